@@ -85,11 +85,13 @@ const float ads111x_gain_values[] = {
     [ADS111X_GAIN_0V256_3] = 0.256
 };
 
-static esp_err_t read_reg(i2c_dev_t *dev, uint8_t reg, uint16_t *val)
+static const uint8_t cached_regs[] = { REG_CONFIG, REG_THRESH_L, REG_THRESH_H };
+
+static esp_err_t read_reg(i2c_dev_t *dev, uint8_t reg, uint16_t *val, bool cached)
 {
     uint8_t buf[2];
     esp_err_t res;
-    if ((res = i2c_dev_read_reg(dev, reg, buf, 2)) != ESP_OK)
+    if ((res = cached ? i2c_dev_read_reg_cached(dev, reg, buf, 2) : i2c_dev_read_reg(dev, reg, buf, 2)) != ESP_OK)
     {
         ESP_LOGE(TAG, "Could not read from register 0x%02x", reg);
         return res;
@@ -99,11 +101,11 @@ static esp_err_t read_reg(i2c_dev_t *dev, uint8_t reg, uint16_t *val)
     return ESP_OK;
 }
 
-static esp_err_t write_reg(i2c_dev_t *dev, uint8_t reg, uint16_t val)
+static esp_err_t write_reg(i2c_dev_t *dev, uint8_t reg, uint16_t val, bool cached)
 {
     uint8_t buf[2] = { val >> 8, val };
     esp_err_t res;
-    if ((res = i2c_dev_write_reg(dev, reg, buf, 2)) != ESP_OK)
+    if ((res = cached ? i2c_dev_write_reg_cached(dev, reg, buf, 2) : i2c_dev_write_reg(dev, reg, buf, 2)) != ESP_OK)
     {
         ESP_LOGE(TAG, "Could not write 0x%04x to register 0x%02x", val, reg);
         return res;
@@ -119,8 +121,9 @@ static esp_err_t read_conf_bits(i2c_dev_t *dev, uint8_t offs, uint16_t mask,
 
     uint16_t val;
 
+    // OS bit reflects device state and must be always read from the device
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONFIG, &val));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONFIG, &val, offs != OS_OFFSET));
     I2C_DEV_GIVE_MUTEX(dev);
 
     ESP_LOGD(TAG, "Got config value: 0x%04x", val);
@@ -138,8 +141,12 @@ static esp_err_t write_conf_bits(i2c_dev_t *dev, uint16_t val, uint8_t offs,
     uint16_t old;
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONFIG, &old));
-    I2C_DEV_CHECK(dev, write_reg(dev, REG_CONFIG, (old & ~(mask << offs)) | (val << offs)));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONFIG, &old, true));
+    // Cached config is kept with OS bit cleared, so writing of other bits
+    // does not start a new conversion and OS bit is never cached
+    old &= ~(OS_MASK << OS_OFFSET);
+    uint16_t v = (old & ~(mask << offs)) | (val << offs);
+    I2C_DEV_CHECK(dev, write_reg(dev, REG_CONFIG, v, offs != OS_OFFSET));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -175,6 +182,7 @@ esp_err_t ads111x_init_desc(i2c_dev_t *dev, uint8_t addr, i2c_port_t port,
 #if HELPER_TARGET_IS_ESP32
     dev->cfg.master.clk_speed = I2C_FREQ_HZ;
 #endif
+    CHECK(i2c_dev_cache_create(dev, cached_regs, sizeof(cached_regs), 2));
     return i2c_dev_create_mutex(dev);
 }
 
@@ -182,6 +190,7 @@ esp_err_t ads111x_free_desc(i2c_dev_t *dev)
 {
     CHECK_ARG(dev);
 
+    CHECK(i2c_dev_cache_delete(dev));
     return i2c_dev_delete_mutex(dev);
 }
 
@@ -195,12 +204,43 @@ esp_err_t ads111x_start_conversion(i2c_dev_t *dev)
     return write_conf_bits(dev, 1, OS_OFFSET, OS_MASK);
 }
 
+esp_err_t ads111x_start_conversion_with(i2c_dev_t *dev, ads111x_mux_t mux, ads111x_gain_t gain,
+        ads111x_data_rate_t rate)
+{
+    CHECK_ARG(dev);
+
+    uint16_t mask = (OS_MASK << OS_OFFSET) | (MUX_MASK << MUX_OFFSET) | (PGA_MASK << PGA_OFFSET)
+        | (MODE_MASK << MODE_OFFSET) | (DR_MASK << DR_OFFSET);
+    uint16_t bits = ((mux & MUX_MASK) << MUX_OFFSET) | ((gain & PGA_MASK) << PGA_OFFSET)
+        | (ADS111X_MODE_SINGLE_SHOT << MODE_OFFSET) | ((rate & DR_MASK) << DR_OFFSET);
+
+    uint16_t old;
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONFIG, &old, true));
+    uint16_t v = (old & ~mask) | bits;
+    // write with OS bit bypassing the cache, then store value without it
+    // in the cache only: it is the same as device has now
+    I2C_DEV_CHECK(dev, write_reg(dev, REG_CONFIG, v | (OS_MASK << OS_OFFSET), false));
+#if CONFIG_I2CDEV_REG_CACHE
+    if (dev->cache)
+    {
+        uint8_t m[2] = { 0xff, 0xff };
+        uint8_t buf[2] = { v >> 8, v };
+        I2C_DEV_CHECK(dev, i2c_dev_update_reg_cached(dev, REG_CONFIG, m, buf, 2, true));
+    }
+#endif
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
+
 esp_err_t ads111x_get_value(i2c_dev_t *dev, int16_t *value)
 {
     CHECK_ARG(dev && value);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONVERSION, (uint16_t *)value));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONVERSION, (uint16_t *)value, false));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -211,7 +251,7 @@ esp_err_t ads101x_get_value(i2c_dev_t *dev, int16_t *value)
     CHECK_ARG(dev && value);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONVERSION, (uint16_t *)value));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_CONVERSION, (uint16_t *)value, false));
     I2C_DEV_GIVE_MUTEX(dev);
 
     *value = *value >> 4;
@@ -308,7 +348,7 @@ esp_err_t ads111x_get_comp_low_thresh(i2c_dev_t *dev, int16_t *th)
     CHECK_ARG(dev && th);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_THRESH_L, (uint16_t *)th));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_THRESH_L, (uint16_t *)th, true));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -319,7 +359,7 @@ esp_err_t ads111x_set_comp_low_thresh(i2c_dev_t *dev, int16_t th)
     CHECK_ARG(dev);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, write_reg(dev, REG_THRESH_L, th));
+    I2C_DEV_CHECK(dev, write_reg(dev, REG_THRESH_L, th, true));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -330,7 +370,7 @@ esp_err_t ads111x_get_comp_high_thresh(i2c_dev_t *dev, int16_t *th)
     CHECK_ARG(dev && th);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, read_reg(dev, REG_THRESH_H, (uint16_t *)th));
+    I2C_DEV_CHECK(dev, read_reg(dev, REG_THRESH_H, (uint16_t *)th, true));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -341,7 +381,7 @@ esp_err_t ads111x_set_comp_high_thresh(i2c_dev_t *dev, int16_t th)
     CHECK_ARG(dev);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, write_reg(dev, REG_THRESH_H, th));
+    I2C_DEV_CHECK(dev, write_reg(dev, REG_THRESH_H, th, true));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
@@ -205,6 +205,21 @@ esp_err_t ads111x_is_busy(i2c_dev_t *dev, bool *busy);
  */
 esp_err_t ads111x_start_conversion(i2c_dev_t *dev);
 
+/**
+ * @brief Switch input, gain and data rate and begin a single conversion
+ *
+ * Whole configuration is sent in one register write, comparator settings
+ * are kept. Device is switched to single-shot mode.
+ *
+ * @param dev Device descriptor
+ * @param mux Input multiplexer configuration
+ * @param gain Gain
+ * @param rate Data rate
+ * @return `ESP_OK` on success
+ */
+esp_err_t ads111x_start_conversion_with(i2c_dev_t *dev, ads111x_mux_t mux, ads111x_gain_t gain,
+        ads111x_data_rate_t rate);
+
 /**
  * @brief Read last conversion result
  *
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ads111x_regs.hpp
+ * @defgroup ads111x_regs ads111x_regs
+ * @{
+ *
+ * ADS111x register map for i2cdev_regs.hpp
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ADS111X_REGS_HPP__
+#define __ADS111X_REGS_HPP__
+
+#include <i2cdev_regs.hpp>
+
+namespace ads111x_regs {
+
+using i2cdev::reg;
+using i2cdev::field;
+
+/// Conversion result register
+struct conversion : reg<0, uint16_t> {};
+
+/// Configuration register
+struct config : reg<1, uint16_t>
+{
+    typedef field<config, 0, 2> comp_que;  //!< Comparator queue and disable
+    typedef field<config, 2> comp_lat;     //!< Latching comparator
+    typedef field<config, 3> comp_pol;     //!< Comparator polarity
+    typedef field<config, 4> comp_mode;    //!< Window comparator
+    typedef field<config, 5, 3> dr;        //!< Data rate, ::ads111x_data_rate_t
+    typedef field<config, 8> mode;         //!< Single-shot mode, ::ads111x_mode_t
+    typedef field<config, 9, 3> pga;       //!< Gain, ::ads111x_gain_t
+    typedef field<config, 12, 3> mux;      //!< Input multiplexer, ::ads111x_mux_t
+    typedef field<config, 15> os;          //!< Start conversion / not busy
+};
+
+/// Comparator low threshold register
+struct thresh_lo : reg<2, uint16_t> {};
+
+/// Comparator high threshold register
+struct thresh_hi : reg<3, uint16_t> {};
+
+} // namespace ads111x_regs
+
+/**@}*/
+
+#endif /* __ADS111X_REGS_HPP__ */
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ads111x_scan.c
+ *
+ * Round-robin multi-channel scanning for ADS111x
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <esp_log.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include "ads111x_scan.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// Conversion ready mode: MSB of high threshold is 1, MSB of low threshold is 0
+#define RDY_THRESH_HI ((int16_t)0x8000)
+#define RDY_THRESH_LO 0
+
+#define NONE ((size_t)-1)
+
+static const char *TAG = "ads111x_scan";
+
+static const uint32_t conv_time_us[] = {
+    [ADS111X_DATA_RATE_8]   = 125000,
+    [ADS111X_DATA_RATE_16]  = 62500,
+    [ADS111X_DATA_RATE_32]  = 31250,
+    [ADS111X_DATA_RATE_64]  = 15625,
+    [ADS111X_DATA_RATE_128] = 7813,
+    [ADS111X_DATA_RATE_250] = 4000,
+    [ADS111X_DATA_RATE_475] = 2106,
+    [ADS111X_DATA_RATE_860] = 1163,
+};
+
+static TickType_t conv_ticks(ads111x_data_rate_t rate, bool fallback)
+{
+    // internal oscillator is +-10%
+    uint32_t us = conv_time_us[rate & 7] * 11 / 10;
+    // with ALERT/RDY the timeout is only a safety net for lost edges
+    if (fallback)
+        us *= 2;
+    return (us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000) + 1;
+}
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR ready_isr(void *arg)
+#else
+static void ready_isr(void *arg)
+#endif
+{
+    // every pin has own handler, so edge is credited to its device only
+    ads111x_scan_rdy_t *rdy = (ads111x_scan_rdy_t *)arg;
+    ads111x_scan_t *scan = (ads111x_scan_t *)rdy->scan;
+
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(scan->task, BIT(rdy->device), eSetBits, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static size_t next_entry(ads111x_scan_t *scan, uint8_t device, size_t from)
+{
+    for (size_t n = 1; n <= scan->count; n++)
+    {
+        size_t i = (from + n) % scan->count;
+        if (scan->list[i].device == device)
+            return i;
+    }
+    return NONE;
+}
+
+static void start_next(ads111x_scan_t *scan, uint8_t d)
+{
+    size_t i = next_entry(scan, d, scan->current[d] == NONE ? scan->count - 1 : scan->current[d]);
+    scan->current[d] = i;
+    if (i == NONE)
+        return;
+
+    const ads111x_scan_entry_t *e = &scan->list[i];
+    esp_err_t res = ads111x_start_conversion_with(scan->devs[d], e->mux, e->gain, e->rate);
+    if (res != ESP_OK)
+        ESP_LOGE(TAG, "Could not start conversion on device %d: %d (%s)", d, res, esp_err_to_name(res));
+    // on error conversion is retried after timeout
+    scan->deadline[d] = xTaskGetTickCount() + conv_ticks(e->rate, scan->gpios[d] != GPIO_NUM_NC);
+}
+
+static void scan_task(void *arg)
+{
+    ads111x_scan_t *scan = (ads111x_scan_t *)arg;
+
+    for (uint8_t d = 0; d < scan->dev_count; d++)
+    {
+        scan->current[d] = NONE;
+        start_next(scan, d);
+    }
+
+    while (scan->running)
+    {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = portMAX_DELAY;
+        for (uint8_t d = 0; d < scan->dev_count; d++)
+        {
+            if (scan->current[d] == NONE)
+                continue;
+            TickType_t left = (int32_t)(scan->deadline[d] - now) > 0 ? scan->deadline[d] - now : 0;
+            if (left < wait)
+                wait = left;
+        }
+
+        uint32_t bits = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &bits, wait);
+        if (!scan->running)
+            break;
+
+        now = xTaskGetTickCount();
+        for (uint8_t d = 0; d < scan->dev_count; d++)
+        {
+            if (scan->current[d] == NONE)
+                continue;
+            if (!(bits & BIT(d)) && (int32_t)(now - scan->deadline[d]) < 0)
+                continue;
+
+            size_t i = scan->current[d];
+            int16_t value;
+            esp_err_t res = ads111x_get_value(scan->devs[d], &value);
+            // start next conversion before callback to keep device busy
+            start_next(scan, d);
+            if (res != ESP_OK)
+                ESP_LOGE(TAG, "Could not read device %d: %d (%s)", d, res, esp_err_to_name(res));
+            else if (scan->callback)
+                scan->callback(i, value, scan->arg);
+        }
+    }
+
+    scan->task = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t setup_rdy(i2c_dev_t *dev)
+{
+    CHECK(ads111x_set_comp_high_thresh(dev, RDY_THRESH_HI));
+    CHECK(ads111x_set_comp_low_thresh(dev, RDY_THRESH_LO));
+    CHECK(ads111x_set_comp_mode(dev, ADS111X_COMP_MODE_NORMAL));
+    CHECK(ads111x_set_comp_polarity(dev, ADS111X_COMP_POLARITY_LOW));
+    CHECK(ads111x_set_comp_latch(dev, ADS111X_COMP_LATCH_DISABLED));
+    return ads111x_set_comp_queue(dev, ADS111X_COMP_QUEUE_1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t ads111x_scan_start(ads111x_scan_t *scan, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(scan && scan->list && scan->count && !scan->task);
+    CHECK_ARG(scan->dev_count && scan->dev_count <= ADS111X_SCAN_MAX_DEVICES);
+    for (size_t i = 0; i < scan->count; i++)
+        CHECK_ARG(scan->list[i].device < scan->dev_count);
+
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        return res;
+
+    for (size_t d = 0; d < scan->dev_count; d++)
+    {
+        CHECK_ARG(scan->devs[d]);
+        if (scan->gpios[d] == GPIO_NUM_NC)
+            continue;
+
+        CHECK(setup_rdy(scan->devs[d]));
+
+        // ALERT/RDY is open drain
+        gpio_config_t io_conf;
+        io_conf.pin_bit_mask = 1ULL << scan->gpios[d];
+        io_conf.mode = GPIO_MODE_INPUT;
+        io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+        io_conf.intr_type = GPIO_INTR_NEGEDGE;
+        CHECK(gpio_config(&io_conf));
+    }
+
+    scan->running = true;
+    if (xTaskCreate(scan_task, TAG, stack_size, scan, priority, &scan->task) != pdPASS)
+    {
+        scan->running = false;
+        scan->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (size_t d = 0; d < scan->dev_count; d++)
+    {
+        if (scan->gpios[d] == GPIO_NUM_NC)
+            continue;
+        scan->rdy[d].scan = scan;
+        scan->rdy[d].device = d;
+        if ((res = gpio_isr_handler_add(scan->gpios[d], ready_isr, &scan->rdy[d])) != ESP_OK)
+        {
+            ads111x_scan_stop(scan);
+            return res;
+        }
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ads111x_scan_stop(ads111x_scan_t *scan)
+{
+    CHECK_ARG(scan);
+
+    for (size_t d = 0; d < scan->dev_count; d++)
+        if (scan->gpios[d] != GPIO_NUM_NC)
+        {
+            gpio_isr_handler_remove(scan->gpios[d]);
+            gpio_set_intr_type(scan->gpios[d], GPIO_INTR_DISABLE);
+        }
+
+    scan->running = false;
+    while (scan->task)
+    {
+        xTaskNotify(scan->task, 0, eNoAction);
+        vTaskDelay(1);
+    }
+
+    for (size_t d = 0; d < scan->dev_count; d++)
+        if (scan->gpios[d] != GPIO_NUM_NC)
+            CHECK(ads111x_set_comp_queue(scan->devs[d], ADS111X_COMP_QUEUE_DISABLED));
+
+    return ESP_OK;
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ads111x_scan.h
+ * @defgroup ads111x_scan ads111x_scan
+ * @{
+ *
+ * Round-robin multi-channel scanning for ADS111x
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ADS111X_SCAN_H__
+#define __ADS111X_SCAN_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "ads111x.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ADS111X_SCAN_MAX_DEVICES 4 //!< Max number of devices, one per I2C address
+
+/**
+ * Scan list entry
+ */
+typedef struct
+{
+    uint8_t device;           //!< Device index in ads111x_scan_t::devs
+    ads111x_mux_t mux;        //!< Input multiplexer configuration
+    ads111x_gain_t gain;      //!< Gain
+    ads111x_data_rate_t rate; //!< Data rate
+} ads111x_scan_entry_t;
+
+/**
+ * Conversion result callback, called from the scan task
+ *
+ * @param index Index of entry in scan list
+ * @param value Conversion result
+ * @param arg User argument
+ */
+typedef void (*ads111x_scan_cb_t)(size_t index, int16_t value, void *arg);
+
+/**
+ * Argument of ALERT/RDY interrupt handler, internal
+ */
+typedef struct
+{
+    void *scan;                                             //!< Scan descriptor
+    uint8_t device;                                         //!< Index of device
+} ads111x_scan_rdy_t;
+
+/**
+ * Scan descriptor
+ */
+typedef struct
+{
+    i2c_dev_t *devs[ADS111X_SCAN_MAX_DEVICES];              //!< Device descriptors
+    gpio_num_t gpios[ADS111X_SCAN_MAX_DEVICES];             //!< ALERT/RDY GPIOs, GPIO_NUM_NC to wait by time
+    size_t dev_count;                                       //!< Number of devices
+    const ads111x_scan_entry_t *list;                       //!< Scan list
+    size_t count;                                           //!< Number of entries in scan list
+    ads111x_scan_cb_t callback;                             //!< Result callback
+    void *arg;                                              //!< Callback argument
+    size_t current[ADS111X_SCAN_MAX_DEVICES];               //!< Entry being converted, internal
+    TickType_t deadline[ADS111X_SCAN_MAX_DEVICES];          //!< End of conversion, internal
+    ads111x_scan_rdy_t rdy[ADS111X_SCAN_MAX_DEVICES];       //!< Interrupt handler arguments, internal
+    TaskHandle_t task;                                      //!< Scan task, internal
+    volatile bool running;                                  //!< Scan state, internal
+} ads111x_scan_t;
+
+/**
+ * @brief Start scanning
+ *
+ * Entries of each device are converted one after another in order of
+ * the list, while devices convert in parallel. Each channel switch is a
+ * single config register write, which also starts the single-shot
+ * conversion (see ads111x_start_conversion_with()).
+ *
+ * End of conversion is detected by ALERT/RDY interrupt when GPIO is set
+ * for the device, comparator is configured as conversion ready signal
+ * then. Otherwise the task waits for the conversion time, which is
+ * rounded up to RTOS ticks, so use ALERT/RDY for high data rates.
+ *
+ * @param scan Scan descriptor, public fields must be set
+ * @param priority Scan task priority
+ * @param stack_size Scan task stack size, callback is called from it
+ * @return `ESP_OK` on success
+ */
+esp_err_t ads111x_scan_start(ads111x_scan_t *scan, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop scanning
+ *
+ * @param scan Scan descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ads111x_scan_stop(ads111x_scan_t *scan);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __ADS111X_SCAN_H__ */
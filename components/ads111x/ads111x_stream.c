@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ads111x_stream.c
+ *
+ * Continuous conversion streaming for ADS111x/ADS101x using ALERT/RDY pin
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include "ads111x_stream.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// Conversion ready mode: MSB of high threshold is 1, MSB of low threshold is 0
+#define RDY_THRESH_HI ((int16_t)0x8000)
+#define RDY_THRESH_LO 0
+
+static const char *TAG = "ads111x_stream";
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR ready_isr(void *arg)
+#else
+static void ready_isr(void *arg)
+#endif
+{
+    ads111x_stream_t *stream = (ads111x_stream_t *)arg;
+
+    stream->ready_time = esp_timer_get_time();
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(stream->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static void reader_task(void *arg)
+{
+    ads111x_stream_t *stream = (ads111x_stream_t *)arg;
+    ads111x_sample_t s;
+
+    while (stream->running)
+    {
+        uint32_t pulses = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!stream->running)
+            break;
+        // conversions finished while previous one was processed
+        if (pulses > 1)
+            stream->overruns += pulses - 1;
+
+        // 64-bit value can be torn by ISR
+        do
+            s.timestamp = stream->ready_time;
+        while (s.timestamp != stream->ready_time);
+
+        esp_err_t res = stream->ads101x
+            ? ads101x_get_value(stream->dev, &s.value)
+            : ads111x_get_value(stream->dev, &s.value);
+        if (res != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Error reading conversion: %d (%s)", res, esp_err_to_name(res));
+            continue;
+        }
+
+        if (xQueueSend(stream->samples, &s, 0) != pdTRUE)
+        {
+            // drop the oldest sample
+            ads111x_sample_t old;
+            xQueueReceive(stream->samples, &old, 0);
+            xQueueSend(stream->samples, &s, 0);
+            stream->overruns++;
+        }
+    }
+
+    stream->task = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t setup_device(ads111x_stream_t *stream)
+{
+    i2c_dev_t *dev = stream->dev;
+
+    CHECK(ads111x_set_comp_high_thresh(dev, RDY_THRESH_HI));
+    CHECK(ads111x_set_comp_low_thresh(dev, RDY_THRESH_LO));
+    CHECK(ads111x_set_comp_mode(dev, ADS111X_COMP_MODE_NORMAL));
+    CHECK(ads111x_set_comp_polarity(dev, ADS111X_COMP_POLARITY_LOW));
+    CHECK(ads111x_set_comp_latch(dev, ADS111X_COMP_LATCH_DISABLED));
+    CHECK(ads111x_set_comp_queue(dev, ADS111X_COMP_QUEUE_1));
+
+    // starts conversions
+    return ads111x_set_mode(dev, ADS111X_MODE_CONTINUOUS);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t ads111x_stream_start(ads111x_stream_t *stream, size_t buf_size, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(stream && stream->dev && buf_size && !stream->task);
+
+    stream->samples = xQueueCreate(buf_size, sizeof(ads111x_sample_t));
+    if (!stream->samples)
+        return ESP_ERR_NO_MEM;
+    stream->overruns = 0;
+
+    stream->running = true;
+    if (xTaskCreate(reader_task, TAG, stack_size, stream, priority, &stream->task) != pdPASS)
+    {
+        stream->running = false;
+        stream->task = NULL;
+        vQueueDelete(stream->samples);
+        stream->samples = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    // ALERT/RDY is open drain
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << stream->gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    esp_err_t res = gpio_config(&io_conf);
+    if (res != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(stream->gpio, ready_isr, stream)) != ESP_OK)
+        goto fail;
+
+    if ((res = setup_device(stream)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    ads111x_stream_stop(stream);
+    return res;
+}
+
+esp_err_t ads111x_stream_stop(ads111x_stream_t *stream)
+{
+    CHECK_ARG(stream);
+
+    gpio_isr_handler_remove(stream->gpio);
+    gpio_set_intr_type(stream->gpio, GPIO_INTR_DISABLE);
+
+    stream->running = false;
+    while (stream->task)
+    {
+        xTaskNotifyGive(stream->task);
+        vTaskDelay(1);
+    }
+
+    if (stream->samples)
+    {
+        vQueueDelete(stream->samples);
+        stream->samples = NULL;
+    }
+
+    CHECK(ads111x_set_comp_queue(stream->dev, ADS111X_COMP_QUEUE_DISABLED));
+    return ads111x_set_mode(stream->dev, ADS111X_MODE_SINGLE_SHOT);
+}
+
+esp_err_t ads111x_stream_read(ads111x_stream_t *stream, ads111x_sample_t *samples, size_t max,
+        size_t *count, uint32_t timeout_ms)
+{
+    CHECK_ARG(stream && stream->samples && samples && max && count);
+
+    *count = 0;
+    if (xQueueReceive(stream->samples, samples, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    size_t n = 1;
+    while (n < max && xQueueReceive(stream->samples, samples + n, 0) == pdTRUE)
+        n++;
+    *count = n;
+
+    return ESP_OK;
+}
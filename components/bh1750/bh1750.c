@@ -142,6 +142,18 @@ esp_err_t bh1750_setup(i2c_dev_t *dev, bh1750_mode_t mode, bh1750_resolution_t r
     return ESP_OK;
 }
 
+esp_err_t bh1750_setup_ready(i2c_dev_t *dev, bh1750_mode_t mode, bh1750_resolution_t resolution,
+        esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(ready);
+
+    CHECK(bh1750_setup(dev, mode, resolution));
+    // Maximal measurement time from datasheet
+    esp_idf_lib_ready_after(ready, resolution == BH1750_RES_LOW ? 24000 : 180000);
+
+    return ESP_OK;
+}
+
 esp_err_t bh1750_set_measurement_time(i2c_dev_t *dev, uint8_t time)
 {
     CHECK_ARG(dev);
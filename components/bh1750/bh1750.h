@@ -49,6 +49,7 @@
 #include <stdint.h>
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <esp_idf_lib_ready.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -122,6 +123,23 @@ esp_err_t bh1750_power_on(i2c_dev_t *dev);
  */
 esp_err_t bh1750_setup(i2c_dev_t *dev, bh1750_mode_t mode, bh1750_resolution_t resolution);
 
+/**
+ * @brief Setup device parameters and get ready time of the first result
+ *
+ * Works as ::bh1750_setup(), `ready` is set to the maximal measurement
+ * time of resolution with default measurement time register. In one time
+ * mode call it for every measurement and read result with ::bh1750_read()
+ * after waiting for the token.
+ *
+ * @param dev Pointer to device descriptor
+ * @param mode Measurement mode
+ * @param resolution Measurement resolution
+ * @param[out] ready Conversion ready token
+ * @return `ESP_OK` on success
+ */
+esp_err_t bh1750_setup_ready(i2c_dev_t *dev, bh1750_mode_t mode, bh1750_resolution_t resolution,
+        esp_idf_lib_ready_t *ready);
+
 /**
  * @brief Set measurement time
  *
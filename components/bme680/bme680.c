@@ -42,6 +42,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "bme680.h"
 
 #define I2C_FREQ_HZ 1000000 // Up to 3.4MHz, but esp-idf only supports 1MHz
@@ -49,7 +50,7 @@
 // modes: unfortunatly, only SLEEP_MODE and FORCED_MODE are documented
 #define BME680_SLEEP_MODE           0x00    // low power sleeping
 #define BME680_FORCED_MODE          0x01    // perform one TPHG cycle (field data 0 filled)
-#define BME680_PARALLEL_MODE        0x02    // no information what it does :-(
+#define BME680_PARALLEL_MODE        0x02    // BME688 only
 #define BME680_SQUENTUAL_MODE       0x02    // no information what it does (field data 0+1+2 filled)
 
 // register addresses
@@ -66,7 +67,9 @@
 #define BME680_REG_STATUS           0x73
 #define BME680_REG_CTRL_MEAS        0x74
 #define BME680_REG_CONFIG           0x75
+#define BME680_REG_GAS_WAIT_SHARED  0x6e    // BME688 only
 #define BME680_REG_ID               0xd0
+#define BME680_REG_VARIANT_ID       0xf0
 #define BME680_REG_RESET            0xe0
 
 // field data 0 registers
@@ -82,6 +85,8 @@
 #define BME680_REG_HUM_LSB_0        0x26
 #define BME680_REG_GAS_R_MSB_0      0x2a
 #define BME680_REG_GAS_R_LSB_0      0x2b
+#define BME688_REG_GAS_R_MSB_0      0x2c    // BME688 only
+#define BME688_REG_GAS_R_LSB_0      0x2d    // BME688 only
 
 // field data 1 registers (not documented, used in SEQUENTIAL_MODE)
 #define BME680_REG_MEAS_STATUS_1    0x2e
@@ -95,7 +100,8 @@
 #define BME680_REG_RAW_DATA_0       BME680_REG_MEAS_STATUS_0    // 0x1d ... 0x2b
 #define BME680_REG_RAW_DATA_1       BME680_REG_MEAS_STATUS_1    // 0x2e ... 0x3c
 #define BME680_REG_RAW_DATA_2       BME680_REG_MEAS_STATUS_2    // 0x40 ... 0x4d
-#define BME680_REG_RAW_DATA_LEN     (BME680_REG_GAS_R_LSB_0 - BME680_REG_MEAS_STATUS_0 + 1)
+#define BME680_REG_RAW_DATA_LEN     (BME688_REG_GAS_R_LSB_0 - BME680_REG_MEAS_STATUS_0 + 1)
+#define BME680_REG_FIELDS_LEN       (BME680_REG_MEAS_STATUS_2 - BME680_REG_MEAS_STATUS_0 + BME680_REG_RAW_DATA_LEN)
 
 // calibration data registers
 #define BME680_REG_CD1_ADDR         0x89    // 25 byte calibration data
@@ -129,6 +135,8 @@
 
 #define BME680_RUN_GAS_BITS         0x10    // BME680_REG_CTRL_GAS_1<4>
 #define BME680_RUN_GAS_SHIFT        4       // BME680_REG_CTRL_GAS_1<4>
+#define BME688_RUN_GAS_H_BITS       0x20    // BME680_REG_CTRL_GAS_1<5>, BME688 only
+#define BME688_RUN_GAS_H_SHIFT      5       // BME680_REG_CTRL_GAS_1<5>, BME688 only
 #define BME680_NB_CONV_BITS         0x0f    // BME680_REG_CTRL_GAS_1<3:0>
 #define BME680_NB_CONV_SHIFT        0       // BME680_REG_CTRL_GAS_1<3:0>
 
@@ -159,7 +167,6 @@
 
 // commands
 #define BME680_RESET_CMD            0xb6    // BME680_REG_RESET<7:0>
-#define BME680_RESET_PERIOD         10      // reset time in ms
 
 #define BME680_RHR_BITS             0x30    // BME680_REG_RES_HEAT_RANGE<5:4>
 #define BME680_RHR_SHIFT            4       // BME680_REG_RES_HEAT_RANGE<5:4>
@@ -253,9 +260,9 @@ static inline esp_err_t write_reg_8_nolock(bme680_t *dev, uint8_t reg, uint8_t d
 
 static esp_err_t read_reg_8(bme680_t *dev, uint8_t reg, uint8_t *data)
 {
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, reg, data));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, reg, data));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -264,11 +271,11 @@ static esp_err_t bme680_set_mode(bme680_t *dev, uint8_t mode)
 {
     uint8_t reg;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, &reg));
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, &reg));
     reg = bme_set_reg_bit(reg, BME680_MODE, mode);
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, reg));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, reg));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -281,6 +288,37 @@ static esp_err_t bme680_set_mode(bme680_t *dev, uint8_t mode)
 #define BME680_RAW_H_OFF (BME680_RAW_T_OFF + BME680_REG_HUM_MSB_0 - BME680_REG_TEMP_MSB_0)
 #define BME680_RAW_G_OFF (BME680_RAW_H_OFF + BME680_REG_GAS_R_MSB_0 - BME680_REG_HUM_MSB_0)
 
+static void bme680_parse_raw_data(uint8_t variant, const uint8_t *raw, bme680_raw_data_t *raw_data)
+{
+    raw_data->gas_index = raw[0] & BME680_GAS_MEAS_INDEX_BITS;
+    raw_data->meas_index = raw[1];
+
+    raw_data->gas_valid     = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 1], BME680_GAS_VALID);
+    raw_data->heater_stable = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 1], BME680_HEAT_STAB_R);
+
+    raw_data->temperature    = msb_lsb_xlsb_to_20bit(uint32_t, raw, BME680_RAW_T_OFF);
+    raw_data->pressure       = msb_lsb_xlsb_to_20bit(uint32_t, raw, BME680_RAW_P_OFF);
+    raw_data->humidity       = msb_lsb_to_type(uint16_t, raw, BME680_RAW_H_OFF);
+    raw_data->gas_resistance = ((uint16_t) raw[BME680_RAW_G_OFF] << 2) | raw[BME680_RAW_G_OFF + 1] >> 6;
+    raw_data->gas_range      = raw[BME680_RAW_G_OFF + 1] & BME680_GAS_RANGE_R_BITS;
+
+    if (variant == BME680_VARIANT_BME688)
+    {
+        // BME688 has own gas registers
+        raw_data->gas_valid      = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 3], BME680_GAS_VALID);
+        raw_data->heater_stable  = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 3], BME680_HEAT_STAB_R);
+        raw_data->gas_resistance = ((uint16_t) raw[BME680_RAW_G_OFF + 2] << 2) | raw[BME680_RAW_G_OFF + 3] >> 6;
+        raw_data->gas_range      = raw[BME680_RAW_G_OFF + 3] & BME680_GAS_RANGE_R_BITS;
+    }
+
+    /*
+     * BME680_REG_MEAS_STATUS_1, BME680_REG_MEAS_STATUS_2
+     * These data are not documented and it is not really clear when they are filled
+     */
+    ESP_LOGD(TAG, "Raw data: %d %d %d %d %d", raw_data->temperature, raw_data->pressure,
+            raw_data->humidity, raw_data->gas_resistance, raw_data->gas_range);
+}
+
 static esp_err_t bme680_get_raw_data(bme680_t *dev, bme680_raw_data_t *raw_data)
 {
     if (!dev->meas_started)
@@ -309,28 +347,14 @@ static esp_err_t bme680_get_raw_data(bme680_t *dev, bme680_raw_data_t *raw_data)
     }
 
     dev->meas_started = false;
-    raw_data->gas_index = dev->meas_status & BME680_GAS_MEAS_INDEX_BITS;
 
     // if there are new data, read raw data from sensor
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_RAW_DATA_0, raw, BME680_REG_RAW_DATA_LEN));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
-
-    raw_data->gas_valid     = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 1], BME680_GAS_VALID);
-    raw_data->heater_stable = bme_get_reg_bit(raw[BME680_RAW_G_OFF + 1], BME680_HEAT_STAB_R);
-
-    raw_data->temperature    = msb_lsb_xlsb_to_20bit(uint32_t, raw, BME680_RAW_T_OFF);
-    raw_data->pressure       = msb_lsb_xlsb_to_20bit(uint32_t, raw, BME680_RAW_P_OFF);
-    raw_data->humidity       = msb_lsb_to_type(uint16_t, raw, BME680_RAW_H_OFF);
-    raw_data->gas_resistance = ((uint16_t) raw[BME680_RAW_G_OFF] << 2) | raw[BME680_RAW_G_OFF + 1] >> 6;
-    raw_data->gas_range      = raw[BME680_RAW_G_OFF + 1] & BME680_GAS_RANGE_R_BITS;
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_RAW_DATA_0, raw, BME680_REG_RAW_DATA_LEN));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
-    /*
-     * BME680_REG_MEAS_STATUS_1, BME680_REG_MEAS_STATUS_2
-     * These data are not documented and it is not really clear when they are filled
-     */
-    ESP_LOGD(TAG, "Raw data: %d %d %d %d %d", raw_data->temperature, raw_data->pressure,
-            raw_data->humidity, raw_data->gas_resistance, raw_data->gas_range);
+    bme680_parse_raw_data(dev->variant, raw, raw_data);
+    raw_data->gas_index = dev->meas_status & BME680_GAS_MEAS_INDEX_BITS;
 
     return ESP_OK;
 }
@@ -483,6 +507,13 @@ static uint32_t bme680_convert_gas(bme680_t *dev, uint16_t gas, uint8_t gas_rang
 {
     bme680_calib_data_t *cd = &dev->calib_data;
 
+    if (dev->variant == BME680_VARIANT_BME688)
+    {
+        uint32_t var1 = UINT32_C(262144) >> gas_range;
+        int32_t var2 = INT32_C(4096) + ((int32_t)gas - INT32_C(512)) * 3;
+        return UINT32_C(10000) * var1 / (uint32_t)var2 * 100;
+    }
+
     float var1 = (1340.0 + 5.0 * cd->range_sw_err) * lookup_table[gas_range][0];
     return var1 * lookup_table[gas_range][1] / (gas - 512.0 + var1);
 }
@@ -578,41 +609,13 @@ esp_err_t bme680_free_desc(bme680_t *dev)
     return i2c_dev_delete_mutex(&dev->i2c_dev);
 }
 
-esp_err_t bme680_init_sensor(bme680_t *dev)
+static esp_err_t read_calib_data_nolock(bme680_t *dev)
 {
-    CHECK_ARG(dev);
-
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-
-    dev->meas_started = false;
-    dev->meas_status = 0;
-    dev->settings.ambient_temperature = 0;
-    dev->settings.osr_temperature = BME680_OSR_NONE;
-    dev->settings.osr_pressure = BME680_OSR_NONE;
-    dev->settings.osr_humidity = BME680_OSR_NONE;
-    dev->settings.filter_size = BME680_IIR_SIZE_0;
-    dev->settings.heater_profile = BME680_HEATER_NOT_USED;
-    memset(dev->settings.heater_temperature, 0, sizeof(uint16_t) * 10);
-    memset(dev->settings.heater_duration, 0, sizeof(uint16_t) * 10);
-
-    // reset the sensor
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_RESET, BME680_RESET_CMD));
-    vTaskDelay(pdMS_TO_TICKS(BME680_RESET_PERIOD));
-
-    uint8_t chip_id = 0;
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_ID, &chip_id));
-    if (chip_id != 0x61)
-    {
-        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
-        ESP_LOGE(TAG, "Chip id %02x is wrong, should be 0x61", chip_id);
-        return ESP_ERR_NOT_FOUND;
-    }
-
     uint8_t buf[BME680_CDM_SIZE];
 
-    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD1_ADDR, buf + BME680_CDM_OFF1, BME680_REG_CD1_LEN));
-    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD2_ADDR, buf + BME680_CDM_OFF2, BME680_REG_CD2_LEN));
-    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD3_ADDR, buf + BME680_CDM_OFF3, BME680_REG_CD3_LEN));
+    CHECK(i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD1_ADDR, buf + BME680_CDM_OFF1, BME680_REG_CD1_LEN));
+    CHECK(i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD2_ADDR, buf + BME680_CDM_OFF2, BME680_REG_CD2_LEN));
+    CHECK(i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_CD3_ADDR, buf + BME680_CDM_OFF3, BME680_REG_CD3_LEN));
 
     dev->calib_data.par_t1 = lsb_msb_to_type(uint16_t, buf, BME680_CDM_T1);
     dev->calib_data.par_t2 = lsb_msb_to_type(int16_t, buf, BME680_CDM_T2);
@@ -648,6 +651,63 @@ esp_err_t bme680_init_sensor(bme680_t *dev)
     dev->calib_data.res_heat_val = (lsb_to_type(int8_t, buf, BME680_CDM_RHV));
     dev->calib_data.range_sw_err = (lsb_to_type(int8_t, buf, BME680_CDM_RSWE) & BME680_RSWE_BITS) >> BME680_RSWE_SHIFT;
 
+    return ESP_OK;
+}
+
+esp_err_t bme680_reset(bme680_t *dev)
+{
+    CHECK_ARG(dev);
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+
+    dev->meas_started = false;
+    dev->meas_status = 0;
+    dev->profile_seq = 0;
+    dev->parallel = false;
+    dev->settings.ambient_temperature = 0;
+    dev->settings.osr_temperature = BME680_OSR_NONE;
+    dev->settings.osr_pressure = BME680_OSR_NONE;
+    dev->settings.osr_humidity = BME680_OSR_NONE;
+    dev->settings.filter_size = BME680_IIR_SIZE_0;
+    dev->settings.heater_profile = BME680_HEATER_NOT_USED;
+    memset(dev->settings.heater_temperature, 0, sizeof(uint16_t) * 10);
+    memset(dev->settings.heater_duration, 0, sizeof(uint16_t) * 10);
+
+    // reset the sensor
+    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_RESET, BME680_RESET_CMD));
+
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_init_after_reset(bme680_t *dev, bool keep_calib)
+{
+    CHECK_ARG(dev);
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+
+    uint8_t chip_id = 0;
+    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_ID, &chip_id));
+    if (chip_id != 0x61)
+    {
+        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        ESP_LOGE(TAG, "Chip id %02x is wrong, should be 0x61", chip_id);
+        return ESP_ERR_NOT_FOUND;
+    }
+    uint8_t variant;
+    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_VARIANT_ID, &variant));
+    ESP_LOGD(TAG, "Chip variant: %d", variant);
+
+    // calibration data supplied by the caller is valid for the same chip variant only
+    if (keep_calib && variant == dev->variant)
+        ESP_LOGD(TAG, "Using supplied calibration data");
+    else
+    {
+        dev->variant = variant;
+        I2C_DEV_CHECK(&dev->i2c_dev, read_calib_data_nolock(dev));
+    }
+
     // Set ambient temperature of sensor to default value (25 degree C)
     dev->settings.ambient_temperature = 25;
 
@@ -663,6 +723,14 @@ esp_err_t bme680_init_sensor(bme680_t *dev)
     return ESP_OK;
 }
 
+esp_err_t bme680_init_sensor(bme680_t *dev)
+{
+    CHECK(bme680_reset(dev));
+    vTaskDelay(pdMS_TO_TICKS(BME680_RESET_TIME_MS));
+
+    return bme680_init_after_reset(dev, false);
+}
+
 esp_err_t bme680_force_measurement(bme680_t *dev)
 {
     CHECK_ARG(dev);
@@ -754,33 +822,22 @@ esp_err_t bme680_is_measuring(bme680_t *dev, bool *busy)
     return ESP_OK;
 }
 
-esp_err_t bme680_get_results_fixed(bme680_t *dev, bme680_values_fixed_t *results)
+static void bme680_compensate(bme680_t *dev, const bme680_raw_data_t *raw, bme680_values_fixed_t *results)
 {
-    CHECK_ARG(dev && results);
-
-    // fill data structure with invalid values
-    results->temperature = INT16_MIN;
-    results->pressure = 0;
-    results->humidity = 0;
-    results->gas_resistance = 0;
-
-    bme680_raw_data_t raw;
-    CHECK(bme680_get_raw_data(dev, &raw));
-
     // use compensation algorithms to compute sensor values in fixed point format
     if (dev->settings.osr_temperature)
-        results->temperature = bme680_convert_temperature(dev, raw.temperature);
+        results->temperature = bme680_convert_temperature(dev, raw->temperature);
     if (dev->settings.osr_pressure)
-        results->pressure = bme680_convert_pressure(dev, raw.pressure);
+        results->pressure = bme680_convert_pressure(dev, raw->pressure);
     if (dev->settings.osr_humidity)
-        results->humidity = bme680_convert_humidity(dev, raw.humidity);
+        results->humidity = bme680_convert_humidity(dev, raw->humidity);
 
     if (dev->settings.heater_profile != BME680_HEATER_NOT_USED)
     {
         // convert gas only if raw data are valid and heater was stable
-        if (raw.gas_valid && raw.heater_stable)
-            results->gas_resistance = bme680_convert_gas(dev, raw.gas_resistance, raw.gas_range);
-        else if (!raw.gas_valid)
+        if (raw->gas_valid && raw->heater_stable)
+            results->gas_resistance = bme680_convert_gas(dev, raw->gas_resistance, raw->gas_range);
+        else if (!raw->gas_valid)
             ESP_LOGW(TAG, "Gas data is not valid");
         else
             ESP_LOGW(TAG, "Heater is not stable");
@@ -788,6 +845,35 @@ esp_err_t bme680_get_results_fixed(bme680_t *dev, bme680_values_fixed_t *results
 
     ESP_LOGD(TAG, "Fixed point sensor values - %d/100 deg.C, %d/1000 %%, %d Pa, %d Ohm",
             results->temperature, results->humidity, results->pressure, results->gas_resistance);
+}
+
+static void fixed_to_float(const bme680_values_fixed_t *fixed, bme680_values_float_t *results)
+{
+    results->temperature = fixed->temperature / 100.0f;
+    results->pressure = fixed->pressure / 100.0f;
+    results->humidity = fixed->humidity / 1000.0f;
+    results->gas_resistance = fixed->gas_resistance;
+}
+
+static void invalidate(bme680_values_fixed_t *results)
+{
+    // fill data structure with invalid values
+    results->temperature = INT16_MIN;
+    results->pressure = 0;
+    results->humidity = 0;
+    results->gas_resistance = 0;
+}
+
+esp_err_t bme680_get_results_fixed(bme680_t *dev, bme680_values_fixed_t *results)
+{
+    CHECK_ARG(dev && results);
+
+    invalidate(results);
+
+    bme680_raw_data_t raw;
+    CHECK(bme680_get_raw_data(dev, &raw));
+
+    bme680_compensate(dev, &raw, results);
 
     return ESP_OK;
 }
@@ -799,14 +885,101 @@ esp_err_t bme680_get_results_float(bme680_t *dev, bme680_values_float_t *results
     bme680_values_fixed_t fixed;
     CHECK(bme680_get_results_fixed(dev, &fixed));
 
-    results->temperature = fixed.temperature / 100.0f;
-    results->pressure = fixed.pressure / 100.0f;
-    results->humidity = fixed.humidity / 1000.0f;
-    results->gas_resistance = fixed.gas_resistance;
+    fixed_to_float(&fixed, results);
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_start_measurement(bme680_t *dev, uint32_t *duration)
+{
+    CHECK_ARG(dev);
+
+    if (dev->parallel)
+    {
+        ESP_LOGE(TAG, "Parallel mode is active");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (dev->profile_seq)
+    {
+        // next profile of sequence, only CTRL_GAS_1 is written
+        int8_t p = dev->settings.heater_profile;
+        do
+            p = (p + 1) % BME680_HEATER_PROFILES;
+        while (!(dev->profile_seq & (1 << p)));
+        CHECK(bme680_use_heater_profile(dev, p));
+    }
+
+    uint32_t ticks;
+    CHECK(bme680_get_measurement_duration(dev, &ticks));
+    CHECK(bme680_force_measurement(dev));
+
+    dev->meas_ready = false;
+    dev->meas_deadline = xTaskGetTickCount() + ticks;
+    if (duration)
+        *duration = ticks;
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_poll_measurement(bme680_t *dev, bool *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    *ready = dev->meas_ready;
+    // not started, already finished or too early: no bus access
+    if (!dev->meas_started || (int32_t)(xTaskGetTickCount() - dev->meas_deadline) < 0)
+        return ESP_OK;
+
+    // status and results in one burst
+    uint8_t raw[BME680_REG_RAW_DATA_LEN];
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_RAW_DATA_0, raw, BME680_REG_RAW_DATA_LEN));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+
+    dev->meas_status = raw[0];
+    if (!(dev->meas_status & BME680_NEW_DATA_BITS))
+        return ESP_OK;
+
+    dev->meas_started = false;
+
+    bme680_raw_data_t raw_data;
+    bme680_parse_raw_data(dev->variant, raw, &raw_data);
+    dev->meas_profile = raw_data.gas_index;
+    invalidate(&dev->meas_results);
+    bme680_compensate(dev, &raw_data, &dev->meas_results);
+    dev->meas_ready = *ready = true;
 
     return ESP_OK;
 }
 
+esp_err_t bme680_finish_measurement_fixed(bme680_t *dev, bme680_values_fixed_t *results)
+{
+    CHECK_ARG(dev && results);
+
+    if (!dev->meas_ready)
+    {
+        invalidate(results);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    *results = dev->meas_results;
+    dev->meas_ready = false;
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_finish_measurement_float(bme680_t *dev, bme680_values_float_t *results)
+{
+    CHECK_ARG(results);
+
+    bme680_values_fixed_t fixed;
+    esp_err_t res = bme680_finish_measurement_fixed(dev, &fixed);
+    fixed_to_float(&fixed, results);
+
+    return res;
+}
+
 esp_err_t bme680_measure_fixed(bme680_t *dev, bme680_values_fixed_t *results)
 {
     CHECK_ARG(dev && results);
@@ -820,7 +993,7 @@ esp_err_t bme680_measure_fixed(bme680_t *dev, bme680_values_fixed_t *results)
     }
 
     CHECK(bme680_force_measurement(dev));
-    vTaskDelay(duration);
+    ESP_IDF_LIB_TRACE_DELAY(duration);
 
     return bme680_get_results_fixed(dev, results);
 }
@@ -838,7 +1011,7 @@ esp_err_t bme680_measure_float(bme680_t *dev, bme680_values_float_t *results)
     }
 
     CHECK(bme680_force_measurement(dev));
-    vTaskDelay(duration);
+    ESP_IDF_LIB_TRACE_DELAY(duration);
 
     return bme680_get_results_float(dev, results);
 }
@@ -862,11 +1035,11 @@ esp_err_t bme680_set_oversampling_rates(bme680_t *dev, bme680_oversampling_rate_
 
     uint8_t reg;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
     if (ost_changed || osp_changed)
     {
         // read the current register value
-        I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, &reg));
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, &reg));
 
         // set changed bit values
         if (ost_changed)
@@ -875,20 +1048,20 @@ esp_err_t bme680_set_oversampling_rates(bme680_t *dev, bme680_oversampling_rate_
             reg = bme_set_reg_bit(reg, BME680_OSR_P, osp);
 
         // write back the new register value
-        I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, reg));
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_MEAS, reg));
     }
     if (osh_changed)
     {
         // read the current register value
-        I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_HUM, &reg));
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CTRL_HUM, &reg));
 
         // set changed bit value
         reg = bme_set_reg_bit(reg, BME680_OSR_H, osh);
 
         // write back the new register value
-        I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_HUM, reg));
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_HUM, reg));
     }
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     ESP_LOGD(TAG, "Setting oversampling rates done: osrt=%d osp=%d osrh=%d",
             dev->settings.osr_temperature, dev->settings.osr_pressure, dev->settings.osr_humidity);
@@ -907,16 +1080,16 @@ esp_err_t bme680_set_filter_size(bme680_t *dev, bme680_filter_size_t size)
     dev->settings.filter_size = size;
 
     uint8_t reg;
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // read the current register value
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CONFIG, &reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_8_nolock(dev, BME680_REG_CONFIG, &reg));
     // set changed bit value
     reg = bme_set_reg_bit(reg, BME680_FILTER, size);
     // write back the new register value
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CONFIG, reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CONFIG, reg));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     ESP_LOGD(TAG, "Setting filter size done: size=%d", dev->settings.filter_size);
 
@@ -941,13 +1114,13 @@ esp_err_t bme680_set_heater_profile(bme680_t *dev, uint8_t profile, uint16_t tem
     uint8_t heat_dur = bme680_heater_duration(duration);           // internal duration value
     uint8_t heat_res = bme680_heater_resistance(dev, temperature); // internal temperature value
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
     // set internal gas sensor configuration parameters if changed
     if (temperature_changed)
-        I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_RES_HEAT_BASE + profile, heat_res));
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_RES_HEAT_BASE + profile, heat_res));
     if (duration_changed)
-        I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_GAS_WAIT_BASE + profile, heat_dur));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_GAS_WAIT_BASE + profile, heat_dur));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
 
     ESP_LOGD(TAG, "Setting heater profile %d done: temperature=%d duration=%d"
@@ -972,12 +1145,16 @@ esp_err_t bme680_use_heater_profile(bme680_t *dev, int8_t profile)
     reg = bme_set_reg_bit(reg, BME680_NB_CONV, profile != BME680_HEATER_NOT_USED ? profile : 0);
 
     // enable or disable gas measurement
-    reg = bme_set_reg_bit(reg, BME680_RUN_GAS,
-            (profile != BME680_HEATER_NOT_USED && dev->settings.heater_temperature[profile] && dev->settings.heater_duration[profile]));
+    bool run_gas = profile != BME680_HEATER_NOT_USED && dev->settings.heater_temperature[profile]
+            && dev->settings.heater_duration[profile];
+    if (dev->variant == BME680_VARIANT_BME688)
+        reg = bme_set_reg_bit(reg, BME688_RUN_GAS_H, run_gas);
+    else
+        reg = bme_set_reg_bit(reg, BME680_RUN_GAS, run_gas);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_GAS_1, reg));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_GAS_1, reg));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -999,12 +1176,143 @@ esp_err_t bme680_set_ambient_temperature(bme680_t *dev, int16_t ambient)
                 ? bme680_heater_resistance(dev, dev->settings.heater_temperature[i])
                 : 0;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_write_reg(&dev->i2c_dev, BME680_REG_RES_HEAT_BASE, data, 10));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, i2c_dev_write_reg(&dev->i2c_dev, BME680_REG_RES_HEAT_BASE, data, 10));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     ESP_LOGD(TAG, "Setting heater ambient temperature done: ambient=%d", dev->settings.ambient_temperature);
 
     return ESP_OK;
 }
 
+
+esp_err_t bme680_set_profile_sequence(bme680_t *dev, uint16_t profiles)
+{
+    CHECK_ARG(dev && profiles < (1 << BME680_HEATER_PROFILES));
+
+    for (uint8_t p = 0; p < BME680_HEATER_PROFILES; p++)
+        if ((profiles & (1 << p)) && !(dev->settings.heater_temperature[p] && dev->settings.heater_duration[p]))
+        {
+            ESP_LOGE(TAG, "Heater profile %d is not set", p);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+    dev->profile_seq = profiles;
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_start_parallel_mode(bme680_t *dev, const uint8_t *multipliers, uint8_t steps, uint16_t shared_ms)
+{
+    CHECK_ARG(dev && multipliers && steps && steps <= BME680_HEATER_PROFILES);
+
+    if (dev->variant != BME680_VARIANT_BME688)
+    {
+        ESP_LOGE(TAG, "Parallel mode is supported by BME688 only");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    if (dev->meas_started)
+    {
+        ESP_LOGE(TAG, "Measurement is already running");
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (uint8_t i = 0; i < steps; i++)
+        if (!dev->settings.heater_temperature[i])
+        {
+            ESP_LOGE(TAG, "Heater temperature of profile %d is not set", i);
+            return ESP_ERR_INVALID_ARG;
+        }
+
+    // shared heater duration in 0.477 ms steps
+    uint8_t shared;
+    if (shared_ms >= 0x783)
+        shared = 0xff;
+    else
+    {
+        uint32_t d = (uint32_t)shared_ms * 1000 / 477;
+        uint8_t factor = 0;
+        while (d > 0x3f)
+        {
+            d >>= 2;
+            factor++;
+        }
+        shared = d | (factor << 6);
+    }
+
+    uint8_t ctrl_gas_1 = bme_set_reg_bit(0, BME680_NB_CONV, steps);
+    ctrl_gas_1 = bme_set_reg_bit(ctrl_gas_1, BME688_RUN_GAS_H, 1);
+
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    // gas_wait_x are step multipliers of shared duration in parallel mode
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, i2c_dev_write_reg(&dev->i2c_dev, BME680_REG_GAS_WAIT_BASE, multipliers, steps));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_GAS_WAIT_SHARED, shared));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_8_nolock(dev, BME680_REG_CTRL_GAS_1, ctrl_gas_1));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+
+    // forced mode durations are overwritten, force rewrite on next use
+    for (uint8_t i = 0; i < steps; i++)
+        dev->settings.heater_duration[i] = 0;
+    dev->settings.heater_profile = 0;
+
+    CHECK(bme680_set_mode(dev, BME680_PARALLEL_MODE));
+    dev->parallel = true;
+
+    return ESP_OK;
+}
+
+esp_err_t bme680_stop_parallel_mode(bme680_t *dev)
+{
+    CHECK_ARG(dev);
+
+    CHECK(bme680_set_mode(dev, BME680_SLEEP_MODE));
+    dev->parallel = false;
+
+    return bme680_use_heater_profile(dev, BME680_HEATER_NOT_USED);
+}
+
+esp_err_t bme680_read_parallel(bme680_t *dev, bme680_values_fixed_t *results, uint8_t *profiles, size_t *count)
+{
+    CHECK_ARG(dev && results && profiles && count);
+
+    if (!dev->parallel)
+        return ESP_ERR_INVALID_STATE;
+
+    // all three fields in one burst
+    uint8_t raw[BME680_REG_FIELDS_LEN];
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BME680_REG_RAW_DATA_0, raw, sizeof(raw)));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+
+    static const uint8_t offs[] = {
+        0,
+        BME680_REG_MEAS_STATUS_1 - BME680_REG_MEAS_STATUS_0,
+        BME680_REG_MEAS_STATUS_2 - BME680_REG_MEAS_STATUS_0
+    };
+
+    bme680_raw_data_t fields[3];
+    size_t n = 0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        if (!(raw[offs[i]] & BME680_NEW_DATA_BITS))
+            continue;
+        bme680_parse_raw_data(dev->variant, raw + offs[i], &fields[n]);
+        // keep fields in order of measurement index
+        for (size_t j = n; j > 0 && (int8_t)(fields[j].meas_index - fields[j - 1].meas_index) < 0; j--)
+        {
+            bme680_raw_data_t t = fields[j];
+            fields[j] = fields[j - 1];
+            fields[j - 1] = t;
+        }
+        n++;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        invalidate(&results[i]);
+        bme680_compensate(dev, &fields[i], &results[i]);
+        profiles[i] = fields[i].gas_index;
+    }
+    *count = n;
+
+    return ESP_OK;
+}
@@ -46,6 +46,7 @@
 #include <stdbool.h>
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +62,11 @@ extern "C" {
 #define BME680_HEATER_PROFILES         10   //!< max. 10 heater profiles 0 ... 9
 #define BME680_HEATER_NOT_USED         -1   //!< heater not used profile
 
+#define BME680_VARIANT_BME680          0x00 //!< BME680 chip variant
+#define BME680_VARIANT_BME688          0x01 //!< BME688 chip variant
+
+#define BME680_RESET_TIME_MS           10   //!< Time from soft reset until the sensor is accessible, ms
+
 /**
  * Fixed point sensor values (fixed THPG values)
  */
@@ -181,6 +187,13 @@ typedef struct
 
     bool meas_started;              //!< Indicates whether measurement started
     uint8_t meas_status;            //!< Last sensor status (for internal use only)
+    TickType_t meas_deadline;       //!< Expected end of measurement (for internal use only)
+    bool meas_ready;                //!< Results are available (for internal use only)
+    bme680_values_fixed_t meas_results; //!< Results of polled measurement (for internal use only)
+    uint8_t meas_profile;           //!< Heater profile of the last polled measurement
+    uint16_t profile_seq;           //!< Heater profile sequence mask (for internal use only)
+    bool parallel;                  //!< Parallel mode is active (for internal use only)
+    uint8_t variant;                //!< Chip variant, BME680_VARIANT_BME680 or BME680_VARIANT_BME688
 
     bme680_settings_t settings;     //!< Sensor settings
     bme680_calib_data_t calib_data; //!< Calibration data of the sensor
@@ -224,6 +237,33 @@ esp_err_t bme680_free_desc(bme680_t *dev);
  */
 esp_err_t bme680_init_sensor(bme680_t *dev);
 
+/**
+ * @brief Soft reset the sensor without waiting
+ *
+ * First half of ::bme680_init_sensor(): resets the settings in the device
+ * descriptor and sends soft reset command. ::bme680_init_after_reset() must
+ * be called not earlier than ::BME680_RESET_TIME_MS after this function.
+ * Allows to wait for resets of several devices at once.
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_reset(bme680_t *dev);
+
+/**
+ * @brief Finish initialization of the sensor after soft reset
+ *
+ * Second half of ::bme680_init_sensor(): probes the sensor, reads its
+ * calibration data and applies the default settings.
+ *
+ * @param dev Device descriptor
+ * @param keep_calib Do not read calibration data when `calib_data` and
+ *                   `variant` fields of the descriptor are already filled,
+ *                   e.g. from a cache, and `variant` matches the sensor
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_init_after_reset(bme680_t *dev, bool keep_calib);
+
 /**
  * @brief   Force one single TPHG measurement
  *
@@ -335,6 +375,54 @@ esp_err_t bme680_measure_fixed(bme680_t *dev, bme680_values_fixed_t *results);
  */
 esp_err_t bme680_measure_float(bme680_t *dev, bme680_values_float_t *results);
 
+/**
+ * @brief   Start a non-blocking measurement
+ *
+ * Starts a TPHG measurement cycle and returns immediately. Use
+ * ::bme680_poll_measurement() to check for the end of the measurement and
+ * ::bme680_finish_measurement_fixed() or ::bme680_finish_measurement_float()
+ * to get the results. This way one task can drive many sensors.
+ *
+ * @param dev Device descriptor
+ * @param[out] duration Expected duration of measurement in ticks, may be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_start_measurement(bme680_t *dev, uint32_t *duration);
+
+/**
+ * @brief   Check whether results of a started measurement are available
+ *
+ * No bus access is made before the expected measurement duration has passed.
+ * After that, status and raw results are read in one burst and converted.
+ *
+ * @param dev Device descriptor
+ * @param[out] ready true if results are available
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_poll_measurement(bme680_t *dev, bool *ready);
+
+/**
+ * @brief   Get results of a polled measurement in fixed point representation
+ *
+ * No bus access is made.
+ *
+ * @param dev Device descriptor
+ * @param[out] results pointer to a data structure that is filled with results
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if results are not ready
+ */
+esp_err_t bme680_finish_measurement_fixed(bme680_t *dev, bme680_values_fixed_t *results);
+
+/**
+ * @brief   Get results of a polled measurement in floating point representation
+ *
+ * No bus access is made.
+ *
+ * @param dev Device descriptor
+ * @param[out] results pointer to a data structure that is filled with results
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if results are not ready
+ */
+esp_err_t bme680_finish_measurement_float(bme680_t *dev, bme680_values_float_t *results);
+
 /**
  * @brief   Set the oversampling rates for measurements
  *
@@ -440,6 +528,66 @@ esp_err_t bme680_use_heater_profile(bme680_t *dev, int8_t profile);
  */
 esp_err_t bme680_set_ambient_temperature(bme680_t *dev, int16_t temperature);
 
+/**
+ * @brief   Set heater profile sequence for non-blocking measurements
+ *
+ * Each ::bme680_start_measurement() activates the next profile of the
+ * sequence, costing one register write. The profile used by a measurement
+ * is available in `meas_profile` field after ::bme680_poll_measurement()
+ * returned results. All profiles of the sequence must be set with
+ * ::bme680_set_heater_profile() before.
+ *
+ * @param dev Device descriptor
+ * @param profiles Bit mask of profiles 0 ... 9, 0 to disable sequencing
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_set_profile_sequence(bme680_t *dev, uint16_t profiles);
+
+/**
+ * @brief   Start parallel mode (BME688 only)
+ *
+ * In parallel mode the sensor cycles through heater steps continuously and
+ * TPH measurements are made during heating. Heater temperatures of steps
+ * 0 ... `steps - 1` are taken from the heater profiles, which must be set
+ * with ::bme680_set_heater_profile() before. Step `i` lasts
+ * `multipliers[i]` TPHG periods, which consist of TPH measurement time plus
+ * `shared_ms`.
+ *
+ * Heater durations of forced mode profiles are overwritten, they have to
+ * be set again after ::bme680_stop_parallel_mode().
+ *
+ * @param dev Device descriptor
+ * @param multipliers Step duration multipliers
+ * @param steps Number of heater steps, 1 ... 10
+ * @param shared_ms Shared heater duration, ms
+ * @return `ESP_OK` on success, `ESP_ERR_NOT_SUPPORTED` on BME680
+ */
+esp_err_t bme680_start_parallel_mode(bme680_t *dev, const uint8_t *multipliers, uint8_t steps, uint16_t shared_ms);
+
+/**
+ * @brief   Stop parallel mode
+ *
+ * Sensor is put to sleep mode and gas measurement is disabled.
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_stop_parallel_mode(bme680_t *dev);
+
+/**
+ * @brief   Read new results in parallel mode
+ *
+ * All three data fields are read in one burst, results are returned in
+ * order of measurement.
+ *
+ * @param dev Device descriptor
+ * @param[out] results Array of at least 3 results
+ * @param[out] profiles Array of at least 3 heater step indexes of results
+ * @param[out] count Number of new results, 0 ... 3
+ * @return `ESP_OK` on success
+ */
+esp_err_t bme680_read_parallel(bme680_t *dev, bme680_values_fixed_t *results, uint8_t *profiles, size_t *count);
+
 #ifdef __cplusplus
 }
 #endif
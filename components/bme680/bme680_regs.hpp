@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file bme680_regs.hpp
+ * @defgroup bme680_regs bme680_regs
+ * @{
+ *
+ * BME680/BME688 register map for i2cdev_regs.hpp
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __BME680_REGS_HPP__
+#define __BME680_REGS_HPP__
+
+#include <i2cdev_regs.hpp>
+
+namespace bme680_regs {
+
+using i2cdev::reg;
+using i2cdev::field;
+
+/// Field and status register of the first measurement
+struct meas_status_0 : reg<0x1d>
+{
+    typedef field<meas_status_0, 0, 4> gas_meas_index; //!< Index of heater profile
+    typedef field<meas_status_0, 5> measuring;         //!< Measurement in progress
+    typedef field<meas_status_0, 6> gas_measuring;     //!< Gas measurement in progress
+    typedef field<meas_status_0, 7> new_data;          //!< New data available
+};
+
+/// Gas control register 0
+struct ctrl_gas_0 : reg<0x70>
+{
+    typedef field<ctrl_gas_0, 3> heat_off; //!< Turn heater off
+};
+
+/// Gas control register 1
+struct ctrl_gas_1 : reg<0x71>
+{
+    typedef field<ctrl_gas_1, 0, 4> nb_conv;   //!< Heater profile to use
+    typedef field<ctrl_gas_1, 4> run_gas;      //!< Enable gas measurement, BME680
+    typedef field<ctrl_gas_1, 4, 2> run_gas_h; //!< Enable gas measurement, BME688 (value 2)
+};
+
+/// Humidity control register
+struct ctrl_hum : reg<0x72>
+{
+    typedef field<ctrl_hum, 0, 3> osrs_h;    //!< Humidity oversampling
+    typedef field<ctrl_hum, 6> spi_3w_int_en; //!< SPI 3-wire interrupt enable
+};
+
+/// Measurement control register
+struct ctrl_meas : reg<0x74>
+{
+    typedef field<ctrl_meas, 0, 2> mode;   //!< Power mode, 1 for forced mode
+    typedef field<ctrl_meas, 2, 3> osrs_p; //!< Pressure oversampling
+    typedef field<ctrl_meas, 5, 3> osrs_t; //!< Temperature oversampling
+};
+
+/// Configuration register
+struct config : reg<0x75>
+{
+    typedef field<config, 0> spi_3w_en;    //!< SPI 3-wire mode
+    typedef field<config, 2, 3> filter;    //!< IIR filter coefficient
+};
+
+/// Chip ID register
+struct id : reg<0xd0> {};
+
+/// Variant ID register, BME688 only
+struct variant_id : reg<0xf0> {};
+
+} // namespace bme680_regs
+
+/**@}*/
+
+#endif /* __BME680_REGS_HPP__ */
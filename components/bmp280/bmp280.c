@@ -35,7 +35,9 @@
  * MIT Licensed as described in the file LICENSE
  */
 
+#include <string.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <esp_idf_lib_helpers.h>
 #include "bmp280.h"
 
@@ -65,6 +67,10 @@ static const char *TAG = "bmp280";
 
 #define BMP280_RESET_VALUE     0xB6
 
+// Stream deadline shift after a duplicate sample, fraction of period
+#define STREAM_RETRY_DIV       8
+#define STREAM_RETRY_MIN_US    500
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 #define CHECK_LOGE(dev, x, msg, ...) do { \
@@ -147,6 +153,29 @@ static esp_err_t read_hum_calibration_data(bmp280_t *dev)
     return ESP_OK;
 }
 
+static esp_err_t write_config(bmp280_t *dev, const bmp280_params_t *params)
+{
+    uint8_t config = (params->standby << 5) | (params->filter << 2);
+    ESP_LOGD(TAG, "Writing config reg=%x", config);
+
+    CHECK(write_register8(&dev->i2c_dev, BMP280_REG_CONFIG, config));
+
+    uint8_t ctrl = (params->oversampling_temperature << 5) | (params->oversampling_pressure << 2) | (params->mode);
+
+    if (dev->id == BME280_CHIP_ID)
+    {
+        // Write crtl hum reg first, only active after write to BMP280_REG_CTRL.
+        uint8_t ctrl_hum = params->oversampling_humidity;
+        ESP_LOGD(TAG, "Writing ctrl hum reg=%x", ctrl_hum);
+        CHECK(write_register8(&dev->i2c_dev, BMP280_REG_CTRL_HUM, ctrl_hum));
+    }
+
+    ESP_LOGD(TAG, "Writing ctrl reg=%x", ctrl);
+    CHECK(write_register8(&dev->i2c_dev, BMP280_REG_CTRL, ctrl));
+
+    return ESP_OK;
+}
+
 esp_err_t bmp280_init_desc(bmp280_t *dev, uint8_t addr, i2c_port_t port, gpio_num_t sda_gpio, gpio_num_t scl_gpio)
 {
     CHECK_ARG(dev);
@@ -222,52 +251,69 @@ esp_err_t bmp280_init(bmp280_t *dev, bmp280_params_t *params)
         CHECK_LOGE(dev, read_hum_calibration_data(dev), "Failed to read humidity calibration data");
     }
 
-    uint8_t config = (params->standby << 5) | (params->filter << 2);
-    ESP_LOGD(TAG, "Writing config reg=%x", config);
-
-    CHECK_LOGE(dev, write_register8(&dev->i2c_dev, BMP280_REG_CONFIG, config), "Failed to configure sensor");
-
     if (params->mode == BMP280_MODE_FORCED)
     {
         params->mode = BMP280_MODE_SLEEP;  // initial mode for forced is sleep
     }
 
-    uint8_t ctrl = (params->oversampling_temperature << 5) | (params->oversampling_pressure << 2) | (params->mode);
-
-    if (dev->id == BME280_CHIP_ID)
-    {
-        // Write crtl hum reg first, only active after write to BMP280_REG_CTRL.
-        uint8_t ctrl_hum = params->oversampling_humidity;
-        ESP_LOGD(TAG, "Writing ctrl hum reg=%x", ctrl_hum);
-        CHECK_LOGE(dev, write_register8(&dev->i2c_dev, BMP280_REG_CTRL_HUM, ctrl_hum), "Failed to control sensor");
-    }
-
-    ESP_LOGD(TAG, "Writing ctrl reg=%x", ctrl);
-    CHECK_LOGE(dev, write_register8(&dev->i2c_dev, BMP280_REG_CTRL, ctrl), "Failed to control sensor");
+    CHECK_LOGE(dev, write_config(dev, params), "Failed to configure sensor");
 
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
     return ESP_OK;
 }
 
-esp_err_t bmp280_force_measurement(bmp280_t *dev)
+/**
+ * Maximal measurement time from datasheets from oversampling fields
+ * of ctrl registers, microseconds
+ */
+static uint32_t max_measurement_time_us(uint8_t ctrl, uint8_t ctrl_hum)
 {
-    CHECK_ARG(dev);
+    uint8_t osrs_t = (ctrl >> 5) & 7, osrs_p = (ctrl >> 2) & 7, osrs_h = ctrl_hum & 7;
+    uint32_t us = 1250;
+    if (osrs_t)
+        us += 2300 << (osrs_t > 5 ? 4 : osrs_t - 1);
+    if (osrs_p)
+        us += (2300 << (osrs_p > 5 ? 4 : osrs_p - 1)) + 575;
+    if (osrs_h)
+        us += (2300 << (osrs_h > 5 ? 4 : osrs_h - 1)) + 575;
+    return us;
+}
 
+static esp_err_t force_measurement(bmp280_t *dev, esp_idf_lib_ready_t *ready)
+{
     I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
 
-    uint8_t ctrl;
+    uint8_t ctrl, ctrl_hum = 0;
     I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BMP280_REG_CTRL, &ctrl, 1));
+    if (ready && dev->id == BME280_CHIP_ID)
+        I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BMP280_REG_CTRL_HUM, &ctrl_hum, 1));
     ctrl &= ~0b11;  // clear two lower bits
     ctrl |= BMP280_MODE_FORCED;
     ESP_LOGD(TAG, "Writing ctrl reg=%x", ctrl);
     CHECK_LOGE(dev, write_register8(&dev->i2c_dev, BMP280_REG_CTRL, ctrl), "Failed to start forced mode");
+    if (ready)
+        esp_idf_lib_ready_after(ready, max_measurement_time_us(ctrl, ctrl_hum));
 
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
     return ESP_OK;
 }
 
+esp_err_t bmp280_force_measurement(bmp280_t *dev)
+{
+    CHECK_ARG(dev);
+
+    return force_measurement(dev, NULL);
+}
+
+esp_err_t bmp280_force_measurement_ready(bmp280_t *dev, esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    return force_measurement(dev, ready);
+}
+
 esp_err_t bmp280_is_measuring(bmp280_t *dev, bool *busy)
 {
     CHECK_ARG(dev && busy);
@@ -303,6 +349,46 @@ static inline int32_t compensate_temperature(bmp280_t *dev, int32_t adc_temp, in
     return (*fine_temp * 5 + 128) >> 8;
 }
 
+#if CONFIG_BMP280_COMPENSATION_32BIT
+
+/**
+ * 32-bit compensation algorithm is taken from BMP280 datasheet (8.2).
+ *
+ * Return value is in Pa, 24 integer bits and 8 fractional bits. Fractional
+ * bits are always zero: this variant has a resolution of 1 Pa.
+ */
+static inline uint32_t compensate_pressure(bmp280_t *dev, int32_t adc_press, int32_t fine_temp)
+{
+    int32_t var1, var2;
+    uint32_t p;
+
+    var1 = (fine_temp >> 1) - 64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)dev->dig_P6;
+    var2 = var2 + ((var1 * (int32_t)dev->dig_P5) << 1);
+    var2 = (var2 >> 2) + ((int32_t)dev->dig_P4 << 16);
+    var1 = ((((int32_t)dev->dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + (((int32_t)dev->dig_P2 * var1) >> 1)) >> 18;
+    var1 = ((32768 + var1) * (int32_t)dev->dig_P1) >> 15;
+
+    if (var1 == 0)
+    {
+        return 0;  // avoid exception caused by division by zero
+    }
+
+    p = ((uint32_t)(1048576 - adc_press) - (var2 >> 12)) * 3125;
+    if (p < 0x80000000)
+        p = (p << 1) / (uint32_t)var1;
+    else
+        p = (p / (uint32_t)var1) * 2;
+
+    var1 = ((int32_t)dev->dig_P9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+    var2 = ((int32_t)(p >> 2) * (int32_t)dev->dig_P8) >> 13;
+
+    p = (uint32_t)((int32_t)p + ((var1 + var2 + dev->dig_P7) >> 4));
+    return p << 8;
+}
+
+#else
+
 /**
  * Compensation algorithm is taken from BMP280 datasheet.
  *
@@ -333,6 +419,8 @@ static inline uint32_t compensate_pressure(bmp280_t *dev, int32_t adc_press, int
     return p;
 }
 
+#endif
+
 /**
  * Compensation algorithm is taken from BME280 datasheet.
  *
@@ -408,3 +496,124 @@ esp_err_t bmp280_read_float(bmp280_t *dev, float *temperature, float *pressure,
 
     return ESP_OK;
 }
+
+/**
+ * Typical measurement time from BMP280/BME280 datasheets, microseconds
+ */
+static uint32_t measurement_time_us(bmp280_t *dev, const bmp280_params_t *params)
+{
+    uint32_t res = 1000;
+    if (params->oversampling_temperature)
+        res += 2000 * (1 << (params->oversampling_temperature - 1));
+    if (params->oversampling_pressure)
+        res += 2000 * (1 << (params->oversampling_pressure - 1)) + 500;
+    if (dev->id == BME280_CHIP_ID && params->oversampling_humidity)
+        res += 2000 * (1 << (params->oversampling_humidity - 1)) + 500;
+    return res;
+}
+
+static uint32_t standby_time_us(bmp280_t *dev, BMP280_StandbyTime standby)
+{
+    static const uint32_t bmp280_standby[] = { 500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000 };
+    static const uint32_t bme280_standby[] = { 500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000 };
+
+    return dev->id == BME280_CHIP_ID ? bme280_standby[standby] : bmp280_standby[standby];
+}
+
+esp_err_t bmp280_stream_start(bmp280_stream_t *stream, bmp280_t *dev, const bmp280_params_t *params)
+{
+    CHECK_ARG(stream && dev && params && params->standby <= BMP280_STANDBY_4000);
+
+    bmp280_params_t p = *params;
+    p.mode = BMP280_MODE_NORMAL;
+
+    memset(stream, 0, sizeof(bmp280_stream_t));
+    stream->dev = dev;
+    stream->size = dev->id == BME280_CHIP_ID ? 8 : 6;
+    stream->period_us = measurement_time_us(dev, &p) + standby_time_us(dev, p.standby);
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    CHECK_LOGE(dev, write_config(dev, &p), "Failed to configure sensor");
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    // First sample is ready after the first measurement
+    stream->next = esp_timer_get_time() + measurement_time_us(dev, &p);
+
+    ESP_LOGD(TAG, "Stream started, period %u us", stream->period_us);
+
+    return ESP_OK;
+}
+
+esp_err_t bmp280_stream_read(bmp280_stream_t *stream, int32_t *temperature,
+                             uint32_t *pressure, uint32_t *humidity, bool *fresh)
+{
+    CHECK_ARG(stream && stream->dev && temperature && pressure);
+
+    bmp280_t *dev = stream->dev;
+    bool res = false;
+    int64_t now = esp_timer_get_time();
+
+    if (now >= stream->next)
+    {
+        uint8_t data[8];
+
+        I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+        CHECK_LOGE(dev, i2c_dev_read_reg(&dev->i2c_dev, BMP280_REG_PRESSURE, data, stream->size), "Failed to read data");
+        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        stream->reads++;
+
+        if (stream->reads > 1 && !memcmp(data, stream->raw, stream->size))
+        {
+            // Sensor has not finished next measurement yet
+            stream->duplicates++;
+            uint32_t retry = stream->period_us / STREAM_RETRY_DIV;
+            stream->next = now + (retry < STREAM_RETRY_MIN_US ? STREAM_RETRY_MIN_US : retry);
+        }
+        else
+        {
+            memcpy(stream->raw, data, stream->size);
+
+            int32_t adc_pressure = data[0] << 12 | data[1] << 4 | data[2] >> 4;
+            int32_t adc_temp = data[3] << 12 | data[4] << 4 | data[5] >> 4;
+
+            int32_t fine_temp;
+            stream->temperature = compensate_temperature(dev, adc_temp, &fine_temp);
+            stream->pressure = compensate_pressure(dev, adc_pressure, fine_temp);
+            if (stream->size == 8)
+                stream->humidity = compensate_humidity(dev, data[6] << 8 | data[7], fine_temp);
+
+            stream->next = now + stream->period_us;
+            res = true;
+        }
+    }
+
+    *temperature = stream->temperature;
+    *pressure = stream->pressure;
+    if (humidity)
+        *humidity = stream->humidity;
+    if (fresh)
+        *fresh = res;
+
+    return ESP_OK;
+}
+
+esp_err_t bmp280_stream_stop(bmp280_stream_t *stream)
+{
+    CHECK_ARG(stream && stream->dev);
+
+    bmp280_t *dev = stream->dev;
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+
+    uint8_t ctrl;
+    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, BMP280_REG_CTRL, &ctrl, 1));
+    ctrl &= ~0b11;
+    ctrl |= BMP280_MODE_SLEEP;
+    CHECK_LOGE(dev, write_register8(&dev->i2c_dev, BMP280_REG_CTRL, ctrl), "Failed to stop normal mode");
+
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    stream->dev = NULL;
+
+    return ESP_OK;
+}
@@ -43,6 +43,7 @@
 #include <stdbool.h>
 #include <esp_err.h>
 #include <i2cdev.h>
+#include <esp_idf_lib_ready.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -139,6 +140,22 @@ typedef struct {
     uint8_t   id;       //!< Chip ID
 } bmp280_t;
 
+/**
+ * Normal mode stream descriptor
+ */
+typedef struct {
+    bmp280_t *dev;          //!< Device descriptor
+    uint32_t period_us;     //!< Expected period of measurements, microseconds
+    int64_t next;           //!< Time of next expected sample, esp_timer_get_time() units
+    size_t size;            //!< Size of burst read, bytes
+    uint8_t raw[8];         //!< Raw data of the last sample
+    int32_t temperature;    //!< Last temperature, deg.C * 100
+    uint32_t pressure;      //!< Last pressure, Pa, 24.8 fixed point
+    uint32_t humidity;      //!< Last humidity, %, 22.10 fixed point (BME280 only)
+    uint32_t reads;         //!< Number of bus reads
+    uint32_t duplicates;    //!< Number of bus reads which returned the same sample
+} bmp280_stream_t;
+
 /**
  * @brief Initialize device descriptor
  *
@@ -199,6 +216,19 @@ esp_err_t bmp280_init(bmp280_t *dev, bmp280_params_t *params);
  */
 esp_err_t bmp280_force_measurement(bmp280_t *dev);
 
+/**
+ * @brief Start measurement in forced mode and get its ready time
+ *
+ * Works as ::bmp280_force_measurement(). Maximal measurement time is
+ * calculated from oversampling settings of the chip, read results after
+ * waiting for the token instead of polling ::bmp280_is_measuring().
+ *
+ * @param dev Device descriptor
+ * @param[out] ready Conversion ready token
+ * @return `ESP_OK` on success
+ */
+esp_err_t bmp280_force_measurement_ready(bmp280_t *dev, esp_idf_lib_ready_t *ready);
+
 /**
  * @brief Check if BMP280 is busy
  *
@@ -241,6 +271,49 @@ esp_err_t bmp280_read_fixed(bmp280_t *dev, int32_t *temperature,
 esp_err_t bmp280_read_float(bmp280_t *dev, float *temperature,
                             float *pressure, float *humidity);
 
+/**
+ * @brief Start streaming measurements in normal mode
+ *
+ * Writes standby time, IIR filter and oversampling settings from `params`
+ * to the device and switches it to normal mode. Device must be
+ * initialized with ::bmp280_init() before. `params->mode` is ignored.
+ *
+ * @param stream Stream descriptor
+ * @param dev Device descriptor
+ * @param params Parameters
+ * @return `ESP_OK` on success
+ */
+esp_err_t bmp280_stream_start(bmp280_stream_t *stream, bmp280_t *dev, const bmp280_params_t *params);
+
+/**
+ * @brief Read the latest sample of the stream
+ *
+ * Bus is not touched until the expected time of the next sample, the last
+ * sample is returned instead. When the deadline has passed, the data
+ * registers are read with a single burst. If they still hold the previous
+ * sample, the deadline is shifted by a fraction of period, otherwise the
+ * new sample is compensated and the deadline is aligned to it.
+ *
+ * Values are in the same format as in ::bmp280_read_fixed().
+ *
+ * @param stream Stream descriptor
+ * @param[out] temperature Temperature, deg.C * 100
+ * @param[out] pressure Pressure
+ * @param[out] humidity Humidity, optional
+ * @param[out] fresh true if a new sample was received, optional
+ * @return `ESP_OK` on success
+ */
+esp_err_t bmp280_stream_read(bmp280_stream_t *stream, int32_t *temperature,
+                             uint32_t *pressure, uint32_t *humidity, bool *fresh);
+
+/**
+ * @brief Stop streaming and switch device to sleep mode
+ *
+ * @param stream Stream descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t bmp280_stream_stop(bmp280_stream_t *stream);
+
 #ifdef __cplusplus
 }
 #endif
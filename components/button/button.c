@@ -24,7 +24,7 @@
 /**
  * @file button.c
  *
- * ESP-IDF driver for simple GPIO buttons.
+ * ESP-IDF driver for simple GPIO and I/O expander buttons.
  *
  * Supports anti-jitter, autorepeat, long press.
  *
@@ -34,6 +34,11 @@
  */
 #include "button.h"
 #include <esp_timer.h>
+#include <esp_idf_lib_work.h>
+#if CONFIG_BUTTON_ISR
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+#endif
 
 #define DEAD_TIME_US 50000 // 50ms
 
@@ -44,10 +49,40 @@
 
 static button_t *buttons[CONFIG_BUTTON_MAX] = { NULL };
 static esp_timer_handle_t timer = NULL;
+// Polling runs in the shared worker, port reads may block on a bus
+static esp_idf_lib_work_t poll_work;
+#if CONFIG_BUTTON_ISR
+static volatile bool stop_pending = false;
+#endif
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
+static inline gpio_num_t intr_gpio(button_t *btn)
+{
+    return btn->port ? btn->port->int_gpio : btn->gpio;
+}
+
+// Returns button pin level or -1 on port read error
+static int get_level(button_t *btn)
+{
+    if (!btn->port)
+        return gpio_get_level(btn->gpio);
+
+    button_port_t *port = btn->port;
+    if (!port->internal.fresh)
+    {
+        port->internal.fresh = true;
+        // Nothing changed since last read if interrupt output is inactive
+        bool changed = port->int_gpio == GPIO_NUM_NC || !port->internal.valid
+                || gpio_get_level(port->int_gpio) == port->int_level;
+        if (changed)
+            port->internal.valid = port->read(port->ctx, &port->internal.value) == ESP_OK;
+    }
+
+    return port->internal.valid ? (port->internal.value >> btn->port_pin) & 1 : -1;
+}
+
 static void poll_button(button_t *btn)
 {
     if (btn->internal.state == BUTTON_PRESSED && btn->internal.pressed_time < DEAD_TIME_US)
@@ -57,7 +92,11 @@ static void poll_button(button_t *btn)
         return;
     }
 
-    if (gpio_get_level(btn->gpio) == btn->pressed_level)
+    int level = get_level(btn);
+    if (level < 0)
+        return;
+
+    if (level == btn->pressed_level)
     {
         // button is pressed
         if (btn->internal.state == BUTTON_RELEASED)
@@ -108,30 +147,146 @@ static void poll_button(button_t *btn)
     }
 }
 
+#if CONFIG_BUTTON_ISR
+
+// Both functions are executed in FreeRTOS timer task, so they never race
+
+static void start_polling(void *arg1, uint32_t arg2)
+{
+    // already running if ESP_ERR_INVALID_STATE
+    esp_timer_start_periodic(timer, POLL_TIMEOUT_US);
+}
+
+static void stop_polling(void *arg1, uint32_t arg2)
+{
+    stop_pending = false;
+
+    // Enable interrupts first, then check levels: any press after this
+    // point triggers start_polling() which is queued after us
+    bool pressed = false;
+    for (size_t i = 0; i < CONFIG_BUTTON_MAX; i++)
+        if (buttons[i])
+        {
+            gpio_num_t gpio = intr_gpio(buttons[i]);
+            gpio_intr_enable(gpio);
+            int level = buttons[i]->port ? buttons[i]->port->int_level : buttons[i]->pressed_level;
+            if (gpio_get_level(gpio) == level)
+                pressed = true;
+        }
+
+    if (!pressed)
+        esp_timer_stop(timer);
+}
+
+static void button_isr(void *arg)
+{
+    // Ignore bounce, button interrupt is enabled again when polling stops
+    gpio_intr_disable((gpio_num_t)(intptr_t)arg);
+
+    BaseType_t woken = pdFALSE;
+    xTimerPendFunctionCallFromISR(start_polling, NULL, 0, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+#endif
+
 static void poll(void *arg)
 {
+#if CONFIG_BUTTON_ISR
+    bool active = false;
+#endif
+    for (size_t i = 0; i < CONFIG_BUTTON_MAX; i++)
+        if (buttons[i] && buttons[i]->port)
+            buttons[i]->port->internal.fresh = false;
+
     for (size_t i = 0; i < CONFIG_BUTTON_MAX; i++)
         if (buttons[i] && buttons[i]->callback)
+        {
             poll_button(buttons[i]);
+#if CONFIG_BUTTON_ISR
+            if (buttons[i]->internal.state != BUTTON_RELEASED)
+                active = true;
+#endif
+        }
+
+#if CONFIG_BUTTON_ISR
+    if (!active && !stop_pending)
+    {
+        stop_pending = true;
+        if (xTimerPendFunctionCall(stop_polling, NULL, 0, 0) != pdPASS)
+            stop_pending = false;
+    }
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 static const esp_timer_create_args_t timer_args = {
-    .arg = NULL,
+    .arg = &poll_work,
     .name = "poll_buttons",
     .dispatch_method = ESP_TIMER_TASK,
-    .callback = poll,
+    .callback = esp_idf_lib_work_timer_cb,
 };
 
+#if CONFIG_BUTTON_ISR
+static esp_err_t setup_intr(gpio_num_t gpio)
+{
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        return res;
+    CHECK(gpio_set_intr_type(gpio, GPIO_INTR_ANYEDGE));
+    CHECK(gpio_isr_handler_add(gpio, button_isr, (void *)(intptr_t)gpio));
+    return gpio_intr_enable(gpio);
+}
+#endif
+
+static esp_err_t setup_port(button_port_t *port)
+{
+    if (port->internal.users++)
+        return ESP_OK;
+
+    port->internal.valid = false;
+    if (port->int_gpio == GPIO_NUM_NC)
+        return ESP_OK;
+
+    CHECK(gpio_set_direction(port->int_gpio, GPIO_MODE_INPUT));
+    // Interrupt outputs are usually open-drain
+    CHECK(gpio_set_pull_mode(port->int_gpio, port->int_level ? GPIO_PULLDOWN_ONLY : GPIO_PULLUP_ONLY));
+#if CONFIG_BUTTON_ISR
+    CHECK(setup_intr(port->int_gpio));
+#endif
+
+    return ESP_OK;
+}
+
+static void release_port(button_port_t *port)
+{
+    if (--port->internal.users || port->int_gpio == GPIO_NUM_NC)
+        return;
+#if CONFIG_BUTTON_ISR
+    gpio_isr_handler_remove(port->int_gpio);
+    gpio_set_intr_type(port->int_gpio, GPIO_INTR_DISABLE);
+#endif
+}
+
 esp_err_t button_init(button_t *btn)
 {
     CHECK_ARG(btn);
+    CHECK_ARG(!btn->port || (btn->port->read && btn->port_pin < 32));
+#if CONFIG_BUTTON_ISR
+    CHECK_ARG(!btn->port || btn->port->int_gpio != GPIO_NUM_NC);
+#endif
 
     if (!timer)
+    {
+        CHECK(esp_idf_lib_worker_start());
+        CHECK(esp_idf_lib_work_init(&poll_work, poll, NULL, ESP_IDF_LIB_WORK_HIGH));
         CHECK(esp_timer_create(&timer_args, &timer));
+    }
 
     esp_timer_stop(timer);
+    esp_idf_lib_work_flush(&poll_work);
 
     esp_err_t res = ESP_ERR_NO_MEM;
 
@@ -145,6 +300,17 @@ esp_err_t button_init(button_t *btn)
             btn->internal.state = BUTTON_RELEASED;
             btn->internal.pressed_time = 0;
             btn->internal.repeating_time = 0;
+            if (btn->port)
+            {
+                res = setup_port(btn->port);
+                if (res != ESP_OK)
+                {
+                    btn->port->internal.users--;
+                    break;
+                }
+                buttons[i] = btn;
+                break;
+            }
             res = gpio_set_direction(btn->gpio, GPIO_MODE_INPUT);
             if (res != ESP_OK) break;
             if (btn->internal_pull)
@@ -152,6 +318,10 @@ esp_err_t button_init(button_t *btn)
                 res = gpio_set_pull_mode(btn->gpio, btn->pressed_level ? GPIO_PULLDOWN_ONLY : GPIO_PULLUP_ONLY);
                 if (res != ESP_OK) break;
             }
+#if CONFIG_BUTTON_ISR
+            res = setup_intr(btn->gpio);
+            if (res != ESP_OK) break;
+#endif
             buttons[i] = btn;
             break;
         }
@@ -166,12 +336,22 @@ esp_err_t button_done(button_t *btn)
     CHECK_ARG(btn);
 
     esp_timer_stop(timer);
+    esp_idf_lib_work_flush(&poll_work);
 
     esp_err_t res = ESP_ERR_INVALID_ARG;
 
     for (size_t i = 0; i < CONFIG_BUTTON_MAX; i++)
         if (buttons[i] == btn)
         {
+            if (btn->port)
+                release_port(btn->port);
+#if CONFIG_BUTTON_ISR
+            else
+            {
+                gpio_isr_handler_remove(btn->gpio);
+                gpio_set_intr_type(btn->gpio, GPIO_INTR_DISABLE);
+            }
+#endif
             buttons[i] = NULL;
             res = ESP_OK;
             break;
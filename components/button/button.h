@@ -26,7 +26,7 @@
  * @defgroup button button
  * @{
  *
- * ESP-IDF driver for simple GPIO buttons.
+ * ESP-IDF driver for simple GPIO and I/O expander buttons.
  *
  * Supports anti-jitter, auto repeat, long press.
  *
@@ -69,12 +69,51 @@ typedef enum {
  */
 typedef void (*button_event_cb_t)(button_t *btn, button_state_t state);
 
+/**
+ * Port read function prototype
+ *
+ * Must read all pins of the port in one transaction, e.g. wrapper for
+ * mcp23x17_port_read() or pcf8574_port_read(). gpio_expander_port_read()
+ * can be used directly with `gpio_expander_t` as context
+ *
+ * @param ctx        User context, e.g. I/O expander descriptor
+ * @param[out] value Pin levels, bit N is level of pin N
+ * @return `ESP_OK` on success
+ */
+typedef esp_err_t (*button_port_read_t)(void *ctx, uint32_t *value);
+
+/**
+ * Port descriptor, source of pin levels for buttons connected to
+ * an I/O expander
+ *
+ * Port is read once per poll for all its buttons. If interrupt output of
+ * the expander is connected, port is read only when interrupt is active
+ * or some of its buttons is pressed. Interrupt output must be configured
+ * to trigger on change of the button pins, e.g. with
+ * mcp23x17_set_interrupt().
+ */
+typedef struct
+{
+    button_port_read_t read;        //!< Port read function
+    void *ctx;                      //!< Context for read function
+    gpio_num_t int_gpio;            //!< GPIO connected to expander interrupt output, GPIO_NUM_NC if not used
+    uint8_t int_level;              //!< Logic level of active interrupt output
+    struct {
+        uint32_t value;
+        bool valid;
+        bool fresh;
+        size_t users;
+    } internal;                     //!< Internal port state
+} button_port_t;
+
 /**
  * Button descriptor struct
  */
 struct button_s
 {
-    gpio_num_t gpio;                //!< GPIO
+    gpio_num_t gpio;                //!< GPIO, ignored if `port` is set
+    button_port_t *port;            //!< Port for expander buttons, NULL for native GPIO
+    uint8_t port_pin;               //!< Pin number in port
     bool internal_pull;             //!< Enable internal pull-up/pull-down
     uint8_t pressed_level;          //!< Logic level of pressed button
     bool autorepeat;                //!< Enable autorepeat
@@ -89,6 +128,13 @@ struct button_s
 /**
  * @brief Init button
  *
+ * Buttons sharing the same port must point to the same port descriptor.
+ * With CONFIG_BUTTON_ISR expander buttons require interrupt output of
+ * the expander to be connected.
+ *
+ * Buttons are polled and callbacks are called in the shared worker task
+ * (see esp_idf_lib_work.h), not in the esp_timer task.
+ *
  * @param btn Pointer to button descriptor
  * @return `ESP_OK` on success
  */
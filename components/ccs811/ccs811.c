@@ -87,6 +87,10 @@ static const char *TAG = "ccs811";
 #define CCS811_ERR_HEATER_FAULT    0x10  // heater current not in range
 #define CCS811_ERR_HEATER_SUPPLY   0x20  // heater voltage not applied correctly
 
+// nWAKE timing, us
+#define CCS811_T_AWAKE             50    // nWAKE low to I2C start
+#define CCS811_T_DWAKE             20    // minimal nWAKE high time
+
 /**
  * Type declarations
  */
@@ -112,11 +116,29 @@ typedef struct
 ///////////////////////////////////////////////////////////////////////////////
 /// Static functions
 
+static inline void wake_assert(ccs811_dev_t *dev)
+{
+    if (!dev->use_wake)
+        return;
+    gpio_set_level(dev->wake_gpio, 0);
+    ets_delay_us(CCS811_T_AWAKE);
+}
+
+static inline void wake_release(ccs811_dev_t *dev)
+{
+    if (!dev->use_wake)
+        return;
+    gpio_set_level(dev->wake_gpio, 1);
+    ets_delay_us(CCS811_T_DWAKE);
+}
+
 static esp_err_t read_reg_nolock(ccs811_dev_t *dev, uint8_t reg, uint8_t *data, uint32_t len)
 {
     ESP_LOGD(TAG, "Read %d byte from i2c slave starting at reg addr %02x.", len, reg);
 
+    wake_assert(dev);
     esp_err_t res = i2c_dev_read_reg(&dev->i2c_dev, reg, data, len);
+    wake_release(dev);
     if (res != ESP_OK)
     {
         ESP_LOGE(TAG, "Error %d on read %d byte from I2C slave reg addr %02x.", res, len, reg);
@@ -130,7 +152,9 @@ static esp_err_t write_reg_nolock(ccs811_dev_t *dev, uint8_t reg, uint8_t *data,
 {
     ESP_LOGD(TAG, "Write %d bytes to i2c slave starting at reg addr %02x", len, reg);
 
+    wake_assert(dev);
     esp_err_t res = i2c_dev_write_reg(&dev->i2c_dev, reg, data, len);
+    wake_release(dev);
     if (res != ESP_OK)
     {
         ESP_LOGE(TAG, "Error %d on write %d byte to i2c slave register %02x.", res, len, reg);
@@ -147,9 +171,9 @@ static esp_err_t ccs811_is_available(ccs811_dev_t *dev)
     uint8_t reg_data[5];
 
     // check hardware id (register 0x20) and hardware version (register 0x21)
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_HW_ID, reg_data, 5));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_HW_ID, reg_data, 5));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     if (reg_data[0] != 0x81)
     {
@@ -173,20 +197,20 @@ static esp_err_t ccs811_enable_threshold(ccs811_dev_t *dev, bool enabled)
     // first, enable/disable the data ready interrupt
     CHECK(ccs811_enable_interrupt(dev, enabled));
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // read measurement mode register value
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
 
     // second, enable/disable the threshold interrupt mode
     reg.int_thresh = enabled;
 
     // write back measurement mode register
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             write_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1),
             "Could not set measurement mode register.");
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -196,22 +220,22 @@ static esp_err_t ccs811_check_error_status(ccs811_dev_t *dev)
     uint8_t status;
     uint8_t err_reg;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // check status register
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_STATUS, &status, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_STATUS, &status, 1));
 
     if (!status & CCS811_STATUS_ERROR)
     {
         // everything is fine
-        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        I2C_DEV_SESSION_END(&dev->i2c_dev);
         return ESP_OK;
     }
 
     // Check the error register
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_ERROR_ID, &err_reg, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_ERROR_ID, &err_reg, 1));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     if (err_reg & CCS811_ERR_WRITE_REG_INV)
     {
@@ -272,10 +296,31 @@ esp_err_t ccs811_init_desc(ccs811_dev_t *dev, uint8_t addr, i2c_port_t port, gpi
     dev->i2c_dev.cfg.master.clk_speed = I2C_FREQ_HZ;
 #endif
     dev->i2c_dev.timeout_ticks = I2CDEV_MAX_STRETCH_TIME;
+    dev->use_wake = false;
 
     return i2c_dev_create_mutex(&dev->i2c_dev);
 }
 
+esp_err_t ccs811_set_wake_gpio(ccs811_dev_t *dev, gpio_num_t wake_gpio)
+{
+    CHECK_ARG(dev);
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << wake_gpio;
+    io_conf.mode = GPIO_MODE_OUTPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_DISABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_DISABLE;
+
+    // sensor sleeps between transactions
+    CHECK(gpio_set_level(wake_gpio, 1));
+    CHECK(gpio_config(&io_conf));
+    dev->wake_gpio = wake_gpio;
+    dev->use_wake = true;
+
+    return ESP_OK;
+}
+
 esp_err_t ccs811_free_desc(ccs811_dev_t *dev)
 {
     CHECK_ARG(dev);
@@ -283,7 +328,7 @@ esp_err_t ccs811_free_desc(ccs811_dev_t *dev)
     return i2c_dev_delete_mutex(&dev->i2c_dev);
 }
 
-esp_err_t ccs811_init(ccs811_dev_t *dev)
+esp_err_t ccs811_reset(ccs811_dev_t *dev)
 {
     CHECK_ARG(dev);
 
@@ -303,10 +348,21 @@ esp_err_t ccs811_init(ccs811_dev_t *dev)
             write_reg_nolock(dev, CCS811_REG_SW_RESET, (uint8_t *)sw_reset, 4),
             "Could not reset the sensor.");
 
-    uint8_t status;
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
-    // wait 100 ms after the reset
-    vTaskDelay(pdMS_TO_TICKS(100));
+    return ESP_OK;
+}
+
+esp_err_t ccs811_app_start(ccs811_dev_t *dev, bool *started)
+{
+    CHECK_ARG(dev);
+
+    if (started)
+        *started = false;
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+
+    uint8_t status;
 
     // get the status to check whether sensor is in bootloader mode
     I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
@@ -327,31 +383,65 @@ esp_err_t ccs811_init(ccs811_dev_t *dev)
 
         // swtich to application mode
         uint8_t r = CCS811_REG_APP_START;
-        I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
-                i2c_dev_write(&dev->i2c_dev, NULL, 0, &r, 1),
-                "Could not start application.");
-
-        // wait 100 ms after starting the app
-        vTaskDelay(pdMS_TO_TICKS(100));
-
-        // get the status to check whether sensor switched to application mode
-        I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
-                read_reg_nolock(dev, CCS811_REG_STATUS, &status, 1),
-                "Could not read application status.");
-        if (!(status & CCS811_STATUS_FW_MODE))
-        {
-            ESP_LOGE(TAG, "Could not start application, invalid status 0x%02x.", status);
-            I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
-            return CCS811_ERR_APP_START_FAIL;
-        }
+        wake_assert(dev);
+        esp_err_t res = i2c_dev_write(&dev->i2c_dev, NULL, 0, &r, 1);
+        wake_release(dev);
+        I2C_DEV_CHECK_LOGE(&dev->i2c_dev, res, "Could not start application.");
+
+        if (started)
+            *started = true;
+    }
+
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    return ESP_OK;
+}
+
+esp_err_t ccs811_init_after_app_start(ccs811_dev_t *dev)
+{
+    CHECK_ARG(dev);
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+
+    uint8_t status;
+
+    // get the status to check whether sensor switched to application mode
+    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+            read_reg_nolock(dev, CCS811_REG_STATUS, &status, 1),
+            "Could not read application status.");
+    if (!(status & CCS811_STATUS_FW_MODE))
+    {
+        ESP_LOGE(TAG, "Could not start application, invalid status 0x%02x.", status);
+        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        return CCS811_ERR_APP_START_FAIL;
     }
 
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
     // try to set default measurement mode to CCS811_MODE_1S
-    CHECK(ccs811_set_mode(dev, CCS811_MODE_1S));
+    return ccs811_set_mode(dev, CCS811_MODE_1S);
+}
 
-    return ESP_OK;
+esp_err_t ccs811_init_after_reset(ccs811_dev_t *dev)
+{
+    bool started;
+    CHECK(ccs811_app_start(dev, &started));
+
+    // wait 100 ms after starting the app
+    if (started)
+        vTaskDelay(pdMS_TO_TICKS(CCS811_APP_START_TIME_MS));
+
+    return ccs811_init_after_app_start(dev);
+}
+
+esp_err_t ccs811_init(ccs811_dev_t *dev)
+{
+    CHECK(ccs811_reset(dev));
+
+    // wait 100 ms after the reset
+    vTaskDelay(pdMS_TO_TICKS(CCS811_RESET_TIME_MS));
+
+    return ccs811_init_after_reset(dev);
 }
 
 esp_err_t ccs811_set_mode(ccs811_dev_t *dev, ccs811_mode_t mode)
@@ -360,32 +450,32 @@ esp_err_t ccs811_set_mode(ccs811_dev_t *dev, ccs811_mode_t mode)
 
     ccs811_meas_mode_reg_t reg;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // read measurement mode register value
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
 
     reg.drive_mode = mode;
 
     // write back measurement mode register
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             write_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1),
             "Could not set measurement mode.");
 
     // check whether setting measurement mode were succesfull
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1),
             "Could not set measurement mode.");
 
     if (reg.drive_mode != mode)
     {
         ESP_LOGE(TAG, "Could not set measurement mode to %d", mode);
-        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        I2C_DEV_SESSION_END(&dev->i2c_dev);
         return CCS811_ERR_MM_INV;
     }
 
     dev->mode = mode;
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -419,11 +509,11 @@ esp_err_t ccs811_get_results(ccs811_dev_t *dev, uint16_t *iaq_tvoc,
     uint8_t data[8];
 
     // read IAQ sensor values and RAW sensor data including status and error id
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             read_reg_nolock(dev, CCS811_REG_ALG_RESULT_DATA, data, 8),
             "Could not read sensor data.");
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     // check for errors
     if (data[CCS811_ALG_DATA_STATUS] & CCS811_STATUS_ERROR)
@@ -459,9 +549,9 @@ esp_err_t ccs811_get_ntc_resistance(ccs811_dev_t *dev, uint32_t r_ref,
     uint8_t data[4];
 
     // read baseline register
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_NTC, data, 4));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_NTC, data, 4));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     // calculation from application note ams AN000372
     uint16_t v_ref = (uint16_t) (data[0]) << 8 | data[1];
@@ -484,11 +574,11 @@ esp_err_t ccs811_set_environmental_data(ccs811_dev_t *dev,
     uint8_t data[4] = { temp >> 8, temp & 0xff, hum >> 8, hum & 0xff };
 
     // send environmental data to the sensor
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             write_reg_nolock(dev, CCS811_REG_ENV_DATA, data, 4),
             "Could not write environmental data to sensor.");
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -514,11 +604,11 @@ esp_err_t ccs811_set_eco2_thresholds(ccs811_dev_t *dev, uint16_t low,
     uint8_t data[5] = { low >> 8, low & 0xff, high >> 8, high & 0xff, hysteresis };
 
     // write threshold data to the sensor
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK_LOGE(&dev->i2c_dev,
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK_LOGE(&dev->i2c_dev,
             write_reg_nolock(dev, CCS811_REG_THRESHOLDS, data, 5),
             "Could not write threshold interrupt data to sensor.");
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     // finally enable the threshold interrupt mode    
     return ccs811_enable_threshold(dev, true);
@@ -530,18 +620,18 @@ esp_err_t ccs811_enable_interrupt(ccs811_dev_t *dev, bool enabled)
 
     ccs811_meas_mode_reg_t reg;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // read measurement mode register value
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
 
     reg.int_datardy = enabled;
     reg.int_thresh = false;      // threshold mode must not enabled
 
     // write back measurement mode register
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_nolock(dev, CCS811_REG_MEAS_MODE, (uint8_t *)&reg, 1));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -552,10 +642,10 @@ esp_err_t ccs811_get_baseline(ccs811_dev_t *dev, uint16_t *baseline)
 
     uint8_t data[2];
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
     // read baseline register
-    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_BASELINE, data, 2));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_reg_nolock(dev, CCS811_REG_BASELINE, data, 2));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     *baseline = (uint16_t) (data[0]) << 8 | data[1];
 
@@ -568,10 +658,10 @@ esp_err_t ccs811_set_baseline(ccs811_dev_t *dev, uint16_t baseline)
 
     uint8_t data[2] = { baseline >> 8, baseline & 0xff };
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
     // write baseline register
-    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_nolock(dev, CCS811_REG_BASELINE, data, 2));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_reg_nolock(dev, CCS811_REG_BASELINE, data, 2));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
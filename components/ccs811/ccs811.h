@@ -51,6 +51,9 @@
 #define CCS811_I2C_ADDRESS_1      0x5a      //!< default
 #define CCS811_I2C_ADDRESS_2      0x5b
 
+#define CCS811_RESET_TIME_MS      100       //!< Time from software reset until the sensor is accessible, ms
+#define CCS811_APP_START_TIME_MS  100       //!< Time from application start until the sensor is accessible, ms
+
 #define CCS811_ERR_BASE 0xa000
 
 //!< CCS811 driver error codes ORed with error codes for I2C the interface
@@ -99,8 +102,10 @@ typedef enum
  */
 typedef struct
 {
-    i2c_dev_t i2c_dev;  //!< I2C device handle
-    ccs811_mode_t mode; //!< operation mode
+    i2c_dev_t i2c_dev;    //!< I2C device handle
+    ccs811_mode_t mode;   //!< operation mode
+    bool use_wake;        //!< nWAKE pin is controlled by driver
+    gpio_num_t wake_gpio; //!< GPIO connected to nWAKE
 } ccs811_dev_t;
 
 /**
@@ -115,6 +120,21 @@ typedef struct
  */
 esp_err_t ccs811_init_desc(ccs811_dev_t *dev, uint8_t addr, i2c_port_t port, gpio_num_t sda_gpio, gpio_num_t scl_gpio);
 
+/**
+ * @brief Control nWAKE pin of the sensor
+ *
+ * nWAKE is asserted 50 us before every I2C transaction and released
+ * right after it, so the I2C interface of the sensor sleeps between
+ * transactions. Without this function nWAKE must be tied to GND.
+ *
+ * Call before ::ccs811_init().
+ *
+ * @param dev Device descriptor
+ * @param wake_gpio GPIO connected to nWAKE
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_set_wake_gpio(ccs811_dev_t *dev, gpio_num_t wake_gpio);
+
 /**
  * @brief Free device descriptor
  *
@@ -134,6 +154,59 @@ esp_err_t ccs811_free_desc(ccs811_dev_t *dev);
  */
 esp_err_t ccs811_init(ccs811_dev_t *dev);
 
+/**
+ * @brief Check availability of a CCS811 sensor and reset it without waiting
+ *
+ * First half of ::ccs811_init(). ::ccs811_init_after_reset() must be
+ * called not earlier than ::CCS811_RESET_TIME_MS after this function.
+ *
+ * @param dev Pointer to the sensor device data structure
+ *
+ * @returns ESP_OK on success
+ */
+esp_err_t ccs811_reset(ccs811_dev_t *dev);
+
+/**
+ * @brief Finish initialization of a CCS811 sensor after reset
+ *
+ * Second half of ::ccs811_init(): starts the application firmware if the
+ * sensor is in boot mode and sets measurement mode ::CCS811_MODE_1S.
+ * Blocks for ::CCS811_APP_START_TIME_MS while the application starts, use
+ * ::ccs811_app_start() and ::ccs811_init_after_app_start() to avoid it.
+ *
+ * @param dev Pointer to the sensor device data structure
+ *
+ * @returns ESP_OK on success
+ */
+esp_err_t ccs811_init_after_reset(ccs811_dev_t *dev);
+
+/**
+ * @brief Start application firmware of a CCS811 sensor without waiting
+ *
+ * First half of ::ccs811_init_after_reset(). If the sensor is in boot mode,
+ * the application is started and ::ccs811_init_after_app_start() must be
+ * called not earlier than ::CCS811_APP_START_TIME_MS after this function.
+ *
+ * @param dev Pointer to the sensor device data structure
+ * @param[out] started true if the application has been started, i.e. the
+ *                     caller must wait, may be NULL
+ *
+ * @returns ESP_OK on success
+ */
+esp_err_t ccs811_app_start(ccs811_dev_t *dev, bool *started);
+
+/**
+ * @brief Finish initialization of a CCS811 sensor after application start
+ *
+ * Second half of ::ccs811_init_after_reset(): checks that the application
+ * is running and sets measurement mode ::CCS811_MODE_1S.
+ *
+ * @param dev Pointer to the sensor device data structure
+ *
+ * @returns ESP_OK on success
+ */
+esp_err_t ccs811_init_after_app_start(ccs811_dev_t *dev);
+
 /**
  * @brief Set the operation mode of the sensor
  *
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file ccs811_baseline.c
+ *
+ * CCS811 baseline persistence in NVS
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdio.h>
+#include <string.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <nvs.h>
+#include "ccs811_baseline.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define NVS_NAMESPACE "ccs811"
+
+// save intervals: sensor age only during burn-in, then baseline
+// daily during the first week and weekly after that
+#define SAVE_INTERVAL_BURN_IN (3600LL * 1000000)
+#define SAVE_INTERVAL_WEEK1   (24LL * 3600 * 1000000)
+#define SAVE_INTERVAL         (7LL * 24 * 3600 * 1000000)
+#define WEEK_S                (7 * 24 * 3600)
+
+static const char *TAG = "ccs811_baseline";
+
+typedef struct
+{
+    uint32_t age;
+    uint16_t baseline;
+    uint8_t mode;
+    uint8_t reserved;
+} record_t;
+
+static inline void record_key(ccs811_baseline_t *bl, char *key, size_t size)
+{
+    snprintf(key, size, "%d_%02x", bl->dev->i2c_dev.port, bl->dev->i2c_dev.addr);
+}
+
+static inline bool measures_iaq(ccs811_mode_t mode)
+{
+    return mode == CCS811_MODE_1S || mode == CCS811_MODE_10S || mode == CCS811_MODE_60S;
+}
+
+static inline uint32_t age_now(ccs811_baseline_t *bl, int64_t now)
+{
+    return bl->age + (uint32_t)((now - bl->started) / 1000000);
+}
+
+esp_err_t ccs811_baseline_init(ccs811_baseline_t *bl, ccs811_dev_t *dev)
+{
+    CHECK_ARG(bl && dev);
+
+    memset(bl, 0, sizeof(ccs811_baseline_t));
+    bl->dev = dev;
+    bl->started = bl->saved = esp_timer_get_time();
+
+    char key[16];
+    record_key(bl, key, sizeof(key));
+
+    record_t rec;
+    size_t size = sizeof(rec);
+
+    nvs_handle_t nvs;
+    esp_err_t res = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if (res == ESP_ERR_NVS_NOT_FOUND)
+        return ESP_OK;
+    CHECK(res);
+    res = nvs_get_blob(nvs, key, &rec, &size);
+    nvs_close(nvs);
+    if (res == ESP_ERR_NVS_NOT_FOUND)
+        return ESP_OK;
+    CHECK(res);
+
+    if (size != sizeof(rec))
+        return ESP_ERR_INVALID_SIZE;
+
+    bl->age = rec.age;
+    bl->baseline = rec.baseline;
+    bl->mode = rec.mode;
+    ESP_LOGD(TAG, "Sensor age %u h, baseline 0x%04x", (unsigned)(bl->age / 3600), bl->baseline);
+
+    return ESP_OK;
+}
+
+esp_err_t ccs811_baseline_update(ccs811_baseline_t *bl)
+{
+    CHECK_ARG(bl && bl->dev);
+
+    int64_t now = esp_timer_get_time();
+
+    if (!bl->restored && !bl->skip_restore && bl->baseline
+            && now - bl->started >= CCS811_CONDITIONING_TIME_S * 1000000LL)
+    {
+        if (bl->mode == bl->dev->mode)
+        {
+            CHECK(ccs811_set_baseline(bl->dev, bl->baseline));
+            bl->restored = true;
+            ESP_LOGD(TAG, "Baseline 0x%04x restored", bl->baseline);
+        }
+        else
+            // baseline of another mode, let the sensor learn its own but
+            // keep the stored one until then
+            bl->skip_restore = true;
+    }
+
+    uint32_t age = age_now(bl, now);
+    int64_t interval = age < CCS811_BURN_IN_TIME_S
+            ? SAVE_INTERVAL_BURN_IN
+            : age < CCS811_BURN_IN_TIME_S + WEEK_S ? SAVE_INTERVAL_WEEK1 : SAVE_INTERVAL;
+    if (now - bl->saved < interval)
+        return ESP_OK;
+
+    return ccs811_baseline_save(bl);
+}
+
+esp_err_t ccs811_baseline_mode_changed(ccs811_baseline_t *bl)
+{
+    CHECK_ARG(bl && bl->dev);
+
+    int64_t now = esp_timer_get_time();
+    bl->age = age_now(bl, now);
+    bl->started = now;
+    bl->restored = false;
+    bl->skip_restore = false;
+
+    return ESP_OK;
+}
+
+esp_err_t ccs811_baseline_save(ccs811_baseline_t *bl)
+{
+    CHECK_ARG(bl && bl->dev);
+
+    int64_t now = esp_timer_get_time();
+    int64_t running = now - bl->started;
+
+    record_t rec = {
+        .age = age_now(bl, now),
+        .baseline = bl->baseline,
+        .mode = bl->mode,
+    };
+
+    bool fresh = rec.age >= CCS811_BURN_IN_TIME_S && measures_iaq(bl->dev->mode)
+            && ((bl->restored && running >= CCS811_CONDITIONING_TIME_S * 1000000LL)
+                || running >= CCS811_BASELINE_LEARN_S * 1000000LL);
+    if (fresh)
+    {
+        CHECK(ccs811_get_baseline(bl->dev, &rec.baseline));
+        rec.mode = bl->dev->mode;
+    }
+
+    char key[16];
+    record_key(bl, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs));
+    esp_err_t res = nvs_set_blob(nvs, key, &rec, sizeof(rec));
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+    CHECK(res);
+
+    if (fresh)
+    {
+        // sensor already uses the baseline just read, nothing to restore
+        bl->baseline = rec.baseline;
+        bl->mode = rec.mode;
+        bl->restored = true;
+    }
+    bl->saved = now;
+    ESP_LOGD(TAG, "Sensor age %u h, baseline 0x%04x saved", (unsigned)(rec.age / 3600), rec.baseline);
+
+    return ESP_OK;
+}
+
+esp_err_t ccs811_baseline_erase(ccs811_baseline_t *bl)
+{
+    CHECK_ARG(bl && bl->dev);
+
+    char key[16];
+    record_key(bl, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs));
+    esp_err_t res = nvs_erase_key(nvs, key);
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+    if (res == ESP_ERR_NVS_NOT_FOUND)
+        res = ESP_OK;
+    CHECK(res);
+
+    bl->age = 0;
+    bl->baseline = 0;
+    bl->restored = false;
+    bl->skip_restore = false;
+
+    return ESP_OK;
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file ccs811_baseline.h
+ * @defgroup ccs811_baseline ccs811_baseline
+ * @{
+ *
+ * CCS811 baseline persistence in NVS
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __CCS811_BASELINE_H__
+#define __CCS811_BASELINE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ccs811.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CCS811_BURN_IN_TIME_S      (48 * 3600) //!< Sensor operating time before its baseline is saved, s
+#define CCS811_CONDITIONING_TIME_S (20 * 60)   //!< Time from mode setting until baseline can be written, s
+#define CCS811_BASELINE_LEARN_S    (24 * 3600) //!< Time of automatic baseline correction without restored baseline, s
+
+/**
+ * Baseline manager
+ */
+typedef struct
+{
+    ccs811_dev_t *dev;   //!< Device descriptor
+    uint32_t age;        //!< Sensor operating time at `started`, s
+    uint16_t baseline;   //!< Baseline stored in NVS, 0 if none
+    ccs811_mode_t mode;  //!< Measurement mode of stored baseline
+    bool restored;       //!< Stored baseline has been written to the sensor
+    bool skip_restore;   //!< Stored baseline is of another mode, internal
+    int64_t started;     //!< Time of ::ccs811_baseline_init() or last mode change, microseconds
+                         //!< since boot, internal
+    int64_t saved;       //!< Time of last save, microseconds since boot, internal
+} ccs811_baseline_t;
+
+/**
+ * @brief Load stored baseline and sensor age from NVS
+ *
+ * Call right after ::ccs811_init() or ::ccs811_set_mode(): the
+ * conditioning period is counted from this moment. Record is stored under
+ * the key made of I2C port and address.
+ *
+ * NVS must be initialized before calling this function.
+ *
+ * @param bl Baseline manager
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success, also when there is no stored record
+ */
+esp_err_t ccs811_baseline_init(ccs811_baseline_t *bl, ccs811_dev_t *dev);
+
+/**
+ * @brief Restore and save baseline when it is time to
+ *
+ * Call periodically, e.g. after ::ccs811_get_results(). Stored baseline
+ * is written to the sensor once, after ::CCS811_CONDITIONING_TIME_S and
+ * only if it was saved in the current measurement mode. A baseline of
+ * another mode is kept in NVS until the sensor learns its own. Record is saved
+ * hourly until sensor age reaches ::CCS811_BURN_IN_TIME_S (sensor age
+ * only), daily during the first week and weekly after that.
+ *
+ * @param bl Baseline manager
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_baseline_update(ccs811_baseline_t *bl);
+
+/**
+ * @brief Restart conditioning after measurement mode change
+ *
+ * Call right after ::ccs811_set_mode(). Stored baseline is restored again
+ * after ::CCS811_CONDITIONING_TIME_S if it matches the new mode.
+ *
+ * @param bl Baseline manager
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_baseline_mode_changed(ccs811_baseline_t *bl);
+
+/**
+ * @brief Save sensor age and baseline to NVS now
+ *
+ * Call before powering the sensor down. Baseline is read from the sensor
+ * and saved only if the sensor is past its burn-in period, measures IAQ
+ * values and either the stored baseline has been restored and the sensor
+ * is conditioned or it has been running for ::CCS811_BASELINE_LEARN_S.
+ * Otherwise only sensor age is updated.
+ *
+ * @param bl Baseline manager
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_baseline_save(ccs811_baseline_t *bl);
+
+/**
+ * @brief Erase stored record
+ *
+ * Call when the sensor is replaced.
+ *
+ * @param bl Baseline manager
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_baseline_erase(ccs811_baseline_t *bl);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __CCS811_BASELINE_H__ */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ccs811_stream.c
+ *
+ * CCS811 results reader driven by nINT pin
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include "ccs811_stream.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "ccs811_stream";
+
+static const uint32_t periods_ms[] = {
+    [CCS811_MODE_IDLE]  = 0,
+    [CCS811_MODE_1S]    = 1000,
+    [CCS811_MODE_10S]   = 10000,
+    [CCS811_MODE_60S]   = 60000,
+    [CCS811_MODE_250MS] = 250,
+};
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR ready_isr(void *arg)
+#else
+static void ready_isr(void *arg)
+#endif
+{
+    ccs811_stream_t *stream = (ccs811_stream_t *)arg;
+
+    stream->ready_time = esp_timer_get_time();
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(stream->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static void reader_task(void *arg)
+{
+    ccs811_stream_t *stream = (ccs811_stream_t *)arg;
+    TickType_t timeout = pdMS_TO_TICKS(periods_ms[stream->dev->mode] * 2);
+    bool raw_only = stream->dev->mode == CCS811_MODE_250MS;
+    ccs811_sample_t s = { 0 };
+
+    while (stream->running)
+    {
+        if (!ulTaskNotifyTake(pdTRUE, timeout))
+        {
+            // lost edge or failed read, nINT is still asserted
+            if (gpio_get_level(stream->gpio))
+                continue;
+            stream->ready_time = esp_timer_get_time();
+        }
+        if (!stream->running)
+            break;
+
+        // 64-bit value can be torn by ISR
+        do
+            s.timestamp = stream->ready_time;
+        while (s.timestamp != stream->ready_time);
+
+        esp_err_t res = raw_only
+            ? ccs811_get_results(stream->dev, NULL, NULL, &s.raw_i, &s.raw_v)
+            : ccs811_get_results(stream->dev, &s.tvoc, &s.eco2, &s.raw_i, &s.raw_v);
+        if (res != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Error reading results: %d (%s)", res, esp_err_to_name(res));
+            stream->errors++;
+            continue;
+        }
+
+        if (xQueueSend(stream->samples, &s, 0) != pdTRUE)
+        {
+            // drop the oldest sample
+            ccs811_sample_t old;
+            xQueueReceive(stream->samples, &old, 0);
+            xQueueSend(stream->samples, &s, 0);
+            stream->overruns++;
+        }
+    }
+
+    stream->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t ccs811_stream_start(ccs811_stream_t *stream, size_t buf_size, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(stream && stream->dev && buf_size && !stream->task);
+    if (stream->dev->mode == CCS811_MODE_IDLE)
+        return CCS811_ERR_WRONG_MODE;
+
+    stream->samples = xQueueCreate(buf_size, sizeof(ccs811_sample_t));
+    if (!stream->samples)
+        return ESP_ERR_NO_MEM;
+    stream->overruns = 0;
+    stream->errors = 0;
+
+    stream->running = true;
+    if (xTaskCreate(reader_task, TAG, stack_size, stream, priority, &stream->task) != pdPASS)
+    {
+        stream->running = false;
+        stream->task = NULL;
+        vQueueDelete(stream->samples);
+        stream->samples = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << stream->gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    // nINT is open drain
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    esp_err_t res = gpio_config(&io_conf);
+    if (res != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(stream->gpio, ready_isr, stream)) != ESP_OK)
+        goto fail;
+
+    if ((res = ccs811_enable_interrupt(stream->dev, true)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    ccs811_stream_stop(stream);
+    return res;
+}
+
+esp_err_t ccs811_stream_stop(ccs811_stream_t *stream)
+{
+    CHECK_ARG(stream);
+
+    gpio_isr_handler_remove(stream->gpio);
+    gpio_set_intr_type(stream->gpio, GPIO_INTR_DISABLE);
+
+    stream->running = false;
+    while (stream->task)
+    {
+        xTaskNotifyGive(stream->task);
+        vTaskDelay(1);
+    }
+
+    if (stream->samples)
+    {
+        vQueueDelete(stream->samples);
+        stream->samples = NULL;
+    }
+
+    return ccs811_enable_interrupt(stream->dev, false);
+}
+
+esp_err_t ccs811_stream_read(ccs811_stream_t *stream, ccs811_sample_t *samples, size_t max,
+        size_t *count, uint32_t timeout_ms)
+{
+    CHECK_ARG(stream && stream->samples && samples && max && count);
+
+    *count = 0;
+    if (xQueueReceive(stream->samples, samples, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    size_t n = 1;
+    while (n < max && xQueueReceive(stream->samples, samples + n, 0) == pdTRUE)
+        n++;
+    *count = n;
+
+    return ESP_OK;
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ccs811_stream.h
+ * @defgroup ccs811_stream ccs811_stream
+ * @{
+ *
+ * CCS811 results reader driven by nINT pin
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __CCS811_STREAM_H__
+#define __CCS811_STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "ccs811.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sample
+ */
+typedef struct
+{
+    uint16_t tvoc;       //!< TVOC, ppb. Not available in ::CCS811_MODE_250MS
+    uint16_t eco2;       //!< eCO2, ppm. Not available in ::CCS811_MODE_250MS
+    uint8_t raw_i;       //!< Current through the sensor, uA
+    uint16_t raw_v;      //!< Voltage across the sensor, 1023 = 1.65 V
+    int64_t timestamp;   //!< Time of nINT signal, microseconds since boot
+} ccs811_sample_t;
+
+/**
+ * Stream descriptor
+ */
+typedef struct
+{
+    ccs811_dev_t *dev;               //!< Device descriptor
+    gpio_num_t gpio;                 //!< GPIO connected to nINT
+    QueueHandle_t samples;           //!< Sample ring buffer, internal
+    TaskHandle_t task;               //!< Reader task, internal
+    volatile int64_t ready_time;     //!< Time of last nINT signal, internal
+    volatile bool running;           //!< Stream state, internal
+    uint32_t overruns;               //!< Number of lost samples
+    uint32_t errors;                 //!< Number of failed reads
+} ccs811_stream_t;
+
+/**
+ * @brief Start reading results on nINT
+ *
+ * Data ready interrupt is enabled, the reader task sleeps until nINT
+ * goes low and then reads results in one transaction, which also
+ * releases nINT. Status is never polled. If nINT is still low after
+ * two measurement periods (e.g. a read failed), results are read
+ * anyway. When buffer is full, the oldest sample is dropped.
+ *
+ * Measurement mode must be set before and must not be ::CCS811_MODE_IDLE.
+ * Combine with ::ccs811_set_wake_gpio() for the lowest consumption.
+ *
+ * @param stream Stream descriptor, `dev` and `gpio` fields must be set
+ * @param buf_size Ring buffer size, samples
+ * @param priority Reader task priority
+ * @param stack_size Reader task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_stream_start(ccs811_stream_t *stream, size_t buf_size, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop reading results
+ *
+ * Data ready interrupt is disabled.
+ *
+ * @param stream Stream descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ccs811_stream_stop(ccs811_stream_t *stream);
+
+/**
+ * @brief Read samples from ring buffer
+ *
+ * Waits for the first sample, then copies all available samples
+ * without waiting.
+ *
+ * @param stream Stream descriptor
+ * @param[out] samples Buffer for samples
+ * @param max Buffer size, samples
+ * @param[out] count Number of copied samples
+ * @param timeout_ms Time to wait for the first sample
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if no samples
+ */
+esp_err_t ccs811_stream_read(ccs811_stream_t *stream, ccs811_sample_t *samples, size_t max,
+        size_t *count, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __CCS811_STREAM_H__ */
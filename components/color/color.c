@@ -23,7 +23,17 @@
 
 #include "color.h"
 #include <math.h>
+#include <string.h>
+#include <stdlib.h>
 #include <lib8tion.h>
+#include <esp_attr.h>
+
+#if CONFIG_COLOR_IRAM
+// noinline keeps the kernels out of their callers in flash
+#define COLOR_IRAM_ATTR IRAM_ATTR __attribute__((noinline))
+#else
+#define COLOR_IRAM_ATTR
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -136,7 +146,7 @@ rgb_t hsv2rgb_spectrum(hsv_t hsv)
 #define K170 170
 #define K85  85
 
-rgb_t hsv2rgb_rainbow(hsv_t hsv)
+rgb_t COLOR_IRAM_ATTR hsv2rgb_rainbow(hsv_t hsv)
 {
     // Yellow has a higher inherent brightness than
     // any other color; 'pure' yellow is perceived to
@@ -527,6 +537,21 @@ hsv_t rgb2hsv_approximate(rgb_t rgb)
     return hsv_from_values(h, s, v);
 }
 
+void rgb2hsv_approximate_array(const rgb_t *src, hsv_t *dst, size_t num)
+{
+    // Black and runs of equal colors are very common in LED frames
+    for (size_t i = 0; i < num; i++)
+    {
+        rgb_t c = src[i];
+        if (i && c.r == src[i - 1].r && c.g == src[i - 1].g && c.b == src[i - 1].b)
+            dst[i] = dst[i - 1];
+        else if (!c.r && !c.g && !c.b)
+            dst[i] = hsv_from_values(0, 0, 0);
+        else
+            dst[i] = rgb2hsv_approximate(c);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 rgb_t rgb_heat_color(uint8_t temperature)
@@ -579,6 +604,45 @@ void hsv_fill_solid_hsv(hsv_t *target, hsv_t color, size_t num)
         target[i] = color;
 }
 
+void COLOR_IRAM_ATTR hsv_rainbow_lut_init(hsv_rainbow_lut_t *lut, uint8_t sat, uint8_t val)
+{
+    lut->sat = sat;
+    lut->val = val;
+    for (int h = 0; h < 256; h++)
+        lut->colors[h] = hsv2rgb_rainbow(hsv_from_values(h, sat, val));
+}
+
+void COLOR_IRAM_ATTR hsv2rgb_rainbow_array(const hsv_t *src, rgb_t *dst, size_t num)
+{
+    if (!num)
+        return;
+
+    // Runs of equal colors are converted once
+    dst[0] = hsv2rgb_rainbow(src[0]);
+    for (size_t i = 1; i < num; i++)
+        dst[i] = src[i].hue == src[i - 1].hue && src[i].sat == src[i - 1].sat && src[i].val == src[i - 1].val
+                 ? dst[i - 1]
+                 : hsv2rgb_rainbow(src[i]);
+}
+
+void COLOR_IRAM_ATTR hsv2rgb_rainbow_array_lut(const hsv_t *src, rgb_t *dst, size_t num, hsv_rainbow_lut_t *lut)
+{
+    // Hue table pays off when there are more pixels than hues
+    bool const_sv = lut && num > 256;
+    for (size_t i = 1; i < num && const_sv; i++)
+        const_sv = src[i].sat == src[0].sat && src[i].val == src[0].val;
+    if (!const_sv)
+    {
+        hsv2rgb_rainbow_array(src, dst, num);
+        return;
+    }
+
+    if (lut->sat != src[0].sat || lut->val != src[0].val)
+        hsv_rainbow_lut_init(lut, src[0].sat, src[0].val);
+    for (size_t i = 0; i < num; i++)
+        dst[i] = lut->colors[src[i].hue];
+}
+
 void rgb_fill_solid_hsv(rgb_t *target, hsv_t color, size_t num)
 {
     rgb_t rgb = hsv2rgb_rainbow(color);
@@ -592,6 +656,82 @@ void rgb_fill_solid_rgb(rgb_t *target, rgb_t color, size_t num)
         target[i] = color;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Bulk array operations
+//
+// Arrays are processed as bytes, four at a time in a 32-bit word (SWAR).
+// Multiplications are done on even and odd bytes separately, so every
+// byte gets its own 16-bit lane and no carries cross lanes.
+
+#define EVEN_BYTES 0x00ff00ffUL
+#define ODD_BYTES  0xff00ff00UL
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store32(uint8_t *p, uint32_t v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+// blend8() of four bytes, ka = 256 - amount, kb = amount + 1
+static inline uint32_t blend8x4(uint32_t a, uint32_t b, uint32_t ka, uint32_t kb)
+{
+    uint32_t even = ((a & EVEN_BYTES) * ka + (b & EVEN_BYTES) * kb) >> 8;
+    uint32_t odd = ((a >> 8) & EVEN_BYTES) * ka + ((b >> 8) & EVEN_BYTES) * kb;
+    return (even & EVEN_BYTES) | (odd & ODD_BYTES);
+}
+
+void COLOR_IRAM_ATTR rgb_nscale8_array(rgb_t *leds, size_t num, uint8_t scale)
+{
+    uint8_t *p = (uint8_t *)leds;
+    size_t bytes = num * sizeof(rgb_t);
+    size_t i = 0;
+
+    for (; i + 4 <= bytes; i += 4)
+        store32(p + i, scale8x4(load32(p + i), scale));
+    for (; i < bytes; i++)
+        p[i] = scale8(p[i], scale);
+}
+
+void rgb_fade_to_black_array(rgb_t *leds, size_t num, uint8_t fade_factor)
+{
+    rgb_nscale8_array(leds, num, 255 - fade_factor);
+}
+
+void COLOR_IRAM_ATTR rgb_add_array(rgb_t *dst, const rgb_t *src, size_t num)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    size_t bytes = num * sizeof(rgb_t);
+    size_t i = 0;
+
+    for (; i + 4 <= bytes; i += 4)
+        store32(d + i, qadd8x4(load32(d + i), load32(s + i)));
+    for (; i < bytes; i++)
+        d[i] = qadd8(d[i], s[i]);
+}
+
+void COLOR_IRAM_ATTR rgb_blend_array(rgb_t *dst, const rgb_t *src, size_t num, fract8 amount)
+{
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    size_t bytes = num * sizeof(rgb_t);
+    size_t i = 0;
+    uint32_t ka = 256 - amount, kb = (uint32_t)amount + 1;
+
+    for (; i + 4 <= bytes; i += 4)
+        store32(d + i, blend8x4(load32(d + i), load32(s + i), ka, kb));
+    for (; i < bytes; i++)
+        d[i] = blend8(d[i], s[i], amount);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void hsv_fill_gradient_hsv(hsv_t *target, size_t startpos, hsv_t startcolor, size_t endpos, hsv_t endcolor,
         color_gradient_direction_t direction)
 {
@@ -753,6 +893,24 @@ void rgb_fill_gradient_hsv(rgb_t *target, size_t startpos, hsv_t startcolor, siz
     accum88 hue88 = startcolor.hue << 8;
     accum88 sat88 = startcolor.sat << 8;
     accum88 val88 = startcolor.val << 8;
+
+    // Only hue changes along long gradient, use hue table
+    if (!satdelta87 && !valdelta87 && pixeldistance >= 256)
+    {
+        hsv_rainbow_lut_t *lut = malloc(sizeof(hsv_rainbow_lut_t));
+        if (lut)
+        {
+            hsv_rainbow_lut_init(lut, startcolor.sat, startcolor.val);
+            for (size_t i = startpos; i <= endpos; ++i)
+            {
+                target[i] = lut->colors[hue88 >> 8];
+                hue88 += huedelta87;
+            }
+            free(lut);
+            return;
+        }
+    }
+
     for (size_t i = startpos; i <= endpos; ++i)
     {
         target[i] = hsv2rgb_rainbow(hsv_from_values(hue88 >> 8, sat88 >> 8, val88 >> 8));
@@ -993,29 +1151,41 @@ hsv_t blend(hsv_t existing, hsv_t overlay, fract8 amount, color_gradient_directi
     return existing;
 }
 
-void blur1d(rgb_t *leds, size_t num_leds, fract8 blur_amount)
+// blur1d over pixels placed `stride` apart
+static void COLOR_IRAM_ATTR blur_line(rgb_t *leds, size_t num_leds, size_t stride, uint8_t keep, uint8_t seep)
 {
-    uint8_t keep = 255 - blur_amount;
-    uint8_t seep = blur_amount >> 1;
     rgb_t carryover = rgb_from_code(0);
-    for (size_t i = 0; i < num_leds; ++i)
+    rgb_t *prev = NULL;
+    for (size_t i = 0; i < num_leds; ++i, leds += stride)
     {
-        rgb_t cur = leds[i];
-        rgb_t part = cur;
-        part = rgb_scale(part, seep);
+        rgb_t cur = *leds;
+        rgb_t part = rgb_scale(cur, seep);
         cur = rgb_add_rgb(rgb_scale(cur, keep), carryover);
-        if (i)
-            leds[i - 1] = rgb_add_rgb(leds[i - 1], part);
-        leds[i] = cur;
+        if (prev)
+            *prev = rgb_add_rgb(*prev, part);
+        *leds = cur;
         carryover = part;
+        prev = leds;
     }
 }
 
+void blur1d(rgb_t *leds, size_t num_leds, fract8 blur_amount)
+{
+    blur_line(leds, num_leds, 1, 255 - blur_amount, blur_amount >> 1);
+}
+
 void blur_columns(rgb_t *leds, size_t width, size_t height, fract8 blur_amount, xy_to_offs_cb xy, void *ctx)
 {
     // blur columns
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
+    if (!xy)
+    {
+        // row-major matrix, columns are strided lines
+        for (size_t col = 0; col < width; ++col)
+            blur_line(leds + col, height, width, keep, seep);
+        return;
+    }
     for (size_t col = 0; col < width; ++col)
     {
         rgb_t carryover = rgb_from_code(0);
@@ -1042,6 +1212,12 @@ void blur_rows(rgb_t *leds, size_t width, size_t height, fract8 blur_amount, xy_
     // blur rows same as columns, for irregular matrix
     uint8_t keep = 255 - blur_amount;
     uint8_t seep = blur_amount >> 1;
+    if (!xy)
+    {
+        for (size_t row = 0; row < height; row++)
+            blur_line(leds + row * width, width, 1, keep, seep);
+        return;
+    }
     for (size_t row = 0; row < height; row++)
     {
         rgb_t carryover = rgb_from_code(0);
@@ -1069,6 +1245,70 @@ void blur2d(rgb_t *leds, size_t width, size_t height, fract8 blur_amount, xy_to_
     blur_columns(leds, width, height, blur_amount, xy, ctx);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// 16 bit per channel colors
+
+void COLOR_IRAM_ATTR rgb16_nscale16_array(rgb16_t *leds, size_t num, uint16_t scale)
+{
+    for (size_t i = 0; i < num; i++)
+        leds[i] = rgb16_scale(leds[i], scale);
+}
+
+void COLOR_IRAM_ATTR rgb16_add_array(rgb16_t *dst, const rgb16_t *src, size_t num)
+{
+    for (size_t i = 0; i < num; i++)
+        dst[i] = rgb16_add_rgb16(dst[i], src[i]);
+}
+
+static void COLOR_IRAM_ATTR blur_line16(rgb16_t *leds, size_t num_leds, size_t stride, uint16_t keep, uint16_t seep)
+{
+    rgb16_t carryover = { 0 };
+    rgb16_t *prev = NULL;
+    for (size_t i = 0; i < num_leds; ++i, leds += stride)
+    {
+        rgb16_t cur = *leds;
+        rgb16_t part = rgb16_scale(cur, seep);
+        cur = rgb16_add_rgb16(rgb16_scale(cur, keep), carryover);
+        if (prev)
+            *prev = rgb16_add_rgb16(*prev, part);
+        *leds = cur;
+        carryover = part;
+        prev = leds;
+    }
+}
+
+void blur2d_rgb16(rgb16_t *leds, size_t width, size_t height, fract8 blur_amount)
+{
+    // same amounts as blur_line(), scaled to 16 bits
+    uint16_t keep = (255 - blur_amount) * 257;
+    uint16_t seep = (blur_amount >> 1) * 257;
+    for (size_t row = 0; row < height; row++)
+        blur_line16(leds + row * width, width, 1, keep, seep);
+    for (size_t col = 0; col < width; col++)
+        blur_line16(leds + col, height, width, keep, seep);
+}
+
+static inline uint8_t dither_channel(uint16_t v, uint8_t threshold)
+{
+    uint32_t r = ((uint32_t)v + threshold) >> 8;
+    return r > 255 ? 255 : r;
+}
+
+void COLOR_IRAM_ATTR rgb16_to_rgb_dither_array(const rgb16_t *src, rgb_t *dst, size_t num, uint8_t frame)
+{
+    // Rounding thresholds in bit-reversed order, the average of any 8
+    // consecutive values is 128, as for rounding to nearest
+    static const uint8_t thresholds[8] = { 16, 144, 80, 208, 48, 176, 112, 240 };
+
+    for (size_t i = 0; i < num; i++)
+    {
+        uint8_t t = thresholds[(frame + i) & 7];
+        dst[i].r = dither_channel(src[i].r, t);
+        dst[i].g = dither_channel(src[i].g, t);
+        dst[i].b = dither_channel(src[i].b, t);
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 uint8_t apply_gamma2brightness(uint8_t brightness, float gamma)
@@ -1101,3 +1341,90 @@ rgb_t apply_gamma2rgb_channels(rgb_t c, float gamma_r, float gamma_g, float gamm
     return res;
 }
 
+void color_gamma_init(color_gamma_t *gt, float gamma)
+{
+    for (int i = 0; i < 256; i++)
+        gt->r[i] = apply_gamma2brightness(i, gamma);
+    memcpy(gt->g, gt->r, sizeof(gt->g));
+    memcpy(gt->b, gt->r, sizeof(gt->b));
+}
+
+void color_gamma_init_channels(color_gamma_t *gt, float gamma_r, float gamma_g, float gamma_b)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        gt->r[i] = apply_gamma2brightness(i, gamma_r);
+        gt->g[i] = apply_gamma2brightness(i, gamma_g);
+        gt->b[i] = apply_gamma2brightness(i, gamma_b);
+    }
+}
+
+void COLOR_IRAM_ATTR color_gamma_apply_array(const color_gamma_t *gt, const rgb_t *src, rgb_t *dst, size_t num)
+{
+    const uint8_t *tr = gt->r, *tg = gt->g, *tb = gt->b;
+    for (size_t i = 0; i < num; i++)
+    {
+        rgb_t c = src[i];
+        dst[i].r = tr[c.r];
+        dst[i].g = tg[c.g];
+        dst[i].b = tb[c.b];
+    }
+}
+
+void color_output_lut_init(uint8_t *lut, const uint8_t *gamma, uint8_t correction, uint8_t brightness, uint8_t dither)
+{
+    // scale8_video(255, b) == b, so no correction costs no precision
+    uint8_t scale = scale8_video(correction, brightness);
+    for (int i = 0; i < 256; i++)
+    {
+        uint8_t v = gamma ? gamma[i] : i;
+        // zero scale must switch LEDs off whatever the rounding threshold
+        lut[i] = dither && scale ? (v * (scale + 1) + dither) >> 8 : scale8_video(v, scale);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void color_palette16_init(color_palette16_t *pal, const rgb_t *entries)
+{
+    memcpy(pal->entries, entries, sizeof(pal->entries));
+    for (int i = 0; i < 256; i++)
+        pal->table[i] = color_from_palette_rgb(pal->entries, COLOR_PALETTE16_SIZE, i, 255, true);
+    pal->scaled_valid = false;
+}
+
+// Same brightness rules as color_from_palette_rgb()
+static inline uint8_t palette_scale(uint8_t c, uint8_t brightness)
+{
+    return brightness && c ? scale8(c, brightness + 1) : 0;
+}
+
+void color_palette16_set_brightness(color_palette16_t *pal, uint8_t brightness)
+{
+    if (pal->scaled_valid && pal->brightness == brightness)
+        return;
+    for (int i = 0; i < 256; i++)
+    {
+        rgb_t c = pal->table[i];
+        if (brightness != 255)
+        {
+            c.r = palette_scale(c.r, brightness);
+            c.g = palette_scale(c.g, brightness);
+            c.b = palette_scale(c.b, brightness);
+        }
+        pal->scaled[i] = c;
+    }
+    pal->brightness = brightness;
+    pal->scaled_valid = true;
+}
+
+void color_palette16_blend(color_palette16_t *pal, const color_palette16_t *target, fract8 amount)
+{
+    rgb_blend_array(pal->entries, target->entries, COLOR_PALETTE16_SIZE, amount);
+    rgb_blend_array(pal->table, target->table, 256, amount);
+    if (pal->scaled_valid)
+    {
+        pal->scaled_valid = false;
+        color_palette16_set_brightness(pal, pal->brightness);
+    }
+}
@@ -39,6 +39,7 @@
 
 #include "rgb.h"
 #include "hsv.h"
+#include "rgb16.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +66,65 @@ extern "C" {
  */
 rgb_t hsv2rgb_rainbow(hsv_t hsv);
 
+/**
+ * @brief Convert array of HSV colors to RGB using balanced rainbow
+ *
+ * Same as ::hsv2rgb_rainbow() for every color, runs of equal colors
+ * are converted once.
+ *
+ * @param src   HSV colors
+ * @param dst   RGB colors
+ * @param num   Number of colors
+ */
+void hsv2rgb_rainbow_array(const hsv_t *src, rgb_t *dst, size_t num);
+
+/**
+ * Table of balanced rainbow colors of all hues for fixed saturation and value
+ */
+typedef struct
+{
+    uint8_t sat;         ///< Saturation of the table
+    uint8_t val;         ///< Value of the table
+    rgb_t colors[256];   ///< RGB color for every hue
+} hsv_rainbow_lut_t;
+
+/**
+ * @brief Fill rainbow hue table
+ *
+ * @param lut   Table
+ * @param sat   Saturation
+ * @param val   Value
+ */
+void hsv_rainbow_lut_init(hsv_rainbow_lut_t *lut, uint8_t sat, uint8_t val);
+
+/**
+ * @brief Get color from rainbow hue table
+ *
+ * @param lut   Table
+ * @param hue   Hue
+ * @return      RGB color, same as `hsv2rgb_rainbow(hsv_from_values(hue, lut->sat, lut->val))`
+ */
+static inline rgb_t hsv_rainbow_lut_get(const hsv_rainbow_lut_t *lut, uint8_t hue)
+{
+    return lut->colors[hue];
+}
+
+/**
+ * @brief Convert array of HSV colors to RGB using cached hue table
+ *
+ * Same as ::hsv2rgb_rainbow_array(). When saturation and value are the
+ * same for all colors of an array longer than 256, colors are taken from
+ * the table, which is rebuilt only if its saturation or value differ.
+ * The table is owned by the caller and must not be used by other tasks
+ * at the same time.
+ *
+ * @param src   HSV colors
+ * @param dst   RGB colors
+ * @param num   Number of colors
+ * @param lut   Table initialized with ::hsv_rainbow_lut_init(), NULL for none
+ */
+void hsv2rgb_rainbow_array_lut(const hsv_t *src, rgb_t *dst, size_t num, hsv_rainbow_lut_t *lut);
+
 /**
  * @brief Convert HSV to RGB using mathematically straight spectrum
  *
@@ -127,6 +187,18 @@ rgb_t hsv2rgb_raw(hsv_t hsv);
  */
 hsv_t rgb2hsv_approximate(rgb_t rgb);
 
+/**
+ * @brief Convert array of RGB colors to HSV
+ *
+ * Same as ::rgb2hsv_approximate() for every color, but black pixels
+ * and runs of equal colors are not converted again.
+ *
+ * @param src   RGB colors
+ * @param dst   HSV colors
+ * @param num   Number of colors
+ */
+void rgb2hsv_approximate_array(const rgb_t *src, hsv_t *dst, size_t num);
+
 /**
  * @brief Approximates a 'black body radiation' spectrum for a given 'heat' level.
  *
@@ -155,6 +227,26 @@ void rgb_fill_solid_hsv(rgb_t *target, hsv_t color, size_t num);
  */
 void rgb_fill_solid_rgb(rgb_t *target, rgb_t color, size_t num);
 
+/**
+ * Scale all colors of an array, see rgb_scale()
+ */
+void rgb_nscale8_array(rgb_t *leds, size_t num, uint8_t scale);
+
+/**
+ * Fade all colors of an array to black, see rgb_fade()
+ */
+void rgb_fade_to_black_array(rgb_t *leds, size_t num, uint8_t fade_factor);
+
+/**
+ * Saturating add of colors of `src` array to `dst` array
+ */
+void rgb_add_array(rgb_t *dst, const rgb_t *src, size_t num);
+
+/**
+ * Blend colors of `dst` array toward `src` array, amount 0..255 of `src`
+ */
+void rgb_blend_array(rgb_t *dst, const rgb_t *src, size_t num, fract8 amount);
+
 /**
  * @brief Fill an array of HSV colors with a smooth HSV gradient between two
  *        specified HSV colors.
@@ -281,12 +373,77 @@ hsv_t color_from_palette_hsv(hsv_t *palette, uint8_t pal_size, uint8_t index, ui
  */
 rgb_t color_from_palette_rgb(rgb_t *palette, uint8_t pal_size, uint8_t index, uint8_t brightness, bool blend);
 
+#define COLOR_PALETTE16_SIZE 16 ///< Number of entries in ::color_palette16_t
+
+/**
+ * 16-entry RGB palette with precomputed blended colors for every index
+ */
+typedef struct
+{
+    rgb_t entries[COLOR_PALETTE16_SIZE]; ///< Palette entries
+    rgb_t table[256];                    ///< Blended colors for every index
+    rgb_t scaled[256];                   ///< Blended colors scaled by `brightness`
+    uint8_t brightness;                  ///< Brightness of `scaled` table
+    bool scaled_valid;                   ///< `scaled` table is filled
+} color_palette16_t;
+
+/**
+ * @brief Initialize palette and expand it to 256 colors
+ *
+ * Colors are the same as from `color_from_palette_rgb(entries, 16, index, 255, true)`.
+ *
+ * @param pal       Palette
+ * @param entries   16 palette colors
+ */
+void color_palette16_init(color_palette16_t *pal, const rgb_t *entries);
+
+/**
+ * @brief Fill brightness-scaled table of palette
+ *
+ * Does nothing if table for this brightness is already filled.
+ *
+ * @param pal       Palette
+ * @param brightness Brightness, same rules as in color_from_palette_rgb()
+ */
+void color_palette16_set_brightness(color_palette16_t *pal, uint8_t brightness);
+
+/**
+ * @brief Crossfade palette toward another palette
+ *
+ * Call it repeatedly with small amount for smooth palette change.
+ * Scaled table is updated for current brightness.
+ *
+ * @param pal       Palette to change
+ * @param target    Target palette
+ * @param amount    Amount of target palette, 0..255
+ */
+void color_palette16_blend(color_palette16_t *pal, const color_palette16_t *target, fract8 amount);
+
+/**
+ * @brief Get blended color from palette
+ */
+static inline rgb_t color_palette16_get(const color_palette16_t *pal, uint8_t index)
+{
+    return pal->table[index];
+}
+
+/**
+ * @brief Get blended and brightness-scaled color from palette
+ *
+ * ::color_palette16_set_brightness() must be called before.
+ */
+static inline rgb_t color_palette16_get_scaled(const color_palette16_t *pal, uint8_t index)
+{
+    return pal->scaled[index];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Filter functions
 
 /**
  * Function which must be provided by the application for use in two-dimensional
- * filter functions.
+ * filter functions. Pass NULL instead for row-major matrix (offset is
+ * `y * width + x`), then faster kernels without callback are used.
  */
 typedef size_t (*xy_to_offs_cb)(void *ctx, size_t x, size_t y);
 
@@ -357,6 +514,85 @@ rgb_t apply_gamma2rgb(rgb_t c, float gamma);
  */
 rgb_t apply_gamma2rgb_channels(rgb_t c, float gamma_r, float gamma_g, float gamma_b);
 
+/**
+ * Gamma correction tables, one entry per channel value
+ *
+ * Built once per gamma value, applying them costs three table lookups
+ * per pixel instead of three powf() calls.
+ */
+typedef struct
+{
+    uint8_t r[256]; //!< Red channel table
+    uint8_t g[256]; //!< Green channel table
+    uint8_t b[256]; //!< Blue channel table
+} color_gamma_t;
+
+/**
+ * @brief Build gamma tables with the same gamma for all channels
+ *
+ * Values are the same as from apply_gamma2brightness().
+ *
+ * @param gt        Gamma tables
+ * @param gamma     Gamma value, e.g. 2.2
+ */
+void color_gamma_init(color_gamma_t *gt, float gamma);
+
+/**
+ * @brief Build gamma tables with different gamma for each channel
+ *
+ * @param gt        Gamma tables
+ * @param gamma_r   Gamma value of red channel
+ * @param gamma_g   Gamma value of green channel
+ * @param gamma_b   Gamma value of blue channel
+ */
+void color_gamma_init_channels(color_gamma_t *gt, float gamma_r, float gamma_g, float gamma_b);
+
+/**
+ * @brief Gamma-correct a single RGB color
+ */
+static inline rgb_t color_gamma_apply(const color_gamma_t *gt, rgb_t c)
+{
+    rgb_t res = {
+        .r = gt->r[c.r],
+        .g = gt->g[c.g],
+        .b = gt->b[c.b],
+    };
+    return res;
+}
+
+/**
+ * @brief Gamma-correct array of RGB colors
+ *
+ * \p src and \p dst can be the same array.
+ *
+ * @param gt        Gamma tables
+ * @param src       Source colors
+ * @param dst       Destination colors
+ * @param num       Number of colors
+ */
+void color_gamma_apply_array(const color_gamma_t *gt, const rgb_t *src, rgb_t *dst, size_t num);
+
+/**
+ * @brief Build output table of one LED channel
+ *
+ * Fuses gamma correction, colour correction and brightness into one
+ * table, so output stages map a drawn channel value to the transmitted
+ * one with a single lookup. Gamma is applied first, then the value is
+ * scaled by `correction` and `brightness` at once.
+ *
+ * With `dither` 0 values are rounded as by scale8_video(), so non-zero
+ * values stay non-zero. Otherwise `dither` is the rounding threshold of
+ * the frame for temporal dithering, see led_strip. Zero brightness or
+ * correction gives a table of zeros in both cases.
+ *
+ * @param lut        Table of 256 entries
+ * @param gamma      Gamma table of the channel (e.g. color_gamma_t::r), NULL for none
+ * @param correction Colour correction of the channel, 255 for none
+ * @param brightness Brightness
+ * @param dither     Rounding threshold 1..255, 0 for no dithering
+ */
+void color_output_lut_init(uint8_t *lut, const uint8_t *gamma, uint8_t correction, uint8_t brightness, uint8_t dither);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,143 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file rgb16.h
+ * @defgroup rgb16 rgb16
+ * @{
+ *
+ * RGB colors with 16 bits per channel
+ *
+ * Channels are 8.8 fixed point values: 8-bit value `c` is `c << 8`, so
+ * repeated fades and blurs keep fractional parts instead of rounding every
+ * step. Colors are converted to 8-bit ::rgb_t with dithering only for output,
+ * see ::rgb16_to_rgb_dither_array().
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __COLOR_RGB16_H__
+#define __COLOR_RGB16_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include "rgb.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// RGB color with 8.8 fixed point channels
+typedef struct
+{
+    uint16_t r;
+    uint16_t g;
+    uint16_t b;
+} rgb16_t;
+
+/// Create rgb16_t color from 8-bit color
+static inline rgb16_t rgb16_from_rgb(rgb_t c)
+{
+    rgb16_t res = {
+        .r = (uint16_t)c.r << 8,
+        .g = (uint16_t)c.g << 8,
+        .b = (uint16_t)c.b << 8,
+    };
+    return res;
+}
+
+/// Convert rgb16_t color to 8-bit color, rounding to nearest
+static inline rgb_t rgb16_to_rgb(rgb16_t c)
+{
+    rgb_t res = {
+        .r = c.r >= 0xff80 ? 255 : (c.r + 0x80) >> 8,
+        .g = c.g >= 0xff80 ? 255 : (c.g + 0x80) >> 8,
+        .b = c.b >= 0xff80 ? 255 : (c.b + 0x80) >> 8,
+    };
+    return res;
+}
+
+/// Scale color to N 65536ths of it's current brightness, 65535 - no change
+static inline rgb16_t rgb16_scale(rgb16_t c, uint16_t scale)
+{
+    uint32_t s = (uint32_t)scale + 1;
+    rgb16_t res = {
+        .r = (c.r * s) >> 16,
+        .g = (c.g * s) >> 16,
+        .b = (c.b * s) >> 16,
+    };
+    return res;
+}
+
+/// Add one color to another, saturating at 0xffff for each channel
+static inline rgb16_t rgb16_add_rgb16(rgb16_t a, rgb16_t b)
+{
+    uint32_t r = (uint32_t)a.r + b.r;
+    uint32_t g = (uint32_t)a.g + b.g;
+    uint32_t bl = (uint32_t)a.b + b.b;
+    rgb16_t res = {
+        .r = r > 0xffff ? 0xffff : r,
+        .g = g > 0xffff ? 0xffff : g,
+        .b = bl > 0xffff ? 0xffff : bl,
+    };
+    return res;
+}
+
+/**
+ * Scale all colors of an array, see ::rgb16_scale()
+ */
+void rgb16_nscale16_array(rgb16_t *leds, size_t num, uint16_t scale);
+
+/**
+ * Saturating add of colors of `src` array to `dst` array
+ */
+void rgb16_add_array(rgb16_t *dst, const rgb16_t *src, size_t num);
+
+/**
+ * @brief Two-dimensional blur filter of row-major matrix, same as ::blur2d()
+ */
+void blur2d_rgb16(rgb16_t *leds, size_t width, size_t height, fract8 blur_amount);
+
+/**
+ * @brief Convert colors to 8 bits per channel with temporal dithering
+ *
+ * Rounding threshold walks through 8 evenly spaced values over 8 consecutive
+ * frames, so the average output of 8 frames equals the 16-bit value with
+ * 1/8 LSB resolution.
+ * Threshold is also shifted by pixel position, so neighbor pixels don't
+ * flicker in sync. Output must be refreshed at 100 Hz or more to hide
+ * the dithering.
+ *
+ * @param src   16-bit colors
+ * @param dst   8-bit colors
+ * @param num   Number of colors
+ * @param frame Frame counter, increment it for every output frame
+ */
+void rgb16_to_rgb_dither_array(const rgb16_t *src, rgb_t *dst, size_t num, uint8_t frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __COLOR_RGB16_H__ */
@@ -0,0 +1,2 @@
+COMPONENT_ADD_INCLUDEDIRS = .
+COMPONENT_DEPENDS = freertos log nvs_flash sht3x bme680 scd4x ccs811
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file dev_init.c
+ *
+ * Parallel initialization of devices with reset delays
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <freertos/semphr.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include "dev_init.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "dev_init";
+
+typedef struct
+{
+    dev_init_device_t *devices;
+    size_t count;
+    int bus;
+    SemaphoreHandle_t finished;
+} bus_t;
+
+static void init_bus(bus_t *bus)
+{
+    while (true)
+    {
+        // device of the bus with the earliest reset completion
+        dev_init_device_t *next = NULL;
+        for (size_t i = 0; i < bus->count; i++)
+        {
+            dev_init_device_t *d = &bus->devices[i];
+            if (d->bus == bus->bus && !d->done && (!next || d->ready < next->ready))
+                next = d;
+        }
+        if (!next)
+            return;
+
+        int64_t wait = next->ready - esp_timer_get_time();
+        if (wait > 0)
+            // round up, device must not be accessed before its reset is complete
+            vTaskDelay((wait + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+
+        if (next->started)
+        {
+            next->result = next->driver->finish(next->ctx);
+            if (next->result != ESP_OK)
+                ESP_LOGE(TAG, "Could not finish initialization of %s on bus %d: %d (%s)",
+                        next->driver->name, next->bus, next->result, esp_err_to_name(next->result));
+            next->done = true;
+            continue;
+        }
+
+        if (next->driver->init)
+        {
+            next->result = next->driver->init(next->ctx);
+            if (next->result != ESP_OK)
+                ESP_LOGE(TAG, "Could not initialize %s on bus %d: %d (%s)", next->driver->name,
+                        next->bus, next->result, esp_err_to_name(next->result));
+        }
+        if (next->result == ESP_OK && next->driver->finish)
+        {
+            // let other devices of the bus go while this one is starting
+            next->ready = esp_timer_get_time() + (int64_t)next->driver->init_time_ms * 1000;
+            next->started = true;
+            continue;
+        }
+        next->done = true;
+    }
+}
+
+static void bus_task(void *arg)
+{
+    bus_t *bus = (bus_t *)arg;
+
+    init_bus(bus);
+    xSemaphoreGive(bus->finished);
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t dev_init_run(dev_init_device_t *devices, size_t count, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(devices && count);
+    for (size_t i = 0; i < count; i++)
+        CHECK_ARG(devices[i].driver);
+
+    bus_t *buses = calloc(count, sizeof(bus_t));
+    if (!buses)
+        return ESP_ERR_NO_MEM;
+    SemaphoreHandle_t finished = xSemaphoreCreateCounting(count, 0);
+    if (!finished)
+    {
+        free(buses);
+        return ESP_ERR_NO_MEM;
+    }
+
+    // issue all resets first, their delays overlap
+    size_t bus_count = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        dev_init_device_t *d = &devices[i];
+        d->result = ESP_OK;
+        d->started = false;
+        d->done = false;
+        if (d->driver->reset && (d->result = d->driver->reset(d->ctx)) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Could not reset %s on bus %d: %d (%s)", d->driver->name,
+                    d->bus, d->result, esp_err_to_name(d->result));
+            d->done = true;
+        }
+        d->ready = esp_timer_get_time() + (int64_t)d->driver->reset_time_ms * 1000;
+
+        size_t b = 0;
+        while (b < bus_count && buses[b].bus != d->bus)
+            b++;
+        if (b == bus_count)
+        {
+            buses[b].devices = devices;
+            buses[b].count = count;
+            buses[b].bus = d->bus;
+            buses[b].finished = finished;
+            bus_count++;
+        }
+    }
+
+    size_t started = 0;
+    for (size_t b = 1; b < bus_count; b++)
+    {
+        if (xTaskCreate(bus_task, TAG, stack_size, &buses[b], priority, NULL) == pdPASS)
+            started++;
+        else
+        {
+            ESP_LOGW(TAG, "Could not create task for bus %d, initializing it serially", buses[b].bus);
+            init_bus(&buses[b]);
+        }
+    }
+    init_bus(&buses[0]);
+
+    while (started--)
+        xSemaphoreTake(finished, portMAX_DELAY);
+
+    vSemaphoreDelete(finished);
+    free(buses);
+
+    for (size_t i = 0; i < count; i++)
+        if (devices[i].result != ESP_OK)
+            return devices[i].result;
+
+    return ESP_OK;
+}
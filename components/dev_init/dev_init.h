@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file dev_init.h
+ * @defgroup dev_init dev_init
+ * @{
+ *
+ * Parallel initialization of devices with reset delays
+ *
+ * Sensor init functions usually reset the device and then block for the
+ * reset time before reading calibration data or configuring the device.
+ * Called serially at boot, these delays add up. ::dev_init_run() issues
+ * resets of all devices first, then performs post-reset initialization of
+ * each device as soon as its reset time has elapsed, with one task per bus,
+ * so reset delays of all devices overlap. Adapters for some drivers of this
+ * library are declared in dev_init_drivers.h.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __DEV_INIT_H__
+#define __DEV_INIT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Driver of initialized device
+ */
+typedef struct
+{
+    const char *name;               //!< Driver name, used in log messages
+
+    /**
+     * Reset device without waiting for it, may be NULL.
+     * Called for all devices in the calling task before any init().
+     */
+    esp_err_t (*reset)(void *ctx);
+
+    uint32_t reset_time_ms;         //!< Time from reset() until init() may be called, ms
+
+    /**
+     * Post-reset initialization of device, may be NULL.
+     * Called by the task of the bus.
+     */
+    esp_err_t (*init)(void *ctx);
+
+    uint32_t init_time_ms;          //!< Time from init() until finish() may be called, ms
+
+    /**
+     * Second stage of initialization, may be NULL.
+     * Called by the task of the bus after init() succeeded, devices of the
+     * same bus are initialized while this device is waiting.
+     */
+    esp_err_t (*finish)(void *ctx);
+} dev_init_driver_t;
+
+/**
+ * Initialized device.
+ *
+ * Fill `driver`, `ctx` and `bus` before ::dev_init_run(), other fields are
+ * set by it.
+ */
+typedef struct
+{
+    const dev_init_driver_t *driver;    //!< Driver vtable
+    void *ctx;                          //!< Driver context (device descriptor)
+    int bus;                            //!< Bus key, e.g. I2C port number. Devices with the same
+                                        //!< key are initialized one by one by the same task
+
+    esp_err_t result;                   //!< Result of reset(), init() or finish() of the device
+    int64_t ready;                      //!< Time when next stage may start, us (for internal use only)
+    bool started;                       //!< init() is done, finish() is pending (for internal use only)
+    bool done;                          //!< Device is processed (for internal use only)
+} dev_init_device_t;
+
+/**
+ * @brief Reset and initialize devices
+ *
+ * Calls reset() of all devices in order, then runs init() of devices of
+ * each bus in a separate task in order of their readiness. Devices of the
+ * first bus are initialized in the calling task. Drivers with finish()
+ * are picked again when their init_time_ms has passed. Blocks until all
+ * devices are processed. Devices which failed to reset are not initialized.
+ *
+ * @param devices Array of devices
+ * @param count Number of devices
+ * @param priority Priority of bus tasks
+ * @param stack_size Stack size of bus tasks
+ * @return `ESP_OK` if all devices are initialized, first error of a device
+ *         otherwise. See `result` fields for results of every device.
+ */
+esp_err_t dev_init_run(dev_init_device_t *devices, size_t count, UBaseType_t priority, uint32_t stack_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __DEV_INIT_H__ */
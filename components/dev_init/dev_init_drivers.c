@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file dev_init_drivers.c
+ *
+ * Adapters of library drivers for dev_init
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdio.h>
+#include <string.h>
+#include <esp_log.h>
+#include <sht3x.h>
+#include <bme680.h>
+#include <scd4x.h>
+#include <ccs811.h>
+#include "dev_init_drivers.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+
+#if CONFIG_DEV_INIT_BME680_CALIB_CACHE
+#include <nvs.h>
+
+#define NVS_NAMESPACE "dev_init"
+
+static const char *TAG = "dev_init";
+#endif
+
+// SHT3x
+
+static esp_err_t reset_sht3x(void *ctx)
+{
+    return sht3x_reset((sht3x_t *)ctx);
+}
+
+const dev_init_driver_t dev_init_sht3x = {
+    .name = "sht3x",
+    .reset = reset_sht3x,
+    .reset_time_ms = SHT3X_RESET_TIME_MS,
+    .init = NULL,
+};
+
+// BME680
+
+#if CONFIG_DEV_INIT_BME680_CALIB_CACHE
+
+typedef struct
+{
+    uint8_t variant;
+    bme680_calib_data_t calib;
+} bme680_calib_cache_t;
+
+static void bme680_cache_key(bme680_t *dev, char *key, size_t size)
+{
+    // chip ID is the same for all sensors, so they are told apart by address
+    snprintf(key, size, "bme680_%d_%02x", dev->i2c_dev.port, dev->i2c_dev.addr);
+}
+
+static bool bme680_load_calib(bme680_t *dev, bme680_calib_cache_t *cache)
+{
+    char key[16];
+    bme680_cache_key(dev, key, sizeof(key));
+
+    size_t size = sizeof(bme680_calib_cache_t);
+    nvs_handle_t nvs;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK)
+        return false;
+    esp_err_t res = nvs_get_blob(nvs, key, cache, &size);
+    nvs_close(nvs);
+
+    return res == ESP_OK && size == sizeof(bme680_calib_cache_t);
+}
+
+static esp_err_t bme680_save_calib(bme680_t *dev)
+{
+    char key[16];
+    bme680_cache_key(dev, key, sizeof(key));
+
+    bme680_calib_cache_t cache;
+    memset(&cache, 0, sizeof(cache));
+    cache.variant = dev->variant;
+    cache.calib = dev->calib_data;
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs));
+    esp_err_t res = nvs_set_blob(nvs, key, &cache, sizeof(cache));
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    return res;
+}
+
+#endif
+
+static esp_err_t reset_bme680(void *ctx)
+{
+    return bme680_reset((bme680_t *)ctx);
+}
+
+static esp_err_t init_bme680(void *ctx)
+{
+    bme680_t *dev = (bme680_t *)ctx;
+
+#if CONFIG_DEV_INIT_BME680_CALIB_CACHE
+    bme680_calib_cache_t cache;
+    bool cached = bme680_load_calib(dev, &cache);
+    if (cached)
+    {
+        dev->variant = cache.variant;
+        dev->calib_data = cache.calib;
+    }
+    CHECK(bme680_init_after_reset(dev, cached));
+
+    // calibration data has been read from the sensor
+    if (!cached || dev->variant != cache.variant)
+    {
+        esp_err_t res = bme680_save_calib(dev);
+        if (res != ESP_OK)
+            ESP_LOGW(TAG, "Could not save BME680 calibration data: %d (%s)", res, esp_err_to_name(res));
+    }
+
+    return ESP_OK;
+#else
+    return bme680_init_after_reset(dev, false);
+#endif
+}
+
+const dev_init_driver_t dev_init_bme680 = {
+    .name = "bme680",
+    .reset = reset_bme680,
+    .reset_time_ms = BME680_RESET_TIME_MS,
+    .init = init_bme680,
+};
+
+// SCD4x
+
+static esp_err_t reset_scd4x(void *ctx)
+{
+    return scd4x_start_reinit((i2c_dev_t *)ctx);
+}
+
+const dev_init_driver_t dev_init_scd4x = {
+    .name = "scd4x",
+    .reset = reset_scd4x,
+    .reset_time_ms = SCD4X_REINIT_TIME_MS,
+    .init = NULL,
+};
+
+// CCS811
+
+static esp_err_t reset_ccs811(void *ctx)
+{
+    return ccs811_reset((ccs811_dev_t *)ctx);
+}
+
+static esp_err_t init_ccs811(void *ctx)
+{
+    return ccs811_app_start((ccs811_dev_t *)ctx, NULL);
+}
+
+static esp_err_t finish_ccs811(void *ctx)
+{
+    return ccs811_init_after_app_start((ccs811_dev_t *)ctx);
+}
+
+const dev_init_driver_t dev_init_ccs811 = {
+    .name = "ccs811",
+    .reset = reset_ccs811,
+    .reset_time_ms = CCS811_RESET_TIME_MS,
+    .init = init_ccs811,
+    .init_time_ms = CCS811_APP_START_TIME_MS,
+    .finish = finish_ccs811,
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t dev_init_clear_cache()
+{
+#if CONFIG_DEV_INIT_BME680_CALIB_CACHE
+    nvs_handle_t nvs;
+    esp_err_t res = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    // nothing is cached yet
+    if (res == ESP_ERR_NVS_NOT_FOUND)
+        return ESP_OK;
+    CHECK(res);
+    res = nvs_erase_all(nvs);
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    return res;
+#else
+    return ESP_OK;
+#endif
+}
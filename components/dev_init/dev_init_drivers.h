@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file dev_init_drivers.h
+ * @defgroup dev_init_drivers dev_init_drivers
+ * @{
+ *
+ * Adapters of library drivers for dev_init
+ *
+ * Device descriptors must be initialized with `*_init_desc()` functions
+ * before ::dev_init_run().
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __DEV_INIT_DRIVERS_H__
+#define __DEV_INIT_DRIVERS_H__
+
+#include "dev_init.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SHT3x, same as `sht3x_init()`.
+ * Context: `sht3x_t *`.
+ */
+extern const dev_init_driver_t dev_init_sht3x;
+
+/**
+ * BME680, same as `bme680_init_sensor()`.
+ * Context: `bme680_t *`.
+ *
+ * With `CONFIG_DEV_INIT_BME680_CALIB_CACHE` calibration data is stored in
+ * NVS, keyed by I2C port and address, and is not read from the sensor
+ * on next boots while chip variant matches. NVS must be initialized before
+ * ::dev_init_run().
+ */
+extern const dev_init_driver_t dev_init_bme680;
+
+/**
+ * SCD4x, same as `scd4x_reinit()`. The sensor must be in idle mode.
+ * Context: `i2c_dev_t *`.
+ */
+extern const dev_init_driver_t dev_init_scd4x;
+
+/**
+ * CCS811, same as `ccs811_init()`. Application start delay is overlapped
+ * with other devices of the bus.
+ * Context: `ccs811_dev_t *`.
+ */
+extern const dev_init_driver_t dev_init_ccs811;
+
+/**
+ * @brief Erase cached calibration data
+ *
+ * Must be called when a sensor is replaced by another one with the same
+ * address, otherwise calibration data of the old sensor is used.
+ * Does nothing without `CONFIG_DEV_INIT_BME680_CALIB_CACHE`.
+ *
+ * @return `ESP_OK` on success
+ */
+esp_err_t dev_init_clear_cache();
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __DEV_INIT_DRIVERS_H__ */
@@ -41,15 +41,33 @@
 #include "dht.h"
 
 #include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdlib.h>
 #include <string.h>
 #include <esp_log.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_crit_stats.h>
+
+#include <esp_attr.h>
+#if CONFIG_DHT_CAPTURE_ISR
+#include <esp_timer.h>
+#endif
 
 // DHT timer precision in microseconds
 #define DHT_TIMER_INTERVAL 2
 #define DHT_DATA_BITS 40
 #define DHT_DATA_BYTES (DHT_DATA_BITS / 8)
 
+// Edges after releasing the line: release, ends of phases 'B', 'C', 'D'
+// and two per bit
+#define DHT_CAPTURE_EDGES (4 + DHT_DATA_BITS * 2)
+#define DHT_CAPTURE_BUF_SIZE (DHT_CAPTURE_EDGES + 4)
+#define DHT_CAPTURE_TIMEOUT_MS 10
+// Minimal duration of response phases 'C' and 'D', bit phases are shorter
+#define DHT_RESPONSE_MIN_US 60
+#define DHT_EDGE_LEVEL BIT(15)
+#define DHT_EDGE_DURATION 0x7fff
+
 /*
  *  Note:
  *  A suitable pull-up resistor should be connected to the selected GPIO line
@@ -80,14 +98,29 @@
 
 static const char *TAG = "dht";
 
+ESP_IDF_LIB_CRIT_STATS_DEFINE(crit_stats, "dht");
+
 #if HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-#define PORT_ENTER_CRITICAL() portENTER_CRITICAL(&mux)
-#define PORT_EXIT_CRITICAL() portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL() do { portENTER_CRITICAL(&mux); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL() do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(&mux); } while (0)
 
 #elif HELPER_TARGET_IS_ESP8266
-#define PORT_ENTER_CRITICAL() portENTER_CRITICAL()
-#define PORT_EXIT_CRITICAL() portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL() do { portENTER_CRITICAL(); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL() do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(); } while (0)
+#endif
+
+#if HELPER_TARGET_IS_ESP32 && CONFIG_DHT_IRAM
+// noinline keeps the functions out of their caller in flash
+#define DHT_IRAM_ATTR IRAM_ATTR __attribute__((noinline))
+#else
+#define DHT_IRAM_ATTR
+#endif
+
+#if HELPER_TARGET_IS_ESP8266
+#define OPEN_DRAIN_MODE GPIO_MODE_OUTPUT_OD
+#else
+#define OPEN_DRAIN_MODE GPIO_MODE_INPUT_OUTPUT_OD
 #endif
 
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -108,7 +141,7 @@ static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
  * false is returned.
  * The elapsed time is returned in pointer 'duration' if it is not NULL.
  */
-static esp_err_t dht_await_pin_state(gpio_num_t pin, uint32_t timeout,
+static esp_err_t DHT_IRAM_ATTR dht_await_pin_state(gpio_num_t pin, uint32_t timeout,
        int expected_pin_state, uint32_t *duration)
 {
     /* XXX dht_await_pin_state() should save pin direction and restore
@@ -136,7 +169,7 @@ static esp_err_t dht_await_pin_state(gpio_num_t pin, uint32_t timeout,
  * The function call should be protected from task switching.
  * Return false if error occurred.
  */
-static inline esp_err_t dht_fetch_data(dht_sensor_type_t sensor_type, gpio_num_t pin, uint8_t data[DHT_DATA_BYTES])
+static esp_err_t DHT_IRAM_ATTR dht_fetch_data(dht_sensor_type_t sensor_type, gpio_num_t pin, uint8_t data[DHT_DATA_BYTES])
 {
     uint32_t low_duration;
     uint32_t high_duration;
@@ -176,6 +209,146 @@ static inline esp_err_t dht_fetch_data(dht_sensor_type_t sensor_type, gpio_num_t
     return ESP_OK;
 }
 
+#if CONFIG_DHT_CAPTURE_ISR
+
+typedef struct
+{
+    gpio_num_t pin;
+    TaskHandle_t task;
+    int64_t last;
+    size_t count;
+    // Time since previous edge, us, and line level after the edge
+    uint16_t edges[DHT_CAPTURE_BUF_SIZE];
+} dht_capture_t;
+
+static void IRAM_ATTR dht_capture_isr(void *arg)
+{
+    dht_capture_t *cap = (dht_capture_t *)arg;
+
+    int64_t now = esp_timer_get_time();
+    if (cap->count >= DHT_CAPTURE_BUF_SIZE)
+        return;
+
+    uint32_t duration = now - cap->last;
+    cap->last = now;
+    cap->edges[cap->count++] = (duration > DHT_EDGE_DURATION ? DHT_EDGE_DURATION : duration)
+            | (gpio_get_level(cap->pin) ? DHT_EDGE_LEVEL : 0);
+
+    if (cap->count == DHT_CAPTURE_EDGES)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(cap->task, &woken);
+        if (woken == pdTRUE)
+            portYIELD_FROM_ISR();
+    }
+}
+
+/**
+ * Send start pulse to the sensors and capture their responses.
+ * Returns ESP_OK if all captures are complete, ESP_ERR_TIMEOUT otherwise,
+ * incomplete captures have count < DHT_CAPTURE_EDGES.
+ */
+static esp_err_t dht_capture(dht_sensor_type_t sensor_type, dht_capture_t *caps, size_t count)
+{
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        return res;
+
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    // Phase 'A' pulling signal low to initiate read sequence
+    for (size_t i = 0; i < count; i++)
+    {
+        caps[i].task = task;
+        caps[i].count = 0;
+        gpio_set_direction(caps[i].pin, OPEN_DRAIN_MODE);
+        gpio_set_level(caps[i].pin, 0);
+    }
+    if (sensor_type == DHT_TYPE_SI7021)
+        ets_delay_us(500);
+    else
+        vTaskDelay(pdMS_TO_TICKS(20) + 1);
+
+    for (size_t i = 0; i < count && res == ESP_OK; i++)
+    {
+        res = gpio_set_intr_type(caps[i].pin, GPIO_INTR_ANYEDGE);
+        if (res == ESP_OK)
+            res = gpio_isr_handler_add(caps[i].pin, dht_capture_isr, &caps[i]);
+    }
+
+    if (res == ESP_OK)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            caps[i].last = esp_timer_get_time();
+            gpio_set_level(caps[i].pin, 1);
+        }
+
+        TickType_t timeout = pdMS_TO_TICKS(DHT_CAPTURE_TIMEOUT_MS) + 1;
+        TickType_t start = xTaskGetTickCount();
+        size_t done = 0;
+        while (done < count)
+        {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= timeout || !ulTaskNotifyTake(pdFALSE, timeout - elapsed))
+                break;
+            done++;
+        }
+        if (done < count)
+            res = ESP_ERR_TIMEOUT;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        gpio_isr_handler_remove(caps[i].pin);
+        gpio_set_intr_type(caps[i].pin, GPIO_INTR_DISABLE);
+    }
+
+    return res;
+}
+
+/**
+ * Decode captured edges. Phase ending with edge i has level opposite to the
+ * level after the edge.
+ */
+static esp_err_t dht_decode(const dht_capture_t *cap, uint8_t data[DHT_DATA_BYTES])
+{
+#define PHASE_LEVEL(i) (!(cap->edges[i] & DHT_EDGE_LEVEL))
+#define PHASE_DURATION(i) (cap->edges[i] & DHT_EDGE_DURATION)
+
+    // Find phases 'C' (low) and 'D' (high)
+    size_t i = 1;
+    while (i + 1 < cap->count
+            && !(!PHASE_LEVEL(i) && PHASE_DURATION(i) >= DHT_RESPONSE_MIN_US
+                    && PHASE_LEVEL(i + 1) && PHASE_DURATION(i + 1) >= DHT_RESPONSE_MIN_US))
+        i++;
+    i += 2;
+    if (i + DHT_DATA_BITS * 2 > cap->count)
+    {
+        ESP_LOGE(TAG, "Incomplete response on pin %d, %d edges", cap->pin, (int)cap->count);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    memset(data, 0, DHT_DATA_BYTES);
+    for (int bit = 0; bit < DHT_DATA_BITS; bit++, i += 2)
+    {
+        if (PHASE_LEVEL(i) || !PHASE_LEVEL(i + 1))
+        {
+            ESP_LOGE(TAG, "Invalid bit %d on pin %d", bit, cap->pin);
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        data[bit / 8] |= (PHASE_DURATION(i + 1) > PHASE_DURATION(i)) << (7 - bit % 8);
+    }
+
+    return ESP_OK;
+
+#undef PHASE_LEVEL
+#undef PHASE_DURATION
+}
+
+#endif /* CONFIG_DHT_CAPTURE_ISR */
+
 /**
  * Pack two data bytes into single value and take into account sign bit.
  */
@@ -199,6 +372,28 @@ static inline int16_t dht_convert_data(dht_sensor_type_t sensor_type, uint8_t ms
     return data;
 }
 
+/**
+ * Verify checksum and convert raw data
+ */
+static esp_err_t dht_parse_data(dht_sensor_type_t sensor_type, const uint8_t data[DHT_DATA_BYTES],
+        int16_t *humidity, int16_t *temperature)
+{
+    if (data[4] != ((data[0] + data[1] + data[2] + data[3]) & 0xFF))
+    {
+        ESP_LOGE(TAG, "Checksum failed, invalid data received from sensor");
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    if (humidity)
+        *humidity = dht_convert_data(sensor_type, data[0], data[1]);
+    if (temperature)
+        *temperature = dht_convert_data(sensor_type, data[2], data[3]);
+
+    ESP_LOGD(TAG, "Sensor data: humidity=%d, temp=%d", humidity ? *humidity : 0, temperature ? *temperature : 0);
+
+    return ESP_OK;
+}
+
 esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
         int16_t *humidity, int16_t *temperature)
 {
@@ -206,6 +401,12 @@ esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
 
     uint8_t data[DHT_DATA_BYTES] = { 0 };
 
+#if CONFIG_DHT_CAPTURE_ISR
+    dht_capture_t cap = { .pin = pin };
+    esp_err_t result = dht_capture(sensor_type, &cap, 1);
+    if (result == ESP_OK || result == ESP_ERR_TIMEOUT)
+        result = dht_decode(&cap, data);
+#else
     gpio_set_direction(pin, GPIO_MODE_OUTPUT_OD);
     gpio_set_level(pin, 1);
 
@@ -213,6 +414,7 @@ esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
     esp_err_t result = dht_fetch_data(sensor_type, pin, data);
     if (result == ESP_OK)
         PORT_EXIT_CRITICAL();
+#endif
 
     /* restore GPIO direction because, after calling dht_fetch_data(), the
      * GPIO direction mode changes */
@@ -222,20 +424,49 @@ esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
     if (result != ESP_OK)
         return result;
 
-    if (data[4] != ((data[0] + data[1] + data[2] + data[3]) & 0xFF))
+    return dht_parse_data(sensor_type, data, humidity, temperature);
+}
+
+esp_err_t dht_read_multi(dht_sensor_type_t sensor_type, const gpio_num_t *pins, size_t count,
+        dht_result_t *results)
+{
+    CHECK_ARG(pins && count && results);
+
+    esp_err_t res = ESP_OK;
+
+#if CONFIG_DHT_CAPTURE_ISR
+    dht_capture_t *caps = calloc(count, sizeof(dht_capture_t));
+    if (!caps)
+        return ESP_ERR_NO_MEM;
+
+    for (size_t i = 0; i < count; i++)
+        caps[i].pin = pins[i];
+
+    esp_err_t r = dht_capture(sensor_type, caps, count);
+    for (size_t i = 0; i < count; i++)
     {
-        ESP_LOGE(TAG, "Checksum failed, invalid data received from sensor");
-        return ESP_ERR_INVALID_CRC;
+        uint8_t data[DHT_DATA_BYTES];
+        results[i].result = r == ESP_OK || r == ESP_ERR_TIMEOUT ? dht_decode(&caps[i], data) : r;
+        if (results[i].result == ESP_OK)
+            results[i].result = dht_parse_data(sensor_type, data, &results[i].humidity, &results[i].temperature);
+        if (results[i].result != ESP_OK)
+            res = results[i].result;
+
+        gpio_set_direction(pins[i], GPIO_MODE_OUTPUT_OD);
+        gpio_set_level(pins[i], 1);
     }
 
-    if (humidity)
-        *humidity = dht_convert_data(sensor_type, data[0], data[1]);
-    if (temperature)
-        *temperature = dht_convert_data(sensor_type, data[2], data[3]);
-
-    ESP_LOGD(TAG, "Sensor data: humidity=%d, temp=%d", *humidity, *temperature);
+    free(caps);
+#else
+    for (size_t i = 0; i < count; i++)
+    {
+        results[i].result = dht_read_data(sensor_type, pins[i], &results[i].humidity, &results[i].temperature);
+        if (results[i].result != ESP_OK)
+            res = results[i].result;
+    }
+#endif
 
-    return ESP_OK;
+    return res;
 }
 
 esp_err_t dht_read_float_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
@@ -46,6 +46,7 @@
 #ifndef __DHT_H__
 #define __DHT_H__
 
+#include <stddef.h>
 #include <driver/gpio.h>
 #include <esp_err.h>
 
@@ -63,12 +64,26 @@ typedef enum
     DHT_TYPE_SI7021       //!< Itead Si7021
 } dht_sensor_type_t;
 
+/**
+ * Result of a single sensor for dht_read_multi()
+ */
+typedef struct
+{
+    int16_t humidity;     //!< Humidity, percents * 10
+    int16_t temperature;  //!< Temperature, degrees Celsius * 10
+    esp_err_t result;     //!< `ESP_OK` if the values are valid
+} dht_result_t;
+
 /**
  * @brief Read integer data from sensor on specified pin
  *
  * Humidity and temperature are returned as integers.
  * For example: humidity=625 is 62.5 %, temperature=244 is 24.4 degrees Celsius
  *
+ * If CONFIG_DHT_CAPTURE_ISR is enabled, the response is captured with GPIO
+ * interrupts and the calling task sleeps during the transfer, otherwise
+ * the response is sampled in a critical section.
+ *
  * @param sensor_type DHT11 or DHT22
  * @param pin GPIO pin connected to sensor OUT
  * @param[out] humidity Humidity, percents * 10, nullable
@@ -78,6 +93,24 @@ typedef enum
 esp_err_t dht_read_data(dht_sensor_type_t sensor_type, gpio_num_t pin,
         int16_t *humidity, int16_t *temperature);
 
+/**
+ * @brief Read integer data from several sensors of the same type
+ *
+ * If CONFIG_DHT_CAPTURE_ISR is enabled, start pulses are sent to all
+ * sensors at once and their responses are captured simultaneously, so
+ * reading all of them takes about as long as reading a single one.
+ * Otherwise sensors are read one after another.
+ *
+ * @param sensor_type DHT11 or DHT22
+ * @param pins GPIO pins connected to sensor OUTs
+ * @param count Number of sensors
+ * @param[out] results Array of at least `count` results
+ * @return `ESP_OK` if all sensors were read successfully, otherwise the
+ *         last error. Result of every sensor is in `results[i].result`
+ */
+esp_err_t dht_read_multi(dht_sensor_type_t sensor_type, const gpio_num_t *pins, size_t count,
+        dht_result_t *results);
+
 /**
  * @brief Read float data from sensor on specified pin
  *
@@ -42,6 +42,7 @@
 #include <string.h>
 #include <esp_log.h> // to include ets_sys.h
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "ds1302.h"
 
 #define CH_REG   0x80
@@ -64,6 +65,11 @@
 
 #define GPIO_BIT(x) (1ULL << (x))
 
+// CE to SCLK setup time, us
+#define CE_SETUP_US 4
+// max CS setup time of SPI driver, bit cycles
+#define SPI_MAX_PRETRANS 16
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
@@ -137,8 +143,46 @@ static esp_err_t read_byte(ds1302_t *dev, uint8_t *b)
     return ESP_OK;
 }
 
+#if HELPER_TARGET_IS_ESP32
+
+// Write phase followed by read phase on the same I/O line, CE is held
+// active for the whole transaction
+static esp_err_t spi_transfer(ds1302_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.length = tx_len * 8;
+    t.tx_buffer = tx;
+    t.rxlength = rx_len * 8;
+    t.rx_buffer = rx;
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, t.length + t.rxlength);
+    esp_err_t res = spi_device_polling_transmit(dev->spi, &t);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+
+    return res;
+}
+
+#define IS_SPI(dev) ((dev)->spi != NULL)
+
+#else
+
+#define IS_SPI(dev) false
+
+static inline esp_err_t spi_transfer(ds1302_t *dev, const uint8_t *tx, size_t tx_len, uint8_t *rx, size_t rx_len)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
+
 static esp_err_t read_register(ds1302_t *dev, uint8_t reg, uint8_t *val)
 {
+    if (IS_SPI(dev))
+    {
+        uint8_t cmd = reg | 0x01;
+        return spi_transfer(dev, &cmd, 1, val, 1);
+    }
+
     PORT_ENTER_CRITICAL;
     CHECK_MUX(prepare(dev, GPIO_MODE_OUTPUT));
     CHECK_MUX(write_byte(dev, reg | 0x01));
@@ -150,6 +194,12 @@ static esp_err_t read_register(ds1302_t *dev, uint8_t reg, uint8_t *val)
 
 static esp_err_t write_register(ds1302_t *dev, uint8_t reg, uint8_t val)
 {
+    if (IS_SPI(dev))
+    {
+        uint8_t buf[2] = { reg, val };
+        return spi_transfer(dev, buf, 2, NULL, 0);
+    }
+
     PORT_ENTER_CRITICAL;
     CHECK_MUX(prepare(dev, GPIO_MODE_OUTPUT));
     CHECK_MUX(write_byte(dev, reg));
@@ -160,6 +210,12 @@ static esp_err_t write_register(ds1302_t *dev, uint8_t reg, uint8_t val)
 
 static esp_err_t burst_read(ds1302_t *dev, uint8_t reg, uint8_t *dst, uint8_t len)
 {
+    if (IS_SPI(dev))
+    {
+        uint8_t cmd = reg | 0x01;
+        return spi_transfer(dev, &cmd, 1, dst, len);
+    }
+
     PORT_ENTER_CRITICAL;
     CHECK_MUX(prepare(dev, GPIO_MODE_OUTPUT));
     CHECK_MUX(write_byte(dev, reg | 0x01));
@@ -172,6 +228,15 @@ static esp_err_t burst_read(ds1302_t *dev, uint8_t reg, uint8_t *dst, uint8_t le
 
 static esp_err_t burst_write(ds1302_t *dev, uint8_t reg, uint8_t *src, uint8_t len)
 {
+    if (IS_SPI(dev))
+    {
+        // command and data in one transaction, burst is not longer than RAM
+        uint8_t buf[DS1302_RAM_SIZE + 1];
+        buf[0] = reg;
+        memcpy(buf + 1, src, len);
+        return spi_transfer(dev, buf, len + 1, NULL, 0);
+    }
+
     PORT_ENTER_CRITICAL;
     CHECK_MUX(prepare(dev, GPIO_MODE_OUTPUT));
     CHECK_MUX(write_byte(dev, reg));
@@ -194,6 +259,11 @@ esp_err_t ds1302_init(ds1302_t *dev)
 {
     CHECK_ARG(dev);
 
+#if HELPER_TARGET_IS_ESP32
+    // descriptor may be not zeroed, bit-banging is used
+    dev->spi = NULL;
+#endif
+
     gpio_config_t io_conf;
     memset(&io_conf, 0, sizeof(gpio_config_t));
     io_conf.mode = GPIO_MODE_OUTPUT;
@@ -210,6 +280,63 @@ esp_err_t ds1302_init(ds1302_t *dev)
     return ESP_OK;
 }
 
+#if HELPER_TARGET_IS_ESP32
+
+esp_err_t ds1302_init_spi(ds1302_t *dev, spi_host_device_t host, uint32_t clock_speed_hz)
+{
+    CHECK_ARG(dev && clock_speed_hz && clock_speed_hz <= DS1302_SPI_MAX_FREQ);
+
+    spi_bus_config_t bus = {
+        .sclk_io_num = dev->sclk_pin,
+        .mosi_io_num = dev->io_pin,
+        .miso_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = 0,
+    };
+    // ESP32 can't combine write and read phases of half-duplex
+    // transaction with DMA, bursts fit into SPI buffer anyway
+    CHECK(spi_bus_initialize(host, &bus, 0));
+
+    uint32_t pretrans = ((uint64_t)clock_speed_hz * CE_SETUP_US + 999999) / 1000000;
+    spi_device_interface_config_t cfg = {
+        // data is latched on rising edge of SCLK, output on falling edge
+        .mode = 0,
+        .clock_speed_hz = clock_speed_hz,
+        .spics_io_num = dev->ce_pin,
+        .cs_ena_pretrans = pretrans < SPI_MAX_PRETRANS ? pretrans : SPI_MAX_PRETRANS,
+        .cs_ena_posttrans = 1,
+        .flags = SPI_DEVICE_HALFDUPLEX | SPI_DEVICE_3WIRE | SPI_DEVICE_BIT_LSBFIRST | SPI_DEVICE_POSITIVE_CS,
+        .queue_size = 1,
+    };
+    esp_err_t res = spi_bus_add_device(host, &cfg, &dev->spi);
+    if (res != ESP_OK)
+    {
+        dev->spi = NULL;
+        spi_bus_free(host);
+        return res;
+    }
+    dev->host = host;
+
+    bool r;
+    CHECK(ds1302_is_running(dev, &r));
+    dev->ch = !r;
+
+    return ESP_OK;
+}
+
+esp_err_t ds1302_free_spi(ds1302_t *dev)
+{
+    CHECK_ARG(dev && dev->spi);
+
+    CHECK(spi_bus_remove_device(dev->spi));
+    dev->spi = NULL;
+
+    return spi_bus_free(dev->host);
+}
+
+#endif
+
 esp_err_t ds1302_start(ds1302_t *dev, bool start)
 {
     CHECK_ARG(dev);
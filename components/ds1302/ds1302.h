@@ -47,6 +47,11 @@
 #include <driver/gpio.h>
 #include <time.h>
 #include <esp_err.h>
+#include <esp_idf_lib_helpers.h>
+
+#if HELPER_TARGET_IS_ESP32 || defined(__DOXYGEN__)
+#include <driver/spi_master.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +59,8 @@ extern "C" {
 
 #define DS1302_RAM_SIZE 31
 
+#define DS1302_SPI_MAX_FREQ 2000000 //!< Max SCLK frequency at Vcc = 5V, 500 kHz at Vcc = 2V
+
 /**
  * Device descriptor
  */
@@ -63,6 +70,10 @@ typedef struct
     gpio_num_t io_pin;     //!< GPIO pin connected to chip I/O
     gpio_num_t sclk_pin;   //!< GPIO pin connected to SCLK
     bool ch;               //!< true if clock is halted
+#if HELPER_TARGET_IS_ESP32 || defined(__DOXYGEN__)
+    spi_host_device_t host;   //!< SPI host, set by ds1302_init_spi()
+    spi_device_handle_t spi;  //!< SPI device, NULL if pins are bit-banged
+#endif
 } ds1302_t;
 
 /**
@@ -73,6 +84,38 @@ typedef struct
  */
 esp_err_t ds1302_init(ds1302_t *dev);
 
+#if HELPER_TARGET_IS_ESP32 || defined(__DOXYGEN__)
+
+/**
+ * @brief Initialize device connected to SPI peripheral
+ *
+ * Use instead of ::ds1302_init() to transfer data with SPI hardware
+ * instead of bit-banging: initializes SPI bus with SCLK on `sclk_pin` and
+ * MOSI on `io_pin`, adds half-duplex 3-wire LSB-first device with CE on
+ * `ce_pin` as active high CS. The bus must not be used by anything else.
+ * All other functions work the same way with both backends.
+ *
+ * Only available on ESP32 family.
+ *
+ * @param dev Device descriptor with pins set
+ * @param host SPI host
+ * @param clock_speed_hz SCLK frequency, up to ::DS1302_SPI_MAX_FREQ
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds1302_init_spi(ds1302_t *dev, spi_host_device_t host, uint32_t clock_speed_hz);
+
+/**
+ * @brief Free device initialized by ds1302_init_spi()
+ *
+ * Removes SPI device and frees SPI bus
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds1302_free_spi(ds1302_t *dev);
+
+#endif
+
 /**
  * @brief Start/stop clock
  *
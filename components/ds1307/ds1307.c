@@ -42,7 +42,6 @@
 
 #define I2C_FREQ_HZ 400000
 
-#define RAM_SIZE 56
 
 #define TIME_REG    0
 #define CONTROL_REG 7
@@ -244,7 +243,7 @@ esp_err_t ds1307_read_ram(i2c_dev_t *dev, uint8_t offset, uint8_t *buf, uint8_t
 {
     CHECK_ARG(dev && buf);
 
-    if (offset + len > RAM_SIZE)
+    if (offset + len > DS1307_RAM_SIZE)
         return ESP_ERR_NO_MEM;
 
     I2C_DEV_TAKE_MUTEX(dev);
@@ -258,7 +257,7 @@ esp_err_t ds1307_write_ram(i2c_dev_t *dev, uint8_t offset, uint8_t *buf, uint8_t
 {
     CHECK_ARG(dev && buf);
 
-    if (offset + len > RAM_SIZE)
+    if (offset + len > DS1307_RAM_SIZE)
         return ESP_ERR_NO_MEM;
 
     I2C_DEV_TAKE_MUTEX(dev);
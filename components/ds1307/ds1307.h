@@ -51,6 +51,7 @@ extern "C" {
 #endif
 
 #define DS1307_ADDR 0x68 //!< I2C address
+#define DS1307_RAM_SIZE 56 //!< Battery-backed RAM size, bytes
 
 /**
  * Squarewave frequency
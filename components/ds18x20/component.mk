@@ -1,2 +1,2 @@
 COMPONENT_ADD_INCLUDEDIRS = .
-COMPONENT_DEPENDS = onewire freertos log esp_idf_lib_helpers
+COMPONENT_DEPENDS = onewire freertos log nvs_flash esp_idf_lib_helpers
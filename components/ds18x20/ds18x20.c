@@ -41,11 +41,18 @@
  * BSD Licensed as described in the file LICENSE
  */
 
+#include <inttypes.h>
 #include <math.h>
+#include <stdio.h>
+#include <string.h>
 #include <esp_log.h>
+#include <nvs.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_timer.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
+#include <esp_idf_lib_crit_stats.h>
 #include "ds18x20.h"
 
 #define ds18x20_WRITE_SCRATCHPAD 0x4E
@@ -60,24 +67,195 @@
 #define ds18x20_ALARMSEARCH      0xEC
 #define ds18x20_CONVERT_T        0x44
 
-#define SLEEP_MS(x) vTaskDelay(((x) + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS)
+#define SLEEP_MS(x) ESP_IDF_LIB_TRACE_DELAY(((x) + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS)
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
+ESP_IDF_LIB_CRIT_STATS_DEFINE(crit_stats, "ds18x20");
+
 #if HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(&mux); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(&mux); } while (0)
 
 #elif HELPER_TARGET_IS_ESP8266
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(); } while (0)
+#endif
+
+#define CONVERSION_TIME_MS 750  // 12-bit, worst case
+#define POLL_INTERVAL_MS   10
+
+#define CONFIG_REG_RES_SHIFT 5
+#define CONFIG_REG_RES_MASK  0x60
+#define CONFIG_REG_RESERVED  0x1f
+
+#define RES_UNKNOWN 0xff
+
+// Raw DS18B20 temperatures, 1/16 deg.C
+#define RAW_MIN      (-55 * 16)
+#define RAW_MAX      (125 * 16)
+#define RAW_POWER_ON (85 * 16)
+
+#define NVS_NAMESPACE "ds18x20"
+
+typedef enum {
+    POWER_UNKNOWN = 0,
+    POWER_EXTERNAL,
+    POWER_PARASITIC,
+} bus_power_t;
+
+// Known resolutions of devices. Entries with addr == DS18X20_ANY describe
+// the whole bus
+typedef struct
+{
+    gpio_num_t pin;
+    ds18x20_addr_t addr;
+    uint8_t resolution;
+    uint8_t power;
+#if CONFIG_DS18X20_FAST_READ
+    bool raw_valid;
+    uint16_t fast_reads;
+    int16_t raw;
 #endif
+} cache_entry_t;
 
 static const char *TAG = "ds18x20";
 
-esp_err_t ds18x20_measure(gpio_num_t pin, ds18x20_addr_t addr, bool wait)
+static cache_entry_t cache[CONFIG_DS18X20_CACHE_SIZE];
+static size_t cache_next;
+
+// Must be called inside critical section. Address 0 is never valid, so
+// zeroed entries are free
+static cache_entry_t *cache_find(gpio_num_t pin, ds18x20_addr_t addr, bool create)
+{
+    for (size_t i = 0; i < CONFIG_DS18X20_CACHE_SIZE; i++)
+        if (cache[i].addr == addr && cache[i].pin == pin)
+            return &cache[i];
+    if (!create)
+        return NULL;
+
+    cache_entry_t *e = &cache[cache_next];
+    cache_next = (cache_next + 1) % CONFIG_DS18X20_CACHE_SIZE;
+    e->pin = pin;
+    e->addr = addr;
+    e->resolution = RES_UNKNOWN;
+    e->power = POWER_UNKNOWN;
+#if CONFIG_DS18X20_FAST_READ
+    e->raw_valid = false;
+    e->fast_reads = 0;
+#endif
+    return e;
+}
+
+static void cache_set_resolution(gpio_num_t pin, ds18x20_addr_t addr, uint8_t resolution)
+{
+    PORT_ENTER_CRITICAL;
+    if (addr == DS18X20_ANY)
+    {
+        // all devices on the bus now have the same resolution
+        for (size_t i = 0; i < CONFIG_DS18X20_CACHE_SIZE; i++)
+            if (cache[i].pin == pin && cache[i].addr && cache[i].addr != DS18X20_ANY)
+                cache[i].resolution = resolution;
+    }
+    else
+    {
+        // bus is not uniform anymore
+        cache_entry_t *bus = cache_find(pin, DS18X20_ANY, false);
+        if (bus && bus->resolution != resolution)
+            bus->resolution = RES_UNKNOWN;
+    }
+    cache_find(pin, addr, true)->resolution = resolution;
+    PORT_EXIT_CRITICAL;
+}
+
+static uint32_t conversion_time(gpio_num_t pin, ds18x20_addr_t addr)
+{
+    if (addr != DS18X20_ANY && (uint8_t)addr != DS18B20_FAMILY_ID)
+        return CONVERSION_TIME_MS;
+
+    uint8_t res = RES_UNKNOWN;
+    PORT_ENTER_CRITICAL;
+    cache_entry_t *e = cache_find(pin, addr, false);
+    if (e)
+        res = e->resolution;
+    if (res == RES_UNKNOWN && addr != DS18X20_ANY)
+    {
+        e = cache_find(pin, DS18X20_ANY, false);
+        if (e)
+            res = e->resolution;
+    }
+    PORT_EXIT_CRITICAL;
+
+    if (res == RES_UNKNOWN)
+        return CONVERSION_TIME_MS;
+    // 93.75 ms for 9 bits, doubling with every next bit
+    uint32_t shift = DS18X20_RESOLUTION_12_BIT - res;
+    return (CONVERSION_TIME_MS + (1 << shift) - 1) >> shift;
+}
+
+// Only the listed devices are read, so waiting for them is enough
+static uint32_t list_conversion_time(gpio_num_t pin, const ds18x20_addr_t *addr_list, size_t addr_count)
+{
+    uint32_t res = 0;
+    for (size_t i = 0; i < addr_count && res < CONVERSION_TIME_MS; i++)
+    {
+        uint32_t ms = conversion_time(pin, addr_list[i]);
+        if (ms > res)
+            res = ms;
+    }
+    return res;
+}
+
+#if CONFIG_DS18X20_POLL_READY
+static esp_err_t bus_power(gpio_num_t pin, bus_power_t *power)
 {
+    PORT_ENTER_CRITICAL;
+    cache_entry_t *e = cache_find(pin, DS18X20_ANY, false);
+    *power = e ? e->power : POWER_UNKNOWN;
+    PORT_EXIT_CRITICAL;
+    if (*power != POWER_UNKNOWN)
+        return ESP_OK;
+
+    if (!onewire_reset(pin))
+        return ESP_ERR_INVALID_RESPONSE;
+    onewire_skip_rom(pin);
+    onewire_write(pin, ds18x20_READ_PWRSUPPLY);
+    // parasitically powered devices pull the bus low during read slot
+    int r = onewire_read(pin);
+    if (r < 0)
+        return ESP_ERR_INVALID_RESPONSE;
+    *power = r & 1 ? POWER_EXTERNAL : POWER_PARASITIC;
+
+    PORT_ENTER_CRITICAL;
+    cache_find(pin, DS18X20_ANY, true)->power = *power;
+    PORT_EXIT_CRITICAL;
+
+    return ESP_OK;
+}
+
+static esp_err_t poll_ready(gpio_num_t pin, uint32_t timeout_ms)
+{
+    // devices respond with 0 to read slots while converting
+    for (uint32_t t = 0; t <= timeout_ms; t += POLL_INTERVAL_MS)
+    {
+        SLEEP_MS(POLL_INTERVAL_MS);
+        if (onewire_read(pin) == 0xff)
+            return ESP_OK;
+    }
+    return ESP_ERR_TIMEOUT;
+}
+#endif
+
+// Start conversion and wait `wait_ms` if it's not 0
+static esp_err_t measure(gpio_num_t pin, ds18x20_addr_t addr, uint32_t wait_ms)
+{
+#if CONFIG_DS18X20_POLL_READY
+    bus_power_t power = POWER_PARASITIC;
+    if (wait_ms)
+        CHECK(bus_power(pin, &power));
+#endif
+
     if (!onewire_reset(pin))
         return ESP_ERR_INVALID_RESPONSE;
 
@@ -86,22 +264,135 @@ esp_err_t ds18x20_measure(gpio_num_t pin, ds18x20_addr_t addr, bool wait)
     else
         onewire_select(pin, addr);
 
-    PORT_ENTER_CRITICAL;
-    onewire_write(pin, ds18x20_CONVERT_T);
-    // For parasitic devices, power must be applied within 10us after issuing
-    // the convert command.
-    onewire_power(pin);
-    PORT_EXIT_CRITICAL;
+#if CONFIG_DS18X20_POLL_READY
+    if (power == POWER_EXTERNAL)
+    {
+        onewire_write(pin, ds18x20_CONVERT_T);
+        return poll_ready(pin, wait_ms);
+    }
+#endif
+
+#if CONFIG_ONEWIRE_RMT
+    // RMT buses sleep while transmitting and cannot be used from a critical
+    // section
+    if (onewire_rmt_attached(pin))
+    {
+        onewire_write(pin, ds18x20_CONVERT_T);
+        onewire_power(pin);
+    }
+    else
+#endif
+    {
+        PORT_ENTER_CRITICAL;
+        onewire_write(pin, ds18x20_CONVERT_T);
+        // For parasitic devices, power must be applied within 10us after issuing
+        // the convert command.
+        onewire_power(pin);
+        PORT_EXIT_CRITICAL;
+    }
 
-    if (wait)
+    if (wait_ms)
     {
-        SLEEP_MS(750);
+        SLEEP_MS(wait_ms);
         onewire_depower(pin);
     }
 
     return ESP_OK;
 }
 
+esp_err_t ds18x20_measure(gpio_num_t pin, ds18x20_addr_t addr, bool wait)
+{
+    return measure(pin, addr, wait ? conversion_time(pin, addr) : 0);
+}
+
+static void conversion_done(void *arg)
+{
+    ds18x20_conversion_t *conv = (ds18x20_conversion_t *)arg;
+
+    onewire_depower(conv->pin);
+    conv->busy = false;
+    xSemaphoreGive(conv->done);
+    if (conv->cb)
+        conv->cb(conv->pin, conv->ctx);
+}
+
+esp_err_t ds18x20_conversion_init(ds18x20_conversion_t *conv, gpio_num_t pin, ds18x20_conversion_cb_t cb, void *ctx)
+{
+    CHECK_ARG(conv);
+
+    conv->pin = pin;
+    conv->cb = cb;
+    conv->ctx = ctx;
+    conv->busy = false;
+    conv->done = xSemaphoreCreateBinary();
+    if (!conv->done)
+        return ESP_ERR_NO_MEM;
+
+    esp_timer_create_args_t args = {
+        .callback = conversion_done,
+        .arg = conv,
+        .name = "ds18x20"
+    };
+    esp_err_t res = esp_timer_create(&args, &conv->timer);
+    if (res != ESP_OK)
+    {
+        vSemaphoreDelete(conv->done);
+        conv->done = NULL;
+        conv->timer = NULL;
+    }
+
+    return res;
+}
+
+esp_err_t ds18x20_conversion_free(ds18x20_conversion_t *conv)
+{
+    CHECK_ARG(conv && conv->done);
+
+    esp_timer_stop(conv->timer);
+    CHECK(esp_timer_delete(conv->timer));
+    if (conv->busy)
+        onewire_depower(conv->pin);
+    vSemaphoreDelete(conv->done);
+    conv->timer = NULL;
+    conv->done = NULL;
+    conv->busy = false;
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_measure_async(ds18x20_conversion_t *conv, ds18x20_addr_t addr)
+{
+    CHECK_ARG(conv && conv->done);
+    if (conv->busy)
+        return ESP_ERR_INVALID_STATE;
+
+    // Bus stays powered, timer depowers it
+    CHECK(measure(conv->pin, addr, 0));
+
+    conv->busy = true;
+    xSemaphoreTake(conv->done, 0);
+    esp_err_t res = esp_timer_start_once(conv->timer, (uint64_t)conversion_time(conv->pin, addr) * 1000);
+    if (res != ESP_OK)
+    {
+        onewire_depower(conv->pin);
+        conv->busy = false;
+    }
+
+    return res;
+}
+
+esp_err_t ds18x20_conversion_wait(ds18x20_conversion_t *conv, TickType_t timeout)
+{
+    CHECK_ARG(conv && conv->done);
+
+    if (!conv->busy)
+        return ESP_OK;
+    if (!xSemaphoreTake(conv->done, timeout))
+        return ESP_ERR_TIMEOUT;
+
+    return ESP_OK;
+}
+
 esp_err_t ds18x20_read_scratchpad(gpio_num_t pin, ds18x20_addr_t addr, uint8_t *buffer)
 {
     CHECK_ARG(buffer);
@@ -118,9 +409,10 @@ esp_err_t ds18x20_read_scratchpad(gpio_num_t pin, ds18x20_addr_t addr, uint8_t *
         onewire_select(pin, addr);
     onewire_write(pin, ds18x20_READ_SCRATCHPAD);
 
-    for (int i = 0; i < 8; i++)
-        buffer[i] = onewire_read(pin);
-    crc = onewire_read(pin);
+    int r;
+    if (!onewire_read_bytes(pin, buffer, 8) || (r = onewire_read(pin)) < 0)
+        return ESP_ERR_INVALID_RESPONSE;
+    crc = r;
 
     expected_crc = onewire_crc8(buffer, 8);
     if (crc != expected_crc)
@@ -130,13 +422,190 @@ esp_err_t ds18x20_read_scratchpad(gpio_num_t pin, ds18x20_addr_t addr, uint8_t *
         return ESP_ERR_INVALID_CRC;
     }
 
+    if (addr != DS18X20_ANY && (uint8_t)addr == DS18B20_FAMILY_ID)
+        cache_set_resolution(pin, addr, (buffer[4] & CONFIG_REG_RES_MASK) >> CONFIG_REG_RES_SHIFT);
+
     return ESP_OK;
 }
 
-esp_err_t ds18x20_read_temperature(gpio_num_t pin, ds18x20_addr_t addr, float *temperature)
+// TH, TL and, for DS18B20, configuration register
+static esp_err_t write_scratchpad(gpio_num_t pin, ds18x20_addr_t addr, const uint8_t *data)
 {
-    CHECK_ARG(temperature);
+    if (!onewire_reset(pin))
+        return ESP_ERR_INVALID_RESPONSE;
+
+    if (addr == DS18X20_ANY)
+        onewire_skip_rom(pin);
+    else
+        onewire_select(pin, addr);
+    onewire_write(pin, ds18x20_WRITE_SCRATCHPAD);
+    // DS18S20 has no configuration register
+    size_t size = addr != DS18X20_ANY && (uint8_t)addr != DS18B20_FAMILY_ID ? 2 : 3;
+    if (!onewire_write_bytes(pin, data, size))
+        return ESP_ERR_INVALID_RESPONSE;
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_set_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution)
+{
+    CHECK_ARG(resolution <= DS18X20_RESOLUTION_12_BIT);
+    if (addr != DS18X20_ANY && (uint8_t)addr != DS18B20_FAMILY_ID)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    // TH = +127, TL = -128
+    uint8_t data[3] = { 0x7f, 0x80, 0 };
+    if (addr != DS18X20_ANY)
+    {
+        uint8_t scratchpad[8];
+        CHECK(ds18x20_read_scratchpad(pin, addr, scratchpad));
+        data[0] = scratchpad[2];
+        data[1] = scratchpad[3];
+    }
+    data[2] = (resolution << CONFIG_REG_RES_SHIFT) | CONFIG_REG_RESERVED;
+
+    CHECK(write_scratchpad(pin, addr, data));
+
+    cache_set_resolution(pin, addr, resolution);
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_get_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t *resolution)
+{
+    CHECK_ARG(resolution && addr != DS18X20_ANY);
+    if ((uint8_t)addr != DS18B20_FAMILY_ID)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    uint8_t scratchpad[8];
+    CHECK(ds18x20_read_scratchpad(pin, addr, scratchpad));
+    *resolution = (scratchpad[4] & CONFIG_REG_RES_MASK) >> CONFIG_REG_RES_SHIFT;
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_set_alarms(gpio_num_t pin, ds18x20_addr_t addr, int8_t th, int8_t tl)
+{
+    CHECK_ARG(th >= tl);
 
+    uint8_t data[3] = { th, tl, 0 };
+    if (addr != DS18X20_ANY)
+    {
+        // Keep configuration register
+        uint8_t scratchpad[8];
+        CHECK(ds18x20_read_scratchpad(pin, addr, scratchpad));
+        data[2] = scratchpad[4];
+    }
+    else
+    {
+        // Resolution of the whole bus is known only after it was set at once
+        PORT_ENTER_CRITICAL;
+        cache_entry_t *bus = cache_find(pin, DS18X20_ANY, false);
+        uint8_t res = bus && bus->resolution != RES_UNKNOWN ? bus->resolution : DS18X20_RESOLUTION_12_BIT;
+        PORT_EXIT_CRITICAL;
+        data[2] = (res << CONFIG_REG_RES_SHIFT) | CONFIG_REG_RESERVED;
+    }
+
+    return write_scratchpad(pin, addr, data);
+}
+
+esp_err_t ds18x20_get_alarms(gpio_num_t pin, ds18x20_addr_t addr, int8_t *th, int8_t *tl)
+{
+    CHECK_ARG(th && tl && addr != DS18X20_ANY);
+
+    uint8_t scratchpad[8];
+    CHECK(ds18x20_read_scratchpad(pin, addr, scratchpad));
+    *th = (int8_t)scratchpad[2];
+    *tl = (int8_t)scratchpad[3];
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_scan_alarms(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found)
+{
+    CHECK_ARG(addr_list && addr_count && found);
+
+    onewire_search_t search;
+    onewire_addr_t addr;
+
+    *found = 0;
+    onewire_search_start(&search);
+    while ((addr = onewire_alarm_search_next(&search, pin)) != ONEWIRE_NONE)
+    {
+        uint8_t family_id = (uint8_t)addr;
+        if (family_id == DS18B20_FAMILY_ID || family_id == DS18S20_FAMILY_ID)
+        {
+            if (*found < addr_count)
+                addr_list[*found] = addr;
+            *found += 1;
+        }
+    }
+
+    return ESP_OK;
+}
+
+#if CONFIG_DS18X20_FAST_READ
+
+// Entry is created on the first full read, so the device can be read fast
+// afterwards. New entry has unknown resolution, i.e. resolution of the bus
+static void cache_set_raw(gpio_num_t pin, ds18x20_addr_t addr, int16_t raw)
+{
+    PORT_ENTER_CRITICAL;
+    cache_entry_t *e = cache_find(pin, addr, true);
+    e->raw = raw;
+    e->raw_valid = true;
+    PORT_EXIT_CRITICAL;
+}
+
+// Reads only temperature bytes of DS18B20 scratchpad and terminates the
+// read with reset. Returns false when a full read with CRC is needed
+static bool fast_read(gpio_num_t pin, ds18x20_addr_t addr, int16_t *raw)
+{
+    PORT_ENTER_CRITICAL;
+    cache_entry_t *e = cache_find(pin, addr, false);
+    bool full = !e || !e->raw_valid;
+    if (e && !full && CONFIG_DS18X20_FAST_READ_CRC_INTERVAL && ++e->fast_reads >= CONFIG_DS18X20_FAST_READ_CRC_INTERVAL)
+    {
+        e->fast_reads = 0;
+        full = true;
+    }
+    int16_t last = e ? e->raw : 0;
+    PORT_EXIT_CRITICAL;
+    if (full)
+        return false;
+
+    uint8_t buf[2];
+    if (!onewire_reset(pin))
+        return false;
+    onewire_select(pin, addr);
+    onewire_write(pin, ds18x20_READ_SCRATCHPAD);
+    bool ok = onewire_read_bytes(pin, buf, sizeof(buf));
+    onewire_reset(pin);
+    if (!ok)
+        return false;
+
+    // Open bus reads as -0.0625 deg.C (0xffff), reset device as 85 deg.C
+    int16_t t = buf[1] << 8 | buf[0];
+    if (t < RAW_MIN || t > RAW_MAX || t == RAW_POWER_ON || t == -1)
+        return false;
+#if CONFIG_DS18X20_FAST_READ_MAX_DELTA
+    int delta = t - last;
+    if (delta > CONFIG_DS18X20_FAST_READ_MAX_DELTA * 16 || delta < -CONFIG_DS18X20_FAST_READ_MAX_DELTA * 16)
+        return false;
+#else
+    (void)last;
+#endif
+
+    cache_set_raw(pin, addr, t);
+    *raw = t;
+    return true;
+}
+
+#endif
+
+// Reads temperature in 1/16 degree Celsius
+static esp_err_t read_temp_raw(gpio_num_t pin, ds18x20_addr_t addr, int16_t *raw)
+{
     uint8_t scratchpad[8];
     int16_t temp;
 
@@ -145,12 +614,37 @@ esp_err_t ds18x20_read_temperature(gpio_num_t pin, ds18x20_addr_t addr, float *t
     temp = scratchpad[1] << 8 | scratchpad[0];
 
     if ((uint8_t)addr == DS18B20_FAMILY_ID)
-        *temperature = ((float)temp * 625.0) / 10000;
-    else
     {
-        temp = ((temp & 0xfffe) << 3) + (16 - scratchpad[6]) - 4;
-        *temperature = ((float)temp * 625.0) / 10000 - 0.25;
+        *raw = temp;
+#if CONFIG_DS18X20_FAST_READ
+        if (addr != DS18X20_ANY)
+            cache_set_raw(pin, addr, temp);
+#endif
     }
+    else
+        *raw = ((temp & 0xfffe) << 3) + (16 - scratchpad[6]) - 4 - 4;
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_read_temperature(gpio_num_t pin, ds18x20_addr_t addr, float *temperature)
+{
+    CHECK_ARG(temperature);
+
+    int16_t raw;
+    CHECK(read_temp_raw(pin, addr, &raw));
+    *temperature = ((float)raw * 625.0) / 10000;
+
+    return ESP_OK;
+}
+
+esp_err_t ds18x20_read_temperature_fixed(gpio_num_t pin, ds18x20_addr_t addr, int16_t *temperature)
+{
+    CHECK_ARG(temperature);
+
+    int16_t raw;
+    CHECK(read_temp_raw(pin, addr, &raw));
+    *temperature = raw * 25 / 4;
 
     return ESP_OK;
 }
@@ -167,11 +661,58 @@ esp_err_t ds18x20_measure_and_read_multi(gpio_num_t pin, ds18x20_addr_t *addr_li
 {
     CHECK_ARG(result_list && addr_count);
 
-    CHECK(ds18x20_measure(pin, DS18X20_ANY, true));
+    CHECK(measure(pin, DS18X20_ANY, list_conversion_time(pin, addr_list, addr_count)));
 
     return ds18x20_read_temp_multi(pin, addr_list, addr_count, result_list);
 }
 
+esp_err_t ds18x20_measure_and_read_buses(const ds18x20_bus_t *buses, size_t bus_count)
+{
+    CHECK_ARG(buses && bus_count);
+
+    esp_err_t res = ESP_OK;
+    bool started = false;
+
+    for (size_t i = 0; i < bus_count; i++)
+    {
+        esp_err_t tmp = ds18x20_measure(buses[i].pin, DS18X20_ANY, false);
+        if (tmp == ESP_OK)
+            started = true;
+        else
+        {
+            ESP_LOGE(TAG, "Could not start conversion on bus %d: %d (%s)",
+                    buses[i].pin, tmp, esp_err_to_name(tmp));
+            res = tmp;
+        }
+    }
+    if (!started)
+        return res;
+
+    uint32_t wait_ms = 0;
+    for (size_t i = 0; i < bus_count; i++)
+    {
+        uint32_t ms = list_conversion_time(buses[i].pin, buses[i].addr_list, buses[i].addr_count);
+        if (ms > wait_ms)
+            wait_ms = ms;
+    }
+    SLEEP_MS(wait_ms);
+
+    for (size_t i = 0; i < bus_count; i++)
+        onewire_depower(buses[i].pin);
+
+    for (size_t i = 0; i < bus_count; i++)
+    {
+        if (!buses[i].addr_count)
+            continue;
+        esp_err_t tmp = ds18x20_read_temp_multi(buses[i].pin, buses[i].addr_list,
+                buses[i].addr_count, buses[i].result_list);
+        if (tmp != ESP_OK)
+            res = tmp;
+    }
+
+    return res;
+}
+
 esp_err_t ds18x20_scan_devices(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found)
 {
     CHECK_ARG(addr_list && addr_count);
@@ -195,6 +736,103 @@ esp_err_t ds18x20_scan_devices(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t
     return ESP_OK;
 }
 
+static bool addr_valid(ds18x20_addr_t addr)
+{
+    uint8_t rom[8];
+    for (int i = 0; i < 8; i++)
+        rom[i] = addr >> (i * 8);
+    return onewire_crc8(rom, 7) == rom[7];
+}
+
+static void inventory_key(gpio_num_t pin, char *key, size_t size)
+{
+    snprintf(key, size, "bus%d", pin);
+}
+
+static esp_err_t inventory_load(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *count)
+{
+    char key[16];
+    inventory_key(pin, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs));
+    size_t size = addr_count * sizeof(ds18x20_addr_t);
+    esp_err_t res = nvs_get_blob(nvs, key, addr_list, &size);
+    nvs_close(nvs);
+    CHECK(res);
+
+    *count = size / sizeof(ds18x20_addr_t);
+    for (size_t i = 0; i < *count; i++)
+        if (!addr_valid(addr_list[i]))
+            return ESP_ERR_INVALID_CRC;
+
+    return ESP_OK;
+}
+
+static esp_err_t inventory_store(gpio_num_t pin, const ds18x20_addr_t *addr_list, size_t count)
+{
+    char key[16];
+    inventory_key(pin, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs));
+    esp_err_t res = nvs_set_blob(nvs, key, addr_list, count * sizeof(ds18x20_addr_t));
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    return res;
+}
+
+esp_err_t ds18x20_scan_devices_cached(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found,
+        bool rescan)
+{
+    CHECK_ARG(addr_list && addr_count && found);
+
+    size_t stored = 0;
+    bool loaded = !rescan && inventory_load(pin, addr_list, addr_count, &stored) == ESP_OK;
+    if (loaded)
+    {
+        size_t i = 0;
+        while (i < stored && onewire_verify(pin, addr_list[i]))
+            i++;
+        if (i == stored)
+        {
+            *found = stored;
+            return ESP_OK;
+        }
+        ESP_LOGI(TAG, "Device %08" PRIx32 "%08" PRIx32 " on bus %d is missing, rescanning",
+                (uint32_t)(addr_list[i] >> 32), (uint32_t)addr_list[i], pin);
+    }
+
+    CHECK(ds18x20_scan_devices(pin, addr_list, addr_count, found));
+    if (*found > addr_count)
+        return ESP_OK;
+
+    for (size_t i = 0; i < *found; i++)
+        if (!addr_valid(addr_list[i]))
+        {
+            ESP_LOGW(TAG, "Invalid ROM CRC during scan of bus %d, inventory not updated", pin);
+            return ESP_OK;
+        }
+
+    esp_err_t res = inventory_store(pin, addr_list, *found);
+    if (res != ESP_OK)
+        ESP_LOGW(TAG, "Could not store inventory of bus %d: %d (%s)", pin, res, esp_err_to_name(res));
+
+    return ESP_OK;
+}
+
+// Same as read_temp_raw() but uses fast read if possible
+static esp_err_t read_temp_raw_fast(gpio_num_t pin, ds18x20_addr_t addr, int16_t *raw)
+{
+#if CONFIG_DS18X20_FAST_READ
+    if ((uint8_t)addr == DS18B20_FAMILY_ID && fast_read(pin, addr, raw))
+        return ESP_OK;
+#endif
+    return read_temp_raw(pin, addr, raw);
+}
+
 esp_err_t ds18x20_read_temp_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, float *result_list)
 {
     CHECK_ARG(result_list);
@@ -202,8 +840,28 @@ esp_err_t ds18x20_read_temp_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, siz
     esp_err_t res = ESP_OK;
     for (size_t i = 0; i < addr_count; i++)
     {
-        esp_err_t tmp = ds18x20_read_temperature(pin, addr_list[i], &result_list[i]);
-        if (tmp != ESP_OK)
+        int16_t raw;
+        esp_err_t tmp = read_temp_raw_fast(pin, addr_list[i], &raw);
+        if (tmp == ESP_OK)
+            result_list[i] = ((float)raw * 625.0) / 10000;
+        else
+            res = tmp;
+    }
+    return res;
+}
+
+esp_err_t ds18x20_read_temp_multi_fixed(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, int16_t *result_list)
+{
+    CHECK_ARG(result_list);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < addr_count; i++)
+    {
+        int16_t raw;
+        esp_err_t tmp = read_temp_raw_fast(pin, addr_list[i], &raw);
+        if (tmp == ESP_OK)
+            result_list[i] = raw * 25 / 4;
+        else
             res = tmp;
     }
     return res;
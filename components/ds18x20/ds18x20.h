@@ -46,6 +46,9 @@
 #define __DS18X20_H__
 
 #include <esp_err.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include <onewire.h>
 
 #ifdef __cplusplus
@@ -63,6 +66,16 @@ typedef onewire_addr_t ds18x20_addr_t;
 /** Family ID (lower address byte) of DS18S20 sensors */
 #define DS18S20_FAMILY_ID 0x10
 
+/**
+ * DS18B20 measurement resolution
+ */
+typedef enum {
+    DS18X20_RESOLUTION_9_BIT = 0, //!< 0.5 deg.C, 93.75 ms conversion
+    DS18X20_RESOLUTION_10_BIT,    //!< 0.25 deg.C, 187.5 ms conversion
+    DS18X20_RESOLUTION_11_BIT,    //!< 0.125 deg.C, 375 ms conversion
+    DS18X20_RESOLUTION_12_BIT,    //!< 0.0625 deg.C, 750 ms conversion
+} ds18x20_resolution_t;
+
 /**
  * @brief Find the addresses of all ds18x20 devices on the bus.
  *
@@ -84,14 +97,43 @@ typedef onewire_addr_t ds18x20_addr_t;
  */
 esp_err_t ds18x20_scan_devices(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found);
 
+/**
+ * @brief Find the addresses of ds18x20 devices using inventory stored in NVS.
+ *
+ * Loads the list of devices found on the bus last time and checks every
+ * device of it with ::onewire_verify(). If all devices respond, the stored
+ * list is returned without a full ROM search. A full search is performed
+ * and the inventory is updated when a device is missing, the stored
+ * inventory is absent, corrupted (ROM CRC mismatch) or larger than
+ * `addr_count`, or when `rescan` is true.
+ *
+ * New devices cannot be detected without a full search, so pass
+ * `rescan = true` when devices may have been added.
+ *
+ * NVS must be initialized before calling this function.
+ *
+ * @param pin         The GPIO pin connected to the ds18x20 bus
+ * @param addr_list   A pointer to an array of ::ds18x20_addr_t values.
+ * @param addr_count  Number of slots in the `addr_list` array.
+ * @param found       The number of devices found, see ds18x20_scan_devices()
+ * @param rescan      Force full search
+ *
+ * @returns `ESP_OK` if the command was successfully issued
+ */
+esp_err_t ds18x20_scan_devices_cached(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found,
+        bool rescan);
+
 /**
  * @brief Tell one or more sensors to perform a temperature measurement and
  * conversion (CONVERT_T) operation.
  *
- * This operation can take up to 750ms to complete.
+ * This operation can take up to 750ms to complete. Conversion time
+ * depends on resolution: if resolution of the device (or of the whole bus,
+ * for ::DS18X20_ANY) is known from a previous ds18x20_set_resolution() or
+ * scratchpad read, only the time needed for it is waited, otherwise 750ms.
  *
  * If `wait=true`, this routine will automatically drive the pin high for the
- * necessary 750ms after issuing the command to ensure parasitically-powered
+ * necessary time after issuing the command to ensure parasitically-powered
  * devices have enough power to perform the conversion operation (for
  * non-parasitically-powered devices, this is not necessary but does not
  * hurt). If `wait=false`, this routine will drive the pin high, but will
@@ -99,11 +141,18 @@ esp_err_t ds18x20_scan_devices(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t
  * and then depower the bus using onewire_depower() or by issuing another
  * command once conversion is done.
  *
+ * If CONFIG_DS18X20_POLL_READY is enabled and there are no parasitically
+ * powered devices on the bus, `wait=true` does not power the bus but
+ * polls it and returns as soon as conversion is done.
+ *
+ * See ds18x20_measure_async() to power the bus for the conversion time
+ * without blocking the calling task.
+ *
  * @param pin   The GPIO pin connected to the ds18x20 device
  * @param addr  The 64-bit address of the device on the bus. This can be set
  *              to ::DS18X20_ANY to send the command to all devices on the bus
  *              at the same time.
- * @param wait  Whether to wait for the necessary 750ms for the ds18x20 to
+ * @param wait  Whether to wait for the necessary conversion time for the ds18x20 to
  *              finish performing the conversion before returning to the
  *              caller (You will normally want to do this).
  *
@@ -111,6 +160,75 @@ esp_err_t ds18x20_scan_devices(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t
  */
 esp_err_t ds18x20_measure(gpio_num_t pin, ds18x20_addr_t addr, bool wait);
 
+/**
+ * Callback of finished asynchronous conversion, called from esp_timer task
+ */
+typedef void (*ds18x20_conversion_cb_t)(gpio_num_t pin, void *ctx);
+
+/**
+ * Asynchronous conversion on one bus
+ */
+typedef struct
+{
+    gpio_num_t pin;              //!< The GPIO pin connected to the ds18x20 bus
+    ds18x20_conversion_cb_t cb;  //!< Completion callback, can be NULL
+    void *ctx;                   //!< Callback context
+    esp_timer_handle_t timer;    //!< Conversion timer, internal
+    SemaphoreHandle_t done;      //!< Completion semaphore, internal
+    volatile bool busy;          //!< Conversion is in progress
+} ds18x20_conversion_t;
+
+/**
+ * @brief Init asynchronous conversion descriptor.
+ *
+ * @param conv  Descriptor
+ * @param pin   The GPIO pin connected to the ds18x20 bus
+ * @param cb    Completion callback, can be NULL
+ * @param ctx   Callback context
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_conversion_init(ds18x20_conversion_t *conv, gpio_num_t pin, ds18x20_conversion_cb_t cb, void *ctx);
+
+/**
+ * @brief Free asynchronous conversion descriptor.
+ *
+ * Conversion in progress is aborted and the bus is depowered.
+ *
+ * @param conv  Descriptor
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_conversion_free(ds18x20_conversion_t *conv);
+
+/**
+ * @brief Start conversion and return immediately.
+ *
+ * Same as ds18x20_measure() with `wait=true`, but the conversion time is
+ * counted by a timer instead of blocking the calling task. The bus stays
+ * driven high for parasitically powered devices until the time passes,
+ * then it is depowered, the callback is called and
+ * ds18x20_conversion_wait() returns. The bus must not be used until then,
+ * other buses and tasks can work meanwhile.
+ *
+ * @param conv  Descriptor
+ * @param addr  The 64-bit address of the device or ::DS18X20_ANY
+ *
+ * @returns `ESP_OK` if conversion was started, `ESP_ERR_INVALID_STATE` if
+ *          previous conversion is not finished
+ */
+esp_err_t ds18x20_measure_async(ds18x20_conversion_t *conv, ds18x20_addr_t addr);
+
+/**
+ * @brief Wait for asynchronous conversion to finish.
+ *
+ * @param conv     Descriptor
+ * @param timeout  Timeout, ticks
+ *
+ * @returns `ESP_OK` when conversion is done, `ESP_ERR_TIMEOUT` on timeout
+ */
+esp_err_t ds18x20_conversion_wait(ds18x20_conversion_t *conv, TickType_t timeout);
+
 /**
  * @brief Read the value from the last CONVERT_T operation.
  *
@@ -128,6 +246,19 @@ esp_err_t ds18x20_measure(gpio_num_t pin, ds18x20_addr_t addr, bool wait);
  */
 esp_err_t ds18x20_read_temperature(gpio_num_t pin, ds18x20_addr_t addr, float *temperature);
 
+/**
+ * @brief Read the value from the last CONVERT_T operation without floating point operations
+ *
+ * Same as ::ds18x20_read_temperature().
+ *
+ * @param pin         The GPIO pin connected to the ds18x20 device
+ * @param addr        The 64-bit address of the device to read
+ * @param temperature The temperature in 0.01 degree Celsius
+ *
+ * @returns `ESP_OK` if the command was successfully issued
+ */
+esp_err_t ds18x20_read_temperature_fixed(gpio_num_t pin, ds18x20_addr_t addr, int16_t *temperature);
+
 /**
  * @brief Read the value from the last CONVERT_T operation for multiple devices.
  *
@@ -140,10 +271,29 @@ esp_err_t ds18x20_read_temperature(gpio_num_t pin, ds18x20_addr_t addr, float *t
  * @param result_list An array of floats to hold the returned temperature
  *                     values. It should have at least `addr_count` entries.
  *
+ * When CONFIG_DS18X20_FAST_READ is enabled, DS18B20 devices read before
+ * are read without CRC, see Kconfig help of the option.
+ *
  * @returns `ESP_OK` if all temperatures were fetched successfully
  */
 esp_err_t ds18x20_read_temp_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, float *result_list);
 
+/**
+ * @brief Read the values from the last CONVERT_T operation for multiple devices
+ *        without floating point operations
+ *
+ * Same as ::ds18x20_read_temp_multi().
+ *
+ * @param pin         The GPIO pin connected to the ds18x20 bus
+ * @param addr_list   A list of addresses for devices to read.
+ * @param addr_count  The number of entries in `addr_list`.
+ * @param result_list An array of temperatures in 0.01 degree Celsius. It
+ *                    should have at least `addr_count` entries.
+ *
+ * @returns `ESP_OK` if all temperatures were fetched successfully
+ */
+esp_err_t ds18x20_read_temp_multi_fixed(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, int16_t *result_list);
+
 /** Perform a ds18x20_measure() followed by ds18x20_read_temperature()
  *
  *  @param pin         The GPIO pin connected to the ds18x20 device
@@ -168,6 +318,118 @@ esp_err_t ds18x20_measure_and_read(gpio_num_t pin, ds18x20_addr_t addr, float *t
  */
 esp_err_t ds18x20_measure_and_read_multi(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, float *result_list);
 
+/**
+ * Sensors on a single 1-Wire bus, see ::ds18x20_measure_and_read_buses()
+ */
+typedef struct
+{
+    gpio_num_t pin;              //!< GPIO pin connected to the bus
+    ds18x20_addr_t *addr_list;   //!< Addresses of devices to read
+    size_t addr_count;           //!< Number of entries in `addr_list`
+    float *result_list;          //!< Temperatures, at least `addr_count` entries
+} ds18x20_bus_t;
+
+/**
+ * @brief Measure temperature with all sensors on several buses at once.
+ *
+ * Issues CONVERT_T to all devices of every bus first, waits for a single
+ * conversion period and then reads the results bus by bus, so the cycle
+ * takes one conversion time regardless of the number of buses.
+ *
+ * Reading continues after an error on one bus; results of the failed
+ * devices are left unchanged.
+ *
+ * @param buses      Array of bus descriptors
+ * @param bus_count  Number of entries in `buses`
+ *
+ * @returns `ESP_OK` if all temperatures were fetched successfully,
+ *          otherwise the last error
+ */
+esp_err_t ds18x20_measure_and_read_buses(const ds18x20_bus_t *buses, size_t bus_count);
+
+/**
+ * @brief Set measurement resolution of DS18B20 sensors.
+ *
+ * Writes the configuration register of the scratchpad. The setting is not
+ * copied to EEPROM and is lost when the device is powered off.
+ *
+ * Alarm thresholds of the device are preserved. When `addr` is
+ * ::DS18X20_ANY, they are set to +127/-128 deg.C on all devices (alarms
+ * effectively disabled), as the previous values cannot be read back at once.
+ *
+ * @param pin         The GPIO pin connected to the ds18x20 bus
+ * @param addr        The 64-bit address of the device or ::DS18X20_ANY to
+ *                    configure all devices on the bus
+ * @param resolution  Measurement resolution
+ *
+ * @returns `ESP_OK` on success, `ESP_ERR_NOT_SUPPORTED` for DS18S20
+ */
+esp_err_t ds18x20_set_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t resolution);
+
+/**
+ * @brief Get measurement resolution of a DS18B20 sensor.
+ *
+ * Reads the scratchpad of the device and updates the cached resolution.
+ *
+ * @param pin              The GPIO pin connected to the ds18x20 bus
+ * @param addr             The 64-bit address of the device
+ * @param[out] resolution  Measurement resolution
+ *
+ * @returns `ESP_OK` on success, `ESP_ERR_NOT_SUPPORTED` for DS18S20
+ */
+esp_err_t ds18x20_get_resolution(gpio_num_t pin, ds18x20_addr_t addr, ds18x20_resolution_t *resolution);
+
+/**
+ * @brief Set alarm thresholds of ds18x20 sensors.
+ *
+ * After every conversion a sensor sets its alarm flag when the temperature
+ * is above \p th or below \p tl, deg.C. Devices with the flag set are found
+ * with ds18x20_scan_alarms(), so a monitoring sweep reads only them.
+ * Thresholds are written to the scratchpad and are not copied to EEPROM.
+ *
+ * With a specific address, configuration register of DS18B20 is preserved.
+ * With ::DS18X20_ANY all devices are written at once and their resolution
+ * is set to the one last set with ds18x20_set_resolution() for the whole
+ * bus, 12 bits if it was not set.
+ *
+ * @param pin   The GPIO pin connected to the ds18x20 bus
+ * @param addr  The 64-bit address of the device or ::DS18X20_ANY
+ * @param th    High threshold, deg.C
+ * @param tl    Low threshold, deg.C
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_set_alarms(gpio_num_t pin, ds18x20_addr_t addr, int8_t th, int8_t tl);
+
+/**
+ * @brief Get alarm thresholds of a ds18x20 sensor.
+ *
+ * @param pin       The GPIO pin connected to the ds18x20 bus
+ * @param addr      The 64-bit address of the device
+ * @param[out] th   High threshold, deg.C
+ * @param[out] tl   Low threshold, deg.C
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_get_alarms(gpio_num_t pin, ds18x20_addr_t addr, int8_t *th, int8_t *tl);
+
+/**
+ * @brief Find ds18x20 devices with alarm condition.
+ *
+ * Same as ds18x20_scan_devices(), but only devices whose last measured
+ * temperature is out of their TH/TL range respond. Start a conversion
+ * (e.g. ds18x20_measure() with ::DS18X20_ANY) before the scan.
+ *
+ * @param pin             The GPIO pin connected to the ds18x20 bus
+ * @param[out] addr_list  Addresses of found devices
+ * @param addr_count      Capacity of the list
+ * @param[out] found      Number of devices with alarm condition, can be
+ *                        larger than \p addr_count
+ *
+ * @returns `ESP_OK` on success
+ */
+esp_err_t ds18x20_scan_alarms(gpio_num_t pin, ds18x20_addr_t *addr_list, size_t addr_count, size_t *found);
+
 /**
  * @brief Read the scratchpad data for a particular ds18x20 device.
  *
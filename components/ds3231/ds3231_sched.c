@@ -0,0 +1,177 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file ds3231_sched.c
+ *
+ * DS3231 alarm-driven wakeup scheduler for deep sleep duty cycling
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <esp_idf_lib_helpers.h>
+#include "ds3231_sched.h"
+
+#if defined(CONFIG_IDF_TARGET_ESP32) || defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3)
+#define HAS_EXT0 1
+#include <driver/rtc_io.h>
+#endif
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// alarm must be far enough to be programmed before RTC reaches it
+#define MIN_LEAD_S 2
+
+static const char *TAG = "ds3231_sched";
+
+// Days since 1970-01-01 of Gregorian date, RTC time has no timezone
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d)
+{
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static esp_err_t get_rtc_time(ds3231_sched_t *sched, time_t *now)
+{
+    struct tm t;
+    CHECK(ds3231_get_time(sched->dev, &t));
+    *now = (time_t)days_from_civil(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday) * 86400
+        + t.tm_hour * 3600 + t.tm_min * 60 + t.tm_sec;
+    return ESP_OK;
+}
+
+// seconds since last time of job, 0 if job is due exactly at `t`
+static inline uint32_t since_job(const ds3231_job_t *job, time_t t)
+{
+    int64_t x = (int64_t)t - job->offset_s;
+    int64_t r = x % job->period_s;
+    return r < 0 ? r + job->period_s : r;
+}
+
+static esp_err_t check_sched(ds3231_sched_t *sched)
+{
+    CHECK_ARG(sched && sched->dev && sched->jobs && sched->count && sched->count <= DS3231_SCHED_MAX_JOBS);
+    for (size_t i = 0; i < sched->count; i++)
+        CHECK_ARG(sched->jobs[i].period_s > DS3231_SCHED_GRACE_S
+                && sched->jobs[i].period_s <= DS3231_SCHED_MAX_PERIOD_S);
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t ds3231_sched_get_due(ds3231_sched_t *sched, uint32_t *due, time_t *now)
+{
+    CHECK(check_sched(sched));
+    CHECK_ARG(due);
+
+    time_t t;
+    CHECK(get_rtc_time(sched, &t));
+    CHECK(ds3231_clear_alarm_flags(sched->dev, DS3231_ALARM_1));
+
+    *due = 0;
+    for (size_t i = 0; i < sched->count; i++)
+        if (since_job(sched->jobs + i, t) <= DS3231_SCHED_GRACE_S)
+            *due |= 1UL << i;
+    if (now)
+        *now = t;
+
+    return ESP_OK;
+}
+
+esp_err_t ds3231_sched_program(ds3231_sched_t *sched, time_t *next, uint32_t *next_due)
+{
+    CHECK(check_sched(sched));
+
+    time_t now, alarm;
+    uint32_t mask;
+    do
+    {
+        CHECK(get_rtc_time(sched, &now));
+
+        // nearest job time after now + MIN_LEAD_S
+        time_t from = now + MIN_LEAD_S;
+        alarm = 0;
+        mask = 0;
+        for (size_t i = 0; i < sched->count; i++)
+        {
+            uint32_t since = since_job(sched->jobs + i, from);
+            time_t t = since ? from + (sched->jobs[i].period_s - since) : from;
+            if (!mask || t < alarm)
+            {
+                alarm = t;
+                mask = 0;
+            }
+            if (t == alarm)
+                mask |= 1UL << i;
+        }
+
+        struct tm tm;
+        gmtime_r(&alarm, &tm);
+        // date match, alarm is less than the shortest month away
+        CHECK(ds3231_set_alarm(sched->dev, DS3231_ALARM_1, &tm, DS3231_ALARM1_MATCH_SECMINHOURDATE, NULL, 0));
+        CHECK(ds3231_clear_alarm_flags(sched->dev, DS3231_ALARM_1));
+        CHECK(ds3231_enable_alarm_ints(sched->dev, DS3231_ALARM_1));
+
+        // alarm would be missed if RTC passed it while programming
+        CHECK(get_rtc_time(sched, &now));
+    }
+    while (now >= alarm);
+
+    ESP_LOGD(TAG, "Next alarm in %d s, jobs 0x%08x", (int)(alarm - now), (unsigned)mask);
+
+    if (next)
+        *next = alarm;
+    if (next_due)
+        *next_due = mask;
+
+    return ESP_OK;
+}
+
+esp_err_t ds3231_sched_sleep(ds3231_sched_t *sched)
+{
+    CHECK(check_sched(sched));
+
+#if HAS_EXT0
+    CHECK_ARG(rtc_gpio_is_valid_gpio(sched->int_gpio));
+    CHECK(ds3231_sched_program(sched, NULL, NULL));
+
+    // INT/SQW is open drain, active low
+    CHECK(rtc_gpio_pullup_en(sched->int_gpio));
+    CHECK(rtc_gpio_pulldown_dis(sched->int_gpio));
+    CHECK(esp_sleep_enable_ext0_wakeup(sched->int_gpio, 0));
+
+    esp_deep_sleep_start();
+    return ESP_FAIL;
+#else
+    ESP_LOGE(TAG, "No ext0 wakeup on this target");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
@@ -0,0 +1,130 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file ds3231_sched.h
+ * @defgroup ds3231_sched ds3231_sched
+ * @{
+ *
+ * DS3231 alarm-driven wakeup scheduler for deep sleep duty cycling
+ *
+ * Jobs are periodic, aligned to RTC time. Before deep sleep, alarm 1 is
+ * programmed to the nearest job and INT/SQW output, active low, is used
+ * as a wakeup source. After wakeup, due jobs are found from RTC time,
+ * so no state has to be kept across deep sleep.
+ *
+ * Wiring: INT/SQW to RTC GPIO (ext0 wakeup). ESP8266 is not supported:
+ * INT/SQW stays low until alarm flag is cleared, so wired to RST it would
+ * hold the chip in reset.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __DS3231_SCHED_H__
+#define __DS3231_SCHED_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include "ds3231.h"
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define DS3231_SCHED_MAX_JOBS 32 //!< Maximal number of jobs
+
+//! Maximal job period. Alarm 1 matches day of month, so the next alarm
+//! must be less than the shortest month away.
+#define DS3231_SCHED_MAX_PERIOD_S (27UL * 24 * 3600)
+
+#ifndef DS3231_SCHED_GRACE_S
+#define DS3231_SCHED_GRACE_S 3 //!< Job is still due this many seconds after its time (boot delay)
+#endif
+
+/**
+ * Periodic job. Job is due at RTC times `t` where `(t - offset_s) % period_s == 0`,
+ * `t` is seconds since 1970-01-01 00:00:00 in RTC time.
+ */
+typedef struct
+{
+    uint32_t period_s; //!< Period, seconds, greater than ::DS3231_SCHED_GRACE_S,
+                       //!< not greater than ::DS3231_SCHED_MAX_PERIOD_S
+    uint32_t offset_s; //!< Offset of job time, seconds
+} ds3231_job_t;
+
+/**
+ * Scheduler descriptor
+ */
+typedef struct
+{
+    i2c_dev_t *dev;            //!< Initialized DS3231 device descriptor
+    gpio_num_t int_gpio;       //!< GPIO connected to INT/SQW (ESP32 only)
+    const ds3231_job_t *jobs;  //!< Jobs
+    size_t count;              //!< Number of jobs, up to ::DS3231_SCHED_MAX_JOBS
+} ds3231_sched_t;
+
+/**
+ * @brief Get jobs due now
+ *
+ * Call after wakeup. Reads RTC time and returns jobs whose time was
+ * not more than ::DS3231_SCHED_GRACE_S seconds ago. Alarm 1 flag is cleared.
+ *
+ * @param sched Scheduler descriptor
+ * @param[out] due Bit mask of due jobs, bit 0 is `jobs[0]`
+ * @param[out] now Current RTC time, NULL-able
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds3231_sched_get_due(ds3231_sched_t *sched, uint32_t *due, time_t *now);
+
+/**
+ * @brief Program alarm 1 to the nearest job
+ *
+ * Squarewave output is disabled, alarm 1 interrupt is enabled.
+ *
+ * @param sched Scheduler descriptor
+ * @param[out] next Time of next alarm, NULL-able
+ * @param[out] next_due Bit mask of jobs due at `next`, NULL-able
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds3231_sched_program(ds3231_sched_t *sched, time_t *next, uint32_t *next_due);
+
+/**
+ * @brief Program alarm 1 and enter deep sleep
+ *
+ * Calls ::ds3231_sched_program(), configures wakeup on low level of INT/SQW
+ * and starts deep sleep. Returns only on error.
+ *
+ * @param sched Scheduler descriptor
+ * @return Error code, `ESP_ERR_NOT_SUPPORTED` if target has no ext0 wakeup (ESP8266)
+ */
+esp_err_t ds3231_sched_sleep(ds3231_sched_t *sched);
+
+#ifdef	__cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __DS3231_SCHED_H__ */
@@ -31,6 +31,7 @@
  * MIT Licensed as described in the file LICENSE
  */
 
+#include <string.h>
 #include <esp_log.h>
 #include <esp_idf_lib_helpers.h>
 #include <freertos/FreeRTOS.h>
@@ -97,7 +98,7 @@ esp_err_t ds3502_get(i2c_dev_t *dev, uint8_t *pos)
 
 esp_err_t ds3502_set(i2c_dev_t *dev, uint8_t pos, bool save)
 {
-    CHECK_ARG(dev && pos >= DS3502_MAX);
+    CHECK_ARG(dev && pos <= DS3502_MAX);
 
     I2C_DEV_TAKE_MUTEX(dev);
     if (save)
@@ -111,7 +112,7 @@ esp_err_t ds3502_set(i2c_dev_t *dev, uint8_t pos, bool save)
     {
         // NVS writing delay
         vTaskDelay(pdMS_TO_TICKS(IVR_SET_DELAY));
-        // Set device back to MODE0
+        // Set device back to MODE1
         uint8_t mode = MODE_WR;
         I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_CR, &mode, 1));
     }
@@ -119,3 +120,50 @@ esp_err_t ds3502_set(i2c_dev_t *dev, uint8_t pos, bool save)
 
     return ESP_OK;
 }
+
+esp_err_t ds3502_cache_init(ds3502_cache_t *cache, i2c_dev_t *dev, uint32_t interval_ms)
+{
+    CHECK_ARG(cache && dev);
+
+    memset(cache, 0, sizeof(ds3502_cache_t));
+    cache->dev = dev;
+    cache->interval = pdMS_TO_TICKS(interval_ms);
+
+    return ESP_OK;
+}
+
+esp_err_t ds3502_cache_set(ds3502_cache_t *cache, uint8_t pos)
+{
+    CHECK_ARG(cache && pos <= DS3502_MAX);
+
+    if (cache->valid && cache->pos == pos)
+        return ESP_OK;
+
+    cache->pos = pos;
+    cache->valid = true;
+    cache->dirty = true;
+
+    return ds3502_cache_flush(cache, false);
+}
+
+esp_err_t ds3502_cache_flush(ds3502_cache_t *cache, bool force)
+{
+    CHECK_ARG(cache && cache->dev);
+
+    if (!cache->dirty)
+        return ESP_OK;
+
+    TickType_t now = xTaskGetTickCount();
+    if (!force && cache->flushed && now - cache->last_flush < cache->interval)
+        return ESP_OK;
+
+    I2C_DEV_TAKE_MUTEX(cache->dev);
+    I2C_DEV_CHECK(cache->dev, i2c_dev_write_reg(cache->dev, REG_WR_IVR, &cache->pos, 1));
+    I2C_DEV_GIVE_MUTEX(cache->dev);
+
+    cache->dirty = false;
+    cache->last_flush = now;
+    cache->flushed = true;
+
+    return ESP_OK;
+}
@@ -38,6 +38,7 @@
 #include <stdbool.h>
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -100,6 +101,58 @@ esp_err_t ds3502_get(i2c_dev_t *dev, uint8_t *pos);
  */
 esp_err_t ds3502_set(i2c_dev_t *dev, uint8_t pos, bool save);
 
+/**
+ * Write-through wiper position cache
+ *
+ * Cached setter skips writes of unchanged position and coalesces rapid
+ * updates, so the wiper register is written not more often than once
+ * per `interval`. Not thread-safe.
+ */
+typedef struct
+{
+    i2c_dev_t *dev;          //!< Device descriptor
+    uint8_t pos;             //!< Wiper position
+    bool valid;              //!< Position is known
+    bool dirty;              //!< Position is not written yet
+    bool flushed;            //!< Position was written at least once
+    TickType_t interval;     //!< Minimal interval between writes
+    TickType_t last_flush;   //!< Time of the last write
+} ds3502_cache_t;
+
+/**
+ * @brief Initialize wiper position cache
+ *
+ * @param cache Cache descriptor
+ * @param dev Device descriptor
+ * @param interval_ms Minimal interval between writes, 0 to write at once
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds3502_cache_init(ds3502_cache_t *cache, i2c_dev_t *dev, uint32_t interval_ms);
+
+/**
+ * @brief Set wiper position, cached
+ *
+ * Position is written to SRAM only. Use ::ds3502_set() to save it
+ * to nonvolatile memory.
+ *
+ * @param cache Cache descriptor
+ * @param pos Wiper position, `0..DS3502_MAX`
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds3502_cache_set(ds3502_cache_t *cache, uint8_t pos);
+
+/**
+ * @brief Write pending position to device
+ *
+ * Should be called periodically (or with `force` after the last change)
+ * so postponed position reaches the device.
+ *
+ * @param cache Cache descriptor
+ * @param force Write even if interval since the last write is not elapsed
+ * @return `ESP_OK` on success
+ */
+esp_err_t ds3502_cache_flush(ds3502_cache_t *cache, bool force);
+
 #ifdef __cplusplus
 }
 #endif
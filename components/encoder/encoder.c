@@ -28,7 +28,7 @@
 /**
  * @file encoder.c
  *
- * ESP-IDF HW timer-based driver for rotary encoders
+ * ESP-IDF HW timer-based or interrupt-driven driver for rotary encoders
  *
  * Copyright (c) 2019 Ruslan V. Uss <unclerus@gmail.com>
  *
@@ -39,6 +39,9 @@
 #include <string.h>
 #include <freertos/semphr.h>
 #include <esp_timer.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_work.h>
 
 #define MUTEX_TIMEOUT 10
 
@@ -50,21 +53,47 @@
 
 static const char *TAG = "encoder";
 static rotary_encoder_t *encs[CONFIG_RE_MAX] = { 0 };
-static const int8_t valid_states[] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
+#if HELPER_TARGET_IS_ESP32 && CONFIG_RE_ISR
+#define RE_ISR_ATTR IRAM_ATTR
+#define RE_ISR_DATA DRAM_ATTR
+#else
+#define RE_ISR_ATTR
+#define RE_ISR_DATA
+#endif
+
+static RE_ISR_DATA const int8_t valid_states[] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
 static SemaphoreHandle_t mutex;
 static QueueHandle_t _queue;
+#if CONFIG_RE_ISR && !CONFIG_RE_COALESCE
+static size_t btn_count = 0;
+#endif
+
+#if CONFIG_RE_COALESCE
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL_ISR portENTER_CRITICAL_ISR(&mux)
+#define PORT_EXIT_CRITICAL_ISR portEXIT_CRITICAL_ISR(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL_ISR
+#define PORT_EXIT_CRITICAL_ISR
+#endif
+#endif
 
 #define GPIO_BIT(x) ((x) < 32 ? BIT(x) : ((uint64_t)(((uint64_t)1)<<(x))))
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-inline static void read_encoder(rotary_encoder_t *re)
+inline static void read_button(rotary_encoder_t *re)
 {
     rotary_encoder_event_t ev = {
-        .sender = re
+        .sender = re,
+        .timestamp = esp_timer_get_time()
     };
 
-    if (re->pin_btn < GPIO_NUM_MAX)
     do
     {
         if (re->btn_state == RE_BTN_PRESSED && re->btn_pressed_time_us < CONFIG_RE_BTN_DEAD_TIME_US)
@@ -111,14 +140,18 @@ inline static void read_encoder(rotary_encoder_t *re)
             }
         }
     } while(0);
+}
 
+// Returns step direction or 0
+static inline int8_t RE_ISR_ATTR decode(rotary_encoder_t *re)
+{
     re->code <<= 2;
     re->code |= gpio_get_level(re->pin_a);
     re->code |= gpio_get_level(re->pin_b) << 1;
     re->code &= 0xf;
 
     if (!valid_states[re->code])
-        return;
+        return 0;
 
     int8_t inc = 0;
 
@@ -127,12 +160,115 @@ inline static void read_encoder(rotary_encoder_t *re)
     if (re->store == 0xe817) inc = 1;
     if (re->store == 0xd42b) inc = -1;
 
-    if (inc)
+    return inc;
+}
+
+// Update step timing, returns accelerated step
+static inline int32_t RE_ISR_ATTR accelerate(rotary_encoder_t *re, int8_t inc, int64_t now)
+{
+    int64_t dt = now - re->last_step_us;
+    re->last_step_us = now;
+
+    if (re->accel_max <= 1)
+        return inc;
+
+    if (dt >= re->accel_interval_us)
     {
-        ev.type = RE_ET_CHANGED;
-        ev.diff = inc;
-        xQueueSendToBack(_queue, &ev, 0);
+        re->interval_us = re->accel_interval_us;
+        return inc;
     }
+    // smooth out uneven detents
+    re->interval_us = (re->interval_us * 3 + (uint32_t)dt) / 4;
+
+    uint32_t k = re->accel_interval_us / (re->interval_us ? re->interval_us : 1);
+    if (k > re->accel_max)
+        k = re->accel_max;
+
+    return k > 1 ? inc * (int32_t)k : inc;
+}
+
+#if CONFIG_RE_COALESCE
+// Add steps to pending ones, take all of them if nothing is waiting in queue
+static inline int32_t RE_ISR_ATTR take_pending(rotary_encoder_t *re, int32_t inc, bool waiting)
+{
+    re->pending += inc;
+    if (waiting)
+        return 0;
+    int32_t diff = re->pending;
+    re->pending = 0;
+    return diff;
+}
+#endif
+
+#if CONFIG_RE_ISR
+static void RE_ISR_ATTR isr_handler(void *arg)
+{
+    rotary_encoder_t *re = (rotary_encoder_t *)arg;
+
+    int8_t inc = decode(re);
+    if (!inc)
+        return;
+
+    rotary_encoder_event_t ev = {
+        .type = RE_ET_CHANGED,
+        .sender = re,
+        .diff = accelerate(re, inc, esp_timer_get_time()),
+        .timestamp = re->last_step_us
+    };
+    BaseType_t woken = pdFALSE;
+#if CONFIG_RE_COALESCE
+    bool waiting = uxQueueMessagesWaitingFromISR(_queue);
+    PORT_ENTER_CRITICAL_ISR;
+    ev.diff = take_pending(re, ev.diff, waiting);
+    PORT_EXIT_CRITICAL_ISR;
+    if (ev.diff && xQueueSendToBackFromISR(_queue, &ev, &woken) != pdTRUE)
+    {
+        PORT_ENTER_CRITICAL_ISR;
+        re->pending += ev.diff;
+        PORT_EXIT_CRITICAL_ISR;
+    }
+#else
+    xQueueSendToBackFromISR(_queue, &ev, &woken);
+#endif
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+#endif
+
+inline static void read_encoder(rotary_encoder_t *re)
+{
+    if (re->pin_btn < GPIO_NUM_MAX)
+        read_button(re);
+
+#if CONFIG_RE_ISR
+    int32_t inc = 0;
+#else
+    int8_t step = decode(re);
+    int32_t inc = step ? accelerate(re, step, esp_timer_get_time()) : 0;
+#endif
+
+    rotary_encoder_event_t ev = {
+        .type = RE_ET_CHANGED,
+        .sender = re,
+        .diff = inc,
+        .timestamp = re->last_step_us
+    };
+#if CONFIG_RE_COALESCE
+    bool waiting = uxQueueMessagesWaiting(_queue);
+    PORT_ENTER_CRITICAL;
+    ev.diff = take_pending(re, inc, waiting);
+    ev.timestamp = re->last_step_us;
+    PORT_EXIT_CRITICAL;
+    if (ev.diff && xQueueSendToBack(_queue, &ev, 0) != pdTRUE)
+    {
+        PORT_ENTER_CRITICAL;
+        re->pending += ev.diff;
+        PORT_EXIT_CRITICAL;
+    }
+#else
+    if (inc)
+        xQueueSendToBack(_queue, &ev, 0);
+#endif
 }
 
 static void timer_handler(void *arg)
@@ -147,10 +283,12 @@ static void timer_handler(void *arg)
     xSemaphoreGive(mutex);
 }
 
+static esp_idf_lib_work_t work;
+
 static const esp_timer_create_args_t timer_args = {
         .name = "__encoder__",
-        .arg = NULL,
-        .callback = timer_handler,
+        .arg = &work,
+        .callback = esp_idf_lib_work_timer_cb,
         .dispatch_method = ESP_TIMER_TASK
 };
 
@@ -168,10 +306,24 @@ esp_err_t rotary_encoder_init(QueueHandle_t queue)
         return ESP_ERR_NO_MEM;
     }
 
+    CHECK(esp_idf_lib_worker_start());
+    CHECK(esp_idf_lib_work_init(&work, timer_handler, NULL, ESP_IDF_LIB_WORK_HIGH));
     CHECK(esp_timer_create(&timer_args, &timer));
+#if CONFIG_RE_ISR
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        return res;
+#if CONFIG_RE_COALESCE
+    CHECK(esp_timer_start_periodic(timer, CONFIG_RE_INTERVAL_US));
+#endif
+
+    ESP_LOGI(TAG, "Initialization complete, interrupt-driven, button polling interval: %dms",
+            CONFIG_RE_INTERVAL_US / 1000);
+#else
     CHECK(esp_timer_start_periodic(timer, CONFIG_RE_INTERVAL_US));
 
     ESP_LOGI(TAG, "Initialization complete, timer interval: %dms", CONFIG_RE_INTERVAL_US / 1000);
+#endif
     return ESP_OK;
 }
 
@@ -201,6 +353,7 @@ esp_err_t rotary_encoder_add(rotary_encoder_t *re)
     }
 
     // setup GPIO
+    esp_err_t res;
     gpio_config_t io_conf;
     memset(&io_conf, 0, sizeof(gpio_config_t));
     io_conf.mode = GPIO_MODE_INPUT;
@@ -209,15 +362,53 @@ esp_err_t rotary_encoder_add(rotary_encoder_t *re)
     io_conf.pin_bit_mask = GPIO_BIT(re->pin_a) | GPIO_BIT(re->pin_b);
     if (re->pin_btn < GPIO_NUM_MAX)
         io_conf.pin_bit_mask |= GPIO_BIT(re->pin_btn);
-    CHECK(gpio_config(&io_conf));
+    if ((res = gpio_config(&io_conf)) != ESP_OK)
+        goto fail;
 
     re->btn_state = RE_BTN_RELEASED;
     re->btn_pressed_time_us = 0;
+    re->pending = 0;
+    re->accel_interval_us = 0;
+    re->accel_max = 1;
+    re->interval_us = 0;
+    re->last_step_us = 0;
+
+#if CONFIG_RE_ISR
+    re->code = gpio_get_level(re->pin_a) | (gpio_get_level(re->pin_b) << 1);
+    re->store = 0;
+    if ((res = gpio_set_intr_type(re->pin_a, GPIO_INTR_ANYEDGE)) != ESP_OK
+            || (res = gpio_set_intr_type(re->pin_b, GPIO_INTR_ANYEDGE)) != ESP_OK
+            || (res = gpio_isr_handler_add(re->pin_a, isr_handler, re)) != ESP_OK
+            || (res = gpio_isr_handler_add(re->pin_b, isr_handler, re)) != ESP_OK)
+        goto fail_isr;
+#endif
+#if CONFIG_RE_ISR && !CONFIG_RE_COALESCE
+    if (re->pin_btn < GPIO_NUM_MAX && !btn_count++
+            && (res = esp_timer_start_periodic(timer, CONFIG_RE_INTERVAL_US)) != ESP_OK)
+    {
+        btn_count--;
+        goto fail_isr;
+    }
+#endif
 
     xSemaphoreGive(mutex);
 
     ESP_LOGI(TAG, "Added rotary encoder %d, A: %d, B: %d, BTN: %d", re->index, re->pin_a, re->pin_b, re->pin_btn);
     return ESP_OK;
+
+#if CONFIG_RE_ISR
+fail_isr:
+    gpio_isr_handler_remove(re->pin_a);
+    gpio_isr_handler_remove(re->pin_b);
+    gpio_set_intr_type(re->pin_a, GPIO_INTR_DISABLE);
+    gpio_set_intr_type(re->pin_b, GPIO_INTR_DISABLE);
+#endif
+fail:
+    // release the slot taken above
+    encs[re->index] = NULL;
+    xSemaphoreGive(mutex);
+    ESP_LOGE(TAG, "Could not add rotary encoder: %d (%s)", res, esp_err_to_name(res));
+    return res;
 }
 
 esp_err_t rotary_encoder_remove(rotary_encoder_t *re)
@@ -233,6 +424,16 @@ esp_err_t rotary_encoder_remove(rotary_encoder_t *re)
         if (encs[i] == re)
         {
             encs[i] = NULL;
+#if CONFIG_RE_ISR
+            gpio_isr_handler_remove(re->pin_a);
+            gpio_isr_handler_remove(re->pin_b);
+            gpio_set_intr_type(re->pin_a, GPIO_INTR_DISABLE);
+            gpio_set_intr_type(re->pin_b, GPIO_INTR_DISABLE);
+#endif
+#if CONFIG_RE_ISR && !CONFIG_RE_COALESCE
+            if (re->pin_btn < GPIO_NUM_MAX && !--btn_count)
+                esp_timer_stop(timer);
+#endif
             ESP_LOGI(TAG, "Removed rotary encoder %d", i);
             xSemaphoreGive(mutex);
             return ESP_OK;
@@ -242,3 +443,16 @@ esp_err_t rotary_encoder_remove(rotary_encoder_t *re)
     xSemaphoreGive(mutex);
     return ESP_ERR_NOT_FOUND;
 }
+
+esp_err_t rotary_encoder_set_acceleration(rotary_encoder_t *re, uint32_t interval_us, uint8_t max)
+{
+    CHECK_ARG(re && max && (interval_us || max == 1));
+
+    // ISR sees acceleration disabled until curve is set
+    re->accel_max = 1;
+    re->accel_interval_us = interval_us;
+    re->interval_us = interval_us;
+    re->accel_max = max;
+
+    return ESP_OK;
+}
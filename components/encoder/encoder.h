@@ -30,7 +30,7 @@
  * @defgroup encoder encoder
  * @{
  *
- * ESP-IDF HW timer-based driver for rotary encoders
+ * ESP-IDF HW timer-based or interrupt-driven driver for rotary encoders
  *
  * Copyright (c) 2019 Ruslan V. Uss <unclerus@gmail.com>
  *
@@ -68,6 +68,11 @@ typedef struct
     size_t index;
     uint64_t btn_pressed_time_us;
     rotary_encoder_btn_state_t btn_state;
+    int32_t pending;                  //!< Steps not queued yet, used with CONFIG_RE_COALESCE
+    uint32_t accel_interval_us;       //!< Step interval where acceleration starts, see rotary_encoder_set_acceleration()
+    uint8_t accel_max;                //!< Maximal acceleration coefficient, 1 if disabled
+    uint32_t interval_us;             //!< Smoothed step interval, internal
+    int64_t last_step_us;             //!< Time of the last step, internal
 } rotary_encoder_t;
 
 /**
@@ -88,7 +93,8 @@ typedef struct
 {
     rotary_encoder_event_type_t type;  //!< Event type
     rotary_encoder_t *sender;          //!< Pointer to descriptor
-    int32_t diff;                      //!< Difference between new and old positions (only if type == RE_ET_CHANGED)
+    int32_t diff;                      //!< Difference between new and old positions, accelerated (only if type == RE_ET_CHANGED)
+    int64_t timestamp;                 //!< Time of the last step or button change, us since boot
 } rotary_encoder_event_t;
 
 /**
@@ -115,6 +121,23 @@ esp_err_t rotary_encoder_add(rotary_encoder_t *re);
  */
 esp_err_t rotary_encoder_remove(rotary_encoder_t *re);
 
+/**
+ * @brief Set acceleration curve of rotary encoder
+ *
+ * Every step is multiplied by `interval_us / t`, where `t` is smoothed
+ * time between steps, limited to `max`. Steps slower than `interval_us`
+ * are not accelerated. Acceleration is computed when step is decoded,
+ * so with CONFIG_RE_COALESCE fast spin produces a few events with large
+ * diff. Acceleration is disabled by rotary_encoder_add().
+ *
+ * @param re Encoder descriptor
+ * @param interval_us Step interval where acceleration starts, us
+ *                    (e.g. 50000)
+ * @param max Maximal acceleration coefficient, 1 to disable acceleration
+ * @return `ESP_OK` on success
+ */
+esp_err_t rotary_encoder_set_acceleration(rotary_encoder_t *re, uint32_t interval_us, uint8_t max);
+
 #ifdef __cplusplus
 }
 #endif
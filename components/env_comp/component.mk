@@ -0,0 +1,2 @@
+COMPONENT_ADD_INCLUDEDIRS = .
+COMPONENT_DEPENDS = freertos log esp_idf_lib_helpers ccs811 scd4x bme680 sgp40
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file env_comp.c
+ *
+ * Environmental compensation pipeline
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <math.h>
+#include <string.h>
+#include <esp_log.h>
+#include "env_comp.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "env_comp";
+
+static inline bool changed(float applied, float value, float threshold)
+{
+    return fabsf(value - applied) > threshold;
+}
+
+static bool need_update(const env_comp_sink_t *sink, const env_comp_env_t *env)
+{
+    // all inputs must be known
+    if (((sink->inputs & ENV_COMP_TEMPERATURE) && isnan(env->temperature))
+            || ((sink->inputs & ENV_COMP_HUMIDITY) && isnan(env->humidity))
+            || ((sink->inputs & ENV_COMP_PRESSURE) && isnan(env->pressure)))
+        return false;
+
+    if (!sink->valid)
+        return true;
+
+    return ((sink->inputs & ENV_COMP_TEMPERATURE)
+                && changed(sink->applied.temperature, env->temperature, sink->threshold.temperature))
+        || ((sink->inputs & ENV_COMP_HUMIDITY)
+                && changed(sink->applied.humidity, env->humidity, sink->threshold.humidity))
+        || ((sink->inputs & ENV_COMP_PRESSURE)
+                && changed(sink->applied.pressure, env->pressure, sink->threshold.pressure));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t env_comp_init(env_comp_t *pipe, env_comp_sink_t **sinks, size_t max)
+{
+    CHECK_ARG(pipe && sinks && max);
+
+    memset(pipe, 0, sizeof(env_comp_t));
+    pipe->sinks = sinks;
+    pipe->max = max;
+    pipe->env.temperature = NAN;
+    pipe->env.humidity = NAN;
+    pipe->env.pressure = NAN;
+
+    pipe->lock = xSemaphoreCreateMutex();
+    if (!pipe->lock)
+        return ESP_ERR_NO_MEM;
+
+    return ESP_OK;
+}
+
+esp_err_t env_comp_free(env_comp_t *pipe)
+{
+    CHECK_ARG(pipe);
+
+    if (pipe->lock)
+        vSemaphoreDelete(pipe->lock);
+    pipe->lock = NULL;
+    pipe->count = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t env_comp_subscribe(env_comp_t *pipe, env_comp_sink_t *sink)
+{
+    CHECK_ARG(pipe && pipe->lock && sink && sink->apply && sink->inputs);
+
+    xSemaphoreTake(pipe->lock, portMAX_DELAY);
+    if (pipe->count == pipe->max)
+    {
+        xSemaphoreGive(pipe->lock);
+        return ESP_ERR_NO_MEM;
+    }
+    sink->valid = false;
+    sink->updates = 0;
+    sink->errors = 0;
+    pipe->sinks[pipe->count++] = sink;
+    xSemaphoreGive(pipe->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t env_comp_publish(env_comp_t *pipe, const env_comp_env_t *env, uint32_t inputs)
+{
+    CHECK_ARG(pipe && pipe->lock && env);
+
+    esp_err_t res = ESP_OK;
+
+    xSemaphoreTake(pipe->lock, portMAX_DELAY);
+
+    if (inputs & ENV_COMP_TEMPERATURE)
+        pipe->env.temperature = env->temperature;
+    if (inputs & ENV_COMP_HUMIDITY)
+        pipe->env.humidity = env->humidity;
+    if (inputs & ENV_COMP_PRESSURE)
+        pipe->env.pressure = env->pressure;
+
+    for (size_t i = 0; i < pipe->count; i++)
+    {
+        env_comp_sink_t *sink = pipe->sinks[i];
+        if (!(sink->inputs & inputs) || !need_update(sink, &pipe->env))
+            continue;
+
+        esp_err_t r = sink->apply(sink->ctx, &pipe->env);
+        if (r != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Error updating %s: %d (%s)", sink->name ? sink->name : "sink", r, esp_err_to_name(r));
+            sink->errors++;
+            res = r;
+            continue;
+        }
+        sink->applied = pipe->env;
+        sink->valid = true;
+        sink->updates++;
+    }
+
+    xSemaphoreGive(pipe->lock);
+
+    return res;
+}
+
+esp_err_t env_comp_get(env_comp_t *pipe, env_comp_env_t *env)
+{
+    CHECK_ARG(pipe && pipe->lock && env);
+
+    xSemaphoreTake(pipe->lock, portMAX_DELAY);
+    *env = pipe->env;
+    xSemaphoreGive(pipe->lock);
+
+    return ESP_OK;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file env_comp.h
+ * @defgroup env_comp env_comp
+ * @{
+ *
+ * Environmental compensation pipeline
+ *
+ * Latest temperature, humidity and pressure readings are published to the
+ * pipeline and passed to subscribed sinks (gas sensors needing compensation).
+ * A sink is updated only when one of its inputs has changed by more than
+ * the sink threshold since the last successful update, so unchanged
+ * environment causes no bus traffic. Adapters for some drivers of this
+ * library are declared in env_comp_sinks.h.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ENV_COMP_H__
+#define __ENV_COMP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Environment inputs, flags
+ */
+typedef enum {
+    ENV_COMP_TEMPERATURE = (1 << 0), //!< Temperature
+    ENV_COMP_HUMIDITY    = (1 << 1), //!< Relative humidity
+    ENV_COMP_PRESSURE    = (1 << 2), //!< Pressure
+} env_comp_input_t;
+
+/**
+ * Environment values. Unknown values are NaN
+ */
+typedef struct
+{
+    float temperature; //!< Temperature, degrees Celsius
+    float humidity;    //!< Relative humidity, %
+    float pressure;    //!< Pressure, hPa
+} env_comp_env_t;
+
+/**
+ * @brief Sink update function
+ *
+ * @param ctx Sink context
+ * @param env Environment, all inputs required by sink are valid
+ * @return `ESP_OK` on success. On error sink is updated on next publish
+ */
+typedef esp_err_t (*env_comp_apply_t)(void *ctx, const env_comp_env_t *env);
+
+/**
+ * Sink (consumer of environment data)
+ */
+typedef struct
+{
+    const char *name;           //!< Sink name for logging
+    env_comp_apply_t apply;     //!< Update function
+    void *ctx;                  //!< Update function context
+    uint32_t inputs;            //!< Required inputs, ::env_comp_input_t flags
+    env_comp_env_t threshold;   //!< Minimal change of each input to update sink
+    env_comp_env_t applied;     //!< Last applied environment, internal
+    bool valid;                 //!< Sink was updated at least once, internal
+    uint32_t updates;           //!< Number of updates
+    uint32_t errors;            //!< Number of failed updates
+} env_comp_sink_t;
+
+/**
+ * Pipeline descriptor
+ */
+typedef struct
+{
+    env_comp_sink_t **sinks;    //!< Subscribed sinks
+    size_t count;               //!< Number of sinks
+    size_t max;                 //!< Size of `sinks` array
+    env_comp_env_t env;         //!< Latest environment
+    SemaphoreHandle_t lock;     //!< Pipeline lock, internal
+} env_comp_t;
+
+/**
+ * @brief Initialize pipeline
+ *
+ * @param pipe Pipeline descriptor
+ * @param sinks Array for sink pointers
+ * @param max Size of `sinks` array
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_init(env_comp_t *pipe, env_comp_sink_t **sinks, size_t max);
+
+/**
+ * @brief Free pipeline
+ *
+ * @param pipe Pipeline descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_free(env_comp_t *pipe);
+
+/**
+ * @brief Subscribe sink
+ *
+ * Sink is updated on the next publish when all its inputs are known.
+ *
+ * @param pipe Pipeline descriptor
+ * @param sink Sink, `name`, `apply`, `ctx`, `inputs` and `threshold` must be set
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_subscribe(env_comp_t *pipe, env_comp_sink_t *sink);
+
+/**
+ * @brief Publish new readings and update sinks
+ *
+ * Only inputs set in `inputs` are taken from `env`, others keep
+ * the previous values, so temperature/humidity and pressure may come
+ * from different sensors. Sinks are updated in the caller context.
+ *
+ * @param pipe Pipeline descriptor
+ * @param env New readings
+ * @param inputs Valid inputs in `env`, ::env_comp_input_t flags
+ * @return `ESP_OK` on success, error of the last failed sink otherwise
+ */
+esp_err_t env_comp_publish(env_comp_t *pipe, const env_comp_env_t *env, uint32_t inputs);
+
+/**
+ * @brief Get latest environment
+ *
+ * @param pipe Pipeline descriptor
+ * @param[out] env Latest environment
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_get(env_comp_t *pipe, env_comp_env_t *env);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __ENV_COMP_H__ */
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file env_comp_sinks.c
+ *
+ * Adapters of library drivers for env_comp
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <math.h>
+#include <string.h>
+#include "env_comp_sinks.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static esp_err_t init_sink(env_comp_sink_t *sink, const char *name, env_comp_apply_t apply, void *ctx,
+        uint32_t inputs, float t_th, float h_th, float p_th)
+{
+    CHECK_ARG(sink && ctx);
+
+    memset(sink, 0, sizeof(env_comp_sink_t));
+    sink->name = name;
+    sink->apply = apply;
+    sink->ctx = ctx;
+    sink->inputs = inputs;
+    sink->threshold.temperature = t_th;
+    sink->threshold.humidity = h_th;
+    sink->threshold.pressure = p_th;
+
+    return ESP_OK;
+}
+
+static esp_err_t ccs811_apply(void *ctx, const env_comp_env_t *env)
+{
+    return ccs811_set_environmental_data((ccs811_dev_t *)ctx, env->temperature, env->humidity);
+}
+
+static esp_err_t scd4x_apply(void *ctx, const env_comp_env_t *env)
+{
+    return scd4x_set_ambient_ressure((i2c_dev_t *)ctx, (uint16_t)(env->pressure + 0.5f));
+}
+
+static esp_err_t bme680_apply(void *ctx, const env_comp_env_t *env)
+{
+    return bme680_set_ambient_temperature((bme680_t *)ctx, (int16_t)lroundf(env->temperature));
+}
+
+static esp_err_t sgp40_apply(void *ctx, const env_comp_env_t *env)
+{
+    env_comp_sgp40_t *s = (env_comp_sgp40_t *)ctx;
+    s->temperature = env->temperature;
+    s->humidity = env->humidity;
+
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t env_comp_sink_ccs811(env_comp_sink_t *sink, ccs811_dev_t *dev)
+{
+    // CCS811 resolution is 1/512 but compensation effect is small
+    return init_sink(sink, "ccs811", ccs811_apply, dev, ENV_COMP_TEMPERATURE | ENV_COMP_HUMIDITY,
+            0.5f, 1.0f, 0);
+}
+
+esp_err_t env_comp_sink_scd4x(env_comp_sink_t *sink, i2c_dev_t *dev)
+{
+    // SCD4x takes pressure in whole hPa
+    return init_sink(sink, "scd4x", scd4x_apply, dev, ENV_COMP_PRESSURE, 0, 0, 1.0f);
+}
+
+esp_err_t env_comp_sink_bme680(env_comp_sink_t *sink, bme680_t *dev)
+{
+    // BME680 takes ambient temperature in whole degrees
+    return init_sink(sink, "bme680", bme680_apply, dev, ENV_COMP_TEMPERATURE, 1.0f, 0, 0);
+}
+
+esp_err_t env_comp_sink_sgp40(env_comp_sink_t *sink, env_comp_sgp40_t *ctx)
+{
+    CHECK_ARG(ctx && ctx->dev);
+
+    ctx->temperature = NAN;
+    ctx->humidity = NAN;
+
+    // no bus traffic, so any change is applied
+    return init_sink(sink, "sgp40", sgp40_apply, ctx, ENV_COMP_TEMPERATURE | ENV_COMP_HUMIDITY, 0, 0, 0);
+}
+
+esp_err_t env_comp_sgp40_measure_voc(env_comp_t *pipe, env_comp_sgp40_t *ctx, int32_t *voc_index)
+{
+    CHECK_ARG(pipe && pipe->lock && ctx && voc_index);
+
+    xSemaphoreTake(pipe->lock, portMAX_DELAY);
+    float t = ctx->temperature;
+    float h = ctx->humidity;
+    xSemaphoreGive(pipe->lock);
+
+    return sgp40_measure_voc(ctx->dev, h, t, voc_index);
+}
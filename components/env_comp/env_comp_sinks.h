@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file env_comp_sinks.h
+ * @defgroup env_comp_sinks env_comp_sinks
+ * @{
+ *
+ * Adapters of library drivers for env_comp
+ *
+ * Each function initializes a sink with the driver update function and
+ * default thresholds, which are below the resolution of the sensor
+ * compensation inputs. Thresholds can be changed before subscribing.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ENV_COMP_SINKS_H__
+#define __ENV_COMP_SINKS_H__
+
+#include <ccs811.h>
+#include <scd4x.h>
+#include <bme680.h>
+#include <sgp40.h>
+#include "env_comp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SGP40 context. SGP40 takes compensation values with every measurement,
+ * so sink only stores them for ::env_comp_sgp40_measure_voc()
+ */
+typedef struct
+{
+    sgp40_t *dev;       //!< Device descriptor
+    float temperature;  //!< Latest temperature, internal
+    float humidity;     //!< Latest humidity, internal
+} env_comp_sgp40_t;
+
+/**
+ * @brief CCS811 sink: temperature and humidity, ::ccs811_set_environmental_data()
+ *
+ * @param sink Sink
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_sink_ccs811(env_comp_sink_t *sink, ccs811_dev_t *dev);
+
+/**
+ * @brief SCD4x sink: pressure, ::scd4x_set_ambient_ressure()
+ *
+ * @param sink Sink
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_sink_scd4x(env_comp_sink_t *sink, i2c_dev_t *dev);
+
+/**
+ * @brief BME680 sink: ambient temperature for heater, ::bme680_set_ambient_temperature()
+ *
+ * Useful when BME680 is used as gas sensor only.
+ *
+ * @param sink Sink
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_sink_bme680(env_comp_sink_t *sink, bme680_t *dev);
+
+/**
+ * @brief SGP40 sink: temperature and humidity
+ *
+ * @param sink Sink
+ * @param ctx SGP40 context, `dev` must be set
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_sink_sgp40(env_comp_sink_t *sink, env_comp_sgp40_t *ctx);
+
+/**
+ * @brief Measure VOC index with the latest compensation values
+ *
+ * Uncompensated measurement is made until the sink is updated.
+ *
+ * @param pipe Pipeline, `ctx` is subscribed to
+ * @param ctx SGP40 context
+ * @param[out] voc_index Calculated VOC index
+ * @return `ESP_OK` on success
+ */
+esp_err_t env_comp_sgp40_measure_voc(env_comp_t *pipe, env_comp_sgp40_t *ctx, int32_t *voc_index);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __ENV_COMP_SINKS_H__ */
@@ -1,8 +1,11 @@
 COMPONENT_ADD_INCLUDEDIRS = .
 
 ifdef CONFIG_IDF_TARGET_ESP8266
-COMPONENT_DEPENDS = esp8266 freertos
+COMPONENT_DEPENDS = esp8266 freertos log
 else
-COMPONENT_DEPENDS = freertos
+COMPONENT_DEPENDS = freertos log
 endif
 
+ifdef CONFIG_ESP_IDF_LIB_TRACE_SYSVIEW
+COMPONENT_DEPENDS += app_trace
+endif
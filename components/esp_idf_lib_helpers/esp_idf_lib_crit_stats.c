@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file esp_idf_lib_crit_stats.c
+ *
+ * Accounting of CPU critical sections of bit-banged drivers
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * ISC Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <inttypes.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include "esp_idf_lib_helpers.h"
+#include "esp_idf_lib_crit_stats.h"
+
+#ifdef CONFIG_ESP_IDF_LIB_CRIT_STATS
+
+static const char *TAG = "crit_stats";
+
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#endif
+
+static esp_idf_lib_crit_counter_t *counters = NULL;
+
+#if HELPER_TARGET_IS_ESP32
+void IRAM_ATTR esp_idf_lib_crit_stats_record(esp_idf_lib_crit_counter_t *counter)
+#else
+void esp_idf_lib_crit_stats_record(esp_idf_lib_crit_counter_t *counter)
+#endif
+{
+    uint32_t t = esp_timer_get_time() - counter->start;
+
+    // Caller already holds its own lock, this one protects the list and
+    // keeps readers from seeing half-updated counters
+    PORT_ENTER_CRITICAL;
+    counter->stats.count++;
+    counter->stats.total_us += t;
+    if (t > counter->stats.max_us)
+        counter->stats.max_us = t;
+    if (!counter->registered)
+    {
+        counter->next = counters;
+        counters = counter;
+        counter->registered = true;
+    }
+    PORT_EXIT_CRITICAL;
+}
+
+esp_err_t esp_idf_lib_crit_stats_get(const char *name, esp_idf_lib_crit_stats_t *stats)
+{
+    if (!name || !stats)
+        return ESP_ERR_INVALID_ARG;
+
+    esp_err_t res = ESP_ERR_NOT_FOUND;
+    PORT_ENTER_CRITICAL;
+    for (esp_idf_lib_crit_counter_t *c = counters; c; c = c->next)
+        if (!strcmp(c->stats.name, name))
+        {
+            *stats = c->stats;
+            res = ESP_OK;
+            break;
+        }
+    PORT_EXIT_CRITICAL;
+
+    return res;
+}
+
+esp_err_t esp_idf_lib_crit_stats_get_all(esp_idf_lib_crit_stats_t *stats, size_t max, size_t *count)
+{
+    if ((!stats && max) || !count)
+        return ESP_ERR_INVALID_ARG;
+
+    size_t n = 0;
+    PORT_ENTER_CRITICAL;
+    for (esp_idf_lib_crit_counter_t *c = counters; c; c = c->next, n++)
+        if (n < max)
+            stats[n] = c->stats;
+    PORT_EXIT_CRITICAL;
+    *count = n;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_idf_lib_crit_stats_reset()
+{
+    PORT_ENTER_CRITICAL;
+    for (esp_idf_lib_crit_counter_t *c = counters; c; c = c->next)
+    {
+        c->stats.count = 0;
+        c->stats.total_us = 0;
+        c->stats.max_us = 0;
+    }
+    PORT_EXIT_CRITICAL;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_idf_lib_crit_stats_log()
+{
+    esp_idf_lib_crit_stats_t stats[CONFIG_ESP_IDF_LIB_CRIT_STATS_MAX_LOG];
+    size_t count;
+    esp_idf_lib_crit_stats_get_all(stats, CONFIG_ESP_IDF_LIB_CRIT_STATS_MAX_LOG, &count);
+
+    if (!count)
+        ESP_LOGI(TAG, "No critical sections recorded");
+    for (size_t i = 0; i < count && i < CONFIG_ESP_IDF_LIB_CRIT_STATS_MAX_LOG; i++)
+        ESP_LOGI(TAG, "%-12s count: %" PRIu32 ", total: %" PRIu64 " us, avg: %" PRIu32 " us, max: %" PRIu32 " us",
+                stats[i].name, stats[i].count, stats[i].total_us,
+                stats[i].count ? (uint32_t)(stats[i].total_us / stats[i].count) : 0, stats[i].max_us);
+
+    return ESP_OK;
+}
+
+#else
+
+void esp_idf_lib_crit_stats_record(esp_idf_lib_crit_counter_t *counter)
+{
+}
+
+esp_err_t esp_idf_lib_crit_stats_get(const char *name, esp_idf_lib_crit_stats_t *stats)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_idf_lib_crit_stats_get_all(esp_idf_lib_crit_stats_t *stats, size_t max, size_t *count)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_idf_lib_crit_stats_reset()
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_idf_lib_crit_stats_log()
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif
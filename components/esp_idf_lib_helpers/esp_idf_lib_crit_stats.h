@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* Accounting of CPU critical sections of bit-banged drivers
+ *
+ * Drivers wrap their portENTER_CRITICAL()/portEXIT_CRITICAL() pairs with
+ * ESP_IDF_LIB_CRIT_STATS_BEGIN()/ESP_IDF_LIB_CRIT_STATS_END(), which count
+ * number, total and maximal duration of the sections per component.
+ * Enabled by CONFIG_ESP_IDF_LIB_CRIT_STATS, the macros compile to nothing
+ * otherwise and the API functions return ESP_ERR_NOT_SUPPORTED.
+ */
+#if !defined(__ESP_IDF_LIB_CRIT_STATS__H__)
+#define __ESP_IDF_LIB_CRIT_STATS__H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Critical section statistics of a component
+ */
+typedef struct
+{
+    const char *name;  //!< Component name
+    uint32_t count;    //!< Number of critical sections
+    uint64_t total_us; //!< Total time spent in critical sections, microseconds
+    uint32_t max_us;   //!< Longest critical section, microseconds
+} esp_idf_lib_crit_stats_t;
+
+/**
+ * Per-component counter, allocated statically by
+ * ESP_IDF_LIB_CRIT_STATS_DEFINE(). Fields are private.
+ */
+typedef struct esp_idf_lib_crit_counter
+{
+    esp_idf_lib_crit_stats_t stats;
+    int64_t start;
+    bool registered;
+    struct esp_idf_lib_crit_counter *next;
+} esp_idf_lib_crit_counter_t;
+
+/* Called by ESP_IDF_LIB_CRIT_STATS_END() inside the critical section */
+void esp_idf_lib_crit_stats_record(esp_idf_lib_crit_counter_t *counter);
+
+#ifdef CONFIG_ESP_IDF_LIB_CRIT_STATS
+
+#include <esp_timer.h>
+
+#define ESP_IDF_LIB_CRIT_STATS_DEFINE(var, component) \
+    static esp_idf_lib_crit_counter_t var = { .stats = { .name = (component) } }
+#define ESP_IDF_LIB_CRIT_STATS_BEGIN(var) do { (var).start = esp_timer_get_time(); } while (0)
+#define ESP_IDF_LIB_CRIT_STATS_END(var) esp_idf_lib_crit_stats_record(&(var))
+
+#else
+
+#define ESP_IDF_LIB_CRIT_STATS_DEFINE(var, component)
+#define ESP_IDF_LIB_CRIT_STATS_BEGIN(var) do { } while (0)
+#define ESP_IDF_LIB_CRIT_STATS_END(var) do { } while (0)
+
+#endif
+
+/**
+ * @brief Get statistics of a component
+ *
+ * Nested sections (e.g. ds18x20 calling onewire) are counted by both
+ * components.
+ *
+ * @param name Component name, e.g. "dht"
+ * @param[out] stats Statistics
+ * @return `ESP_OK` on success, `ESP_ERR_NOT_FOUND` if the component has not
+ *         entered a critical section yet
+ */
+esp_err_t esp_idf_lib_crit_stats_get(const char *name, esp_idf_lib_crit_stats_t *stats);
+
+/**
+ * @brief Get statistics of all components
+ *
+ * @param[out] stats Array of statistics
+ * @param max Size of array
+ * @param[out] count Number of components with stats, can be greater than `max`
+ * @return `ESP_OK` on success
+ */
+esp_err_t esp_idf_lib_crit_stats_get_all(esp_idf_lib_crit_stats_t *stats, size_t max, size_t *count);
+
+/**
+ * @brief Reset statistics of all components
+ *
+ * @return `ESP_OK` on success
+ */
+esp_err_t esp_idf_lib_crit_stats_reset();
+
+/**
+ * @brief Log statistics of all components with ESP_LOGI
+ *
+ * @return `ESP_OK` on success
+ */
+esp_err_t esp_idf_lib_crit_stats_log();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ESP_IDF_LIB_CRIT_STATS__H__ */
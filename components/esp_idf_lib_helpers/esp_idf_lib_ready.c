@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file esp_idf_lib_ready.c
+ *
+ * Conversion ready tokens
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * ISC Licensed as described in the file LICENSE
+ */
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sdkconfig.h>
+#if CONFIG_ESP_IDF_LIB_READY_LIGHT_SLEEP
+#include <esp_sleep.h>
+#endif
+#include "esp_idf_lib_trace.h"
+#include "esp_idf_lib_ready.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define TICK_US (portTICK_PERIOD_MS * 1000)
+
+#if CONFIG_ESP_IDF_LIB_READY_LIGHT_SLEEP
+static esp_err_t light_sleep(int64_t us)
+{
+    CHECK(esp_sleep_enable_timer_wakeup(us));
+    esp_err_t res = esp_light_sleep_start();
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    return res;
+}
+#endif
+
+esp_err_t esp_idf_lib_sleep_until(int64_t time_us)
+{
+    int64_t left = time_us - esp_timer_get_time();
+    if (left <= 0)
+        return ESP_OK;
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_WAIT, left / TICK_US);
+    esp_err_t res = ESP_OK;
+    while (left > 0)
+    {
+#if CONFIG_ESP_IDF_LIB_READY_LIGHT_SLEEP
+        if (left >= CONFIG_ESP_IDF_LIB_READY_SLEEP_MIN_US)
+        {
+            if ((res = light_sleep(left)) != ESP_OK)
+                break;
+            left = time_us - esp_timer_get_time();
+            continue;
+        }
+#endif
+        // vTaskDelay(1) may end on the next tick, so round down and recheck
+        TickType_t ticks = left / TICK_US;
+        vTaskDelay(ticks ? ticks : 1);
+        left = time_us - esp_timer_get_time();
+    }
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_WAIT);
+
+    return res;
+}
+
+esp_err_t esp_idf_lib_ready_wait(esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(ready);
+    if (!ready->ready_us)
+        return ESP_ERR_INVALID_STATE;
+
+    CHECK(esp_idf_lib_sleep_until(ready->ready_us));
+    ready->ready_us = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_idf_lib_ready_wait_any(esp_idf_lib_ready_t *const *tokens, size_t count, size_t *index)
+{
+    CHECK_ARG(tokens && index);
+
+    esp_idf_lib_ready_t *earliest = NULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!tokens[i] || !tokens[i]->ready_us)
+            continue;
+        if (!earliest || tokens[i]->ready_us < earliest->ready_us)
+        {
+            earliest = tokens[i];
+            *index = i;
+        }
+    }
+    if (!earliest)
+        return ESP_ERR_NOT_FOUND;
+
+    return esp_idf_lib_ready_wait(earliest);
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file esp_idf_lib_ready.h
+ *
+ * Conversion ready tokens
+ *
+ * Sensor drivers with separate start and read steps fill a ready token when
+ * they start a conversion: the time when the result can be read. Instead of
+ * a fixed delay per sensor, application starts conversions of all sensors
+ * and waits for the earliest token with ::esp_idf_lib_ready_wait_any(), so
+ * conversions overlap and the task sleeps until a result is due.
+ *
+ * Waits are done with vTaskDelay(), so with power management and tickless
+ * idle enabled the chip enters automatic light sleep while all tasks wait.
+ * With CONFIG_ESP_IDF_LIB_READY_LIGHT_SLEEP long waits enter light sleep
+ * explicitly, which suits applications where the measuring task is the
+ * only active one.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * ISC Licensed as described in the file LICENSE
+ */
+#if !defined(__ESP_IDF_LIB_READY__H__)
+#define __ESP_IDF_LIB_READY__H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <esp_err.h>
+#include <esp_timer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Conversion ready token
+ */
+typedef struct
+{
+    int64_t ready_us; //!< Time since boot when result is ready, 0 if no conversion is pending
+} esp_idf_lib_ready_t;
+
+/**
+ * @brief Mark conversion started now and ready after `us` microseconds
+ *
+ * @param ready Token
+ * @param us    Conversion time
+ */
+static inline void esp_idf_lib_ready_after(esp_idf_lib_ready_t *ready, uint32_t us)
+{
+    ready->ready_us = esp_timer_get_time() + us;
+}
+
+/**
+ * @brief Check if conversion is pending
+ *
+ * @param ready Token
+ * @return true if token was set and not waited for yet
+ */
+static inline bool esp_idf_lib_ready_pending(const esp_idf_lib_ready_t *ready)
+{
+    return ready->ready_us != 0;
+}
+
+/**
+ * @brief Check if result can be read without waiting
+ *
+ * @param ready Token
+ * @return true if conversion is pending and its time has come
+ */
+static inline bool esp_idf_lib_ready_check(const esp_idf_lib_ready_t *ready)
+{
+    return ready->ready_us && esp_timer_get_time() >= ready->ready_us;
+}
+
+/**
+ * @brief Sleep until time since boot
+ *
+ * Returns immediately if the time has passed.
+ *
+ * @param time_us Time since boot, microseconds
+ * @return ESP_OK on success
+ */
+esp_err_t esp_idf_lib_sleep_until(int64_t time_us);
+
+/**
+ * @brief Wait for conversion and clear token
+ *
+ * @param ready Token
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if no conversion is pending
+ */
+esp_err_t esp_idf_lib_ready_wait(esp_idf_lib_ready_t *ready);
+
+/**
+ * @brief Wait for the earliest of pending conversions and clear its token
+ *
+ * Call it in a loop and read the sensor of returned token, until
+ * ESP_ERR_NOT_FOUND is returned.
+ *
+ * @param tokens     Array of token pointers, NULL items are skipped
+ * @param count      Number of items
+ * @param[out] index Index of the ready token
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no conversion is pending
+ */
+esp_err_t esp_idf_lib_ready_wait_any(esp_idf_lib_ready_t *const *tokens, size_t count, size_t *index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ESP_IDF_LIB_READY__H__ */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* Lock-free single producer, single consumer ring buffer
+ *
+ * One side (typically an ISR) pushes fixed-size items, the other (a task)
+ * pops them. Indices run freely and wrap by mask, so capacity must be
+ * a power of two and all slots are usable. Nothing is locked, the only
+ * synchronization is acquire/release ordering of the indices, so push is
+ * a few instructions and never blocks, unlike xQueueSendFromISR().
+ *
+ * Items are either copied with esp_idf_lib_ring_push()/esp_idf_lib_ring_pop()
+ * or written and read in place with esp_idf_lib_ring_slot()/
+ * esp_idf_lib_ring_commit() and esp_idf_lib_ring_peek()/
+ * esp_idf_lib_ring_release(). Functions of each side must be called from
+ * one context only. Push functions are placed in IRAM on ESP32, storage
+ * must be in internal RAM if the producer is an IRAM-safe ISR.
+ */
+#if !defined(__ESP_IDF_LIB_RING__H__)
+#define __ESP_IDF_LIB_RING__H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sdkconfig.h>
+#include <esp_err.h>
+#include <esp_attr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(CONFIG_IDF_TARGET_ESP8266)
+#define ESP_IDF_LIB_RING_ATTR
+#else
+#define ESP_IDF_LIB_RING_ATTR IRAM_ATTR
+#endif
+
+/**
+ * Ring buffer descriptor. Fields are private.
+ */
+typedef struct
+{
+    uint8_t *data;           //!< Storage of `mask + 1` items
+    uint32_t item_size;      //!< Size of item, bytes
+    uint32_t mask;           //!< Capacity - 1
+    volatile uint32_t head;  //!< Write index, written by producer
+    volatile uint32_t tail;  //!< Read index, written by consumer
+    uint32_t overruns;       //!< Items dropped because the ring was full, written by producer
+} esp_idf_lib_ring_t;
+
+/**
+ * Timestamped sample of a scalar sensor (ADC, load cell, encoder position)
+ */
+typedef struct
+{
+    int64_t ts;     //!< Timestamp, e.g. esp_timer_get_time(), us
+    int32_t value;  //!< Raw value
+} esp_idf_lib_sample_t;
+
+/**
+ * Timestamped sample of a 3-axis sensor (magnetometer, accelerometer)
+ */
+typedef struct
+{
+    int64_t ts;     //!< Timestamp, e.g. esp_timer_get_time(), us
+    int32_t x;      //!< Raw X value
+    int32_t y;      //!< Raw Y value
+    int32_t z;      //!< Raw Z value
+} esp_idf_lib_sample3_t;
+
+/**
+ * Define static storage and descriptor of a ring of `capacity` items of `type`
+ *
+ * `capacity` must be a power of two.
+ */
+#define ESP_IDF_LIB_RING_DEFINE(name, type, capacity) \
+    static type name##_storage[(capacity)]; \
+    static esp_idf_lib_ring_t name = { \
+        .data = (uint8_t *)name##_storage, \
+        .item_size = sizeof(type), \
+        .mask = (capacity) - 1, \
+    }
+
+/**
+ * @brief Initialize ring buffer
+ *
+ * @param ring      Ring descriptor
+ * @param data      Storage of `capacity * item_size` bytes
+ * @param item_size Size of item, bytes
+ * @param capacity  Number of items, power of two
+ * @return `ESP_OK` on success
+ */
+static inline esp_err_t esp_idf_lib_ring_init(esp_idf_lib_ring_t *ring, void *data, size_t item_size, size_t capacity)
+{
+    if (!ring || !data || !item_size || !capacity || (capacity & (capacity - 1)))
+        return ESP_ERR_INVALID_ARG;
+    ring->data = (uint8_t *)data;
+    ring->item_size = item_size;
+    ring->mask = capacity - 1;
+    ring->head = ring->tail = 0;
+    ring->overruns = 0;
+    return ESP_OK;
+}
+
+/**
+ * @brief Number of items in the ring
+ */
+static inline size_t ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_count(const esp_idf_lib_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Capacity of the ring, items
+ */
+static inline size_t esp_idf_lib_ring_capacity(const esp_idf_lib_ring_t *ring)
+{
+    return ring->mask + 1;
+}
+
+/**
+ * @brief Get free slot to write the next item in place, producer side
+ *
+ * Item becomes visible to consumer after esp_idf_lib_ring_commit().
+ *
+ * @return Pointer to slot or NULL if the ring is full, overrun is counted then
+ */
+static inline void * ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_slot(esp_idf_lib_ring_t *ring)
+{
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask)
+    {
+        ring->overruns++;
+        return NULL;
+    }
+    return ring->data + (head & ring->mask) * ring->item_size;
+}
+
+/**
+ * @brief Publish item written to slot, producer side
+ */
+static inline void ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_commit(esp_idf_lib_ring_t *ring)
+{
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy item to the ring, producer side
+ *
+ * @return false if the ring is full and item was dropped
+ */
+static inline bool ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_push(esp_idf_lib_ring_t *ring, const void *item)
+{
+    void *slot = esp_idf_lib_ring_slot(ring);
+    if (!slot)
+        return false;
+    memcpy(slot, item, ring->item_size);
+    esp_idf_lib_ring_commit(ring);
+    return true;
+}
+
+/**
+ * @brief Get the oldest item in place, consumer side
+ *
+ * Slot stays valid until esp_idf_lib_ring_release().
+ *
+ * @return Pointer to item or NULL if the ring is empty
+ */
+static inline void *esp_idf_lib_ring_peek(esp_idf_lib_ring_t *ring)
+{
+    uint32_t tail = ring->tail;
+    if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+        return NULL;
+    return ring->data + (tail & ring->mask) * ring->item_size;
+}
+
+/**
+ * @brief Return slot of the oldest item to producer, consumer side
+ */
+static inline void esp_idf_lib_ring_release(esp_idf_lib_ring_t *ring)
+{
+    __atomic_store_n(&ring->tail, ring->tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy the oldest item from the ring, consumer side
+ *
+ * @return false if the ring is empty
+ */
+static inline bool esp_idf_lib_ring_pop(esp_idf_lib_ring_t *ring, void *item)
+{
+    void *slot = esp_idf_lib_ring_peek(ring);
+    if (!slot)
+        return false;
+    memcpy(item, slot, ring->item_size);
+    esp_idf_lib_ring_release(ring);
+    return true;
+}
+
+/**
+ * @brief Drop all items, consumer side
+ */
+static inline void esp_idf_lib_ring_flush(esp_idf_lib_ring_t *ring)
+{
+    __atomic_store_n(&ring->tail, __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Push timestamped scalar sample, producer side
+ *
+ * Ring must be initialized with `sizeof(esp_idf_lib_sample_t)` items.
+ *
+ * @return false if the ring is full and sample was dropped
+ */
+static inline bool ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_push_sample(esp_idf_lib_ring_t *ring, int64_t ts, int32_t value)
+{
+    esp_idf_lib_sample_t *s = (esp_idf_lib_sample_t *)esp_idf_lib_ring_slot(ring);
+    if (!s)
+        return false;
+    s->ts = ts;
+    s->value = value;
+    esp_idf_lib_ring_commit(ring);
+    return true;
+}
+
+/**
+ * @brief Push timestamped 3-axis sample, producer side
+ *
+ * Ring must be initialized with `sizeof(esp_idf_lib_sample3_t)` items.
+ *
+ * @return false if the ring is full and sample was dropped
+ */
+static inline bool ESP_IDF_LIB_RING_ATTR esp_idf_lib_ring_push_sample3(esp_idf_lib_ring_t *ring, int64_t ts,
+        int32_t x, int32_t y, int32_t z)
+{
+    esp_idf_lib_sample3_t *s = (esp_idf_lib_sample3_t *)esp_idf_lib_ring_slot(ring);
+    if (!s)
+        return false;
+    s->ts = ts;
+    s->x = x;
+    s->y = y;
+    s->z = z;
+    esp_idf_lib_ring_commit(ring);
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ESP_IDF_LIB_RING__H__ */
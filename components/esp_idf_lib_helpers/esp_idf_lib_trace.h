@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* Trace markers of bus activity and conversion waits
+ *
+ * Drivers wrap bus transfers, bus lock waits and conversion delays with
+ * ESP_IDF_LIB_TRACE_BEGIN()/ESP_IDF_LIB_TRACE_END(). Backend is selected
+ * in menuconfig (ESP-IDF-LIB tracing), markers compile to nothing when
+ * tracing is disabled.
+ */
+#if !defined(__ESP_IDF_LIB_TRACE__H__)
+#define __ESP_IDF_LIB_TRACE__H__
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/* Marker IDs */
+#define ESP_IDF_LIB_TRACE_I2C          0 /* I2C transfer, arg: (port << 8) | address */
+#define ESP_IDF_LIB_TRACE_I2C_LOCK     1 /* Waiting for I2C port lock, arg: port */
+#define ESP_IDF_LIB_TRACE_I2C_DEV_LOCK 2 /* Waiting for I2C device mutex, arg: (port << 8) | address */
+#define ESP_IDF_LIB_TRACE_SPI          3 /* SPI transaction, arg: transfer length, bits */
+#define ESP_IDF_LIB_TRACE_ONEWIRE      4 /* 1-Wire reset or byte, arg: GPIO */
+#define ESP_IDF_LIB_TRACE_WAIT         5 /* Conversion delay, arg: ticks */
+
+#if defined(CONFIG_ESP_IDF_LIB_TRACE_SYSVIEW)
+
+#include <SEGGER_SYSVIEW.h>
+
+#define ESP_IDF_LIB_TRACE_BEGIN(id, arg) SEGGER_SYSVIEW_OnUserStart(CONFIG_ESP_IDF_LIB_TRACE_ID_BASE + (id))
+#define ESP_IDF_LIB_TRACE_END(id) SEGGER_SYSVIEW_OnUserStop(CONFIG_ESP_IDF_LIB_TRACE_ID_BASE + (id))
+
+#elif defined(CONFIG_ESP_IDF_LIB_TRACE_HOOKS)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Defined by application, called from task context only */
+void esp_idf_lib_trace_begin(uint32_t id, uint32_t arg);
+void esp_idf_lib_trace_end(uint32_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define ESP_IDF_LIB_TRACE_BEGIN(id, arg) esp_idf_lib_trace_begin((id), (uint32_t)(arg))
+#define ESP_IDF_LIB_TRACE_END(id) esp_idf_lib_trace_end(id)
+
+#else
+
+#define ESP_IDF_LIB_TRACE_BEGIN(id, arg) do { } while (0)
+#define ESP_IDF_LIB_TRACE_END(id) do { } while (0)
+
+#endif
+
+/* vTaskDelay() marked as conversion wait */
+#define ESP_IDF_LIB_TRACE_DELAY(ticks) do { \
+        TickType_t __ticks = (ticks); \
+        ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_WAIT, __ticks); \
+        vTaskDelay(__ticks); \
+        ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_WAIT); \
+    } while (0)
+
+#endif
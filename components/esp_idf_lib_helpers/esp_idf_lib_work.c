@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/**
+ * @file esp_idf_lib_work.c
+ *
+ * Shared deferred work service
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * ISC Licensed as described in the file LICENSE
+ */
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include "esp_idf_lib_helpers.h"
+#include "esp_idf_lib_work.h"
+
+static const char *TAG = "esp_idf_lib_work";
+
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL_ISR portENTER_CRITICAL_ISR(&mux)
+#define PORT_EXIT_CRITICAL_ISR portEXIT_CRITICAL_ISR(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL_ISR
+#define PORT_EXIT_CRITICAL_ISR
+#endif
+
+#if CONFIG_ESP_IDF_LIB_WORKER_CORE < 0
+#define WORKER_CORE tskNO_AFFINITY
+#else
+#define WORKER_CORE CONFIG_ESP_IDF_LIB_WORKER_CORE
+#endif
+
+static QueueHandle_t queue = NULL;
+static TaskHandle_t task = NULL;
+static esp_idf_lib_work_t *volatile running = NULL;
+
+static void worker_task(void *arg)
+{
+    esp_idf_lib_work_t *work;
+    while (true)
+    {
+        if (xQueueReceive(queue, &work, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        // Submissions from now on queue the item again
+        PORT_ENTER_CRITICAL;
+        work->pending = false;
+        running = work;
+        PORT_EXIT_CRITICAL;
+
+        work->cb(work->arg);
+
+        running = NULL;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+esp_err_t esp_idf_lib_worker_start()
+{
+    PORT_ENTER_CRITICAL;
+    bool started = queue != NULL;
+    PORT_EXIT_CRITICAL;
+    if (started)
+        return ESP_OK;
+
+    QueueHandle_t q = xQueueCreate(CONFIG_ESP_IDF_LIB_WORKER_QUEUE_LEN, sizeof(esp_idf_lib_work_t *));
+    if (!q)
+        return ESP_ERR_NO_MEM;
+
+    // Two components may start the worker at the same time
+    PORT_ENTER_CRITICAL;
+    started = queue != NULL;
+    if (!started)
+        queue = q;
+    PORT_EXIT_CRITICAL;
+    if (started)
+    {
+        vQueueDelete(q);
+        return ESP_OK;
+    }
+
+#if HELPER_TARGET_IS_ESP8266
+    BaseType_t res = xTaskCreate(worker_task, "esp_idf_lib_work", CONFIG_ESP_IDF_LIB_WORKER_STACK_SIZE, NULL,
+            CONFIG_ESP_IDF_LIB_WORKER_PRIORITY, &task);
+#else
+    BaseType_t res = xTaskCreatePinnedToCore(worker_task, "esp_idf_lib_work", CONFIG_ESP_IDF_LIB_WORKER_STACK_SIZE,
+            NULL, CONFIG_ESP_IDF_LIB_WORKER_PRIORITY, &task, WORKER_CORE);
+#endif
+    if (res != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create worker task");
+        PORT_ENTER_CRITICAL;
+        queue = NULL;
+        PORT_EXIT_CRITICAL;
+        vQueueDelete(q);
+        task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t esp_idf_lib_work_init(esp_idf_lib_work_t *work, esp_idf_lib_work_cb_t cb, void *arg,
+        esp_idf_lib_work_prio_t prio)
+{
+    if (!work || !cb)
+        return ESP_ERR_INVALID_ARG;
+
+    work->cb = cb;
+    work->arg = arg;
+    work->prio = prio;
+    work->pending = false;
+    work->coalesced = 0;
+    work->dropped = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t esp_idf_lib_work_submit(esp_idf_lib_work_t *work)
+{
+    if (!queue)
+        return ESP_ERR_INVALID_STATE;
+
+    PORT_ENTER_CRITICAL;
+    bool pending = work->pending;
+    if (pending)
+        work->coalesced++;
+    work->pending = true;
+    PORT_EXIT_CRITICAL;
+    if (pending)
+        return ESP_OK;
+
+    BaseType_t res = work->prio == ESP_IDF_LIB_WORK_HIGH
+            ? xQueueSendToFront(queue, &work, 0)
+            : xQueueSendToBack(queue, &work, 0);
+    if (res == pdTRUE)
+        return ESP_OK;
+
+    PORT_ENTER_CRITICAL;
+    work->pending = false;
+    work->dropped++;
+    PORT_EXIT_CRITICAL;
+
+    return ESP_ERR_NO_MEM;
+}
+
+#if HELPER_TARGET_IS_ESP32
+esp_err_t IRAM_ATTR esp_idf_lib_work_submit_from_isr(esp_idf_lib_work_t *work, BaseType_t *woken)
+#else
+esp_err_t esp_idf_lib_work_submit_from_isr(esp_idf_lib_work_t *work, BaseType_t *woken)
+#endif
+{
+    if (!queue)
+        return ESP_ERR_INVALID_STATE;
+
+    PORT_ENTER_CRITICAL_ISR;
+    bool pending = work->pending;
+    if (pending)
+        work->coalesced++;
+    work->pending = true;
+    PORT_EXIT_CRITICAL_ISR;
+    if (pending)
+        return ESP_OK;
+
+    BaseType_t res = work->prio == ESP_IDF_LIB_WORK_HIGH
+            ? xQueueSendToFrontFromISR(queue, &work, woken)
+            : xQueueSendToBackFromISR(queue, &work, woken);
+    if (res == pdTRUE)
+        return ESP_OK;
+
+    PORT_ENTER_CRITICAL_ISR;
+    work->pending = false;
+    work->dropped++;
+    PORT_EXIT_CRITICAL_ISR;
+
+    return ESP_ERR_NO_MEM;
+}
+
+void esp_idf_lib_work_timer_cb(void *arg)
+{
+    esp_idf_lib_work_submit((esp_idf_lib_work_t *)arg);
+}
+
+uint32_t esp_idf_lib_work_take_coalesced(esp_idf_lib_work_t *work)
+{
+    if (!work)
+        return 0;
+
+    PORT_ENTER_CRITICAL;
+    uint32_t res = work->coalesced;
+    work->coalesced = 0;
+    PORT_EXIT_CRITICAL;
+
+    return res;
+}
+
+esp_err_t esp_idf_lib_work_flush(esp_idf_lib_work_t *work)
+{
+    if (!work)
+        return ESP_ERR_INVALID_ARG;
+    if (task && xTaskGetCurrentTaskHandle() == task)
+        return ESP_ERR_INVALID_STATE;
+
+    while (work->pending || running == work)
+        vTaskDelay(1);
+
+    return ESP_OK;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/* Shared deferred work service
+ *
+ * Periodic and interrupt-driven components (button, encoder, framebuffer
+ * animation) do not run their work in the esp_timer task anymore: timer
+ * callbacks and ISRs only submit a work item, and the item is executed by
+ * a single worker task shared by all components. Slow work, e.g. I/O
+ * expander reads or drawing of a frame, no longer delays other esp_timer
+ * callbacks of the system.
+ *
+ * Items of ESP_IDF_LIB_WORK_HIGH priority are queued before items of
+ * ESP_IDF_LIB_WORK_NORMAL priority. Submitting an item which is already
+ * queued does nothing, so a slow item never floods the queue.
+ *
+ * Worker task priority, stack size, core and queue length are set in
+ * menuconfig.
+ */
+#if !defined(__ESP_IDF_LIB_WORK__H__)
+#define __ESP_IDF_LIB_WORK__H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Work function
+ */
+typedef void (*esp_idf_lib_work_cb_t)(void *arg);
+
+/**
+ * Work item priority
+ */
+typedef enum
+{
+    ESP_IDF_LIB_WORK_NORMAL = 0, //!< Queued at the back
+    ESP_IDF_LIB_WORK_HIGH,       //!< Queued at the front, e.g. input polling
+} esp_idf_lib_work_prio_t;
+
+/**
+ * Work item, usually a member of the component descriptor or a static
+ * variable. Must stay valid while it is queued or running.
+ */
+typedef struct
+{
+    esp_idf_lib_work_cb_t cb;     //!< Work function
+    void *arg;                    //!< Work function argument
+    esp_idf_lib_work_prio_t prio; //!< Priority
+    volatile bool pending;        //!< Internal: item is queued
+    uint32_t coalesced;           //!< Submissions skipped because item was already queued, see esp_idf_lib_work_take_coalesced()
+    uint32_t dropped;             //!< Submissions dropped because queue was full
+} esp_idf_lib_work_t;
+
+/**
+ * @brief Start worker task
+ *
+ * Does nothing if the worker is already running. Call it from component
+ * init functions before submitting any work.
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t esp_idf_lib_worker_start();
+
+/**
+ * @brief Initialize work item
+ *
+ * @param work Work item
+ * @param cb   Work function
+ * @param arg  Work function argument
+ * @param prio Priority
+ * @return ESP_OK on success
+ */
+esp_err_t esp_idf_lib_work_init(esp_idf_lib_work_t *work, esp_idf_lib_work_cb_t cb, void *arg,
+        esp_idf_lib_work_prio_t prio);
+
+/**
+ * @brief Queue work item for execution in worker task
+ *
+ * Never blocks. If the item is already queued, the call is counted
+ * in `coalesced` and item is executed once.
+ *
+ * @param work Work item
+ * @return ESP_OK on success or if item is already queued,
+ *         ESP_ERR_INVALID_STATE if worker is not started,
+ *         ESP_ERR_NO_MEM if queue is full
+ */
+esp_err_t esp_idf_lib_work_submit(esp_idf_lib_work_t *work);
+
+/**
+ * @brief Queue work item from ISR
+ *
+ * @param work  Work item
+ * @param woken Set to pdTRUE if context switch is required, can be NULL
+ * @return ESP_OK on success or if item is already queued,
+ *         ESP_ERR_INVALID_STATE if worker is not started,
+ *         ESP_ERR_NO_MEM if queue is full
+ */
+esp_err_t esp_idf_lib_work_submit_from_isr(esp_idf_lib_work_t *work, BaseType_t *woken);
+
+/**
+ * @brief esp_timer callback which submits work item passed as `arg`
+ *
+ * Use it as `callback` of `esp_timer_create_args_t` with the work item
+ * as `arg`, so the esp_timer task only queues the item.
+ *
+ * @param arg Work item (esp_idf_lib_work_t *)
+ */
+void esp_idf_lib_work_timer_cb(void *arg);
+
+/**
+ * @brief Get and reset `coalesced` counter of work item
+ *
+ * Counter is incremented by submitting tasks and ISRs, so it must not be
+ * read and cleared directly.
+ *
+ * @param work Work item
+ * @return Number of submissions coalesced since the previous call
+ */
+uint32_t esp_idf_lib_work_take_coalesced(esp_idf_lib_work_t *work);
+
+/**
+ * @brief Wait until work item is neither queued nor running
+ *
+ * Call it after the timer or interrupt which submits the item is stopped,
+ * before the data used by the work function is changed or freed.
+ *
+ * @param work Work item
+ * @return ESP_OK on success,
+ *         ESP_ERR_INVALID_STATE when called from the worker task
+ */
+esp_err_t esp_idf_lib_work_flush(esp_idf_lib_work_t *work);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ESP_IDF_LIB_WORK__H__ */
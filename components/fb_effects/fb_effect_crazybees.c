@@ -1,5 +1,5 @@
 /**
- * @file crazybees.c
+ * @file fb_effect_crazybees.c
  *
  * Crazy Bees effect
  *
@@ -8,7 +8,7 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/crazybees.h"
+#include "fb_effect_crazybees.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -26,25 +26,15 @@ typedef struct
     bee_t bees[CRAZYBEES_MAX_BEES];
 } params_t;
 
-esp_err_t led_effect_crazybees_init(framebuffer_t *fb, uint8_t num_bees)
+esp_err_t fb_effect_crazybees_init(fb_effects_t *fx, uint8_t num_bees)
 {
-    CHECK_ARG(fb && num_bees && num_bees <= CRAZYBEES_MAX_BEES);
+    CHECK_ARG(fx && fx->fb && num_bees && num_bees <= CRAZYBEES_MAX_BEES);
+    framebuffer_t *fb = fx->fb;
 
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_crazybees_set_params(fb, num_bees);
-}
-
-esp_err_t led_effect_crazybees_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb);
-
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
+    return fb_effect_crazybees_set_params(fb, num_bees);
 }
 
 static void change_flower(framebuffer_t *fb, uint8_t bee)
@@ -55,7 +45,7 @@ static void change_flower(framebuffer_t *fb, uint8_t bee)
     params->bees[bee].hue = random8();
 }
 
-esp_err_t led_effect_crazybees_set_params(framebuffer_t *fb, uint8_t num_bees)
+esp_err_t fb_effect_crazybees_set_params(framebuffer_t *fb, uint8_t num_bees)
 {
     CHECK_ARG(fb && fb->internal && num_bees && num_bees <= CRAZYBEES_MAX_BEES);
 
@@ -74,7 +64,7 @@ esp_err_t led_effect_crazybees_set_params(framebuffer_t *fb, uint8_t num_bees)
     return ESP_OK;
 }
 
-esp_err_t led_effect_crazybees_run(framebuffer_t *fb)
+esp_err_t fb_effect_crazybees_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -109,3 +99,20 @@ esp_err_t led_effect_crazybees_run(framebuffer_t *fb)
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_crazybees_init(fx, random8_between(2, 5));
+}
+
+const fb_effect_t fb_effect_crazybees = {
+    .name = "crazybees",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_crazybees_run,
+};
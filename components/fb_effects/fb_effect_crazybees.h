@@ -0,0 +1,36 @@
+/**
+ * @file fb_effect_crazybees.h
+ *
+ * @defgroup fb_effect_crazybees fb_effect_crazybees
+ * @{
+ *
+ * Crazy Bees effect
+ *
+ * Author: Stepko
+ */
+#ifndef __FB_EFFECT_CRAZYBEES_H__
+#define __FB_EFFECT_CRAZYBEES_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRAZYBEES_MAX_BEES 10
+
+esp_err_t fb_effect_crazybees_init(fb_effects_t *fx, uint8_t num_bees);
+
+esp_err_t fb_effect_crazybees_set_params(framebuffer_t *fb, uint8_t num_bees);
+
+esp_err_t fb_effect_crazybees_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_crazybees;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_CRAZYBEES_H__ */
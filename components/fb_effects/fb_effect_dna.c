@@ -1,5 +1,5 @@
 /**
- * @file dna.c
+ * @file fb_effect_dna.c
  *
  * DNA spiral effect
  *
@@ -15,7 +15,7 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/dna.h"
+#include "fb_effect_dna.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -30,30 +30,18 @@ typedef struct
     uint32_t offset;
 } params_t;
 
-esp_err_t led_effect_dna_init(framebuffer_t *fb, uint8_t speed, uint8_t size, bool border)
+esp_err_t fb_effect_dna_init(fb_effects_t *fx, uint8_t speed, uint8_t size, bool border)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    // allocate internal storage
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_dna_set_params(fb, speed, size, border);
+    return fb_effect_dna_set_params(fb, speed, size, border);
 }
 
-esp_err_t led_effect_dna_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb && fb->internal);
-
-    // free internal storage
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_dna_set_params(framebuffer_t *fb, uint8_t speed, uint8_t size, bool border)
+esp_err_t fb_effect_dna_set_params(framebuffer_t *fb, uint8_t speed, uint8_t size, bool border)
 {
     CHECK_ARG(fb && fb->internal);
 
@@ -68,7 +56,7 @@ esp_err_t led_effect_dna_set_params(framebuffer_t *fb, uint8_t speed, uint8_t si
 static const rgb_t dark_slate_gray = { .r = 0x2f, .g = 0x4f, .b = 0x4f };
 static const rgb_t white = { .r = 0xff, .g = 0xff, .b = 0xff };
 
-void horizontal_line(framebuffer_t *fb, uint8_t x1, uint8_t x2, uint8_t y, rgb_t color, bool dot)
+static void horizontal_line(framebuffer_t *fb, uint8_t x1, uint8_t x2, uint8_t y, rgb_t color, bool dot)
 {
     uint8_t steps = abs8(x2 - x1) + 1;
 
@@ -91,7 +79,7 @@ void horizontal_line(framebuffer_t *fb, uint8_t x1, uint8_t x2, uint8_t y, rgb_t
     }
 }
 
-esp_err_t led_effect_dna_run(framebuffer_t *fb)
+esp_err_t fb_effect_dna_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -114,3 +102,20 @@ esp_err_t led_effect_dna_run(framebuffer_t *fb)
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_dna_init(fx, random8_between(10, 100), random8_between(1, 10), random8_to(2));
+}
+
+const fb_effect_t fb_effect_dna = {
+    .name = "dna",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_dna_run,
+};
@@ -0,0 +1,41 @@
+/**
+ * @file fb_effect_dna.h
+ *
+ * @defgroup fb_effect_dna fb_effect_dna
+ * @{
+ *
+ * DNA spiral effect
+ *
+ * Author: Yaroslaw Turbin (https://vk.com/ldirko, https://www.reddit.com/user/ldirko/)
+ *
+ * Max supported framebuffer size is 256x256
+ *
+ * Parameters:
+ *   - speed:  Speed of rotation, 10 - 100
+ *   - size:   Spiral size, 1 - 10
+ *   - border: Add white border
+ */
+#ifndef __FB_EFFECT_DNA_H__
+#define __FB_EFFECT_DNA_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t fb_effect_dna_init(fb_effects_t *fx, uint8_t speed, uint8_t size, bool border);
+
+esp_err_t fb_effect_dna_set_params(framebuffer_t *fb, uint8_t speed, uint8_t size, bool border);
+
+esp_err_t fb_effect_dna_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_dna;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_DNA_H__ */
@@ -0,0 +1,125 @@
+/**
+ * @file fb_effect_fire.c
+ *
+ * Fire effect based on Perlin noise
+ *
+ * Author: Yaroslaw Turbin (https://vk.com/ldirko, https://www.reddit.com/user/ldirko/)
+ *
+ * https://pastebin.com/jSSVSRi6
+ */
+#include <lib8tion.h>
+#include <noise.h>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_timer.h>
+
+#include "fb_effect_fire.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define PALETTE_SIZE 16
+
+typedef struct
+{
+    color_palette16_t palette;
+    uint8_t *noise;
+    uint32_t time;
+} params_t;
+
+esp_err_t fb_effect_fire_init(fb_effects_t *fx, fb_effect_fire_palette_t p)
+{
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
+
+    params_t *params = fb_effects_alloc_state(fx, sizeof(params_t));
+    if (!params)
+        return ESP_ERR_NO_MEM;
+    params->noise = fb_effects_alloc(fx, fb->width * fb->height);
+    if (!params->noise)
+        return ESP_ERR_NO_MEM;
+
+    return fb_effect_fire_set_params(fb, p);
+}
+
+static const rgb_t C_BLACK  = { 0 };
+static const rgb_t C_WHITE  = { .r = 255, .g = 255, .b = 255 };
+static const rgb_t C_DBLUE  = { .r = 0,   .g = 0,   .b = 100 };
+static const rgb_t C_CYAN   = { .r = 0,   .g = 200, .b = 255 };
+static const rgb_t C_RED    = { .r = 255, .g = 0,   .b = 0 };
+static const rgb_t C_YELLOW = { .r = 255, .g = 255, .b = 0 };
+static const rgb_t C_DGREEN = { .r = 0,   .g = 100, .b = 0 };
+static const rgb_t C_BGREEN = { .r = 155, .g = 255, .b = 155 };
+
+esp_err_t fb_effect_fire_set_params(framebuffer_t *fb, fb_effect_fire_palette_t p)
+{
+    CHECK_ARG(fb && fb->internal);
+
+    params_t *params = (params_t *)fb->internal;
+    rgb_t palette[PALETTE_SIZE];
+    switch (p)
+    {
+        case FIRE_PALETTE_BLUE:
+            rgb_fill_gradient4_rgb(palette, PALETTE_SIZE, C_BLACK, C_DBLUE, C_CYAN, C_WHITE);
+            break;
+        case FIRE_PALETTE_GREEN:
+            rgb_fill_gradient4_rgb(palette, PALETTE_SIZE, C_BLACK, C_DGREEN, C_BGREEN, C_WHITE);
+            break;
+        default:
+            rgb_fill_gradient4_rgb(palette, PALETTE_SIZE, C_BLACK, C_RED, C_YELLOW, C_WHITE);
+    }
+    color_palette16_init(&params->palette, palette);
+
+    return ESP_OK;
+}
+
+// rows are independent, see fb_draw_rows()
+static esp_err_t draw_rows(framebuffer_t *fb, size_t y0, size_t y1)
+{
+    params_t *params = (params_t *)fb->internal;
+    uint8_t *n = params->noise + y0 * fb->width;
+    uint32_t a = params->time;
+
+    // Same values as inoise8_3d(x * 60, y * 60 + a, a / 3), whole rows at once
+    memset(n, 0, (y1 - y0) * fb->width);
+    fill_noise8_2d(n, fb->width, y1 - y0, 1, 0, 60, a + y0 * 60, 60, a / 3);
+
+    for (size_t y = y0; y < y1; y++)
+    {
+        uint8_t fade = abs8(y - (fb->height - 1)) * 255 / (fb->height - 1);
+        for (size_t x = 0; x < fb->width; x++)
+            *fb_pixel_unchecked(fb, x, fb->height - y - 1) = color_palette16_get(&params->palette, qsub8(*n++, fade));
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fb_effect_fire_run(framebuffer_t *fb)
+{
+    CHECK(fb_begin(fb));
+
+    params_t *params = (params_t *)fb->internal;
+    params->time = esp_timer_get_time() / 1000;
+
+    esp_err_t res = fb_draw_rows(fb, draw_rows);
+    fb_end(fb);
+
+    return res;
+}
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t)) + FB_EFFECTS_ALIGN(fb->width * fb->height);
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_fire_init(fx, random8_to(3));
+}
+
+const fb_effect_t fb_effect_fire = {
+    .name = "fire",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_fire_run,
+};
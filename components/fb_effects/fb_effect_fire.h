@@ -0,0 +1,42 @@
+/**
+ * @file fb_effect_fire.h
+ *
+ * @defgroup fb_effect_fire fb_effect_fire
+ * @{
+ *
+ * Fire effect based on Perlin noise
+ *
+ * Author: Yaroslaw Turbin (https://vk.com/ldirko, https://www.reddit.com/user/ldirko/)
+ *
+ * https://pastebin.com/jSSVSRi6
+ */
+#ifndef __FB_EFFECT_FIRE_H__
+#define __FB_EFFECT_FIRE_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    FIRE_PALETTE_FIRE = 0,
+    FIRE_PALETTE_BLUE,
+    FIRE_PALETTE_GREEN
+} fb_effect_fire_palette_t;
+
+esp_err_t fb_effect_fire_init(fb_effects_t *fx, fb_effect_fire_palette_t p);
+
+esp_err_t fb_effect_fire_set_params(framebuffer_t *fb, fb_effect_fire_palette_t p);
+
+esp_err_t fb_effect_fire_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_fire;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_FIRE_H__ */
@@ -1,5 +1,5 @@
 /**
- * @file matrix.c
+ * @file fb_effect_matrix.c
  *
  * Matrix effect
  *
@@ -7,7 +7,7 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/matrix.h"
+#include "fb_effect_matrix.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -17,30 +17,18 @@ typedef struct
     uint8_t density;
 } params_t;
 
-esp_err_t led_effect_matrix_init(framebuffer_t *fb, uint8_t density)
+esp_err_t fb_effect_matrix_init(fb_effects_t *fx, uint8_t density)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    // allocate internal storage
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_matrix_set_params(fb, density);
+    return fb_effect_matrix_set_params(fb, density);
 }
 
-esp_err_t led_effect_matrix_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb && fb->internal);
-
-    // free internal storage
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_matrix_set_params(framebuffer_t *fb, uint8_t density)
+esp_err_t fb_effect_matrix_set_params(framebuffer_t *fb, uint8_t density)
 {
     CHECK_ARG(fb && fb->internal);
 
@@ -57,7 +45,7 @@ esp_err_t led_effect_matrix_set_params(framebuffer_t *fb, uint8_t density)
 #define MATRIX_OFF_THRESH    0x030000
 #define MATRIX_DIMMEST_COLOR 0x020300
 
-esp_err_t led_effect_matrix_run(framebuffer_t *fb)
+esp_err_t fb_effect_matrix_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -128,3 +116,20 @@ esp_err_t led_effect_matrix_run(framebuffer_t *fb)
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_matrix_init(fx, random8_between(10, 250));
+}
+
+const fb_effect_t fb_effect_matrix = {
+    .name = "matrix",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_matrix_run,
+};
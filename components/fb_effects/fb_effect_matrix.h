@@ -0,0 +1,33 @@
+/**
+ * @file fb_effect_matrix.h
+ *
+ * @defgroup fb_effect_matrix fb_effect_matrix
+ * @{
+ *
+ * Matrix effect
+ *
+ */
+#ifndef __FB_EFFECT_MATRIX_H__
+#define __FB_EFFECT_MATRIX_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t fb_effect_matrix_init(fb_effects_t *fx, uint8_t density);
+
+esp_err_t fb_effect_matrix_set_params(framebuffer_t *fb, uint8_t density);
+
+esp_err_t fb_effect_matrix_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_matrix;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_MATRIX_H__ */
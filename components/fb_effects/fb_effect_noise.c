@@ -0,0 +1,104 @@
+/**
+ * @file fb_effect_noise.c
+ *
+ * Perlin noise effect
+ *
+ * Author: Chuck Sommerville
+ */
+#include <lib8tion.h>
+#include <noise.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fb_effect_noise.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+typedef struct
+{
+    uint8_t scale;
+    uint8_t speed;
+    uint16_t z_pos;
+    uint16_t x_offs;
+    uint8_t hue;
+    uint8_t *noise;
+} params_t;
+
+esp_err_t fb_effect_noise_init(fb_effects_t *fx, uint8_t scale, uint8_t speed)
+{
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
+
+    params_t *params = fb_effects_alloc_state(fx, sizeof(params_t));
+    if (!params)
+        return ESP_ERR_NO_MEM;
+    params->noise = fb_effects_alloc(fx, fb->width * fb->height);
+    if (!params->noise)
+        return ESP_ERR_NO_MEM;
+
+    return fb_effect_noise_set_params(fb, scale, speed);
+}
+
+esp_err_t fb_effect_noise_set_params(framebuffer_t *fb, uint8_t scale, uint8_t speed)
+{
+    CHECK_ARG(fb && fb->internal);
+
+    params_t *params = (params_t *)fb->internal;
+    params->scale = scale;
+    params->speed = speed;
+
+    return ESP_OK;
+}
+
+// rows are independent, see fb_draw_rows()
+static esp_err_t draw_rows(framebuffer_t *fb, size_t y0, size_t y1)
+{
+    params_t *params = (params_t *)fb->internal;
+    uint8_t *n = params->noise + y0 * fb->width;
+
+    // Same values as inoise8_3d(x * scale, y * scale, z_pos), whole rows at once
+    memset(n, 0, (y1 - y0) * fb->width);
+    fill_noise8_2d(n, fb->width, y1 - y0, 1, 0, params->scale, y0 * params->scale, params->scale, params->z_pos);
+
+    for (size_t y = y0; y < y1; y++)
+        for (size_t x = 0; x < fb->width; x++)
+            *fb_pixel_unchecked(fb, x, y) = hsv2rgb_rainbow(hsv_from_values(params->hue + *n++, 255, 255));
+
+    return ESP_OK;
+}
+
+esp_err_t fb_effect_noise_run(framebuffer_t *fb)
+{
+    CHECK(fb_begin(fb));
+
+    params_t *params = (params_t *)fb->internal;
+
+    if (!(fb->frame_num % 30))
+        params->x_offs++;
+
+    params->z_pos += params->speed;
+    params->hue++;
+
+    esp_err_t res = fb_draw_rows(fb, draw_rows);
+    fb_end(fb);
+
+    return res;
+}
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t)) + FB_EFFECTS_ALIGN(fb->width * fb->height);
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_noise_init(fx, random8_between(10, 100), random8_between(1, 50));
+}
+
+const fb_effect_t fb_effect_noise = {
+    .name = "noise",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_noise_run,
+};
@@ -0,0 +1,34 @@
+/**
+ * @file fb_effect_noise.h
+ *
+ * @defgroup fb_effect_noise fb_effect_noise
+ * @{
+ *
+ * Perlin noise effect
+ *
+ * Author: Chuck Sommerville
+ */
+#ifndef __FB_EFFECT_NOISE_H__
+#define __FB_EFFECT_NOISE_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t fb_effect_noise_init(fb_effects_t *fx, uint8_t scale, uint8_t speed);
+
+esp_err_t fb_effect_noise_set_params(framebuffer_t *fb, uint8_t scale, uint8_t speed);
+
+esp_err_t fb_effect_noise_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_noise;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_NOISE_H__ */
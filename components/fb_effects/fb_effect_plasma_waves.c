@@ -1,12 +1,12 @@
 /**
- * @file plasma_waves.c
+ * @file fb_effect_plasma_waves.c
  *
  * Plasma waves effect.
  * Author: Edmund "Skorn" Horn
  */
 #include <lib8tion.h>
 #include <stdlib.h>
-#include "effects/plasma_waves.h"
+#include "fb_effect_plasma_waves.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -35,30 +35,21 @@ static const uint8_t exp_gamma[256] = {
 typedef struct
 {
     uint8_t speed;
+    uint8_t t1, t2, t3;
 } params_t;
 
-esp_err_t led_effect_plasma_waves_init(framebuffer_t *fb, uint8_t speed)
+esp_err_t fb_effect_plasma_waves_init(fb_effects_t *fx, uint8_t speed)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_plasma_waves_set_params(fb, speed);
+    return fb_effect_plasma_waves_set_params(fb, speed);
 }
 
-esp_err_t led_effect_plasma_waves_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb);
-
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_plasma_waves_set_params(framebuffer_t *fb, uint8_t speed)
+esp_err_t fb_effect_plasma_waves_set_params(framebuffer_t *fb, uint8_t speed)
 {
     CHECK_ARG(fb && fb->internal);
 
@@ -69,17 +60,15 @@ esp_err_t led_effect_plasma_waves_set_params(framebuffer_t *fb, uint8_t speed)
     return ESP_OK;
 }
 
-esp_err_t led_effect_plasma_waves_run(framebuffer_t *fb)
+// rows are independent, see fb_draw_rows()
+static esp_err_t draw_rows(framebuffer_t *fb, size_t y0, size_t y1)
 {
-    CHECK(fb_begin(fb));
-
     params_t *params = (params_t *)fb->internal;
+    uint8_t t1 = params->t1;
+    uint8_t t2 = params->t2;
+    uint8_t t3 = params->t3;
 
-    uint8_t t1 = cos8((42 * fb->frame_num) / params->speed);
-    uint8_t t2 = cos8((35 * fb->frame_num) / params->speed);
-    uint8_t t3 = cos8((38 * fb->frame_num) / params->speed);
-
-    for (uint16_t y = 0; y < fb->height; y++)
+    for (uint16_t y = y0; y < y1; y++)
     {
         for (uint16_t x = 0; x < fb->width; x++)
         {
@@ -93,9 +82,42 @@ esp_err_t led_effect_plasma_waves_run(framebuffer_t *fb)
                 .g = exp_gamma[g],
                 .b = exp_gamma[b]
             };
-            fb_set_pixel_rgb(fb, x, y, c);
+            *fb_pixel_unchecked(fb, x, y) = c;
         }
     }
 
-    return fb_end(fb);
+    return ESP_OK;
 }
+
+esp_err_t fb_effect_plasma_waves_run(framebuffer_t *fb)
+{
+    CHECK(fb_begin(fb));
+
+    params_t *params = (params_t *)fb->internal;
+
+    params->t1 = cos8((42 * fb->frame_num) / params->speed);
+    params->t2 = cos8((35 * fb->frame_num) / params->speed);
+    params->t3 = cos8((38 * fb->frame_num) / params->speed);
+
+    esp_err_t res = fb_draw_rows(fb, draw_rows);
+    fb_end(fb);
+
+    return res;
+}
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_plasma_waves_init(fx, random8_between(50, 255));
+}
+
+const fb_effect_t fb_effect_plasma_waves = {
+    .name = "plasma_waves",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_plasma_waves_run,
+};
@@ -0,0 +1,34 @@
+/**
+ * @file fb_effect_plasma_waves.h
+ *
+ * @defgroup fb_effect_plasma_waves fb_effect_plasma_waves
+ * @{
+ *
+ * Plasma waves effect
+ *
+ * Author: Edmund "Skorn" Horn
+ */
+#ifndef __FB_EFFECT_PLASMA_WAVES_H__
+#define __FB_EFFECT_PLASMA_WAVES_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t fb_effect_plasma_waves_init(fb_effects_t *fx, uint8_t speed);
+
+esp_err_t fb_effect_plasma_waves_set_params(framebuffer_t *fb, uint8_t speed);
+
+esp_err_t fb_effect_plasma_waves_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_plasma_waves;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_PLASMA_WAVES_H__ */
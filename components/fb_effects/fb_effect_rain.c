@@ -1,5 +1,5 @@
 /**
- * @file rain.c
+ * @file fb_effect_rain.c
  *
  * Rain effect by Shaitan
  *
@@ -7,43 +7,31 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/rain.h"
+#include "fb_effect_rain.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
 typedef struct
 {
-    led_effect_rain_mode_t mode;
+    fb_effect_rain_mode_t mode;
     uint8_t hue;
     uint8_t density;
     uint8_t tail;
 } params_t;
 
-esp_err_t led_effect_rain_init(framebuffer_t *fb, led_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail)
+esp_err_t fb_effect_rain_init(fb_effects_t *fx, fb_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    // allocate internal storage
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_rain_set_params(fb, mode, hue, density, tail);
+    return fb_effect_rain_set_params(fb, mode, hue, density, tail);
 }
 
-esp_err_t led_effect_rain_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb && fb->internal);
-
-    // free internal storage
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_rain_set_params(framebuffer_t *fb, led_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail)
+esp_err_t fb_effect_rain_set_params(framebuffer_t *fb, fb_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail)
 {
     CHECK_ARG(fb && fb->internal);
 
@@ -56,7 +44,7 @@ esp_err_t led_effect_rain_set_params(framebuffer_t *fb, led_effect_rain_mode_t m
     return ESP_OK;
 }
 
-esp_err_t led_effect_rain_run(framebuffer_t *fb)
+esp_err_t fb_effect_rain_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -79,3 +67,20 @@ esp_err_t led_effect_rain_run(framebuffer_t *fb)
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_rain_init(fx, random8_to(2), random8(), random8_to(100), random8_between(100, 200));
+}
+
+const fb_effect_t fb_effect_rain = {
+    .name = "rain",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_rain_run,
+};
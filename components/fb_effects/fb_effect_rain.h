@@ -0,0 +1,38 @@
+/**
+ * @file fb_effect_rain.h
+ *
+ * @defgroup fb_effect_rain fb_effect_rain
+ * @{
+ *
+ * Rain effect by Shaitan
+ *
+ */
+#ifndef __FB_EFFECT_RAIN_H__
+#define __FB_EFFECT_RAIN_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    RAIN_MODE_SINGLE_COLOR = 0,
+    RAIN_MODE_RAINBOW
+} fb_effect_rain_mode_t;
+
+esp_err_t fb_effect_rain_init(fb_effects_t *fx, fb_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail);
+
+esp_err_t fb_effect_rain_set_params(framebuffer_t *fb, fb_effect_rain_mode_t mode, uint8_t hue, uint8_t density, uint8_t tail);
+
+esp_err_t fb_effect_rain_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_rain;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_RAIN_H__ */
@@ -1,5 +1,5 @@
 /**
- * @file rainbow.c
+ * @file fb_effect_rainbow.c
  *
  * Simple rainbow effect
  *
@@ -11,41 +11,31 @@
 #include <noise.h>
 #include <stdlib.h>
 
-#include "effects/rainbow.h"
+#include "fb_effect_rainbow.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
 typedef struct
 {
-    led_effect_rainbow_direction_t direction;
+    fb_effect_rainbow_direction_t direction;
     uint8_t scale;
     uint8_t speed;
 } params_t;
 
-esp_err_t led_effect_rainbow_init(framebuffer_t *fb, led_effect_rainbow_direction_t direction,
+esp_err_t fb_effect_rainbow_init(fb_effects_t *fx, fb_effect_rainbow_direction_t direction,
         uint8_t scale, uint8_t speed)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_rainbow_set_params(fb, direction, scale, speed);
+    return fb_effect_rainbow_set_params(fb, direction, scale, speed);
 }
 
-esp_err_t led_effect_rainbow_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb);
-
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_rainbow_set_params(framebuffer_t *fb, led_effect_rainbow_direction_t direction,
+esp_err_t fb_effect_rainbow_set_params(framebuffer_t *fb, fb_effect_rainbow_direction_t direction,
         uint8_t scale, uint8_t speed)
 {
     CHECK_ARG(fb && fb->internal);
@@ -58,7 +48,7 @@ esp_err_t led_effect_rainbow_set_params(framebuffer_t *fb, led_effect_rainbow_di
     return ESP_OK;
 }
 
-esp_err_t led_effect_rainbow_run(framebuffer_t *fb)
+esp_err_t fb_effect_rainbow_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -90,13 +80,30 @@ esp_err_t led_effect_rainbow_run(framebuffer_t *fb)
                 .sat = 255,
                 .val = 255
             };
-            for (size_t j = 0; j < inner; j++)
-                if (params->direction == RAINBOW_HORIZONTAL)
-                    fb_set_pixel_hsv(fb, i, j, color);
-                else
-                    fb_set_pixel_hsv(fb, j, i, color);
+            // Whole line has the same color
+            if (params->direction == RAINBOW_HORIZONTAL)
+                fb_fill_rect(fb, i, 0, 1, inner, hsv2rgb_rainbow(color));
+            else
+                fb_fill_rect(fb, 0, i, inner, 1, hsv2rgb_rainbow(color));
         }
     }
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_rainbow_init(fx, random8_to(3), random8_between(10, 50), random8_between(1, 20));
+}
+
+const fb_effect_t fb_effect_rainbow = {
+    .name = "rainbow",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_rainbow_run,
+};
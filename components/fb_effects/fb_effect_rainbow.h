@@ -0,0 +1,44 @@
+/**
+ * @file fb_effect_rainbow.h
+ *
+ * @defgroup fb_effect_rainbow fb_effect_rainbow
+ * @{
+ *
+ * Simple rainbow effect
+ *
+ * Parameters:
+ *     - scale:  Density of rainbows. Suggested range 10-50.
+ *     - speed:  Speed with which the rainbow shimmers. Suggested range 1-50.
+ */
+#ifndef __FB_EFFECT_RAINBOW_H__
+#define __FB_EFFECT_RAINBOW_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    RAINBOW_HORIZONTAL = 0,
+    RAINBOW_VERTICAL,
+    RAINBOW_DIAGONAL,
+} fb_effect_rainbow_direction_t;
+
+esp_err_t fb_effect_rainbow_init(fb_effects_t *fx, fb_effect_rainbow_direction_t direction,
+        uint8_t scale, uint8_t speed);
+
+esp_err_t fb_effect_rainbow_set_params(framebuffer_t *fb, fb_effect_rainbow_direction_t direction,
+        uint8_t scale, uint8_t speed);
+
+esp_err_t fb_effect_rainbow_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_rainbow;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_RAINBOW_H__ */
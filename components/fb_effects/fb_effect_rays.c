@@ -1,5 +1,5 @@
 /**
- * @file rays.c
+ * @file fb_effect_rays.c
  *
  * Colored rays effect
  *
@@ -17,7 +17,7 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/rays.h"
+#include "fb_effect_rays.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -31,30 +31,18 @@ typedef struct
     uint8_t num_rays;
 } params_t;
 
-esp_err_t led_effect_rays_init(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays)
+esp_err_t fb_effect_rays_init(fb_effects_t *fx, uint8_t speed, uint8_t min_rays, uint8_t max_rays)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    // allocate internal storage
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    if (!fb_effects_alloc_state(fx, sizeof(params_t)))
         return ESP_ERR_NO_MEM;
 
-    return led_effect_rays_set_params(fb, speed, min_rays, max_rays);
+    return fb_effect_rays_set_params(fb, speed, min_rays, max_rays);
 }
 
-esp_err_t led_effect_rays_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb && fb->internal);
-
-    // free internal storage
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
-}
-
-esp_err_t led_effect_rays_set_params(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays)
+esp_err_t fb_effect_rays_set_params(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays)
 {
     CHECK_ARG(fb && fb->internal);
 
@@ -83,7 +71,7 @@ static void line(framebuffer_t *fb, uint8_t x1, uint8_t y1, uint8_t x2, uint8_t
     }
 }
 
-esp_err_t led_effect_rays_run(framebuffer_t *fb)
+esp_err_t fb_effect_rays_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -117,3 +105,20 @@ esp_err_t led_effect_rays_run(framebuffer_t *fb)
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t));
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    return fb_effect_rays_init(fx, random8_between(0, 50), random8_between(3, 5), random8_between(5, 10));
+}
+
+const fb_effect_t fb_effect_rays = {
+    .name = "rays",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_rays_run,
+};
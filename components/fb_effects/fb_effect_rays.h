@@ -1,5 +1,5 @@
 /**
- * @file rays.h
+ * @file fb_effect_rays.h
  *
  * Colored rays effect
  *
@@ -14,22 +14,22 @@
  *   - min_rays: Minimal rays count, 1 - 10
  *   - max_rays: Maximal rays count, 10 - 20
  */
-#ifndef __LED_EFFECTS_RAYS_H__
-#define __LED_EFFECTS_RAYS_H__
+#ifndef __FB_EFFECT_RAYS_H__
+#define __FB_EFFECT_RAYS_H__
 
-#include <framebuffer.h>
+#include <fb_effects.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-esp_err_t led_effect_rays_init(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays);
+esp_err_t fb_effect_rays_init(fb_effects_t *fx, uint8_t speed, uint8_t min_rays, uint8_t max_rays);
 
-esp_err_t led_effect_rays_done(framebuffer_t *fb);
+esp_err_t fb_effect_rays_set_params(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays);
 
-esp_err_t led_effect_rays_set_params(framebuffer_t *fb, uint8_t speed, uint8_t min_rays, uint8_t max_rays);
+esp_err_t fb_effect_rays_run(framebuffer_t *fb);
 
-esp_err_t led_effect_rays_run(framebuffer_t *fb);
+extern const fb_effect_t fb_effect_rays;
 
 #ifdef __cplusplus
 }
@@ -37,4 +37,4 @@ esp_err_t led_effect_rays_run(framebuffer_t *fb);
 
 /**@}*/
 
-#endif /* __LED_EFFECTS_RAYS_H__ */
+#endif /* __FB_EFFECT_RAYS_H__ */
@@ -0,0 +1,33 @@
+/**
+ * @file fb_effect_sparkles.h
+ *
+ * @defgroup fb_effect_sparkles fb_effect_sparkles
+ * @{
+ *
+ * Colored sparkles effect.
+ *
+ */
+#ifndef __FB_EFFECT_SPARKLES_H__
+#define __FB_EFFECT_SPARKLES_H__
+
+#include <fb_effects.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+esp_err_t fb_effect_sparkles_init(fb_effects_t *fx, uint8_t max_sparkles, uint8_t fadeout_speed);
+
+esp_err_t fb_effect_sparkles_set_params(framebuffer_t *fb, uint8_t max_sparkles, uint8_t fadeout_speed);
+
+esp_err_t fb_effect_sparkles_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_sparkles;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECT_SPARKLES_H__ */
@@ -1,5 +1,5 @@
 /**
- * @file waterfall.c
+ * @file fb_effect_waterfall.c
  *
  * Waterfall/Fire effect
  *
@@ -14,7 +14,7 @@
 #include <lib8tion.h>
 #include <stdlib.h>
 
-#include "effects/waterfall.h"
+#include "fb_effect_waterfall.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
@@ -23,50 +23,33 @@
 
 typedef struct
 {
-    led_effect_waterfall_mode_t mode;
+    fb_effect_waterfall_mode_t mode;
     uint8_t hue;
     uint8_t cooling;
     uint8_t sparking;
-    rgb_t palette[PALETTE_SIZE];
+    color_palette16_t palette;
     uint8_t *map;
 } params_t;
 
-esp_err_t led_effect_waterfall_init(framebuffer_t *fb, led_effect_waterfall_mode_t mode,
+esp_err_t fb_effect_waterfall_init(fb_effects_t *fx, fb_effect_waterfall_mode_t mode,
         uint8_t hue, uint8_t cooling, uint8_t sparking)
 {
-    CHECK_ARG(fb);
+    CHECK_ARG(fx && fx->fb);
+    framebuffer_t *fb = fx->fb;
 
-    // allocate internal storage
-    fb->internal = calloc(1, sizeof(params_t));
-    if (!fb->internal)
+    params_t *params = fb_effects_alloc_state(fx, sizeof(params_t));
+    if (!params)
         return ESP_ERR_NO_MEM;
 
-    // allocate color map
-    params_t *params = (params_t *)fb->internal;
-    params->map = calloc(fb->width * fb->height, 1);
+    // heat map
+    params->map = fb_effects_alloc(fx, fb->width * fb->height);
     if (!params->map)
         return ESP_ERR_NO_MEM;
 
-    return led_effect_waterfall_set_params(fb, mode, hue, cooling, sparking);
-}
-
-esp_err_t led_effect_waterfall_done(framebuffer_t *fb)
-{
-    CHECK_ARG(fb);
-    params_t *params = (params_t *)fb->internal;
-
-    // free map
-    if (params && params->map)
-        free(params->map);
-
-    // free internal storage
-    if (fb->internal)
-        free(fb->internal);
-
-    return ESP_OK;
+    return fb_effect_waterfall_set_params(fb, mode, hue, cooling, sparking);
 }
 
-esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfall_mode_t mode,
+esp_err_t fb_effect_waterfall_set_params(framebuffer_t *fb, fb_effect_waterfall_mode_t mode,
         uint8_t hue, uint8_t cooling, uint8_t sparking)
 {
     CHECK_ARG(fb && fb->internal);
@@ -76,10 +59,11 @@ esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfal
     params->hue = hue;
     params->cooling = cooling;
     params->sparking = sparking;
+    rgb_t palette[PALETTE_SIZE];
     switch (mode)
     {
         case WATERFALL_SIMPLE:
-            rgb_fill_gradient4_hsv(params->palette, PALETTE_SIZE,
+            rgb_fill_gradient4_hsv(palette, PALETTE_SIZE,
                     hsv_from_values(0, 0, 0),
                     hsv_from_values(hue, 0, 255),
                     hsv_from_values(hue, 128, 255),
@@ -87,7 +71,7 @@ esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfal
                     COLOR_SHORTEST_HUES);
             break;
         case WATERFALL_COLORS:
-            rgb_fill_gradient4_hsv(params->palette, PALETTE_SIZE,
+            rgb_fill_gradient4_hsv(palette, PALETTE_SIZE,
                     hsv_from_values(0, 0, 0),
                     hsv_from_values(hue, 0, 255),
                     hsv_from_values(hue, 128, 255),
@@ -95,14 +79,14 @@ esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfal
                     COLOR_SHORTEST_HUES);
             break;
         case WATERFALL_FIRE:
-            rgb_fill_gradient4_rgb(params->palette, PALETTE_SIZE,
+            rgb_fill_gradient4_rgb(palette, PALETTE_SIZE,
                     rgb_from_values(0, 0, 0),       // black
                     rgb_from_values(255, 0, 0),
                     rgb_from_values(255, 255, 0),
                     rgb_from_values(255, 255, 255)); // white
             break;
         case WATERFALL_COLD_FIRE:
-            rgb_fill_gradient4_rgb(params->palette, PALETTE_SIZE,
+            rgb_fill_gradient4_rgb(palette, PALETTE_SIZE,
                     rgb_from_values(0, 0, 0),       // black
                     rgb_from_values(0, 0, 100),
                     rgb_from_values(0, 200, 255),
@@ -111,13 +95,14 @@ esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfal
         default:
             return ESP_ERR_NOT_SUPPORTED;
     }
+    color_palette16_init(&params->palette, palette);
 
     return ESP_OK;
 }
 
 #define MAP_XY(x, y) ((y) * fb->width + (x))
 
-esp_err_t led_effect_waterfall_run(framebuffer_t *fb)
+esp_err_t fb_effect_waterfall_run(framebuffer_t *fb)
 {
     CHECK(fb_begin(fb));
 
@@ -144,16 +129,35 @@ esp_err_t led_effect_waterfall_run(framebuffer_t *fb)
         }
 
         // Step 4.  Map from heat cells to LED colors
+        bool is_fire = (params->mode == WATERFALL_FIRE || params->mode == WATERFALL_COLD_FIRE);
         for (y = 0; y < fb->height; y++)
         {
             // Scale the heat value from 0-255 down to 0-240
             // for best results with color palettes.
             uint8_t color_idx = scale8(params->map[MAP_XY(x, y)], 240);
-            bool is_fire = (params->mode == WATERFALL_FIRE || params->mode == WATERFALL_COLD_FIRE);
-            fb_set_pixel_rgb(fb, x, is_fire ? y : fb->height - 1 - y,
-                    color_from_palette_rgb(params->palette, PALETTE_SIZE, color_idx, 255, true));
+            *fb_pixel_unchecked(fb, x, is_fire ? y : fb->height - 1 - y) = color_palette16_get(&params->palette, color_idx);
         }
     }
+    fb_mark_dirty_unchecked(fb, 0, 0, fb->width - 1, fb->height - 1);
 
     return fb_end(fb);
 }
+
+static size_t state_size(const framebuffer_t *fb)
+{
+    return FB_EFFECTS_ALIGN(sizeof(params_t)) + FB_EFFECTS_ALIGN(fb->width * fb->height);
+}
+
+static esp_err_t init_random(fb_effects_t *fx)
+{
+    fb_effect_waterfall_mode_t mode = random8_to(4);
+    uint8_t hue = mode == WATERFALL_FIRE || mode == WATERFALL_COLD_FIRE ? 0 : random8_between(1, 255);
+    return fb_effect_waterfall_init(fx, mode, hue, random8_between(20, 120), random8_between(50, 200));
+}
+
+const fb_effect_t fb_effect_waterfall = {
+    .name = "waterfall",
+    .state_size = state_size,
+    .init = init_random,
+    .run = fb_effect_waterfall_run,
+};
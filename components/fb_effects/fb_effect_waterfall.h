@@ -1,7 +1,7 @@
 /**
- * @file waterfall.h
+ * @file fb_effect_waterfall.h
  *
- * @defgroup led_effect_waterfall led_effect_waterfall
+ * @defgroup fb_effect_waterfall fb_effect_waterfall
  * @{
  *
  * Waterfall/Fire effect
@@ -14,10 +14,10 @@
  *
  * Recommended parameters for fire mode: cooling = 90, sparking = 80
  */
-#ifndef __LED_EFFECTS_WATERFALL_H__
-#define __LED_EFFECTS_WATERFALL_H__
+#ifndef __FB_EFFECT_WATERFALL_H__
+#define __FB_EFFECT_WATERFALL_H__
 
-#include <framebuffer.h>
+#include <fb_effects.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,17 +28,17 @@ typedef enum {
     WATERFALL_COLORS,
     WATERFALL_FIRE,
     WATERFALL_COLD_FIRE,
-} led_effect_waterfall_mode_t;
+} fb_effect_waterfall_mode_t;
 
-esp_err_t led_effect_waterfall_init(framebuffer_t *fb, led_effect_waterfall_mode_t mode,
+esp_err_t fb_effect_waterfall_init(fb_effects_t *fx, fb_effect_waterfall_mode_t mode,
         uint8_t hue, uint8_t cooling, uint8_t sparking);
 
-esp_err_t led_effect_waterfall_done(framebuffer_t *fb);
-
-esp_err_t led_effect_waterfall_set_params(framebuffer_t *fb, led_effect_waterfall_mode_t mode,
+esp_err_t fb_effect_waterfall_set_params(framebuffer_t *fb, fb_effect_waterfall_mode_t mode,
         uint8_t hue, uint8_t cooling, uint8_t sparking);
 
-esp_err_t led_effect_waterfall_run(framebuffer_t *fb);
+esp_err_t fb_effect_waterfall_run(framebuffer_t *fb);
+
+extern const fb_effect_t fb_effect_waterfall;
 
 #ifdef __cplusplus
 }
@@ -46,4 +46,4 @@ esp_err_t led_effect_waterfall_run(framebuffer_t *fb);
 
 /**@}*/
 
-#endif /* __LED_EFFECTS_WATERFALL_H__ */
+#endif /* __FB_EFFECT_WATERFALL_H__ */
@@ -0,0 +1,205 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fb_effects.c
+ *
+ * Library of framebuffer effects with registry and preallocated state
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#include "fb_effects.h"
+#include "fb_effect_crazybees.h"
+#include "fb_effect_dna.h"
+#include "fb_effect_fire.h"
+#include "fb_effect_matrix.h"
+#include "fb_effect_noise.h"
+#include "fb_effect_plasma_waves.h"
+#include "fb_effect_rain.h"
+#include "fb_effect_rainbow.h"
+#include "fb_effect_rays.h"
+#include "fb_effect_sparkles.h"
+#include "fb_effect_waterfall.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "fb_effects";
+
+// Effects which are not listed here are dropped by linker
+static const fb_effect_t *const registry[] = {
+#ifdef CONFIG_FB_EFFECTS_CRAZYBEES
+    &fb_effect_crazybees,
+#endif
+#ifdef CONFIG_FB_EFFECTS_DNA
+    &fb_effect_dna,
+#endif
+#ifdef CONFIG_FB_EFFECTS_FIRE
+    &fb_effect_fire,
+#endif
+#ifdef CONFIG_FB_EFFECTS_MATRIX
+    &fb_effect_matrix,
+#endif
+#ifdef CONFIG_FB_EFFECTS_NOISE
+    &fb_effect_noise,
+#endif
+#ifdef CONFIG_FB_EFFECTS_PLASMA_WAVES
+    &fb_effect_plasma_waves,
+#endif
+#ifdef CONFIG_FB_EFFECTS_RAIN
+    &fb_effect_rain,
+#endif
+#ifdef CONFIG_FB_EFFECTS_RAINBOW
+    &fb_effect_rainbow,
+#endif
+#ifdef CONFIG_FB_EFFECTS_RAYS
+    &fb_effect_rays,
+#endif
+#ifdef CONFIG_FB_EFFECTS_SPARKLES
+    &fb_effect_sparkles,
+#endif
+#ifdef CONFIG_FB_EFFECTS_WATERFALL
+    &fb_effect_waterfall,
+#endif
+    NULL
+};
+
+#define REGISTRY_SIZE (sizeof(registry) / sizeof(registry[0]) - 1)
+
+esp_err_t fb_effects_init(fb_effects_t *fx, framebuffer_t *fb, size_t arena_size)
+{
+    CHECK_ARG(fx && fb);
+
+    if (!arena_size)
+        for (size_t i = 0; i < REGISTRY_SIZE; i++)
+        {
+            size_t size = registry[i]->state_size(fb);
+            if (size > arena_size)
+                arena_size = size;
+        }
+
+    memset(fx, 0, sizeof(fb_effects_t));
+    fx->fb = fb;
+    if (arena_size)
+    {
+        fx->arena = malloc(arena_size);
+        if (!fx->arena)
+        {
+            ESP_LOGE(TAG, "Could not allocate %u bytes for effects state", (unsigned)arena_size);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    fx->arena_size = arena_size;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_effects_free(fb_effects_t *fx)
+{
+    CHECK_ARG(fx);
+
+    if (fx->fb && fx->fb->internal == fx->arena)
+        fx->fb->internal = NULL;
+    if (fx->arena)
+        free(fx->arena);
+    fx->arena = NULL;
+    fx->arena_size = 0;
+    fx->arena_used = 0;
+    fx->current = NULL;
+
+    return ESP_OK;
+}
+
+size_t fb_effects_count()
+{
+    return REGISTRY_SIZE;
+}
+
+const fb_effect_t *fb_effects_get(size_t idx)
+{
+    return idx < REGISTRY_SIZE ? registry[idx] : NULL;
+}
+
+const fb_effect_t *fb_effects_find(const char *name)
+{
+    if (!name)
+        return NULL;
+
+    for (size_t i = 0; i < REGISTRY_SIZE; i++)
+        if (!strcmp(registry[i]->name, name))
+            return registry[i];
+
+    return NULL;
+}
+
+esp_err_t fb_effects_switch(fb_effects_t *fx, const fb_effect_t *effect)
+{
+    CHECK_ARG(fx && fx->fb && effect && effect->init && effect->run);
+
+    fx->current = NULL;
+    fx->arena_used = 0;
+    fx->fb->internal = NULL;
+    fb_clear(fx->fb);
+
+    esp_err_t res = effect->init(fx);
+    if (res != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not init effect %s: %d (%s)", effect->name, res, esp_err_to_name(res));
+        fx->fb->internal = NULL;
+        return res;
+    }
+    fx->current = effect;
+
+    return ESP_OK;
+}
+
+void *fb_effects_alloc_state(fb_effects_t *fx, size_t size)
+{
+    if (!fx || !fx->fb)
+        return NULL;
+
+    fx->arena_used = 0;
+    fx->fb->internal = fb_effects_alloc(fx, size);
+
+    return fx->fb->internal;
+}
+
+void *fb_effects_alloc(fb_effects_t *fx, size_t size)
+{
+    if (!fx || !fx->arena)
+        return NULL;
+
+    size = FB_EFFECTS_ALIGN(size);
+    if (size > fx->arena_size - fx->arena_used)
+        return NULL;
+
+    void *res = fx->arena + fx->arena_used;
+    fx->arena_used += size;
+    memset(res, 0, size);
+
+    return res;
+}
@@ -0,0 +1,170 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fb_effects.h
+ * @defgroup fb_effects fb_effects
+ * @{
+ *
+ * Library of framebuffer effects with registry and preallocated state
+ *
+ * Every effect is described by ::fb_effect_t and keeps its state in
+ * the arena of ::fb_effects_t, which is allocated once by ::fb_effects_init().
+ * Switching effects does not allocate memory on the heap.
+ *
+ * Effects (fb_effect_*.c, fb_effect_*.h) are moved from the led_effects
+ * example with their original headers and author notes, the license below
+ * covers the registry (fb_effects.c, fb_effects.h).
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FB_EFFECTS_H__
+#define __FB_EFFECTS_H__
+
+#include <framebuffer.h>
+#include <fbanimation.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Round size up to the arena alignment
+ */
+#define FB_EFFECTS_ALIGN(size) (((size) + 3) & ~3)
+
+typedef struct fb_effects_s fb_effects_t;
+
+/**
+ * Effect descriptor
+ */
+typedef struct
+{
+    const char *name;                                  ///< Effect name
+    size_t (*state_size)(const framebuffer_t *fb);     ///< Arena bytes needed by effect for this framebuffer
+    esp_err_t (*init)(fb_effects_t *fx);               ///< Init effect with random parameters
+    fb_draw_cb_t run;                                  ///< Draw function, see ::fb_animation_play()
+} fb_effect_t;
+
+/**
+ * Effects context
+ */
+struct fb_effects_s
+{
+    framebuffer_t *fb;          ///< Framebuffer descriptor
+    uint8_t *arena;             ///< State arena
+    size_t arena_size;          ///< Size of arena, bytes
+    size_t arena_used;          ///< Used bytes of arena
+    const fb_effect_t *current; ///< Current effect, NULL if none
+};
+
+/**
+ * @brief Init effects context
+ *
+ * Allocates state arena for the effects.
+ *
+ * @param fx Effects context
+ * @param fb Framebuffer descriptor
+ * @param arena_size Arena size in bytes. If 0, size will be the maximal
+ *                   state size of registered effects for this framebuffer
+ * @return `ESP_OK` on success
+ */
+esp_err_t fb_effects_init(fb_effects_t *fx, framebuffer_t *fb, size_t arena_size);
+
+/**
+ * @brief Free effects context
+ *
+ * @param fx Effects context
+ * @return `ESP_OK` on success
+ */
+esp_err_t fb_effects_free(fb_effects_t *fx);
+
+/**
+ * @brief Get number of registered effects
+ *
+ * Only effects selected in menuconfig are registered.
+ *
+ * @return Number of effects
+ */
+size_t fb_effects_count();
+
+/**
+ * @brief Get registered effect by index
+ *
+ * @param idx Index of effect, 0..fb_effects_count() - 1
+ * @return Effect descriptor or NULL if index is out of range
+ */
+const fb_effect_t *fb_effects_get(size_t idx);
+
+/**
+ * @brief Find registered effect by name
+ *
+ * @param name Effect name
+ * @return Effect descriptor or NULL if not found
+ */
+const fb_effect_t *fb_effects_find(const char *name);
+
+/**
+ * @brief Switch to effect
+ *
+ * Resets the arena, clears framebuffer and inits effect with random
+ * parameters. Animation must be stopped during the switch.
+ *
+ * @param fx Effects context
+ * @param effect Effect descriptor
+ * @return `ESP_OK` on success, `ESP_ERR_NO_MEM` if arena is too small for effect
+ */
+esp_err_t fb_effects_switch(fb_effects_t *fx, const fb_effect_t *effect);
+
+/**
+ * @brief Allocate main state of effect
+ *
+ * Resets the arena, allocates zeroed block and sets it as
+ * `internal` buffer of the framebuffer. Used by effects init functions.
+ *
+ * @param fx Effects context
+ * @param size Size of state, bytes
+ * @return Pointer to state or NULL if arena is too small
+ */
+void *fb_effects_alloc_state(fb_effects_t *fx, size_t size);
+
+/**
+ * @brief Allocate additional zeroed block in the arena
+ *
+ * Must be called after ::fb_effects_alloc_state().
+ *
+ * @param fx Effects context
+ * @param size Size of block, bytes
+ * @return Pointer to block or NULL if arena is too small
+ */
+void *fb_effects_alloc(fb_effects_t *fx, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_EFFECTS_H__ */
@@ -0,0 +1,316 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fb_player.c
+ *
+ * Playback of compressed frame sequences from flash partition or file
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#include "fb_player.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+#define CHECK(x) do { esp_err_t __; if ((__ = (x)) != ESP_OK) return __; } while (0)
+
+#define OP_MASK 0xc0
+#define COUNT_MASK 0x3f
+#define COUNT_EXT 64
+
+static const char *TAG = "fb_player";
+
+static inline uint16_t le16(const uint8_t *b)
+{
+    return b[0] | (b[1] << 8);
+}
+
+static esp_err_t refill(fb_player_t *p)
+{
+    p->buf_len = p->read(p->read_ctx, p->offs, p->buf, sizeof(p->buf));
+    p->offs += p->buf_len;
+    p->buf_pos = 0;
+
+    return p->buf_len ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+static inline esp_err_t get_byte(fb_player_t *p, uint8_t *b)
+{
+    if (p->buf_pos == p->buf_len)
+        CHECK(refill(p));
+    *b = p->buf[p->buf_pos++];
+
+    return ESP_OK;
+}
+
+static esp_err_t get_bytes(fb_player_t *p, void *dst, size_t len)
+{
+    uint8_t *d = (uint8_t *)dst;
+    while (len)
+    {
+        if (p->buf_pos == p->buf_len)
+        {
+            // long literals bypass read buffer
+            if (len >= sizeof(p->buf))
+            {
+                size_t n = p->read(p->read_ctx, p->offs, d, len);
+                p->offs += n;
+                return n == len ? ESP_OK : ESP_ERR_INVALID_SIZE;
+            }
+            CHECK(refill(p));
+        }
+        size_t n = p->buf_len - p->buf_pos;
+        if (n > len)
+            n = len;
+        memcpy(d, p->buf + p->buf_pos, n);
+        p->buf_pos += n;
+        d += n;
+        len -= n;
+    }
+
+    return ESP_OK;
+}
+
+static inline esp_err_t get_pixel(fb_player_t *p, rgb_t *c)
+{
+    if (!p->indexed)
+        return get_bytes(p, c, sizeof(rgb_t));
+
+    uint8_t i;
+    CHECK(get_byte(p, &i));
+    *c = p->palette[i];
+
+    return ESP_OK;
+}
+
+static size_t read_partition(void *ctx, size_t offset, void *dst, size_t len)
+{
+    fb_player_t *p = (fb_player_t *)ctx;
+
+    if (offset >= p->partition->size)
+        return 0;
+    if (len > p->partition->size - offset)
+        len = p->partition->size - offset;
+
+    return esp_partition_read(p->partition, offset, dst, len) == ESP_OK ? len : 0;
+}
+
+static size_t read_file(void *ctx, size_t offset, void *dst, size_t len)
+{
+    fb_player_t *p = (fb_player_t *)ctx;
+
+    // reads are sequential except for rewinding
+    if (p->file_pos != offset)
+    {
+        if (fseek(p->file, offset, SEEK_SET))
+            return 0;
+        p->file_pos = offset;
+    }
+    size_t n = fread(dst, 1, len, p->file);
+    p->file_pos += n;
+
+    return n;
+}
+
+esp_err_t fb_player_init(fb_player_t *player, framebuffer_t *fb, fb_player_read_cb_t read, void *ctx, size_t offset)
+{
+    CHECK_ARG(player && fb && fb->data && read);
+
+    // keep source of fb_player_init_partition() and fb_player_init_file()
+    const esp_partition_t *partition = player->partition;
+    FILE *file = player->file;
+    memset(player, 0, sizeof(fb_player_t));
+    player->partition = partition;
+    player->file = file;
+    player->fb = fb;
+    player->read = read;
+    player->read_ctx = ctx;
+    player->base = offset;
+
+    uint8_t h[FB_CLIP_HEADER_SIZE];
+    if (read(ctx, offset, h, sizeof(h)) != sizeof(h) || memcmp(h, FB_CLIP_MAGIC, 4) || h[4] != FB_CLIP_VERSION)
+    {
+        ESP_LOGE(TAG, "Invalid clip header");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    player->indexed = h[5] & FB_CLIP_INDEXED;
+    player->width = le16(h + 6);
+    player->height = le16(h + 8);
+    player->frames = le16(h + 10);
+    player->fps = h[12];
+    if (player->width != fb->width || player->height != fb->height || !player->frames)
+    {
+        ESP_LOGE(TAG, "Clip %dx%d doesn't fit framebuffer %dx%d", (int)player->width, (int)player->height,
+                (int)fb->width, (int)fb->height);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    player->first_frame = FB_CLIP_HEADER_SIZE;
+    if (player->indexed)
+    {
+        player->palette = malloc(FB_CLIP_PALETTE_SIZE * sizeof(rgb_t));
+        if (!player->palette)
+            return ESP_ERR_NO_MEM;
+        size_t size = FB_CLIP_PALETTE_SIZE * sizeof(rgb_t);
+        if (read(ctx, offset + FB_CLIP_HEADER_SIZE, player->palette, size) != size)
+        {
+            fb_player_free(player);
+            return ESP_ERR_INVALID_SIZE;
+        }
+        player->first_frame += size;
+    }
+    player->loop = true;
+    fb->internal = (uint8_t *)player;
+
+    return fb_player_rewind(player);
+}
+
+esp_err_t fb_player_init_partition(fb_player_t *player, framebuffer_t *fb, const esp_partition_t *partition,
+        size_t offset)
+{
+    CHECK_ARG(player && partition);
+
+    player->partition = partition;
+    player->file = NULL;
+
+    return fb_player_init(player, fb, read_partition, player, offset);
+}
+
+esp_err_t fb_player_init_file(fb_player_t *player, framebuffer_t *fb, FILE *file)
+{
+    CHECK_ARG(player && file);
+
+    player->partition = NULL;
+    player->file = file;
+    player->file_pos = ftell(file);
+
+    return fb_player_init(player, fb, read_file, player, 0);
+}
+
+esp_err_t fb_player_free(fb_player_t *player)
+{
+    CHECK_ARG(player);
+
+    free(player->palette);
+    player->palette = NULL;
+    if (player->fb && player->fb->internal == (uint8_t *)player)
+        player->fb->internal = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_player_rewind(fb_player_t *player)
+{
+    CHECK_ARG(player && player->read);
+
+    player->offs = player->base + player->first_frame;
+    player->buf_pos = player->buf_len = 0;
+    player->frame = 0;
+    player->finished = false;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_player_decode(fb_player_t *player)
+{
+    CHECK_ARG(player && player->read && player->fb);
+
+    if (player->finished)
+        return ESP_OK;
+
+    framebuffer_t *fb = player->fb;
+    if (fb->ring)
+        CHECK(fb_compact(fb));
+
+    size_t total = player->width * player->height;
+    size_t i = 0, lo = total, hi = 0;
+    while (true)
+    {
+        uint8_t op;
+        CHECK(get_byte(player, &op));
+        if ((op & OP_MASK) == FB_CLIP_OP_END)
+            break;
+
+        size_t count = op & COUNT_MASK;
+        if (!count)
+        {
+            uint8_t ext;
+            CHECK(get_byte(player, &ext));
+            count = COUNT_EXT + ext;
+        }
+        if (i + count > total)
+        {
+            ESP_LOGE(TAG, "Frame %d is corrupted", (int)player->frame);
+            return ESP_ERR_INVALID_SIZE;
+        }
+
+        rgb_t c;
+        switch (op & OP_MASK)
+        {
+            case FB_CLIP_OP_RUN:
+                CHECK(get_pixel(player, &c));
+                rgb_fill_solid_rgb(fb->data + i, c, count);
+                break;
+            case FB_CLIP_OP_LITERAL:
+                if (!player->indexed)
+                    CHECK(get_bytes(player, fb->data + i, count * sizeof(rgb_t)));
+                else
+                    for (size_t k = 0; k < count; k++)
+                        CHECK(get_pixel(player, fb->data + i + k));
+                break;
+            default:
+                i += count;
+                continue;
+        }
+        if (i < lo)
+            lo = i;
+        hi = i + count - 1;
+        i += count;
+    }
+    if (lo <= hi)
+        fb_mark_dirty_unchecked(fb, 0, lo / fb->width, fb->width - 1, hi / fb->width);
+
+    if (++player->frame == player->frames)
+    {
+        if (player->loop)
+            return fb_player_rewind(player);
+        player->finished = true;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fb_player_run(framebuffer_t *fb)
+{
+    CHECK_ARG(fb && fb->internal);
+
+    CHECK(fb_begin(fb));
+    esp_err_t res = fb_player_decode((fb_player_t *)fb->internal);
+    CHECK(fb_end(fb));
+
+    return res;
+}
@@ -0,0 +1,201 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fb_player.h
+ * @defgroup fb_player fb_player
+ * @{
+ *
+ * Playback of compressed frame sequences from flash partition or file
+ *
+ * Clip is streamed through a small read buffer and decoded directly into
+ * framebuffer data, so RAM use does not depend on clip length. Every frame
+ * is a sequence of skip (unchanged pixels), run and literal operations
+ * over the previous frame, pixels are RGB or indices into a palette of the
+ * clip. Clips are made by `fbclip.py` script of this component.
+ *
+ * Clip format, integers are little endian:
+ *
+ *     header:  "FBCL", u8 version (1), u8 flags, u16 width, u16 height,
+ *              u16 frames, u8 fps, 3 reserved bytes
+ *     palette: 256 RGB colors if FB_CLIP_INDEXED flag is set
+ *     frames:  operations, terminated by FB_CLIP_OP_END
+ *
+ * Operation byte: 2 high bits are opcode, 6 low bits are count 1..63,
+ * count 0 means 64 + next byte. Run is followed by one pixel, literal by
+ * `count` pixels. Pixel is an index in indexed clips or 3 RGB bytes.
+ * First frame is a complete one.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FB_PLAYER_H__
+#define __FB_PLAYER_H__
+
+#include <stdio.h>
+#include <esp_partition.h>
+#include <framebuffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_CLIP_MAGIC "FBCL"     ///< First bytes of clip
+#define FB_CLIP_VERSION 1        ///< Format version
+#define FB_CLIP_HEADER_SIZE 16   ///< Header size, bytes
+#define FB_CLIP_INDEXED 0x01     ///< Header flag: pixels are palette indices
+#define FB_CLIP_PALETTE_SIZE 256 ///< Number of palette colors
+
+#define FB_CLIP_OP_SKIP    0x00  ///< Keep `count` pixels
+#define FB_CLIP_OP_RUN     0x40  ///< Fill `count` pixels with one color
+#define FB_CLIP_OP_LITERAL 0x80  ///< Copy `count` pixels
+#define FB_CLIP_OP_END     0xc0  ///< End of frame, rest of pixels unchanged
+
+#ifndef FB_PLAYER_BUF_SIZE
+#define FB_PLAYER_BUF_SIZE 512   ///< Size of read buffer
+#endif
+
+/**
+ * Clip read function
+ *
+ * @param ctx       Reader context
+ * @param offset    Offset in clip source
+ * @param dst       Destination buffer
+ * @param len       Number of bytes to read
+ * @return          Number of bytes read, less than `len` at the end of source
+ */
+typedef size_t (*fb_player_read_cb_t)(void *ctx, size_t offset, void *dst, size_t len);
+
+/**
+ * Player descriptor
+ */
+typedef struct
+{
+    framebuffer_t *fb;            ///< Target framebuffer
+    fb_player_read_cb_t read;     ///< Read function
+    void *read_ctx;               ///< Argument of `read`
+    size_t base;                  ///< Offset of clip in source
+    size_t width;                 ///< Clip width
+    size_t height;                ///< Clip height
+    size_t frames;                ///< Number of frames
+    uint8_t fps;                  ///< Frame rate of clip
+    bool indexed;                 ///< Pixels are palette indices
+    bool loop;                    ///< Restart after last frame, true by default
+    bool finished;                ///< Last frame was shown and `loop` is false
+    size_t frame;                 ///< Number of next frame
+    rgb_t *palette;               ///< Palette of indexed clip
+    size_t first_frame;           ///< Internal: offset of first frame data
+    size_t offs;                  ///< Internal: source offset of data after read buffer
+    size_t buf_pos;               ///< Internal: read position in buffer
+    size_t buf_len;               ///< Internal: amount of data in buffer
+    uint8_t buf[FB_PLAYER_BUF_SIZE]; ///< Internal: read buffer
+    const esp_partition_t *partition; ///< Internal: source partition of ::fb_player_init_partition()
+    FILE *file;                   ///< Internal: source file of ::fb_player_init_file()
+    size_t file_pos;              ///< Internal: current position in `file`
+} fb_player_t;
+
+/**
+ * @brief Open clip with custom read function
+ *
+ * Clip size must be equal to framebuffer size. Framebuffer `internal`
+ * pointer is set to the player, see ::fb_player_run().
+ *
+ * @param player    Player descriptor
+ * @param fb        Target framebuffer
+ * @param read      Read function
+ * @param ctx       Argument of `read`
+ * @param offset    Offset of clip in source
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_init(fb_player_t *player, framebuffer_t *fb, fb_player_read_cb_t read, void *ctx, size_t offset);
+
+/**
+ * @brief Open clip stored in flash partition
+ *
+ * @param player    Player descriptor
+ * @param fb        Target framebuffer
+ * @param partition Partition, e.g. found by esp_partition_find_first()
+ * @param offset    Offset of clip in partition
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_init_partition(fb_player_t *player, framebuffer_t *fb, const esp_partition_t *partition,
+        size_t offset);
+
+/**
+ * @brief Open clip stored in file, e.g. on SPIFFS
+ *
+ * File must stay open while clip is played.
+ *
+ * @param player    Player descriptor
+ * @param fb        Target framebuffer
+ * @param file      Opened file, clip is read from its start
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_init_file(fb_player_t *player, framebuffer_t *fb, FILE *file);
+
+/**
+ * @brief Free player buffers
+ *
+ * @param player    Player descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_free(fb_player_t *player);
+
+/**
+ * @brief Restart clip from the first frame
+ *
+ * @param player    Player descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_rewind(fb_player_t *player);
+
+/**
+ * @brief Decode next frame into framebuffer
+ *
+ * Only changed rows are marked dirty. Framebuffer in ring mode is
+ * compacted first, see ::fb_compact().
+ *
+ * @param player    Player descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_decode(fb_player_t *player);
+
+/**
+ * @brief Draw function for ::fb_animation_play()
+ *
+ * Decodes next frame of player set by ::fb_player_init() between
+ * ::fb_begin() and ::fb_end(). Play animation with clip `fps`.
+ *
+ * @param fb        Framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_player_run(framebuffer_t *fb);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FB_PLAYER_H__ */
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+Encoder of compressed frame sequences for fb_player
+
+Input is a raw RGB24 stream, e.g. made by
+`ffmpeg -i anim.gif -s 16x16 -f rawvideo -pix_fmt rgb24 anim.rgb`,
+or a list of images (requires Pillow).
+
+Usage:
+  fbclip.py -s 16x16 -r 25 anim.rgb anim.fbc
+  fbclip.py -s 16x16 -r 25 --indexed frame*.png anim.fbc
+
+Clip can be written to a data partition with parttool.py or put to SPIFFS
+image. See fb_player.h for format description.
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = b'FBCL'
+VERSION = 1
+FLAG_INDEXED = 0x01
+PALETTE_SIZE = 256
+
+OP_SKIP = 0x00
+OP_RUN = 0x40
+OP_LITERAL = 0x80
+OP_END = 0xc0
+
+MAX_COUNT = 64 + 255
+
+
+def read_frames(files, width, height):
+    size = width * height
+    if len(files) == 1 and not files[0].lower().endswith(('.png', '.gif', '.bmp', '.jpg')):
+        data = open(files[0], 'rb').read()
+        step = size * 3
+        for i in range(0, len(data) - step + 1, step):
+            chunk = data[i:i + step]
+            yield [tuple(chunk[j:j + 3]) for j in range(0, step, 3)]
+        return
+    from PIL import Image
+    for name in files:
+        img = Image.open(name).convert('RGB')
+        if img.size != (width, height):
+            img = img.resize((width, height))
+        yield list(img.getdata())
+
+
+def op(code, count):
+    if count < 64:
+        return bytes([code | count])
+    return bytes([code, count - 64])
+
+
+def encode_frame(frame, prev, pixel):
+    out = bytearray()
+    total = len(frame)
+    i = 0
+    while i < total:
+        # unchanged pixels
+        n = 0
+        while prev and i + n < total and n < MAX_COUNT and frame[i + n] == prev[i + n]:
+            n += 1
+        if n:
+            if i + n == total:
+                break
+            out += op(OP_SKIP, n)
+            i += n
+            continue
+        # run of one color
+        n = 1
+        while i + n < total and n < MAX_COUNT and frame[i + n] == frame[i]:
+            n += 1
+        if n >= 2:
+            out += op(OP_RUN, n) + pixel(frame[i])
+            i += n
+            continue
+        # literal up to next run or unchanged pixel
+        n = 1
+        while i + n < total and n < MAX_COUNT:
+            j = i + n
+            if prev and frame[j] == prev[j]:
+                break
+            if j + 1 < total and frame[j] == frame[j + 1]:
+                break
+            n += 1
+        out += op(OP_LITERAL, n) + b''.join(pixel(c) for c in frame[i:i + n])
+        i += n
+    out.append(OP_END)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Encode frames for fb_player')
+    parser.add_argument('-s', '--size', required=True, help='frame size, WxH')
+    parser.add_argument('-r', '--fps', type=int, default=25, help='frame rate')
+    parser.add_argument('--indexed', action='store_true', help='palette-indexed clip, at most 256 colors')
+    parser.add_argument('input', nargs='+', help='raw RGB24 file or images')
+    parser.add_argument('output', help='clip file')
+    args = parser.parse_args()
+
+    width, height = (int(v) for v in args.size.lower().split('x'))
+    frames = list(read_frames(args.input, width, height))
+    if not frames:
+        sys.exit('No frames')
+
+    flags = 0
+    palette = None
+    pixel = bytes
+    if args.indexed:
+        colors = sorted(set(c for f in frames for c in f))
+        if len(colors) > PALETTE_SIZE:
+            sys.exit('%d colors, indexed clip can have %d' % (len(colors), PALETTE_SIZE))
+        index = {c: i for i, c in enumerate(colors)}
+        palette = colors + [(0, 0, 0)] * (PALETTE_SIZE - len(colors))
+        pixel = lambda c: bytes([index[c]])
+        flags |= FLAG_INDEXED
+
+    with open(args.output, 'wb') as f:
+        f.write(MAGIC + struct.pack('<BBHHHB3x', VERSION, flags, width, height, len(frames), args.fps))
+        if palette:
+            f.write(b''.join(bytes(c) for c in palette))
+        prev = None
+        for frame in frames:
+            f.write(encode_frame(frame, prev, pixel))
+            prev = frame
+        size = f.tell()
+
+    print('%d frames, %d bytes, %.1f bytes per frame (raw %d)' % (
+        len(frames), size, size / len(frames), width * height * 3))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,171 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file font.c
+ *
+ * Bitmap fonts and text rendering for framebuffer and LED matrices
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "font.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+size_t font_text_width(const font_t *font, const char *text)
+{
+    if (!font || !text)
+        return 0;
+
+    return strlen(text) * (font->width + font->spacing);
+}
+
+esp_err_t font_line_init(font_line_t *line, const font_t *font, size_t capacity)
+{
+    CHECK_ARG(line && font && capacity);
+
+    line->font = font;
+    line->width = 0;
+    line->capacity = capacity;
+    line->columns = calloc(1, capacity);
+    if (!line->columns)
+        return ESP_ERR_NO_MEM;
+
+    return ESP_OK;
+}
+
+esp_err_t font_line_free(font_line_t *line)
+{
+    CHECK_ARG(line);
+
+    free(line->columns);
+    line->columns = NULL;
+    line->capacity = line->width = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t font_line_set_text(font_line_t *line, const char *text)
+{
+    CHECK_ARG(line && line->columns && text);
+
+    const font_t *font = line->font;
+    uint8_t *dst = line->columns;
+    size_t left = line->capacity;
+
+    for (; *text && left; text++)
+    {
+        size_t n = font->width < left ? font->width : left;
+        memcpy(dst, font_glyph(font, *text), n);
+        dst += n;
+        left -= n;
+
+        n = font->spacing < left ? font->spacing : left;
+        memset(dst, 0, n);
+        dst += n;
+        left -= n;
+    }
+    line->width = line->capacity - left;
+
+    return ESP_OK;
+}
+
+esp_err_t font_line_window(const font_line_t *line, size_t offs, bool wrap, uint8_t *dst, size_t num)
+{
+    CHECK_ARG(line && line->columns && (dst || !num));
+
+    if (!line->width)
+    {
+        memset(dst, 0, num);
+        return ESP_OK;
+    }
+
+    if (wrap)
+    {
+        offs %= line->width;
+        while (num)
+        {
+            size_t n = line->width - offs;
+            if (n > num)
+                n = num;
+            memcpy(dst, line->columns + offs, n);
+            dst += n;
+            num -= n;
+            offs = 0;
+        }
+        return ESP_OK;
+    }
+
+    size_t n = offs < line->width ? line->width - offs : 0;
+    if (n > num)
+        n = num;
+    memcpy(dst, line->columns + offs, n);
+    memset(dst + n, 0, num - n);
+
+    return ESP_OK;
+}
+
+esp_err_t font_line_draw_fb(const font_line_t *line, framebuffer_t *fb, size_t x, size_t y, size_t offs, bool wrap,
+        rgb_t fg, const rgb_t *bg)
+{
+    CHECK_ARG(line && line->columns && fb && fb->data);
+
+    if (x >= fb->width || y >= fb->height || !line->width)
+        return ESP_OK;
+
+    size_t w = fb->width - x;
+    size_t h = line->font->height;
+    if (h > fb->height - y)
+        h = fb->height - y;
+    if (wrap)
+        offs %= line->width;
+    else if (!bg)
+    {
+        // nothing to draw behind the end of text
+        if (offs >= line->width)
+            return ESP_OK;
+        if (w > line->width - offs)
+            w = line->width - offs;
+    }
+
+    for (size_t i = 0; i < w; i++, offs++)
+    {
+        if (wrap && offs == line->width)
+            offs = 0;
+        uint8_t col = offs < line->width ? line->columns[offs] : 0;
+        for (size_t r = 0; r < h; r++, col >>= 1)
+        {
+            if (col & 1)
+                *fb_pixel_unchecked(fb, x + i, y + r) = fg;
+            else if (bg)
+                *fb_pixel_unchecked(fb, x + i, y + r) = *bg;
+        }
+    }
+    fb_mark_dirty_unchecked(fb, x, y, x + w - 1, y + h - 1);
+
+    return ESP_OK;
+}
@@ -0,0 +1,174 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file font.h
+ * @defgroup font font
+ * @{
+ *
+ * Bitmap fonts and text rendering for framebuffer and LED matrices
+ *
+ * Fonts are constant column bitmaps placed in flash. Text is rasterised
+ * once into ::font_line_t, a line of 1-bit columns, so drawing and scrolling
+ * it does not look up or decode glyphs every frame.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FONT_H__
+#define __FONT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+#include <framebuffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Monospace bitmap font, up to 8 rows high
+ */
+typedef struct
+{
+    uint8_t width;          ///< Glyph width, columns
+    uint8_t height;         ///< Glyph height, rows, 1..8
+    uint8_t spacing;        ///< Empty columns after every glyph
+    uint8_t first;          ///< Code of first glyph
+    uint8_t last;           ///< Code of last glyph
+    uint8_t fallback;       ///< Code of glyph drawn for characters out of range
+    const uint8_t *bitmap;  ///< `width` columns per glyph, bit 0 is the top row
+} font_t;
+
+/**
+ * Classic 5x7 ASCII font, characters 32..126
+ */
+extern const font_t font_5x7;
+
+/**
+ * @brief Get glyph columns of character
+ *
+ * @param font Font
+ * @param c Character
+ * @return Pointer to `font->width` columns
+ */
+static inline const uint8_t *font_glyph(const font_t *font, char c)
+{
+    uint8_t code = (uint8_t)c;
+    if (code < font->first || code > font->last)
+        code = font->fallback;
+    return font->bitmap + (size_t)(code - font->first) * font->width;
+}
+
+/**
+ * @brief Get width of text
+ *
+ * @param font Font
+ * @param text Text
+ * @return Width in columns, including spacing after the last glyph
+ */
+size_t font_text_width(const font_t *font, const char *text);
+
+/**
+ * Rasterised line of text
+ */
+typedef struct
+{
+    const font_t *font;     ///< Font
+    uint8_t *columns;       ///< Text columns, bit 0 is the top row
+    size_t width;           ///< Width of text, columns
+    size_t capacity;        ///< Size of `columns`
+} font_line_t;
+
+/**
+ * @brief Allocate rasterised line
+ *
+ * @param line Line descriptor
+ * @param font Font
+ * @param capacity Maximal width of text, columns
+ * @return `ESP_OK` on success
+ */
+esp_err_t font_line_init(font_line_t *line, const font_t *font, size_t capacity);
+
+/**
+ * @brief Free rasterised line
+ *
+ * @param line Line descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t font_line_free(font_line_t *line);
+
+/**
+ * @brief Rasterise text into line
+ *
+ * Text which does not fit the capacity is truncated.
+ *
+ * @param line Line descriptor
+ * @param text Text
+ * @return `ESP_OK` on success
+ */
+esp_err_t font_line_set_text(font_line_t *line, const char *text);
+
+/**
+ * @brief Copy window of line columns
+ *
+ * Two memcpy() at most, so scrolling ticker costs nothing but the copy.
+ *
+ * @param line Line descriptor
+ * @param offs First column of window
+ * @param wrap Wrap around the end of text (ticker), otherwise columns
+ *             behind the end are empty
+ * @param[out] dst Buffer for `num` columns
+ * @param num Width of window
+ * @return `ESP_OK` on success
+ */
+esp_err_t font_line_window(const font_line_t *line, size_t offs, bool wrap, uint8_t *dst, size_t num);
+
+/**
+ * @brief Draw line into framebuffer
+ *
+ * Columns of line starting from `offs` are drawn from `x` to the right
+ * edge of framebuffer, rows are clipped by framebuffer.
+ *
+ * @param line Line descriptor
+ * @param fb Framebuffer
+ * @param x Left column in framebuffer
+ * @param y Top row in framebuffer
+ * @param offs First column of line
+ * @param wrap Wrap around the end of text, see font_line_window()
+ * @param fg Text color
+ * @param bg Background color or NULL for transparent background
+ * @return `ESP_OK` on success
+ */
+esp_err_t font_line_draw_fb(const font_line_t *line, framebuffer_t *fb, size_t x, size_t y, size_t offs, bool wrap,
+        rgb_t fg, const rgb_t *bg);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FONT_H__ */
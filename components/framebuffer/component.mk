@@ -1,3 +1,3 @@
 COMPONENT_ADD_INCLUDEDIRS = .
-COMPONENT_SRCDIRS = . led_effects
-COMPONENT_DEPENDS = log color lib8tion noise
+COMPONENT_SRCDIRS = .
+COMPONENT_DEPENDS = log color lib8tion noise esp_idf_lib_helpers
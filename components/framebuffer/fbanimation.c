@@ -30,6 +30,8 @@
  *
  * MIT Licensed as described in the file LICENSE
  */
+#include <stdlib.h>
+#include <string.h>
 #include <esp_err.h>
 #include <esp_log.h>
 #include "fbanimation.h"
@@ -39,24 +41,309 @@ static const char *TAG = "animation";
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-static void display_frame(void *ctx)
+#if FB_SPLIT_SUPPORTED
+
+static void split_worker(void *arg)
 {
-    fb_animation_t *animation = (fb_animation_t *)ctx;
+    fb_split_worker_t *w = (fb_split_worker_t *)arg;
+
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        w->res = w->rows(w->fb, w->y0, w->y1);
+        xSemaphoreGive(w->done);
+    }
+}
+
+// draw second half of rows on the other core, first one here
+static esp_err_t split_dispatch(framebuffer_t *fb, fb_draw_rows_cb_t rows, void *ctx)
+{
+    fb_split_t *sp = (fb_split_t *)ctx;
+    fb_split_worker_t *w = &sp->workers[!xPortGetCoreID()];
+    size_t half = fb->height / 2;
+
+    w->fb = fb;
+    w->rows = rows;
+    w->y0 = half;
+    w->y1 = fb->height;
+    xTaskNotifyGive(w->task);
+
+    esp_err_t res = rows(fb, 0, half);
+    // barrier before render
+    xSemaphoreTake(w->done, portMAX_DELAY);
+
+    return res != ESP_OK ? res : w->res;
+}
+
+#endif /* FB_SPLIT_SUPPORTED */
+
+static inline void attach_split(fb_animation_t *animation, framebuffer_t *fb)
+{
+#if FB_SPLIT_SUPPORTED
+    fb->rows_dispatch = animation->split.enabled ? split_dispatch : NULL;
+    fb->rows_ctx = &animation->split;
+#endif
+}
+
+// draw outgoing effect if it's its turn and blend it with incoming one
+static esp_err_t draw_transition(fb_animation_t *animation, int64_t now, framebuffer_t *view)
+{
+    fb_transition_t *tr = &animation->transition;
+    framebuffer_t *fb = animation->fb;
+
+    uint32_t elapsed = now - tr->start_us;
+    if (elapsed >= tr->duration_us)
+    {
+        // done, next frame must be rendered completely
+        tr->from = NULL;
+        fb_mark_dirty_unchecked(fb, 0, 0, fb->width - 1, fb->height - 1);
+        return ESP_OK;
+    }
+
+    if (++tr->from_skipped >= tr->from_div)
+    {
+        tr->from_skipped = 0;
+        attach_split(animation, tr->from);
+        CHECK(tr->from_draw(tr->from));
+    }
+
+    // blending works on physical order of pixels
+    if (tr->from->ring)
+        CHECK(fb_compact(tr->from));
+    if (fb->ring)
+        CHECK(fb_compact(fb));
+
+    size_t num = fb->width * fb->height;
+    memcpy(tr->out, tr->from->data, num * sizeof(rgb_t));
+    rgb_blend_array(tr->out, fb->data, num, (uint64_t)elapsed * 255 / tr->duration_us);
+
+    *view = *fb;
+    view->data = tr->out;
+    view->ring = false;
+    view->row_origin = view->col_origin = 0;
+    view->dirty = false;
+    fb_mark_dirty_unchecked(view, 0, 0, fb->width - 1, fb->height - 1);
+
+    return ESP_OK;
+}
 
-    // run effect
+// run effect and crossfade, returns frame to render
+static esp_err_t draw_frame(fb_animation_t *animation, int64_t start, framebuffer_t *view, framebuffer_t **frame)
+{
+    attach_split(animation, animation->fb);
     esp_err_t res = animation->draw ? animation->draw(animation->fb) : ESP_FAIL;
     if (res != ESP_OK)
     {
         ESP_LOGE(TAG, "Error running effect %d (%s)", res, esp_err_to_name(res));
+        return res;
+    }
+    // crossfade with outgoing effect
+    *frame = animation->fb;
+    if (animation->transition.from)
+    {
+        res = draw_transition(animation, start, view);
+        if (res != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Error running transition %d (%s)", res, esp_err_to_name(res));
+            return res;
+        }
+        if (animation->transition.from)
+            *frame = view;
+    }
+
+    return ESP_OK;
+}
+
+// adapt rate of outgoing effect to the frame period
+static void adapt_transition(fb_animation_t *animation, int64_t frame_us)
+{
+    fb_transition_t *tr = &animation->transition;
+    if (!tr->from)
         return;
+
+    if (frame_us > animation->period_us && tr->from_div < FB_TRANSITION_MAX_DIV)
+        tr->from_div++;
+    else if (frame_us < animation->period_us / 2 && tr->from_div > 1)
+        tr->from_div--;
+}
+
+static void update_stats(fb_animation_t *animation, uint32_t draw_us, uint32_t render_us)
+{
+    fb_animation_stats_t *stats = &animation->stats;
+
+    stats->frames++;
+    stats->last_draw_us = draw_us;
+    stats->last_render_us = render_us;
+    if (stats->last_draw_us > stats->max_draw_us)
+        stats->max_draw_us = stats->last_draw_us;
+    if (stats->last_render_us > stats->max_render_us)
+        stats->max_render_us = stats->last_render_us;
+}
+
+#if FB_PIPELINE_SUPPORTED
+
+// copy frame to contiguous buffer, resolving ring origin
+static void copy_frame(const framebuffer_t *frame, rgb_t *dst)
+{
+    if (!frame->ring)
+    {
+        memcpy(dst, frame->data, frame->width * frame->height * sizeof(rgb_t));
+        return;
+    }
+    for (size_t y = 0; y < frame->height; y++, dst += frame->width)
+    {
+        rgb_t *first, *second;
+        size_t len = fb_span_unchecked(frame, 0, y, frame->width, &first, &second);
+        memcpy(dst, first, len * sizeof(rgb_t));
+        if (len < frame->width)
+            memcpy(dst + len, second, (frame->width - len) * sizeof(rgb_t));
     }
+}
+
+// Only draw task leaves FB_PIPELINE_DRAWING, other tasks enter it from
+// FB_PIPELINE_IDLE or FB_PIPELINE_READY with compare-and-swap, so a request
+// is never lost and nobody sees an idle pipeline while a frame is drawn
+static inline bool pipeline_cas(fb_pipeline_t *pl, uint8_t from, uint8_t to)
+{
+    return __atomic_compare_exchange_n(&pl->state, &from, to, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+// draws frames into back buffer on request of display_frame()
+static void pipeline_task(void *arg)
+{
+    fb_animation_t *animation = (fb_animation_t *)arg;
+    fb_pipeline_t *pl = &animation->pipeline;
+
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int64_t start = esp_timer_get_time();
+        framebuffer_t view;
+        framebuffer_t *frame;
+        uint8_t done = FB_PIPELINE_IDLE;
+        if (draw_frame(animation, start, &view, &frame) == ESP_OK)
+        {
+            copy_frame(frame, pl->buf[pl->back]);
+            pl->draw_us = esp_timer_get_time() - start;
+            adapt_transition(animation, pl->draw_us);
+            done = FB_PIPELINE_READY;
+        }
+        __atomic_store_n(&pl->state, done, __ATOMIC_RELEASE);
+    }
+}
+
+// request next frame, if draw task is not busy
+static inline bool pipeline_kick(fb_pipeline_t *pl, uint8_t from)
+{
+    if (!pipeline_cas(pl, from, FB_PIPELINE_DRAWING))
+        return false;
+    xTaskNotifyGive(pl->task);
+    return true;
+}
+
+static void pipeline_wait_idle(fb_pipeline_t *pl)
+{
+    while (__atomic_load_n(&pl->state, __ATOMIC_ACQUIRE) == FB_PIPELINE_DRAWING)
+        vTaskDelay(1);
+}
+
+// swap buffers and render the frame drawn by pipeline_task()
+static void display_pipelined(fb_animation_t *animation, int64_t start)
+{
+    fb_pipeline_t *pl = &animation->pipeline;
+
+    if (__atomic_load_n(&pl->state, __ATOMIC_ACQUIRE) != FB_PIPELINE_READY)
+    {
+        // next frame is not drawn yet
+        pipeline_kick(pl, FB_PIPELINE_IDLE);
+        animation->stats.dropped++;
+        return;
+    }
+
+    // draw task waits for notification now, so buffers can be swapped
+    uint8_t front = pl->back;
+    pl->back = !front;
+    uint32_t draw_us = pl->draw_us;
+    pipeline_kick(pl, FB_PIPELINE_READY);
+
+    framebuffer_t *fb = animation->fb;
+    framebuffer_t view = *fb;
+    view.data = pl->buf[front];
+    view.ring = false;
+    view.row_origin = view.col_origin = 0;
+    view.mutex = pl->mutex;
+    view.dirty = false;
+    fb_mark_dirty_unchecked(&view, 0, 0, fb->width - 1, fb->height - 1);
+
+    esp_err_t res = fb_render(&view, animation->render_ctx);
+    if (res != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Error rendering frame %d (%s)", res, esp_err_to_name(res));
+        return;
+    }
+    int64_t end = esp_timer_get_time();
+
+    update_stats(animation, draw_us, end - start);
+
+    animation->next_frame_us = start + animation->period_us;
+    if (end > animation->next_frame_us)
+    {
+        animation->stats.late++;
+        animation->next_frame_us = end;
+    }
+}
+
+#endif /* FB_PIPELINE_SUPPORTED */
+
+static void display_frame(void *ctx)
+{
+    fb_animation_t *animation = (fb_animation_t *)ctx;
+    fb_animation_stats_t *stats = &animation->stats;
+
+    // ticks of the timer while this frame was queued
+    stats->dropped += esp_idf_lib_work_take_coalesced(&animation->work);
+
+    int64_t start = esp_timer_get_time();
+    // callback queued while previous frame was late
+    if (start + animation->period_us / 4 < animation->next_frame_us)
+    {
+        stats->dropped++;
+        return;
+    }
+
+#if FB_PIPELINE_SUPPORTED
+    if (animation->pipeline.task)
+    {
+        display_pipelined(animation, start);
+        return;
+    }
+#endif
+
+    framebuffer_t view;
+    framebuffer_t *frame;
+    if (draw_frame(animation, start, &view, &frame) != ESP_OK)
+        return;
+    int64_t drawn = esp_timer_get_time();
     // render frame
-    res = fb_render(animation->fb, animation->render_ctx);
+    esp_err_t res = fb_render(frame, animation->render_ctx);
     if (res != ESP_OK)
     {
         ESP_LOGE(TAG, "Error rendering frame %d (%s)", res, esp_err_to_name(res));
         return;
     }
+    int64_t end = esp_timer_get_time();
+
+    update_stats(animation, drawn - start, end - drawn);
+    adapt_transition(animation, end - start);
+
+    animation->next_frame_us = start + animation->period_us;
+    if (end > animation->next_frame_us)
+    {
+        // frames due before now will be dropped
+        stats->late++;
+        animation->next_frame_us = end;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -67,9 +354,14 @@ esp_err_t fb_animation_init(fb_animation_t *animation, framebuffer_t *fb)
 
     animation->fb = fb;
     animation->timer = NULL;
+    CHECK(esp_idf_lib_worker_start());
+    CHECK(esp_idf_lib_work_init(&animation->work, display_frame, animation, ESP_IDF_LIB_WORK_NORMAL));
+    memset(&animation->transition, 0, sizeof(animation->transition));
+    memset(&animation->pipeline, 0, sizeof(animation->pipeline));
+    memset(&animation->split, 0, sizeof(animation->split));
     esp_timer_create_args_t timer_args = {
-        .arg = animation,
-        .callback = display_frame,
+        .arg = &animation->work,
+        .callback = esp_idf_lib_work_timer_cb,
         .dispatch_method = ESP_TIMER_TASK,
     };
     return esp_timer_create(&timer_args, &animation->timer);
@@ -78,17 +370,191 @@ esp_err_t fb_animation_init(fb_animation_t *animation, framebuffer_t *fb)
 esp_err_t fb_animation_play(fb_animation_t *animation, uint8_t fps, fb_draw_cb_t draw, void *render_ctx)
 {
     CHECK_ARG(animation && fps && draw);
+#if FB_PIPELINE_SUPPORTED
+    fb_pipeline_t *pl = &animation->pipeline;
+    CHECK_ARG(!pl->task || animation->fb->width * animation->fb->height <= pl->size);
+#endif
 
     animation->render_ctx = render_ctx;
     animation->draw = draw;
-    return esp_timer_start_periodic(animation->timer, 1000000 / fps);
+    animation->period_us = 1000000 / fps;
+    animation->next_frame_us = 0;
+    memset(&animation->stats, 0, sizeof(animation->stats));
+    esp_idf_lib_work_take_coalesced(&animation->work);
+#if FB_PIPELINE_SUPPORTED
+    if (pl->task)
+    {
+        // drop frame of previous effect and draw the first one
+        pipeline_wait_idle(pl);
+        pipeline_cas(pl, FB_PIPELINE_READY, FB_PIPELINE_IDLE);
+        pipeline_kick(pl, FB_PIPELINE_IDLE);
+    }
+#endif
+    return esp_timer_start_periodic(animation->timer, animation->period_us);
+}
+
+esp_err_t fb_animation_crossfade(fb_animation_t *animation, uint8_t fps, framebuffer_t *fb, fb_draw_cb_t draw,
+        void *render_ctx, uint32_t duration_ms)
+{
+    CHECK_ARG(animation && fps && fb && fb->data && draw);
+
+    fb_transition_t *tr = &animation->transition;
+    framebuffer_t *from = animation->fb;
+    fb_draw_cb_t from_draw = animation->draw;
+
+    if (!duration_ms || !from_draw || from == fb)
+    {
+        animation->fb = fb;
+        tr->from = NULL;
+        return fb_animation_play(animation, fps, draw, render_ctx);
+    }
+
+    CHECK_ARG(from->width == fb->width && from->height == fb->height);
+
+    size_t num = fb->width * fb->height;
+    if (tr->out_size < num)
+    {
+        free(tr->out);
+        tr->out_size = 0;
+        tr->out = malloc(num * sizeof(rgb_t));
+        if (!tr->out)
+        {
+            ESP_LOGE(TAG, "Could not allocate %u bytes for transition", (unsigned)(num * sizeof(rgb_t)));
+            return ESP_ERR_NO_MEM;
+        }
+        tr->out_size = num;
+    }
+
+    animation->fb = fb;
+    tr->from = from;
+    tr->from_draw = from_draw;
+    tr->start_us = esp_timer_get_time();
+    tr->duration_us = duration_ms * 1000;
+    tr->from_div = 1;
+    tr->from_skipped = 0;
+
+    return fb_animation_play(animation, fps, draw, render_ctx);
+}
+
+esp_err_t fb_animation_pipeline_enable(fb_animation_t *animation, int core, UBaseType_t priority)
+{
+    CHECK_ARG(animation && animation->fb);
+
+#if FB_PIPELINE_SUPPORTED
+    fb_pipeline_t *pl = &animation->pipeline;
+    if (pl->task)
+        return ESP_OK;
+
+    pl->size = animation->fb->width * animation->fb->height;
+    pl->buf[0] = calloc(pl->size, sizeof(rgb_t));
+    pl->buf[1] = calloc(pl->size, sizeof(rgb_t));
+    pl->mutex = xSemaphoreCreateMutex();
+    pl->back = 0;
+    pl->state = FB_PIPELINE_IDLE;
+    if (!pl->buf[0] || !pl->buf[1] || !pl->mutex
+            || xTaskCreatePinnedToCore(pipeline_task, "fb_draw", FB_PIPELINE_STACK_SIZE, animation,
+                    priority, &pl->task, core) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create pipeline");
+        pl->task = NULL;
+        fb_animation_pipeline_disable(animation);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t fb_animation_pipeline_disable(fb_animation_t *animation)
+{
+    CHECK_ARG(animation);
+
+#if FB_PIPELINE_SUPPORTED
+    fb_pipeline_t *pl = &animation->pipeline;
+    if (pl->task)
+    {
+        pipeline_wait_idle(pl);
+        vTaskDelete(pl->task);
+    }
+    if (pl->mutex)
+        vSemaphoreDelete(pl->mutex);
+    free(pl->buf[0]);
+    free(pl->buf[1]);
+    memset(pl, 0, sizeof(fb_pipeline_t));
+#endif
+
+    return ESP_OK;
+}
+
+esp_err_t fb_animation_split_enable(fb_animation_t *animation, UBaseType_t priority)
+{
+    CHECK_ARG(animation);
+
+#if FB_SPLIT_SUPPORTED
+    fb_split_t *sp = &animation->split;
+    if (sp->enabled)
+        return ESP_OK;
+
+    for (int core = 0; core < 2; core++)
+    {
+        fb_split_worker_t *w = &sp->workers[core];
+        w->done = xSemaphoreCreateBinary();
+        if (!w->done || xTaskCreatePinnedToCore(split_worker, "fb_split", FB_SPLIT_STACK_SIZE, w,
+                priority, &w->task, core) != pdPASS)
+        {
+            ESP_LOGE(TAG, "Could not create split worker on core %d", core);
+            w->task = NULL;
+            fb_animation_split_disable(animation);
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    sp->enabled = true;
+
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t fb_animation_split_disable(fb_animation_t *animation)
+{
+    CHECK_ARG(animation);
+
+#if FB_SPLIT_SUPPORTED
+    fb_split_t *sp = &animation->split;
+    sp->enabled = false;
+    if (animation->fb)
+        attach_split(animation, animation->fb);
+    if (animation->transition.from)
+        attach_split(animation, animation->transition.from);
+    for (int core = 0; core < 2; core++)
+    {
+        fb_split_worker_t *w = &sp->workers[core];
+        if (w->task)
+            vTaskDelete(w->task);
+        if (w->done)
+            vSemaphoreDelete(w->done);
+        memset(w, 0, sizeof(fb_split_worker_t));
+    }
+#endif
+
+    return ESP_OK;
 }
 
 esp_err_t fb_animation_stop(fb_animation_t *animation)
 {
     CHECK_ARG(animation);
 
-    return esp_timer_stop(animation->timer);
+    esp_err_t res = esp_timer_stop(animation->timer);
+    esp_idf_lib_work_flush(&animation->work);
+#if FB_PIPELINE_SUPPORTED
+    if (animation->pipeline.task)
+        pipeline_wait_idle(&animation->pipeline);
+#endif
+
+    return res;
 }
 
 esp_err_t fb_animation_free(fb_animation_t *animation)
@@ -96,5 +562,10 @@ esp_err_t fb_animation_free(fb_animation_t *animation)
     CHECK_ARG(animation);
 
     esp_timer_stop(animation->timer);
+    esp_idf_lib_work_flush(&animation->work);
+    fb_animation_pipeline_disable(animation);
+    fb_animation_split_disable(animation);
+    free(animation->transition.out);
+    memset(&animation->transition, 0, sizeof(animation->transition));
     return esp_timer_delete(animation->timer);
 }
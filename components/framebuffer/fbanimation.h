@@ -36,6 +36,8 @@
 #define __FBANIMATION_H__
 
 #include <esp_timer.h>
+#include <freertos/task.h>
+#include <esp_idf_lib_work.h>
 #include "framebuffer.h"
 
 #ifdef __cplusplus
@@ -47,6 +49,105 @@ extern "C" {
  */
 typedef esp_err_t (*fb_draw_cb_t)(framebuffer_t *fb);
 
+/**
+ * Animation frame pacing statistics
+ */
+typedef struct
+{
+    uint32_t frames;           ///< Number of displayed frames
+    uint32_t late;             ///< Number of frames which took longer than frame period
+    uint32_t dropped;          ///< Number of skipped frames because of late ones
+    uint32_t last_draw_us;     ///< Draw time of last frame, microseconds
+    uint32_t last_render_us;   ///< Render time of last frame, microseconds
+    uint32_t max_draw_us;      ///< Maximal draw time, microseconds
+    uint32_t max_render_us;    ///< Maximal render time, microseconds
+} fb_animation_stats_t;
+
+/**
+ * Maximal divider of outgoing effect frame rate during crossfade
+ */
+#define FB_TRANSITION_MAX_DIV 8
+
+/**
+ * Crossfade state, see ::fb_animation_crossfade()
+ */
+typedef struct
+{
+    framebuffer_t *from;       ///< Framebuffer of outgoing effect, NULL if there is no transition
+    fb_draw_cb_t from_draw;    ///< Draw function of outgoing effect
+    rgb_t *out;                ///< Blended frame, allocated by first transition
+    size_t out_size;           ///< Size of blended frame, pixels
+    int64_t start_us;          ///< Time of transition start, microseconds
+    uint32_t duration_us;      ///< Transition duration, microseconds
+    uint8_t from_div;          ///< Outgoing effect is drawn every `from_div` frame
+    uint8_t from_skipped;      ///< Internal: frames since outgoing effect was drawn
+} fb_transition_t;
+
+#if defined(CONFIG_IDF_TARGET_ESP8266) || defined(CONFIG_FREERTOS_UNICORE)
+#define FB_PIPELINE_SUPPORTED 0
+#else
+#define FB_PIPELINE_SUPPORTED (portNUM_PROCESSORS > 1) ///< Draw/render pipeline is available
+#endif
+
+/**
+ * Stack size of pipeline draw task, effects run on it
+ */
+#define FB_PIPELINE_STACK_SIZE 4096
+
+/**
+ * State of draw task of pipeline
+ */
+typedef enum
+{
+    FB_PIPELINE_IDLE = 0, ///< Draw task waits for request
+    FB_PIPELINE_DRAWING,  ///< Draw task is drawing into back buffer
+    FB_PIPELINE_READY,    ///< Back buffer contains drawn frame
+} fb_pipeline_state_t;
+
+/**
+ * Draw/render pipeline state, see ::fb_animation_pipeline_enable()
+ */
+typedef struct
+{
+    TaskHandle_t task;         ///< Draw task, NULL if pipeline is disabled
+    SemaphoreHandle_t mutex;   ///< Internal: mutex of rendered frame
+    rgb_t *buf[2];             ///< Internal: front and back buffers
+    size_t size;               ///< Size of every buffer, pixels
+    uint8_t back;              ///< Internal: index of back buffer
+    uint8_t state;             ///< Internal: ::fb_pipeline_state_t, changed atomically
+    uint32_t draw_us;          ///< Internal: draw time of frame in back buffer
+} fb_pipeline_t;
+
+#define FB_SPLIT_SUPPORTED FB_PIPELINE_SUPPORTED ///< Tile-parallel drawing is available
+
+/**
+ * Stack size of split draw workers
+ */
+#define FB_SPLIT_STACK_SIZE 4096
+
+/**
+ * Worker of split drawing, see ::fb_animation_split_enable()
+ */
+typedef struct
+{
+    TaskHandle_t task;         ///< Worker task, NULL if not created
+    SemaphoreHandle_t done;    ///< Internal: given when job is finished
+    framebuffer_t *fb;         ///< Internal: framebuffer of current job
+    fb_draw_rows_cb_t rows;    ///< Internal: draw function of current job
+    size_t y0;                 ///< Internal: first row of current job
+    size_t y1;                 ///< Internal: row after the last one of current job
+    esp_err_t res;             ///< Internal: result of current job
+} fb_split_worker_t;
+
+/**
+ * Split drawing state
+ */
+typedef struct
+{
+    bool enabled;                 ///< Row-independent effects are drawn on both cores
+    fb_split_worker_t workers[2]; ///< Internal: workers pinned to every core
+} fb_split_t;
+
 /**
  * Animation descriptor
  */
@@ -55,7 +156,14 @@ typedef struct
     framebuffer_t *fb;         ///< Framebuffer descriptor
     void *render_ctx;          ///< Renderer context
     esp_timer_handle_t timer;  ///< Animation timer
+    esp_idf_lib_work_t work;   ///< Internal: frame work queued by the timer
     fb_draw_cb_t draw;         ///< Draw function
+    uint32_t period_us;        ///< Frame period, microseconds
+    int64_t next_frame_us;     ///< Internal: time when next frame is due
+    fb_animation_stats_t stats; ///< Frame pacing statistics, reset by ::fb_animation_play()
+    fb_transition_t transition; ///< Crossfade state
+    fb_pipeline_t pipeline;    ///< Draw/render pipeline state
+    fb_split_t split;          ///< Split drawing state
 } fb_animation_t;
 
 /**
@@ -70,6 +178,10 @@ esp_err_t fb_animation_init(fb_animation_t *animation, framebuffer_t *fb);
 /**
  * @brief Play animation
  *
+ * When frame takes longer than frame period, timer ticks meanwhile
+ * are skipped and counted as dropped, so animation does not
+ * try to catch up by drawing frames back to back.
+ *
  * @param animation     Animation descriptor
  * @param fps           Target FPS
  * @param draw          Function for drawing on a framebuffer
@@ -78,9 +190,103 @@ esp_err_t fb_animation_init(fb_animation_t *animation, framebuffer_t *fb);
  */
 esp_err_t fb_animation_play(fb_animation_t *animation, uint8_t fps, fb_draw_cb_t draw, void *render_ctx);
 
+/**
+ * @brief Play animation with crossfade from the current one
+ *
+ * Current framebuffer and draw function of animation become outgoing
+ * effect, `fb` and `draw` become the incoming one. Both effects keep running
+ * for `duration_ms` and their frames are blended into a separate buffer
+ * which is rendered with the renderer of `fb`. Outgoing effect is drawn at
+ * reduced rate when frames do not fit the frame period, up to
+ * ::FB_TRANSITION_MAX_DIV times less often.
+ *
+ * Framebuffers must have the same size and must not be shared with other
+ * effects during transition. After transition animation plays `fb` only,
+ * so the outgoing framebuffer can be used for the next effect.
+ *
+ * Animation must be stopped before the call.
+ *
+ * @param animation     Animation descriptor
+ * @param fps           Target FPS
+ * @param fb            Framebuffer of incoming effect
+ * @param draw          Draw function of incoming effect
+ * @param render_ctx    Renderer callback argument
+ * @param duration_ms   Transition duration, ms. If 0, acts as ::fb_animation_play()
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_animation_crossfade(fb_animation_t *animation, uint8_t fps, framebuffer_t *fb, fb_draw_cb_t draw,
+        void *render_ctx, uint32_t duration_ms);
+
+/**
+ * @brief Enable draw/render pipeline
+ *
+ * By default frames are drawn and rendered sequentially in the shared
+ * worker task (see esp_idf_lib_work.h). With the pipeline the draw task
+ * pinned to `core` draws frame N+1 and copies it to the back buffer while
+ * frame N is rendered from the front buffer in the worker task. Buffers are swapped without locks when the
+ * draw task has finished, so frame period is limited by the slowest
+ * stage instead of their sum. Frame is displayed one period later than
+ * it was drawn.
+ *
+ * Render callback gets a view of framebuffer with `data` pointing to
+ * the front buffer and the whole frame marked dirty.
+ *
+ * Animation must be stopped. Only available on dual-core targets, see
+ * ::FB_PIPELINE_SUPPORTED.
+ *
+ * @param animation     Animation descriptor
+ * @param core          Core of draw task, usually the one the worker task
+ *                      is not pinned to
+ * @param priority      Priority of draw task
+ * @return              ESP_OK on success, ESP_ERR_NOT_SUPPORTED on single-core targets
+ */
+esp_err_t fb_animation_pipeline_enable(fb_animation_t *animation, int core, UBaseType_t priority);
+
+/**
+ * @brief Disable draw/render pipeline
+ *
+ * Animation must be stopped.
+ *
+ * @param animation     Animation descriptor
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_animation_pipeline_disable(fb_animation_t *animation);
+
+/**
+ * @brief Enable drawing of row-independent effects on both cores
+ *
+ * Creates a worker task pinned to every core. Effects which draw with
+ * ::fb_draw_rows() get the rows split in two halves: the first one is drawn
+ * by the calling task, the second one by the worker on the other core.
+ * Calling task waits for the worker before the frame is rendered. Other
+ * effects are drawn as usual.
+ *
+ * Animation must be stopped. Only available on dual-core targets, see
+ * ::FB_SPLIT_SUPPORTED.
+ *
+ * @param animation     Animation descriptor
+ * @param priority      Priority of worker tasks, should not be lower than
+ *                      priority of the drawing task
+ * @return              ESP_OK on success, ESP_ERR_NOT_SUPPORTED on single-core targets
+ */
+esp_err_t fb_animation_split_enable(fb_animation_t *animation, UBaseType_t priority);
+
+/**
+ * @brief Disable drawing on both cores
+ *
+ * Animation must be stopped.
+ *
+ * @param animation     Animation descriptor
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_animation_split_disable(fb_animation_t *animation);
+
 /**
  * @brief Stop playing animation
  *
+ * With the pipeline enabled waits until the draw task finishes current frame,
+ * so effect can be switched after the call.
+ *
  * @param animation     Animation descriptor
  * @return              ESP_OK on success
  */
@@ -0,0 +1,189 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbblit.c
+ *
+ * Image and sprite blitting
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <lib8tion.h>
+#include "fbblit.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+typedef enum {
+    BLIT_OPAQUE = 0,
+    BLIT_KEYED,
+    BLIT_ALPHA,
+} blit_mode_t;
+
+typedef struct
+{
+    const fb_image_t *img;
+    blit_mode_t mode;
+    rgb_t key;
+    uint8_t opacity;
+} blit_t;
+
+static inline rgb_t image_pixel(const fb_image_t *img, size_t i)
+{
+    return img->format == FB_IMAGE_INDEXED
+           ? img->palette[((const uint8_t *)img->data)[i]]
+           : ((const rgb_t *)img->data)[i];
+}
+
+// Draw `len` pixels of image starting from pixel `offs`
+static void blit_run(const blit_t *b, rgb_t *dst, size_t offs, size_t len)
+{
+    const fb_image_t *img = b->img;
+    const rgb_t *rgb = (const rgb_t *)img->data + offs;
+
+    if (img->format == FB_IMAGE_RGB)
+    {
+        if (b->mode == BLIT_OPAQUE)
+        {
+            memcpy(dst, rgb, len * sizeof(rgb_t));
+            return;
+        }
+        if (b->mode == BLIT_ALPHA && !img->alpha)
+        {
+            rgb_blend_array(dst, rgb, len, b->opacity);
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < len; i++, offs++)
+    {
+        rgb_t c = image_pixel(img, offs);
+        switch (b->mode)
+        {
+            case BLIT_KEYED:
+                if (c.r != b->key.r || c.g != b->key.g || c.b != b->key.b)
+                    dst[i] = c;
+                break;
+            case BLIT_ALPHA:
+            {
+                uint8_t a = b->opacity;
+                if (img->alpha)
+                    a = a == 255 ? img->alpha[offs] : scale8(img->alpha[offs], a);
+                if (a == 255)
+                    dst[i] = c;
+                else if (a)
+                {
+                    dst[i].r = blend8(dst[i].r, c.r, a);
+                    dst[i].g = blend8(dst[i].g, c.g, a);
+                    dst[i].b = blend8(dst[i].b, c.b, a);
+                }
+                break;
+            }
+            default:
+                dst[i] = c;
+        }
+    }
+}
+
+static esp_err_t blit(framebuffer_t *fb, int x, int y, const blit_t *b)
+{
+    const fb_image_t *img = b->img;
+    CHECK_ARG(fb && fb->data && img && img->data && (img->format != FB_IMAGE_INDEXED || img->palette));
+
+    // clip image rectangle against framebuffer
+    size_t sx = x < 0 ? (size_t)-x : 0;
+    size_t sy = y < 0 ? (size_t)-y : 0;
+    if (sx >= img->width || sy >= img->height)
+        return ESP_OK;
+    size_t dx = x < 0 ? 0 : (size_t)x;
+    size_t dy = y < 0 ? 0 : (size_t)y;
+    if (dx >= fb->width || dy >= fb->height)
+        return ESP_OK;
+    size_t w = img->width - sx;
+    if (w > fb->width - dx)
+        w = fb->width - dx;
+    size_t h = img->height - sy;
+    if (h > fb->height - dy)
+        h = fb->height - dy;
+
+    for (size_t row = 0; row < h; row++)
+    {
+        size_t offs = (sy + row) * img->width + sx;
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, dx, dy + row, w, &first, &second);
+        blit_run(b, first, offs, n);
+        if (n < w)
+            blit_run(b, second, offs + n, w - n);
+    }
+    fb_mark_dirty_unchecked(fb, dx, dy, dx + w - 1, dy + h - 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_image_from_indexed(fb_image_t *img, const fb_indexed_t *ifb)
+{
+    CHECK_ARG(img && ifb && ifb->data && ifb->palette);
+
+    img->format = FB_IMAGE_INDEXED;
+    img->width = ifb->width;
+    img->height = ifb->height;
+    img->data = ifb->data;
+    img->palette = ifb->palette;
+    img->alpha = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_image_frame(const fb_image_t *sheet, size_t frame, size_t frame_height, fb_image_t *img)
+{
+    CHECK_ARG(sheet && sheet->data && img && frame_height && (frame + 1) * frame_height <= sheet->height);
+
+    size_t offs = frame * frame_height * sheet->width;
+    *img = *sheet;
+    img->height = frame_height;
+    img->data = sheet->format == FB_IMAGE_INDEXED
+                ? (const void *)((const uint8_t *)sheet->data + offs)
+                : (const void *)((const rgb_t *)sheet->data + offs);
+    if (sheet->alpha)
+        img->alpha = sheet->alpha + offs;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_blit(framebuffer_t *fb, int x, int y, const fb_image_t *img)
+{
+    blit_t b = { .img = img, .mode = BLIT_OPAQUE };
+    return blit(fb, x, y, &b);
+}
+
+esp_err_t fb_blit_keyed(framebuffer_t *fb, int x, int y, const fb_image_t *img, rgb_t key)
+{
+    blit_t b = { .img = img, .mode = BLIT_KEYED, .key = key };
+    return blit(fb, x, y, &b);
+}
+
+esp_err_t fb_blit_alpha(framebuffer_t *fb, int x, int y, const fb_image_t *img, uint8_t opacity)
+{
+    blit_t b = { .img = img, .mode = BLIT_ALPHA, .opacity = opacity };
+    return blit(fb, x, y, &b);
+}
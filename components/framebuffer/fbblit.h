@@ -0,0 +1,146 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbblit.h
+ * @defgroup fb_blit fb_blit
+ * @{
+ *
+ * Image and sprite blitting
+ *
+ * Images are drawn row by row with clipping against framebuffer bounds,
+ * so they can be placed partly or completely outside the frame. Opaque
+ * RGB images are copied with memcpy(), other variants process one row
+ * span at a time without per-pixel bounds checks or function calls.
+ *
+ * Image data can be constant (in flash) or in RAM, RGB or 8-bit indexed
+ * with palette, see ::fb_image_from_indexed().
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBBLIT_H__
+#define __FBBLIT_H__
+
+#include "framebuffer.h"
+#include "fbindexed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Pixel format of image
+ */
+typedef enum {
+    FB_IMAGE_RGB = 0, ///< `data` is an array of rgb_t
+    FB_IMAGE_INDEXED, ///< `data` is an array of indices in `palette`
+} fb_image_format_t;
+
+/**
+ * Image descriptor
+ */
+typedef struct
+{
+    fb_image_format_t format; ///< Pixel format
+    size_t width;             ///< Image width
+    size_t height;            ///< Image height
+    const void *data;         ///< Pixels, `width * height`, row by row
+    const rgb_t *palette;     ///< Palette of ::FB_IMAGE_INDEXED image
+    const uint8_t *alpha;     ///< Opacity of every pixel or NULL, used by ::fb_blit_alpha()
+} fb_image_t;
+
+/**
+ * @brief Make image from indexed framebuffer
+ *
+ * Image refers to framebuffer data and palette, no copy is made.
+ *
+ * @param[out] img  Image descriptor
+ * @param ifb       Indexed framebuffer
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_image_from_indexed(fb_image_t *img, const fb_indexed_t *ifb);
+
+/**
+ * @brief Get frame of sprite sheet
+ *
+ * Sprite sheet is an image with frames of the same height placed
+ * one under another. Returned image refers to the sheet data.
+ *
+ * @param sheet         Sprite sheet
+ * @param frame         Frame number
+ * @param frame_height  Height of one frame
+ * @param[out] img      Frame image
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_image_frame(const fb_image_t *sheet, size_t frame, size_t frame_height, fb_image_t *img);
+
+/**
+ * @brief Draw opaque image
+ *
+ * Per-pixel alpha of the image is ignored.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate of top left corner, can be negative
+ * @param y         Y coordinate of top left corner, can be negative
+ * @param img       Image
+ * @return          ESP_OK on success, image can be clipped completely
+ */
+esp_err_t fb_blit(framebuffer_t *fb, int x, int y, const fb_image_t *img);
+
+/**
+ * @brief Draw image with transparent color
+ *
+ * Pixels of `key` color are not drawn. Indexed images are compared
+ * by palette color, not by index.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate of top left corner, can be negative
+ * @param y         Y coordinate of top left corner, can be negative
+ * @param img       Image
+ * @param key       Transparent color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_blit_keyed(framebuffer_t *fb, int x, int y, const fb_image_t *img, rgb_t key);
+
+/**
+ * @brief Blend image into framebuffer
+ *
+ * Pixels are blended by their `alpha` scaled by `opacity`, or by
+ * `opacity` alone if image has no alpha.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate of top left corner, can be negative
+ * @param y         Y coordinate of top left corner, can be negative
+ * @param img       Image
+ * @param opacity   Opacity of whole image, 255 keeps per-pixel alpha
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_blit_alpha(framebuffer_t *fb, int x, int y, const fb_image_t *img, uint8_t opacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBBLIT_H__ */
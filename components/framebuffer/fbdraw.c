@@ -0,0 +1,394 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbdraw.c
+ *
+ * Anti-aliased drawing primitives
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <lib8tion.h>
+#include "fbdraw.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define HALF (FB_FIXED_ONE / 2)
+
+// Pixel which contains fixed point coordinate
+#define PIX(v) (((v) + HALF) >> FB_FIXED_SHIFT)
+
+#define SWAP(a, b) do { fb_fixed_t __t = (a); (a) = (b); (b) = __t; } while (0)
+
+static inline fb_fixed_t fx_abs(fb_fixed_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+static inline fb_fixed_t fx_min(fb_fixed_t a, fb_fixed_t b)
+{
+    return a < b ? a : b;
+}
+
+static inline fb_fixed_t fx_max(fb_fixed_t a, fb_fixed_t b)
+{
+    return a > b ? a : b;
+}
+
+static uint32_t isqrt(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit = 1ULL << 62;
+
+    while (bit > v)
+        bit >>= 2;
+    while (bit)
+    {
+        if (v >= res + bit)
+        {
+            v -= res + bit;
+            res = (res >> 1) + bit;
+        }
+        else
+            res >>= 1;
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+// Blend pixel to color by coverage 0..FB_FIXED_ONE, clipped
+static inline void plot(framebuffer_t *fb, int x, int y, rgb_t color, int32_t cov)
+{
+    if (x < 0 || y < 0 || (size_t)x >= fb->width || (size_t)y >= fb->height || cov <= 0)
+        return;
+
+    rgb_t *p = fb_pixel_unchecked(fb, x, y);
+    if (cov >= 255)
+    {
+        *p = color;
+        return;
+    }
+    p->r = blend8(p->r, color.r, cov);
+    p->g = blend8(p->g, color.g, cov);
+    p->b = blend8(p->b, color.b, cov);
+}
+
+static void mark(framebuffer_t *fb, int x0, int y0, int x1, int y1)
+{
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= (int)fb->width) x1 = fb->width - 1;
+    if (y1 >= (int)fb->height) y1 = fb->height - 1;
+    if (x0 <= x1 && y0 <= y1)
+        fb_mark_dirty_unchecked(fb, x0, y0, x1, y1);
+}
+
+static void fill_run(framebuffer_t *fb, int x0, int x1, int y, rgb_t color, int32_t cov)
+{
+    if (x0 < 0) x0 = 0;
+    if (x1 >= (int)fb->width) x1 = fb->width - 1;
+    if (x0 > x1)
+        return;
+
+    size_t len = x1 - x0 + 1;
+    rgb_t *first, *second;
+    size_t n = fb_span_unchecked(fb, x0, y, len, &first, &second);
+    if (cov >= 255)
+    {
+        rgb_fill_solid_rgb(first, color, n);
+        if (n < len)
+            rgb_fill_solid_rgb(second, color, len - n);
+        return;
+    }
+    for (size_t i = 0; i < len; i++)
+        plot(fb, x0 + i, y, color, cov);
+}
+
+/*
+ * Integral of fraction of row height right of edge which goes from `lo`
+ * to `hi` across the row, from -inf to `t`
+ */
+static int64_t edge_area(fb_fixed_t lo, fb_fixed_t hi, fb_fixed_t t)
+{
+    if (t <= lo)
+        return 0;
+    if (t >= hi)
+        return (int64_t)(hi - lo) / 2 + (t - hi);
+    return (int64_t)(t - lo) * (t - lo) / (2 * (hi - lo));
+}
+
+// Part of pixel `x` right of edge, 0..FB_FIXED_ONE
+static inline int32_t edge_cov(fb_fixed_t lo, fb_fixed_t hi, int x)
+{
+    fb_fixed_t c = x * FB_FIXED_ONE;
+    return edge_area(lo, hi, c + HALF) - edge_area(lo, hi, c - HALF);
+}
+
+/*
+ * Draw row of filled shape. Left edge crosses the row between `l_lo` and
+ * `l_hi`, right edge between `r_lo` and `r_hi`, `cov` is the covered part
+ * of row height.
+ */
+static void fill_row(framebuffer_t *fb, int y, fb_fixed_t l_lo, fb_fixed_t l_hi, fb_fixed_t r_lo, fb_fixed_t r_hi,
+        rgb_t color, int32_t cov)
+{
+    if (y < 0 || (size_t)y >= fb->height || r_hi <= l_lo || cov <= 0)
+        return;
+
+    int left_end = PIX(l_hi);
+    int right_start = PIX(r_lo);
+    int last = PIX(r_hi);
+    if (last >= (int)fb->width)
+        last = fb->width - 1;
+
+    for (int x = PIX(l_lo) < 0 ? 0 : PIX(l_lo); x <= last; x++)
+    {
+        if (x > left_end && x < right_start)
+        {
+            // interior
+            fill_run(fb, x, right_start - 1, y, color, cov);
+            x = right_start - 1;
+            continue;
+        }
+        int32_t c = edge_cov(l_lo, l_hi, x) - edge_cov(r_lo, r_hi, x);
+        plot(fb, x, y, color, (c * cov) >> FB_FIXED_SHIFT);
+    }
+}
+
+esp_err_t fb_draw_point_aa(framebuffer_t *fb, fb_fixed_t x, fb_fixed_t y, rgb_t color)
+{
+    CHECK_ARG(fb && fb->data);
+
+    int ix = FB_FIXED_INT(x);
+    int iy = FB_FIXED_INT(y);
+    int32_t fx = x & (FB_FIXED_ONE - 1);
+    int32_t fy = y & (FB_FIXED_ONE - 1);
+
+    plot(fb, ix, iy, color, ((FB_FIXED_ONE - fx) * (FB_FIXED_ONE - fy)) >> FB_FIXED_SHIFT);
+    plot(fb, ix + 1, iy, color, (fx * (FB_FIXED_ONE - fy)) >> FB_FIXED_SHIFT);
+    plot(fb, ix, iy + 1, color, ((FB_FIXED_ONE - fx) * fy) >> FB_FIXED_SHIFT);
+    plot(fb, ix + 1, iy + 1, color, (fx * fy) >> FB_FIXED_SHIFT);
+    mark(fb, ix, iy, ix + 1, iy + 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_draw_line_aa(framebuffer_t *fb, fb_fixed_t x0, fb_fixed_t y0, fb_fixed_t x1, fb_fixed_t y1,
+        rgb_t color)
+{
+    CHECK_ARG(fb && fb->data);
+
+    // Xiaolin Wu's algorithm, iterate over major axis
+    bool steep = fx_abs(y1 - y0) > fx_abs(x1 - x0);
+    if (steep)
+    {
+        SWAP(x0, y0);
+        SWAP(x1, y1);
+    }
+    if (x0 > x1)
+    {
+        SWAP(x0, x1);
+        SWAP(y0, y1);
+    }
+
+    fb_fixed_t dx = x1 - x0;
+    // slope and y in 16.16
+    int64_t grad = dx ? ((int64_t)(y1 - y0) << 16) / dx : 0;
+    int xs = PIX(x0);
+    int xe = PIX(x1);
+    int limit = steep ? fb->height : fb->width;
+    int first = xs < 0 ? 0 : xs;
+    int last = xe >= limit ? limit - 1 : xe;
+    int64_t y = ((int64_t)y0 << 8) + (((int64_t)first * FB_FIXED_ONE - x0) * grad >> 8);
+
+    for (int x = first; x <= last; x++, y += grad)
+    {
+        // horizontal coverage of end pixels
+        int32_t c = FB_FIXED_ONE;
+        if (xs == xe)
+            c = dx;
+        else if (x == xs)
+            c = FB_FIXED_ONE - ((x0 + HALF) & (FB_FIXED_ONE - 1));
+        else if (x == xe)
+            c = (x1 + HALF) & (FB_FIXED_ONE - 1);
+
+        int iy = (int)(y >> 16);
+        int32_t f = (y >> 8) & (FB_FIXED_ONE - 1);
+        int32_t c0 = ((FB_FIXED_ONE - f) * c) >> FB_FIXED_SHIFT;
+        int32_t c1 = (f * c) >> FB_FIXED_SHIFT;
+        if (steep)
+        {
+            plot(fb, iy, x, color, c0);
+            plot(fb, iy + 1, x, color, c1);
+        }
+        else
+        {
+            plot(fb, x, iy, color, c0);
+            plot(fb, x, iy + 1, color, c1);
+        }
+    }
+
+    int ymin = FB_FIXED_INT(fx_min(y0, y1));
+    int ymax = FB_FIXED_INT(fx_max(y0, y1)) + 1;
+    if (steep)
+        mark(fb, ymin, first, ymax, last);
+    else
+        mark(fb, first, ymin, last, ymax);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_draw_circle_aa(framebuffer_t *fb, fb_fixed_t cx, fb_fixed_t cy, fb_fixed_t r, rgb_t color)
+{
+    CHECK_ARG(fb && fb->data && r >= 0);
+
+    int64_t r2 = (int64_t)r * r;
+    // 1/sqrt(2), octant boundary
+    fb_fixed_t lim = (fb_fixed_t)(((int64_t)r * 181) >> 8);
+
+    // rows of left and right octants
+    int first = (cy - lim + FB_FIXED_ONE - 1) >> FB_FIXED_SHIFT;
+    int last = FB_FIXED_INT(cy + lim);
+    if (first < 0) first = 0;
+    if (last >= (int)fb->height) last = fb->height - 1;
+    for (int y = first; y <= last; y++)
+    {
+        fb_fixed_t d = y * FB_FIXED_ONE - cy;
+        fb_fixed_t w = isqrt(r2 - (int64_t)d * d);
+        for (int s = 0; s < 2; s++)
+        {
+            fb_fixed_t x = s ? cx + w : cx - w;
+            int32_t f = x & (FB_FIXED_ONE - 1);
+            plot(fb, FB_FIXED_INT(x), y, color, FB_FIXED_ONE - f);
+            plot(fb, FB_FIXED_INT(x) + 1, y, color, f);
+        }
+    }
+
+    // columns of top and bottom octants
+    first = (cx - lim + FB_FIXED_ONE - 1) >> FB_FIXED_SHIFT;
+    last = FB_FIXED_INT(cx + lim);
+    if (first < 0) first = 0;
+    if (last >= (int)fb->width) last = fb->width - 1;
+    for (int x = first; x <= last; x++)
+    {
+        fb_fixed_t d = x * FB_FIXED_ONE - cx;
+        // diagonal pixels are drawn by rows
+        if (fx_abs(d) >= lim)
+            continue;
+        fb_fixed_t w = isqrt(r2 - (int64_t)d * d);
+        for (int s = 0; s < 2; s++)
+        {
+            fb_fixed_t y = s ? cy + w : cy - w;
+            int32_t f = y & (FB_FIXED_ONE - 1);
+            plot(fb, x, FB_FIXED_INT(y), color, FB_FIXED_ONE - f);
+            plot(fb, x, FB_FIXED_INT(y) + 1, color, f);
+        }
+    }
+
+    mark(fb, FB_FIXED_INT(cx - r), FB_FIXED_INT(cy - r), FB_FIXED_INT(cx + r) + 1, FB_FIXED_INT(cy + r) + 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_fill_circle_aa(framebuffer_t *fb, fb_fixed_t cx, fb_fixed_t cy, fb_fixed_t r, rgb_t color)
+{
+    CHECK_ARG(fb && fb->data && r >= 0);
+
+    int64_t r2 = (int64_t)r * r;
+    int first = PIX(cy - r);
+    int last = PIX(cy + r);
+    if (first < 0) first = 0;
+    if (last >= (int)fb->height) last = fb->height - 1;
+
+    for (int y = first; y <= last; y++)
+    {
+        // part of row inside circle
+        fb_fixed_t top = fx_max(y * FB_FIXED_ONE - HALF - cy, -r);
+        fb_fixed_t bottom = fx_min(y * FB_FIXED_ONE + HALF - cy, r);
+        if (bottom <= top)
+            continue;
+        // half-widths of circle at row edges and the widest one
+        fb_fixed_t w0 = isqrt(r2 - (int64_t)top * top);
+        fb_fixed_t w1 = isqrt(r2 - (int64_t)bottom * bottom);
+        fb_fixed_t wmin = fx_min(w0, w1);
+        fb_fixed_t wmax = top < 0 && bottom > 0 ? r : fx_max(w0, w1);
+
+        fill_row(fb, y, cx - wmax, cx - wmin, cx + wmin, cx + wmax, color, bottom - top);
+    }
+
+    mark(fb, FB_FIXED_INT(cx - r), first, FB_FIXED_INT(cx + r) + 1, last);
+
+    return ESP_OK;
+}
+
+static inline fb_fixed_t edge_x(fb_fixed_t ax, fb_fixed_t ay, fb_fixed_t bx, fb_fixed_t by, fb_fixed_t y)
+{
+    if (by == ay)
+        return ax;
+    return ax + (fb_fixed_t)((int64_t)(y - ay) * (bx - ax) / (by - ay));
+}
+
+esp_err_t fb_fill_triangle_aa(framebuffer_t *fb, fb_fixed_t x0, fb_fixed_t y0, fb_fixed_t x1, fb_fixed_t y1,
+        fb_fixed_t x2, fb_fixed_t y2, rgb_t color)
+{
+    CHECK_ARG(fb && fb->data);
+
+    // sort vertices top to bottom
+    if (y0 > y1) { SWAP(x0, x1); SWAP(y0, y1); }
+    if (y1 > y2) { SWAP(x1, x2); SWAP(y1, y2); }
+    if (y0 > y1) { SWAP(x0, x1); SWAP(y0, y1); }
+
+    int first = PIX(y0);
+    int last = PIX(y2);
+    if (first < 0) first = 0;
+    if (last >= (int)fb->height) last = fb->height - 1;
+
+    for (int y = first; y <= last; y++)
+    {
+        fb_fixed_t top = fx_max(y * FB_FIXED_ONE - HALF, y0);
+        fb_fixed_t bottom = fx_min(y * FB_FIXED_ONE + HALF, y2);
+        if (bottom <= top)
+            continue;
+
+        // sample both edges at row boundaries and at the middle vertex
+        fb_fixed_t ys[3] = { top, bottom, y1 };
+        size_t n = y1 > top && y1 < bottom ? 3 : 2;
+        fb_fixed_t l_lo = INT32_MAX, l_hi = INT32_MIN, r_lo = INT32_MAX, r_hi = INT32_MIN;
+        for (size_t i = 0; i < n; i++)
+        {
+            fb_fixed_t a = edge_x(x0, y0, x2, y2, ys[i]);
+            fb_fixed_t b = ys[i] < y1 ? edge_x(x0, y0, x1, y1, ys[i]) : edge_x(x1, y1, x2, y2, ys[i]);
+            fb_fixed_t lo = fx_min(a, b), hi = fx_max(a, b);
+            l_lo = fx_min(l_lo, lo);
+            l_hi = fx_max(l_hi, lo);
+            r_lo = fx_min(r_lo, hi);
+            r_hi = fx_max(r_hi, hi);
+        }
+
+        fill_row(fb, y, l_lo, l_hi, r_lo, r_hi, color, bottom - top);
+    }
+
+    mark(fb, FB_FIXED_INT(fx_min(x0, fx_min(x1, x2))), first, FB_FIXED_INT(fx_max(x0, fx_max(x1, x2))) + 1, last);
+
+    return ESP_OK;
+}
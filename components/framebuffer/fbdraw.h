@@ -0,0 +1,129 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbdraw.h
+ * @defgroup fb_draw fb_draw
+ * @{
+ *
+ * Anti-aliased drawing primitives
+ *
+ * Coordinates are signed fixed point numbers with 8 fractional bits,
+ * pixel centers are at integer coordinates as in ::fb_set_pixelf_rgb().
+ * Shapes are clipped against framebuffer bounds and blended into it by
+ * coverage, so they can be drawn over any background. Filled shapes are
+ * drawn by horizontal spans, fully covered pixels are filled without
+ * blending.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBDRAW_H__
+#define __FBDRAW_H__
+
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t fb_fixed_t; ///< Fixed point coordinate, 24.8
+
+#define FB_FIXED_SHIFT 8                                    ///< Number of fractional bits
+#define FB_FIXED_ONE (1 << FB_FIXED_SHIFT)                  ///< 1.0 in fixed point
+#define FB_FIXED(v) ((fb_fixed_t)((v) * FB_FIXED_ONE))      ///< Integer or float constant to fixed point
+#define FB_FIXED_INT(v) ((int)((v) >> FB_FIXED_SHIFT))      ///< Fixed point to integer, rounded down
+
+/**
+ * @brief Draw anti-aliased point
+ *
+ * Color is spread over up to 4 pixels by subpixel position.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate
+ * @param y         Y coordinate
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_draw_point_aa(framebuffer_t *fb, fb_fixed_t x, fb_fixed_t y, rgb_t color);
+
+/**
+ * @brief Draw anti-aliased line, one pixel wide
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x0        X coordinate of start point
+ * @param y0        Y coordinate of start point
+ * @param x1        X coordinate of end point
+ * @param y1        Y coordinate of end point
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_draw_line_aa(framebuffer_t *fb, fb_fixed_t x0, fb_fixed_t y0, fb_fixed_t x1, fb_fixed_t y1,
+        rgb_t color);
+
+/**
+ * @brief Draw anti-aliased circle, one pixel wide
+ *
+ * @param fb        Framebuffer descriptor
+ * @param cx        X coordinate of center
+ * @param cy        Y coordinate of center
+ * @param r         Radius
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_draw_circle_aa(framebuffer_t *fb, fb_fixed_t cx, fb_fixed_t cy, fb_fixed_t r, rgb_t color);
+
+/**
+ * @brief Draw filled circle with anti-aliased edges
+ *
+ * @param fb        Framebuffer descriptor
+ * @param cx        X coordinate of center
+ * @param cy        Y coordinate of center
+ * @param r         Radius
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_fill_circle_aa(framebuffer_t *fb, fb_fixed_t cx, fb_fixed_t cy, fb_fixed_t r, rgb_t color);
+
+/**
+ * @brief Draw filled triangle with anti-aliased edges
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x0        X coordinate of first vertex
+ * @param y0        Y coordinate of first vertex
+ * @param x1        X coordinate of second vertex
+ * @param y1        Y coordinate of second vertex
+ * @param x2        X coordinate of third vertex
+ * @param y2        Y coordinate of third vertex
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_fill_triangle_aa(framebuffer_t *fb, fb_fixed_t x0, fb_fixed_t y0, fb_fixed_t x1, fb_fixed_t y1,
+        fb_fixed_t x2, fb_fixed_t y2, rgb_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBDRAW_H__ */
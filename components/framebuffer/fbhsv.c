@@ -0,0 +1,262 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbhsv.c
+ *
+ * HSV framebuffer plane
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <lib8tion.h>
+#include "fbhsv.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define HFB_SIZE(hfb) ((hfb)->width * (hfb)->height)
+
+static inline void mark_all(fb_hsv_t *hfb)
+{
+    fb_hsv_mark_dirty_unchecked(hfb, 0, 0, hfb->width - 1, hfb->height - 1);
+}
+
+esp_err_t fb_hsv_init(fb_hsv_t *hfb, size_t width, size_t height)
+{
+    CHECK_ARG(hfb && width && height);
+
+    hfb->width = width;
+    hfb->height = height;
+    hfb->data = calloc(HFB_SIZE(hfb), sizeof(hsv_t));
+    hfb->lut = malloc(sizeof(hsv_rainbow_lut_t));
+    if (!hfb->data || !hfb->lut)
+    {
+        fb_hsv_free(hfb);
+        return ESP_ERR_NO_MEM;
+    }
+    hsv_rainbow_lut_init(hfb->lut, 0, 0);
+    hfb->dirty = false;
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_free(fb_hsv_t *hfb)
+{
+    CHECK_ARG(hfb);
+
+    free(hfb->data);
+    free(hfb->lut);
+    hfb->data = NULL;
+    hfb->lut = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_set_pixel(fb_hsv_t *hfb, size_t x, size_t y, hsv_t color)
+{
+    CHECK_ARG(hfb && hfb->data && x < hfb->width && y < hfb->height);
+
+    *fb_hsv_pixel_unchecked(hfb, x, y) = color;
+    fb_hsv_mark_dirty_unchecked(hfb, x, y, x, y);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_get_pixel(const fb_hsv_t *hfb, size_t x, size_t y, hsv_t *color)
+{
+    CHECK_ARG(hfb && hfb->data && color && x < hfb->width && y < hfb->height);
+
+    *color = hfb->data[y * hfb->width + x];
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_fill_rect(fb_hsv_t *hfb, size_t x, size_t y, size_t w, size_t h, hsv_t color)
+{
+    CHECK_ARG(hfb && hfb->data);
+
+    if (x >= hfb->width || y >= hfb->height || !w || !h)
+        return ESP_OK;
+    if (w > hfb->width - x)
+        w = hfb->width - x;
+    if (h > hfb->height - y)
+        h = hfb->height - y;
+
+    for (size_t row = y; row < y + h; row++)
+        hsv_fill_solid_hsv(hfb->data + row * hfb->width + x, color, w);
+    fb_hsv_mark_dirty_unchecked(hfb, x, y, x + w - 1, y + h - 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_clear(fb_hsv_t *hfb)
+{
+    CHECK_ARG(hfb && hfb->data);
+
+    memset(hfb->data, 0, HFB_SIZE(hfb) * sizeof(hsv_t));
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_shift(fb_hsv_t *hfb, size_t offs, fb_shift_direction_t dir)
+{
+    CHECK_ARG(hfb && hfb->data && offs);
+
+    if (((dir == FB_SHIFT_LEFT || dir == FB_SHIFT_RIGHT) && offs >= hfb->width)
+            || ((dir == FB_SHIFT_UP || dir == FB_SHIFT_DOWN) && offs >= hfb->height))
+        return ESP_OK;
+
+    switch (dir)
+    {
+        case FB_SHIFT_LEFT:
+            for (size_t row = 0; row < hfb->height; row++)
+                memmove(hfb->data + row * hfb->width,
+                        hfb->data + row * hfb->width + offs,
+                        (hfb->width - offs) * sizeof(hsv_t));
+            break;
+        case FB_SHIFT_RIGHT:
+            for (size_t row = 0; row < hfb->height; row++)
+                memmove(hfb->data + row * hfb->width + offs,
+                        hfb->data + row * hfb->width,
+                        (hfb->width - offs) * sizeof(hsv_t));
+            break;
+        case FB_SHIFT_UP:
+            memmove(hfb->data + offs * hfb->width,
+                    hfb->data,
+                    (HFB_SIZE(hfb) - offs * hfb->width) * sizeof(hsv_t));
+            break;
+        case FB_SHIFT_DOWN:
+            memmove(hfb->data,
+                    hfb->data + offs * hfb->width,
+                    (HFB_SIZE(hfb) - offs * hfb->width) * sizeof(hsv_t));
+            break;
+    }
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_fade(fb_hsv_t *hfb, uint8_t scale)
+{
+    CHECK_ARG(hfb && hfb->data);
+
+    if (scale == 255)
+        return ESP_OK;
+    for (size_t i = 0; i < HFB_SIZE(hfb); i++)
+        hfb->data[i].val = scale8(hfb->data[i].val, scale);
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_rotate_hue(fb_hsv_t *hfb, uint8_t delta)
+{
+    CHECK_ARG(hfb && hfb->data);
+
+    if (!delta)
+        return ESP_OK;
+    for (size_t i = 0; i < HFB_SIZE(hfb); i++)
+        hfb->data[i].hue += delta;
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_desaturate(fb_hsv_t *hfb, uint8_t scale)
+{
+    CHECK_ARG(hfb && hfb->data);
+
+    if (scale == 255)
+        return ESP_OK;
+    for (size_t i = 0; i < HFB_SIZE(hfb); i++)
+        hfb->data[i].sat = scale8(hfb->data[i].sat, scale);
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_load(fb_hsv_t *hfb, const framebuffer_t *fb)
+{
+    CHECK_ARG(hfb && hfb->data && fb && fb->data
+            && fb->width == hfb->width && fb->height == hfb->height);
+
+    for (size_t y = 0; y < hfb->height; y++)
+    {
+        hsv_t *dst = hfb->data + y * hfb->width;
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, 0, y, fb->width, &first, &second);
+        rgb2hsv_approximate_array(first, dst, n);
+        if (n < fb->width)
+            rgb2hsv_approximate_array(second, dst + n, fb->width - n);
+    }
+    mark_all(hfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_convert_rows(const fb_hsv_t *hfb, size_t y, size_t rows, rgb_t *dst)
+{
+    CHECK_ARG(hfb && hfb->data && dst && y + rows <= hfb->height);
+
+    hsv2rgb_rainbow_array_lut(hfb->data + y * hfb->width, dst, rows * hfb->width, hfb->lut);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_hsv_convert(fb_hsv_t *hfb, framebuffer_t *fb)
+{
+    CHECK_ARG(hfb && hfb->data && fb && fb->data
+            && fb->width == hfb->width && fb->height == hfb->height);
+
+    if (!hfb->dirty)
+        return ESP_OK;
+
+    const fb_rect_t *r = &hfb->dirty_rect;
+    size_t len = r->x1 - r->x0 + 1;
+    if (len == hfb->width && !fb->row_origin && !fb->col_origin)
+    {
+        // Whole rows are contiguous in both buffers, convert them in one
+        // pass so the hue table can be used
+        size_t offs = r->y0 * hfb->width;
+        hsv2rgb_rainbow_array_lut(hfb->data + offs, fb->data + offs, (r->y1 - r->y0 + 1) * hfb->width, hfb->lut);
+    }
+    else
+    {
+        for (size_t y = r->y0; y <= r->y1; y++)
+        {
+            const hsv_t *src = hfb->data + y * hfb->width + r->x0;
+            rgb_t *first, *second;
+            size_t n = fb_span_unchecked(fb, r->x0, y, len, &first, &second);
+            hsv2rgb_rainbow_array_lut(src, first, n, hfb->lut);
+            if (n < len)
+                hsv2rgb_rainbow_array_lut(src + n, second, len - n, hfb->lut);
+        }
+    }
+    fb_mark_dirty_unchecked(fb, r->x0, r->y0, r->x1, r->y1);
+    hfb->dirty = false;
+
+    return ESP_OK;
+}
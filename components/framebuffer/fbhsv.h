@@ -0,0 +1,233 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbhsv.h
+ * @defgroup fb_hsv fb_hsv
+ * @{
+ *
+ * HSV framebuffer plane
+ *
+ * Every pixel is stored as ::hsv_t, so effects which work in HSV domain
+ * (hue rotation, brightness fades, saturation changes) read and modify pixels
+ * without converting them to RGB and back on every access. Frame is converted
+ * to RGB once per render with ::hsv2rgb_rainbow_array_lut(), into a regular
+ * framebuffer or directly into a renderer buffer.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBHSV_H__
+#define __FBHSV_H__
+
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * HSV framebuffer descriptor
+ */
+typedef struct
+{
+    hsv_t *data;            ///< HSV pixels, row by row
+    size_t width;           ///< Frame width
+    size_t height;          ///< Frame height
+    bool dirty;             ///< Frame was changed since last conversion
+    fb_rect_t dirty_rect;   ///< Changed region, valid if `dirty` is true
+    hsv_rainbow_lut_t *lut; ///< Internal: hue table of conversions to RGB
+} fb_hsv_t;
+
+/**
+ * @brief Extend changed region of HSV framebuffer, no checks
+ */
+static inline void fb_hsv_mark_dirty_unchecked(fb_hsv_t *hfb, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    if (!hfb->dirty)
+    {
+        hfb->dirty_rect.x0 = x0;
+        hfb->dirty_rect.y0 = y0;
+        hfb->dirty_rect.x1 = x1;
+        hfb->dirty_rect.y1 = y1;
+        hfb->dirty = true;
+        return;
+    }
+    if (x0 < hfb->dirty_rect.x0) hfb->dirty_rect.x0 = x0;
+    if (y0 < hfb->dirty_rect.y0) hfb->dirty_rect.y0 = y0;
+    if (x1 > hfb->dirty_rect.x1) hfb->dirty_rect.x1 = x1;
+    if (y1 > hfb->dirty_rect.y1) hfb->dirty_rect.y1 = y1;
+}
+
+/**
+ * @brief Pointer to pixel, no checks
+ *
+ * Changed pixels must be marked with ::fb_hsv_mark_dirty_unchecked()
+ */
+static inline hsv_t *fb_hsv_pixel_unchecked(fb_hsv_t *hfb, size_t x, size_t y)
+{
+    return hfb->data + y * hfb->width + x;
+}
+
+/**
+ * @brief Initialize HSV framebuffer, all pixels are black
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param width     Frame width in pixels
+ * @param height    Frame height in pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_init(fb_hsv_t *hfb, size_t width, size_t height);
+
+/**
+ * @brief Free HSV framebuffer
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_free(fb_hsv_t *hfb);
+
+/**
+ * @brief Set pixel
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param x         X coordinate
+ * @param y         Y coordinate
+ * @param color     HSV color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_set_pixel(fb_hsv_t *hfb, size_t x, size_t y, hsv_t color);
+
+/**
+ * @brief Get pixel
+ *
+ * @param hfb           HSV framebuffer descriptor
+ * @param x             X coordinate
+ * @param y             Y coordinate
+ * @param[out] color    HSV color
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_hsv_get_pixel(const fb_hsv_t *hfb, size_t x, size_t y, hsv_t *color);
+
+/**
+ * @brief Fill rectangle, clipped by frame
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param x         Left column
+ * @param y         Top row
+ * @param w         Width
+ * @param h         Height
+ * @param color     HSV color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_fill_rect(fb_hsv_t *hfb, size_t x, size_t y, size_t w, size_t h, hsv_t color);
+
+/**
+ * @brief Fill frame with black
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_clear(fb_hsv_t *hfb);
+
+/**
+ * @brief Shift frame, same as ::fb_shift()
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param offs      Number of pixels
+ * @param dir       Direction
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_shift(fb_hsv_t *hfb, size_t offs, fb_shift_direction_t dir);
+
+/**
+ * @brief Scale value of all pixels, hue and saturation are kept
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param scale     Scale, 255 - no change
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_fade(fb_hsv_t *hfb, uint8_t scale);
+
+/**
+ * @brief Add offset to hue of all pixels
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param delta     Hue offset, wraps around
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_rotate_hue(fb_hsv_t *hfb, uint8_t delta);
+
+/**
+ * @brief Scale saturation of all pixels
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param scale     Scale, 255 - no change
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_desaturate(fb_hsv_t *hfb, uint8_t scale);
+
+/**
+ * @brief Load pixels from RGB framebuffer
+ *
+ * Framebuffer must have the same size. Pixels are converted with
+ * ::rgb2hsv_approximate_array(), so the result is approximate.
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param fb        RGB framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_load(fb_hsv_t *hfb, const framebuffer_t *fb);
+
+/**
+ * @brief Convert rows into RGB buffer
+ *
+ * For renderers which write frame directly into output buffer.
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param y         First row
+ * @param rows      Number of rows
+ * @param[out] dst  Buffer of `rows * width` pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_convert_rows(const fb_hsv_t *hfb, size_t y, size_t rows, rgb_t *dst);
+
+/**
+ * @brief Convert changed region into RGB framebuffer
+ *
+ * Framebuffer must have the same size. Changed region is marked dirty
+ * in `fb` and the HSV framebuffer becomes clean, so ::fb_render() sends
+ * only the changed part.
+ *
+ * @param hfb       HSV framebuffer descriptor
+ * @param fb        RGB framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_hsv_convert(fb_hsv_t *hfb, framebuffer_t *fb);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBHSV_H__ */
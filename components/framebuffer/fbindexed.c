@@ -0,0 +1,256 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbindexed.c
+ *
+ * Palette-indexed framebuffer
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <lib8tion.h>
+#include "fbindexed.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define IFB_SIZE(ifb) ((ifb)->width * (ifb)->height)
+
+static inline void mark_all(fb_indexed_t *ifb)
+{
+    fb_indexed_mark_dirty_unchecked(ifb, 0, 0, ifb->width - 1, ifb->height - 1);
+}
+
+esp_err_t fb_indexed_init(fb_indexed_t *ifb, size_t width, size_t height, const rgb_t *palette)
+{
+    CHECK_ARG(ifb && width && height);
+
+    ifb->width = width;
+    ifb->height = height;
+    ifb->palette = palette;
+    ifb->data = calloc(1, IFB_SIZE(ifb));
+    if (!ifb->data)
+        return ESP_ERR_NO_MEM;
+    ifb->dirty = false;
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_free(fb_indexed_t *ifb)
+{
+    CHECK_ARG(ifb);
+
+    free(ifb->data);
+    ifb->data = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_set_palette(fb_indexed_t *ifb, const rgb_t *palette)
+{
+    CHECK_ARG(ifb && ifb->data && palette);
+
+    ifb->palette = palette;
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_set_pixel(fb_indexed_t *ifb, size_t x, size_t y, uint8_t index)
+{
+    CHECK_ARG(ifb && ifb->data && x < ifb->width && y < ifb->height);
+
+    uint8_t *p = fb_indexed_pixel_unchecked(ifb, x, y);
+    if (*p == index)
+        return ESP_OK;
+    *p = index;
+    fb_indexed_mark_dirty_unchecked(ifb, x, y, x, y);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_get_pixel(const fb_indexed_t *ifb, size_t x, size_t y, uint8_t *index)
+{
+    CHECK_ARG(ifb && ifb->data && index && x < ifb->width && y < ifb->height);
+
+    *index = ifb->data[y * ifb->width + x];
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_fill_rect(fb_indexed_t *ifb, size_t x, size_t y, size_t w, size_t h, uint8_t index)
+{
+    CHECK_ARG(ifb && ifb->data);
+
+    if (x >= ifb->width || y >= ifb->height || !w || !h)
+        return ESP_OK;
+    if (w > ifb->width - x)
+        w = ifb->width - x;
+    if (h > ifb->height - y)
+        h = ifb->height - y;
+
+    for (size_t row = y; row < y + h; row++)
+        memset(ifb->data + row * ifb->width + x, index, w);
+    fb_indexed_mark_dirty_unchecked(ifb, x, y, x + w - 1, y + h - 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_clear(fb_indexed_t *ifb)
+{
+    CHECK_ARG(ifb && ifb->data);
+
+    memset(ifb->data, 0, IFB_SIZE(ifb));
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_shift(fb_indexed_t *ifb, size_t offs, fb_shift_direction_t dir)
+{
+    CHECK_ARG(ifb && ifb->data && offs);
+
+    if (((dir == FB_SHIFT_LEFT || dir == FB_SHIFT_RIGHT) && offs >= ifb->width)
+            || ((dir == FB_SHIFT_UP || dir == FB_SHIFT_DOWN) && offs >= ifb->height))
+        return ESP_OK;
+
+    switch (dir)
+    {
+        case FB_SHIFT_LEFT:
+            for (size_t row = 0; row < ifb->height; row++)
+                memmove(ifb->data + row * ifb->width,
+                        ifb->data + row * ifb->width + offs,
+                        ifb->width - offs);
+            break;
+        case FB_SHIFT_RIGHT:
+            for (size_t row = 0; row < ifb->height; row++)
+                memmove(ifb->data + row * ifb->width + offs,
+                        ifb->data + row * ifb->width,
+                        ifb->width - offs);
+            break;
+        case FB_SHIFT_UP:
+            memmove(ifb->data + offs * ifb->width,
+                    ifb->data,
+                    IFB_SIZE(ifb) - offs * ifb->width);
+            break;
+        case FB_SHIFT_DOWN:
+            memmove(ifb->data,
+                    ifb->data + offs * ifb->width,
+                    IFB_SIZE(ifb) - offs * ifb->width);
+            break;
+    }
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_fade(fb_indexed_t *ifb, uint8_t scale)
+{
+    CHECK_ARG(ifb && ifb->data);
+
+    if (scale == 255)
+        return ESP_OK;
+    for (size_t i = 0; i < IFB_SIZE(ifb); i++)
+        ifb->data[i] = scale8(ifb->data[i], scale);
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+// blur1d over indices placed `stride` apart
+static void blur_line(uint8_t *p, size_t num, size_t stride, uint8_t keep, uint8_t seep)
+{
+    uint8_t carryover = 0;
+    uint8_t *prev = NULL;
+    for (size_t i = 0; i < num; ++i, p += stride)
+    {
+        uint8_t cur = *p;
+        uint8_t part = scale8(cur, seep);
+        cur = qadd8(scale8(cur, keep), carryover);
+        if (prev)
+            *prev = qadd8(*prev, part);
+        *p = cur;
+        carryover = part;
+        prev = p;
+    }
+}
+
+esp_err_t fb_indexed_blur2d(fb_indexed_t *ifb, fract8 amount)
+{
+    CHECK_ARG(ifb && ifb->data);
+
+    if (!amount)
+        return ESP_OK;
+
+    uint8_t keep = 255 - amount;
+    uint8_t seep = amount >> 1;
+    for (size_t row = 0; row < ifb->height; row++)
+        blur_line(ifb->data + row * ifb->width, ifb->width, 1, keep, seep);
+    for (size_t col = 0; col < ifb->width; col++)
+        blur_line(ifb->data + col, ifb->height, ifb->width, keep, seep);
+    mark_all(ifb);
+
+    return ESP_OK;
+}
+
+static inline void expand(const rgb_t *palette, const uint8_t *src, rgb_t *dst, size_t num)
+{
+    for (size_t i = 0; i < num; i++)
+        dst[i] = palette[src[i]];
+}
+
+esp_err_t fb_indexed_expand_rows(const fb_indexed_t *ifb, size_t y, size_t rows, rgb_t *dst)
+{
+    CHECK_ARG(ifb && ifb->data && ifb->palette && dst && y + rows <= ifb->height);
+
+    expand(ifb->palette, ifb->data + y * ifb->width, dst, rows * ifb->width);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_indexed_expand(fb_indexed_t *ifb, framebuffer_t *fb)
+{
+    CHECK_ARG(ifb && ifb->data && ifb->palette && fb && fb->data
+            && fb->width == ifb->width && fb->height == ifb->height);
+
+    if (!ifb->dirty)
+        return ESP_OK;
+
+    const fb_rect_t *r = &ifb->dirty_rect;
+    size_t len = r->x1 - r->x0 + 1;
+    for (size_t y = r->y0; y <= r->y1; y++)
+    {
+        const uint8_t *src = ifb->data + y * ifb->width + r->x0;
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, r->x0, y, len, &first, &second);
+        expand(ifb->palette, src, first, n);
+        if (n < len)
+            expand(ifb->palette, src + n, second, len - n);
+    }
+    fb_mark_dirty_unchecked(fb, r->x0, r->y0, r->x1, r->y1);
+    ifb->dirty = false;
+
+    return ESP_OK;
+}
@@ -0,0 +1,230 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbindexed.h
+ * @defgroup fb_indexed fb_indexed
+ * @{
+ *
+ * Palette-indexed framebuffer
+ *
+ * Every pixel is an 8-bit index into a 256-entry RGB palette, so frame
+ * takes a third of RGB framebuffer memory and shifting, filling and blurring
+ * touch three times less bytes. Frame is expanded to RGB only when rendered,
+ * into a regular framebuffer or directly into a renderer buffer.
+ *
+ * Blur and fade work on indices, so they make sense for palettes which
+ * are gradients from index 0 (heat maps, fire, brightness ramps).
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBINDEXED_H__
+#define __FBINDEXED_H__
+
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FB_INDEXED_PALETTE_SIZE 256 ///< Number of palette entries
+
+/**
+ * Indexed framebuffer descriptor
+ */
+typedef struct
+{
+    uint8_t *data;          ///< Palette indices, row by row
+    size_t width;           ///< Frame width
+    size_t height;          ///< Frame height
+    const rgb_t *palette;   ///< Palette of ::FB_INDEXED_PALETTE_SIZE entries, not copied
+    bool dirty;             ///< Frame was changed since last expansion
+    fb_rect_t dirty_rect;   ///< Changed region, valid if `dirty` is true
+} fb_indexed_t;
+
+/**
+ * @brief Extend changed region of indexed framebuffer, no checks
+ */
+static inline void fb_indexed_mark_dirty_unchecked(fb_indexed_t *ifb, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    if (!ifb->dirty)
+    {
+        ifb->dirty_rect.x0 = x0;
+        ifb->dirty_rect.y0 = y0;
+        ifb->dirty_rect.x1 = x1;
+        ifb->dirty_rect.y1 = y1;
+        ifb->dirty = true;
+        return;
+    }
+    if (x0 < ifb->dirty_rect.x0) ifb->dirty_rect.x0 = x0;
+    if (y0 < ifb->dirty_rect.y0) ifb->dirty_rect.y0 = y0;
+    if (x1 > ifb->dirty_rect.x1) ifb->dirty_rect.x1 = x1;
+    if (y1 > ifb->dirty_rect.y1) ifb->dirty_rect.y1 = y1;
+}
+
+/**
+ * @brief Pointer to pixel index, no checks
+ *
+ * Changed pixels must be marked with ::fb_indexed_mark_dirty_unchecked()
+ */
+static inline uint8_t *fb_indexed_pixel_unchecked(fb_indexed_t *ifb, size_t x, size_t y)
+{
+    return ifb->data + y * ifb->width + x;
+}
+
+/**
+ * @brief Initialize indexed framebuffer
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param width     Frame width in pixels
+ * @param height    Frame height in pixels
+ * @param palette   Palette of ::FB_INDEXED_PALETTE_SIZE entries, e.g. `table`
+ *                  of ::color_palette16_t. Not copied, may be NULL
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_init(fb_indexed_t *ifb, size_t width, size_t height, const rgb_t *palette);
+
+/**
+ * @brief Free indexed framebuffer
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_free(fb_indexed_t *ifb);
+
+/**
+ * @brief Set palette
+ *
+ * Whole frame is marked dirty. Call it also after changing entries of
+ * the current palette.
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param palette   Palette of ::FB_INDEXED_PALETTE_SIZE entries, not copied
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_set_palette(fb_indexed_t *ifb, const rgb_t *palette);
+
+/**
+ * @brief Set pixel index
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param x         X coordinate
+ * @param y         Y coordinate
+ * @param index     Palette index
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_set_pixel(fb_indexed_t *ifb, size_t x, size_t y, uint8_t index);
+
+/**
+ * @brief Get pixel index
+ *
+ * @param ifb           Indexed framebuffer descriptor
+ * @param x             X coordinate
+ * @param y             Y coordinate
+ * @param[out] index    Palette index
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_indexed_get_pixel(const fb_indexed_t *ifb, size_t x, size_t y, uint8_t *index);
+
+/**
+ * @brief Fill rectangle, clipped by frame
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param x         Left column
+ * @param y         Top row
+ * @param w         Width
+ * @param h         Height
+ * @param index     Palette index
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_fill_rect(fb_indexed_t *ifb, size_t x, size_t y, size_t w, size_t h, uint8_t index);
+
+/**
+ * @brief Fill frame with index 0
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_clear(fb_indexed_t *ifb);
+
+/**
+ * @brief Shift frame, same as ::fb_shift()
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param offs      Number of pixels
+ * @param dir       Direction
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_shift(fb_indexed_t *ifb, size_t offs, fb_shift_direction_t dir);
+
+/**
+ * @brief Scale all indices down toward 0
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param scale     Scale, 255 - no change
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_fade(fb_indexed_t *ifb, uint8_t scale);
+
+/**
+ * @brief Blur indices to 8 XY neighbors, same algorithm as ::fb_blur2d()
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param amount    Blur amount
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_blur2d(fb_indexed_t *ifb, fract8 amount);
+
+/**
+ * @brief Expand rows into RGB buffer
+ *
+ * For renderers which write frame directly into output buffer.
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param y         First row
+ * @param rows      Number of rows
+ * @param[out] dst  Buffer of `rows * width` pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_expand_rows(const fb_indexed_t *ifb, size_t y, size_t rows, rgb_t *dst);
+
+/**
+ * @brief Expand changed region into RGB framebuffer
+ *
+ * Framebuffer must have the same size. Changed region is marked dirty
+ * in `fb` and the indexed framebuffer becomes clean, so ::fb_render() sends
+ * only the changed part.
+ *
+ * @param ifb       Indexed framebuffer descriptor
+ * @param fb        RGB framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_indexed_expand(fb_indexed_t *ifb, framebuffer_t *fb);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBINDEXED_H__ */
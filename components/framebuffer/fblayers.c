@@ -0,0 +1,185 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fblayers.c
+ *
+ * Layered framebuffer compositor
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <lib8tion.h>
+#include "fblayers.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+#define CHECK(x) do { esp_err_t __; if ((__ = (x)) != ESP_OK) return __; } while (0)
+
+// Layers are rendered by compositor only
+static esp_err_t layer_render(framebuffer_t *fb, void *arg)
+{
+    return ESP_OK;
+}
+
+esp_err_t fb_layers_init(fb_layers_t *layers, framebuffer_t *out, size_t count)
+{
+    CHECK_ARG(layers && out && out->data && count);
+
+    layers->layers = calloc(count, sizeof(fb_layer_t));
+    if (!layers->layers)
+        return ESP_ERR_NO_MEM;
+    layers->out = out;
+    layers->count = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        fb_layer_t *l = &layers->layers[i];
+        esp_err_t res = fb_init(&l->fb, out->width, out->height, layer_render);
+        if (res != ESP_OK)
+        {
+            fb_free(&l->fb);
+            fb_layers_free(layers);
+            return res;
+        }
+        l->mode = FB_BLEND_ALPHA;
+        l->opacity = 255;
+        l->visible = true;
+        layers->count++;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fb_layers_free(fb_layers_t *layers)
+{
+    CHECK_ARG(layers);
+
+    for (size_t i = 0; i < layers->count; i++)
+        fb_free(&layers->layers[i].fb);
+    free(layers->layers);
+    layers->layers = NULL;
+    layers->count = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_layers_invalidate(fb_layers_t *layers)
+{
+    CHECK_ARG(layers && layers->count);
+
+    framebuffer_t *fb = &layers->layers[0].fb;
+    return fb_mark_dirty(fb, 0, 0, fb->width - 1, fb->height - 1);
+}
+
+static inline rgb_t blend_pixel(rgb_t dst, rgb_t src, fb_blend_mode_t mode, uint8_t opacity)
+{
+    switch (mode)
+    {
+        case FB_BLEND_ADD:
+            dst.r = qadd8(dst.r, scale8(src.r, opacity));
+            dst.g = qadd8(dst.g, scale8(src.g, opacity));
+            dst.b = qadd8(dst.b, scale8(src.b, opacity));
+            break;
+        case FB_BLEND_MAX:
+            src.r = scale8(src.r, opacity);
+            src.g = scale8(src.g, opacity);
+            src.b = scale8(src.b, opacity);
+            if (src.r > dst.r) dst.r = src.r;
+            if (src.g > dst.g) dst.g = src.g;
+            if (src.b > dst.b) dst.b = src.b;
+            break;
+        case FB_BLEND_MULTIPLY:
+            // Opacity 0 multiplies by white
+            dst.r = scale8(dst.r, blend8(255, src.r, opacity));
+            dst.g = scale8(dst.g, blend8(255, src.g, opacity));
+            dst.b = scale8(dst.b, blend8(255, src.b, opacity));
+            break;
+        default:
+            dst.r = blend8(dst.r, src.r, opacity);
+            dst.g = blend8(dst.g, src.g, opacity);
+            dst.b = blend8(dst.b, src.b, opacity);
+    }
+    return dst;
+}
+
+static void blend_span(rgb_t *dst, const rgb_t *src, size_t len, const fb_layer_t *l)
+{
+    if (l->mode == FB_BLEND_ALPHA && l->opacity == 255)
+    {
+        memcpy(dst, src, len * sizeof(rgb_t));
+        return;
+    }
+    for (size_t x = 0; x < len; x++)
+        dst[x] = blend_pixel(dst[x], src[x], l->mode, l->opacity);
+}
+
+esp_err_t fb_layers_compose(fb_layers_t *layers)
+{
+    CHECK_ARG(layers && layers->out && layers->count);
+
+    // Union of changed regions
+    bool dirty = false;
+    fb_rect_t r = { 0 };
+    for (size_t i = 0; i < layers->count; i++)
+    {
+        framebuffer_t *fb = &layers->layers[i].fb;
+        if (!fb->dirty)
+            continue;
+        if (!dirty)
+            r = fb->dirty_rect;
+        else
+        {
+            if (fb->dirty_rect.x0 < r.x0) r.x0 = fb->dirty_rect.x0;
+            if (fb->dirty_rect.y0 < r.y0) r.y0 = fb->dirty_rect.y0;
+            if (fb->dirty_rect.x1 > r.x1) r.x1 = fb->dirty_rect.x1;
+            if (fb->dirty_rect.y1 > r.y1) r.y1 = fb->dirty_rect.y1;
+        }
+        dirty = true;
+        fb->dirty = false;
+    }
+    if (!dirty)
+        return ESP_OK;
+
+    framebuffer_t *out = layers->out;
+    CHECK(fb_compact(out));
+    for (size_t y = r.y0; y <= r.y1; y++)
+    {
+        rgb_t *dst = out->data + FB_OFFSET(out, r.x0, y);
+        size_t len = r.x1 - r.x0 + 1;
+        memset(dst, 0, len * sizeof(rgb_t));
+        for (size_t i = 0; i < layers->count; i++)
+        {
+            fb_layer_t *l = &layers->layers[i];
+            if (!l->visible)
+                continue;
+            rgb_t *first, *second;
+            size_t n = fb_span_unchecked(&l->fb, r.x0, y, len, &first, &second);
+            blend_span(dst, first, n, l);
+            if (n < len)
+                blend_span(dst + n, second, len - n, l);
+        }
+    }
+
+    return fb_mark_dirty(out, r.x0, r.y0, r.x1, r.y1);
+}
@@ -0,0 +1,128 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fblayers.h
+ * @defgroup fb_layers fb_layers
+ * @{
+ *
+ * Layered framebuffer compositor
+ *
+ * Every layer is a regular framebuffer, so all framebuffer drawing
+ * functions can be used on it. Layers are blended bottom to top into
+ * the output framebuffer, only the region changed since last composition
+ * is recalculated.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBLAYERS_H__
+#define __FBLAYERS_H__
+
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Layer blend mode
+ */
+typedef enum {
+    FB_BLEND_ALPHA = 0, ///< Linear interpolation to layer color by opacity
+    FB_BLEND_ADD,       ///< Saturating addition of layer color scaled by opacity
+    FB_BLEND_MAX,       ///< Maximum of channels, layer color scaled by opacity
+    FB_BLEND_MULTIPLY,  ///< Multiplication by layer color, strength set by opacity
+} fb_blend_mode_t;
+
+/**
+ * Framebuffer layer
+ */
+typedef struct
+{
+    framebuffer_t fb;      ///< Layer framebuffer, draw on it
+    fb_blend_mode_t mode;  ///< Blend mode, call ::fb_layers_invalidate() after change
+    uint8_t opacity;       ///< Layer opacity, call ::fb_layers_invalidate() after change
+    bool visible;          ///< Layer visibility, call ::fb_layers_invalidate() after change
+} fb_layer_t;
+
+/**
+ * Layers compositor descriptor
+ */
+typedef struct
+{
+    framebuffer_t *out;    ///< Output framebuffer
+    size_t count;          ///< Number of layers
+    fb_layer_t *layers;    ///< Layers, 0 is bottom one
+} fb_layers_t;
+
+/**
+ * @brief Allocate layers of the output framebuffer size
+ *
+ * Layers are created visible, opaque, with ::FB_BLEND_ALPHA mode and
+ * black pixels. Black is transparent for ::FB_BLEND_ADD and ::FB_BLEND_MAX
+ * modes only.
+ *
+ * @param layers    Compositor descriptor
+ * @param out       Output framebuffer
+ * @param count     Number of layers
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_layers_init(fb_layers_t *layers, framebuffer_t *out, size_t count);
+
+/**
+ * @brief Free layers
+ *
+ * @param layers    Compositor descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_layers_free(fb_layers_t *layers);
+
+/**
+ * @brief Mark whole frame for recomposition
+ *
+ * Must be called after change of layer mode, opacity or visibility.
+ *
+ * @param layers    Compositor descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_layers_invalidate(fb_layers_t *layers);
+
+/**
+ * @brief Blend changed regions of layers into output framebuffer
+ *
+ * Bounding rectangle of regions changed in all layers is recalculated.
+ * If no layer was changed, output framebuffer is left untouched, so
+ * ::fb_render() skips the frame. Layers must not be drawn during the call.
+ *
+ * @param layers    Compositor descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_layers_compose(fb_layers_t *layers);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBLAYERS_H__ */
@@ -0,0 +1,201 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbrgb16.c
+ *
+ * Framebuffer with 16 bits per channel
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "fbrgb16.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define WFB_SIZE(wfb) ((wfb)->width * (wfb)->height)
+
+static inline void mark_all(fb_rgb16_t *wfb)
+{
+    fb_rgb16_mark_dirty_unchecked(wfb, 0, 0, wfb->width - 1, wfb->height - 1);
+}
+
+esp_err_t fb_rgb16_init(fb_rgb16_t *wfb, size_t width, size_t height)
+{
+    CHECK_ARG(wfb && width && height);
+
+    wfb->width = width;
+    wfb->height = height;
+    wfb->data = calloc(WFB_SIZE(wfb), sizeof(rgb16_t));
+    if (!wfb->data)
+        return ESP_ERR_NO_MEM;
+    wfb->dither = true;
+    wfb->frame = 0;
+    wfb->dirty = false;
+    mark_all(wfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_free(fb_rgb16_t *wfb)
+{
+    CHECK_ARG(wfb);
+
+    free(wfb->data);
+    wfb->data = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_set_pixel(fb_rgb16_t *wfb, size_t x, size_t y, rgb16_t color)
+{
+    CHECK_ARG(wfb && wfb->data && x < wfb->width && y < wfb->height);
+
+    *fb_rgb16_pixel_unchecked(wfb, x, y) = color;
+    fb_rgb16_mark_dirty_unchecked(wfb, x, y, x, y);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_get_pixel(const fb_rgb16_t *wfb, size_t x, size_t y, rgb16_t *color)
+{
+    CHECK_ARG(wfb && wfb->data && color && x < wfb->width && y < wfb->height);
+
+    *color = wfb->data[y * wfb->width + x];
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_fill_rect(fb_rgb16_t *wfb, size_t x, size_t y, size_t w, size_t h, rgb16_t color)
+{
+    CHECK_ARG(wfb && wfb->data);
+
+    if (x >= wfb->width || y >= wfb->height || !w || !h)
+        return ESP_OK;
+    if (w > wfb->width - x)
+        w = wfb->width - x;
+    if (h > wfb->height - y)
+        h = wfb->height - y;
+
+    for (size_t row = y; row < y + h; row++)
+    {
+        rgb16_t *p = wfb->data + row * wfb->width + x;
+        for (size_t i = 0; i < w; i++)
+            p[i] = color;
+    }
+    fb_rgb16_mark_dirty_unchecked(wfb, x, y, x + w - 1, y + h - 1);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_clear(fb_rgb16_t *wfb)
+{
+    CHECK_ARG(wfb && wfb->data);
+
+    memset(wfb->data, 0, WFB_SIZE(wfb) * sizeof(rgb16_t));
+    mark_all(wfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_fade(fb_rgb16_t *wfb, uint16_t scale)
+{
+    CHECK_ARG(wfb && wfb->data);
+
+    if (scale == 65535)
+        return ESP_OK;
+    rgb16_nscale16_array(wfb->data, WFB_SIZE(wfb), scale);
+    mark_all(wfb);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_blur2d(fb_rgb16_t *wfb, fract8 amount)
+{
+    CHECK_ARG(wfb && wfb->data);
+
+    if (!amount)
+        return ESP_OK;
+    blur2d_rgb16(wfb->data, wfb->width, wfb->height, amount);
+    mark_all(wfb);
+
+    return ESP_OK;
+}
+
+static void convert(const rgb16_t *src, rgb_t *dst, size_t num, bool dither, uint8_t frame)
+{
+    if (dither)
+    {
+        rgb16_to_rgb_dither_array(src, dst, num, frame);
+        return;
+    }
+    for (size_t i = 0; i < num; i++)
+        dst[i] = rgb16_to_rgb(src[i]);
+}
+
+esp_err_t fb_rgb16_convert_rows(const fb_rgb16_t *wfb, size_t y, size_t rows, uint8_t frame, rgb_t *dst)
+{
+    CHECK_ARG(wfb && wfb->data && dst && y + rows <= wfb->height);
+
+    if (!wfb->dither)
+    {
+        convert(wfb->data + y * wfb->width, dst, rows * wfb->width, false, 0);
+        return ESP_OK;
+    }
+    for (size_t row = y; row < y + rows; row++, dst += wfb->width)
+        convert(wfb->data + row * wfb->width, dst, wfb->width, true, frame + row * 3);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_rgb16_convert(fb_rgb16_t *wfb, framebuffer_t *fb)
+{
+    CHECK_ARG(wfb && wfb->data && fb && fb->data
+            && fb->width == wfb->width && fb->height == wfb->height);
+
+    // Dithered output changes every frame even if pixels don't
+    if (wfb->dither)
+        mark_all(wfb);
+    if (!wfb->dirty)
+        return ESP_OK;
+
+    const fb_rect_t *r = &wfb->dirty_rect;
+    size_t len = r->x1 - r->x0 + 1;
+    for (size_t y = r->y0; y <= r->y1; y++)
+    {
+        const rgb16_t *src = wfb->data + y * wfb->width + r->x0;
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, r->x0, y, len, &first, &second);
+        // Offset by row keeps thresholds of vertical neighbors different
+        uint8_t frame = wfb->frame + y * 3;
+        convert(src, first, n, wfb->dither, frame);
+        if (n < len)
+            convert(src + n, second, len - n, wfb->dither, frame + n);
+    }
+    fb_mark_dirty_unchecked(fb, r->x0, r->y0, r->x1, r->y1);
+    wfb->dirty = false;
+    wfb->frame++;
+
+    return ESP_OK;
+}
@@ -0,0 +1,208 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file fbrgb16.h
+ * @defgroup fb_rgb16 fb_rgb16
+ * @{
+ *
+ * Framebuffer with 16 bits per channel
+ *
+ * Pixels are ::rgb16_t, so trails made of many consecutive fades and blurs
+ * keep smooth gradients down to black instead of stepping and stalling at
+ * 8-bit quantization levels. Frame is converted to 8-bit RGB framebuffer with
+ * temporal dithering when rendered.
+ *
+ * Frame takes twice as much memory as RGB framebuffer.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __FBRGB16_H__
+#define __FBRGB16_H__
+
+#include "framebuffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 16-bit framebuffer descriptor
+ */
+typedef struct
+{
+    rgb16_t *data;          ///< Pixels, row by row
+    size_t width;           ///< Frame width
+    size_t height;          ///< Frame height
+    bool dither;            ///< Dither on conversion, true by default. Whole frame
+                            ///< is converted on every call then, not only changed region
+    uint8_t frame;          ///< Internal: dithering frame counter
+    bool dirty;             ///< Frame was changed since last conversion
+    fb_rect_t dirty_rect;   ///< Changed region, valid if `dirty` is true
+} fb_rgb16_t;
+
+/**
+ * @brief Extend changed region of 16-bit framebuffer, no checks
+ */
+static inline void fb_rgb16_mark_dirty_unchecked(fb_rgb16_t *wfb, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    if (!wfb->dirty)
+    {
+        wfb->dirty_rect.x0 = x0;
+        wfb->dirty_rect.y0 = y0;
+        wfb->dirty_rect.x1 = x1;
+        wfb->dirty_rect.y1 = y1;
+        wfb->dirty = true;
+        return;
+    }
+    if (x0 < wfb->dirty_rect.x0) wfb->dirty_rect.x0 = x0;
+    if (y0 < wfb->dirty_rect.y0) wfb->dirty_rect.y0 = y0;
+    if (x1 > wfb->dirty_rect.x1) wfb->dirty_rect.x1 = x1;
+    if (y1 > wfb->dirty_rect.y1) wfb->dirty_rect.y1 = y1;
+}
+
+/**
+ * @brief Pointer to pixel, no checks
+ *
+ * Changed pixels must be marked with ::fb_rgb16_mark_dirty_unchecked()
+ */
+static inline rgb16_t *fb_rgb16_pixel_unchecked(fb_rgb16_t *wfb, size_t x, size_t y)
+{
+    return wfb->data + y * wfb->width + x;
+}
+
+/**
+ * @brief Initialize 16-bit framebuffer, all pixels are black
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param width     Frame width in pixels
+ * @param height    Frame height in pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_init(fb_rgb16_t *wfb, size_t width, size_t height);
+
+/**
+ * @brief Free 16-bit framebuffer
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_free(fb_rgb16_t *wfb);
+
+/**
+ * @brief Set pixel
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param x         X coordinate
+ * @param y         Y coordinate
+ * @param color     Color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_set_pixel(fb_rgb16_t *wfb, size_t x, size_t y, rgb16_t color);
+
+/**
+ * @brief Get pixel
+ *
+ * @param wfb           16-bit framebuffer descriptor
+ * @param x             X coordinate
+ * @param y             Y coordinate
+ * @param[out] color    Color
+ * @return              ESP_OK on success
+ */
+esp_err_t fb_rgb16_get_pixel(const fb_rgb16_t *wfb, size_t x, size_t y, rgb16_t *color);
+
+/**
+ * @brief Fill rectangle, clipped by frame
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param x         Left column
+ * @param y         Top row
+ * @param w         Width
+ * @param h         Height
+ * @param color     Color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_fill_rect(fb_rgb16_t *wfb, size_t x, size_t y, size_t w, size_t h, rgb16_t color);
+
+/**
+ * @brief Fill frame with black
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_clear(fb_rgb16_t *wfb);
+
+/**
+ * @brief Scale all pixels, see ::rgb16_scale()
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param scale     Scale, 65535 - no change
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_fade(fb_rgb16_t *wfb, uint16_t scale);
+
+/**
+ * @brief Blur pixels to 8 XY neighbors, same algorithm as ::fb_blur2d()
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param amount    Blur amount
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_blur2d(fb_rgb16_t *wfb, fract8 amount);
+
+/**
+ * @brief Convert rows into RGB buffer
+ *
+ * For renderers which write frame directly into output buffer. Frame
+ * counter is not incremented, pass the same `frame` for all rows of frame.
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param y         First row
+ * @param rows      Number of rows
+ * @param frame     Dithering frame counter, ignored if `dither` is false
+ * @param[out] dst  Buffer of `rows * width` pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_convert_rows(const fb_rgb16_t *wfb, size_t y, size_t rows, uint8_t frame, rgb_t *dst);
+
+/**
+ * @brief Convert frame into RGB framebuffer
+ *
+ * Framebuffer must have the same size. When dithering is enabled the whole
+ * frame is converted and marked dirty on every call, so call it for every
+ * rendered frame, at 100 Hz or more. Otherwise only changed region is
+ * converted with rounding.
+ *
+ * @param wfb       16-bit framebuffer descriptor
+ * @param fb        RGB framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_rgb16_convert(fb_rgb16_t *wfb, framebuffer_t *fb);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __FBRGB16_H__ */
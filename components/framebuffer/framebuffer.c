@@ -31,33 +31,114 @@
  * MIT Licensed as described in the file LICENSE
  */
 #include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#if !defined(CONFIG_IDF_TARGET_ESP8266)
+#include <esp_heap_caps.h>
+#endif
 #include "framebuffer.h"
 
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 #define CHECK(x) do { esp_err_t __; if ((__ = (x)) != ESP_OK) return __; } while (0)
 
-static size_t xy(void *ctx, size_t x, size_t y)
+static inline void mark_all(framebuffer_t *fb)
 {
-    framebuffer_t *fb = (framebuffer_t *)ctx;
-    return y * fb->width + x;
+    fb_mark_dirty_unchecked(fb, 0, 0, fb->width - 1, fb->height - 1);
+}
+
+static inline void set_pixel(framebuffer_t *fb, size_t x, size_t y, rgb_t color)
+{
+    rgb_t *p = fb->data + fb_pixel_offset(fb, x, y);
+    if (p->r == color.r && p->g == color.g && p->b == color.b)
+        return;
+    *p = color;
+    fb_mark_dirty_unchecked(fb, x, y, x, y);
+}
+
+static const char *TAG = "framebuffer";
+
+// `latest` of triple buffer mode: buffer index and flag of a frame not rendered yet
+#define TRIPLE_INDEX 0x03
+#define TRIPLE_FRESH 0x04
+
+static void *alloc_data(size_t size, fb_alloc_t alloc)
+{
+#if defined(CONFIG_IDF_TARGET_ESP8266)
+    // no PSRAM, everything is internal
+    return alloc == FB_ALLOC_PSRAM ? NULL : calloc(1, size);
+#else
+    void *res;
+    switch (alloc)
+    {
+        case FB_ALLOC_INTERNAL:
+            return heap_caps_calloc(1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+        case FB_ALLOC_PSRAM:
+            return heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        case FB_ALLOC_PREFER_INTERNAL:
+            res = heap_caps_calloc(1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            return res ? res : heap_caps_calloc(1, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        default:
+            return calloc(1, size);
+    }
+#endif
 }
 
 esp_err_t fb_init(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb)
 {
-    CHECK_ARG(fb && width && height && render_cb);
+    return fb_init_caps(fb, width, height, render_cb, FB_ALLOC_DEFAULT);
+}
 
+static esp_err_t init_descriptor(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb)
+{
     fb->width = width;
     fb->height = height;
     fb->frame_num = 0;
     fb->last_frame_us = 0;
     fb->render = render_cb;
+    fb->render_always = false;
     fb->internal = NULL;
+    fb->map = NULL;
+    fb->map_allocated = false;
+    fb->gamma = NULL;
+    fb->ring = false;
+    fb->row_origin = 0;
+    fb->col_origin = 0;
+    fb->rows_dispatch = NULL;
+    fb->rows_ctx = NULL;
+    fb->data = NULL;
+    fb->data_allocated = false;
+    memset(fb->triple, 0, sizeof(fb->triple));
+    // Send initial black frame
+    fb->dirty = false;
+    mark_all(fb);
     fb->mutex = xSemaphoreCreateMutex();
-    if (!fb->mutex)
-        return ESP_ERR_NO_MEM;
-    fb->data = calloc(1, FB_SIZE(fb));
+
+    return fb->mutex ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t fb_init_caps(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb, fb_alloc_t alloc)
+{
+    CHECK_ARG(fb && width && height && render_cb);
+
+    CHECK(init_descriptor(fb, width, height, render_cb));
+    fb->data = alloc_data(FB_SIZE(fb), alloc);
     if (!fb->data)
+    {
+        ESP_LOGE(TAG, "Could not allocate %u bytes for frame", (unsigned)FB_SIZE(fb));
         return ESP_ERR_NO_MEM;
+    }
+    fb->data_allocated = true;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_init_static(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb, rgb_t *data)
+{
+    CHECK_ARG(fb && width && height && render_cb && data);
+
+    CHECK(init_descriptor(fb, width, height, render_cb));
+    fb->data = data;
+    memset(fb->data, 0, FB_SIZE(fb));
 
     return ESP_OK;
 }
@@ -66,10 +147,316 @@ esp_err_t fb_free(framebuffer_t *fb)
 {
     CHECK_ARG(fb);
 
-    if (fb->data)
+    if (fb->triple[0])
+    {
+        free(fb->triple[1]);
+        free(fb->triple[2]);
+        // Buffer of init is the first one
+        fb->data = fb->triple[0];
+        memset(fb->triple, 0, sizeof(fb->triple));
+    }
+    if (fb->data_allocated)
         free(fb->data);
+    fb->data = NULL;
+    fb->data_allocated = false;
     if (fb->mutex)
         vSemaphoreDelete(fb->mutex);
+    if (fb->map_allocated)
+        free((void *)fb->map);
+    fb->map = NULL;
+    fb->map_allocated = false;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_strip_init(fb_strip_t *strip, framebuffer_t *fb, size_t rows)
+{
+    CHECK_ARG(strip && fb && rows && rows <= fb->height);
+
+    strip->fb = fb;
+    strip->rows = rows;
+    strip->y0 = 0;
+    strip->count = 0;
+    strip->data = alloc_data(rows * fb->width * sizeof(rgb_t), FB_ALLOC_INTERNAL);
+    if (!strip->data)
+    {
+        ESP_LOGE(TAG, "Could not allocate strip of %u rows", (unsigned)rows);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fb_strip_free(fb_strip_t *strip)
+{
+    CHECK_ARG(strip);
+
+    free(strip->data);
+    strip->data = NULL;
+    strip->rows = strip->count = 0;
+
+    return ESP_OK;
+}
+
+// copy rows between strip and framebuffer, resolving ring origin
+static void strip_copy(fb_strip_t *strip, bool store)
+{
+    framebuffer_t *fb = strip->fb;
+    rgb_t *line = strip->data;
+
+    for (size_t y = strip->y0; y < strip->y0 + strip->count; y++, line += fb->width)
+    {
+        rgb_t *first, *second;
+        size_t len = fb_span_unchecked(fb, 0, y, fb->width, &first, &second);
+        if (store)
+        {
+            memcpy(first, line, len * sizeof(rgb_t));
+            if (len < fb->width)
+                memcpy(second, line + len, (fb->width - len) * sizeof(rgb_t));
+        }
+        else
+        {
+            memcpy(line, first, len * sizeof(rgb_t));
+            if (len < fb->width)
+                memcpy(line + len, second, (fb->width - len) * sizeof(rgb_t));
+        }
+    }
+}
+
+esp_err_t fb_strip_load(fb_strip_t *strip, size_t y0, size_t count)
+{
+    CHECK_ARG(strip && strip->data && count && count <= strip->rows && y0 + count <= strip->fb->height);
+
+    strip->y0 = y0;
+    strip->count = count;
+    strip_copy(strip, false);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_strip_store(fb_strip_t *strip)
+{
+    CHECK_ARG(strip && strip->data);
+
+    if (!strip->count)
+        return ESP_OK;
+
+    strip_copy(strip, true);
+    fb_mark_dirty_unchecked(strip->fb, 0, strip->y0, strip->fb->width - 1, strip->y0 + strip->count - 1);
+
+    return ESP_OK;
+}
+
+static size_t tile_index(uint32_t flags, size_t w, size_t h, size_t x, size_t y)
+{
+    if (flags & FB_MAP_MIRROR_X)
+        x = w - 1 - x;
+    if (flags & FB_MAP_MIRROR_Y)
+        y = h - 1 - y;
+
+    size_t line = y, pos = x, line_len = w;
+    if (flags & FB_MAP_COLUMNS)
+    {
+        line = x;
+        pos = y;
+        line_len = h;
+    }
+    if ((flags & FB_MAP_SERPENTINE) && (line & 1))
+        pos = line_len - 1 - pos;
+
+    return line * line_len + pos;
+}
+
+esp_err_t fb_map_init(framebuffer_t *fb, uint32_t flags, size_t tile_w, size_t tile_h)
+{
+    CHECK_ARG(fb && fb->width * fb->height <= UINT16_MAX + 1);
+    if (!tile_w || !tile_h)
+    {
+        tile_w = fb->width;
+        tile_h = fb->height;
+    }
+    CHECK_ARG(fb->width % tile_w == 0 && fb->height % tile_h == 0);
+
+    uint16_t *map = malloc(fb->width * fb->height * sizeof(uint16_t));
+    if (!map)
+        return ESP_ERR_NO_MEM;
+
+    size_t tiles_x = fb->width / tile_w;
+    for (size_t y = 0; y < fb->height; y++)
+        for (size_t x = 0; x < fb->width; x++)
+        {
+            size_t tile = (y / tile_h) * tiles_x + x / tile_w;
+            map[FB_OFFSET(fb, x, y)] = tile * tile_w * tile_h
+                    + tile_index(flags, tile_w, tile_h, x % tile_w, y % tile_h);
+        }
+
+    CHECK(fb_map_set(fb, map));
+    fb->map_allocated = true;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_map_set(framebuffer_t *fb, const uint16_t *map)
+{
+    CHECK_ARG(fb);
+
+    if (fb->map_allocated)
+        free((void *)fb->map);
+    fb->map = map;
+    fb->map_allocated = false;
+
+    return ESP_OK;
+}
+
+static void reverse(rgb_t *p, size_t len)
+{
+    for (rgb_t *q = p + len - 1; p < q; p++, q--)
+    {
+        rgb_t t = *p;
+        *p = *q;
+        *q = t;
+    }
+}
+
+// Rotate array left by `k` pixels in place
+static void rotate(rgb_t *p, size_t len, size_t k)
+{
+    if (!k)
+        return;
+    reverse(p, k);
+    reverse(p + k, len - k);
+    reverse(p, len);
+}
+
+esp_err_t fb_ring_enable(framebuffer_t *fb, bool enable)
+{
+    CHECK_ARG(fb && fb->data);
+    if (enable && fb->triple[0])
+        return ESP_ERR_INVALID_STATE;
+
+    if (!enable)
+        CHECK(fb_compact(fb));
+    fb->ring = enable;
+
+    return ESP_OK;
+}
+
+esp_err_t fb_triple_enable(framebuffer_t *fb, fb_alloc_t alloc)
+{
+    CHECK_ARG(fb && fb->data);
+    if (fb->ring || fb->triple[0])
+        return ESP_ERR_INVALID_STATE;
+
+    for (int i = 1; i < 3; i++)
+    {
+        fb->triple[i] = alloc_data(FB_SIZE(fb), alloc);
+        if (!fb->triple[i])
+        {
+            ESP_LOGE(TAG, "Could not allocate %u bytes for frame", (unsigned)FB_SIZE(fb));
+            free(fb->triple[1]);
+            fb->triple[1] = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(fb->triple[i], fb->data, FB_SIZE(fb));
+    }
+    fb->triple[0] = fb->data;
+    fb->back = 0;
+    fb->front = 1;
+    // Current content is the first frame to render
+    fb->latest = 2 | TRIPLE_FRESH;
+
+    return ESP_OK;
+}
+
+// Publish drawn frame and continue drawing on its copy
+static void triple_publish(framebuffer_t *fb)
+{
+    rgb_t *done = fb->data;
+    fb->back = __atomic_exchange_n(&fb->latest, fb->back | TRIPLE_FRESH, __ATOMIC_ACQ_REL) & TRIPLE_INDEX;
+    fb->data = fb->triple[fb->back];
+    // Renderer may read the published frame meanwhile, both only read it
+    memcpy(fb->data, done, FB_SIZE(fb));
+}
+
+static esp_err_t triple_render(framebuffer_t *fb, void *render_ctx)
+{
+    if (__atomic_load_n(&fb->latest, __ATOMIC_ACQUIRE) & TRIPLE_FRESH)
+        fb->front = __atomic_exchange_n(&fb->latest, fb->front, __ATOMIC_ACQ_REL) & TRIPLE_INDEX;
+    else if (!fb->render_always)
+        return ESP_OK;
+
+    // Drawing state of the descriptor belongs to producers
+    framebuffer_t view = *fb;
+    view.data = fb->triple[fb->front];
+    view.dirty = false;
+    mark_all(&view);
+
+    return view.render(&view, render_ctx);
+}
+
+esp_err_t fb_compact(framebuffer_t *fb)
+{
+    CHECK_ARG(fb && fb->data);
+
+    if (fb->row_origin)
+        rotate(fb->data, fb->width * fb->height, fb->row_origin * fb->width);
+    if (fb->col_origin)
+        for (size_t y = 0; y < fb->height; y++)
+            rotate(fb->data + FB_OFFSET(fb, 0, y), fb->width, fb->col_origin);
+    fb->row_origin = 0;
+    fb->col_origin = 0;
+
+    return ESP_OK;
+}
+
+// Copy `len` pixels starting from logical index `i` to output
+static void remap_span(const framebuffer_t *fb, const rgb_t *src, rgb_t *dst, size_t i, size_t len)
+{
+    if (!fb->map)
+    {
+        if (fb->gamma)
+            color_gamma_apply_array(fb->gamma, src, dst + i, len);
+        else
+            memcpy(dst + i, src, len * sizeof(rgb_t));
+        return;
+    }
+    const uint16_t *map = fb->map + i;
+    if (fb->gamma)
+        for (size_t k = 0; k < len; k++)
+            dst[map[k]] = color_gamma_apply(fb->gamma, src[k]);
+    else
+        for (size_t k = 0; k < len; k++)
+            dst[map[k]] = src[k];
+}
+
+esp_err_t fb_remap(framebuffer_t *fb, rgb_t *dst)
+{
+    CHECK_ARG(fb && fb->data && dst);
+
+    if (!fb->row_origin && !fb->col_origin)
+    {
+        remap_span(fb, fb->data, dst, 0, fb->width * fb->height);
+        return ESP_OK;
+    }
+    // Ring mode: every logical row is one or two physical spans
+    for (size_t y = 0; y < fb->height; y++)
+    {
+        rgb_t *first, *second;
+        size_t i = y * fb->width;
+        size_t len = fb_span_unchecked(fb, 0, y, fb->width, &first, &second);
+        remap_span(fb, first, dst, i, len);
+        if (len < fb->width)
+            remap_span(fb, second, dst, i + len, fb->width - len);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t fb_gamma_set(framebuffer_t *fb, const color_gamma_t *gamma)
+{
+    CHECK_ARG(fb);
+
+    fb->gamma = gamma;
 
     return ESP_OK;
 }
@@ -78,10 +465,30 @@ esp_err_t fb_render(framebuffer_t *fb, void *render_ctx)
 {
     CHECK_ARG(fb && fb->data && fb->render);
 
+    if (fb->triple[0])
+        return triple_render(fb, render_ctx);
+
     if (xSemaphoreTake(fb->mutex, 0) != pdTRUE)
         return ESP_ERR_INVALID_STATE;
-    CHECK(fb->render(fb, render_ctx));
+    if (!fb->dirty && !fb->render_always)
+    {
+        xSemaphoreGive(fb->mutex);
+        return ESP_OK;
+    }
+    esp_err_t res = fb->render(fb, render_ctx);
+    if (res == ESP_OK)
+        fb->dirty = false;
     xSemaphoreGive(fb->mutex);
+    CHECK(res);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_mark_dirty(framebuffer_t *fb, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    CHECK_ARG(fb && x0 <= x1 && y0 <= y1 && x1 < fb->width && y1 < fb->height);
+
+    fb_mark_dirty_unchecked(fb, x0, y0, x1, y1);
 
     return ESP_OK;
 }
@@ -90,7 +497,7 @@ esp_err_t fb_set_pixel_rgb(framebuffer_t *fb, size_t x, size_t y, rgb_t color)
 {
     CHECK_ARG(fb && fb->data && x < fb->width && y < fb->height);
 
-    fb->data[FB_OFFSET(fb, x, y)] = color;
+    set_pixel(fb, x, y, color);
 
     return ESP_OK;
 }
@@ -99,7 +506,7 @@ esp_err_t fb_set_pixel_hsv(framebuffer_t *fb, size_t x, size_t y, hsv_t color)
 {
     CHECK_ARG(fb && fb->data && x < fb->width && y < fb->height);
 
-    fb->data[FB_OFFSET(fb, x, y)] = hsv2rgb_rainbow(color);
+    set_pixel(fb, x, y, hsv2rgb_rainbow(color));
 
     return ESP_OK;
 }
@@ -108,7 +515,7 @@ esp_err_t fb_get_pixel_rgb(framebuffer_t *fb, size_t x, size_t y, rgb_t *color)
 {
     CHECK_ARG(color && fb && fb->data && x < fb->width && y < fb->height);
 
-    *color = fb->data[FB_OFFSET(fb, x, y)];
+    *color = fb->data[fb_pixel_offset(fb, x, y)];
 
     return ESP_OK;
 }
@@ -117,7 +524,7 @@ esp_err_t fb_get_pixel_hsv(framebuffer_t *fb, size_t x, size_t y, hsv_t *color)
 {
     CHECK_ARG(color && fb && fb->data && x < fb->width && y < fb->height);
 
-    *color = rgb2hsv_approximate(fb->data[FB_OFFSET(fb, x, y)]);
+    *color = rgb2hsv_approximate(fb->data[fb_pixel_offset(fb, x, y)]);
 
     return ESP_OK;
 }
@@ -162,11 +569,43 @@ esp_err_t fb_set_pixelf_hsv(framebuffer_t *fb, float x, float y, hsv_t color)
     return fb_set_pixelf_rgb(fb, x, y, hsv2rgb_rainbow(color));
 }
 
+esp_err_t fb_write_span(framebuffer_t *fb, size_t x, size_t y, const rgb_t *data, size_t len)
+{
+    CHECK_ARG(fb && fb->data && data && len && y < fb->height && x + len <= fb->width);
+
+    rgb_t *first, *second;
+    size_t n = fb_span_unchecked(fb, x, y, len, &first, &second);
+    memcpy(first, data, n * sizeof(rgb_t));
+    if (n < len)
+        memcpy(second, data + n, (len - n) * sizeof(rgb_t));
+    fb_mark_dirty_unchecked(fb, x, y, x + len - 1, y);
+
+    return ESP_OK;
+}
+
+esp_err_t fb_fill_rect(framebuffer_t *fb, size_t x, size_t y, size_t w, size_t h, rgb_t color)
+{
+    CHECK_ARG(fb && fb->data && w && h && x + w <= fb->width && y + h <= fb->height);
+
+    for (size_t i = 0; i < h; i++)
+    {
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, x, y + i, w, &first, &second);
+        rgb_fill_solid_rgb(first, color, n);
+        if (n < w)
+            rgb_fill_solid_rgb(second, color, w - n);
+    }
+    fb_mark_dirty_unchecked(fb, x, y, x + w - 1, y + h - 1);
+
+    return ESP_OK;
+}
+
 esp_err_t fb_clear(framebuffer_t *fb)
 {
     CHECK_ARG(fb && fb->data);
 
     memset(fb->data, 0, FB_SIZE(fb));
+    mark_all(fb);
 
     return ESP_OK;
 }
@@ -179,6 +618,27 @@ esp_err_t fb_shift(framebuffer_t *fb, size_t offs, fb_shift_direction_t dir)
             || ((dir == FB_SHIFT_UP || dir == FB_SHIFT_DOWN) && offs >= fb->height))
         return ESP_OK;
 
+    if (fb->ring)
+    {
+        switch (dir)
+        {
+            case FB_SHIFT_LEFT:
+                fb->col_origin = (fb->col_origin + offs) % fb->width;
+                break;
+            case FB_SHIFT_RIGHT:
+                fb->col_origin = (fb->col_origin + fb->width - offs) % fb->width;
+                break;
+            case FB_SHIFT_UP:
+                fb->row_origin = (fb->row_origin + fb->height - offs) % fb->height;
+                break;
+            case FB_SHIFT_DOWN:
+                fb->row_origin = (fb->row_origin + offs) % fb->height;
+                break;
+        }
+        mark_all(fb);
+        return ESP_OK;
+    }
+
     switch (dir)
     {
         case FB_SHIFT_LEFT:
@@ -204,6 +664,7 @@ esp_err_t fb_shift(framebuffer_t *fb, size_t offs, fb_shift_direction_t dir)
                     FB_SIZE(fb) - offs * fb->width * sizeof(rgb_t));
             break;
     }
+    mark_all(fb);
 
     return ESP_OK;
 }
@@ -212,8 +673,16 @@ esp_err_t fb_fade(framebuffer_t *fb, uint8_t scale)
 {
     CHECK_ARG(fb && fb->data);
 
-    for (size_t i = 0; i < fb->width * fb->height; i++)
-        fb->data[i] = rgb_fade(fb->data[i], scale);
+    if (!scale)
+        return ESP_OK;
+    // Black frame stays unchanged
+    size_t i = 0;
+    while (i < fb->width * fb->height && rgb_is_zero(fb->data[i]))
+        i++;
+    if (i == fb->width * fb->height)
+        return ESP_OK;
+    rgb_fade_to_black_array(fb->data, fb->width * fb->height, scale);
+    mark_all(fb);
 
     return ESP_OK;
 }
@@ -222,7 +691,11 @@ esp_err_t fb_blur2d(framebuffer_t *fb, fract8 amount)
 {
     CHECK_ARG(fb && fb->data);
 
-    blur2d(fb->data, fb->width, fb->height, amount, xy, fb);
+    if (amount)
+        CHECK(fb_compact(fb));
+    blur2d(fb->data, fb->width, fb->height, amount, NULL, NULL);
+    if (amount)
+        mark_all(fb);
 
     return ESP_OK;
 }
@@ -237,12 +710,28 @@ esp_err_t fb_begin(framebuffer_t *fb)
     return ESP_OK;
 }
 
+esp_err_t fb_draw_rows(framebuffer_t *fb, fb_draw_rows_cb_t rows)
+{
+    CHECK_ARG(fb && fb->data && rows);
+
+    mark_all(fb);
+    if (fb->rows_dispatch && fb->height > 1)
+        return fb->rows_dispatch(fb, rows, fb->rows_ctx);
+
+    return rows(fb, 0, fb->height);
+}
+
 esp_err_t fb_end(framebuffer_t *fb)
 {
     CHECK_ARG(fb);
 
     fb->frame_num++;
     fb->last_frame_us = esp_timer_get_time();
+    if (fb->triple[0])
+    {
+        triple_publish(fb);
+        fb->dirty = false;
+    }
     xSemaphoreGive(fb->mutex);
 
     return ESP_OK;
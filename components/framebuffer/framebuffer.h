@@ -48,6 +48,11 @@ extern "C" {
 
 #define FB_SIZE(fb) ((fb)->width * (fb)->height * sizeof(rgb_t))
 
+/**
+ * Size of frame data in bytes for ::fb_init_static()
+ */
+#define FB_BUFFER_SIZE(width, height) ((width) * (height) * sizeof(rgb_t))
+
 typedef enum {
     FB_SHIFT_LEFT  = 0,
     FB_SHIFT_RIGHT,
@@ -55,6 +60,37 @@ typedef enum {
     FB_SHIFT_DOWN
 } fb_shift_direction_t;
 
+/**
+ * Rectangular framebuffer region, coordinates are inclusive
+ */
+typedef struct
+{
+    size_t x0; ///< Left column
+    size_t y0; ///< Top row
+    size_t x1; ///< Right column
+    size_t y1; ///< Bottom row
+} fb_rect_t;
+
+/**
+ * Flags of physical pixel layout, see ::fb_map_init()
+ */
+typedef enum {
+    FB_MAP_SERPENTINE = (1 << 0), ///< Every second line goes in reverse direction (zig-zag)
+    FB_MAP_MIRROR_X   = (1 << 1), ///< First physical pixel is on the right
+    FB_MAP_MIRROR_Y   = (1 << 2), ///< First physical pixel is at the bottom
+    FB_MAP_COLUMNS    = (1 << 3), ///< Physical lines are columns, not rows
+} fb_map_flags_t;
+
+/**
+ * Memory for framebuffer data, see ::fb_init_caps()
+ */
+typedef enum {
+    FB_ALLOC_DEFAULT = 0,     ///< Default heap, data may end up in PSRAM if malloc() uses it
+    FB_ALLOC_INTERNAL,        ///< Internal RAM only
+    FB_ALLOC_PSRAM,           ///< External PSRAM only
+    FB_ALLOC_PREFER_INTERNAL, ///< Internal RAM if there is enough of it, PSRAM otherwise
+} fb_alloc_t;
+
 typedef struct framebuffer_s framebuffer_t;
 
 /**
@@ -62,6 +98,17 @@ typedef struct framebuffer_s framebuffer_t;
  */
 typedef esp_err_t (*fb_render_cb_t)(framebuffer_t *fb, void *arg);
 
+/**
+ * Draw function of rows `y0`..`y1 - 1`, see ::fb_draw_rows()
+ */
+typedef esp_err_t (*fb_draw_rows_cb_t)(framebuffer_t *fb, size_t y0, size_t y1);
+
+/**
+ * Executor of ::fb_draw_rows() which splits the frame into row ranges
+ * and draws them in parallel
+ */
+typedef esp_err_t (*fb_rows_dispatch_cb_t)(framebuffer_t *fb, fb_draw_rows_cb_t rows, void *ctx);
+
 /**
  * Framebuffer descriptor descriptor
  */
@@ -73,10 +120,111 @@ struct framebuffer_s
     size_t frame_num;              ///< Number of rendered frames
     uint64_t last_frame_us;        ///< Time of last rendered frame since boot in microseconds
     fb_render_cb_t render;         ///< See ::fb_render()
+    bool render_always;            ///< Call renderer even if framebuffer was not changed
+    bool dirty;                    ///< Framebuffer was changed since last render
+    fb_rect_t dirty_rect;          ///< Changed region, valid if `dirty` is true. Renderers
+                                   ///< can use it to send only changed part of frame
     uint8_t *internal;             ///< Buffer for effect settings, internal vars, palettes and so on
+    const uint16_t *map;           ///< Physical index of every logical pixel or NULL, see ::fb_remap()
+    bool map_allocated;            ///< Internal: map was allocated by ::fb_map_init()
+    bool data_allocated;           ///< Internal: data was allocated by ::fb_init_caps()
+    const color_gamma_t *gamma;    ///< Gamma tables applied by ::fb_remap() or NULL, see ::fb_gamma_set()
+    bool ring;                     ///< Scrolling moves origin instead of pixels, see ::fb_ring_enable()
+    size_t row_origin;             ///< Internal: physical row of logical row 0
+    size_t col_origin;             ///< Internal: physical column of logical column 0
+    fb_rows_dispatch_cb_t rows_dispatch; ///< Parallel executor of ::fb_draw_rows() or NULL
+    void *rows_ctx;                ///< Argument of `rows_dispatch`
+    rgb_t *triple[3];              ///< Internal: buffers of triple buffer mode, see ::fb_triple_enable()
+    uint8_t front;                 ///< Internal: buffer being rendered in triple buffer mode
+    uint8_t back;                  ///< Internal: buffer being drawn (`data`) in triple buffer mode
+    uint8_t latest;                ///< Internal: last complete frame and its fresh flag, swapped atomically
     SemaphoreHandle_t mutex;
 };
 
+/**
+ * @brief Extend changed region of framebuffer, no checks
+ */
+static inline void fb_mark_dirty_unchecked(framebuffer_t *fb, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    if (!fb->dirty)
+    {
+        fb->dirty_rect.x0 = x0;
+        fb->dirty_rect.y0 = y0;
+        fb->dirty_rect.x1 = x1;
+        fb->dirty_rect.y1 = y1;
+        fb->dirty = true;
+        return;
+    }
+    if (x0 < fb->dirty_rect.x0) fb->dirty_rect.x0 = x0;
+    if (y0 < fb->dirty_rect.y0) fb->dirty_rect.y0 = y0;
+    if (x1 > fb->dirty_rect.x1) fb->dirty_rect.x1 = x1;
+    if (y1 > fb->dirty_rect.y1) fb->dirty_rect.y1 = y1;
+}
+
+/**
+ * @brief Offset of logical pixel in `data`, no checks
+ *
+ * Offset differs from ::FB_OFFSET() only in ring mode after scrolling,
+ * see ::fb_ring_enable().
+ */
+static inline size_t fb_pixel_offset(const framebuffer_t *fb, size_t x, size_t y)
+{
+    x += fb->col_origin;
+    if (x >= fb->width)
+        x -= fb->width;
+    y += fb->row_origin;
+    if (y >= fb->height)
+        y -= fb->height;
+    return FB_OFFSET(fb, x, y);
+}
+
+/**
+ * @brief Physical location of horizontal span of pixels, no checks
+ *
+ * In ring mode span may wrap around the right edge of `data`, then it
+ * consists of two parts: `*first` of returned length and `*second` of
+ * the rest. Span must fit into the row.
+ *
+ * @param fb           Framebuffer descriptor
+ * @param x            X coordinate of first pixel
+ * @param y            Y coordinate
+ * @param len          Number of pixels
+ * @param[out] first   First part of span
+ * @param[out] second  Second part of span, used only if returned length is less than `len`
+ * @return             Length of first part
+ */
+static inline size_t fb_span_unchecked(const framebuffer_t *fb, size_t x, size_t y, size_t len,
+                                       rgb_t **first, rgb_t **second)
+{
+    size_t offs = fb_pixel_offset(fb, x, y);
+    size_t col = offs % fb->width;
+    *first = fb->data + offs;
+    *second = fb->data + (offs - col);
+    return len <= fb->width - col ? len : fb->width - col;
+}
+
+/**
+ * @brief Pointer to framebuffer pixel, no checks
+ *
+ * Changed pixels must be marked with ::fb_mark_dirty_unchecked()
+ */
+static inline rgb_t *fb_pixel_unchecked(framebuffer_t *fb, size_t x, size_t y)
+{
+    return fb->data + fb_pixel_offset(fb, x, y);
+}
+
+/**
+ * @brief Set RGB color of framebuffer pixel, no checks
+ *
+ * Fast version of ::fb_set_pixel_rgb() for use between ::fb_begin() and
+ * ::fb_end(). Coordinates must be inside framebuffer.
+ */
+static inline void fb_set_pixel_rgb_unchecked(framebuffer_t *fb, size_t x, size_t y, rgb_t color)
+{
+    fb->data[fb_pixel_offset(fb, x, y)] = color;
+    fb_mark_dirty_unchecked(fb, x, y, x, y);
+}
+
 /**
  * @brief Initialize framebuffer
  *
@@ -89,6 +237,42 @@ struct framebuffer_s
  */
 esp_err_t fb_init(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb);
 
+/**
+ * @brief Initialize framebuffer with data in specific memory
+ *
+ * Per-pixel access to PSRAM goes through the flash/PSRAM cache and is several
+ * times slower than to internal RAM. Small frames should be kept in internal
+ * RAM, large ones in PSRAM processed with ::fb_strip_t.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param width     Frame width in pixels
+ * @param height    Frame height in pixels
+ * @param render_cb Renderer callback function
+ * @param alloc     Memory for frame data
+ *
+ * @return          ESP_OK on success, ESP_ERR_NO_MEM if there is no memory
+ *                  of requested type
+ */
+esp_err_t fb_init_caps(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb, fb_alloc_t alloc);
+
+/**
+ * @brief Initialize framebuffer with caller-provided frame data
+ *
+ * Frame data is not allocated, so it can be a static array placed at link
+ * time in internal RAM, DMA-capable memory or PSRAM (`EXT_RAM_ATTR`).
+ * Data is cleared by this function and is not freed by ::fb_free().
+ * Only the mutex of the framebuffer is created on the heap.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param width     Frame width in pixels
+ * @param height    Frame height in pixels
+ * @param render_cb Renderer callback function
+ * @param data      Frame data, ::FB_BUFFER_SIZE(width, height) bytes
+ *
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_init_static(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t render_cb, rgb_t *data);
+
 /**
  * @brief Free Framebuffer descriptor buffers
  *
@@ -97,11 +281,184 @@ esp_err_t fb_init(framebuffer_t *fb, size_t width, size_t height, fb_render_cb_t
  */
 esp_err_t fb_free(framebuffer_t *fb);
 
+/**
+ * Working copy of framebuffer rows in internal RAM
+ *
+ * Effects running over a framebuffer in PSRAM can load a strip of rows,
+ * work on it with ::fb_strip_pixel() and store it back. Rows are copied
+ * in whole lines, so PSRAM is accessed sequentially instead of by random
+ * pixels in the hot loop.
+ */
+typedef struct
+{
+    framebuffer_t *fb;  ///< Framebuffer descriptor
+    rgb_t *data;        ///< Rows in internal RAM
+    size_t rows;        ///< Capacity of strip, rows
+    size_t y0;          ///< First loaded row
+    size_t count;       ///< Number of loaded rows
+} fb_strip_t;
+
+/**
+ * @brief Allocate strip of rows in internal RAM
+ *
+ * @param strip     Strip descriptor
+ * @param fb        Framebuffer descriptor
+ * @param rows      Capacity in rows
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_strip_init(fb_strip_t *strip, framebuffer_t *fb, size_t rows);
+
+/**
+ * @brief Free strip
+ *
+ * @param strip     Strip descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_strip_free(fb_strip_t *strip);
+
+/**
+ * @brief Copy rows of framebuffer to strip
+ *
+ * @param strip     Strip descriptor
+ * @param y0        First row
+ * @param count     Number of rows, not more than capacity
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_strip_load(fb_strip_t *strip, size_t y0, size_t count);
+
+/**
+ * @brief Copy strip back to framebuffer
+ *
+ * Loaded rows are marked dirty.
+ *
+ * @param strip     Strip descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_strip_store(fb_strip_t *strip);
+
+/**
+ * @brief Pointer to pixel of loaded strip, no checks
+ *
+ * `y` is the row of framebuffer, it must be loaded.
+ */
+static inline rgb_t *fb_strip_pixel(fb_strip_t *strip, size_t x, size_t y)
+{
+    return strip->data + (y - strip->y0) * strip->fb->width + x;
+}
+
+/**
+ * @brief Build physical layout table of framebuffer
+ *
+ * Matrix may consist of equal tiles, ordered left to right and top to
+ * bottom, each tile has layout described by flags. Rotation by 90 degrees
+ * is ::FB_MAP_COLUMNS combined with one of mirror flags.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param flags     Combination of ::fb_map_flags_t
+ * @param tile_w    Width of the tile, 0 if matrix is not tiled
+ * @param tile_h    Height of the tile, 0 if matrix is not tiled
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_map_init(framebuffer_t *fb, uint32_t flags, size_t tile_w, size_t tile_h);
+
+/**
+ * @brief Set custom physical layout table of framebuffer
+ *
+ * Table is not copied and can be placed in flash (declared `const`).
+ * Previous table built by ::fb_map_init() is freed.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param map       Table of `width * height` physical indexes in logical
+ *                  row-major order, NULL for identity layout
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_map_set(framebuffer_t *fb, const uint16_t *map);
+
+/**
+ * @brief Set gamma correction of rendered frames
+ *
+ * Tables are not copied. Correction is applied by ::fb_remap() on the way
+ * to the output buffer, framebuffer data stays linear, so effects that
+ * read pixels back (fade, blur) are not affected.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param gamma     Gamma tables built by ::color_gamma_init(), NULL to disable
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_gamma_set(framebuffer_t *fb, const color_gamma_t *gamma);
+
+/**
+ * @brief Enable or disable ring mode
+ *
+ * In ring mode ::fb_shift() does not move pixels, it only moves the origin
+ * of the frame inside `data`, so scrolling costs O(1) regardless of
+ * framebuffer size. All functions of this module resolve the origin,
+ * ::fb_remap() does it in the same pass as layout remapping. Code which
+ * reads or writes `data` directly must use ::fb_pixel_offset(),
+ * ::fb_span_unchecked() or call ::fb_compact() first.
+ *
+ * Disabling ring mode compacts the framebuffer.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param enable    true to enable ring mode
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_ring_enable(framebuffer_t *fb, bool enable);
+
+/**
+ * @brief Enable triple buffer mode
+ *
+ * Two more buffers are allocated. Producers draw into `data` between
+ * ::fb_begin() and ::fb_end() as usual, ::fb_end() publishes the frame by
+ * an atomic index swap and continues drawing on a copy of it. ::fb_render()
+ * takes the latest complete frame by another swap and passes the renderer
+ * callback a copy of the descriptor with `data` pointing to it, so the
+ * renderer and producers never wait for each other and frames drawn
+ * faster than they are rendered are dropped. The mutex serializes
+ * producers only.
+ *
+ * The renderer always gets the whole frame marked dirty. Ring mode can't
+ * be used with triple buffering. Call before the producer and renderer
+ * tasks are started, the mode stays enabled until ::fb_free().
+ *
+ * @param fb        Framebuffer descriptor
+ * @param alloc     Memory of additional buffers
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_triple_enable(framebuffer_t *fb, fb_alloc_t alloc);
+
+/**
+ * @brief Move pixels so that logical origin is at the start of `data`
+ *
+ * Rotates `data` in place in O(width * height), without additional memory.
+ * Does nothing if origin is already at the start of `data`.
+ *
+ * @param fb        Framebuffer descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_compact(framebuffer_t *fb);
+
+/**
+ * @brief Copy framebuffer to physical order in one pass
+ *
+ * Call it from renderer callback to get the frame in the order of the
+ * actual LEDs. Drawing functions always operate in logical coordinates.
+ * Gamma correction set by ::fb_gamma_set() is applied in the same pass.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param[out] dst  Buffer of `width * height` pixels
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_remap(framebuffer_t *fb, rgb_t *dst);
+
 /**
  * @brief Render frambuffer to actual display or LED strip
  *
  * Rendering is performed by calling the callback function with passing
- * it as arguments \p fb and \p ctx
+ * it as arguments \p fb and \p ctx. If framebuffer was not changed since
+ * last render and `render_always` is false, callback is not called.
+ * In triple buffer mode only frames completed by ::fb_end() are rendered,
+ * see ::fb_triple_enable().
  *
  * @param fb   Framebuffer descriptor
  * @param ctx  Argument to pass to callback
@@ -109,6 +466,21 @@ esp_err_t fb_free(framebuffer_t *fb);
  */
 esp_err_t fb_render(framebuffer_t *fb, void *ctx);
 
+/**
+ * @brief Mark framebuffer region as changed
+ *
+ * Functions of this module mark changed regions themselves, call this
+ * after changing `data` directly.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x0        Left column
+ * @param y0        Top row
+ * @param x1        Right column, inclusive
+ * @param y1        Bottom row, inclusive
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_mark_dirty(framebuffer_t *fb, size_t x0, size_t y0, size_t x1, size_t y1);
+
 /**
  * @brief Set RGB color of framebuffer pixel
  *
@@ -175,6 +547,31 @@ esp_err_t fb_get_pixel_rgb(framebuffer_t *fb, size_t x, size_t y, rgb_t *color);
  */
 esp_err_t fb_get_pixel_hsv(framebuffer_t *fb, size_t x, size_t y, hsv_t *color);
 
+/**
+ * @brief Copy RGB colors to horizontal span of pixels
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate of first pixel
+ * @param y         Y coordinate
+ * @param data      Colors
+ * @param len       Number of pixels, span must fit into the row
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_write_span(framebuffer_t *fb, size_t x, size_t y, const rgb_t *data, size_t len);
+
+/**
+ * @brief Fill rectangle with RGB color
+ *
+ * @param fb        Framebuffer descriptor
+ * @param x         X coordinate of top left corner
+ * @param y         Y coordinate of top left corner
+ * @param w         Width, rectangle must fit into framebuffer
+ * @param h         Height, rectangle must fit into framebuffer
+ * @param color     RGB color
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_fill_rect(framebuffer_t *fb, size_t x, size_t y, size_t w, size_t h, rgb_t color);
+
 /**
  * @brief Clear framebuffer
  *
@@ -186,6 +583,9 @@ esp_err_t fb_clear(framebuffer_t *fb);
 /**
  * @brief Shift framebuffer
  *
+ * Uncovered lines keep their old content in normal mode and get the lines
+ * shifted out in ring mode, effects must redraw them.
+ *
  * @param fb        Framebuffer descriptor
  * @param offs      Shift size
  * @param dir       Shift direction
@@ -207,6 +607,8 @@ esp_err_t fb_fade(framebuffer_t *fb, uint8_t scale);
 /**
  * @brief Aplly two-dimensional blur filter on framebuffer
  *
+ * Framebuffer in ring mode is compacted first, see ::fb_compact().
+ *
  * Spreads light to 8 XY neighbors.
  *
  *   0 = no spread at all
@@ -231,6 +633,24 @@ esp_err_t fb_blur2d(framebuffer_t *fb, fract8 amount);
  */
 esp_err_t fb_begin(framebuffer_t *fb);
 
+/**
+ * @brief Draw frame by row ranges
+ *
+ * Used between ::fb_begin() and ::fb_end() by effects whose rows don't
+ * depend on each other. Per-frame state must be updated before the call,
+ * `rows` may be called concurrently for different ranges (see
+ * ::fb_animation_split_enable()), so it must only write its own rows with
+ * unchecked functions and must not lock the framebuffer. Whole frame is
+ * marked dirty.
+ *
+ * Without executor `rows` is called once for the whole frame.
+ *
+ * @param fb        Framebuffer descriptor
+ * @param rows      Draw function of row range
+ * @return          ESP_OK on success
+ */
+esp_err_t fb_draw_rows(framebuffer_t *fb, fb_draw_rows_cb_t rows);
+
 /**
  * @brief Finish frame rendering
  *
@@ -0,0 +1,2 @@
+COMPONENT_ADD_INCLUDEDIRS = .
+COMPONENT_DEPENDS = freertos i2cdev log esp_idf_lib_helpers mcp23008 pcf8574 pcf8575 tca95x5
@@ -0,0 +1,512 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file gpio_expander.c
+ *
+ * Common interface of GPIO expanders
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <esp_idf_lib_helpers.h>
+#include <esp_attr.h>
+#include <esp_log.h>
+#include <mcp23008.h>
+#include <pcf8574.h>
+#include <pcf8575.h>
+#include <tca95x5.h>
+#if !HELPER_TARGET_IS_ESP8266
+#include <mcp23x17.h>
+#endif
+#include "gpio_expander.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "gpio_expander";
+
+#define SEQ_CHUNK 16
+
+#define LOCK(exp) xSemaphoreTakeRecursive((exp)->lock, portMAX_DELAY)
+#define UNLOCK(exp) xSemaphoreGiveRecursive((exp)->lock)
+
+#if !HELPER_TARGET_IS_ESP8266
+static esp_err_t mcp23x17_read(void *dev, uint32_t *val)
+{
+    uint16_t v;
+    CHECK(mcp23x17_port_read((mcp23x17_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t mcp23x17_write(void *dev, uint32_t val)
+{
+    return mcp23x17_port_write((mcp23x17_t *)dev, val);
+}
+
+static esp_err_t mcp23x17_enable_intr(void *dev, uint32_t mask)
+{
+    return mcp23x17_port_set_interrupt((mcp23x17_t *)dev, mask, MCP23X17_INT_ANY_EDGE);
+}
+
+const gpio_expander_driver_t gpio_expander_mcp23x17 = {
+    .read = mcp23x17_read,
+    .write = mcp23x17_write,
+    .read_input = mcp23x17_read,
+    .enable_intr = mcp23x17_enable_intr,
+    .width = 16,
+    .power_on = 0,
+};
+#endif
+
+static esp_err_t mcp23008_read(void *dev, uint32_t *val)
+{
+    uint8_t v;
+    CHECK(mcp23008_port_read((i2c_dev_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t mcp23008_write(void *dev, uint32_t val)
+{
+    return mcp23008_port_write((i2c_dev_t *)dev, val);
+}
+
+static esp_err_t mcp23008_enable_intr(void *dev, uint32_t mask)
+{
+    return mcp23008_port_set_interrupt((i2c_dev_t *)dev, mask, MCP23008_INT_ANY_EDGE);
+}
+
+const gpio_expander_driver_t gpio_expander_mcp23008 = {
+    .read = mcp23008_read,
+    .write = mcp23008_write,
+    .read_input = mcp23008_read,
+    .enable_intr = mcp23008_enable_intr,
+    .width = 8,
+    .power_on = 0,
+};
+
+static esp_err_t pcf8574_read(void *dev, uint32_t *val)
+{
+    uint8_t v;
+    CHECK(pcf8574_port_read((i2c_dev_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t pcf8574_write(void *dev, uint32_t val)
+{
+    return pcf8574_port_write((i2c_dev_t *)dev, val);
+}
+
+static esp_err_t pcf8574_write_seq(void *dev, const uint32_t *values, size_t len)
+{
+    uint8_t buf[SEQ_CHUNK];
+    while (len)
+    {
+        size_t n = len < SEQ_CHUNK ? len : SEQ_CHUNK;
+        for (size_t i = 0; i < n; i++)
+            buf[i] = values[i];
+        CHECK(pcf8574_port_write_seq((i2c_dev_t *)dev, buf, n));
+        values += n;
+        len -= n;
+    }
+    return ESP_OK;
+}
+
+// Port read returns pin levels, not latch: input pins pulled low by
+// external circuit would be turned into outputs on next write
+const gpio_expander_driver_t gpio_expander_pcf8574 = {
+    .read = NULL,
+    .write = pcf8574_write,
+    .read_input = pcf8574_read,
+    .write_seq = pcf8574_write_seq,
+    .width = 8,
+    .power_on = 0xff,
+};
+
+static esp_err_t pcf8575_read(void *dev, uint32_t *val)
+{
+    uint16_t v;
+    CHECK(pcf8575_port_read((i2c_dev_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t pcf8575_write(void *dev, uint32_t val)
+{
+    return pcf8575_port_write((i2c_dev_t *)dev, val);
+}
+
+const gpio_expander_driver_t gpio_expander_pcf8575 = {
+    .read = NULL,
+    .write = pcf8575_write,
+    .read_input = pcf8575_read,
+    .width = 16,
+    .power_on = 0xffff,
+};
+
+static esp_err_t tca95x5_read(void *dev, uint32_t *val)
+{
+    uint16_t v;
+    CHECK(tca95x5_port_read_output((i2c_dev_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t tca95x5_read_in(void *dev, uint32_t *val)
+{
+    uint16_t v;
+    CHECK(tca95x5_port_read((i2c_dev_t *)dev, &v));
+    *val = v;
+    return ESP_OK;
+}
+
+static esp_err_t tca95x5_write(void *dev, uint32_t val)
+{
+    return tca95x5_port_write((i2c_dev_t *)dev, val);
+}
+
+const gpio_expander_driver_t gpio_expander_tca95x5 = {
+    .read = tca95x5_read,
+    .write = tca95x5_write,
+    .read_input = tca95x5_read_in,
+    .width = 16,
+    .power_on = 0xffff,
+};
+
+static esp_err_t flush(gpio_expander_t *exp)
+{
+    if (exp->group || exp->pending == exp->latch)
+        return ESP_OK;
+
+    esp_err_t res = exp->driver->write(exp->dev, exp->pending);
+    if (res == ESP_OK)
+        exp->latch = exp->pending;
+    else
+        exp->pending = exp->latch;
+
+    return res;
+}
+
+static esp_err_t update(gpio_expander_t *exp, uint32_t mask, uint32_t val, bool toggle)
+{
+    LOCK(exp);
+    if (toggle)
+        exp->pending ^= mask;
+    else
+        exp->pending = (exp->pending & ~mask) | (val & mask);
+    esp_err_t res = flush(exp);
+    UNLOCK(exp);
+
+    return res;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t gpio_expander_init(gpio_expander_t *exp, const gpio_expander_driver_t *driver, void *dev)
+{
+    CHECK_ARG(exp && driver && driver->write && dev);
+
+    uint32_t latch = driver->power_on;
+    if (driver->read)
+        CHECK(driver->read(dev, &latch));
+
+    exp->lock = xSemaphoreCreateRecursiveMutex();
+    if (!exp->lock)
+        return ESP_ERR_NO_MEM;
+
+    exp->driver = driver;
+    exp->dev = dev;
+    exp->latch = exp->pending = latch;
+    exp->group = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_free(gpio_expander_t *exp)
+{
+    CHECK_ARG(exp && exp->lock);
+
+    vSemaphoreDelete(exp->lock);
+    exp->lock = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_set_level(gpio_expander_t *exp, uint8_t pin, bool level)
+{
+    CHECK_ARG(exp && pin < exp->driver->width);
+
+    return update(exp, 1UL << pin, level ? 1UL << pin : 0, false);
+}
+
+esp_err_t gpio_expander_toggle(gpio_expander_t *exp, uint8_t pin)
+{
+    CHECK_ARG(exp && pin < exp->driver->width);
+
+    return update(exp, 1UL << pin, 0, true);
+}
+
+esp_err_t gpio_expander_write(gpio_expander_t *exp, uint32_t mask, uint32_t val)
+{
+    CHECK_ARG(exp);
+
+    return update(exp, mask & ((1UL << exp->driver->width) - 1), val, false);
+}
+
+esp_err_t gpio_expander_get_latch(gpio_expander_t *exp, uint32_t *val)
+{
+    CHECK_ARG(exp && val);
+
+    LOCK(exp);
+    *val = exp->pending;
+    UNLOCK(exp);
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_read_input(gpio_expander_t *exp, uint32_t *val)
+{
+    CHECK_ARG(exp && val);
+
+    if (!exp->driver->read_input)
+        return ESP_ERR_NOT_SUPPORTED;
+
+    return exp->driver->read_input(exp->dev, val);
+}
+
+esp_err_t gpio_expander_port_read(void *exp, uint32_t *val)
+{
+    return gpio_expander_read_input((gpio_expander_t *)exp, val);
+}
+
+esp_err_t gpio_expander_write_seq(gpio_expander_t *exp, uint32_t mask, const uint32_t *values, size_t len)
+{
+    CHECK_ARG(exp && values && len);
+
+    mask &= (1UL << exp->driver->width) - 1;
+    esp_err_t res = ESP_OK;
+
+    LOCK(exp);
+    if (exp->group)
+    {
+        // inside a group only the final state matters
+        exp->pending = (exp->pending & ~mask) | (values[len - 1] & mask);
+        UNLOCK(exp);
+        return ESP_OK;
+    }
+
+    uint32_t base = exp->pending & ~mask;
+    if (exp->driver->write_seq)
+    {
+        uint32_t buf[SEQ_CHUNK];
+        for (size_t pos = 0; pos < len && res == ESP_OK; pos += SEQ_CHUNK)
+        {
+            size_t n = len - pos < SEQ_CHUNK ? len - pos : SEQ_CHUNK;
+            for (size_t i = 0; i < n; i++)
+                buf[i] = base | (values[pos + i] & mask);
+            res = exp->driver->write_seq(exp->dev, buf, n);
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < len && res == ESP_OK; i++)
+            res = exp->driver->write(exp->dev, base | (values[i] & mask));
+    }
+    // on error real latch is unknown, assume last value was written
+    exp->latch = exp->pending = base | (values[len - 1] & mask);
+    UNLOCK(exp);
+
+    return res;
+}
+
+esp_err_t gpio_expander_begin(gpio_expander_t *exp)
+{
+    CHECK_ARG(exp);
+
+    LOCK(exp);
+    exp->group++;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_commit(gpio_expander_t *exp)
+{
+    CHECK_ARG(exp);
+
+    LOCK(exp);
+    if (!exp->group)
+    {
+        UNLOCK(exp);
+        return ESP_ERR_INVALID_STATE;
+    }
+    exp->group--;
+    esp_err_t res = flush(exp);
+    UNLOCK(exp);
+    // release lock taken by gpio_expander_begin()
+    UNLOCK(exp);
+
+    return res;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR intr_isr(void *arg)
+#else
+static void intr_isr(void *arg)
+#endif
+{
+    gpio_expander_intr_service_t *svc = (gpio_expander_intr_service_t *)arg;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(svc->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static esp_err_t intr_process(gpio_expander_intr_service_t *svc)
+{
+    uint32_t port;
+    CHECK(svc->exp->driver->read_input(svc->exp->dev, &port));
+
+    uint32_t changed = svc->state ^ port;
+    svc->state = port;
+
+    for (uint8_t pin = 0; changed && pin < GPIO_EXPANDER_MAX_PINS; pin++, changed >>= 1)
+        if ((changed & 1) && svc->callbacks[pin])
+            svc->callbacks[pin](svc, pin, (port >> pin) & 1, svc->args[pin]);
+
+    return ESP_OK;
+}
+
+static void intr_task(void *arg)
+{
+    gpio_expander_intr_service_t *svc = (gpio_expander_intr_service_t *)arg;
+    bool active = false;
+
+    while (svc->running)
+    {
+        // poll every tick while interrupt output stays active
+        ulTaskNotifyTake(pdTRUE, active ? 1 : portMAX_DELAY);
+        if (!svc->running)
+            break;
+
+        esp_err_t res = intr_process(svc);
+        if (res != ESP_OK)
+            ESP_LOGE(TAG, "Error reading input port: %d (%s)", res, esp_err_to_name(res));
+
+        active = gpio_get_level(svc->gpio) == svc->active_level;
+    }
+
+    svc->task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t gpio_expander_intr_service_start(gpio_expander_intr_service_t *svc, gpio_expander_t *exp,
+        gpio_num_t gpio, uint8_t active_level, uint32_t mask, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(svc && exp && exp->driver->read_input && !svc->task
+            && exp->driver->width <= GPIO_EXPANDER_MAX_PINS);
+
+    svc->exp = exp;
+    svc->gpio = gpio;
+    svc->active_level = active_level ? 1 : 0;
+
+    if (exp->driver->enable_intr)
+        CHECK(exp->driver->enable_intr(exp->dev, mask));
+
+    CHECK(gpio_set_direction(gpio, GPIO_MODE_INPUT));
+    CHECK(gpio_set_pull_mode(gpio, svc->active_level ? GPIO_PULLDOWN_ONLY : GPIO_PULLUP_ONLY));
+
+    // initial state, clears pending interrupt
+    uint32_t port;
+    CHECK(exp->driver->read_input(exp->dev, &port));
+    svc->state = port;
+
+    svc->running = true;
+    if (xTaskCreate(intr_task, TAG, stack_size, svc, priority, &svc->task) != pdPASS)
+    {
+        svc->running = false;
+        svc->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_set_intr_type(gpio, svc->active_level ? GPIO_INTR_POSEDGE : GPIO_INTR_NEGEDGE)) != ESP_OK)
+        goto fail;
+    if ((res = gpio_isr_handler_add(gpio, intr_isr, svc)) != ESP_OK)
+        goto fail;
+
+    // catch changes made before ISR was installed
+    xTaskNotifyGive(svc->task);
+
+    return ESP_OK;
+
+fail:
+    gpio_expander_intr_service_stop(svc);
+    return res;
+}
+
+esp_err_t gpio_expander_intr_service_stop(gpio_expander_intr_service_t *svc)
+{
+    CHECK_ARG(svc);
+
+    gpio_isr_handler_remove(svc->gpio);
+    gpio_set_intr_type(svc->gpio, GPIO_INTR_DISABLE);
+
+    svc->running = false;
+    while (svc->task)
+    {
+        xTaskNotifyGive(svc->task);
+        vTaskDelay(1);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_intr_service_set_callback(gpio_expander_intr_service_t *svc, uint8_t pin,
+        gpio_expander_pin_cb_t callback, void *arg)
+{
+    CHECK_ARG(svc && pin < GPIO_EXPANDER_MAX_PINS);
+
+    svc->callbacks[pin] = NULL;
+    svc->args[pin] = arg;
+    svc->callbacks[pin] = callback;
+
+    return ESP_OK;
+}
+
+esp_err_t gpio_expander_intr_service_get_state(gpio_expander_intr_service_t *svc, uint32_t *val)
+{
+    CHECK_ARG(svc && val);
+
+    *val = svc->state;
+
+    return ESP_OK;
+}
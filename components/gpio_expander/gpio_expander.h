@@ -0,0 +1,332 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file gpio_expander.h
+ * @defgroup gpio_expander gpio_expander
+ * @{
+ *
+ * Common interface of GPIO expanders
+ *
+ * Keeps a copy of output latch of MCP23x17, MCP23008, PCF8574, PCF8575
+ * or TCA95x5, so single pin changes don't need read-modify-write over
+ * the bus. Input port is read through the same interface, optionally
+ * cached by an interrupt-on-change service.
+ *
+ * Consumers like hd44780 or button need only a few lines of glue, e.g.
+ * hd44780 bulk write callback calling gpio_expander_write_seq() and
+ * button port with gpio_expander_port_read().
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __GPIO_EXPANDER_H__
+#define __GPIO_EXPANDER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <esp_err.h>
+#include <esp_idf_lib_helpers.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <driver/gpio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Expander driver
+ */
+typedef struct
+{
+    /**
+     * Read output latch. NULL if device has no readable latch,
+     * shadow is then initialized with power-on value.
+     */
+    esp_err_t (*read)(void *dev, uint32_t *val);
+    esp_err_t (*write)(void *dev, uint32_t val); //!< Write whole port
+    esp_err_t (*read_input)(void *dev, uint32_t *val); //!< Read pin levels of whole port
+    /**
+     * Write sequence of port values in one transaction. NULL if device
+     * can't do it, values are then written one by one.
+     */
+    esp_err_t (*write_seq)(void *dev, const uint32_t *values, size_t len);
+    /**
+     * Enable interrupt on any change of pins in mask. NULL if device
+     * always signals changes of all input pins.
+     */
+    esp_err_t (*enable_intr)(void *dev, uint32_t mask);
+    uint8_t width;                               //!< Number of pins
+    uint32_t power_on;                           //!< Latch value after power-on
+} gpio_expander_driver_t;
+
+#if !HELPER_TARGET_IS_ESP8266
+extern const gpio_expander_driver_t gpio_expander_mcp23x17; //!< MCP23017/MCP23S17, device is `mcp23x17_t *`
+#endif
+extern const gpio_expander_driver_t gpio_expander_mcp23008; //!< MCP23008, device is `i2c_dev_t *`
+extern const gpio_expander_driver_t gpio_expander_pcf8574;  //!< PCF8574, device is `i2c_dev_t *`
+extern const gpio_expander_driver_t gpio_expander_pcf8575;  //!< PCF8575, device is `i2c_dev_t *`
+extern const gpio_expander_driver_t gpio_expander_tca95x5;  //!< TCA9535/TCA9555, device is `i2c_dev_t *`
+
+/**
+ * Expander descriptor
+ */
+typedef struct
+{
+    const gpio_expander_driver_t *driver; //!< Expander driver
+    void *dev;                            //!< Device descriptor
+    uint32_t latch;                       //!< Output latch value written to device
+    uint32_t pending;                     //!< Latch value with uncommitted changes
+    uint8_t group;                        //!< Group nesting level
+    SemaphoreHandle_t lock;               //!< Descriptor lock
+} gpio_expander_t;
+
+/**
+ * @brief Initialize expander descriptor
+ *
+ * Device descriptor must be initialized before. Shadow is loaded from
+ * the device when driver can read the latch, otherwise it is set to
+ * the power-on value and nothing is sent to device.
+ *
+ * All outputs of the device must be changed through this descriptor
+ * after initialization, otherwise shadow becomes stale.
+ *
+ * @param exp Expander descriptor
+ * @param driver Expander driver
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_init(gpio_expander_t *exp, const gpio_expander_driver_t *driver, void *dev);
+
+/**
+ * @brief Free expander descriptor
+ *
+ * @param exp Expander descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_free(gpio_expander_t *exp);
+
+/**
+ * @brief Set pin level
+ *
+ * @param exp Expander descriptor
+ * @param pin Pin number
+ * @param level Pin level
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_set_level(gpio_expander_t *exp, uint8_t pin, bool level);
+
+/**
+ * @brief Invert pin level
+ *
+ * @param exp Expander descriptor
+ * @param pin Pin number
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_toggle(gpio_expander_t *exp, uint8_t pin);
+
+/**
+ * @brief Change several pins at once
+ *
+ * @param exp Expander descriptor
+ * @param mask Pins to change
+ * @param val New levels of pins in mask
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_write(gpio_expander_t *exp, uint32_t mask, uint32_t val);
+
+/**
+ * @brief Get shadowed latch value
+ *
+ * No bus transaction is made. Uncommitted changes of the current group
+ * are included.
+ *
+ * @param exp Expander descriptor
+ * @param[out] val Latch value
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_get_latch(gpio_expander_t *exp, uint32_t *val);
+
+/**
+ * @brief Read pin levels of whole port
+ *
+ * Reads the device in one transaction, e.g. from a pin change callback
+ * of an expander interrupt service.
+ *
+ * @param exp Expander descriptor
+ * @param[out] val Pin levels
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_read_input(gpio_expander_t *exp, uint32_t *val);
+
+/**
+ * @brief Port read function for consumers taking `(void *ctx, uint32_t *value)`
+ *
+ * Same as gpio_expander_read_input(), can be used as ::button_port_t
+ * read function with expander descriptor as context.
+ *
+ * @param exp Expander descriptor, `gpio_expander_t *`
+ * @param[out] val Pin levels
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_port_read(void *exp, uint32_t *val);
+
+/**
+ * @brief Write sequence of values to pins in mask
+ *
+ * Every value is merged with the current latch, so pins outside of mask
+ * keep their state. Values are written in one transaction if device
+ * supports it (PCF8574), otherwise one transaction per value. Latch
+ * is left at the last value.
+ *
+ * Useful for strobed protocols, e.g. HD44780 LCD.
+ *
+ * @param exp Expander descriptor
+ * @param mask Pins to change
+ * @param values Sequence of pin levels
+ * @param len Number of values
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_write_seq(gpio_expander_t *exp, uint32_t mask, const uint32_t *values, size_t len);
+
+/**
+ * @brief Start group of changes
+ *
+ * Changes made until gpio_expander_commit() are collected in the shadow
+ * and written to device in one transaction. Descriptor stays locked for
+ * other tasks during the group. Groups can be nested, changes are written
+ * by the outermost commit.
+ *
+ * @param exp Expander descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_begin(gpio_expander_t *exp);
+
+/**
+ * @brief Finish group of changes
+ *
+ * @param exp Expander descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_commit(gpio_expander_t *exp);
+
+/**
+ * Maximal number of pins handled by interrupt service
+ */
+#define GPIO_EXPANDER_MAX_PINS 16
+
+typedef struct gpio_expander_intr_service gpio_expander_intr_service_t;
+
+/**
+ * Pin change callback prototype
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number
+ * @param level Current pin level
+ * @param arg User argument
+ */
+typedef void (*gpio_expander_pin_cb_t)(gpio_expander_intr_service_t *svc, uint8_t pin, bool level, void *arg);
+
+/**
+ * Interrupt service descriptor
+ */
+struct gpio_expander_intr_service
+{
+    gpio_expander_t *exp;                              //!< Expander descriptor
+    gpio_num_t gpio;                                   //!< GPIO connected to interrupt output
+    uint8_t active_level;                              //!< Active level of interrupt output
+    volatile uint32_t state;                           //!< Cached input port state
+    gpio_expander_pin_cb_t callbacks[GPIO_EXPANDER_MAX_PINS]; //!< Pin callbacks
+    void *args[GPIO_EXPANDER_MAX_PINS];                //!< Callback arguments
+    TaskHandle_t task;                                 //!< Service task, internal
+    volatile bool running;                             //!< Service state, internal
+};
+
+/**
+ * @brief Start interrupt service
+ *
+ * Generic version of device specific interrupt services: enables
+ * interrupt on change of pins in `mask` (if driver needs it), installs
+ * GPIO interrupt handler and reads the input port in one transaction on
+ * every interrupt. Cached state is updated and callbacks of changed pins
+ * are called from the service task. While the interrupt output stays
+ * active after the read the task polls every tick.
+ *
+ * Interrupt output mode of MCP23x17/MCP23008 must match `active_level`
+ * (both ports mirrored for MCP23x17). PCF857x and TCA95x5 have open-drain
+ * active low output.
+ *
+ * @param svc Interrupt service descriptor, must be zero-initialized
+ * @param exp Expander descriptor, driver must support `read_input`
+ * @param gpio GPIO connected to interrupt output
+ * @param active_level Active level of interrupt output
+ * @param mask Input pins to watch
+ * @param priority Service task priority
+ * @param stack_size Service task stack size, callbacks are called from it
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_intr_service_start(gpio_expander_intr_service_t *svc, gpio_expander_t *exp,
+        gpio_num_t gpio, uint8_t active_level, uint32_t mask, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop interrupt service
+ *
+ * @param svc Interrupt service descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_intr_service_stop(gpio_expander_intr_service_t *svc);
+
+/**
+ * @brief Set pin change callback
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number
+ * @param callback Callback, NULL to remove
+ * @param arg User argument passed to callback
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_intr_service_set_callback(gpio_expander_intr_service_t *svc, uint8_t pin,
+        gpio_expander_pin_cb_t callback, void *arg);
+
+/**
+ * @brief Get cached input port state
+ *
+ * No bus transaction is made, state is updated by the service task.
+ *
+ * @param svc Interrupt service descriptor
+ * @param[out] val Pin levels
+ * @return `ESP_OK` on success
+ */
+esp_err_t gpio_expander_intr_service_get_state(gpio_expander_intr_service_t *svc, uint32_t *val);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __GPIO_EXPANDER_H__ */
@@ -37,9 +37,12 @@
  * BSD Licensed as described in the file LICENSE
  */
 #include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
 #include <esp_system.h>
 #include <esp_idf_lib_helpers.h>
 #include <esp_log.h> // to include ets_sys.h
+#include <esp_timer.h>
 #include "hd44780.h"
 
 #define MS 1000
@@ -61,6 +64,9 @@
 #define CMD_CGRAM_ADDR   0x40
 #define CMD_DDRAM_ADDR   0x80
 
+// Character codes 0x08..0x0f show the same CGRAM glyphs as 0x00..0x07
+#define CGRAM_CODE_MIRROR 0x08
+
 #define ARG_MOVE_RIGHT 0x04
 #define ARG_MOVE_LEFT 0x00
 #define CMD_SHIFT_LEFT  (CMD_SHIFT | CMD_DISPLAY_CTRL | ARG_MOVE_LEFT)
@@ -81,25 +87,179 @@
 #define ARG_FS_FONT_5X10    BV(2)
 
 #define init_delay()   do { ets_delay_us(DELAY_INIT); } while (0)
-#define short_delay()  do { ets_delay_us(DELAY_CMD_SHORT); } while (0)
-#define long_delay()   do { ets_delay_us(DELAY_CMD_LONG); } while (0)
 #define toggle_delay() do { ets_delay_us(DELAY_TOGGLE); } while (0)
 
+// Address counter update time after busy flag is cleared
+#define DELAY_ADDR_UPDATE 2
+
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 
 static const uint8_t line_addr[] = { 0x00, 0x40, 0x14, 0x54 };
 
-static esp_err_t write_nibble(const hd44780_t *lcd, uint8_t b, bool rs)
+const hd44780_timing_t hd44780_timing_standard = {
+    .cmd_short_us = DELAY_CMD_SHORT,
+    .cmd_long_us = DELAY_CMD_LONG,
+};
+
+const hd44780_timing_t hd44780_timing_fast = {
+    .cmd_short_us = 40,
+    .cmd_long_us = 1600,
+};
+
+static inline const hd44780_timing_t *timing(const hd44780_t *lcd)
+{
+    return lcd->timing ? lcd->timing : &hd44780_timing_standard;
+}
+
+static inline uint8_t glyph_bytes(const hd44780_t *lcd)
+{
+    return lcd->font == HD44780_FONT_5X8 ? 8 : 10;
+}
+
+static inline uint8_t cgram_slots(const hd44780_t *lcd)
+{
+    return lcd->font == HD44780_FONT_5X8 ? HD44780_CGRAM_SLOTS : HD44780_CGRAM_SLOTS / 2;
+}
+
+// With 5x10 font CGRAM pattern takes 16 bytes and is selected by bits 2:1
+// of character code, bit 0 is ignored
+static inline uint8_t cgram_slot_shift(const hd44780_t *lcd)
+{
+    return lcd->font == HD44780_FONT_5X8 ? 0 : 1;
+}
+
+static inline bool is_gpio(const hd44780_t *lcd)
+{
+    return !lcd->write_cb && !lcd->write_bulk_cb && !lcd->write16_cb;
+}
+
+// 16-bit port callback takes precedence over 8-bit bulk callback
+static inline bool use_bulk(const hd44780_t *lcd)
+{
+    return lcd->write_bulk_cb && !lcd->write16_cb;
+}
+
+static inline bool use_busy_flag(const hd44780_t *lcd)
+{
+    return lcd->read_busy && is_gpio(lcd);
+}
+
+static esp_err_t set_data_direction(const hd44780_t *lcd, gpio_mode_t mode)
+{
+    if (lcd->bus_8bit)
+    {
+        CHECK(gpio_set_direction(lcd->pins.d0, mode));
+        CHECK(gpio_set_direction(lcd->pins.d1, mode));
+        CHECK(gpio_set_direction(lcd->pins.d2, mode));
+        CHECK(gpio_set_direction(lcd->pins.d3, mode));
+    }
+    CHECK(gpio_set_direction(lcd->pins.d4, mode));
+    CHECK(gpio_set_direction(lcd->pins.d5, mode));
+    CHECK(gpio_set_direction(lcd->pins.d6, mode));
+    CHECK(gpio_set_direction(lcd->pins.d7, mode));
+
+    return ESP_OK;
+}
+
+// Poll busy flag until it is cleared. If it is still set after timeout_us
+// (e.g. RW is not wired), give up and assume the command is done; no error
+// is returned and no extra delay is added
+static esp_err_t wait_busy(const hd44780_t *lcd, uint32_t timeout_us)
+{
+    CHECK(set_data_direction(lcd, GPIO_MODE_INPUT));
+    CHECK(gpio_set_level(lcd->pins.rs, 0));
+    CHECK(gpio_set_level(lcd->pins.rw, 1));
+    ets_delay_us(1); // Address Setup time >= 60ns.
+
+    bool busy;
+    int64_t start = esp_timer_get_time();
+    do
+    {
+        // high nibble, D7 is busy flag
+        CHECK(gpio_set_level(lcd->pins.e, true));
+        toggle_delay();
+        busy = gpio_get_level(lcd->pins.d7);
+        CHECK(gpio_set_level(lcd->pins.e, false));
+        toggle_delay();
+        if (lcd->bus_8bit)
+            continue;
+        // low nibble, ignored
+        CHECK(gpio_set_level(lcd->pins.e, true));
+        toggle_delay();
+        CHECK(gpio_set_level(lcd->pins.e, false));
+        toggle_delay();
+    } while (busy && esp_timer_get_time() - start < timeout_us);
+
+    CHECK(gpio_set_level(lcd->pins.rw, 0));
+    CHECK(set_data_direction(lcd, GPIO_MODE_OUTPUT));
+    ets_delay_us(DELAY_ADDR_UPDATE);
+
+    return ESP_OK;
+}
+
+static esp_err_t wait_ready(const hd44780_t *lcd, bool long_cmd)
+{
+    uint32_t us = long_cmd ? timing(lcd)->cmd_long_us : timing(lcd)->cmd_short_us;
+
+    if (use_busy_flag(lcd))
+        return wait_busy(lcd, us * 2);
+
+    ets_delay_us(us);
+    return ESP_OK;
+}
+
+// Expander port value for one bus cycle, E low. Byte is put on D0..D7
+// in 8-bit mode, low nibble on D4..D7 in 4-bit mode
+static inline uint16_t port_data(const hd44780_t *lcd, uint8_t b, bool rs)
+{
+    uint16_t v = (rs ? 1 << lcd->pins.rs : 0)
+               | (lcd->backlight ? 1 << lcd->pins.bl : 0);
+    if (lcd->bus_8bit)
+    {
+        v |= (((b >> 3) & 1) << lcd->pins.d3)
+           | (((b >> 2) & 1) << lcd->pins.d2)
+           | (((b >> 1) & 1) << lcd->pins.d1)
+           | ((b & 1) << lcd->pins.d0);
+        b >>= 4;
+    }
+    return v
+         | (((b >> 3) & 1) << lcd->pins.d7)
+         | (((b >> 2) & 1) << lcd->pins.d6)
+         | (((b >> 1) & 1) << lcd->pins.d5)
+         | ((b & 1) << lcd->pins.d4);
+}
+
+// Put E pulses for both nibbles of byte into sequence, 4 bytes
+static inline void port_seq(const hd44780_t *lcd, uint8_t b, bool rs, uint8_t *seq)
+{
+    uint8_t hi = port_data(lcd, b >> 4, rs);
+    uint8_t lo = port_data(lcd, b, rs);
+    seq[0] = hi | (1 << lcd->pins.e);
+    seq[1] = hi;
+    seq[2] = lo | (1 << lcd->pins.e);
+    seq[3] = lo;
+}
+
+// One bus cycle: nibble in 4-bit mode, byte in 8-bit mode
+static esp_err_t write_bus(const hd44780_t *lcd, uint8_t b, bool rs)
 {
-    if (lcd->write_cb)
+    if (lcd->write16_cb)
+    {
+        uint16_t data = port_data(lcd, b, rs);
+        CHECK(lcd->write16_cb(lcd, data | (1 << lcd->pins.e)));
+        toggle_delay();
+        CHECK(lcd->write16_cb(lcd, data));
+    }
+    else if (lcd->write_bulk_cb)
+    {
+        uint8_t data = port_data(lcd, b, rs);
+        uint8_t seq[2] = { data | (1 << lcd->pins.e), data };
+        CHECK(lcd->write_bulk_cb(lcd, seq, 2));
+    }
+    else if (lcd->write_cb)
     {
-        uint8_t data = (((b >> 3) & 1) << lcd->pins.d7)
-                     | (((b >> 2) & 1) << lcd->pins.d6)
-                     | (((b >> 1) & 1) << lcd->pins.d5)
-                     | ((b & 1) << lcd->pins.d4)
-                     | (rs ? 1 << lcd->pins.rs : 0)
-                     | (lcd->backlight ? 1 << lcd->pins.bl : 0);
+        uint8_t data = port_data(lcd, b, rs);
         CHECK(lcd->write_cb(lcd, data | (1 << lcd->pins.e)));
         toggle_delay();
         CHECK(lcd->write_cb(lcd, data));
@@ -109,6 +269,14 @@ static esp_err_t write_nibble(const hd44780_t *lcd, uint8_t b, bool rs)
         CHECK(gpio_set_level(lcd->pins.rs, rs));
         ets_delay_us(1); // Address Setup time >= 60ns.
         CHECK(gpio_set_level(lcd->pins.e, true));
+        if (lcd->bus_8bit)
+        {
+            CHECK(gpio_set_level(lcd->pins.d3, (b >> 3) & 1));
+            CHECK(gpio_set_level(lcd->pins.d2, (b >> 2) & 1));
+            CHECK(gpio_set_level(lcd->pins.d1, (b >> 1) & 1));
+            CHECK(gpio_set_level(lcd->pins.d0, b & 1));
+            b >>= 4;
+        }
         CHECK(gpio_set_level(lcd->pins.d7, (b >> 3) & 1));
         CHECK(gpio_set_level(lcd->pins.d6, (b >> 2) & 1));
         CHECK(gpio_set_level(lcd->pins.d5, (b >> 1) & 1));
@@ -122,8 +290,61 @@ static esp_err_t write_nibble(const hd44780_t *lcd, uint8_t b, bool rs)
 
 static esp_err_t write_byte(const hd44780_t *lcd, uint8_t b, bool rs)
 {
-    CHECK(write_nibble(lcd, b >> 4, rs));
-    CHECK(write_nibble(lcd, b, rs));
+    if (lcd->bus_8bit)
+        return write_bus(lcd, b, rs);
+
+    if (use_bulk(lcd))
+    {
+        uint8_t seq[4];
+        port_seq(lcd, b, rs, seq);
+        return lcd->write_bulk_cb(lcd, seq, sizeof(seq));
+    }
+
+    CHECK(write_bus(lcd, b >> 4, rs));
+    CHECK(write_bus(lcd, b, rs));
+
+    return ESP_OK;
+}
+
+// Write custom character bitmap to CGRAM at address
+static esp_err_t write_cgram(const hd44780_t *lcd, uint8_t addr, const uint8_t *data)
+{
+    uint8_t bytes = glyph_bytes(lcd);
+    CHECK(write_byte(lcd, CMD_CGRAM_ADDR + addr, false));
+    CHECK(wait_ready(lcd, false));
+    for (uint8_t i = 0; i < bytes; i ++)
+    {
+        CHECK(write_byte(lcd, data[i], true));
+        CHECK(wait_ready(lcd, false));
+    }
+
+    return ESP_OK;
+}
+
+#define BULK_CHARS 16
+
+// Write characters at cursor position
+static esp_err_t write_data(const hd44780_t *lcd, const char *s, size_t len)
+{
+    if (!use_bulk(lcd))
+    {
+        for (size_t i = 0; i < len; i++)
+            CHECK(hd44780_putc(lcd, s[i]));
+        return ESP_OK;
+    }
+
+    // characters are paced by bus speed
+    uint8_t seq[BULK_CHARS * 4];
+    while (len)
+    {
+        size_t n = len < BULK_CHARS ? len : BULK_CHARS;
+        for (size_t i = 0; i < n; i++)
+            port_seq(lcd, s[i], true, seq + i * 4);
+        CHECK(lcd->write_bulk_cb(lcd, seq, n * 4));
+        s += n;
+        len -= n;
+    }
+    CHECK(wait_ready(lcd, false));
 
     return ESP_OK;
 }
@@ -131,8 +352,10 @@ static esp_err_t write_byte(const hd44780_t *lcd, uint8_t b, bool rs)
 esp_err_t hd44780_init(const hd44780_t *lcd)
 {
     CHECK_ARG(lcd && lcd->lines > 0 && lcd->lines < 5);
+    // 8-bit interface doesn't fit into 8-bit expander port
+    CHECK_ARG(!lcd->bus_8bit || is_gpio(lcd) || lcd->write16_cb);
 
-    if (!lcd->write_cb)
+    if (is_gpio(lcd))
     {
         gpio_config_t io_conf;
         memset(&io_conf, 0, sizeof(gpio_config_t));
@@ -144,34 +367,48 @@ esp_err_t hd44780_init(const hd44780_t *lcd)
                 GPIO_BIT(lcd->pins.d5) |
                 GPIO_BIT(lcd->pins.d6) |
                 GPIO_BIT(lcd->pins.d7);
+        if (lcd->bus_8bit)
+            io_conf.pin_bit_mask |=
+                    GPIO_BIT(lcd->pins.d0) |
+                    GPIO_BIT(lcd->pins.d1) |
+                    GPIO_BIT(lcd->pins.d2) |
+                    GPIO_BIT(lcd->pins.d3);
         if (lcd->pins.bl != HD44780_NOT_USED)
             io_conf.pin_bit_mask |= GPIO_BIT(lcd->pins.bl);
+        if (lcd->read_busy)
+            io_conf.pin_bit_mask |= GPIO_BIT(lcd->pins.rw);
         CHECK(gpio_config(&io_conf));
+        if (lcd->read_busy)
+            CHECK(gpio_set_level(lcd->pins.rw, 0));
     }
 
-    // switch to 4 bit mode
+    // reset to 8 bit mode, then switch to 4 bit mode if needed
     for (uint8_t i = 0; i < 3; i ++)
     {
-        CHECK(write_nibble(lcd, (CMD_FUNC_SET | ARG_FS_8_BIT) >> 4, false));
+        CHECK(write_bus(lcd, lcd->bus_8bit ? CMD_FUNC_SET | ARG_FS_8_BIT : (CMD_FUNC_SET | ARG_FS_8_BIT) >> 4, false));
         init_delay();
     }
-    CHECK(write_nibble(lcd, CMD_FUNC_SET >> 4, false));
-    short_delay();
+    if (!lcd->bus_8bit)
+    {
+        CHECK(write_bus(lcd, CMD_FUNC_SET >> 4, false));
+        ets_delay_us(timing(lcd)->cmd_short_us);
+    }
 
     // Specify the number of display lines and character font
     CHECK(write_byte(lcd,
         CMD_FUNC_SET
+            | (lcd->bus_8bit ? ARG_FS_8_BIT : 0)
             | (lcd->lines > 1 ? ARG_FS_2_LINES : 0)
             | (lcd->font == HD44780_FONT_5X10 ? ARG_FS_FONT_5X10 : 0),
         false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
     // Display off
     CHECK(hd44780_control(lcd, false, false, false));
     // Clear
     CHECK(hd44780_clear(lcd));
     // Entry mode set
     CHECK(write_byte(lcd, CMD_ENTRY_MODE | ARG_EM_INCREMENT, false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
     // Display on
     CHECK(hd44780_control(lcd, true, false, false));
 
@@ -188,7 +425,7 @@ esp_err_t hd44780_control(const hd44780_t *lcd, bool on, bool cursor, bool curso
             | (cursor ? ARG_DC_CURSOR_ON : 0)
             | (cursor_blink ? ARG_DC_CURSOR_BLINK : 0),
         false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
 
     return ESP_OK;
 }
@@ -198,7 +435,7 @@ esp_err_t hd44780_clear(const hd44780_t *lcd)
     CHECK_ARG(lcd);
 
     CHECK(write_byte(lcd, CMD_CLEAR, false));
-    long_delay();
+    CHECK(wait_ready(lcd, true));
 
     return ESP_OK;
 }
@@ -208,7 +445,7 @@ esp_err_t hd44780_gotoxy(const hd44780_t *lcd, uint8_t col, uint8_t line)
     CHECK_ARG(lcd && line < lcd->lines && line < sizeof(line_addr));
 
     CHECK(write_byte(lcd, CMD_DDRAM_ADDR + line_addr[line] + col, false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
 
     return ESP_OK;
 }
@@ -218,7 +455,7 @@ esp_err_t hd44780_putc(const hd44780_t *lcd, char c)
     CHECK_ARG(lcd);
 
     CHECK(write_byte(lcd, c, true));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
 
     return ESP_OK;
 }
@@ -227,13 +464,7 @@ esp_err_t hd44780_puts(const hd44780_t *lcd, const char *s)
 {
     CHECK_ARG(lcd && s);
 
-    while (*s)
-    {
-        CHECK(hd44780_putc(lcd, *s));
-        s++;
-    }
-
-    return ESP_OK;
+    return write_data(lcd, s, strlen(s));
 }
 
 esp_err_t hd44780_switch_backlight(hd44780_t *lcd, bool on)
@@ -242,7 +473,14 @@ esp_err_t hd44780_switch_backlight(hd44780_t *lcd, bool on)
     if (lcd->pins.bl == HD44780_NOT_USED)
         return ESP_ERR_NOT_SUPPORTED;
 
-    if (!lcd->write_cb)
+    if (lcd->write16_cb)
+        CHECK(lcd->write16_cb(lcd, on ? BV(lcd->pins.bl) : 0));
+    else if (lcd->write_bulk_cb)
+    {
+        uint8_t data = on ? BV(lcd->pins.bl) : 0;
+        CHECK(lcd->write_bulk_cb(lcd, &data, 1));
+    }
+    else if (!lcd->write_cb)
         CHECK(gpio_set_level(lcd->pins.bl, on));
     else
         CHECK(lcd->write_cb(lcd, on ? BV(lcd->pins.bl) : 0));
@@ -256,16 +494,70 @@ esp_err_t hd44780_upload_character(const hd44780_t *lcd, uint8_t num, const uint
 {
     CHECK_ARG(lcd && data && num < 8);
 
-    uint8_t bytes = lcd->font == HD44780_FONT_5X8 ? 8 : 10;
-    CHECK(write_byte(lcd, CMD_CGRAM_ADDR + num * bytes, false));
-    short_delay();
-    for (uint8_t i = 0; i < bytes; i ++)
+    CHECK(write_cgram(lcd, num * glyph_bytes(lcd), data));
+    CHECK(hd44780_gotoxy(lcd, 0, 0));
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_cgram_init(hd44780_cgram_t *cache)
+{
+    CHECK_ARG(cache);
+
+    memset(cache, 0, sizeof(hd44780_cgram_t));
+    for (uint8_t i = 0; i < HD44780_CGRAM_SLOTS; i++)
+        cache->lru[i] = i;
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_cgram_get(hd44780_cgram_t *cache, const hd44780_t *lcd, const uint8_t *glyph, char *code)
+{
+    CHECK_ARG(cache && lcd && glyph && code);
+
+    uint8_t bytes = glyph_bytes(lcd);
+    uint8_t slots = cgram_slots(lcd);
+    uint8_t i, slot = 0;
+
+    for (i = 0; i < slots; i++)
     {
-        CHECK(write_byte(lcd, data[i], true));
-        short_delay();
+        slot = cache->lru[i];
+        if ((cache->valid & BV(slot)) && !memcmp(cache->data[slot], glyph, bytes))
+            break;
     }
 
-    CHECK(hd44780_gotoxy(lcd, 0, 0));
+    if (i == slots)
+    {
+        // miss, replace least recently used unlocked slot
+        while (i && (cache->locked & BV(cache->lru[i - 1])))
+            i--;
+        if (!i)
+            return ESP_ERR_NO_MEM;
+        slot = cache->lru[--i];
+
+        cache->valid &= ~BV(slot);
+        CHECK(write_cgram(lcd, (slot << cgram_slot_shift(lcd)) * 8, glyph));
+        memcpy(cache->data[slot], glyph, bytes);
+        cache->valid |= BV(slot);
+        cache->uploads++;
+    }
+
+    // move to the head of LRU list
+    memmove(cache->lru + 1, cache->lru, i);
+    cache->lru[0] = slot;
+    cache->locked |= BV(slot);
+
+    // codes 8..15 mirror CGRAM, so glyph code is never '\0'
+    *code = (char)(CGRAM_CODE_MIRROR + (slot << cgram_slot_shift(lcd)));
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_cgram_unlock(hd44780_cgram_t *cache)
+{
+    CHECK_ARG(cache);
+
+    cache->locked = 0;
 
     return ESP_OK;
 }
@@ -275,7 +567,7 @@ esp_err_t hd44780_scroll_left(const hd44780_t *lcd)
     CHECK_ARG(lcd);
 
     CHECK(write_byte(lcd, CMD_SHIFT_LEFT, false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
 
     return ESP_OK;
 }
@@ -285,7 +577,192 @@ esp_err_t hd44780_scroll_right(const hd44780_t *lcd)
     CHECK_ARG(lcd);
 
     CHECK(write_byte(lcd, CMD_SHIFT_RIGHT, false));
-    short_delay();
+    CHECK(wait_ready(lcd, false));
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_screen_init(hd44780_screen_t *scr, const hd44780_t *lcd, uint8_t cols)
+{
+    CHECK_ARG(scr && lcd && cols && cols * lcd->lines <= HD44780_SCREEN_SIZE);
+
+    scr->lcd = lcd;
+    scr->cols = cols;
+    scr->cgram = NULL;
+    CHECK(hd44780_screen_clear(scr));
+    memset(scr->shown, ' ', sizeof(scr->shown));
+
+    return hd44780_clear(lcd);
+}
+
+esp_err_t hd44780_screen_clear(hd44780_screen_t *scr)
+{
+    CHECK_ARG(scr);
+
+    memset(scr->buf, ' ', sizeof(scr->buf));
+    memset(scr->glyph, 0, sizeof(scr->glyph));
+    scr->glyph_count = 0;
+    scr->col = 0;
+    scr->line = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_screen_gotoxy(hd44780_screen_t *scr, uint8_t col, uint8_t line)
+{
+    CHECK_ARG(scr && scr->lcd && col < scr->cols && line < scr->lcd->lines);
+
+    scr->col = col;
+    scr->line = line;
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_screen_puts(hd44780_screen_t *scr, const char *s)
+{
+    CHECK_ARG(scr && scr->lcd && s);
+
+    for (; *s; s++)
+    {
+        if (*s == '\n')
+        {
+            scr->col = 0;
+            if (scr->line < scr->lcd->lines)
+                scr->line++;
+            continue;
+        }
+        if (scr->col >= scr->cols || scr->line >= scr->lcd->lines)
+            continue;
+        scr->glyph[scr->line * scr->cols + scr->col] = 0;
+        scr->buf[scr->line * scr->cols + scr->col++] = *s;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_screen_printf(hd44780_screen_t *scr, const char *fmt, ...)
+{
+    CHECK_ARG(scr && fmt);
+
+    char s[HD44780_SCREEN_SIZE + 1];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(s, sizeof(s), fmt, args);
+    va_end(args);
+
+    return hd44780_screen_puts(scr, s);
+}
+
+esp_err_t hd44780_screen_set_cgram(hd44780_screen_t *scr, hd44780_cgram_t *cache)
+{
+    CHECK_ARG(scr);
+
+    scr->cgram = cache;
+
+    return ESP_OK;
+}
+
+// Bitmask of buffer glyphs used by characters
+static uint8_t used_glyphs(const hd44780_screen_t *scr)
+{
+    uint8_t used = 0;
+    for (size_t i = 0; i < scr->cols * scr->lcd->lines; i++)
+        if (scr->glyph[i])
+            used |= BV(scr->glyph[i] - 1);
+    return used;
+}
+
+esp_err_t hd44780_screen_put_glyph(hd44780_screen_t *scr, const uint8_t *glyph)
+{
+    CHECK_ARG(scr && scr->lcd && glyph);
+    if (!scr->cgram)
+        return ESP_ERR_INVALID_STATE;
+
+    if (scr->col >= scr->cols || scr->line >= scr->lcd->lines)
+        return ESP_OK;
+
+    uint8_t bytes = glyph_bytes(scr->lcd);
+    uint8_t idx;
+    for (idx = 0; idx < scr->glyph_count; idx++)
+        if (!memcmp(scr->glyphs[idx], glyph, bytes))
+            break;
+
+    if (idx == scr->glyph_count)
+    {
+        if (scr->glyph_count < cgram_slots(scr->lcd))
+            scr->glyph_count++;
+        else
+        {
+            // reuse glyph overwritten by text
+            uint8_t used = used_glyphs(scr);
+            for (idx = 0; idx < scr->glyph_count && (used & BV(idx)); idx++) {}
+            if (idx == scr->glyph_count)
+                return ESP_ERR_NO_MEM;
+        }
+        memcpy(scr->glyphs[idx], glyph, bytes);
+    }
+
+    size_t pos = scr->line * scr->cols + scr->col++;
+    scr->glyph[pos] = idx + 1;
+    scr->buf[pos] = ' ';
+
+    return ESP_OK;
+}
+
+// Assign CGRAM slots to buffer glyphs, uploading missing ones
+static esp_err_t map_glyphs(hd44780_screen_t *scr)
+{
+    if (!scr->cgram || !scr->glyph_count)
+        return ESP_OK;
+
+    uint8_t used = used_glyphs(scr);
+    char codes[HD44780_CGRAM_SLOTS];
+
+    CHECK(hd44780_cgram_unlock(scr->cgram));
+    for (uint8_t i = 0; i < scr->glyph_count; i++)
+        if (used & BV(i))
+            CHECK(hd44780_cgram_get(scr->cgram, scr->lcd, scr->glyphs[i], &codes[i]));
+
+    // characters with replaced glyphs differ from shown ones and will be redrawn
+    for (size_t i = 0; i < scr->cols * scr->lcd->lines; i++)
+        if (scr->glyph[i])
+            scr->buf[i] = codes[scr->glyph[i] - 1];
+
+    return ESP_OK;
+}
+
+esp_err_t hd44780_refresh(hd44780_screen_t *scr)
+{
+    CHECK_ARG(scr && scr->lcd);
+
+    CHECK(map_glyphs(scr));
+
+    for (uint8_t line = 0; line < scr->lcd->lines && line < sizeof(line_addr); line++)
+    {
+        char *buf = scr->buf + line * scr->cols;
+        char *shown = scr->shown + line * scr->cols;
+        uint8_t col = 0;
+        while (col < scr->cols)
+        {
+            // find start of the changed run
+            if (buf[col] == shown[col])
+            {
+                col++;
+                continue;
+            }
+            // find its end, merging runs separated by single unchanged char,
+            // rewriting it costs the same as the cursor move
+            uint8_t end = col + 1;
+            while (end < scr->cols && (buf[end] != shown[end]
+                    || (end + 1 < scr->cols && buf[end + 1] != shown[end + 1])))
+                end++;
+
+            CHECK(hd44780_gotoxy(scr->lcd, col, line));
+            CHECK(write_data(scr->lcd, buf + col, end - col));
+            memcpy(shown + col, buf + col, end - col);
+            col = end;
+        }
+    }
 
     return ESP_OK;
 }
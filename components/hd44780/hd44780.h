@@ -43,6 +43,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <driver/gpio.h>
 #include <esp_err.h>
 
@@ -62,31 +63,127 @@ typedef enum
     HD44780_FONT_5X10
 } hd44780_font_t;
 
+/**
+ * Command execution times. Clones with faster internal clock may
+ * work with shorter delays.
+ */
+typedef struct
+{
+    uint16_t cmd_short_us; //!< Execution time of most commands and data writes, us
+    uint16_t cmd_long_us;  //!< Execution time of clear and return home, us
+} hd44780_timing_t;
+
+extern const hd44780_timing_t hd44780_timing_standard; //!< Safe default timing, used when `timing` is NULL
+extern const hd44780_timing_t hd44780_timing_fast;     //!< Datasheet timing of 270 kHz controllers
+
 typedef struct hd44780 hd44780_t;
 
 typedef esp_err_t (*hd44780_write_cb_t)(const hd44780_t *lcd, uint8_t data);
 
+/**
+ * Bulk data write callback prototype
+ *
+ * Must write all bytes to the expander port one after another in a single
+ * bus transaction, e.g. with pcf8574_port_write_seq() or gpio_expander_write_seq()
+ */
+typedef esp_err_t (*hd44780_write_bulk_cb_t)(const hd44780_t *lcd, const uint8_t *data, size_t len);
+
+/**
+ * 16-bit port write callback prototype
+ *
+ * Must write value to the whole 16-bit expander port at once, e.g. with
+ * mcp23x17_port_write(). Allows 8-bit interface, when data pins, RS and E
+ * are set by a single write.
+ */
+typedef esp_err_t (*hd44780_write16_cb_t)(const hd44780_t *lcd, uint16_t data);
+
 /**
  * LCD descriptor. Fill it before use.
  */
 struct hd44780
 {
     hd44780_write_cb_t write_cb; //!< Data write callback. Set it to NULL in case of direct LCD connection to GPIO
+    hd44780_write_bulk_cb_t write_bulk_cb; //!< Optional bulk write callback, used instead of `write_cb` if set.
+                                           //!< Bus must be slow enough (I2C up to 400 kHz) to execute
+                                           //!< every character before the next one arrives
+    hd44780_write16_cb_t write16_cb; //!< Optional 16-bit port write callback, used instead of `write_cb` if set
     struct
     {
         uint8_t rs;        //!< GPIO/register bit used for RS pin
         uint8_t e;         //!< GPIO/register bit used for E pin
         uint8_t d4;        //!< GPIO/register bit used for D4 pin
         uint8_t d5;        //!< GPIO/register bit used for D5 pin
-        uint8_t d6;        //!< GPIO/register bit used for D5 pin
-        uint8_t d7;        //!< GPIO/register bit used for D5 pin
+        uint8_t d6;        //!< GPIO/register bit used for D6 pin
+        uint8_t d7;        //!< GPIO/register bit used for D7 pin
         uint8_t bl;        //!< GPIO/register bit used for backlight. Set it `HD44780_NOT_USED` if no backlight used
+        uint8_t rw;        //!< GPIO used for RW pin, only if `read_busy` is true
+        uint8_t d0;        //!< GPIO/register bit used for D0 pin, only if `bus_8bit` is true
+        uint8_t d1;        //!< GPIO/register bit used for D1 pin, only if `bus_8bit` is true
+        uint8_t d2;        //!< GPIO/register bit used for D2 pin, only if `bus_8bit` is true
+        uint8_t d3;        //!< GPIO/register bit used for D3 pin, only if `bus_8bit` is true
     } pins;
+    bool bus_8bit;         //!< Use 8-bit interface, one bus cycle per byte instead of two.
+                           //!< GPIO mode or `write16_cb` only
+    bool read_busy;        //!< Poll busy flag instead of fixed delays. GPIO mode only, requires RW pin.
+                           //!< Data pins must tolerate LCD output levels
+    const hd44780_timing_t *timing; //!< Command timing, NULL for ::hd44780_timing_standard.
+                                    //!< With `read_busy` used as timeout
     hd44780_font_t font;   //!< LCD Font type
     uint8_t lines;         //!< Number of lines for LCD. Many 16x1 LCD has two lines (like 8x2)
     bool backlight;        //!< Current backlight state
 };
 
+/**
+ * Number of CGRAM character slots with 5x8 font, 5x10 font has half of them
+ */
+#define HD44780_CGRAM_SLOTS 8
+
+/**
+ * Maximal size of custom character bitmap, bytes
+ */
+#define HD44780_GLYPH_SIZE 10
+
+/**
+ * CGRAM glyph cache
+ *
+ * Keeps track of custom characters loaded into CGRAM slots, so glyph is
+ * uploaded only if it is not in CGRAM already. Least recently used slot
+ * is replaced when all slots are taken.
+ */
+typedef struct
+{
+    uint8_t data[HD44780_CGRAM_SLOTS][HD44780_GLYPH_SIZE]; //!< Glyphs in CGRAM slots, internal
+    uint8_t lru[HD44780_CGRAM_SLOTS]; //!< Slot numbers, most recently used first, internal
+    uint8_t valid;                    //!< Bitmask of slots holding glyph, internal
+    uint8_t locked;                   //!< Bitmask of slots which must not be replaced, internal
+    uint32_t uploads;                 //!< Number of glyph uploads, for statistics
+} hd44780_cgram_t;
+
+/**
+ * Maximal number of characters of a screen buffer, HD44780 DDRAM size
+ */
+#define HD44780_SCREEN_SIZE 80
+
+/**
+ * Screen buffer descriptor
+ *
+ * Text is drawn into the buffer and sent to the LCD with hd44780_refresh(),
+ * which writes only changed characters.
+ */
+typedef struct
+{
+    const hd44780_t *lcd;              //!< LCD descriptor
+    uint8_t cols;                      //!< Number of columns
+    uint8_t col;                       //!< Buffer cursor column
+    uint8_t line;                      //!< Buffer cursor line
+    char buf[HD44780_SCREEN_SIZE];     //!< Screen buffer
+    char shown[HD44780_SCREEN_SIZE];   //!< Characters currently on the LCD, internal
+    hd44780_cgram_t *cgram;            //!< Glyph cache, set with hd44780_screen_set_cgram()
+    uint8_t glyph[HD44780_SCREEN_SIZE]; //!< Glyph of every character + 1, 0 for text, internal
+    uint8_t glyphs[HD44780_CGRAM_SLOTS][HD44780_GLYPH_SIZE]; //!< Glyphs of the buffer, internal
+    uint8_t glyph_count;               //!< Number of glyphs in the buffer, internal
+} hd44780_screen_t;
+
 /**
  * @brief Init LCD
  *
@@ -169,6 +266,44 @@ esp_err_t hd44780_switch_backlight(hd44780_t *lcd, bool on);
  */
 esp_err_t hd44780_upload_character(const hd44780_t *lcd, uint8_t num, const uint8_t *data);
 
+/**
+ * @brief Init CGRAM glyph cache
+ *
+ * Cache must be reinitialized after hd44780_upload_character() is used
+ * directly.
+ *
+ * @param cache Glyph cache
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_cgram_init(hd44780_cgram_t *cache);
+
+/**
+ * @brief Get character code for custom glyph, uploading it if needed
+ *
+ * Glyph is looked up in the cache by bitmap. If it is missing, it is
+ * uploaded to the least recently used slot. Slot is locked until
+ * hd44780_cgram_unlock() is called, so all glyphs shown at the same
+ * time stay valid. Cursor position is undefined after upload.
+ *
+ * @param cache Glyph cache
+ * @param lcd LCD descriptor
+ * @param glyph Glyph bitmap, 8 bytes for 5x8 font, 10 bytes for 5x10 font
+ * @param[out] code Character code to print: 8..15 with 5x8 font,
+ *                  8, 10, 12 or 14 with 5x10 font
+ * @return `ESP_OK` on success, `ESP_ERR_NO_MEM` if all slots are locked
+ */
+esp_err_t hd44780_cgram_get(hd44780_cgram_t *cache, const hd44780_t *lcd, const uint8_t *glyph, char *code);
+
+/**
+ * @brief Unlock all slots of the glyph cache
+ *
+ * Call it before drawing a new set of glyphs.
+ *
+ * @param cache Glyph cache
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_cgram_unlock(hd44780_cgram_t *cache);
+
 /**
  * @brief Scroll the display content to left by one character
  *
@@ -185,6 +320,99 @@ esp_err_t hd44780_scroll_left(const hd44780_t *lcd);
  */
 esp_err_t hd44780_scroll_right(const hd44780_t *lcd);
 
+/**
+ * @brief Init screen buffer
+ *
+ * Clears the buffer and the LCD. LCD must be initialized with
+ * hd44780_init() first.
+ *
+ * @param scr Screen buffer descriptor
+ * @param lcd LCD descriptor
+ * @param cols Number of columns, `cols * lcd->lines` must not exceed
+ *             ::HD44780_SCREEN_SIZE
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_init(hd44780_screen_t *scr, const hd44780_t *lcd, uint8_t cols);
+
+/**
+ * @brief Clear screen buffer and move buffer cursor to (0, 0)
+ *
+ * @param scr Screen buffer descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_clear(hd44780_screen_t *scr);
+
+/**
+ * @brief Move buffer cursor
+ *
+ * @param scr Screen buffer descriptor
+ * @param col Column
+ * @param line Line
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_gotoxy(hd44780_screen_t *scr, uint8_t col, uint8_t line);
+
+/**
+ * @brief Write string to screen buffer at buffer cursor position
+ *
+ * Text is clipped at the end of line, '\n' moves cursor to the
+ * beginning of the next line.
+ *
+ * @param scr Screen buffer descriptor
+ * @param s String to write
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_puts(hd44780_screen_t *scr, const char *s);
+
+/**
+ * @brief Write formatted string to screen buffer at buffer cursor position
+ *
+ * Same as hd44780_screen_puts() but printf-like.
+ *
+ * @param scr Screen buffer descriptor
+ * @param fmt Format string
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_printf(hd44780_screen_t *scr, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief Set glyph cache used for custom characters of screen buffer
+ *
+ * Required for hd44780_screen_put_glyph().
+ *
+ * @param scr Screen buffer descriptor
+ * @param cache Initialized glyph cache, NULL to disable custom glyphs
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_screen_set_cgram(hd44780_screen_t *scr, hd44780_cgram_t *cache);
+
+/**
+ * @brief Write custom glyph to screen buffer at buffer cursor position
+ *
+ * Glyph bitmap is copied, slot in CGRAM is assigned by hd44780_refresh()
+ * which uploads only glyphs missing in the cache. Up to
+ * ::HD44780_CGRAM_SLOTS (half of it for 5x10 font) different glyphs may
+ * be in the buffer at once.
+ *
+ * @param scr Screen buffer descriptor
+ * @param glyph Glyph bitmap, 8 bytes for 5x8 font, 10 bytes for 5x10 font
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if glyph cache is
+ *         not set, `ESP_ERR_NO_MEM` if there are too many different glyphs
+ */
+esp_err_t hd44780_screen_put_glyph(hd44780_screen_t *scr, const uint8_t *glyph);
+
+/**
+ * @brief Send changes of screen buffer to LCD
+ *
+ * Finds runs of changed characters and writes every run with a single
+ * cursor move. Runs separated by one unchanged character are merged.
+ * Custom glyphs are mapped to CGRAM slots first, see hd44780_cgram_get().
+ *
+ * @param scr Screen buffer descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hd44780_refresh(hd44780_screen_t *scr);
+
 #ifdef __cplusplus
 }
 #endif
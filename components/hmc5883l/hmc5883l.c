@@ -83,6 +83,17 @@ static const float gain_values [] = {
     [HMC5883L_GAIN_230]  = 4.35
 };
 
+static const uint16_t gain_int_values [] = {
+    [HMC5883L_GAIN_1370] = 73,
+    [HMC5883L_GAIN_1090] = 92,
+    [HMC5883L_GAIN_820]  = 122,
+    [HMC5883L_GAIN_660]  = 152,
+    [HMC5883L_GAIN_440]  = 227,
+    [HMC5883L_GAIN_390]  = 256,
+    [HMC5883L_GAIN_330]  = 303,
+    [HMC5883L_GAIN_230]  = 435
+};
+
 #define timeout_expired(start, len) ((uint64_t)(esp_timer_get_time() - (start)) >= (len))
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
@@ -157,6 +168,7 @@ esp_err_t hmc5883l_init(hmc5883l_dev_t *dev)
     hmc5883l_gain_t gain;
     CHECK(hmc5883l_get_gain(dev, &gain));
     dev->gain = gain_values[gain];
+    dev->gain_int = gain_int_values[gain];
 
     CHECK(hmc5883l_get_opmode(dev, &dev->opmode));
 
@@ -275,6 +287,7 @@ esp_err_t hmc5883l_set_gain(hmc5883l_dev_t *dev, hmc5883l_gain_t gain)
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
     dev->gain = gain_values[gain];
+    dev->gain_int = gain_int_values[gain];
     return ESP_OK;
 }
 
@@ -345,6 +358,17 @@ esp_err_t hmc5883l_raw_to_mg(const hmc5883l_dev_t *dev, const hmc5883l_raw_data_
     return ESP_OK;
 }
 
+esp_err_t hmc5883l_raw_to_mg_int(const hmc5883l_dev_t *dev, const hmc5883l_raw_data_t *raw, hmc5883l_data_int_t *mg)
+{
+    CHECK_ARG(dev && raw && mg);
+
+    mg->x = (int32_t)raw->x * dev->gain_int / 100;
+    mg->y = (int32_t)raw->y * dev->gain_int / 100;
+    mg->z = (int32_t)raw->z * dev->gain_int / 100;
+
+    return ESP_OK;
+}
+
 esp_err_t hmc5883l_get_data(hmc5883l_dev_t *dev, hmc5883l_data_t *data)
 {
     CHECK_ARG(data);
@@ -121,6 +121,7 @@ typedef struct
     i2c_dev_t i2c_dev;        //!< I2C device descriptor
     hmc5883l_opmode_t opmode; //!< Operating mode
     float gain;               //!< Gain
+    uint16_t gain_int;        //!< Gain, 0.01 mG/LSb
 } hmc5883l_dev_t;
 
 /**
@@ -143,6 +144,16 @@ typedef struct
     float z;
 } hmc5883l_data_t;
 
+/**
+ * Measurement result, integer milligauss
+ */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} hmc5883l_data_int_t;
+
 /**
  * @brief Initialize device descriptor
  *
@@ -306,6 +317,17 @@ esp_err_t hmc5883l_get_raw_data(hmc5883l_dev_t *dev, hmc5883l_raw_data_t *data);
  */
 esp_err_t hmc5883l_raw_to_mg(const hmc5883l_dev_t *dev, const hmc5883l_raw_data_t *raw, hmc5883l_data_t *mg);
 
+/**
+ * @brief Convert raw magnetic data to integer milligausses
+ *
+ * Same as ::hmc5883l_raw_to_mg() but without floating point math.
+ *
+ * @param dev Device descriptor
+ * @param raw Source raw data
+ * @param[out] mg Converted data
+ */
+esp_err_t hmc5883l_raw_to_mg_int(const hmc5883l_dev_t *dev, const hmc5883l_raw_data_t *raw, hmc5883l_data_int_t *mg);
+
 /**
  * @brief Get magnetic data in milligausses
  *
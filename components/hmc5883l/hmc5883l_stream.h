@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file hmc5883l_stream.h
+ * @defgroup hmc5883l_stream hmc5883l_stream
+ * @{
+ *
+ * HMC5883L streaming using DRDY pin
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __HMC5883L_STREAM_H__
+#define __HMC5883L_STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "hmc5883l.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sample
+ */
+typedef struct
+{
+    hmc5883l_raw_data_t raw; //!< Raw magnetic data
+    int64_t timestamp;       //!< Time of DRDY signal, microseconds since boot
+} hmc5883l_sample_t;
+
+/**
+ * Stream descriptor
+ */
+typedef struct
+{
+    hmc5883l_dev_t *dev;             //!< Device descriptor
+    gpio_num_t gpio;                 //!< GPIO connected to DRDY
+    QueueHandle_t samples;           //!< Sample ring buffer, internal
+    TaskHandle_t task;               //!< Reader task, internal
+    volatile int64_t ready_time;     //!< Time of last DRDY signal, internal
+    volatile bool running;           //!< Stream state, internal
+    uint32_t overruns;               //!< Number of lost samples
+} hmc5883l_stream_t;
+
+/**
+ * @brief Start streaming
+ *
+ * On each DRDY interrupt the reader task makes one 6-byte burst read
+ * of data registers and puts timestamped sample to ring buffer, so status
+ * register is never polled. When buffer is full, the oldest sample is
+ * dropped. HMC5883L pulls DRDY low for 250 us when new data is placed to data registers.
+ *
+ * Gain, data rate and averaging must be set before. Device is switched to
+ * continuous measurement mode.
+ *
+ * @param stream Stream descriptor, `dev` and `gpio` fields must be set
+ * @param buf_size Ring buffer size, samples
+ * @param priority Reader task priority
+ * @param stack_size Reader task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t hmc5883l_stream_start(hmc5883l_stream_t *stream, size_t buf_size, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop streaming
+ *
+ * Device is switched back to single measurement mode.
+ *
+ * @param stream Stream descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hmc5883l_stream_stop(hmc5883l_stream_t *stream);
+
+/**
+ * @brief Read samples from ring buffer
+ *
+ * Waits for the first sample, then copies all available samples
+ * without waiting.
+ *
+ * @param stream Stream descriptor
+ * @param[out] samples Buffer for samples
+ * @param max Buffer size, samples
+ * @param[out] count Number of copied samples
+ * @param timeout_ms Time to wait for the first sample
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if no samples
+ */
+esp_err_t hmc5883l_stream_read(hmc5883l_stream_t *stream, hmc5883l_sample_t *samples, size_t max,
+        size_t *count, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __HMC5883L_STREAM_H__ */
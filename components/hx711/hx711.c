@@ -37,7 +37,9 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_timer.h>
+#include <esp_attr.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_crit_stats.h>
 #include "hx711.h"
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
@@ -47,14 +49,14 @@
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
 #endif
 
-static uint32_t read_raw(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
-{
+ESP_IDF_LIB_CRIT_STATS_DEFINE(crit_stats, "hx711");
+
 #if HELPER_TARGET_IS_ESP32
-    portENTER_CRITICAL(&mux);
-#elif HELPER_TARGET_IS_ESP8266
-    portENTER_CRITICAL();
+static uint32_t IRAM_ATTR read_bits(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
+#else
+static uint32_t read_bits(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
 #endif
-
+{
     // read data
     uint32_t data = 0;
     for (size_t i = 0; i < 24; i++)
@@ -75,6 +77,21 @@ static uint32_t read_raw(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
         ets_delay_us(1);
     }
 
+    return data;
+}
+
+static uint32_t read_raw(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
+{
+#if HELPER_TARGET_IS_ESP32
+    portENTER_CRITICAL(&mux);
+#elif HELPER_TARGET_IS_ESP8266
+    portENTER_CRITICAL();
+#endif
+    ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats);
+
+    uint32_t data = read_bits(dout, pd_sck, gain);
+
+    ESP_IDF_LIB_CRIT_STATS_END(crit_stats);
 #if HELPER_TARGET_IS_ESP32
     portEXIT_CRITICAL(&mux);
 #elif HELPER_TARGET_IS_ESP8266
@@ -84,17 +101,96 @@ static uint32_t read_raw(gpio_num_t dout, gpio_num_t pd_sck, hx711_gain_t gain)
     return data;
 }
 
+static inline int32_t sign_extend(uint32_t raw)
+{
+    if (raw & 0x800000)
+        raw |= 0xff000000;
+    return (int32_t)raw;
+}
+
+static inline hx711_gain_t other_gain(const hx711_t *dev, hx711_gain_t gain)
+{
+    return gain == dev->gains[0] ? dev->gains[1] : dev->gains[0];
+}
+
+/*
+ * Decide gain of the next conversion before reading a sample. Returns
+ * false if the sample must be dropped, `tag` is gain of the sample.
+ */
+#if HELPER_TARGET_IS_ESP32
+static bool IRAM_ATTR next_gain(hx711_t *dev, hx711_gain_t *tag, hx711_gain_t *next)
+#else
+static bool next_gain(hx711_t *dev, hx711_gain_t *tag, hx711_gain_t *next)
+#endif
+{
+    *tag = dev->pending;
+    bool keep = !dev->skip;
+    if (!dev->interleave)
+        *next = dev->gain;
+    else if (keep)
+    {
+        *next = other_gain(dev, *tag);
+        dev->skip = dev->discard;
+    }
+    else
+    {
+        *next = *tag;
+        dev->skip--;
+    }
+    dev->pending = *next;
+
+    return keep;
+}
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR dout_isr(void *arg)
+#else
+static void dout_isr(void *arg)
+#endif
+{
+    hx711_t *dev = (hx711_t *)arg;
+
+    // DOUT toggles while shifting data out, ignore these edges
+    if (gpio_get_level(dev->dout))
+        return;
+
+    hx711_sample_t sample;
+    hx711_gain_t next;
+    sample.timestamp = esp_timer_get_time();
+    bool keep = next_gain(dev, &sample.gain, &next);
+    // Interrupts of this level are already masked, PD_SCK won't stay
+    // high long enough to power down the device
+    sample.value = sign_extend(read_bits(dev->dout, dev->pd_sck, next));
+    if (!keep)
+        return;
+
+    BaseType_t woken = pdFALSE;
+    if (xQueueSendFromISR(dev->queue, &sample, &woken) != pdTRUE)
+        dev->overruns++;
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 esp_err_t hx711_init(hx711_t *dev)
 {
     CHECK_ARG(dev);
 
+    // not streaming
+    dev->queue = NULL;
+    dev->overruns = 0;
+
     CHECK(gpio_set_direction(dev->dout, GPIO_MODE_INPUT));
     CHECK(gpio_set_direction(dev->pd_sck, GPIO_MODE_OUTPUT));
 
     CHECK(hx711_power_down(dev, false));
 
+    // Conversion after power up is always channel A, gain 128
+    dev->pending = HX711_GAIN_A_128;
+    dev->interleave = false;
+    dev->skip = 0;
+
     return hx711_set_gain(dev, dev->gain);
 }
 
@@ -112,14 +208,76 @@ esp_err_t hx711_set_gain(hx711_t *dev, hx711_gain_t gain)
 {
     CHECK_ARG(dev && gain <= HX711_GAIN_A_64);
 
+    if (dev->queue)
+    {
+        // applied by the interrupt handler, first sample with the new gain
+        // is the one after the next
+        dev->gain = gain;
+        dev->interleave = false;
+        dev->skip = 0;
+        return ESP_OK;
+    }
+
     CHECK(hx711_wait(dev, 200)); // 200 ms timeout
 
     read_raw(dev->dout, dev->pd_sck, gain);
     dev->gain = gain;
+    dev->pending = gain;
+    dev->interleave = false;
+    dev->skip = 0;
 
     return ESP_OK;
 }
 
+esp_err_t hx711_set_interleave(hx711_t *dev, hx711_gain_t gain_a, hx711_gain_t gain_b, uint8_t discard)
+{
+    CHECK_ARG(dev && gain_a <= HX711_GAIN_A_64 && gain_b <= HX711_GAIN_A_64 && gain_a != gain_b);
+
+    dev->gains[0] = gain_a;
+    dev->gains[1] = gain_b;
+    dev->discard = discard;
+
+    if (dev->queue)
+    {
+        // Conversion in progress keeps its gain, the interrupt handler
+        // starts the other one of gain_a/gain_b after it
+        dev->skip = 0;
+        dev->gain = gain_a;
+        dev->interleave = true;
+        return ESP_OK;
+    }
+
+    CHECK(hx711_wait(dev, 200)); // 200 ms timeout
+
+    read_raw(dev->dout, dev->pd_sck, gain_a);
+    dev->gain = gain_a;
+    dev->pending = gain_a;
+    dev->skip = discard;
+    dev->interleave = true;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_read_sample(hx711_t *dev, hx711_sample_t *sample, size_t timeout_ms)
+{
+    CHECK_ARG(dev && sample);
+
+    if (dev->queue)
+        return ESP_ERR_INVALID_STATE;
+
+    while (true)
+    {
+        CHECK(hx711_wait(dev, timeout_ms));
+
+        hx711_gain_t next;
+        sample->timestamp = esp_timer_get_time();
+        bool keep = next_gain(dev, &sample->gain, &next);
+        sample->value = sign_extend(read_raw(dev->dout, dev->pd_sck, next));
+        if (keep)
+            return ESP_OK;
+    }
+}
+
 esp_err_t hx711_is_ready(hx711_t *dev, bool *ready)
 {
     CHECK_ARG(dev && ready);
@@ -146,10 +304,91 @@ esp_err_t hx711_read_data(hx711_t *dev, int32_t *data)
 {
     CHECK_ARG(dev && data);
 
-    uint32_t raw = read_raw(dev->dout, dev->pd_sck, dev->gain);
-    if (raw & 0x800000)
-        raw |= 0xff000000;
-    *data = *((int32_t *)&raw);
+    if (dev->queue)
+        return ESP_ERR_INVALID_STATE;
+
+    hx711_gain_t tag, next;
+    next_gain(dev, &tag, &next);
+    *data = sign_extend(read_raw(dev->dout, dev->pd_sck, next));
 
     return ESP_OK;
 }
+
+esp_err_t hx711_start_stream(hx711_t *dev, size_t queue_len)
+{
+    CHECK_ARG(dev && queue_len);
+
+    if (dev->queue)
+        return ESP_ERR_INVALID_STATE;
+
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        return res;
+
+    dev->queue = xQueueCreate(queue_len, sizeof(hx711_sample_t));
+    if (!dev->queue)
+        return ESP_ERR_NO_MEM;
+    dev->overruns = 0;
+
+    res = gpio_set_intr_type(dev->dout, GPIO_INTR_NEGEDGE);
+    if (res == ESP_OK)
+        res = gpio_isr_handler_add(dev->dout, dout_isr, dev);
+    if (res != ESP_OK)
+    {
+        gpio_set_intr_type(dev->dout, GPIO_INTR_DISABLE);
+        vQueueDelete(dev->queue);
+        dev->queue = NULL;
+        return res;
+    }
+
+    // Sample may be ready already, its falling edge has been missed then
+    if (!gpio_get_level(dev->dout))
+    {
+        hx711_sample_t sample;
+        hx711_gain_t next;
+        sample.timestamp = esp_timer_get_time();
+        bool keep = next_gain(dev, &sample.gain, &next);
+        sample.value = sign_extend(read_raw(dev->dout, dev->pd_sck, next));
+        if (keep)
+            xQueueSend(dev->queue, &sample, 0);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_stop_stream(hx711_t *dev)
+{
+    CHECK_ARG(dev);
+
+    if (!dev->queue)
+        return ESP_ERR_INVALID_STATE;
+
+    gpio_set_intr_type(dev->dout, GPIO_INTR_DISABLE);
+    CHECK(gpio_isr_handler_remove(dev->dout));
+    vQueueDelete(dev->queue);
+    dev->queue = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_read_stream(hx711_t *dev, hx711_sample_t *samples, size_t count, size_t *received,
+        size_t timeout_ms)
+{
+    CHECK_ARG(dev && samples && count && received);
+
+    if (!dev->queue)
+        return ESP_ERR_INVALID_STATE;
+
+    *received = 0;
+    TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+    TickType_t start = xTaskGetTickCount();
+    while (*received < count)
+    {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (xQueueReceive(dev->queue, &samples[*received], elapsed < timeout ? timeout - elapsed : 0) != pdTRUE)
+            break;
+        (*received)++;
+    }
+
+    return *received ? ESP_OK : ESP_ERR_TIMEOUT;
+}
@@ -42,6 +42,8 @@
 #include <driver/gpio.h>
 #include <stdbool.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,8 +67,25 @@ typedef struct
     gpio_num_t dout;
     gpio_num_t pd_sck;
     hx711_gain_t gain;
+    QueueHandle_t queue;  //!< Sample queue in streaming mode, NULL otherwise
+    uint32_t overruns;    //!< Samples dropped because the queue was full
+    bool interleave;      //!< Interleaved mode, see hx711_set_interleave()
+    hx711_gain_t gains[2]; //!< Internal: gains alternated in interleaved mode
+    uint8_t discard;      //!< Internal: samples discarded after channel switch
+    uint8_t skip;         //!< Internal: samples left to discard
+    hx711_gain_t pending; //!< Internal: gain of conversion in progress
 } hx711_t;
 
+/**
+ * Sample received in streaming mode
+ */
+typedef struct
+{
+    int32_t value;      //!< Raw ADC data
+    int64_t timestamp;  //!< Time when the sample became ready, us since boot
+    hx711_gain_t gain;  //!< Gain and channel of the sample
+} hx711_sample_t;
+
 /**
  * @brief Initialize device
  *
@@ -96,6 +115,44 @@ esp_err_t hx711_power_down(hx711_t *dev, bool down);
  */
 esp_err_t hx711_set_gain(hx711_t *dev, hx711_gain_t gain);
 
+/**
+ * @brief Alternate two gains/channels sample by sample
+ *
+ * Trailing clock pulses of every read select the other gain for the next
+ * conversion, so channels A and B are sampled alternately without extra
+ * reads. Every sample is tagged with its gain, use hx711_read_sample()
+ * or streaming mode to get the tags. After each switch `discard` samples
+ * of the new channel are read and dropped, for inputs which need more
+ * settling time. Interleaving is stopped by hx711_set_gain().
+ *
+ * Waits for the conversion in progress, reads it and starts conversion
+ * of `gain_a`. In streaming mode returns immediately: the conversion in
+ * progress completes with the previous gain and is queued tagged with it,
+ * then the interrupt handler alternates the gains. The first conversion
+ * after the switch is `gain_b` if the previous gain was `gain_a`, `gain_a`
+ * otherwise.
+ *
+ * @param dev Device descriptor
+ * @param gain_a First gain, conversion of this gain starts first
+ * @param gain_b Second gain
+ * @param discard Number of samples dropped after every switch, 0 for none
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if device not found
+ */
+esp_err_t hx711_set_interleave(hx711_t *dev, hx711_gain_t gain_a, hx711_gain_t gain_b, uint8_t discard);
+
+/**
+ * @brief Wait for sample and read it with its gain tag
+ *
+ * In interleaved mode samples dropped after a channel switch are read
+ * and skipped. Not available in streaming mode.
+ *
+ * @param dev Device descriptor
+ * @param[out] sample Sample
+ * @param timeout_ms Maximum time to wait for every conversion, milliseconds
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_read_sample(hx711_t *dev, hx711_sample_t *sample, size_t timeout_ms);
+
 /**
  * @brief Check if device ready to send data
  *
@@ -126,6 +183,53 @@ esp_err_t hx711_wait(hx711_t *dev, size_t timeout_ms);
  */
 esp_err_t hx711_read_data(hx711_t *dev, int32_t *data);
 
+/**
+ * @brief Start streaming mode.
+ *
+ * Every sample is clocked out by the DOUT falling edge interrupt as soon as
+ * it is ready and put into the sample queue together with its timestamp.
+ * If the queue is full, sample is dropped and `dev->overruns` incremented.
+ *
+ * In streaming mode hx711_read_data() returns `ESP_ERR_INVALID_STATE` and
+ * hx711_set_gain() does not wait, new gain is applied starting from the
+ * sample after the next one. In interleaved mode samples dropped after
+ * channel switches are not queued.
+ *
+ * Clocking out a sample takes about 60 us in the interrupt handler.
+ * Installs GPIO ISR service if it is not installed yet.
+ *
+ * @param dev Device descriptor
+ * @param queue_len Sample queue length
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_start_stream(hx711_t *dev, size_t queue_len);
+
+/**
+ * @brief Stop streaming mode.
+ *
+ * Queued samples are discarded.
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_stop_stream(hx711_t *dev);
+
+/**
+ * @brief Read a batch of samples in streaming mode.
+ *
+ * Waits until `count` samples received or timeout expires.
+ *
+ * @param dev Device descriptor
+ * @param[out] samples Array of at least `count` samples
+ * @param count Number of samples to read
+ * @param[out] received Number of samples actually read
+ * @param timeout_ms Maximum time to wait, milliseconds
+ * @return `ESP_OK` if at least one sample has been read, `ESP_ERR_TIMEOUT`
+ *         if none
+ */
+esp_err_t hx711_read_stream(hx711_t *dev, hx711_sample_t *samples, size_t count, size_t *received,
+        size_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file hx711_filter.c
+ *
+ * Integer filtering and calibration of HX711 samples
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_timer.h>
+#include "hx711_filter.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define EMA_FRAC 16
+
+static int32_t median(hx711_filter_t *f, int32_t raw)
+{
+    size_t n = f->count, i;
+
+    if (n == f->param)
+    {
+        // remove oldest sample from sorted window
+        int32_t old = f->window[f->pos];
+        for (i = 0; f->sorted[i] != old; i++) {}
+        memmove(&f->sorted[i], &f->sorted[i + 1], (n - i - 1) * sizeof(int32_t));
+        n--;
+    }
+    else
+        f->count++;
+
+    f->window[f->pos] = raw;
+    f->pos = (f->pos + 1) % f->param;
+
+    // insert new one
+    for (i = n; i > 0 && f->sorted[i - 1] > raw; i--)
+        f->sorted[i] = f->sorted[i - 1];
+    f->sorted[i] = raw;
+
+    // until window is full, take median of what we have
+    return f->sorted[f->count / 2];
+}
+
+static int32_t ema(hx711_filter_t *f, int32_t raw)
+{
+    int64_t x = (int64_t)raw * (1 << EMA_FRAC);
+    if (!f->count)
+    {
+        f->ema = x;
+        f->count = 1;
+    }
+    else
+        f->ema += (x - f->ema) / (1 << f->param);
+
+    return (int32_t)(f->ema / (1 << EMA_FRAC));
+}
+
+static bool cic(hx711_filter_t *f, int32_t raw, int32_t *value)
+{
+    // unsigned arithmetic wraps around, result is exact as long as it fits
+    uint64_t y = (uint64_t)(int64_t)raw;
+    for (size_t i = 0; i < HX711_FILTER_CIC_ORDER; i++)
+        y = f->integ[i] += y;
+
+    if (++f->count < f->param)
+        return false;
+    f->count = 0;
+
+    for (size_t i = 0; i < HX711_FILTER_CIC_ORDER; i++)
+    {
+        uint64_t t = y;
+        y -= f->comb[i];
+        f->comb[i] = t;
+    }
+
+    if (f->settle)
+    {
+        f->settle--;
+        return false;
+    }
+
+    int64_t gain = 1;
+    for (size_t i = 0; i < HX711_FILTER_CIC_ORDER; i++)
+        gain *= f->param;
+    *value = (int32_t)((int64_t)y / gain);
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t hx711_filter_init(hx711_filter_t *f, hx711_filter_type_t type, uint8_t param)
+{
+    CHECK_ARG(f);
+    switch (type)
+    {
+        case HX711_FILTER_NONE:
+            break;
+        case HX711_FILTER_MEDIAN:
+            CHECK_ARG(param && param <= HX711_FILTER_MEDIAN_MAX && (param & 1));
+            break;
+        case HX711_FILTER_EMA:
+            CHECK_ARG(param && param <= 16);
+            break;
+        case HX711_FILTER_CIC:
+            CHECK_ARG(param >= 2 && param <= HX711_FILTER_CIC_MAX);
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(f, 0, sizeof(hx711_filter_t));
+    f->type = type;
+    f->param = param;
+    f->scale = HX711_FILTER_SCALE_ONE;
+
+    return hx711_filter_reset(f);
+}
+
+esp_err_t hx711_filter_reset(hx711_filter_t *f)
+{
+    CHECK_ARG(f);
+
+    f->count = 0;
+    f->pos = 0;
+    f->ema = 0;
+    memset(f->integ, 0, sizeof(f->integ));
+    memset(f->comb, 0, sizeof(f->comb));
+    // CIC output is valid after ORDER outputs
+    f->settle = HX711_FILTER_CIC_ORDER - 1;
+
+    return ESP_OK;
+}
+
+bool hx711_filter_update(hx711_filter_t *f, int32_t raw, int32_t *out)
+{
+    if (!f || !out)
+        return false;
+
+    switch (f->type)
+    {
+        case HX711_FILTER_MEDIAN:
+            f->value = median(f, raw);
+            break;
+        case HX711_FILTER_EMA:
+            f->value = ema(f, raw);
+            break;
+        case HX711_FILTER_CIC:
+            if (!cic(f, raw, &f->value))
+                return false;
+            break;
+        default:
+            f->value = raw;
+    }
+
+    *out = (int32_t)(((int64_t)(f->value - f->offset) * f->scale) / HX711_FILTER_SCALE_ONE);
+
+    return true;
+}
+
+esp_err_t hx711_filter_read(hx711_t *dev, hx711_filter_t *f, int32_t *out, size_t timeout_ms)
+{
+    CHECK_ARG(dev && f && out);
+
+    int64_t deadline = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (true)
+    {
+        int64_t left = deadline - esp_timer_get_time();
+        if (left < 0)
+            return ESP_ERR_TIMEOUT;
+
+        hx711_sample_t sample;
+        size_t received;
+        CHECK(hx711_read_stream(dev, &sample, 1, &received, left / 1000));
+        if (hx711_filter_update(f, sample.value, out))
+            return ESP_OK;
+    }
+}
+
+esp_err_t hx711_filter_set_tare(hx711_filter_t *f, int32_t offset)
+{
+    CHECK_ARG(f);
+
+    f->offset = offset;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_filter_tare(hx711_filter_t *f)
+{
+    CHECK_ARG(f);
+
+    f->offset = f->value;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_filter_set_scale(hx711_filter_t *f, int32_t scale)
+{
+    CHECK_ARG(f && scale);
+
+    f->scale = scale;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_filter_calibrate(hx711_filter_t *f, int32_t known)
+{
+    CHECK_ARG(f && known);
+
+    int32_t delta = f->value - f->offset;
+    if (!delta)
+        return ESP_ERR_INVALID_STATE;
+
+    int64_t scale = (int64_t)known * HX711_FILTER_SCALE_ONE / delta;
+    if (!scale || scale > INT32_MAX || scale < INT32_MIN)
+        return ESP_ERR_INVALID_STATE;
+    f->scale = (int32_t)scale;
+
+    return ESP_OK;
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file hx711_filter.h
+ * @defgroup hx711_filter hx711_filter
+ * @{
+ *
+ * Integer filtering and calibration of HX711 samples
+ *
+ * Raw samples are passed through one of the filters (median of N,
+ * exponential moving average or 3rd order CIC decimator), then tare
+ * offset is subtracted and result is scaled to user units (grams,
+ * milligrams, etc). No floating point is used.
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __HX711_FILTER_H__
+#define __HX711_FILTER_H__
+
+#include "hx711.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximal median window size
+ */
+#define HX711_FILTER_MEDIAN_MAX 15
+
+/**
+ * Maximal CIC decimation ratio
+ */
+#define HX711_FILTER_CIC_MAX 64
+
+/**
+ * CIC filter order
+ */
+#define HX711_FILTER_CIC_ORDER 3
+
+/**
+ * Scale factor corresponding to 1.0, scale is in Q16.16 format
+ */
+#define HX711_FILTER_SCALE_ONE (1 << 16)
+
+/**
+ * Filter type
+ */
+typedef enum
+{
+    HX711_FILTER_NONE = 0, //!< No filtering, output every sample
+    HX711_FILTER_MEDIAN,   //!< Sliding median of N samples, output every sample
+    HX711_FILTER_EMA,      //!< Exponential moving average, alpha = 1 / 2^N, output every sample
+    HX711_FILTER_CIC,      //!< CIC decimator, output every N samples
+} hx711_filter_type_t;
+
+/**
+ * Filter descriptor
+ */
+typedef struct
+{
+    hx711_filter_type_t type; //!< Filter type
+    uint8_t param;            //!< Window size, EMA shift or decimation ratio
+    uint8_t count;            //!< Samples in window / decimation counter
+    uint8_t pos;              //!< Oldest sample position in median window
+    uint8_t settle;           //!< CIC outputs left to discard
+    int32_t window[HX711_FILTER_MEDIAN_MAX]; //!< Median window, in arrival order
+    int32_t sorted[HX711_FILTER_MEDIAN_MAX]; //!< Median window, sorted
+    int64_t ema;              //!< EMA state, Q.16
+    uint64_t integ[HX711_FILTER_CIC_ORDER]; //!< CIC integrators
+    uint64_t comb[HX711_FILTER_CIC_ORDER];  //!< CIC comb delays
+    int32_t value;            //!< Last filtered raw value
+    int32_t offset;           //!< Tare offset, raw units
+    int32_t scale;            //!< User units per raw unit, Q16.16
+} hx711_filter_t;
+
+/**
+ * @brief Initialize filter
+ *
+ * Tare offset is set to 0, scale to ::HX711_FILTER_SCALE_ONE.
+ *
+ * @param f Filter descriptor
+ * @param type Filter type
+ * @param param Odd window size up to ::HX711_FILTER_MEDIAN_MAX for
+ *              median, shift 1..16 for EMA, decimation ratio
+ *              2..::HX711_FILTER_CIC_MAX for CIC, ignored otherwise
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_filter_init(hx711_filter_t *f, hx711_filter_type_t type, uint8_t param);
+
+/**
+ * @brief Reset filter state
+ *
+ * Calibration (tare offset and scale) is kept.
+ *
+ * @param f Filter descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_filter_reset(hx711_filter_t *f);
+
+/**
+ * @brief Feed raw sample to the filter
+ *
+ * @param f Filter descriptor
+ * @param raw Raw ADC data
+ * @param[out] out Calibrated value, valid if function returned true
+ * @return true if new output value is available
+ */
+bool hx711_filter_update(hx711_filter_t *f, int32_t raw, int32_t *out);
+
+/**
+ * @brief Read next calibrated value in streaming mode
+ *
+ * Takes samples from the stream started with hx711_start_stream() and
+ * feeds them to the filter until it produces output.
+ *
+ * @param dev Device descriptor
+ * @param f Filter descriptor
+ * @param[out] out Calibrated value
+ * @param timeout_ms Maximum time to wait, milliseconds
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if no output in time
+ */
+esp_err_t hx711_filter_read(hx711_t *dev, hx711_filter_t *f, int32_t *out, size_t timeout_ms);
+
+/**
+ * @brief Set tare offset
+ *
+ * @param f Filter descriptor
+ * @param offset Offset, raw units
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_filter_set_tare(hx711_filter_t *f, int32_t offset);
+
+/**
+ * @brief Use last filtered value as tare offset
+ *
+ * @param f Filter descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_filter_tare(hx711_filter_t *f);
+
+/**
+ * @brief Set scale
+ *
+ * @param f Filter descriptor
+ * @param scale User units per raw unit, Q16.16
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_filter_set_scale(hx711_filter_t *f, int32_t scale);
+
+/**
+ * @brief Calculate scale from a known load
+ *
+ * Put known load on the scale after tare and wait for filter to settle,
+ * then call this function.
+ *
+ * @param f Filter descriptor
+ * @param known Known load, user units
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if filtered value
+ *         equals tare offset or resulting scale is out of range
+ */
+esp_err_t hx711_filter_calibrate(hx711_filter_t *f, int32_t known);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __HX711_FILTER_H__ */
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file hx711_spi.c
+ *
+ * SPI backend of ESP-IDF driver for HX711 24-bit ADC for weigh scales
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include "hx711_spi.h"
+
+#if HELPER_TARGET_IS_ESP32
+
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include <esp_idf_lib_trace.h>
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define CLOCK_HZ 1000000
+#define DATA_BITS 24
+// data bits + up to 3 gain pulses
+#define MAX_CLOCKS (DATA_BITS + 3)
+
+// DOUT changes after rising edge of PD_SCK, sample on falling (mode 1)
+#define SPI_MODE 1
+
+static inline size_t lane_width(const hx711_spi_t *dev)
+{
+    return dev->lanes > 2 ? 4 : dev->lanes;
+}
+
+// Send 24 data clocks and gain pulses, deinterleave received bits
+static esp_err_t transfer(hx711_spi_t *dev, hx711_gain_t gain, int32_t *data)
+{
+    size_t width = lane_width(dev);
+    size_t clocks = DATA_BITS + gain + 1;
+    uint8_t buf[(MAX_CLOCKS * HX711_SPI_MAX_LANES + 7) / 8];
+
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.flags = width == 4 ? SPI_TRANS_MODE_QIO : width == 2 ? SPI_TRANS_MODE_DIO : 0;
+    t.rxlength = clocks * width;
+    t.rx_buffer = buf;
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, t.rxlength);
+    esp_err_t res = spi_device_polling_transmit(dev->spi, &t);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+    CHECK(res);
+
+    if (!data)
+        return ESP_OK;
+
+    // Every byte holds 8 / width clocks, first clock in the most significant
+    // bits, lane D0 in the lowest bit of a clock
+    size_t per_byte = 8 / width;
+    for (size_t lane = 0; lane < dev->lanes; lane++)
+    {
+        uint32_t raw = 0;
+        for (size_t c = 0; c < DATA_BITS; c++)
+        {
+            size_t shift = (per_byte - 1 - c % per_byte) * width + lane;
+            raw = (raw << 1) | ((buf[c / per_byte] >> shift) & 1);
+        }
+        if (raw & 0x800000)
+            raw |= 0xff000000;
+        data[lane] = (int32_t)raw;
+    }
+
+    return ESP_OK;
+}
+
+static bool ready(const hx711_spi_t *dev)
+{
+    for (size_t i = 0; i < dev->lanes; i++)
+        if (gpio_get_level(dev->dout[i]))
+            return false;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t hx711_spi_init(hx711_spi_t *dev)
+{
+    CHECK_ARG(dev && (dev->lanes == 1 || dev->lanes == 2 || dev->lanes == HX711_SPI_MAX_LANES)
+            && dev->gain <= HX711_GAIN_A_64);
+
+    spi_bus_config_t bus = {
+        .sclk_io_num = dev->pd_sck,
+        .mosi_io_num = -1,
+        .miso_io_num = -1,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = 0,
+    };
+    if (dev->lanes == 1)
+        bus.miso_io_num = dev->dout[0];
+    else
+    {
+        bus.mosi_io_num = dev->dout[0];
+        bus.miso_io_num = dev->dout[1];
+        if (dev->lanes == HX711_SPI_MAX_LANES)
+        {
+            bus.quadwp_io_num = dev->dout[2];
+            bus.quadhd_io_num = dev->dout[3];
+        }
+    }
+    CHECK(spi_bus_initialize(dev->host, &bus, 0));
+
+    spi_device_interface_config_t cfg = {
+        .mode = SPI_MODE,
+        .clock_speed_hz = CLOCK_HZ,
+        .spics_io_num = -1,
+        .flags = SPI_DEVICE_HALFDUPLEX,
+        .queue_size = 1,
+    };
+    esp_err_t res = spi_bus_add_device(dev->host, &cfg, &dev->spi);
+    if (res != ESP_OK)
+    {
+        spi_bus_free(dev->host);
+        return res;
+    }
+
+    return hx711_spi_set_gain(dev, dev->gain);
+}
+
+esp_err_t hx711_spi_free(hx711_spi_t *dev)
+{
+    CHECK_ARG(dev && dev->spi);
+
+    CHECK(spi_bus_remove_device(dev->spi));
+    dev->spi = NULL;
+
+    return spi_bus_free(dev->host);
+}
+
+esp_err_t hx711_spi_set_gain(hx711_spi_t *dev, hx711_gain_t gain)
+{
+    CHECK_ARG(dev && gain <= HX711_GAIN_A_64);
+
+    CHECK(hx711_spi_wait(dev, 200)); // 200 ms timeout
+
+    CHECK(transfer(dev, gain, NULL));
+    dev->gain = gain;
+
+    return ESP_OK;
+}
+
+esp_err_t hx711_spi_wait(hx711_spi_t *dev, size_t timeout_ms)
+{
+    CHECK_ARG(dev);
+
+    uint64_t started = esp_timer_get_time() / 1000;
+    while (esp_timer_get_time() / 1000 - started < timeout_ms)
+    {
+        if (ready(dev))
+            return ESP_OK;
+        vTaskDelay(1);
+    }
+
+    return ESP_ERR_TIMEOUT;
+}
+
+esp_err_t hx711_spi_read_data(hx711_spi_t *dev, int32_t *data)
+{
+    CHECK_ARG(dev && dev->spi && data);
+
+    return transfer(dev, dev->gain, data);
+}
+
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file hx711_spi.h
+ * @defgroup hx711_spi hx711_spi
+ * @{
+ *
+ * SPI backend of ESP-IDF driver for HX711 24-bit ADC for weigh scales
+ *
+ * Several HX711 share PD_SCK line which is driven by SPI clock, DOUT of
+ * every device is connected to its own SPI data line. Up to 4 devices are
+ * read simultaneously in quad SPI mode, the whole transfer is done by
+ * hardware.
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __HX711_SPI_H__
+#define __HX711_SPI_H__
+
+#include <esp_idf_lib_helpers.h>
+
+#if HELPER_TARGET_IS_ESP32 || defined(__DOXYGEN__)
+
+#include <driver/spi_master.h>
+#include "hx711.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximal number of devices on a single SPI bus
+ */
+#define HX711_SPI_MAX_LANES 4
+
+/**
+ * Device group descriptor
+ */
+typedef struct
+{
+    spi_host_device_t host;                 //!< SPI host, bus must not be used by anything else
+    gpio_num_t pd_sck;                      //!< Common PD_SCK line
+    gpio_num_t dout[HX711_SPI_MAX_LANES];   //!< DOUT lines, SPI D0, D1, D2, D3
+    size_t lanes;                           //!< Number of devices: 1, 2 or 4
+    hx711_gain_t gain;                      //!< Gain and channel of all devices
+    spi_device_handle_t spi;                //!< SPI device handle, set by hx711_spi_init()
+} hx711_spi_t;
+
+/**
+ * @brief Initialize device group
+ *
+ * Initializes SPI bus, adds device with half-duplex 1 MHz mode 1 timing,
+ * waits for all devices to be ready and sets gain.
+ *
+ * With 1 lane DOUT is connected to MISO, with 2 lanes dual SPI mode is
+ * used, with 4 lanes quad SPI mode.
+ *
+ * @param dev Device group descriptor
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if devices not found
+ */
+esp_err_t hx711_spi_init(hx711_spi_t *dev);
+
+/**
+ * @brief Free device group
+ *
+ * Removes SPI device and frees SPI bus
+ *
+ * @param dev Device group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_spi_free(hx711_spi_t *dev);
+
+/**
+ * @brief Set gain and channel of all devices
+ *
+ * @param dev Device group descriptor
+ * @param gain Gain + channel value
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if devices not ready
+ */
+esp_err_t hx711_spi_set_gain(hx711_spi_t *dev, hx711_gain_t gain);
+
+/**
+ * @brief Wait for all devices of the group to become ready
+ *
+ * @param dev Device group descriptor
+ * @param timeout_ms Maximum time to wait, milliseconds
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_spi_wait(hx711_spi_t *dev, size_t timeout_ms);
+
+/**
+ * @brief Read raw data from all devices at once
+ *
+ * Call this function only when all devices are ready.
+ *
+ * @param dev Device group descriptor
+ * @param[out] data Raw ADC data, `dev->lanes` values in order of `dev->dout`
+ * @return `ESP_OK` on success
+ */
+esp_err_t hx711_spi_read_data(hx711_spi_t *dev, int32_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}*/
+
+#endif /* __HX711_SPI_H__ */
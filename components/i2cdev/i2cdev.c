@@ -31,30 +31,227 @@
  * MIT Licensed as described in the file LICENSE
  */
 #include <string.h>
+#include <stdlib.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_log.h>
+#include <esp_idf_lib_trace.h>
+#if CONFIG_I2CDEV_STATS || CONFIG_I2CDEV_BREAKER
+#include <esp_timer.h>
+#endif
 #include "i2cdev.h"
+#include "i2cdev_soft.h"
+#include "i2cdev_ng.h"
 
 static const char *TAG = "i2cdev";
 
+#define TRACE_ARG(dev) (((uint32_t)(dev)->port << 8) | (dev)->addr)
+
+#if CONFIG_I2CDEV_STATIC_CMD_LINK && !I2CDEV_USE_NG_DRIVER && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 4, 0)
+#define USE_STATIC_CMD_LINK 1
+// Enough for a write transaction followed by a scatter read transaction
+#define CMD_LINK_BUF_SIZE I2C_LINK_RECOMMENDED_SIZE(2 + I2C_DEV_READV_MAX_SEGMENTS)
+#else
+#define USE_STATIC_CMD_LINK 0
+#endif
+
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+#define IS_SOFT_PORT(port) ((port) >= I2C_NUM_MAX)
+#else
+#define IS_SOFT_PORT(port) false
+#endif
+
+#if CONFIG_I2CDEV_BREAKER
+// Failure counter of a device, devices behind muxes are told apart by channels
+typedef struct {
+    uint8_t addr;
+    uint8_t mux_addr;
+    uint8_t mux_channels;
+    uint8_t failures;
+    uint32_t backoff_ms;
+    int64_t retry_at;
+} breaker_t;
+#endif
+
+#if CONFIG_I2CDEV_STATS
+// Device of a statistics entry, same device on different mux channels is a different device
+typedef struct {
+    uint8_t addr;
+    uint8_t mux_addr;
+    uint8_t mux_channels;
+} stats_key_t;
+#endif
+
+#if CONFIG_I2CDEV_SPEED_TUNING
+// Runtime clock speed limit of a device
+typedef struct {
+    uint8_t addr;
+    uint8_t mux_addr;
+    uint8_t mux_channels;
+    uint8_t transfers;
+    uint8_t errors;
+    uint32_t clk_speed;
+} speed_limit_t;
+#endif
+
+#if CONFIG_I2CDEV_SCAN
+// Scan result of a port or of a mux channel selection
+typedef struct {
+    uint8_t mux_addr;
+    uint8_t mux_channels;
+    uint32_t present[4];
+} presence_t;
+#endif
+
 typedef struct {
     SemaphoreHandle_t lock;
     i2c_config_t config;
+    const i2c_dev_bus_t *bus; // Shared bus the port is configured for, NULL if unknown
     bool installed;
+#if HELPER_TARGET_IS_ESP32
+    uint32_t timeout;
+#endif
+#if USE_STATIC_CMD_LINK
+    uint8_t cmd_buf[CMD_LINK_BUF_SIZE];
+#endif
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    i2c_soft_bus_t soft;
+#endif
+#if I2CDEV_USE_NG_DRIVER
+    i2c_ng_bus_t ng;
+#endif
+    QueueHandle_t async_queue;
+    TaskHandle_t async_task;
+    TaskHandle_t async_stopper;
+    SemaphoreHandle_t sched_lock;
+    TaskHandle_t sched_task;
+    TaskHandle_t sched_stopper;
+    i2c_dev_job_t *jobs;
+    i2c_dev_job_t *sched_current;
+    bool sched_current_listed;
+    volatile bool sched_stop;
+    TaskHandle_t session_task;
+    struct {
+        uint8_t addr;
+        uint8_t channels;
+        bool known;
+    } muxes[I2CDEV_MAX_MUXES];
+#if CONFIG_I2CDEV_STATS
+    i2c_dev_stats_t stats;
+    stats_key_t dev_keys[CONFIG_I2CDEV_STATS_MAX_DEVICES];
+    i2c_dev_stats_t dev_stats[CONFIG_I2CDEV_STATS_MAX_DEVICES];
+    size_t dev_count;
+#endif
+#if CONFIG_I2CDEV_BREAKER
+    breaker_t breakers[CONFIG_I2CDEV_BREAKER_MAX_DEVICES];
+    size_t breaker_count;
+#endif
+#if CONFIG_I2CDEV_SPEED_TUNING
+    speed_limit_t limits[CONFIG_I2CDEV_SPEED_TUNING_MAX_DEVICES];
+    size_t limit_count;
+#endif
+#if CONFIG_I2CDEV_SCAN
+    presence_t presence[CONFIG_I2CDEV_SCAN_MAX_SEGMENTS];
+    size_t presence_count;
+#endif
 } i2c_port_state_t;
 
-static i2c_port_state_t states[I2C_NUM_MAX];
+static i2c_port_state_t states[I2CDEV_PORT_COUNT];
+
+#if CONFIG_I2CDEV_STATS
+
+#define STATS_LOCK_BEGIN() int64_t __lock_start = esp_timer_get_time()
+#define STATS_LOCK_END(port) states[port].stats.lock_wait_us += esp_timer_get_time() - __lock_start
+
+static i2c_dev_stats_t *find_dev_stats(const i2c_dev_t *dev, bool create)
+{
+    i2c_port_state_t *st = &states[dev->port];
+    for (size_t i = 0; i < st->dev_count; i++)
+        if (st->dev_keys[i].addr == dev->addr && st->dev_keys[i].mux_addr == dev->mux_addr
+                && st->dev_keys[i].mux_channels == dev->mux_channels)
+            return &st->dev_stats[i];
+    if (!create || st->dev_count >= CONFIG_I2CDEV_STATS_MAX_DEVICES)
+        return NULL;
+    stats_key_t *k = &st->dev_keys[st->dev_count];
+    k->addr = dev->addr;
+    k->mux_addr = dev->mux_addr;
+    k->mux_channels = dev->mux_channels;
+    return &st->dev_stats[st->dev_count++];
+}
+
+static void stats_update(i2c_dev_stats_t *stats, size_t bytes, uint32_t us, esp_err_t res)
+{
+    stats->transactions++;
+    stats->bus_time_us += us;
+
+    size_t bucket = 0;
+    while (us > 1 && bucket < I2C_DEV_STATS_HIST_SIZE - 1)
+    {
+        us >>= 1;
+        bucket++;
+    }
+    stats->latency_hist[bucket]++;
+
+    if (res == ESP_OK)
+    {
+        stats->bytes += bytes;
+        return;
+    }
+
+    stats->errors++;
+    for (size_t i = 0; i < I2C_DEV_STATS_ERR_CODES; i++)
+    {
+        if (stats->error_codes[i].code == res || !stats->error_codes[i].count)
+        {
+            stats->error_codes[i].code = res;
+            stats->error_codes[i].count++;
+            return;
+        }
+    }
+}
+
+static void stats_record(const i2c_dev_t *dev, size_t bytes, uint32_t us, esp_err_t res)
+{
+    stats_update(&states[dev->port].stats, bytes, us, res);
+    i2c_dev_stats_t *ds = find_dev_stats(dev, true);
+    if (ds)
+        stats_update(ds, bytes, us, res);
+}
+
+#define STATS_BUS_BEGIN() int64_t __bus_start = esp_timer_get_time()
+#define STATS_BUS_END(dev, bytes, res) stats_record(dev, bytes, esp_timer_get_time() - __bus_start, res)
+
+#else
+
+#define STATS_LOCK_BEGIN()
+#define STATS_LOCK_END(port)
+#define STATS_BUS_BEGIN()
+#define STATS_BUS_END(dev, bytes, res)
+
+#endif
+
+// Failed transfers of quiet devices are expected and logged at debug level
+#define LOG_XFER_ERROR(dev, fmt, ...) do { \
+        if ((dev)->quiet) \
+            ESP_LOGD(TAG, fmt, ## __VA_ARGS__); \
+        else \
+            ESP_LOGE(TAG, fmt, ## __VA_ARGS__); \
+    } while (0)
 
 #if CONFIG_I2CDEV_NOLOCK
 #define SEMAPHORE_TAKE(port)
 #else
 #define SEMAPHORE_TAKE(port) do { \
+        STATS_LOCK_BEGIN(); \
+        ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C_LOCK, port); \
         if (!xSemaphoreTake(states[port].lock, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT))) \
         { \
+            ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C_LOCK); \
             ESP_LOGE(TAG, "Could not take port mutex %d", port); \
             return ESP_ERR_TIMEOUT; \
         } \
+        ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C_LOCK); \
+        STATS_LOCK_END(port); \
         } while (0)
 #endif
 
@@ -70,12 +267,33 @@ static i2c_port_state_t states[I2C_NUM_MAX];
         } while (0)
 #endif
 
+#if CONFIG_I2CDEV_NOLOCK
+#define PORT_TAKE(port)
+#define PORT_GIVE(port)
+#else
+// Port lock is already held if the task is inside i2c_dev_session_begin()
+#define PORT_TAKE(port) \
+        bool __in_session = states[port].session_task == xTaskGetCurrentTaskHandle(); \
+        if (!__in_session) SEMAPHORE_TAKE(port)
+#define PORT_GIVE(port) do { if (!__in_session) SEMAPHORE_GIVE(port); } while (0)
+#endif
+
+static void driver_delete(i2c_port_t port)
+{
+    if (IS_SOFT_PORT(port)) return;
+#if I2CDEV_USE_NG_DRIVER
+    i2c_ng_delete(&states[port].ng);
+#else
+    i2c_driver_delete(port);
+#endif
+}
+
 esp_err_t i2cdev_init()
 {
     memset(states, 0, sizeof(states));
 
 #if !CONFIG_I2CDEV_NOLOCK
-    for (int i = 0; i < I2C_NUM_MAX; i++)
+    for (int i = 0; i < I2CDEV_PORT_COUNT; i++)
     {
         states[i].lock = xSemaphoreCreateMutex();
         if (!states[i].lock)
@@ -91,14 +309,17 @@ esp_err_t i2cdev_init()
 
 esp_err_t i2cdev_done()
 {
-    for (int i = 0; i < I2C_NUM_MAX; i++)
+    for (int i = 0; i < I2CDEV_PORT_COUNT; i++)
     {
+        i2c_dev_async_done(i);
+        i2c_dev_sched_done(i);
+
         if (!states[i].lock) continue;
 
         if (states[i].installed)
         {
             SEMAPHORE_TAKE(i);
-            i2c_driver_delete(i);
+            driver_delete(i);
             states[i].installed = false;
             SEMAPHORE_GIVE(i);
         }
@@ -110,11 +331,58 @@ esp_err_t i2cdev_done()
     return ESP_OK;
 }
 
+esp_err_t i2c_dev_set_bus(i2c_dev_t *dev, const i2c_dev_bus_t *bus)
+{
+    if (!dev) return ESP_ERR_INVALID_ARG;
+
+    dev->bus = bus;
+    return ESP_OK;
+}
+
+#if !CONFIG_I2CDEV_NOLOCK && CONFIG_I2CDEV_LAZY_MUTEX
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mutex_mux = portMUX_INITIALIZER_UNLOCKED;
+#define MUTEX_ENTER_CRITICAL portENTER_CRITICAL(&mutex_mux)
+#define MUTEX_EXIT_CRITICAL portEXIT_CRITICAL(&mutex_mux)
+#else
+#define MUTEX_ENTER_CRITICAL portENTER_CRITICAL()
+#define MUTEX_EXIT_CRITICAL portEXIT_CRITICAL()
+#endif
+
+static esp_err_t lazy_mutex(i2c_dev_t *dev)
+{
+    if (dev->mutex) return ESP_OK;
+
+    // Mutex cannot be created in a critical section, so two tasks may race
+    // here. Loser deletes its mutex.
+    SemaphoreHandle_t m = xSemaphoreCreateMutex();
+    if (!m)
+    {
+        ESP_LOGE(TAG, "[0x%02x at %d] Could not create device mutex", dev->addr, dev->port);
+        return ESP_ERR_NO_MEM;
+    }
+    MUTEX_ENTER_CRITICAL;
+    bool won = !dev->mutex;
+    if (won)
+        dev->mutex = m;
+    MUTEX_EXIT_CRITICAL;
+    if (!won)
+        vSemaphoreDelete(m);
+    return ESP_OK;
+}
+#endif
+
 esp_err_t i2c_dev_create_mutex(i2c_dev_t *dev)
 {
 #if !CONFIG_I2CDEV_NOLOCK
     if (!dev) return ESP_ERR_INVALID_ARG;
 
+#if CONFIG_I2CDEV_LAZY_MUTEX
+    // Created on first use
+    dev->mutex = NULL;
+    return ESP_OK;
+#endif
+
     ESP_LOGV(TAG, "[0x%02x at %d] creating mutex", dev->addr, dev->port);
 
     dev->mutex = xSemaphoreCreateMutex();
@@ -135,7 +403,9 @@ esp_err_t i2c_dev_delete_mutex(i2c_dev_t *dev)
 
     ESP_LOGV(TAG, "[0x%02x at %d] deleting mutex", dev->addr, dev->port);
 
-    vSemaphoreDelete(dev->mutex);
+    if (dev->mutex)
+        vSemaphoreDelete(dev->mutex);
+    dev->mutex = NULL;
 #endif
     return ESP_OK;
 }
@@ -147,7 +417,16 @@ esp_err_t i2c_dev_take_mutex(i2c_dev_t *dev)
 
     ESP_LOGV(TAG, "[0x%02x at %d] taking mutex", dev->addr, dev->port);
 
-    if (!xSemaphoreTake(dev->mutex, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT)))
+#if CONFIG_I2CDEV_LAZY_MUTEX
+    esp_err_t res = lazy_mutex(dev);
+    if (res != ESP_OK)
+        return res;
+#endif
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C_DEV_LOCK, TRACE_ARG(dev));
+    BaseType_t taken = xSemaphoreTake(dev->mutex, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT));
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C_DEV_LOCK);
+    if (!taken)
     {
         ESP_LOGE(TAG, "[0x%02x at %d] Could not take device mutex", dev->addr, dev->port);
         return ESP_ERR_TIMEOUT;
@@ -172,133 +451,1730 @@ esp_err_t i2c_dev_give_mutex(i2c_dev_t *dev)
     return ESP_OK;
 }
 
-inline static bool cfg_equal(const i2c_config_t *a, const i2c_config_t *b)
+inline static const i2c_config_t *dev_cfg(const i2c_dev_t *dev)
+{
+    return dev->bus ? &dev->bus->cfg : &dev->cfg;
+}
+
+#if CONFIG_I2CDEV_SPEED_TUNING
+
+// Speeds tried by i2c_dev_tune_speed() and steps of runtime degradation
+static const uint32_t tune_speeds[] = { 1000000, 800000, 400000, 200000, 100000 };
+
+static speed_limit_t *find_limit(const i2c_dev_t *dev, bool create)
+{
+    i2c_port_state_t *st = &states[dev->port];
+    for (size_t i = 0; i < st->limit_count; i++)
+        if (st->limits[i].addr == dev->addr && st->limits[i].mux_addr == dev->mux_addr
+                && st->limits[i].mux_channels == dev->mux_channels)
+            return &st->limits[i];
+    if (!create || st->limit_count >= CONFIG_I2CDEV_SPEED_TUNING_MAX_DEVICES)
+        return NULL;
+    speed_limit_t *l = &st->limits[st->limit_count++];
+    memset(l, 0, sizeof(*l));
+    l->addr = dev->addr;
+    l->mux_addr = dev->mux_addr;
+    l->mux_channels = dev->mux_channels;
+    return l;
+}
+
+static uint32_t clk_speed(const i2c_dev_t *dev)
+{
+    speed_limit_t *l = find_limit(dev, false);
+    return l && l->clk_speed && l->clk_speed < dev_cfg(dev)->master.clk_speed
+        ? l->clk_speed
+        : dev_cfg(dev)->master.clk_speed;
+}
+
+static void speed_record(const i2c_dev_t *dev, esp_err_t res)
+{
+    // NACKs of quiet devices are not caused by the clock
+    if (dev->quiet || (res != ESP_OK && res != ESP_FAIL && res != ESP_ERR_TIMEOUT))
+        return;
+    speed_limit_t *l = find_limit(dev, res != ESP_OK);
+    if (!l) return;
+
+    if (res != ESP_OK)
+        l->errors++;
+    if (++l->transfers < CONFIG_I2CDEV_SPEED_TUNING_WINDOW && l->errors < CONFIG_I2CDEV_SPEED_TUNING_ERRORS)
+        return;
+
+    if (l->errors >= CONFIG_I2CDEV_SPEED_TUNING_ERRORS)
+    {
+        uint32_t speed = clk_speed(dev);
+        for (size_t i = 0; i < sizeof(tune_speeds) / sizeof(tune_speeds[0]); i++)
+            if (tune_speeds[i] < speed)
+            {
+                ESP_LOGW(TAG, "Device [0x%02x at %d]: %d errors in %d transfers, clock %u -> %u Hz",
+                        dev->addr, dev->port, l->errors, l->transfers, (unsigned)speed, (unsigned)tune_speeds[i]);
+                l->clk_speed = tune_speeds[i];
+                break;
+            }
+    }
+    l->transfers = 0;
+    l->errors = 0;
+}
+
+#define SPEED_RECORD(dev, res) speed_record(dev, res)
+
+#else
+
+#define clk_speed(dev) (dev_cfg(dev)->master.clk_speed)
+#define SPEED_RECORD(dev, res)
+
+#endif
+
+inline static bool pins_equal(const i2c_config_t *a, const i2c_config_t *b)
 {
     return a->scl_io_num == b->scl_io_num
         && a->sda_io_num == b->sda_io_num
+        && a->scl_pullup_en == b->scl_pullup_en
+        && a->sda_pullup_en == b->sda_pullup_en;
+}
+
+inline static uint32_t stretch_ticks(const i2c_dev_t *dev)
+{
+    // Timeout cannot be 0
+    uint32_t ticks = dev->bus ? dev->bus->timeout_ticks : dev->timeout_ticks;
+    return ticks ? ticks : I2CDEV_MAX_STRETCH_TIME;
+}
+
+// Clock stretch timeout in microseconds (80 MHz APB ticks), at least 1 us
+inline static uint32_t stretch_us(const i2c_dev_t *dev)
+{
+    uint32_t us = stretch_ticks(dev) / 80;
+    return us ? us : 1;
+}
+
+inline static bool cfg_equal(const i2c_dev_t *dev, const i2c_config_t *b)
+{
+    return pins_equal(dev_cfg(dev), b)
 #if HELPER_TARGET_IS_ESP32
-        && a->master.clk_speed == b->master.clk_speed
+        && clk_speed(dev) == b->master.clk_speed;
 #elif HELPER_TARGET_IS_ESP8266
-        && a->clk_stretch_tick == b->clk_stretch_tick
+        // Stretch time is taken from the descriptor, not from cfg
+        && stretch_ticks(dev) == b->clk_stretch_tick;
 #endif
-        && a->scl_pullup_en == b->scl_pullup_en
-        && a->sda_pullup_en == b->sda_pullup_en;
 }
 
-static esp_err_t i2c_setup_port(const i2c_dev_t *dev)
+// Devices of the shared bus the port is configured for differ only in tuned clock speed
+inline static bool same_bus(const i2c_dev_t *dev, const i2c_port_state_t *st)
+{
+    return dev->bus && dev->bus == st->bus
+#if CONFIG_I2CDEV_SPEED_TUNING && HELPER_TARGET_IS_ESP32
+        && clk_speed(dev) == st->config.master.clk_speed
+#endif
+        ;
+}
+
+static esp_err_t setup_bus(const i2c_dev_t *dev)
 {
-    if (dev->port >= I2C_NUM_MAX) return ESP_ERR_INVALID_ARG;
+    if (dev->port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
 
+    i2c_port_state_t *st = &states[dev->port];
     esp_err_t res;
-    if (!cfg_equal(&dev->cfg, &states[dev->port].config))
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    if (IS_SOFT_PORT(dev->port))
+    {
+        if (!st->installed || (!same_bus(dev, st)
+                && (!cfg_equal(dev, &st->config) || st->timeout != stretch_ticks(dev))))
+        {
+            ESP_LOGD(TAG, "Reconfiguring software I2C port %d", dev->port);
+            i2c_config_t temp;
+            memcpy(&temp, dev_cfg(dev), sizeof(i2c_config_t));
+            temp.master.clk_speed = clk_speed(dev);
+            // Stretch time is in 80MHz APB ticks as for hardware ports
+            if ((res = i2c_soft_setup(&st->soft, &temp, stretch_us(dev))) != ESP_OK)
+                return res;
+            memcpy(&st->config, &temp, sizeof(i2c_config_t));
+            st->timeout = stretch_ticks(dev);
+            st->bus = dev->bus;
+            st->installed = true;
+        }
+        return ESP_OK;
+    }
+#endif
+#if I2CDEV_USE_NG_DRIVER
+    // Clock speed and stretch time are set in device handles
+    if (!st->installed || (!same_bus(dev, st) && !pins_equal(dev_cfg(dev), &st->config)))
+    {
+        ESP_LOGD(TAG, "Creating I2C bus on port %d", dev->port);
+        st->installed = false;
+        if ((res = i2c_ng_setup(&st->ng, dev->port, dev_cfg(dev))) != ESP_OK)
+            return res;
+        memcpy(&st->config, dev_cfg(dev), sizeof(i2c_config_t));
+        st->bus = dev->bus;
+        st->installed = true;
+    }
+    return ESP_OK;
+#else
+    if (!st->installed || (!same_bus(dev, st) && !cfg_equal(dev, &st->config)))
     {
         ESP_LOGD(TAG, "Reconfiguring I2C driver on port %d", dev->port);
         i2c_config_t temp;
-        memcpy(&temp, &dev->cfg, sizeof(i2c_config_t));
+        memcpy(&temp, dev_cfg(dev), sizeof(i2c_config_t));
         temp.mode = I2C_MODE_MASTER;
 
-        // Driver reinstallation
-        if (states[dev->port].installed)
-            i2c_driver_delete(dev->port);
 #if HELPER_TARGET_IS_ESP32
-        if ((res = i2c_param_config(dev->port, &temp)) != ESP_OK)
-            return res;
-        if ((res = i2c_driver_install(dev->port, temp.mode, 0, 0, 0)) != ESP_OK)
-            return res;
+        temp.master.clk_speed = clk_speed(dev);
+        if (st->installed && pins_equal(&temp, &st->config))
+        {
+            // Only clock speed differs, reprogram installed driver in place
+            if ((res = i2c_param_config(dev->port, &temp)) != ESP_OK)
+                return res;
+        }
+        else
+        {
+            // Driver reinstallation
+            if (st->installed)
+                i2c_driver_delete(dev->port);
+            st->installed = false;
+            if ((res = i2c_param_config(dev->port, &temp)) != ESP_OK)
+                return res;
+            if ((res = i2c_driver_install(dev->port, temp.mode, 0, 0, 0)) != ESP_OK)
+                return res;
+        }
+        // Bus timing reconfiguration resets the timeout
+        st->timeout = 0;
 #endif
 #if HELPER_TARGET_IS_ESP8266
+        // Driver reinstallation
+        if (st->installed)
+            i2c_driver_delete(dev->port);
+        st->installed = false;
         // Clock Stretch time, depending on CPU frequency
-        temp.clk_stretch_tick = dev->timeout_ticks ? dev->timeout_ticks : I2CDEV_MAX_STRETCH_TIME;
+        temp.clk_stretch_tick = stretch_ticks(dev);
         if ((res = i2c_driver_install(dev->port, temp.mode)) != ESP_OK)
             return res;
         if ((res = i2c_param_config(dev->port, &temp)) != ESP_OK)
             return res;
 #endif
-        states[dev->port].installed = true;
+        st->installed = true;
 
-        memcpy(&states[dev->port].config, &temp, sizeof(i2c_config_t));
+        memcpy(&st->config, &temp, sizeof(i2c_config_t));
+        st->bus = dev->bus;
         ESP_LOGD(TAG, "I2C driver successfully reconfigured on port %d", dev->port);
     }
 #if HELPER_TARGET_IS_ESP32
-    int t;
-    if ((res = i2c_get_timeout(dev->port, &t)) != ESP_OK)
-        return res;
-    // Timeout cannot be 0
-    uint32_t ticks = dev->timeout_ticks ? dev->timeout_ticks : I2CDEV_MAX_STRETCH_TIME;
-    if ((ticks != t) && (res = i2c_set_timeout(dev->port, ticks)) != ESP_OK)
-        return res;
-    ESP_LOGD(TAG, "Timeout: ticks = %d (%d usec) on port %d", dev->timeout_ticks, dev->timeout_ticks / 80, dev->port);
+    // Cached value is used to avoid reading timeout from hardware on each transfer
+    uint32_t ticks = stretch_ticks(dev);
+    if (ticks != st->timeout)
+    {
+        if ((res = i2c_set_timeout(dev->port, ticks)) != ESP_OK)
+            return res;
+        st->timeout = ticks;
+        ESP_LOGD(TAG, "Timeout: ticks = %d (%d usec) on port %d", ticks, ticks / 80, dev->port);
+    }
 #endif
 
     return ESP_OK;
+#endif
 }
 
-esp_err_t i2c_dev_read(const i2c_dev_t *dev, const void *out_data, size_t out_size, void *in_data, size_t in_size)
-{
-    if (!dev || !in_data || !in_size) return ESP_ERR_INVALID_ARG;
+#if I2CDEV_USE_NG_DRIVER
 
-    SEMAPHORE_TAKE(dev->port);
+inline static i2c_ng_dev_t ng_dev(const i2c_dev_t *dev)
+{
+    i2c_ng_dev_t d = {
+        .addr = dev->addr,
+        .clk_speed = clk_speed(dev),
+        .stretch_us = stretch_us(dev),
+    };
+    return d;
+}
 
-    esp_err_t res = i2c_setup_port(dev);
-    if (res == ESP_OK)
-    {
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
-        if (out_data && out_size)
-        {
-            i2c_master_start(cmd);
-            i2c_master_write_byte(cmd, dev->addr << 1, true);
-            i2c_master_write(cmd, (void *)out_data, out_size, true);
-        }
-        i2c_master_start(cmd);
-        i2c_master_write_byte(cmd, (dev->addr << 1) | 1, true);
-        i2c_master_read(cmd, in_data, in_size, I2C_MASTER_LAST_NACK);
-        i2c_master_stop(cmd);
+#else
 
-        res = i2c_master_cmd_begin(dev->port, cmd, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT));
-        if (res != ESP_OK)
-            ESP_LOGE(TAG, "Could not read from device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+// Command link buffers are protected by the port lock
+inline static i2c_cmd_handle_t cmd_link_create(i2c_port_t port)
+{
+#if USE_STATIC_CMD_LINK
+    return i2c_cmd_link_create_static(states[port].cmd_buf, CMD_LINK_BUF_SIZE);
+#else
+    return i2c_cmd_link_create();
+#endif
+}
 
-        i2c_cmd_link_delete(cmd);
-    }
+inline static void cmd_link_delete(i2c_cmd_handle_t cmd)
+{
+#if USE_STATIC_CMD_LINK
+    i2c_cmd_link_delete_static(cmd);
+#else
+    i2c_cmd_link_delete(cmd);
+#endif
+}
 
-    SEMAPHORE_GIVE(dev->port);
+static esp_err_t cmd_begin(const i2c_dev_t *dev, i2c_cmd_handle_t cmd, size_t bytes)
+{
+    STATS_BUS_BEGIN();
+    esp_err_t res = i2c_master_cmd_begin(dev->port, cmd, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT));
+    STATS_BUS_END(dev, bytes, res);
     return res;
 }
 
-esp_err_t i2c_dev_write(const i2c_dev_t *dev, const void *out_reg, size_t out_reg_size, const void *out_data, size_t out_size)
+#endif
+
+static esp_err_t exec_write(const i2c_dev_t *dev, const void *out_reg, size_t out_reg_size, const void *out_data, size_t out_size)
 {
-    if (!dev || !out_data || !out_size) return ESP_ERR_INVALID_ARG;
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    if (IS_SOFT_PORT(dev->port))
+    {
+        STATS_BUS_BEGIN();
+        esp_err_t res = i2c_soft_write(&states[dev->port].soft, dev->addr, out_reg, out_reg_size, out_data, out_size);
+        STATS_BUS_END(dev, out_reg_size + out_size, res);
+        if (res != ESP_OK)
+            LOG_XFER_ERROR(dev, "Could not write to device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+        return res;
+    }
+#endif
+#if I2CDEV_USE_NG_DRIVER
+    i2c_ng_dev_t d = ng_dev(dev);
+    STATS_BUS_BEGIN();
+    esp_err_t res = i2c_ng_write(&states[dev->port].ng, &d, out_reg, out_reg_size, out_data, out_size);
+    STATS_BUS_END(dev, out_reg_size + out_size, res);
+    if (res != ESP_OK)
+        LOG_XFER_ERROR(dev, "Could not write to device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+    return res;
+#else
+    i2c_cmd_handle_t cmd = cmd_link_create(dev->port);
+    if (!cmd) return ESP_ERR_NO_MEM;
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, dev->addr << 1, true);
+    if (out_reg && out_reg_size)
+        i2c_master_write(cmd, (void *)out_reg, out_reg_size, true);
+    i2c_master_write(cmd, (void *)out_data, out_size, true);
+    i2c_master_stop(cmd);
 
-    SEMAPHORE_TAKE(dev->port);
+    esp_err_t res = cmd_begin(dev, cmd, out_reg_size + out_size);
+    if (res != ESP_OK)
+        LOG_XFER_ERROR(dev, "Could not write to device [0x%02x at %d]: %d", dev->addr, dev->port, res);
 
-    esp_err_t res = i2c_setup_port(dev);
-    if (res == ESP_OK)
+    cmd_link_delete(cmd);
+    return res;
+#endif
+}
+
+static esp_err_t exec_readv(const i2c_dev_t *dev, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt)
+{
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    if (IS_SOFT_PORT(dev->port))
+    {
+        size_t total = 0;
+        for (size_t i = 0; i < iovcnt; i++)
+            total += iov[i].size;
+        STATS_BUS_BEGIN();
+        esp_err_t res = i2c_soft_readv(&states[dev->port].soft, dev->addr, out_data, out_size, iov, iovcnt);
+        STATS_BUS_END(dev, out_size + total, res);
+        if (res != ESP_OK)
+            LOG_XFER_ERROR(dev, "Could not read from device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+        return res;
+    }
+#endif
+#if I2CDEV_USE_NG_DRIVER
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; i++)
+        total += iov[i].size;
+    i2c_ng_dev_t d = ng_dev(dev);
+    STATS_BUS_BEGIN();
+    esp_err_t res = i2c_ng_readv(&states[dev->port].ng, &d, out_data, out_size, iov, iovcnt);
+    STATS_BUS_END(dev, out_size + total, res);
+    if (res != ESP_OK)
+        LOG_XFER_ERROR(dev, "Could not read from device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+    return res;
+#else
+    i2c_cmd_handle_t cmd = cmd_link_create(dev->port);
+    if (!cmd) return ESP_ERR_NO_MEM;
+    if (out_data && out_size)
     {
-        i2c_cmd_handle_t cmd = i2c_cmd_link_create();
         i2c_master_start(cmd);
         i2c_master_write_byte(cmd, dev->addr << 1, true);
-        if (out_reg && out_reg_size)
-            i2c_master_write(cmd, (void *)out_reg, out_reg_size, true);
         i2c_master_write(cmd, (void *)out_data, out_size, true);
-        i2c_master_stop(cmd);
-        res = i2c_master_cmd_begin(dev->port, cmd, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT));
-        if (res != ESP_OK)
-            ESP_LOGE(TAG, "Could not write to device [0x%02x at %d]: %d", dev->addr, dev->port, res);
-        i2c_cmd_link_delete(cmd);
     }
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, (dev->addr << 1) | 1, true);
+    // Last byte of the last segment must be NACKed
+    size_t total = 0;
+    size_t last = iovcnt - 1;
+    while (last && !iov[last].size)
+        last--;
+    for (size_t i = 0; i <= last; i++)
+    {
+        if (!iov[i].size) continue;
+        i2c_master_read(cmd, iov[i].data, iov[i].size, i == last ? I2C_MASTER_LAST_NACK : I2C_MASTER_ACK);
+        total += iov[i].size;
+    }
+    i2c_master_stop(cmd);
 
-    SEMAPHORE_GIVE(dev->port);
+    esp_err_t res = cmd_begin(dev, cmd, out_size + total);
+    if (res != ESP_OK)
+        LOG_XFER_ERROR(dev, "Could not read from device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+
+    cmd_link_delete(cmd);
     return res;
+#endif
 }
 
-esp_err_t i2c_dev_read_reg(const i2c_dev_t *dev, uint8_t reg,
-        void *in_data, size_t in_size)
+static esp_err_t mux_send(const i2c_dev_t *dev, int slot, uint8_t mux_addr, uint8_t channels)
 {
-    return i2c_dev_read(dev, &reg, 1, in_data, in_size);
+    i2c_port_state_t *st = &states[dev->port];
+
+    ESP_LOGV(TAG, "[0x%02x at %d] Selecting channels 0x%02x", mux_addr, dev->port, channels);
+
+    // Mux is on the same bus as the device
+    i2c_dev_t mux = *dev;
+    mux.addr = mux_addr;
+    esp_err_t res = exec_write(&mux, NULL, 0, &channels, 1);
+
+    if (slot >= 0)
+    {
+        st->muxes[slot].addr = mux_addr;
+        st->muxes[slot].channels = channels;
+        // Mux state is unknown after error
+        st->muxes[slot].known = res == ESP_OK;
+    }
+
+    return res;
 }
 
-esp_err_t i2c_dev_write_reg(const i2c_dev_t *dev, uint8_t reg,
-        const void *out_data, size_t out_size)
+static esp_err_t mux_write(const i2c_dev_t *dev, uint8_t mux_addr, uint8_t channels)
 {
-    return i2c_dev_write(dev, &reg, 1, out_data, out_size);
+    i2c_port_state_t *st = &states[dev->port];
+
+    int slot = -1;
+    for (int i = 0; i < I2CDEV_MAX_MUXES; i++)
+    {
+        if (st->muxes[i].addr == mux_addr)
+        {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && !st->muxes[i].addr)
+            slot = i;
+    }
+    if (slot >= 0 && st->muxes[slot].addr == mux_addr && st->muxes[slot].known
+            && st->muxes[slot].channels == channels)
+        return ESP_OK;
+
+    // Downstream buses of other muxes would be connected in parallel
+    // with the selected one, so their channels are switched off first
+    if (channels)
+        for (int i = 0; i < I2CDEV_MAX_MUXES; i++)
+        {
+            if (!st->muxes[i].addr || st->muxes[i].addr == mux_addr
+                    || (st->muxes[i].known && !st->muxes[i].channels))
+                continue;
+            esp_err_t res = mux_send(dev, i, st->muxes[i].addr, 0);
+            if (res != ESP_OK)
+                return res;
+        }
+
+    return mux_send(dev, slot, mux_addr, channels);
 }
+
+#if CONFIG_I2CDEV_BUS_RECOVERY
+
+#define RECOVERY_HALF_PERIOD_US 5
+
+// Lines of an idle bus are high, the port lock is held here, so nobody
+// else can be in the middle of a transfer
+inline static bool bus_stuck(i2c_port_t port)
+{
+    return !gpio_get_level(states[port].config.sda_io_num)
+        || !gpio_get_level(states[port].config.scl_io_num);
+}
+
+static esp_err_t bus_recover(i2c_port_t port)
+{
+    i2c_port_state_t *st = &states[port];
+    gpio_num_t sda = st->config.sda_io_num;
+    gpio_num_t scl = st->config.scl_io_num;
+
+    // Take the pins from the driver, setup_bus() installs it again
+    driver_delete(port);
+    st->installed = false;
+    // Muxes could have been reset together with the device
+    memset(st->muxes, 0, sizeof(st->muxes));
+
+    gpio_config_t io = {
+        .pin_bit_mask = (1ULL << sda) | (1ULL << scl),
+#if HELPER_TARGET_IS_ESP8266
+        .mode = GPIO_MODE_OUTPUT_OD,
+#else
+        .mode = GPIO_MODE_INPUT_OUTPUT_OD,
+#endif
+        .pull_up_en = st->config.sda_pullup_en || st->config.scl_pullup_en
+            ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    gpio_set_level(sda, 1);
+    gpio_set_level(scl, 1);
+    esp_err_t res = gpio_config(&io);
+    if (res != ESP_OK)
+        return res;
+    ets_delay_us(RECOVERY_HALF_PERIOD_US);
+
+    // A slave holding SDA low is in the middle of a byte it sends,
+    // clock it out until it releases the line, 9 clocks are enough
+    for (int i = 0; i < 9 && !gpio_get_level(sda); i++)
+    {
+        gpio_set_level(scl, 0);
+        ets_delay_us(RECOVERY_HALF_PERIOD_US);
+        gpio_set_level(scl, 1);
+        ets_delay_us(RECOVERY_HALF_PERIOD_US);
+    }
+
+    // STOP condition
+    gpio_set_level(scl, 0);
+    ets_delay_us(RECOVERY_HALF_PERIOD_US);
+    gpio_set_level(sda, 0);
+    ets_delay_us(RECOVERY_HALF_PERIOD_US);
+    gpio_set_level(scl, 1);
+    ets_delay_us(RECOVERY_HALF_PERIOD_US);
+    gpio_set_level(sda, 1);
+    ets_delay_us(RECOVERY_HALF_PERIOD_US);
+
+    if (bus_stuck(port))
+    {
+        ESP_LOGE(TAG, "Could not recover bus on port %d: SDA=%d, SCL=%d", port,
+                gpio_get_level(sda), gpio_get_level(scl));
+        return ESP_ERR_INVALID_STATE;
+    }
+    ESP_LOGW(TAG, "Bus on port %d recovered", port);
+    return ESP_OK;
+}
+
+#endif
+
+#if CONFIG_I2CDEV_BREAKER
+
+static size_t find_breaker(const i2c_dev_t *dev, bool create)
+{
+    i2c_port_state_t *st = &states[dev->port];
+    size_t i;
+    for (i = 0; i < st->breaker_count; i++)
+        if (st->breakers[i].addr == dev->addr && st->breakers[i].mux_addr == dev->mux_addr
+                && st->breakers[i].mux_channels == dev->mux_channels)
+            return i;
+    if (!create || st->breaker_count >= CONFIG_I2CDEV_BREAKER_MAX_DEVICES)
+        return SIZE_MAX;
+    memset(&st->breakers[i], 0, sizeof(st->breakers[i]));
+    st->breakers[i].addr = dev->addr;
+    st->breakers[i].mux_addr = dev->mux_addr;
+    st->breakers[i].mux_channels = dev->mux_channels;
+    st->breaker_count++;
+    return i;
+}
+
+static bool breaker_open(const i2c_dev_t *dev)
+{
+    if (dev->quiet) return false;
+    size_t i = find_breaker(dev, false);
+    if (i == SIZE_MAX) return false;
+    // After the backoff one transfer is let through as a probe
+    return states[dev->port].breakers[i].failures >= CONFIG_I2CDEV_BREAKER_THRESHOLD
+        && esp_timer_get_time() < states[dev->port].breakers[i].retry_at;
+}
+
+static void breaker_record(const i2c_dev_t *dev, esp_err_t res)
+{
+    // Quiet devices are expected to fail, e.g. while probing
+    if (dev->quiet || res == ESP_ERR_INVALID_ARG || res == ESP_ERR_NO_MEM || res == ESP_ERR_NOT_FINISHED
+            || res == ESP_ERR_NOT_FOUND)
+        return;
+    size_t i = find_breaker(dev, res != ESP_OK);
+    if (i == SIZE_MAX) return;
+
+    breaker_t *b = &states[dev->port].breakers[i];
+    if (res == ESP_OK)
+    {
+        if (b->failures >= CONFIG_I2CDEV_BREAKER_THRESHOLD)
+            ESP_LOGI(TAG, "Device [0x%02x at %d] responds again", dev->addr, dev->port);
+        b->failures = 0;
+        b->backoff_ms = 0;
+        return;
+    }
+    if (b->failures < UINT8_MAX)
+        b->failures++;
+    if (b->failures < CONFIG_I2CDEV_BREAKER_THRESHOLD)
+        return;
+
+    b->backoff_ms = b->backoff_ms ? b->backoff_ms * 2 : CONFIG_I2CDEV_BREAKER_BACKOFF_MS;
+    if (b->backoff_ms > CONFIG_I2CDEV_BREAKER_MAX_BACKOFF_MS)
+        b->backoff_ms = CONFIG_I2CDEV_BREAKER_MAX_BACKOFF_MS;
+    b->retry_at = esp_timer_get_time() + (int64_t)b->backoff_ms * 1000;
+    ESP_LOGW(TAG, "Device [0x%02x at %d] failed %d times, suspended for %u ms",
+            dev->addr, dev->port, b->failures, (unsigned)b->backoff_ms);
+}
+
+#define BREAKER_RECORD(dev, res) breaker_record(dev, res)
+
+#else
+
+#define BREAKER_RECORD(dev, res)
+
+#endif
+
+#if CONFIG_I2CDEV_SCAN
+
+#define PRESENT(map, addr) ((map)[(addr) / 32] & (1UL << ((addr) % 32)))
+
+static presence_t *find_presence(i2c_port_t port, uint8_t mux_addr, uint8_t mux_channels, bool create)
+{
+    i2c_port_state_t *st = &states[port];
+    for (size_t i = 0; i < st->presence_count; i++)
+        if (st->presence[i].mux_addr == mux_addr && st->presence[i].mux_channels == mux_channels)
+            return &st->presence[i];
+    if (!create || st->presence_count >= CONFIG_I2CDEV_SCAN_MAX_SEGMENTS)
+        return NULL;
+    presence_t *p = &st->presence[st->presence_count++];
+    memset(p, 0, sizeof(presence_t));
+    p->mux_addr = mux_addr;
+    p->mux_channels = mux_channels;
+    return p;
+}
+
+// Devices that did not respond to the scan are not accessed
+static bool absent(const i2c_dev_t *dev)
+{
+    if (dev->quiet) return false;
+    presence_t *p = find_presence(dev->port, dev->mux_addr, dev->mux_channels, false);
+    return p && !PRESENT(p->present, dev->addr);
+}
+
+static esp_err_t exec_probe(const i2c_dev_t *dev)
+{
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    if (IS_SOFT_PORT(dev->port))
+        return i2c_soft_write(&states[dev->port].soft, dev->addr, NULL, 0, NULL, 0);
+#endif
+#if I2CDEV_USE_NG_DRIVER
+    return i2c_ng_probe(&states[dev->port].ng, dev->addr, CONFIG_I2CDEV_SCAN_TIMEOUT);
+#else
+    i2c_cmd_handle_t cmd = cmd_link_create(dev->port);
+    if (!cmd) return ESP_ERR_NO_MEM;
+    i2c_master_start(cmd);
+    i2c_master_write_byte(cmd, dev->addr << 1, true);
+    i2c_master_stop(cmd);
+    esp_err_t res = i2c_master_cmd_begin(dev->port, cmd, pdMS_TO_TICKS(CONFIG_I2CDEV_SCAN_TIMEOUT));
+    cmd_link_delete(cmd);
+    return res;
+#endif
+}
+
+#endif
+
+#define XFER_RECORD(dev, res) do { BREAKER_RECORD(dev, res); SPEED_RECORD(dev, res); } while (0)
+
+static esp_err_t i2c_setup_port(const i2c_dev_t *dev)
+{
+#if CONFIG_I2CDEV_BREAKER
+    if (breaker_open(dev))
+        return ESP_ERR_NOT_FINISHED;
+#endif
+#if CONFIG_I2CDEV_SCAN
+    if (absent(dev))
+        return ESP_ERR_NOT_FOUND;
+#endif
+    esp_err_t res = setup_bus(dev);
+#if CONFIG_I2CDEV_BUS_RECOVERY
+    if (res == ESP_OK && bus_stuck(dev->port))
+    {
+        ESP_LOGW(TAG, "Bus on port %d is stuck, recovering", dev->port);
+        if ((res = bus_recover(dev->port)) == ESP_OK)
+            res = setup_bus(dev);
+    }
+#endif
+    if (res == ESP_OK && dev->mux_addr)
+        res = mux_write(dev, dev->mux_addr, dev->mux_channels);
+    return res;
+}
+
+static esp_err_t exec_read(const i2c_dev_t *dev, const void *out_data, size_t out_size, void *in_data, size_t in_size)
+{
+    i2c_dev_iovec_t iov = { .data = in_data, .size = in_size };
+    return exec_readv(dev, out_data, out_size, &iov, 1);
+}
+
+static esp_err_t read_locked(const i2c_dev_t *dev, const void *out_data, size_t out_size, void *in_data, size_t in_size)
+{
+    PORT_TAKE(dev->port);
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C, TRACE_ARG(dev));
+    esp_err_t res = i2c_setup_port(dev);
+    if (res == ESP_OK)
+        res = exec_read(dev, out_data, out_size, in_data, in_size);
+    XFER_RECORD(dev, res);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C);
+
+    PORT_GIVE(dev->port);
+    return res;
+}
+
+// Port lock is released after every chunk, waiting tasks of higher
+// priority take it before we do
+static esp_err_t read_chunked(const i2c_dev_t *dev, const uint8_t *reg, size_t reg_size, uint8_t *in_data, size_t in_size)
+{
+    uint16_t addr = reg_size == 2 ? (reg[0] << 8) | reg[1] : reg[0];
+    uint8_t buf[2];
+
+    while (in_size)
+    {
+        size_t len = in_size < dev->max_chunk ? in_size : dev->max_chunk;
+        if (reg_size == 2)
+        {
+            buf[0] = addr >> 8;
+            buf[1] = addr;
+        }
+        else
+            buf[0] = addr;
+
+        esp_err_t res = read_locked(dev, buf, reg_size, in_data, len);
+        if (res != ESP_OK)
+            return res;
+
+        in_data += len;
+        in_size -= len;
+        if (!dev->chunk_same_reg)
+            addr += len;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_read(const i2c_dev_t *dev, const void *out_data, size_t out_size, void *in_data, size_t in_size)
+{
+    if (!dev || !in_data || !in_size) return ESP_ERR_INVALID_ARG;
+
+    if (dev->max_chunk && in_size > dev->max_chunk && out_data && (out_size == 1 || out_size == 2))
+        return read_chunked(dev, out_data, out_size, in_data, in_size);
+
+    return read_locked(dev, out_data, out_size, in_data, in_size);
+}
+
+esp_err_t i2c_dev_readv(const i2c_dev_t *dev, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt)
+{
+    if (!dev || !iov || !iovcnt || iovcnt > I2C_DEV_READV_MAX_SEGMENTS) return ESP_ERR_INVALID_ARG;
+
+    size_t total = 0;
+    for (size_t i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].size && !iov[i].data) return ESP_ERR_INVALID_ARG;
+        total += iov[i].size;
+    }
+    if (!total) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(dev->port);
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C, TRACE_ARG(dev));
+    esp_err_t res = i2c_setup_port(dev);
+    if (res == ESP_OK)
+        res = exec_readv(dev, out_data, out_size, iov, iovcnt);
+    XFER_RECORD(dev, res);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C);
+
+    PORT_GIVE(dev->port);
+    return res;
+}
+
+esp_err_t i2c_dev_write(const i2c_dev_t *dev, const void *out_reg, size_t out_reg_size, const void *out_data, size_t out_size)
+{
+    if (!dev || !out_data || !out_size) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(dev->port);
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C, TRACE_ARG(dev));
+    esp_err_t res = i2c_setup_port(dev);
+    if (res == ESP_OK)
+        res = exec_write(dev, out_reg, out_reg_size, out_data, out_size);
+    XFER_RECORD(dev, res);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C);
+
+    PORT_GIVE(dev->port);
+    return res;
+}
+
+esp_err_t i2c_dev_read_reg(const i2c_dev_t *dev, uint8_t reg,
+        void *in_data, size_t in_size)
+{
+    return i2c_dev_read(dev, &reg, 1, in_data, in_size);
+}
+
+esp_err_t i2c_dev_write_reg(const i2c_dev_t *dev, uint8_t reg,
+        const void *out_data, size_t out_size)
+{
+    return i2c_dev_write(dev, &reg, 1, out_data, out_size);
+}
+
+#if CONFIG_I2CDEV_REG_CACHE
+
+static i2c_dev_cache_entry_t *cache_find(const i2c_dev_t *dev, uint8_t reg, size_t size)
+{
+    i2c_dev_cache_t *cache = dev->cache;
+    if (!cache || cache->reg_size != size)
+        return NULL;
+    for (size_t i = 0; i < cache->count; i++)
+        if (cache->entries[i].reg == reg)
+            return &cache->entries[i];
+    return NULL;
+}
+
+esp_err_t i2c_dev_cache_create(i2c_dev_t *dev, const uint8_t *regs, size_t count, size_t reg_size)
+{
+    if (!dev || !regs || !count || !reg_size || reg_size > I2C_DEV_CACHE_MAX_REG_SIZE)
+        return ESP_ERR_INVALID_ARG;
+
+    i2c_dev_cache_t *cache = calloc(1, sizeof(i2c_dev_cache_t) + count * sizeof(i2c_dev_cache_entry_t));
+    if (!cache)
+    {
+        ESP_LOGE(TAG, "[0x%02x at %d] Could not allocate register cache", dev->addr, dev->port);
+        return ESP_ERR_NO_MEM;
+    }
+    cache->reg_size = reg_size;
+    cache->count = count;
+    for (size_t i = 0; i < count; i++)
+        cache->entries[i].reg = regs[i];
+
+    free(dev->cache);
+    dev->cache = cache;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_delete(i2c_dev_t *dev)
+{
+    if (!dev) return ESP_ERR_INVALID_ARG;
+
+    free(dev->cache);
+    dev->cache = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_invalidate(i2c_dev_t *dev)
+{
+    if (!dev) return ESP_ERR_INVALID_ARG;
+
+    if (dev->cache)
+    {
+        for (size_t i = 0; i < dev->cache->count; i++)
+            dev->cache->entries[i].valid = dev->cache->entries[i].dirty = false;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_flush(const i2c_dev_t *dev)
+{
+    if (!dev) return ESP_ERR_INVALID_ARG;
+    if (!dev->cache) return ESP_OK;
+
+    for (size_t i = 0; i < dev->cache->count; i++)
+    {
+        i2c_dev_cache_entry_t *e = &dev->cache->entries[i];
+        if (!e->dirty) continue;
+        esp_err_t res = i2c_dev_write_reg(dev, e->reg, e->value, dev->cache->reg_size);
+        if (res != ESP_OK)
+            return res;
+        e->dirty = false;
+    }
+
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t i2c_dev_cache_create(i2c_dev_t *dev, const uint8_t *regs, size_t count, size_t reg_size)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_delete(i2c_dev_t *dev)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_invalidate(i2c_dev_t *dev)
+{
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_cache_flush(const i2c_dev_t *dev)
+{
+    return ESP_OK;
+}
+
+#define cache_find(dev, reg, size) ((i2c_dev_cache_entry_t *)NULL)
+
+#endif
+
+esp_err_t i2c_dev_read_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        void *in_data, size_t in_size)
+{
+    if (!dev || !in_data || !in_size) return ESP_ERR_INVALID_ARG;
+
+    i2c_dev_cache_entry_t *e = cache_find(dev, reg, in_size);
+    if (e && e->valid)
+    {
+        memcpy(in_data, e->value, in_size);
+        return ESP_OK;
+    }
+
+    esp_err_t res = i2c_dev_read_reg(dev, reg, in_data, in_size);
+    if (res == ESP_OK && e)
+    {
+        memcpy(e->value, in_data, in_size);
+        e->valid = true;
+    }
+
+    return res;
+}
+
+esp_err_t i2c_dev_write_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        const void *out_data, size_t out_size)
+{
+    if (!dev || !out_data || !out_size) return ESP_ERR_INVALID_ARG;
+
+    i2c_dev_cache_entry_t *e = cache_find(dev, reg, out_size);
+    if (e && e->valid && !e->dirty && !memcmp(e->value, out_data, out_size))
+        return ESP_OK;
+
+    esp_err_t res = i2c_dev_write_reg(dev, reg, out_data, out_size);
+    if (e)
+    {
+        // On error the register state is unknown
+        e->valid = res == ESP_OK;
+        e->dirty = false;
+        memcpy(e->value, out_data, out_size);
+    }
+
+    return res;
+}
+
+esp_err_t i2c_dev_update_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        const void *mask, const void *value, size_t size, bool defer)
+{
+    if (!dev || !mask || !value || !size || size > I2C_DEV_CACHE_MAX_REG_SIZE)
+        return ESP_ERR_INVALID_ARG;
+
+    uint8_t buf[I2C_DEV_CACHE_MAX_REG_SIZE];
+    esp_err_t res = i2c_dev_read_reg_cached(dev, reg, buf, size);
+    if (res != ESP_OK)
+        return res;
+
+    const uint8_t *m = mask, *v = value;
+    for (size_t i = 0; i < size; i++)
+        buf[i] = (buf[i] & ~m[i]) | (v[i] & m[i]);
+
+    i2c_dev_cache_entry_t *e = cache_find(dev, reg, size);
+    if (defer && e)
+    {
+        if (memcmp(e->value, buf, size))
+        {
+            memcpy(e->value, buf, size);
+            e->dirty = true;
+        }
+        return ESP_OK;
+    }
+
+    return i2c_dev_write_reg_cached(dev, reg, buf, size);
+}
+
+esp_err_t i2c_dev_transactions(i2c_port_t port, i2c_dev_transaction_t *trans, size_t count)
+{
+    if (port >= I2CDEV_PORT_COUNT || !trans || !count) return ESP_ERR_INVALID_ARG;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!trans[i].dev || trans[i].dev->port != port || !trans[i].data || !trans[i].size)
+            return ESP_ERR_INVALID_ARG;
+        trans[i].result = ESP_ERR_INVALID_STATE;
+    }
+
+    PORT_TAKE(port);
+
+    esp_err_t res = ESP_OK;
+    const i2c_dev_t *last = NULL;
+    for (size_t i = 0; i < count; i++)
+    {
+        i2c_dev_transaction_t *t = &trans[i];
+
+        // Port setup is needed only when the device changes
+        ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C, TRACE_ARG(t->dev));
+        esp_err_t r = ESP_OK;
+        if (t->dev != last)
+        {
+            r = i2c_setup_port(t->dev);
+            last = r == ESP_OK ? t->dev : NULL;
+        }
+        if (r == ESP_OK)
+            r = t->op == I2C_DEV_OP_READ
+                ? exec_read(t->dev, t->reg, t->reg_size, t->data, t->size)
+                : exec_write(t->dev, t->reg, t->reg_size, t->data, t->size);
+        XFER_RECORD(t->dev, r);
+        ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C);
+
+        t->result = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    PORT_GIVE(port);
+    return res;
+}
+
+#if !CONFIG_I2CDEV_NOLOCK
+static esp_err_t session_lock(i2c_port_t port)
+{
+    SEMAPHORE_TAKE(port);
+    states[port].session_task = xTaskGetCurrentTaskHandle();
+    return ESP_OK;
+}
+
+static esp_err_t session_unlock(i2c_port_t port)
+{
+    states[port].session_task = NULL;
+    SEMAPHORE_GIVE(port);
+    return ESP_OK;
+}
+#endif
+
+esp_err_t i2c_dev_session_begin(i2c_dev_t *dev)
+{
+    if (!dev || dev->port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t res = i2c_dev_take_mutex(dev);
+    if (res != ESP_OK)
+        return res;
+#if !CONFIG_I2CDEV_NOLOCK
+    res = session_lock(dev->port);
+    if (res != ESP_OK)
+        i2c_dev_give_mutex(dev);
+#endif
+
+    return res;
+}
+
+esp_err_t i2c_dev_session_end(i2c_dev_t *dev)
+{
+    if (!dev || dev->port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+#if !CONFIG_I2CDEV_NOLOCK
+    esp_err_t res = session_unlock(dev->port);
+    if (res != ESP_OK)
+        return res;
+#endif
+
+    return i2c_dev_give_mutex(dev);
+}
+
+static void async_worker(void *arg)
+{
+    i2c_port_t port = (i2c_port_t)(intptr_t)arg;
+    i2c_dev_async_t *req;
+
+    while (true)
+    {
+        if (xQueueReceive(states[port].async_queue, &req, portMAX_DELAY) != pdTRUE)
+            continue;
+        // NULL request is a stop signal
+        if (!req)
+            break;
+
+        i2c_dev_transactions(port, &req->trans, 1);
+
+        // request may be reused or freed as soon as it is marked done,
+        // so it is not touched after the store
+        i2c_dev_async_cb_t cb = req->cb;
+        void *ctx = req->ctx;
+        TaskHandle_t task = req->task;
+        __atomic_store_n(&req->done, true, __ATOMIC_RELEASE);
+        if (cb)
+            cb(&req->trans, ctx);
+        else
+            xTaskNotifyGive(task);
+    }
+
+    xTaskNotifyGive(states[port].async_stopper);
+    vTaskDelete(NULL);
+}
+
+esp_err_t i2c_dev_async_init(i2c_port_t port, size_t queue_size, UBaseType_t priority)
+{
+    if (port >= I2CDEV_PORT_COUNT || !queue_size) return ESP_ERR_INVALID_ARG;
+    if (states[port].async_task) return ESP_ERR_INVALID_STATE;
+
+    states[port].async_queue = xQueueCreate(queue_size, sizeof(i2c_dev_async_t *));
+    if (!states[port].async_queue)
+    {
+        ESP_LOGE(TAG, "Could not create async queue for port %d", port);
+        return ESP_ERR_NO_MEM;
+    }
+    if (xTaskCreate(async_worker, "i2cdev_async", CONFIG_I2CDEV_ASYNC_STACK_SIZE,
+            (void *)(intptr_t)port, priority, &states[port].async_task) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create async worker for port %d", port);
+        vQueueDelete(states[port].async_queue);
+        states[port].async_queue = NULL;
+        states[port].async_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_async_done(i2c_port_t port)
+{
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+    if (!states[port].async_task) return ESP_OK;
+
+    i2c_dev_async_t *stop = NULL;
+    states[port].async_stopper = xTaskGetCurrentTaskHandle();
+    xQueueSendToBack(states[port].async_queue, &stop, portMAX_DELAY);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    vQueueDelete(states[port].async_queue);
+    states[port].async_queue = NULL;
+    states[port].async_task = NULL;
+
+    return ESP_OK;
+}
+
+static esp_err_t async_submit(i2c_dev_async_t *req)
+{
+    i2c_port_t port = req->trans.dev->port;
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+    if (!states[port].async_queue) return ESP_ERR_INVALID_STATE;
+
+    req->task = xTaskGetCurrentTaskHandle();
+    req->done = false;
+    req->trans.result = ESP_ERR_INVALID_STATE;
+
+    if (xQueueSendToBack(states[port].async_queue, &req, pdMS_TO_TICKS(CONFIG_I2CDEV_TIMEOUT)) != pdTRUE)
+    {
+        ESP_LOGE(TAG, "[0x%02x at %d] Async queue is full", req->trans.dev->addr, port);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_read_async(i2c_dev_async_t *req, const i2c_dev_t *dev, const void *out_data,
+        size_t out_size, void *in_data, size_t in_size)
+{
+    if (!req || !dev || !in_data || !in_size) return ESP_ERR_INVALID_ARG;
+
+    req->trans.dev = dev;
+    req->trans.op = I2C_DEV_OP_READ;
+    req->trans.reg = out_data;
+    req->trans.reg_size = out_size;
+    req->trans.data = in_data;
+    req->trans.size = in_size;
+
+    return async_submit(req);
+}
+
+esp_err_t i2c_dev_write_async(i2c_dev_async_t *req, const i2c_dev_t *dev, const void *out_reg,
+        size_t out_reg_size, const void *out_data, size_t out_size)
+{
+    if (!req || !dev || !out_data || !out_size) return ESP_ERR_INVALID_ARG;
+
+    req->trans.dev = dev;
+    req->trans.op = I2C_DEV_OP_WRITE;
+    req->trans.reg = out_reg;
+    req->trans.reg_size = out_reg_size;
+    req->trans.data = (void *)out_data;
+    req->trans.size = out_size;
+
+    return async_submit(req);
+}
+
+esp_err_t i2c_dev_async_wait(i2c_dev_async_t *req, TickType_t timeout)
+{
+    if (!req) return ESP_ERR_INVALID_ARG;
+
+    TickType_t start = xTaskGetTickCount();
+    while (!__atomic_load_n(&req->done, __ATOMIC_ACQUIRE))
+    {
+        TickType_t elapsed = xTaskGetTickCount() - start;
+        if (elapsed >= timeout || !ulTaskNotifyTake(pdTRUE, timeout - elapsed))
+            return __atomic_load_n(&req->done, __ATOMIC_ACQUIRE) ? req->trans.result : ESP_ERR_TIMEOUT;
+    }
+
+    return req->trans.result;
+}
+
+#if CONFIG_I2CDEV_STATS
+
+esp_err_t i2c_dev_get_port_stats(i2c_port_t port, i2c_dev_stats_t *stats)
+{
+    if (port >= I2CDEV_PORT_COUNT || !stats) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(port);
+    memcpy(stats, &states[port].stats, sizeof(i2c_dev_stats_t));
+    PORT_GIVE(port);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_get_dev_stats(const i2c_dev_t *dev, i2c_dev_stats_t *stats)
+{
+    if (!dev || dev->port >= I2CDEV_PORT_COUNT || !stats) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(dev->port);
+    i2c_dev_stats_t *ds = find_dev_stats(dev, false);
+    if (ds)
+        memcpy(stats, ds, sizeof(i2c_dev_stats_t));
+    PORT_GIVE(dev->port);
+
+    return ds ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t i2c_dev_reset_stats(i2c_port_t port)
+{
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(port);
+    memset(&states[port].stats, 0, sizeof(i2c_dev_stats_t));
+    memset(states[port].dev_stats, 0, sizeof(states[port].dev_stats));
+    states[port].dev_count = 0;
+    PORT_GIVE(port);
+
+    return ESP_OK;
+}
+
+#endif
+
+// Tick counter can overflow, so times are compared by difference
+inline static bool tick_before(TickType_t a, TickType_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+inline static TickType_t job_deadline(const i2c_dev_job_t *job)
+{
+    return job->release + (job->deadline ? job->deadline : job->period);
+}
+
+static void sched_worker(void *arg)
+{
+    i2c_port_t port = (i2c_port_t)(intptr_t)arg;
+    i2c_port_state_t *st = &states[port];
+
+    while (!st->sched_stop)
+    {
+        // Select released job with the earliest deadline
+        xSemaphoreTake(st->sched_lock, portMAX_DELAY);
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = portMAX_DELAY;
+        i2c_dev_job_t *job = NULL;
+        for (i2c_dev_job_t *j = st->jobs; j; j = j->next)
+        {
+            if (tick_before(now, j->release))
+            {
+                if (j->release - now < wait)
+                    wait = j->release - now;
+                continue;
+            }
+            if (!job || tick_before(job_deadline(j), job_deadline(job)))
+                job = j;
+        }
+        if (job)
+        {
+            TickType_t delay = now - job->release;
+            if (delay > job->max_delay)
+                job->max_delay = delay;
+
+            // Callback runs unlocked, so it can add and remove jobs
+            i2c_dev_job_cb_t cb = job->cb;
+            const i2c_dev_t *dev = job->dev;
+            void *ctx = job->ctx;
+            st->sched_current = job;
+            st->sched_current_listed = true;
+            xSemaphoreGive(st->sched_lock);
+
+            cb(dev, ctx);
+
+            xSemaphoreTake(st->sched_lock, portMAX_DELAY);
+            st->sched_current = NULL;
+            // Job removed or re-added by the callback is not updated
+            if (st->sched_current_listed)
+            {
+                job->runs++;
+                now = xTaskGetTickCount();
+                if (tick_before(job_deadline(job), now))
+                    job->misses++;
+                job->release += job->period;
+                // Skip missed periods
+                if (tick_before(job->release, now))
+                    job->release = now;
+            }
+        }
+        xSemaphoreGive(st->sched_lock);
+
+        // Sleep until the next release or until the job list is changed
+        if (!job)
+            ulTaskNotifyTake(pdTRUE, wait);
+    }
+
+    xTaskNotifyGive(st->sched_stopper);
+    vTaskDelete(NULL);
+}
+
+esp_err_t i2c_dev_sched_init(i2c_port_t port, UBaseType_t priority)
+{
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    i2c_port_state_t *st = &states[port];
+    if (st->sched_task) return ESP_ERR_INVALID_STATE;
+
+    st->sched_lock = xSemaphoreCreateMutex();
+    if (!st->sched_lock)
+    {
+        ESP_LOGE(TAG, "Could not create scheduler mutex for port %d", port);
+        return ESP_ERR_NO_MEM;
+    }
+    st->jobs = NULL;
+    st->sched_current = NULL;
+    st->sched_stop = false;
+    if (xTaskCreate(sched_worker, "i2cdev_sched", CONFIG_I2CDEV_SCHED_STACK_SIZE,
+            (void *)(intptr_t)port, priority, &st->sched_task) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create scheduler task for port %d", port);
+        vSemaphoreDelete(st->sched_lock);
+        st->sched_lock = NULL;
+        st->sched_task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_sched_done(i2c_port_t port)
+{
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    i2c_port_state_t *st = &states[port];
+    if (!st->sched_task) return ESP_OK;
+
+    st->sched_stopper = xTaskGetCurrentTaskHandle();
+    st->sched_stop = true;
+    xTaskNotifyGive(st->sched_task);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    vSemaphoreDelete(st->sched_lock);
+    st->sched_lock = NULL;
+    st->sched_task = NULL;
+    st->jobs = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_sched_add(i2c_port_t port, i2c_dev_job_t *job)
+{
+    if (port >= I2CDEV_PORT_COUNT || !job || !job->cb || !job->period) return ESP_ERR_INVALID_ARG;
+
+    i2c_port_state_t *st = &states[port];
+    if (!st->sched_task) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(st->sched_lock, portMAX_DELAY);
+    for (i2c_dev_job_t *j = st->jobs; j; j = j->next)
+        if (j == job)
+        {
+            xSemaphoreGive(st->sched_lock);
+            return ESP_ERR_INVALID_STATE;
+        }
+    if (st->sched_current == job)
+        st->sched_current_listed = false;
+    job->runs = job->misses = 0;
+    job->max_delay = 0;
+    job->release = xTaskGetTickCount();
+    job->next = st->jobs;
+    st->jobs = job;
+    xSemaphoreGive(st->sched_lock);
+
+    xTaskNotifyGive(st->sched_task);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_sched_remove(i2c_port_t port, i2c_dev_job_t *job)
+{
+    if (port >= I2CDEV_PORT_COUNT || !job) return ESP_ERR_INVALID_ARG;
+
+    i2c_port_state_t *st = &states[port];
+    if (!st->sched_task) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t res = ESP_ERR_NOT_FOUND;
+    xSemaphoreTake(st->sched_lock, portMAX_DELAY);
+    for (i2c_dev_job_t **j = &st->jobs; *j; j = &(*j)->next)
+    {
+        if (*j == job)
+        {
+            *j = job->next;
+            job->next = NULL;
+            res = ESP_OK;
+            break;
+        }
+    }
+    if (st->sched_current == job)
+        st->sched_current_listed = false;
+    xSemaphoreGive(st->sched_lock);
+
+    // Job memory may be released after return, so wait for its callback
+    // running in the scheduler task
+    while (res == ESP_OK && xTaskGetCurrentTaskHandle() != st->sched_task)
+    {
+        xSemaphoreTake(st->sched_lock, portMAX_DELAY);
+        bool running = st->sched_current == job;
+        xSemaphoreGive(st->sched_lock);
+        if (!running)
+            break;
+        vTaskDelay(1);
+    }
+
+    return res;
+}
+
+esp_err_t i2c_dev_mux_select(const i2c_dev_t *mux, uint8_t channels)
+{
+    if (!mux || !mux->addr || mux->mux_addr) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(mux->port);
+
+    esp_err_t res = setup_bus(mux);
+    if (res == ESP_OK)
+        res = mux_write(mux, mux->addr, channels);
+
+    PORT_GIVE(mux->port);
+    return res;
+}
+
+#if CONFIG_I2CDEV_SPEED_TUNING
+
+// Shared bus objects are read-only, clock of their devices is limited in the table
+static esp_err_t set_speed(i2c_dev_t *dev, uint32_t speed)
+{
+    if (!dev->bus)
+    {
+        dev->cfg.master.clk_speed = speed;
+        return ESP_OK;
+    }
+    PORT_TAKE(dev->port);
+    speed_limit_t *l = find_limit(dev, true);
+    if (l)
+        l->clk_speed = speed;
+    PORT_GIVE(dev->port);
+    return l ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t i2c_dev_tune_speed(i2c_dev_t *dev, uint8_t reg, size_t size, uint32_t max_speed)
+{
+    if (!dev || !size || size > I2C_DEV_TUNE_MAX_SIZE || dev->port >= I2CDEV_PORT_COUNT)
+        return ESP_ERR_INVALID_ARG;
+
+    uint8_t ref[I2C_DEV_TUNE_MAX_SIZE], buf[I2C_DEV_TUNE_MAX_SIZE];
+    uint32_t saved = dev->bus ? 0 : dev->cfg.master.clk_speed;
+    bool quiet = dev->quiet;
+
+    PORT_TAKE(dev->port);
+    speed_limit_t *l = find_limit(dev, false);
+    if (l)
+    {
+        l->transfers = 0;
+        l->errors = 0;
+        l->clk_speed = 0;
+    }
+    PORT_GIVE(dev->port);
+
+    esp_err_t res = i2c_dev_read_reg(dev, reg, ref, size);
+    if (res != ESP_OK)
+        return res;
+
+    // Failures are expected here, they must not suspend or slow down the device
+    dev->quiet = true;
+    res = ESP_ERR_NOT_FOUND;
+    for (size_t i = 0; i < sizeof(tune_speeds) / sizeof(tune_speeds[0]) && res != ESP_OK; i++)
+    {
+        if (tune_speeds[i] > max_speed || (dev->bus && tune_speeds[i] > dev->bus->cfg.master.clk_speed))
+            continue;
+        if ((res = set_speed(dev, tune_speeds[i])) != ESP_OK)
+            break;
+        for (int n = 0; n < CONFIG_I2CDEV_SPEED_TUNING_READS && res == ESP_OK; n++)
+            if ((res = i2c_dev_read_reg(dev, reg, buf, size)) == ESP_OK && memcmp(ref, buf, size))
+                res = ESP_ERR_INVALID_RESPONSE;
+        ESP_LOGD(TAG, "[0x%02x at %d] %u Hz: %d", dev->addr, dev->port, (unsigned)tune_speeds[i], res);
+    }
+    dev->quiet = quiet;
+
+    if (res != ESP_OK)
+    {
+        set_speed(dev, saved);
+        return res == ESP_ERR_NO_MEM ? res : ESP_ERR_NOT_FOUND;
+    }
+    ESP_LOGI(TAG, "[0x%02x at %d] Clock speed %u Hz", dev->addr, dev->port, (unsigned)clk_speed(dev));
+    return ESP_OK;
+}
+
+#endif
+
+#if CONFIG_I2CDEV_SCAN
+
+typedef struct {
+    i2c_dev_scan_t *segments;
+    size_t count;
+    i2c_port_t port;
+    TaskHandle_t caller;
+} scan_job_t;
+
+static esp_err_t scan_segment(i2c_dev_scan_t *seg)
+{
+    // Descriptor of the segment is used for every probed address
+    i2c_dev_t dev = *seg->bus;
+    memset(seg->present, 0, sizeof(seg->present));
+
+    PORT_TAKE(dev.port);
+
+    esp_err_t res = setup_bus(&dev);
+#if CONFIG_I2CDEV_BUS_RECOVERY
+    if (res == ESP_OK && bus_stuck(dev.port) && (res = bus_recover(dev.port)) == ESP_OK)
+        res = setup_bus(&dev);
+#endif
+    if (res == ESP_OK && dev.mux_addr)
+        res = mux_write(&dev, dev.mux_addr, dev.mux_channels);
+    for (uint8_t addr = I2C_DEV_SCAN_FIRST_ADDR; res == ESP_OK && addr <= I2C_DEV_SCAN_LAST_ADDR; addr++)
+    {
+        dev.addr = addr;
+        esp_err_t r = exec_probe(&dev);
+        if (r == ESP_OK)
+            seg->present[addr / 32] |= 1UL << (addr % 32);
+        // NACK means no device, anything else is a bus problem
+        else if (r != ESP_FAIL)
+            res = r;
+    }
+    if (res == ESP_OK)
+    {
+        presence_t *p = find_presence(dev.port, dev.mux_addr, dev.mux_channels, true);
+        if (p)
+            memcpy(p->present, seg->present, sizeof(p->present));
+        else
+            ESP_LOGW(TAG, "Too many scanned segments on port %d", dev.port);
+    }
+
+    PORT_GIVE(dev.port);
+
+    if (res != ESP_OK)
+        ESP_LOGE(TAG, "Could not scan port %d, mux 0x%02x, channels 0x%02x: %d",
+                dev.port, dev.mux_addr, dev.mux_channels, res);
+    return res;
+}
+
+static void scan_port(scan_job_t *job)
+{
+    for (size_t i = 0; i < job->count; i++)
+        if (job->segments[i].bus->port == job->port)
+            job->segments[i].result = scan_segment(&job->segments[i]);
+}
+
+static void scan_worker(void *arg)
+{
+    scan_job_t *job = (scan_job_t *)arg;
+    scan_port(job);
+    xTaskNotifyGive(job->caller);
+    vTaskDelete(NULL);
+}
+
+esp_err_t i2c_dev_scan(i2c_dev_scan_t *segments, size_t count, UBaseType_t priority)
+{
+    if (!segments || !count) return ESP_ERR_INVALID_ARG;
+
+    bool used[I2CDEV_PORT_COUNT] = { 0 };
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!segments[i].bus || segments[i].bus->port >= I2CDEV_PORT_COUNT)
+            return ESP_ERR_INVALID_ARG;
+        used[segments[i].bus->port] = true;
+        segments[i].result = ESP_ERR_INVALID_STATE;
+    }
+
+    // Every port but the last one is scanned by its own task
+    scan_job_t jobs[I2CDEV_PORT_COUNT];
+    scan_job_t *own = NULL;
+    size_t started = 0;
+    for (int port = 0; port < I2CDEV_PORT_COUNT; port++)
+    {
+        if (!used[port]) continue;
+        scan_job_t *job = &jobs[port];
+        job->segments = segments;
+        job->count = count;
+        job->port = port;
+        job->caller = xTaskGetCurrentTaskHandle();
+        if (own)
+        {
+            if (xTaskCreate(scan_worker, "i2cdev_scan", CONFIG_I2CDEV_ASYNC_STACK_SIZE, own, priority, NULL) == pdPASS)
+                started++;
+            else
+                scan_port(own);
+        }
+        own = job;
+    }
+    scan_port(own);
+    while (started--)
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+
+    for (size_t i = 0; i < count; i++)
+        if (segments[i].result != ESP_OK)
+            return segments[i].result;
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_probe(const i2c_dev_t *dev)
+{
+    if (!dev || dev->port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(dev->port);
+
+    esp_err_t res = setup_bus(dev);
+    if (res == ESP_OK && dev->mux_addr)
+        res = mux_write(dev, dev->mux_addr, dev->mux_channels);
+    if (res == ESP_OK)
+    {
+        res = exec_probe(dev) == ESP_OK ? ESP_OK : ESP_ERR_NOT_FOUND;
+        presence_t *p = find_presence(dev->port, dev->mux_addr, dev->mux_channels, false);
+        if (p && res == ESP_OK)
+            p->present[dev->addr / 32] |= 1UL << (dev->addr % 32);
+        else if (p)
+            p->present[dev->addr / 32] &= ~(1UL << (dev->addr % 32));
+    }
+
+    PORT_GIVE(dev->port);
+    return res;
+}
+
+esp_err_t i2c_dev_scan_clear(i2c_port_t port)
+{
+    if (port >= I2CDEV_PORT_COUNT) return ESP_ERR_INVALID_ARG;
+
+    PORT_TAKE(port);
+    states[port].presence_count = 0;
+    PORT_GIVE(port);
+
+    return ESP_OK;
+}
+
+#endif
+
+#if CONFIG_I2CDEV_SMBUS
+
+// CRC-8, polynomial x^8 + x^2 + x + 1
+static const uint8_t pec_table[256] = {
+    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15, 0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+    0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65, 0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
+    0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5, 0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
+    0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85, 0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
+    0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2, 0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
+    0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2, 0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
+    0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32, 0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
+    0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42, 0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
+    0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c, 0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
+    0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec, 0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
+    0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c, 0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
+    0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c, 0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
+    0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b, 0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
+    0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b, 0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
+    0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb, 0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
+    0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb, 0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3
+};
+
+uint8_t i2c_dev_smbus_pec(uint8_t crc, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    while (size--)
+        crc = pec_table[crc ^ *p++];
+    return crc;
+}
+
+// Reads count byte, data and optional PEC into buf
+static esp_err_t exec_block_read(const i2c_dev_t *dev, uint8_t cmd, uint8_t *buf, size_t max, size_t extra)
+{
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+    if (IS_SOFT_PORT(dev->port))
+    {
+        STATS_BUS_BEGIN();
+        esp_err_t res = i2c_soft_block_read(&states[dev->port].soft, dev->addr, cmd, buf, max, extra);
+        STATS_BUS_END(dev, 2 + buf[0] + extra, res);
+        if (res != ESP_OK)
+            LOG_XFER_ERROR(dev, "Could not read block from device [0x%02x at %d]: %d", dev->addr, dev->port, res);
+        return res;
+    }
+#endif
+    // Length of hardware reads cannot depend on received data, read
+    // as much as the caller can take
+    return exec_read(dev, &cmd, 1, buf, 1 + max + extra);
+}
+
+esp_err_t i2c_dev_smbus_block_read(const i2c_dev_t *dev, uint8_t cmd, bool pec, void *data, size_t *size)
+{
+    if (!dev || !data || !size || !*size || *size > I2C_DEV_SMBUS_BLOCK_MAX) return ESP_ERR_INVALID_ARG;
+
+    uint8_t buf[I2C_DEV_SMBUS_BLOCK_MAX + 2];
+
+    PORT_TAKE(dev->port);
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_I2C, TRACE_ARG(dev));
+    esp_err_t res = i2c_setup_port(dev);
+    if (res == ESP_OK)
+        res = exec_block_read(dev, cmd, buf, *size, pec ? 1 : 0);
+    XFER_RECORD(dev, res);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_I2C);
+
+    PORT_GIVE(dev->port);
+
+    if (res != ESP_OK)
+        return res;
+
+    size_t count = buf[0];
+    if (count > *size)
+    {
+        LOG_XFER_ERROR(dev, "[0x%02x at %d] Block of %d bytes does not fit into %d", dev->addr, dev->port,
+                (int)count, (int)*size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (pec)
+    {
+        uint8_t hdr[] = { dev->addr << 1, cmd, (dev->addr << 1) | 1 };
+        uint8_t crc = i2c_dev_smbus_pec(i2c_dev_smbus_pec(0, hdr, sizeof(hdr)), buf, count + 1);
+        if (crc != buf[count + 1])
+        {
+            LOG_XFER_ERROR(dev, "[0x%02x at %d] Invalid PEC", dev->addr, dev->port);
+            return ESP_ERR_INVALID_CRC;
+        }
+    }
+    memcpy(data, buf + 1, count);
+    *size = count;
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_dev_smbus_block_write(const i2c_dev_t *dev, uint8_t cmd, bool pec, const void *data, size_t size)
+{
+    if (!dev || (size && !data) || size > I2C_DEV_SMBUS_BLOCK_MAX) return ESP_ERR_INVALID_ARG;
+
+    uint8_t buf[I2C_DEV_SMBUS_BLOCK_MAX + 2];
+    buf[0] = size;
+    if (size)
+        memcpy(buf + 1, data, size);
+    size_t len = size + 1;
+    if (pec)
+    {
+        uint8_t hdr[] = { dev->addr << 1, cmd };
+        buf[len] = i2c_dev_smbus_pec(i2c_dev_smbus_pec(0, hdr, sizeof(hdr)), buf, len);
+        len++;
+    }
+
+    return i2c_dev_write(dev, &cmd, 1, buf, len);
+}
+
+#endif
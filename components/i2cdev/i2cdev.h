@@ -38,6 +38,8 @@
 #include <driver/i2c.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/semphr.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
 #include <esp_err.h>
 #include <esp_idf_lib_helpers.h>
 
@@ -56,18 +58,114 @@ extern "C" {
 #endif
 #endif
 
+#define I2C_DEV_CACHE_MAX_REG_SIZE 4 //!< Maximal size of cached register, bytes
+
+/**
+ * Cached register
+ */
+typedef struct
+{
+    uint8_t reg;                               //!< Register address
+    bool valid;                                //!< Value is known
+    bool dirty;                                //!< Value is not yet written to device
+    uint8_t value[I2C_DEV_CACHE_MAX_REG_SIZE]; //!< Register value as it is on the bus
+} i2c_dev_cache_entry_t;
+
+/**
+ * Register shadow cache, see CONFIG_I2CDEV_REG_CACHE
+ */
+typedef struct
+{
+    size_t reg_size;                 //!< Size of each register, bytes
+    size_t count;                    //!< Number of cached registers
+    i2c_dev_cache_entry_t entries[]; //!< Cached registers
+} i2c_dev_cache_t;
+
+#ifndef CONFIG_I2CDEV_SOFT_PORTS
+#define CONFIG_I2CDEV_SOFT_PORTS 0
+#endif
+
+/**
+ * Number of the software (bit-banged) I2C port, n in range
+ * 0..CONFIG_I2CDEV_SOFT_PORTS - 1. Pins and clock speed are taken from the
+ * device descriptor as for hardware ports.
+ */
+#define I2CDEV_SOFT_PORT(n) ((i2c_port_t)(I2C_NUM_MAX + (n)))
+
+/**
+ * Total number of hardware and software I2C ports
+ */
+#define I2CDEV_PORT_COUNT (I2C_NUM_MAX + CONFIG_I2CDEV_SOFT_PORTS)
+
+/**
+ * Maximal number of tracked multiplexers per port
+ */
+#define I2CDEV_MAX_MUXES 8
+
+/**
+ * Shared I2C bus configuration
+ *
+ * Devices on the same bus may reference one bus object instead of carrying
+ * own copies of pins, clock speed and timeout, see ::i2c_dev_set_bus().
+ * The object must stay valid while devices reference it and must not be
+ * changed while they are used.
+ */
+typedef struct
+{
+    i2c_config_t cfg;       //!< I2C driver configuration
+    uint32_t timeout_ticks; /*!< HW I2C bus timeout (stretch time), same units as
+                                 i2c_dev_t::timeout_ticks. 0 for I2CDEV_MAX_STRETCH_TIME */
+} i2c_dev_bus_t;
+
 /**
  * I2C device descriptor
+ *
+ * When `bus` is not NULL, `cfg` and `timeout_ticks` are ignored and the bus
+ * configuration is taken from the shared bus object. The port checks it with
+ * one pointer comparison before every transfer.
+ *
+ * When `mux_addr` is non-zero, i2cdev selects `mux_channels` on the
+ * multiplexer before accessing the device. Currently selected channels are
+ * tracked for each multiplexer on the port, so selecting is done only when
+ * the channels change. Before channels of a multiplexer are selected,
+ * channels of other tracked multiplexers on the port are switched off.
+ * Selecting and access are performed under one port lock. Only one level
+ * of multiplexers is supported.
+ *
+ * When CONFIG_I2CDEV_BUS_RECOVERY is enabled, SDA and SCL are checked before
+ * every transfer. If a slave holds a line low (e.g. after a reset in the middle
+ * of a read), up to 9 clock pulses and a STOP are sent and the driver is
+ * reinstalled, so a stuck bus costs at most one timed out transfer.
+ *
+ * When CONFIG_I2CDEV_BREAKER is enabled, a device that failed
+ * CONFIG_I2CDEV_BREAKER_THRESHOLD transfers in a row is suspended: its
+ * transfers return ESP_ERR_NOT_FINISHED without touching the bus until the
+ * backoff time passes. Then one transfer is let through, the backoff doubles
+ * on every failed probe and is reset by the first successful transfer.
+ * Devices with `quiet` set are never suspended.
  */
 typedef struct
 {
-    i2c_port_t port;         //!< I2C port number
-    i2c_config_t cfg;        //!< I2C driver configuration
+    i2c_port_t port;         //!< I2C port number or I2CDEV_SOFT_PORT(n)
+    i2c_config_t cfg;        //!< I2C driver configuration, unused when `bus` is set
+    const i2c_dev_bus_t *bus; //!< Shared bus configuration, NULL to use `cfg` and `timeout_ticks`
     uint8_t addr;            //!< Unshifted address
     SemaphoreHandle_t mutex; //!< Device mutex
     uint32_t timeout_ticks;  /*!< HW I2C bus timeout (stretch time), in ticks. 80MHz APB clock
                                   ticks for ESP-IDF, CPU ticks for ESP8266.
                                   When this value is 0, I2CDEV_MAX_STRETCH_TIME will be used */
+#if CONFIG_I2CDEV_REG_CACHE
+    i2c_dev_cache_t *cache;  //!< Register shadow cache, NULL if not used
+#endif
+    uint8_t mux_addr;        /*!< Address of TCA9548-compatible multiplexer the device is
+                                  connected to, 0 if device is connected to the bus directly */
+    uint8_t mux_channels;    //!< Multiplexer channels to select before accessing the device
+    bool quiet;              /*!< Log failed transfers at debug level. Used by drivers of
+                                  devices which NACK while they are busy */
+    uint16_t max_chunk;      /*!< Maximal number of bytes read under one port lock, see
+                                  ::i2c_dev_read(). 0 if reads are never split */
+    bool chunk_same_reg;     /*!< Do not increment register address between chunks, e.g.
+                                  for FIFO data registers */
 } i2c_dev_t;
 
 /**
@@ -89,10 +187,25 @@ esp_err_t i2cdev_init();
  */
 esp_err_t i2cdev_done();
 
+/**
+ * @brief Attach device descriptor to a shared bus object
+ *
+ * Call it after the driver's init_desc() function. Pins, clock speed and
+ * timeout of the descriptor are replaced by the ones of the bus object.
+ *
+ * @param dev Device descriptor
+ * @param bus Shared bus configuration, NULL to use the descriptor's own `cfg`
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_set_bus(i2c_dev_t *dev, const i2c_dev_bus_t *bus);
+
 /**
  * @brief Create mutex for device descriptor
  *
  * This function does nothing if option CONFIG_I2CDEV_NOLOCK is enabled.
+ * When CONFIG_I2CDEV_LAZY_MUTEX is enabled, the mutex is created by the
+ * first ::i2c_dev_take_mutex() call, so devices which are never used do
+ * not consume heap for it.
  *
  * @param dev Device descriptor
  * @return ESP_OK on success
@@ -129,6 +242,31 @@ esp_err_t i2c_dev_take_mutex(i2c_dev_t *dev);
  */
 esp_err_t i2c_dev_give_mutex(i2c_dev_t *dev);
 
+/**
+ * @brief Begin bus session
+ *
+ * Takes device mutex and port lock at once. Until ::i2c_dev_session_end()
+ * transfers of the calling task on this port do not take the port lock
+ * again, so a sequence of register accesses (e.g. read-modify-write) costs
+ * two lock operations instead of one per transfer. Other tasks cannot use
+ * the port during the session, so do not wait for conversions inside it.
+ * Sessions cannot be nested.
+ *
+ * This function does nothing if option CONFIG_I2CDEV_NOLOCK is enabled.
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_session_begin(i2c_dev_t *dev);
+
+/**
+ * @brief End bus session started by ::i2c_dev_session_begin()
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_session_end(i2c_dev_t *dev);
+
 /**
  * @brief Read from slave device
  *
@@ -136,6 +274,16 @@ esp_err_t i2c_dev_give_mutex(i2c_dev_t *dev);
  * from slave into \p in_data .
  * Function is thread-safe.
  *
+ * Port lock is held for the whole transfer, so other tasks wait for long
+ * reads. If `max_chunk` of the descriptor is non-zero and \p out_data is
+ * a 1 or 2 byte (big-endian) register address, reads longer than
+ * `max_chunk` are split into several transfers of at most `max_chunk`
+ * bytes. Register address is incremented by the size of every chunk,
+ * unless `chunk_same_reg` is set, and port lock is released between
+ * chunks, so transactions of higher priority tasks are served in between.
+ * Use it only with devices which keep their state between transfers,
+ * e.g. EEPROMs, FRAM or FIFOs.
+ *
  * @param dev Device descriptor
  * @param out_data Pointer to data to send if non-null
  * @param out_size Size of data to send
@@ -190,6 +338,577 @@ esp_err_t i2c_dev_read_reg(const i2c_dev_t *dev, uint8_t reg,
 esp_err_t i2c_dev_write_reg(const i2c_dev_t *dev, uint8_t reg,
         const void *out_data, size_t out_size);
 
+/**
+ * @brief Create register shadow cache for device
+ *
+ * Registers in the list are cached after the first read or write made
+ * through ::i2c_dev_read_reg_cached(), ::i2c_dev_write_reg_cached() or
+ * ::i2c_dev_update_reg_cached(). Only registers that are never changed by
+ * the device itself may be cached.
+ * This function does nothing if option CONFIG_I2CDEV_REG_CACHE is disabled.
+ *
+ * @param dev Device descriptor
+ * @param regs Addresses of cacheable registers
+ * @param count Number of cacheable registers
+ * @param reg_size Size of each register, up to I2C_DEV_CACHE_MAX_REG_SIZE bytes
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_cache_create(i2c_dev_t *dev, const uint8_t *regs, size_t count, size_t reg_size);
+
+/**
+ * @brief Delete register shadow cache
+ *
+ * This function does nothing if option CONFIG_I2CDEV_REG_CACHE is disabled.
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_cache_delete(i2c_dev_t *dev);
+
+/**
+ * @brief Invalidate all cached values
+ *
+ * Must be called when the device registers were changed outside of the
+ * cache, e.g. after device reset. Dirty values are discarded.
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_cache_invalidate(i2c_dev_t *dev);
+
+/**
+ * @brief Write all dirty cached registers to device
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_cache_flush(const i2c_dev_t *dev);
+
+/**
+ * @brief Read register through the cache
+ *
+ * Returns cached value without bus access if it is known, otherwise
+ * works as ::i2c_dev_read_reg() and stores the value in the cache.
+ *
+ * @param dev Device descriptor
+ * @param reg Register address
+ * @param[out] in_data Pointer to input data buffer
+ * @param in_size Number of byte to read
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_read_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        void *in_data, size_t in_size);
+
+/**
+ * @brief Write register through the cache
+ *
+ * Works as ::i2c_dev_write_reg() and updates the cached value.
+ * Write is skipped when the cached value is known and equals to \p out_data .
+ *
+ * @param dev Device descriptor
+ * @param reg Register address
+ * @param out_data Pointer to data to send
+ * @param out_size Size of data to send
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_write_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        const void *out_data, size_t out_size);
+
+/**
+ * @brief Read-modify-write register through the cache
+ *
+ * New value is `(old & ~mask) | (value & mask)`, byte by byte. When the old
+ * value is cached, no bus read is made.
+ *
+ * @param dev Device descriptor
+ * @param reg Register address
+ * @param mask Pointer to mask, \p size bytes
+ * @param value Pointer to new bits, \p size bytes
+ * @param size Register size
+ * @param defer If true and register is cacheable, only mark the register
+ *              dirty; it will be written by ::i2c_dev_cache_flush()
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_update_reg_cached(const i2c_dev_t *dev, uint8_t reg,
+        const void *mask, const void *value, size_t size, bool defer);
+
+#define I2C_DEV_READV_MAX_SEGMENTS 8 //!< Maximal number of buffers in ::i2c_dev_readv()
+
+/**
+ * Buffer segment for scatter read
+ */
+typedef struct
+{
+    void *data;  //!< Pointer to buffer
+    size_t size; //!< Buffer size
+} i2c_dev_iovec_t;
+
+/**
+ * @brief Read from slave device into several buffers
+ *
+ * Same as ::i2c_dev_read(), but data is read in one I2C transaction
+ * into several buffers in order. Useful for reading device FIFOs directly
+ * into ring buffers.
+ * Function is thread-safe.
+ *
+ * @param dev Device descriptor
+ * @param out_data Pointer to data to send if non-null
+ * @param out_size Size of data to send
+ * @param iov Array of buffers
+ * @param iovcnt Number of buffers, up to I2C_DEV_READV_MAX_SEGMENTS
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_readv(const i2c_dev_t *dev, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt);
+
+/**
+ * @brief Select channels of I2C multiplexer
+ *
+ * Writes channel mask to TCA9548-compatible multiplexer and updates
+ * tracked multiplexer state used for devices with `mux_addr` set. Write is
+ * skipped when the channels are already selected.
+ * Function is thread-safe.
+ *
+ * @param mux Multiplexer device descriptor
+ * @param channels Channel mask
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_mux_select(const i2c_dev_t *mux, uint8_t channels);
+
+/**
+ * Transaction type
+ */
+typedef enum {
+    I2C_DEV_OP_READ = 0, //!< Send optional register address, then read data
+    I2C_DEV_OP_WRITE,    //!< Send optional register address, then write data
+} i2c_dev_op_t;
+
+/**
+ * Single transaction in a batch, see ::i2c_dev_transactions()
+ */
+typedef struct
+{
+    const i2c_dev_t *dev; //!< Device descriptor
+    i2c_dev_op_t op;      //!< Transaction type
+    const void *reg;      //!< Pointer to register address to send if non-null
+    size_t reg_size;      //!< Size of register address
+    void *data;           //!< Input buffer for reading, data to send for writing
+    size_t size;          //!< Number of bytes to read or write
+    esp_err_t result;     //!< [out] Result of the transaction
+} i2c_dev_transaction_t;
+
+/**
+ * @brief Execute a batch of transactions on one I2C port
+ *
+ * All transactions are executed one after another while holding the port
+ * lock, so there is no interleaving with other tasks. Port setup is performed
+ * only when the device differs from the previous transaction. Transactions
+ * may target several devices attached to the same port.
+ * The result of each transaction is stored in its `result` field, execution
+ * continues after a failed transaction.
+ * Function is thread-safe with respect to the port, but does not take
+ * device mutexes.
+ *
+ * @param port I2C port number, all devices in batch must be on this port
+ * @param trans Array of transactions
+ * @param count Number of transactions in array
+ * @return ESP_OK if all transactions succeeded, otherwise the first error
+ */
+esp_err_t i2c_dev_transactions(i2c_port_t port, i2c_dev_transaction_t *trans, size_t count);
+
+/**
+ * Completion callback of asynchronous transaction.
+ * Called from the port worker task.
+ */
+typedef void (*i2c_dev_async_cb_t)(i2c_dev_transaction_t *trans, void *ctx);
+
+/**
+ * Asynchronous transaction request.
+ *
+ * Memory for the request is owned by the caller and must stay valid
+ * until the transaction is completed.
+ */
+typedef struct
+{
+    i2c_dev_transaction_t trans; //!< Transaction, result is stored in `trans.result`
+    i2c_dev_async_cb_t cb;       //!< Completion callback, NULL to notify the submitting task
+    void *ctx;                   //!< Callback context
+    TaskHandle_t task;           //!< Task to notify on completion, set on submit
+    volatile bool done;          //!< true when the transaction is completed
+} i2c_dev_async_t;
+
+/**
+ * @brief Start asynchronous transaction worker for the port
+ *
+ * Creates a task that executes queued asynchronous transactions for all
+ * devices on the port.
+ *
+ * @param port I2C port number
+ * @param queue_size Maximal number of pending requests
+ * @param priority Worker task priority
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_async_init(i2c_port_t port, size_t queue_size, UBaseType_t priority);
+
+/**
+ * @brief Stop asynchronous transaction worker for the port
+ *
+ * Pending requests are executed before the worker stops.
+ *
+ * @param port I2C port number
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_async_done(i2c_port_t port);
+
+/**
+ * @brief Queue reading from slave device
+ *
+ * Same as ::i2c_dev_read(), but returns immediately. When the transaction
+ * is completed, `req->cb` is called from the worker task or, when it is
+ * NULL, the calling task is notified (see ::i2c_dev_async_wait()).
+ *
+ * @param req Request, `cb` and `ctx` fields must be set by the caller
+ * @param dev Device descriptor
+ * @param out_data Pointer to data to send if non-null
+ * @param out_size Size of data to send
+ * @param[out] in_data Pointer to input data buffer
+ * @param in_size Number of byte to read
+ * @return ESP_OK if request was queued
+ */
+esp_err_t i2c_dev_read_async(i2c_dev_async_t *req, const i2c_dev_t *dev, const void *out_data,
+        size_t out_size, void *in_data, size_t in_size);
+
+/**
+ * @brief Queue writing to slave device
+ *
+ * Same as ::i2c_dev_write(), but returns immediately. See
+ * ::i2c_dev_read_async() for completion details.
+ *
+ * @param req Request, `cb` and `ctx` fields must be set by the caller
+ * @param dev Device descriptor
+ * @param out_reg Pointer to register address to send if non-null
+ * @param out_reg_size Size of register address
+ * @param out_data Pointer to data to send
+ * @param out_size Size of data to send
+ * @return ESP_OK if request was queued
+ */
+esp_err_t i2c_dev_write_async(i2c_dev_async_t *req, const i2c_dev_t *dev, const void *out_reg,
+        size_t out_reg_size, const void *out_data, size_t out_size);
+
+/**
+ * @brief Wait for asynchronous transaction without callback
+ *
+ * Must be called from the task that submitted the request.
+ *
+ * @param req Request
+ * @param timeout Maximal time to wait, ticks
+ * @return Transaction result or ESP_ERR_TIMEOUT
+ */
+esp_err_t i2c_dev_async_wait(i2c_dev_async_t *req, TickType_t timeout);
+
+/**
+ * Periodic job callback.
+ * Called from the port scheduler task.
+ */
+typedef void (*i2c_dev_job_cb_t)(const i2c_dev_t *dev, void *ctx);
+
+/**
+ * Periodic job of the port scheduler.
+ *
+ * Memory for the job is owned by the caller and must stay valid
+ * until the job is removed.
+ */
+typedef struct i2c_dev_job_s
+{
+    const i2c_dev_t *dev;  //!< Device descriptor passed to callback
+    i2c_dev_job_cb_t cb;   //!< Job callback
+    void *ctx;             //!< Callback context
+    TickType_t period;     //!< Job period, ticks
+    TickType_t deadline;   //!< Relative deadline, ticks. 0 for deadline equal to period
+    uint32_t runs;         //!< [out] Number of executions
+    uint32_t misses;       //!< [out] Number of executions finished after the deadline
+    TickType_t max_delay;  //!< [out] Maximal delay from the release to the start of execution, ticks
+
+    TickType_t release;         //!< Internal: next release time
+    struct i2c_dev_job_s *next; //!< Internal: next job in list
+} i2c_dev_job_t;
+
+/**
+ * @brief Start periodic job scheduler for the port
+ *
+ * Creates a task that runs registered jobs earliest deadline first. Jobs
+ * accessing devices on one port from a single task do not compete for
+ * the port lock.
+ *
+ * @param port I2C port number
+ * @param priority Scheduler task priority
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_sched_init(i2c_port_t port, UBaseType_t priority);
+
+/**
+ * @brief Stop periodic job scheduler for the port
+ *
+ * Registered jobs are removed.
+ *
+ * @param port I2C port number
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_sched_done(i2c_port_t port);
+
+/**
+ * @brief Register periodic job
+ *
+ * First execution is released immediately. Can be called from job
+ * callbacks, e.g. to re-register a removed job with new parameters.
+ *
+ * @param port I2C port number
+ * @param job Job, fields `dev`, `cb`, `ctx`, `period` and `deadline` must be set
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if job is already registered
+ */
+esp_err_t i2c_dev_sched_add(i2c_port_t port, i2c_dev_job_t *job);
+
+/**
+ * @brief Remove periodic job
+ *
+ * Can be called from job callbacks. Called from another task, waits until
+ * the callback of the job finishes, if it is running.
+ *
+ * @param port I2C port number
+ * @param job Job
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if job is not registered
+ */
+esp_err_t i2c_dev_sched_remove(i2c_port_t port, i2c_dev_job_t *job);
+
+#if CONFIG_I2CDEV_STATS || defined(__DOXYGEN__)
+
+#define I2C_DEV_STATS_HIST_SIZE 16 //!< Number of latency histogram buckets
+#define I2C_DEV_STATS_ERR_CODES 4  //!< Number of distinct error codes counted separately
+
+/**
+ * Transaction statistics, see CONFIG_I2CDEV_STATS
+ */
+typedef struct
+{
+    uint32_t transactions; //!< Number of bus transactions
+    uint32_t bytes;        //!< Number of bytes transferred in successful transactions
+    uint32_t errors;       //!< Number of failed transactions
+    struct {
+        esp_err_t code;    //!< Error code
+        uint32_t count;    //!< Number of errors with this code
+    } error_codes[I2C_DEV_STATS_ERR_CODES]; //!< Errors by code, first codes seen
+    uint64_t lock_wait_us; //!< Total time spent waiting for the port lock, us (port only)
+    uint64_t bus_time_us;  //!< Total time spent in transactions, us
+    uint32_t latency_hist[I2C_DEV_STATS_HIST_SIZE]; /*!< Transaction time histogram. Bucket N
+                                                         counts transactions that took [2^N, 2^(N+1)) us,
+                                                         the first and the last buckets also count
+                                                         shorter and longer ones */
+} i2c_dev_stats_t;
+
+/**
+ * @brief Get statistics snapshot for the port
+ *
+ * Available when CONFIG_I2CDEV_STATS is enabled.
+ *
+ * @param port I2C port number
+ * @param[out] stats Statistics
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_get_port_stats(i2c_port_t port, i2c_dev_stats_t *stats);
+
+/**
+ * @brief Get statistics snapshot for the device
+ *
+ * Available when CONFIG_I2CDEV_STATS is enabled. Statistics are kept
+ * for the first CONFIG_I2CDEV_STATS_MAX_DEVICES devices seen on the port.
+ * Devices are told apart by address, multiplexer address and multiplexer
+ * channels, so devices with the same address behind different multiplexer
+ * channels have separate statistics. Field `lock_wait_us` is always 0 for
+ * devices.
+ *
+ * @param dev Device descriptor
+ * @param[out] stats Statistics
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if there are no statistics for the device
+ */
+esp_err_t i2c_dev_get_dev_stats(const i2c_dev_t *dev, i2c_dev_stats_t *stats);
+
+/**
+ * @brief Reset port and device statistics
+ *
+ * Available when CONFIG_I2CDEV_STATS is enabled.
+ *
+ * @param port I2C port number
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_reset_stats(i2c_port_t port);
+
+#endif
+
+#if CONFIG_I2CDEV_SPEED_TUNING || defined(__DOXYGEN__)
+
+#define I2C_DEV_TUNE_MAX_SIZE 8 //!< Maximal size of the register read by ::i2c_dev_tune_speed()
+
+/**
+ * @brief Find the highest reliable clock speed of the device
+ *
+ * Reads \p size bytes from register \p reg at the configured speed, then
+ * tries 1 MHz, 800, 400, 200 and 100 kHz, highest first, not above
+ * \p max_speed. The first speed at which CONFIG_I2CDEV_SPEED_TUNING_READS
+ * reads succeed and return the same data is kept. Register must not change
+ * between reads, e.g. chip ID or configuration register. Runtime limit of
+ * the device is reset.
+ *
+ * Where the tuned speed is stored depends on the descriptor:
+ *  - without shared bus object it is written to `dev->cfg.master.clk_speed`;
+ *  - with shared bus object (`dev->bus` is set) the bus configuration is
+ *    not changed, speeds above the bus speed are not tried and the tuned
+ *    speed is stored in the per-port speed limit table as the limit of
+ *    the device, the same entry which is lowered at runtime.
+ *
+ * Devices are reconfigured in place when only clock speed differs, so
+ * devices with different speeds can share a bus. When a device fails
+ * CONFIG_I2CDEV_SPEED_TUNING_ERRORS of CONFIG_I2CDEV_SPEED_TUNING_WINDOW
+ * transfers, its speed is lowered one step at runtime.
+ *
+ * Call it before the descriptor is shared with other tasks, e.g. in
+ * init functions of drivers. Available when CONFIG_I2CDEV_SPEED_TUNING
+ * is enabled.
+ *
+ * @param dev Device descriptor
+ * @param reg Register address
+ * @param size Number of bytes to read, 1..I2C_DEV_TUNE_MAX_SIZE
+ * @param max_speed Highest speed to try, Hz
+ * @return ESP_OK on success, ESP_ERR_NOT_FOUND if no speed works,
+ *         descriptor is not changed then
+ */
+esp_err_t i2c_dev_tune_speed(i2c_dev_t *dev, uint8_t reg, size_t size, uint32_t max_speed);
+
+#endif
+
+#if CONFIG_I2CDEV_SCAN || defined(__DOXYGEN__)
+
+#define I2C_DEV_SCAN_FIRST_ADDR 0x08 //!< First address probed by ::i2c_dev_scan()
+#define I2C_DEV_SCAN_LAST_ADDR  0x77 //!< Last address probed by ::i2c_dev_scan()
+
+/**
+ * Bus segment to scan
+ */
+typedef struct
+{
+    const i2c_dev_t *bus; /*!< Descriptor of the segment: `port`, `cfg`, `mux_addr` and
+                               `mux_channels` are used, `addr` is ignored */
+    uint32_t present[4];  /*!< Responding addresses, bit `addr % 32` of `present[addr / 32]`,
+                               filled by ::i2c_dev_scan() */
+    esp_err_t result;     //!< Result of the segment scan
+} i2c_dev_scan_t;
+
+/**
+ * @brief Scan bus segments for devices
+ *
+ * Every address from I2C_DEV_SCAN_FIRST_ADDR to I2C_DEV_SCAN_LAST_ADDR is
+ * probed with an address-only write and CONFIG_I2CDEV_SCAN_TIMEOUT timeout.
+ * A segment is a port or a channel selection of a multiplexer on it, the
+ * channels are selected before probing. Segments of different ports are
+ * scanned in parallel by temporary tasks, segments of one port one after
+ * another. Port lock is taken for each segment.
+ *
+ * Results are cached per port and segment. After the scan, transfers to
+ * devices that did not respond fail with ESP_ERR_NOT_FOUND without touching
+ * the bus, so probes in init functions of absent devices cost nothing.
+ * Devices with `quiet` set are never skipped. Use ::i2c_dev_probe() or
+ * ::i2c_dev_scan_clear() when a device is powered later.
+ *
+ * Available when CONFIG_I2CDEV_SCAN is enabled.
+ *
+ * @param segments Segments to scan
+ * @param count Number of segments
+ * @param priority Priority of scanning tasks
+ * @return ESP_OK if all segments were scanned, otherwise the first error,
+ *         see `result` of each segment
+ */
+esp_err_t i2c_dev_scan(i2c_dev_scan_t *segments, size_t count, UBaseType_t priority);
+
+/**
+ * @brief Check if device responds
+ *
+ * Sends address-only write to the device and updates the presence cache
+ * if its segment was scanned.
+ * Function is thread-safe.
+ *
+ * @param dev Device descriptor
+ * @return ESP_OK if device responds, ESP_ERR_NOT_FOUND if not
+ */
+esp_err_t i2c_dev_probe(const i2c_dev_t *dev);
+
+/**
+ * @brief Forget scan results of the port
+ *
+ * @param port I2C port number
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_scan_clear(i2c_port_t port);
+
+#endif
+
+#if CONFIG_I2CDEV_SMBUS || defined(__DOXYGEN__)
+
+#define I2C_DEV_SMBUS_BLOCK_MAX 32 //!< Maximal size of SMBus block
+
+/**
+ * @brief Calculate SMBus packet error code
+ *
+ * CRC-8 with polynomial x^8 + x^2 + x + 1 over all bytes of the transfer,
+ * including address bytes with R/W bit.
+ *
+ * @param crc Initial value, 0 or result of the previous call
+ * @param data Data
+ * @param size Data size, bytes
+ * @return PEC
+ */
+uint8_t i2c_dev_smbus_pec(uint8_t crc, const void *data, size_t size);
+
+/**
+ * @brief SMBus block read
+ *
+ * Sends command, then reads count byte, data and optional PEC in one
+ * transaction. On software ports exactly count bytes are read. Hardware
+ * drivers cannot change the length of a read in progress, so 1 + \p size
+ * (+ 1 with PEC) bytes are read there: pass the maximal block size the
+ * command returns, not I2C_DEV_SMBUS_BLOCK_MAX, to save bus time.
+ * Function is thread-safe.
+ *
+ * Available when CONFIG_I2CDEV_SMBUS is enabled.
+ *
+ * @param dev Device descriptor
+ * @param cmd Command code
+ * @param pec Device appends PEC
+ * @param[out] data Buffer for block data
+ * @param[in,out] size Buffer size, 1..I2C_DEV_SMBUS_BLOCK_MAX, on success
+ *                     number of received bytes
+ * @return ESP_OK on success, ESP_ERR_INVALID_SIZE if block does not fit
+ *         into the buffer, ESP_ERR_INVALID_CRC on PEC mismatch
+ */
+esp_err_t i2c_dev_smbus_block_read(const i2c_dev_t *dev, uint8_t cmd, bool pec, void *data, size_t *size);
+
+/**
+ * @brief SMBus block write
+ *
+ * Sends command, count byte, data and optional PEC in one transaction.
+ * Function is thread-safe.
+ *
+ * Available when CONFIG_I2CDEV_SMBUS is enabled.
+ *
+ * @param dev Device descriptor
+ * @param cmd Command code
+ * @param pec Append PEC
+ * @param data Block data
+ * @param size Block size, 0..I2C_DEV_SMBUS_BLOCK_MAX
+ * @return ESP_OK on success
+ */
+esp_err_t i2c_dev_smbus_block_write(const i2c_dev_t *dev, uint8_t cmd, bool pec, const void *data, size_t size);
+
+#endif
+
 #define I2C_DEV_TAKE_MUTEX(dev) do { \
         esp_err_t __ = i2c_dev_take_mutex(dev); \
         if (__ != ESP_OK) return __;\
@@ -217,6 +936,33 @@ esp_err_t i2c_dev_write_reg(const i2c_dev_t *dev, uint8_t reg,
         } \
     } while (0)
 
+#define I2C_DEV_SESSION_BEGIN(dev) do { \
+        esp_err_t __ = i2c_dev_session_begin(dev); \
+        if (__ != ESP_OK) return __;\
+    } while (0)
+
+#define I2C_DEV_SESSION_END(dev) do { \
+        esp_err_t __ = i2c_dev_session_end(dev); \
+        if (__ != ESP_OK) return __;\
+    } while (0)
+
+#define I2C_DEV_SESSION_CHECK(dev, X) do { \
+        esp_err_t ___ = X; \
+        if (___ != ESP_OK) { \
+            I2C_DEV_SESSION_END(dev); \
+            return ___; \
+        } \
+    } while (0)
+
+#define I2C_DEV_SESSION_CHECK_LOGE(dev, X, msg, ...) do { \
+        esp_err_t ___ = X; \
+        if (___ != ESP_OK) { \
+            I2C_DEV_SESSION_END(dev); \
+            ESP_LOGE(TAG, msg, ## __VA_ARGS__); \
+            return ___; \
+        } \
+    } while (0)
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file i2cdev_ng.c
+ *
+ * I2C master backend of i2cdev on the ESP-IDF >= v5.2 i2c_master driver
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <esp_log.h>
+#include "i2cdev_ng.h"
+
+#if I2CDEV_USE_NG_DRIVER
+
+// Transfers up to this size are gathered on the stack
+#define STACK_BUF_SIZE 32
+
+static const char *TAG = "i2cdev_ng";
+
+esp_err_t i2c_ng_setup(i2c_ng_bus_t *bus, i2c_port_t port, const i2c_config_t *cfg)
+{
+    i2c_ng_delete(bus);
+
+    i2c_master_bus_config_t bus_cfg = {
+        .i2c_port = port,
+        .sda_io_num = cfg->sda_io_num,
+        .scl_io_num = cfg->scl_io_num,
+        .clk_source = I2C_CLK_SRC_DEFAULT,
+        .glitch_ignore_cnt = 7,
+        .flags.enable_internal_pullup = cfg->sda_pullup_en || cfg->scl_pullup_en,
+    };
+    return i2c_new_master_bus(&bus_cfg, &bus->bus);
+}
+
+void i2c_ng_delete(i2c_ng_bus_t *bus)
+{
+    if (!bus->bus) return;
+
+    for (size_t i = 0; i < CONFIG_I2CDEV_NG_MAX_DEVICES; i++)
+        if (bus->devs[i].handle)
+            i2c_master_bus_rm_device(bus->devs[i].handle);
+    i2c_del_master_bus(bus->bus);
+    memset(bus, 0, sizeof(i2c_ng_bus_t));
+}
+
+// Handles are created on first access, least recently created one is
+// replaced when all slots are taken
+static i2c_master_dev_handle_t get_handle(i2c_ng_bus_t *bus, const i2c_ng_dev_t *dev)
+{
+    i2c_ng_dev_t *free_slot = NULL;
+    for (size_t i = 0; i < CONFIG_I2CDEV_NG_MAX_DEVICES; i++)
+    {
+        i2c_ng_dev_t *d = &bus->devs[i];
+        if (!d->handle)
+        {
+            if (!free_slot) free_slot = d;
+            continue;
+        }
+        if (d->addr == dev->addr && d->clk_speed == dev->clk_speed && d->stretch_us == dev->stretch_us)
+            return d->handle;
+    }
+    if (!free_slot)
+    {
+        free_slot = &bus->devs[bus->next];
+        bus->next = (bus->next + 1) % CONFIG_I2CDEV_NG_MAX_DEVICES;
+        i2c_master_bus_rm_device(free_slot->handle);
+        free_slot->handle = NULL;
+    }
+
+    i2c_device_config_t cfg = {
+        .dev_addr_length = I2C_ADDR_BIT_LEN_7,
+        .device_address = dev->addr,
+        .scl_speed_hz = dev->clk_speed,
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+        .scl_wait_us = dev->stretch_us,
+#endif
+    };
+    esp_err_t res = i2c_master_bus_add_device(bus->bus, &cfg, &free_slot->handle);
+    if (res != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not add device 0x%02x: %d", dev->addr, res);
+        free_slot->handle = NULL;
+        return NULL;
+    }
+    free_slot->addr = dev->addr;
+    free_slot->clk_speed = dev->clk_speed;
+    free_slot->stretch_us = dev->stretch_us;
+    ESP_LOGD(TAG, "Added device 0x%02x, %u Hz", dev->addr, (unsigned)dev->clk_speed);
+
+    return free_slot->handle;
+}
+
+// Drivers check ESP_FAIL for NACK as returned by the legacy driver
+inline static esp_err_t map_error(esp_err_t res)
+{
+    return res == ESP_OK || res == ESP_ERR_TIMEOUT || res == ESP_ERR_NO_MEM || res == ESP_ERR_INVALID_ARG
+        ? res
+        : ESP_FAIL;
+}
+
+esp_err_t i2c_ng_write(i2c_ng_bus_t *bus, const i2c_ng_dev_t *dev, const void *out_reg, size_t out_reg_size,
+        const void *out_data, size_t out_size)
+{
+    i2c_master_dev_handle_t h = get_handle(bus, dev);
+    if (!h) return ESP_FAIL;
+
+    if (!out_reg || !out_reg_size)
+        return map_error(i2c_master_transmit(h, out_data, out_size, CONFIG_I2CDEV_TIMEOUT));
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 4, 0)
+    i2c_master_transmit_multi_buffer_info_t bufs[] = {
+        { .write_buffer = (uint8_t *)out_reg, .buffer_size = out_reg_size },
+        { .write_buffer = (uint8_t *)out_data, .buffer_size = out_size },
+    };
+    return map_error(i2c_master_multi_buffer_transmit(h, bufs, 2, CONFIG_I2CDEV_TIMEOUT));
+#else
+    // Register address and data must go in one transaction
+    uint8_t stack_buf[STACK_BUF_SIZE];
+    size_t size = out_reg_size + out_size;
+    uint8_t *buf = size <= sizeof(stack_buf) ? stack_buf : malloc(size);
+    if (!buf) return ESP_ERR_NO_MEM;
+    memcpy(buf, out_reg, out_reg_size);
+    memcpy(buf + out_reg_size, out_data, out_size);
+
+    esp_err_t res = i2c_master_transmit(h, buf, size, CONFIG_I2CDEV_TIMEOUT);
+
+    if (buf != stack_buf)
+        free(buf);
+    return map_error(res);
+#endif
+}
+
+esp_err_t i2c_ng_readv(i2c_ng_bus_t *bus, const i2c_ng_dev_t *dev, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt)
+{
+    i2c_master_dev_handle_t h = get_handle(bus, dev);
+    if (!h) return ESP_FAIL;
+
+    // Driver has no scatter reads, segments are read into one buffer
+    uint8_t stack_buf[STACK_BUF_SIZE];
+    uint8_t *buf;
+    size_t size = 0;
+    for (size_t i = 0; i < iovcnt; i++)
+        size += iov[i].size;
+    if (iovcnt == 1)
+        buf = iov[0].data;
+    else if (size <= sizeof(stack_buf))
+        buf = stack_buf;
+    else if (!(buf = malloc(size)))
+        return ESP_ERR_NO_MEM;
+
+    esp_err_t res = out_data && out_size
+        ? i2c_master_transmit_receive(h, out_data, out_size, buf, size, CONFIG_I2CDEV_TIMEOUT)
+        : i2c_master_receive(h, buf, size, CONFIG_I2CDEV_TIMEOUT);
+
+    if (iovcnt > 1)
+    {
+        if (res == ESP_OK)
+        {
+            uint8_t *p = buf;
+            for (size_t i = 0; i < iovcnt; i++)
+            {
+                if (!iov[i].size) continue;
+                memcpy(iov[i].data, p, iov[i].size);
+                p += iov[i].size;
+            }
+        }
+        if (buf != stack_buf)
+            free(buf);
+    }
+    return map_error(res);
+}
+
+esp_err_t i2c_ng_probe(i2c_ng_bus_t *bus, uint8_t addr, uint32_t timeout_ms)
+{
+    // Driver returns ESP_ERR_NOT_FOUND on NACK
+    return map_error(i2c_master_probe(bus->bus, addr, timeout_ms));
+}
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file i2cdev_ng.h
+ *
+ * I2C master backend of i2cdev on the ESP-IDF >= v5.2 i2c_master driver,
+ * internal header
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __I2CDEV_NG_H__
+#define __I2CDEV_NG_H__
+
+#include "i2cdev.h"
+
+#if CONFIG_I2CDEV_NG_DRIVER && ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 2, 0)
+#define I2CDEV_USE_NG_DRIVER 1
+#else
+#define I2CDEV_USE_NG_DRIVER 0
+#endif
+
+#if I2CDEV_USE_NG_DRIVER
+
+#include <driver/i2c_master.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Device handle attached to the bus
+ */
+typedef struct
+{
+    i2c_master_dev_handle_t handle;
+    uint8_t addr;
+    uint32_t clk_speed;
+    uint32_t stretch_us;
+} i2c_ng_dev_t;
+
+/**
+ * Bus handle and handles of devices accessed on it
+ */
+typedef struct
+{
+    i2c_master_bus_handle_t bus;
+    i2c_ng_dev_t devs[CONFIG_I2CDEV_NG_MAX_DEVICES];
+    size_t next; // Slot to reuse when all are taken
+} i2c_ng_bus_t;
+
+/**
+ * Create bus on the port, previous bus and its devices are deleted
+ */
+esp_err_t i2c_ng_setup(i2c_ng_bus_t *bus, i2c_port_t port, const i2c_config_t *cfg);
+
+/**
+ * Delete bus and all device handles
+ */
+void i2c_ng_delete(i2c_ng_bus_t *bus);
+
+/**
+ * Write transaction: address, optional register address, data
+ */
+esp_err_t i2c_ng_write(i2c_ng_bus_t *bus, const i2c_ng_dev_t *dev, const void *out_reg, size_t out_reg_size,
+        const void *out_data, size_t out_size);
+
+/**
+ * Optional write of \p out_data, then repeated start and scatter read
+ */
+esp_err_t i2c_ng_readv(i2c_ng_bus_t *bus, const i2c_ng_dev_t *dev, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt);
+
+/**
+ * Address-only write, ESP_FAIL on NACK
+ */
+esp_err_t i2c_ng_probe(i2c_ng_bus_t *bus, uint8_t addr, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+#endif /* __I2CDEV_NG_H__ */
@@ -0,0 +1,279 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file i2cdev_regs.hpp
+ * @defgroup i2cdev_regs i2cdev_regs
+ * @{
+ *
+ * Compile-time register maps for C++ applications
+ *
+ * Header-only layer over i2cdev. Registers and bitfields are described
+ * as types, masks and shifts are constants, so updating several fields
+ * of one register with i2cdev::modify() is a single read-modify-write
+ * with a mask known at compile time. Register cache of i2cdev is used
+ * if enabled, so with cached registers no bus read is made.
+ *
+ * Example:
+ *
+ *     using namespace bme680_regs;
+ *     i2cdev::modify<ctrl_meas::osrs_t, ctrl_meas::osrs_p, ctrl_meas::mode>(&dev.i2c_dev, 2, 5, 1);
+ *
+ * Register maps of several drivers are provided in their components,
+ * see bme680_regs.hpp, ina3221_regs.hpp, ads111x_regs.hpp and
+ * tsl2591_regs.hpp.
+ *
+ * Requires C++11.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __I2CDEV_REGS_HPP__
+#define __I2CDEV_REGS_HPP__
+
+#ifndef __cplusplus
+#error "i2cdev_regs.hpp is C++ only"
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+#include "i2cdev.h"
+
+namespace i2cdev {
+
+/**
+ * Byte order of multibyte register on the bus
+ */
+enum class byte_order
+{
+    big,    //!< MSB first
+    little, //!< LSB first
+};
+
+/**
+ * Register descriptor
+ *
+ * @tparam Addr Register address (command byte)
+ * @tparam T Unsigned type of register value, up to ::I2C_DEV_CACHE_MAX_REG_SIZE bytes
+ * @tparam Order Byte order on the bus
+ */
+template <uint8_t Addr, typename T = uint8_t, byte_order Order = byte_order::big>
+struct reg
+{
+    static_assert(std::is_unsigned<T>::value, "Register type must be unsigned");
+    static_assert(sizeof(T) <= I2C_DEV_CACHE_MAX_REG_SIZE, "Register is too wide");
+
+    typedef T type;
+    static constexpr uint8_t addr = Addr;
+    static constexpr size_t size = sizeof(T);
+    static constexpr byte_order order = Order;
+};
+
+/**
+ * Bitfield descriptor
+ *
+ * @tparam Reg Register descriptor
+ * @tparam Offset Position of the least significant bit
+ * @tparam Width Field width, bits
+ */
+template <typename Reg, unsigned Offset, unsigned Width = 1>
+struct field
+{
+    static_assert(Width && Offset + Width <= Reg::size * 8, "Field does not fit into register");
+
+    typedef Reg reg;
+    typedef typename Reg::type type;
+    static constexpr type mask = (type)((((uint64_t)1 << Width) - 1) << Offset);
+
+    static constexpr type encode(type v) { return (type)(((uint64_t)v << Offset) & mask); }
+    static constexpr type decode(type raw) { return (type)((raw & mask) >> Offset); }
+};
+
+namespace detail {
+
+// Combined mask and value of fields of one register
+template <typename Reg, typename... Fields>
+struct fields
+{
+    static constexpr typename Reg::type mask = 0;
+    static constexpr typename Reg::type encode() { return 0; }
+};
+
+template <typename Reg, typename F, typename... Rest>
+struct fields<Reg, F, Rest...>
+{
+    static_assert(std::is_same<typename F::reg, Reg>::value, "All fields must belong to the same register");
+    static_assert(!(F::mask & fields<Reg, Rest...>::mask), "Fields overlap");
+
+    static constexpr typename Reg::type mask = F::mask | fields<Reg, Rest...>::mask;
+
+    static constexpr typename Reg::type encode(typename F::type v, typename Rest::type... rest)
+    {
+        return F::encode(v) | fields<Reg, Rest...>::encode(rest...);
+    }
+};
+
+template <typename F, typename... Rest>
+struct first { typedef F type; };
+
+template <typename Reg>
+inline void to_bytes(typename Reg::type v, uint8_t *buf)
+{
+    for (size_t i = 0; i < Reg::size; i++)
+        buf[Reg::order == byte_order::big ? Reg::size - 1 - i : i] = (uint8_t)(v >> (i * 8));
+}
+
+template <typename Reg>
+inline typename Reg::type from_bytes(const uint8_t *buf)
+{
+    typename Reg::type v = 0;
+    for (size_t i = 0; i < Reg::size; i++)
+        v |= (typename Reg::type)buf[Reg::order == byte_order::big ? Reg::size - 1 - i : i] << (i * 8);
+    return v;
+}
+
+// Scoped device mutex
+class lock
+{
+public:
+    explicit lock(i2c_dev_t *dev) : dev_(dev), res_(i2c_dev_take_mutex(dev)) {}
+    ~lock() { if (res_ == ESP_OK) i2c_dev_give_mutex(dev_); }
+    esp_err_t result() const { return res_; }
+private:
+    i2c_dev_t *dev_;
+    esp_err_t res_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Read raw register value
+ *
+ * @tparam Reg Register descriptor
+ * @param dev Device descriptor
+ * @param[out] raw Register value
+ * @return `ESP_OK` on success
+ */
+template <typename Reg>
+esp_err_t read_reg(i2c_dev_t *dev, typename Reg::type &raw)
+{
+    detail::lock l(dev);
+    if (l.result() != ESP_OK)
+        return l.result();
+
+    uint8_t buf[Reg::size];
+    esp_err_t res = i2c_dev_read_reg_cached(dev, Reg::addr, buf, Reg::size);
+    if (res == ESP_OK)
+        raw = detail::from_bytes<Reg>(buf);
+    return res;
+}
+
+/**
+ * @brief Write raw register value
+ *
+ * @tparam Reg Register descriptor
+ * @param dev Device descriptor
+ * @param raw Register value
+ * @return `ESP_OK` on success
+ */
+template <typename Reg>
+esp_err_t write_reg(i2c_dev_t *dev, typename Reg::type raw)
+{
+    detail::lock l(dev);
+    if (l.result() != ESP_OK)
+        return l.result();
+
+    uint8_t buf[Reg::size];
+    detail::to_bytes<Reg>(raw, buf);
+    return i2c_dev_write_reg_cached(dev, Reg::addr, buf, Reg::size);
+}
+
+/**
+ * @brief Read bitfield
+ *
+ * @tparam Field Field descriptor
+ * @param dev Device descriptor
+ * @param[out] value Field value, shifted to bit 0
+ * @return `ESP_OK` on success
+ */
+template <typename Field>
+esp_err_t read(i2c_dev_t *dev, typename Field::type &value)
+{
+    typename Field::type raw;
+    esp_err_t res = read_reg<typename Field::reg>(dev, raw);
+    if (res == ESP_OK)
+        value = Field::decode(raw);
+    return res;
+}
+
+/**
+ * @brief Update several bitfields of one register at once
+ *
+ * Mask of all fields is combined at compile time, register is updated
+ * with a single read-modify-write. Other bits are kept.
+ *
+ * @tparam Fields Field descriptors, all of the same register
+ * @param dev Device descriptor
+ * @param values Field values, one per field
+ * @return `ESP_OK` on success
+ */
+template <typename... Fields>
+esp_err_t modify(i2c_dev_t *dev, typename Fields::type... values)
+{
+    typedef typename detail::first<Fields...>::type::reg reg_t;
+    typedef detail::fields<reg_t, Fields...> f;
+
+    uint8_t mask[reg_t::size], value[reg_t::size];
+    detail::to_bytes<reg_t>(f::mask, mask);
+    detail::to_bytes<reg_t>(f::encode(values...), value);
+
+    detail::lock l(dev);
+    if (l.result() != ESP_OK)
+        return l.result();
+
+    return i2c_dev_update_reg_cached(dev, reg_t::addr, mask, value, reg_t::size, false);
+}
+
+/**
+ * @brief Write several bitfields of one register, other bits are cleared
+ *
+ * Same as i2cdev::modify() but without reading the register.
+ *
+ * @tparam Fields Field descriptors, all of the same register
+ * @param dev Device descriptor
+ * @param values Field values, one per field
+ * @return `ESP_OK` on success
+ */
+template <typename... Fields>
+esp_err_t write(i2c_dev_t *dev, typename Fields::type... values)
+{
+    typedef typename detail::first<Fields...>::type::reg reg_t;
+
+    return write_reg<reg_t>(dev, detail::fields<reg_t, Fields...>::encode(values...));
+}
+
+} // namespace i2cdev
+
+/**@}*/
+
+#endif /* __I2CDEV_REGS_HPP__ */
@@ -0,0 +1,268 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file i2cdev_soft.c
+ *
+ * Bit-banged I2C master backend of i2cdev
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <esp_log.h> // to include ets_sys.h
+#include "i2cdev_soft.h"
+
+#if CONFIG_I2CDEV_SOFT_PORTS > 0
+
+#define DEFAULT_CLK_SPEED 100000
+
+// Lines are open-drain: level 1 releases the line, pull-ups raise it
+#define SDA_LOW(bus)  gpio_set_level((bus)->sda, 0)
+#define SDA_HIGH(bus) gpio_set_level((bus)->sda, 1)
+#define SCL_LOW(bus)  gpio_set_level((bus)->scl, 0)
+#define SDA_READ(bus) gpio_get_level((bus)->sda)
+#define SCL_READ(bus) gpio_get_level((bus)->scl)
+
+#define DELAY(bus) ets_delay_us((bus)->half_period_us)
+
+static esp_err_t scl_release(const i2c_soft_bus_t *bus)
+{
+    gpio_set_level(bus->scl, 1);
+    // Clock stretching: slave can hold SCL low
+    for (uint32_t t = 0; !SCL_READ(bus); t++)
+    {
+        if (t >= bus->stretch_timeout_us)
+            return ESP_ERR_TIMEOUT;
+        ets_delay_us(1);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t send_start(const i2c_soft_bus_t *bus)
+{
+    // Also works as repeated start when SCL is low
+    SDA_HIGH(bus);
+    DELAY(bus);
+    esp_err_t res = scl_release(bus);
+    if (res != ESP_OK)
+        return res;
+    if (!SDA_READ(bus))
+        return ESP_FAIL; // Bus is held by slave or other master
+    DELAY(bus);
+    SDA_LOW(bus);
+    DELAY(bus);
+    SCL_LOW(bus);
+    return ESP_OK;
+}
+
+static esp_err_t send_stop(const i2c_soft_bus_t *bus)
+{
+    SDA_LOW(bus);
+    DELAY(bus);
+    esp_err_t res = scl_release(bus);
+    DELAY(bus);
+    SDA_HIGH(bus);
+    DELAY(bus);
+    return res;
+}
+
+static esp_err_t write_bit(const i2c_soft_bus_t *bus, bool bit)
+{
+    if (bit)
+        SDA_HIGH(bus);
+    else
+        SDA_LOW(bus);
+    DELAY(bus);
+    esp_err_t res = scl_release(bus);
+    if (res != ESP_OK)
+        return res;
+    DELAY(bus);
+    SCL_LOW(bus);
+    return ESP_OK;
+}
+
+static esp_err_t read_bit(const i2c_soft_bus_t *bus, bool *bit)
+{
+    SDA_HIGH(bus);
+    DELAY(bus);
+    esp_err_t res = scl_release(bus);
+    if (res != ESP_OK)
+        return res;
+    *bit = SDA_READ(bus);
+    DELAY(bus);
+    SCL_LOW(bus);
+    return ESP_OK;
+}
+
+static esp_err_t write_byte(const i2c_soft_bus_t *bus, uint8_t byte)
+{
+    esp_err_t res;
+    for (uint8_t mask = 0x80; mask; mask >>= 1)
+        if ((res = write_bit(bus, byte & mask)) != ESP_OK)
+            return res;
+
+    bool nack;
+    if ((res = read_bit(bus, &nack)) != ESP_OK)
+        return res;
+    // Same error as hardware driver returns for NACK
+    return nack ? ESP_FAIL : ESP_OK;
+}
+
+static esp_err_t read_byte(const i2c_soft_bus_t *bus, uint8_t *byte, bool ack)
+{
+    esp_err_t res;
+    uint8_t v = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        bool bit;
+        if ((res = read_bit(bus, &bit)) != ESP_OK)
+            return res;
+        v = (v << 1) | bit;
+    }
+    *byte = v;
+    return write_bit(bus, !ack);
+}
+
+static esp_err_t write_bytes(const i2c_soft_bus_t *bus, const uint8_t *buf, size_t size)
+{
+    esp_err_t res;
+    for (size_t i = 0; i < size; i++)
+        if ((res = write_byte(bus, buf[i])) != ESP_OK)
+            return res;
+    return ESP_OK;
+}
+
+esp_err_t i2c_soft_setup(i2c_soft_bus_t *bus, const i2c_config_t *cfg, uint32_t stretch_timeout_us)
+{
+    gpio_config_t io = {
+        .pin_bit_mask = (1ULL << cfg->sda_io_num) | (1ULL << cfg->scl_io_num),
+        .mode = GPIO_MODE_INPUT_OUTPUT_OD,
+        .pull_up_en = cfg->sda_pullup_en || cfg->scl_pullup_en ? GPIO_PULLUP_ENABLE : GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE,
+    };
+    esp_err_t res = gpio_config(&io);
+    if (res != ESP_OK)
+        return res;
+
+    bus->sda = cfg->sda_io_num;
+    bus->scl = cfg->scl_io_num;
+    uint32_t speed = cfg->master.clk_speed ? cfg->master.clk_speed : DEFAULT_CLK_SPEED;
+    // Real frequency is lower because of GPIO access time
+    bus->half_period_us = 500000 / speed;
+    if (!bus->half_period_us)
+        bus->half_period_us = 1;
+    bus->stretch_timeout_us = stretch_timeout_us;
+
+    gpio_set_level(bus->sda, 1);
+    gpio_set_level(bus->scl, 1);
+
+    return ESP_OK;
+}
+
+esp_err_t i2c_soft_write(const i2c_soft_bus_t *bus, uint8_t addr, const void *out_reg, size_t out_reg_size,
+        const void *out_data, size_t out_size)
+{
+    esp_err_t res = send_start(bus);
+    if (res == ESP_OK)
+        res = write_byte(bus, addr << 1);
+    if (res == ESP_OK && out_reg && out_reg_size)
+        res = write_bytes(bus, out_reg, out_reg_size);
+    if (res == ESP_OK)
+        res = write_bytes(bus, out_data, out_size);
+
+    esp_err_t stop = send_stop(bus);
+    return res != ESP_OK ? res : stop;
+}
+
+esp_err_t i2c_soft_readv(const i2c_soft_bus_t *bus, uint8_t addr, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt)
+{
+    esp_err_t res = ESP_OK;
+    if (out_data && out_size)
+    {
+        res = send_start(bus);
+        if (res == ESP_OK)
+            res = write_byte(bus, addr << 1);
+        if (res == ESP_OK)
+            res = write_bytes(bus, out_data, out_size);
+    }
+    if (res == ESP_OK)
+        res = send_start(bus);
+    if (res == ESP_OK)
+        res = write_byte(bus, (addr << 1) | 1);
+
+    // Last byte of the last segment is NACKed
+    size_t last = iovcnt - 1;
+    while (last && !iov[last].size)
+        last--;
+    for (size_t i = 0; res == ESP_OK && i <= last; i++)
+    {
+        uint8_t *buf = iov[i].data;
+        for (size_t j = 0; res == ESP_OK && j < iov[i].size; j++)
+            res = read_byte(bus, &buf[j], i != last || j != iov[i].size - 1);
+    }
+
+    esp_err_t stop = send_stop(bus);
+    return res != ESP_OK ? res : stop;
+}
+
+esp_err_t i2c_soft_block_read(const i2c_soft_bus_t *bus, uint8_t addr, uint8_t cmd, uint8_t *buf,
+        size_t max, size_t extra)
+{
+    buf[0] = 0;
+    esp_err_t res = send_start(bus);
+    if (res == ESP_OK)
+        res = write_byte(bus, addr << 1);
+    if (res == ESP_OK)
+        res = write_byte(bus, cmd);
+    if (res == ESP_OK)
+        res = send_start(bus);
+    if (res == ESP_OK)
+        res = write_byte(bus, (addr << 1) | 1);
+    if (res == ESP_OK)
+        res = read_byte(bus, &buf[0], true);
+
+    size_t len = 0;
+    if (res == ESP_OK)
+    {
+        len = buf[0] + extra;
+        if (buf[0] > max)
+        {
+            res = ESP_ERR_INVALID_SIZE;
+            len = 0;
+        }
+        // Count byte is already ACKed, the last read byte must be NACKed
+        if (!len)
+        {
+            uint8_t dummy;
+            read_byte(bus, &dummy, false);
+        }
+    }
+    for (size_t i = 0; res == ESP_OK && i < len; i++)
+        res = read_byte(bus, &buf[1 + i], i != len - 1);
+
+    esp_err_t stop = send_stop(bus);
+    return res != ESP_OK ? res : stop;
+}
+
+#endif
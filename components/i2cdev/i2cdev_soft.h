@@ -0,0 +1,79 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file i2cdev_soft.h
+ *
+ * Bit-banged I2C master backend of i2cdev, internal header
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __I2CDEV_SOFT_H__
+#define __I2CDEV_SOFT_H__
+
+#include "i2cdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Software I2C bus state
+ */
+typedef struct
+{
+    gpio_num_t sda;
+    gpio_num_t scl;
+    uint32_t half_period_us;
+    uint32_t stretch_timeout_us;
+} i2c_soft_bus_t;
+
+/**
+ * Configure GPIO pins of software bus
+ */
+esp_err_t i2c_soft_setup(i2c_soft_bus_t *bus, const i2c_config_t *cfg, uint32_t stretch_timeout_us);
+
+/**
+ * Write transaction: address, optional register address, data
+ */
+esp_err_t i2c_soft_write(const i2c_soft_bus_t *bus, uint8_t addr, const void *out_reg, size_t out_reg_size,
+        const void *out_data, size_t out_size);
+
+/**
+ * Optional write of \p out_data, then repeated start and scatter read
+ */
+esp_err_t i2c_soft_readv(const i2c_soft_bus_t *bus, uint8_t addr, const void *out_data, size_t out_size,
+        const i2c_dev_iovec_t *iov, size_t iovcnt);
+
+/**
+ * SMBus block read: \p cmd, repeated start, count byte into buf[0], then
+ * count + \p extra bytes. ESP_ERR_INVALID_SIZE if count exceeds \p max
+ */
+esp_err_t i2c_soft_block_read(const i2c_soft_bus_t *bus, uint8_t addr, uint8_t cmd, uint8_t *buf,
+        size_t max, size_t extra);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __I2CDEV_SOFT_H__ */
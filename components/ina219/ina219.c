@@ -37,6 +37,7 @@
  */
 #include <esp_log.h>
 #include <math.h>
+#include <esp_timer.h>
 #include <esp_idf_lib_helpers.h>
 #include "ina219.h"
 
@@ -58,6 +59,9 @@ static const char *TAG = "ina219";
 #define BIT_SADC0 3
 #define BIT_MODE  0
 
+#define BIT_OVF  0
+#define BIT_CNVR 1
+
 #define MASK_PG   (3 << BIT_PG0)
 #define MASK_BADC (0xf << BIT_BADC0)
 #define MASK_SADC (0xf << BIT_SADC0)
@@ -69,6 +73,15 @@ static const char *TAG = "ina219";
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#endif
+
 static const float u_shunt_max[] = {
     [INA219_GAIN_1]     = 0.04,
     [INA219_GAIN_0_5]   = 0.08,
@@ -304,3 +317,111 @@ esp_err_t ina219_get_power(ina219_t *dev, float *power)
     return ESP_OK;
 }
 
+
+esp_err_t ina219_accum_start(ina219_accum_t *acc, ina219_t *dev)
+{
+    CHECK_ARG(acc && dev);
+
+    if (!dev->i_lsb)
+    {
+        ESP_LOGE(TAG, "Device is not calibrated");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (((dev->config & MASK_MODE) >> BIT_MODE) != INA219_MODE_CONT_SHUNT_BUS)
+    {
+        ESP_LOGE(TAG, "Continuous shunt and bus mode required");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    acc->dev = dev;
+    acc->overflows = 0;
+
+    return ina219_accum_reset(acc);
+}
+
+esp_err_t ina219_accum_update(ina219_accum_t *acc, bool *sampled)
+{
+    CHECK_ARG(acc && acc->dev);
+
+    if (sampled)
+        *sampled = false;
+
+    uint16_t bus;
+    CHECK(read_reg_16(acc->dev, REG_BUS_U, &bus));
+    if (!(bus & (1 << BIT_CNVR)))
+        return ESP_OK;
+    int64_t now = esp_timer_get_time();
+
+    // reading power register clears conversion ready flag
+    uint8_t regs[2] = { REG_CURRENT, REG_POWER };
+    uint16_t raw[2];
+    i2c_dev_transaction_t trans[2];
+    for (int i = 0; i < 2; i++)
+    {
+        trans[i].dev = &acc->dev->i2c_dev;
+        trans[i].op = I2C_DEV_OP_READ;
+        trans[i].reg = &regs[i];
+        trans[i].reg_size = 1;
+        trans[i].data = &raw[i];
+        trans[i].size = 2;
+    }
+    I2C_DEV_TAKE_MUTEX(&acc->dev->i2c_dev);
+    I2C_DEV_CHECK(&acc->dev->i2c_dev, i2c_dev_transactions(acc->dev->i2c_dev.port, trans, 2));
+    I2C_DEV_GIVE_MUTEX(&acc->dev->i2c_dev);
+
+    int16_t current = (int16_t)((raw[0] >> 8) | (raw[0] << 8));
+    uint16_t power = (raw[1] >> 8) | (raw[1] << 8);
+
+    PORT_ENTER_CRITICAL;
+    // first sample only sets time reference
+    if (acc->last)
+    {
+        int64_t dt = now - acc->last;
+        acc->charge += current * dt;
+        acc->energy += power * dt;
+        acc->samples++;
+    }
+    acc->last = now;
+    if (bus & (1 << BIT_OVF))
+        acc->overflows++;
+    PORT_EXIT_CRITICAL;
+
+    if (sampled)
+        *sampled = true;
+
+    return ESP_OK;
+}
+
+esp_err_t ina219_accum_get(ina219_accum_t *acc, float *charge, float *energy, uint32_t *samples)
+{
+    CHECK_ARG(acc && acc->dev && (charge || energy || samples));
+
+    PORT_ENTER_CRITICAL;
+    int64_t c = acc->charge;
+    int64_t e = acc->energy;
+    uint32_t n = acc->samples;
+    PORT_EXIT_CRITICAL;
+
+    if (charge)
+        *charge = (float)c * acc->dev->i_lsb * 1e-6f;
+    if (energy)
+        *energy = (float)e * acc->dev->p_lsb * 1e-6f;
+    if (samples)
+        *samples = n;
+
+    return ESP_OK;
+}
+
+esp_err_t ina219_accum_reset(ina219_accum_t *acc)
+{
+    CHECK_ARG(acc);
+
+    PORT_ENTER_CRITICAL;
+    acc->charge = 0;
+    acc->energy = 0;
+    acc->last = 0;
+    acc->samples = 0;
+    PORT_EXIT_CRITICAL;
+
+    return ESP_OK;
+}
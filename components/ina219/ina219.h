@@ -124,6 +124,19 @@ typedef struct
     float i_lsb, p_lsb;
 } ina219_t;
 
+/**
+ * Energy accumulator
+ */
+typedef struct
+{
+    ina219_t *dev;      //!< Device descriptor
+    int64_t charge;     //!< Accumulated charge, current LSB * us
+    int64_t energy;     //!< Accumulated energy, power LSB * us
+    int64_t last;       //!< Time of the last sample, us
+    uint32_t samples;   //!< Number of accumulated samples
+    uint32_t overflows; //!< Number of samples with math overflow flag set
+} ina219_accum_t;
+
 /**
  * @brief Initialize device descriptor
  *
@@ -289,6 +302,53 @@ esp_err_t ina219_get_current(ina219_t *dev, float *current);
  */
 esp_err_t ina219_get_power(ina219_t *dev, float *power);
 
+/**
+ * @brief Start energy accumulation
+ *
+ * Device must be calibrated and configured for continuous shunt and
+ * bus conversions.
+ *
+ * @param acc Accumulator descriptor
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina219_accum_start(ina219_accum_t *acc, ina219_t *dev);
+
+/**
+ * @brief Poll device and accumulate new sample
+ *
+ * Bus voltage register is read to check conversion ready flag. Current
+ * and power registers are read only when new conversion is complete, so
+ * function can be called as often as needed. Each sample is integrated
+ * over the time since the previous one using integer math only.
+ *
+ * @param acc Accumulator descriptor
+ * @param[out] sampled true if new sample was accumulated, optional
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina219_accum_update(ina219_accum_t *acc, bool *sampled);
+
+/**
+ * @brief Get accumulated charge and energy
+ *
+ * No I2C transfers are made, function can be called from any task.
+ *
+ * @param acc Accumulator descriptor
+ * @param[out] charge Accumulated charge, C, optional
+ * @param[out] energy Accumulated energy, J, optional
+ * @param[out] samples Number of accumulated samples, optional
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina219_accum_get(ina219_accum_t *acc, float *charge, float *energy, uint32_t *samples);
+
+/**
+ * @brief Reset accumulated charge and energy
+ *
+ * @param acc Accumulator descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina219_accum_reset(ina219_accum_t *acc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,6 +36,8 @@
  */
 #include <esp_log.h>
 #include <math.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
 #include <esp_idf_lib_helpers.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
@@ -81,6 +83,15 @@ static const char *TAG = "ina260";
 
 #define BV(x) (1 << (x))
 
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#endif
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
@@ -233,7 +244,7 @@ esp_err_t ina260_set_alert(ina260_t *dev, ina260_alert_mode_t mode, float limit,
         default:
             wl = false;
     }
-    if (cvrf)        reg |= BV(BIT_CVRF);
+    if (cvrf)        reg |= BV(BIT_CNVR);
     if (active_high) reg |= BV(BIT_APOL);
     if (latch)       reg |= BV(BIT_LEN);
     if (wl)
@@ -266,11 +277,11 @@ esp_err_t ina260_get_status(ina260_t *dev, bool *ready, bool *alert, bool *overf
     CHECK(read_reg_16(dev, REG_MASK_EN, &val));
 
     if (ready)
-        *ready = val & BIT_CVRF ? 1 : 0;
+        *ready = val & BV(BIT_CVRF) ? 1 : 0;
     if (alert)
-        *alert = val & BIT_AFF ? 1 : 0;
+        *alert = val & BV(BIT_AFF) ? 1 : 0;
     if (overflow)
-        *overflow = val & BIT_OVF ? 1 : 0;
+        *overflow = val & BV(BIT_OVF) ? 1 : 0;
 
     return ESP_OK;
 }
@@ -310,3 +321,189 @@ esp_err_t ina260_get_power(ina260_t *dev, float *power)
     return ESP_OK;
 }
 
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR alert_isr(void *arg)
+#else
+static void alert_isr(void *arg)
+#endif
+{
+    ina260_accum_t *acc = (ina260_accum_t *)arg;
+
+    acc->ready_time = esp_timer_get_time();
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(acc->ready, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+esp_err_t ina260_accum_start(ina260_accum_t *acc, ina260_t *dev, gpio_num_t gpio)
+{
+    CHECK_ARG(acc && dev);
+
+    if (((dev->config & MASK_MODE) >> BIT_MODE) != INA260_MODE_CONT_SHUNT_BUS)
+    {
+        ESP_LOGE(TAG, "Continuous shunt and bus mode required");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    acc->dev = dev;
+    acc->gpio = gpio;
+    acc->ready = NULL;
+    acc->overflows = 0;
+    CHECK(ina260_accum_reset(acc));
+
+    if (gpio == GPIO_NUM_NC)
+        return ESP_OK;
+
+    acc->ready = xSemaphoreCreateBinary();
+    if (!acc->ready)
+        return ESP_ERR_NO_MEM;
+
+    // ALERT is open drain
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    esp_err_t res = gpio_config(&io_conf);
+    if (res != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(gpio, alert_isr, acc)) != ESP_OK)
+        goto fail;
+
+    // Latched, so the pin stays low until mask/enable register is read
+    if ((res = ina260_set_alert(dev, INA260_ALERT_DISABLED, 0, true, false, true)) != ESP_OK)
+        goto fail;
+    // release the pin if conversion is already pending
+    uint16_t val;
+    if ((res = read_reg_16(dev, REG_MASK_EN, &val)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    ina260_accum_stop(acc);
+    return res;
+}
+
+esp_err_t ina260_accum_stop(ina260_accum_t *acc)
+{
+    CHECK_ARG(acc);
+
+    if (acc->ready)
+    {
+        gpio_isr_handler_remove(acc->gpio);
+        gpio_set_intr_type(acc->gpio, GPIO_INTR_DISABLE);
+        vSemaphoreDelete(acc->ready);
+        acc->ready = NULL;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ina260_accum_update(ina260_accum_t *acc, uint32_t timeout_ms, bool *sampled)
+{
+    CHECK_ARG(acc && acc->dev);
+
+    if (sampled)
+        *sampled = false;
+
+    if (acc->ready && xSemaphoreTake(acc->ready, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    // Reading mask/enable register clears conversion ready flag and ALERT pin
+    uint16_t mask;
+    CHECK(read_reg_16(acc->dev, REG_MASK_EN, &mask));
+    if (!(mask & BV(BIT_CVRF)))
+        return ESP_OK;
+
+    int64_t now;
+    if (acc->ready)
+    {
+        // 64-bit value can be torn by ISR
+        do
+            now = acc->ready_time;
+        while (now != acc->ready_time);
+    }
+    else
+        now = esp_timer_get_time();
+
+    uint8_t regs[2] = { REG_CURRENT, REG_POWER };
+    uint16_t raw[2];
+    i2c_dev_transaction_t trans[2];
+    for (int i = 0; i < 2; i++)
+    {
+        trans[i].dev = &acc->dev->i2c_dev;
+        trans[i].op = I2C_DEV_OP_READ;
+        trans[i].reg = &regs[i];
+        trans[i].reg_size = 1;
+        trans[i].data = &raw[i];
+        trans[i].size = 2;
+    }
+    I2C_DEV_TAKE_MUTEX(&acc->dev->i2c_dev);
+    I2C_DEV_CHECK(&acc->dev->i2c_dev, i2c_dev_transactions(acc->dev->i2c_dev.port, trans, 2));
+    I2C_DEV_GIVE_MUTEX(&acc->dev->i2c_dev);
+
+    int16_t current = (int16_t)((raw[0] >> 8) | (raw[0] << 8));
+    uint16_t power = (raw[1] >> 8) | (raw[1] << 8);
+
+    PORT_ENTER_CRITICAL;
+    // first sample only sets time reference
+    if (acc->last)
+    {
+        int64_t dt = now - acc->last;
+        acc->charge += current * dt;
+        acc->energy += power * dt;
+        acc->samples++;
+    }
+    acc->last = now;
+    if (mask & BV(BIT_OVF))
+        acc->overflows++;
+    PORT_EXIT_CRITICAL;
+
+    if (sampled)
+        *sampled = true;
+
+    return ESP_OK;
+}
+
+esp_err_t ina260_accum_get(ina260_accum_t *acc, float *charge, float *energy, uint32_t *samples)
+{
+    CHECK_ARG(acc && (charge || energy || samples));
+
+    PORT_ENTER_CRITICAL;
+    int64_t c = acc->charge;
+    int64_t e = acc->energy;
+    uint32_t n = acc->samples;
+    PORT_EXIT_CRITICAL;
+
+    if (charge)
+        *charge = (float)c * 1.25e-9f;
+    if (energy)
+        *energy = (float)e * 1e-8f;
+    if (samples)
+        *samples = n;
+
+    return ESP_OK;
+}
+
+esp_err_t ina260_accum_reset(ina260_accum_t *acc)
+{
+    CHECK_ARG(acc);
+
+    PORT_ENTER_CRITICAL;
+    acc->charge = 0;
+    acc->energy = 0;
+    acc->last = 0;
+    acc->samples = 0;
+    PORT_EXIT_CRITICAL;
+
+    return ESP_OK;
+}
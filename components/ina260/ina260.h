@@ -43,6 +43,9 @@
 
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -132,6 +135,22 @@ typedef struct
     uint16_t die_id;   //!< Die ID
 } ina260_t;
 
+/**
+ * Energy accumulator
+ */
+typedef struct
+{
+    ina260_t *dev;                //!< Device descriptor
+    gpio_num_t gpio;              //!< GPIO connected to ALERT pin, GPIO_NUM_NC to poll status register
+    SemaphoreHandle_t ready;      //!< Conversion ready semaphore, internal
+    volatile int64_t ready_time;  //!< Time of last ALERT pulse, internal
+    int64_t charge;               //!< Accumulated charge, 1.25 mA * us
+    int64_t energy;               //!< Accumulated energy, 10 mW * us
+    int64_t last;                 //!< Time of the last sample, us
+    uint32_t samples;             //!< Number of accumulated samples
+    uint32_t overflows;           //!< Number of samples with power overflow flag set
+} ina260_accum_t;
+
 /**
  * @brief Initialize device descriptor.
  *
@@ -266,6 +285,68 @@ esp_err_t ina260_get_bus_voltage(ina260_t *dev, float *voltage);
  */
 esp_err_t ina260_get_power(ina260_t *dev, float *power);
 
+/**
+ * @brief Start energy accumulation.
+ *
+ * Device must be configured for continuous current and bus voltage
+ * conversions. If `gpio` is not GPIO_NUM_NC, ALERT pin is configured as
+ * latched active low conversion ready output and its interrupt is used
+ * to wait for conversions and to timestamp them. ALERT limit function is
+ * disabled.
+ *
+ * @param acc Accumulator descriptor
+ * @param dev Device descriptor
+ * @param gpio GPIO connected to ALERT pin or GPIO_NUM_NC
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina260_accum_start(ina260_accum_t *acc, ina260_t *dev, gpio_num_t gpio);
+
+/**
+ * @brief Stop energy accumulation.
+ *
+ * ALERT interrupt is disabled, accumulated values are kept.
+ *
+ * @param acc Accumulator descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina260_accum_stop(ina260_accum_t *acc);
+
+/**
+ * @brief Wait for conversion and accumulate new sample.
+ *
+ * With ALERT pin function waits for the conversion ready interrupt,
+ * otherwise checks conversion ready flag once. Current and power
+ * registers are read only when new conversion is complete. Each sample
+ * is integrated over the time since the previous one using integer math only.
+ *
+ * @param acc Accumulator descriptor
+ * @param timeout_ms Time to wait for ALERT interrupt, ignored in polling mode
+ * @param[out] sampled true if new sample was accumulated, optional
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if there was no interrupt
+ */
+esp_err_t ina260_accum_update(ina260_accum_t *acc, uint32_t timeout_ms, bool *sampled);
+
+/**
+ * @brief Get accumulated charge and energy.
+ *
+ * No I2C transfers are made, function can be called from any task.
+ *
+ * @param acc Accumulator descriptor
+ * @param[out] charge Accumulated charge, C, optional
+ * @param[out] energy Accumulated energy, J, optional
+ * @param[out] samples Number of accumulated samples, optional
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina260_accum_get(ina260_accum_t *acc, float *charge, float *energy, uint32_t *samples);
+
+/**
+ * @brief Reset accumulated charge and energy.
+ *
+ * @param acc Accumulator descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ina260_accum_reset(ina260_accum_t *acc);
+
 #ifdef __cplusplus
 }
 #endif
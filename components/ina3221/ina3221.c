@@ -270,6 +270,65 @@ esp_err_t ina3221_get_sum_shunt_value(ina3221_t *dev, float *voltage)
     return ESP_OK;
 }
 
+esp_err_t ina3221_get_all(ina3221_t *dev, ina3221_data_t *data, bool *ready)
+{
+    CHECK_ARG(dev && data && ready);
+
+    *ready = false;
+
+    uint16_t raw[INA3221_BUS_NUMBER * 2];
+    uint8_t regs[INA3221_BUS_NUMBER * 2];
+    i2c_dev_transaction_t trans[INA3221_BUS_NUMBER * 2];
+    bool enabled[INA3221_BUS_NUMBER] = { dev->config.ch1, dev->config.ch2, dev->config.ch3 };
+    size_t count = 0;
+
+    for (int ch = 0; ch < INA3221_BUS_NUMBER; ch++)
+    {
+        if (!enabled[ch])
+            continue;
+        for (int bus = 0; bus < 2; bus++)
+        {
+            if (!(bus ? dev->config.ebus : dev->config.esht))
+                continue;
+            regs[count] = INA3221_REG_SHUNTVOLTAGE_1 + ch * 2 + bus;
+            trans[count].dev = &dev->i2c_dev;
+            trans[count].op = I2C_DEV_OP_READ;
+            trans[count].reg = &regs[count];
+            trans[count].reg_size = 1;
+            trans[count].data = &raw[count];
+            trans[count].size = 2;
+            count++;
+        }
+    }
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_read_reg(&dev->i2c_dev, INA3221_REG_MASK, &dev->mask.mask_register, 2));
+    dev->mask.mask_register = (dev->mask.mask_register >> 8) | (dev->mask.mask_register << 8);
+    if (!dev->mask.cvrf || !count)
+    {
+        I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+        return ESP_OK;
+    }
+    I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_transactions(dev->i2c_dev.port, trans, count));
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        int ch = (regs[i] - INA3221_REG_SHUNTVOLTAGE_1) / 2;
+        int16_t val = (int16_t)((raw[i] >> 8) | (raw[i] << 8));
+        if ((regs[i] - INA3221_REG_SHUNTVOLTAGE_1) & 1)
+            data->bus_mv[ch] = val; // 8 mV step
+        else
+        {
+            data->shunt_uv[ch] = val * 5; // 40 uV step
+            data->current_ua[ch] = dev->shunt[ch] ? data->shunt_uv[ch] * 1000 / dev->shunt[ch] : 0;
+        }
+    }
+    *ready = true;
+
+    return ESP_OK;
+}
+
 esp_err_t ina3221_set_critical_alert(ina3221_t *dev, ina3221_channel_t channel, float current)
 {
     CHECK_ARG(dev);
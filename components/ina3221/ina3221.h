@@ -148,6 +148,16 @@ typedef union
     uint16_t mask_register;
 } ina3221_mask_t;
 
+/**
+ * Measurements of all channels in integer units
+ */
+typedef struct
+{
+    int32_t shunt_uv[INA3221_BUS_NUMBER];   ///< Shunt voltage, uV
+    int32_t current_ua[INA3221_BUS_NUMBER]; ///< Current, uA (0 if no shunt configured)
+    int16_t bus_mv[INA3221_BUS_NUMBER];     ///< Bus voltage, mV
+} ina3221_data_t;
+
 /**
  *  Device descriptor
  */
@@ -319,6 +329,23 @@ esp_err_t ina3221_get_shunt_value(ina3221_t *dev, ina3221_channel_t channel, flo
  */
 esp_err_t ina3221_get_sum_shunt_value(ina3221_t *dev, float *voltage);
 
+/**
+ * @brief Get shunt and bus values of all enabled channels
+ *
+ * Conversion ready flag is checked first and measurement registers are
+ * read only if new conversion is complete. All registers are read in one
+ * batch while holding the bus, without per-register port setup. Only
+ * enabled channels and measurements are read, other fields are left
+ * untouched. Reading clears conversion ready flag, so ::ina3221_get_status()
+ * is not needed. Results are in integer units, no floating point is used.
+ *
+ * @param dev Device descriptor
+ * @param[out] data Measurements
+ * @param[out] ready true if conversion was ready and data was read
+ * @return ESP_OK to indicate success
+ */
+esp_err_t ina3221_get_all(ina3221_t *dev, ina3221_data_t *data, bool *ready);
+
 /**
  * @brief Set Critical alert
  *
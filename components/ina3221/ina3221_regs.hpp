@@ -0,0 +1,86 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file ina3221_regs.hpp
+ * @defgroup ina3221_regs ina3221_regs
+ * @{
+ *
+ * INA3221 register map for i2cdev_regs.hpp
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __INA3221_REGS_HPP__
+#define __INA3221_REGS_HPP__
+
+#include <i2cdev_regs.hpp>
+
+namespace ina3221_regs {
+
+using i2cdev::reg;
+using i2cdev::field;
+
+/// Configuration register
+struct config : reg<0x00, uint16_t>
+{
+    typedef field<config, 0> esht;     //!< Measure shunt voltage
+    typedef field<config, 1> ebus;     //!< Measure bus voltage
+    typedef field<config, 2> mode;     //!< Continuous mode
+    typedef field<config, 3, 3> vsht;  //!< Shunt voltage conversion time
+    typedef field<config, 6, 3> vbus;  //!< Bus voltage conversion time
+    typedef field<config, 9, 3> avg;   //!< Averaging mode
+    typedef field<config, 12> ch3;     //!< Enable channel 3
+    typedef field<config, 13> ch2;     //!< Enable channel 2
+    typedef field<config, 14> ch1;     //!< Enable channel 1
+    typedef field<config, 15> rst;     //!< Reset
+};
+
+/// Shunt voltage register of channel N (0..2)
+template <unsigned N>
+struct shunt_voltage : reg<0x01 + N * 2, uint16_t> { static_assert(N < 3, "Invalid channel"); };
+
+/// Bus voltage register of channel N (0..2)
+template <unsigned N>
+struct bus_voltage : reg<0x02 + N * 2, uint16_t> { static_assert(N < 3, "Invalid channel"); };
+
+/// Mask/enable register
+struct mask : reg<0x0f, uint16_t>
+{
+    typedef field<mask, 0> cvrf;     //!< Conversion ready flag
+    typedef field<mask, 1> tcf;      //!< Timing control flag
+    typedef field<mask, 2> pvf;      //!< Power valid flag
+    typedef field<mask, 3, 3> wf;    //!< Warning alert flags
+    typedef field<mask, 6> sf;       //!< Sum alert flag
+    typedef field<mask, 7, 3> cf;    //!< Critical alert flags
+    typedef field<mask, 10> cen;     //!< Critical alert latch
+    typedef field<mask, 11> wen;     //!< Warning alert latch
+    typedef field<mask, 12> scc3;    //!< Channel 3 in shunt sum
+    typedef field<mask, 13> scc2;    //!< Channel 2 in shunt sum
+    typedef field<mask, 14> scc1;    //!< Channel 1 in shunt sum
+};
+
+} // namespace ina3221_regs
+
+/**@}*/
+
+#endif /* __INA3221_REGS_HPP__ */
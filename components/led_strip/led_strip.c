@@ -31,15 +31,43 @@
  * MIT Licensed as described in the file LICENSE
  */
 #include "led_strip.h"
+#include "led_strip_timing.h"
+#include "led_strip_priv.h"
 #include <esp_log.h>
 #include <esp_attr.h>
 #include <stdlib.h>
+#include <string.h>
 #include <esp_idf_lib_helpers.h>
 
 #if HELPER_TARGET_IS_ESP8266
 #error led_strip is not supported on ESP8266
 #endif
 
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0)
+#include <soc/soc_caps.h>
+#endif
+
+#if LED_STRIP_RMT_ENCODER
+
+#if ESP_IDF_VERSION < ESP_IDF_VERSION_VAL(5, 0, 0)
+#error RMT encoder backend of led_strip requires ESP-IDF >= 5.0
+#endif
+#include <esp_heap_caps.h>
+
+#define LED_STRIP_RMT_RESOLUTION 40000000 // 25 ns per tick
+#define LED_STRIP_RMT_DMA_SYMBOLS 1024
+#define LED_STRIP_RESET_US 50
+
+#define NS_TO_TICKS(ns) ((ns) * (LED_STRIP_RMT_RESOLUTION / 1000000) / 1000)
+
+#else
+
+#if defined(SOC_RMT_SUPPORT_TX_SYNCHRO) && SOC_RMT_SUPPORT_TX_SYNCHRO
+#define LED_STRIP_TX_SYNC 1
+#else
+#define LED_STRIP_TX_SYNC 0
+#endif
+
 #ifndef RMT_DEFAULT_CONFIG_TX
 #define RMT_DEFAULT_CONFIG_TX(gpio, channel_id)      \
     {                                                \
@@ -60,40 +88,186 @@
     }
 #endif
 
-static const char *TAG = "led_strip";
-
 #define LED_STRIP_RMT_CLK_DIV 2
 
-#define WS2812_T0H_NS   400
-#define WS2812_T0L_NS   1000
-#define WS2812_T1H_NS   1000
-#define WS2812_T1L_NS   400
-
-#define SK6812_T0H_NS   300
-#define SK6812_T0L_NS   900
-#define SK6812_T1H_NS   600
-#define SK6812_T1L_NS   600
+#endif /* LED_STRIP_RMT_ENCODER */
 
-#define APA106_T0H_NS   350
-#define APA106_T0L_NS   1360
-#define APA106_T1H_NS   1360
-#define APA106_T1L_NS   350
+static const char *TAG = "led_strip";
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
 #define COLOR_SIZE(strip) (3 + ((strip)->is_rgbw != 0))
 
-static rmt_item32_t ws2812_bit0 = { 0 };
-static rmt_item32_t ws2812_bit1 = { 0 };
-static rmt_item32_t sk6812_bit0 = { 0 };
-static rmt_item32_t sk6812_bit1 = { 0 };
-static rmt_item32_t apa106_bit0 = { 0 };
-static rmt_item32_t apa106_bit1 = { 0 };
+#if !LED_STRIP_RMT_ENCODER
+// RMT items for 4 bits, MSB first
+typedef struct
+{
+    rmt_item32_t items[4];
+} nibble_items_t;
+
+// RMT items for every nibble value, computed once in led_strip_install()
+static DRAM_ATTR nibble_items_t ws2812_nibbles[16];
+static DRAM_ATTR nibble_items_t sk6812_nibbles[16];
+static DRAM_ATTR nibble_items_t apa106_nibbles[16];
+#endif
+
+// Move white part of the color to white channel, see LED_STRIP_WHITE_TEMP
+static uint8_t IRAM_ATTR white_temp(led_strip_t *strip, rgb_t *c)
+{
+    rgb_t wc = strip->white_color;
+    if (!wc.r && !wc.g && !wc.b)
+        wc = rgb_from_code(LED_STRIP_WHITE_COLOR);
+    if (wc.r != strip->white_cache.r || wc.g != strip->white_cache.g || wc.b != strip->white_cache.b
+            || !(strip->white_k[0] | strip->white_k[1] | strip->white_k[2]))
+    {
+        // channels not present in white color don't limit white
+        strip->white_k[0] = wc.r ? (255 << 8) / wc.r : 0;
+        strip->white_k[1] = wc.g ? (255 << 8) / wc.g : 0;
+        strip->white_k[2] = wc.b ? (255 << 8) / wc.b : 0;
+        strip->white_cache = wc;
+    }
+
+    uint8_t *ch[3] = { &c->r, &c->g, &c->b };
+    const uint8_t wch[3] = { wc.r, wc.g, wc.b };
+    uint32_t w = 255;
+    for (int i = 0; i < 3; i++)
+    {
+        if (!strip->white_k[i])
+            continue;
+        uint32_t t = (*ch[i] * strip->white_k[i]) >> 8;
+        if (t < w) w = t;
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        // w * wch / 255
+        uint32_t sub = (w * wch[i] * 257 + 257) >> 16;
+        *ch[i] = *ch[i] > sub ? *ch[i] - sub : 0;
+    }
+
+    return w;
+}
+
+// Convert color to strip color order with white channel
+static inline void IRAM_ATTR encode_pixel(led_strip_t *strip, rgb_t c, uint8_t *out)
+{
+    uint8_t w = 0;
+    if (strip->is_rgbw)
+    {
+        switch (strip->white)
+        {
+            case LED_STRIP_WHITE_NONE:
+                break;
+            case LED_STRIP_WHITE_MIN:
+                w = c.r < c.g ? c.r : c.g;
+                if (c.b < w) w = c.b;
+                c.r -= w;
+                c.g -= w;
+                c.b -= w;
+                break;
+            case LED_STRIP_WHITE_TEMP:
+                w = white_temp(strip, &c);
+                break;
+            default:
+                w = rgb_luma(c);
+        }
+        out[3] = w;
+    }
+    if (strip->type == LED_STRIP_APA106)
+    {
+        // RGB
+        out[0] = c.r;
+        out[1] = c.g;
+    }
+    else
+    {
+        // GRB
+        out[0] = c.g;
+        out[1] = c.r;
+    }
+    out[2] = c.b;
+}
+
+#ifdef LED_STRIP_BRIGHTNESS
+// Gamma table of byte number `idx` of the pixel in strip color order, NULL for white
+static const uint8_t *gamma_table(const led_strip_t *strip, uint8_t idx)
+{
+    if (!strip->gamma)
+        return NULL;
+    switch (idx)
+    {
+        case 0:
+            return strip->type == LED_STRIP_APA106 ? strip->gamma->r : strip->gamma->g;
+        case 1:
+            return strip->type == LED_STRIP_APA106 ? strip->gamma->g : strip->gamma->r;
+        case 2:
+            return strip->gamma->b;
+        default:
+            return NULL;
+    }
+}
+
+// Colour correction of byte number `idx` of the pixel in strip color order
+static uint8_t correction(const led_strip_t *strip, uint8_t idx)
+{
+    rgb_t c = strip->correction;
+    if (rgb_is_zero(c))
+        return 255;
+    switch (idx)
+    {
+        case 0:
+            return strip->type == LED_STRIP_APA106 ? c.r : c.g;
+        case 1:
+            return strip->type == LED_STRIP_APA106 ? c.g : c.r;
+        case 2:
+            return c.b;
+        default:
+            return 255;
+    }
+}
+#endif
+
+#if !LED_STRIP_RMT_ENCODER
+
+#ifdef LED_STRIP_BRIGHTNESS
+// Translate caller-owned rgb_t array, see led_strip_flush_pixels()
+static void IRAM_ATTR _rgb_adapter(led_strip_t *strip, const rgb_t *src, nibble_items_t *dest, size_t src_size,
+                                   size_t wanted_num, size_t *translated_size, size_t *item_num,
+                                   const nibble_items_t *nibbles, const uint8_t *lut)
+{
+    size_t size = 0;
+    size_t num = 0;
+    uint32_t sum = 0;
+    uint8_t color_size = COLOR_SIZE(strip);
+
+    // Pixel may be split between calls when RMT asks for less items than a pixel takes,
+    // so source is consumed by whole pixels and position inside the pixel is kept in strip
+    while (size < src_size && num + 8 <= wanted_num)
+    {
+        if (!strip->rgb_offset)
+            encode_pixel(strip, *src, strip->rgb_px);
+        uint8_t b = strip->rgb_px[strip->rgb_offset];
+        if (lut) b = lut[(strip->rgb_offset << 8) | b];
+        sum += b;
+        *dest++ = nibbles[b >> 4];
+        *dest++ = nibbles[b & 0x0f];
+        num += 8;
+        if (++strip->rgb_offset == color_size)
+        {
+            strip->rgb_offset = 0;
+            src++;
+            size += sizeof(rgb_t);
+        }
+    }
+    strip->power_sum += sum;
+    *translated_size = size;
+    *item_num = num;
+}
+#endif
 
 static void IRAM_ATTR _rmt_adapter(const void *src, rmt_item32_t *dest, size_t src_size,
                                    size_t wanted_num, size_t *translated_size, size_t *item_num,
-                                   const rmt_item32_t *bit0, const rmt_item32_t *bit1)
+                                   const nibble_items_t *nibbles)
 {
     if (!src || !dest)
     {
@@ -103,30 +277,46 @@ static void IRAM_ATTR _rmt_adapter(const void *src, rmt_item32_t *dest, size_t s
     }
     size_t size = 0;
     size_t num = 0;
-    uint8_t *psrc = (uint8_t *)src;
-    rmt_item32_t *pdest = dest;
+    const uint8_t *psrc = (const uint8_t *)src;
+    nibble_items_t *pdest = (nibble_items_t *)dest;
 #ifdef LED_STRIP_BRIGHTNESS
     led_strip_t *strip;
     esp_err_t r = rmt_translator_get_context(item_num, (void **)&strip);
-    uint8_t brightness = r == ESP_OK ? strip->brightness : 255;
+    // Tables are updated in led_strip_flush()
+    const uint8_t *lut = r == ESP_OK && strip->lut_active ? strip->lut : NULL;
+    if (r == ESP_OK && strip->rgb_src)
+    {
+        _rgb_adapter(strip, (const rgb_t *)src, pdest, src_size, wanted_num, translated_size, item_num, nibbles, lut);
+        return;
+    }
+    // Transmitted channel values for current estimation
+    uint32_t sum = 0;
 #endif
     while (size < src_size && num < wanted_num)
     {
 #ifdef LED_STRIP_BRIGHTNESS
-        uint8_t b = brightness != 255 ? scale8_video(*psrc, brightness) : *psrc;
-#else
         uint8_t b = *psrc;
-#endif
-        for (int i = 0; i < 8; i++)
+        if (lut)
         {
-            // MSB first
-            pdest->val = b & (1 << (7 - i)) ? bit1->val : bit0->val;
-            num++;
-            pdest++;
+            // Position inside the pixel is kept in strip, frame may be split between calls
+            b = lut[(strip->rgb_offset << 8) | b];
+            if (++strip->rgb_offset == COLOR_SIZE(strip))
+                strip->rgb_offset = 0;
         }
+        sum += b;
+#else
+        uint8_t b = *psrc;
+#endif
+        *pdest++ = nibbles[b >> 4];
+        *pdest++ = nibbles[b & 0x0f];
+        num += 8;
         size++;
         psrc++;
     }
+#ifdef LED_STRIP_BRIGHTNESS
+    if (r == ESP_OK)
+        strip->power_sum += sum;
+#endif
     *translated_size = size;
     *item_num = num;
 }
@@ -134,66 +324,285 @@ static void IRAM_ATTR _rmt_adapter(const void *src, rmt_item32_t *dest, size_t s
 static void IRAM_ATTR ws2812_rmt_adapter(const void *src, rmt_item32_t *dest, size_t src_size,
         size_t wanted_num, size_t *translated_size, size_t *item_num)
 {
-    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, &ws2812_bit0, &ws2812_bit1);
+    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, ws2812_nibbles);
 }
 
 static void IRAM_ATTR sk6812_rmt_adapter(const void *src, rmt_item32_t *dest, size_t src_size,
         size_t wanted_num, size_t *translated_size, size_t *item_num)
 {
-    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, &sk6812_bit0, &sk6812_bit1);
+    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, sk6812_nibbles);
 }
 
 static void IRAM_ATTR apa106_rmt_adapter(const void *src, rmt_item32_t *dest, size_t src_size,
         size_t wanted_num, size_t *translated_size, size_t *item_num)
 {
-    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, &apa106_bit0, &apa106_bit1);
+    _rmt_adapter(src, dest, src_size, wanted_num, translated_size, item_num, apa106_nibbles);
 }
 
-///////////////////////////////////////////////////////////////////////////////
+static void fill_nibbles(nibble_items_t *nibbles, float ratio, uint32_t t0h, uint32_t t0l, uint32_t t1h, uint32_t t1l)
+{
+    rmt_item32_t bit0 = { 0 }, bit1 = { 0 };
+
+    bit0.duration0 = ratio * t0h;
+    bit0.level0 = 1;
+    bit0.duration1 = ratio * t0l;
+    bit0.level1 = 0;
+    bit1.duration0 = ratio * t1h;
+    bit1.level0 = 1;
+    bit1.duration1 = ratio * t1l;
+    bit1.level1 = 0;
+
+    for (int n = 0; n < 16; n++)
+        for (int i = 0; i < 4; i++)
+            nibbles[n].items[i] = n & (1 << (3 - i)) ? bit1 : bit0;
+}
 
-void led_strip_install()
+// Strips with completion callbacks by channel
+static led_strip_t *strips[RMT_CHANNEL_MAX] = { 0 };
+
+static void IRAM_ATTR tx_end_handler(rmt_channel_t channel, void *arg)
 {
-    float ratio = (float)(APB_CLK_FREQ / LED_STRIP_RMT_CLK_DIV) / 1e09;
+    led_strip_t *strip = channel < RMT_CHANNEL_MAX ? strips[channel] : NULL;
+    if (strip && strip->done_cb)
+        strip->done_cb(strip, strip->done_ctx);
+}
 
-    ws2812_bit0.duration0 = ratio * WS2812_T0H_NS;
-    ws2812_bit0.level0 = 1;
-    ws2812_bit0.duration1 = ratio * WS2812_T0L_NS;
-    ws2812_bit0.level1 = 0;
-    ws2812_bit1.duration0 = ratio * WS2812_T1H_NS;
-    ws2812_bit1.level0 = 1;
-    ws2812_bit1.duration1 = ratio * WS2812_T1L_NS;
-    ws2812_bit1.level1 = 0;
-
-    sk6812_bit0.duration0 = ratio * SK6812_T0H_NS;
-    sk6812_bit0.level0 = 1;
-    sk6812_bit0.duration1 = ratio * SK6812_T0L_NS;
-    sk6812_bit0.level1 = 0;
-    sk6812_bit1.duration0 = ratio * SK6812_T1H_NS;
-    sk6812_bit1.level0 = 1;
-    sk6812_bit1.duration1 = ratio * SK6812_T1L_NS;
-    sk6812_bit1.level1 = 0;
-
-    apa106_bit0.duration0 = ratio * APA106_T0H_NS;
-    apa106_bit0.level0 = 1;
-    apa106_bit0.duration1 = ratio * APA106_T0L_NS;
-    apa106_bit0.level1 = 0;
-    apa106_bit1.duration0 = ratio * APA106_T1H_NS;
-    apa106_bit1.level0 = 1;
-    apa106_bit1.duration1 = ratio * APA106_T1L_NS;
-    apa106_bit1.level1 = 0;
+#else /* LED_STRIP_RMT_ENCODER */
+
+// Strip bits followed by reset code, composed of bytes and copy encoders
+typedef struct
+{
+    rmt_encoder_t base;
+    rmt_encoder_t *bytes;
+    rmt_encoder_t *copy;
+    int state;
+    rmt_symbol_word_t reset;
+} strip_encoder_t;
+
+static size_t IRAM_ATTR encode_strip(rmt_encoder_t *encoder, rmt_channel_handle_t channel,
+                                     const void *data, size_t size, rmt_encode_state_t *ret_state)
+{
+    strip_encoder_t *e = __containerof(encoder, strip_encoder_t, base);
+    rmt_encode_state_t session = RMT_ENCODING_RESET;
+    rmt_encode_state_t state = RMT_ENCODING_RESET;
+    size_t num = 0;
+
+    switch (e->state)
+    {
+        case 0:
+            num += e->bytes->encode(e->bytes, channel, data, size, &session);
+            if (session & RMT_ENCODING_COMPLETE)
+                e->state = 1;
+            if (session & RMT_ENCODING_MEM_FULL)
+            {
+                state |= RMT_ENCODING_MEM_FULL;
+                break;
+            }
+            // fall through
+        case 1:
+            num += e->copy->encode(e->copy, channel, &e->reset, sizeof(e->reset), &session);
+            if (session & RMT_ENCODING_COMPLETE)
+            {
+                e->state = RMT_ENCODING_RESET;
+                state |= RMT_ENCODING_COMPLETE;
+            }
+            if (session & RMT_ENCODING_MEM_FULL)
+                state |= RMT_ENCODING_MEM_FULL;
+            break;
+    }
+    *ret_state = state;
+
+    return num;
 }
 
-esp_err_t led_strip_init(led_strip_t *strip)
+static esp_err_t IRAM_ATTR reset_strip_encoder(rmt_encoder_t *encoder)
 {
-    CHECK_ARG(strip && strip->length > 0);
+    strip_encoder_t *e = __containerof(encoder, strip_encoder_t, base);
+    rmt_encoder_reset(e->bytes);
+    rmt_encoder_reset(e->copy);
+    e->state = RMT_ENCODING_RESET;
 
-    strip->buf = calloc(strip->length, COLOR_SIZE(strip));
-    if (!strip->buf)
+    return ESP_OK;
+}
+
+static esp_err_t del_strip_encoder(rmt_encoder_t *encoder)
+{
+    strip_encoder_t *e = __containerof(encoder, strip_encoder_t, base);
+    if (e->bytes) rmt_del_encoder(e->bytes);
+    if (e->copy) rmt_del_encoder(e->copy);
+    free(e);
+
+    return ESP_OK;
+}
+
+static rmt_symbol_word_t bit_symbol(uint32_t high_ns, uint32_t low_ns)
+{
+    rmt_symbol_word_t s = {
+        .level0 = 1,
+        .duration0 = NS_TO_TICKS(high_ns),
+        .level1 = 0,
+        .duration1 = NS_TO_TICKS(low_ns),
+    };
+    return s;
+}
+
+static esp_err_t new_strip_encoder(led_strip_t *strip)
+{
+    rmt_bytes_encoder_config_t config = { .flags.msb_first = 1 };
+    switch (strip->type)
+    {
+        case LED_STRIP_WS2812:
+            config.bit0 = bit_symbol(WS2812_T0H_NS, WS2812_T0L_NS);
+            config.bit1 = bit_symbol(WS2812_T1H_NS, WS2812_T1L_NS);
+            break;
+        case LED_STRIP_SK6812:
+            config.bit0 = bit_symbol(SK6812_T0H_NS, SK6812_T0L_NS);
+            config.bit1 = bit_symbol(SK6812_T1H_NS, SK6812_T1L_NS);
+            break;
+        case LED_STRIP_APA106:
+            config.bit0 = bit_symbol(APA106_T0H_NS, APA106_T0L_NS);
+            config.bit1 = bit_symbol(APA106_T1H_NS, APA106_T1L_NS);
+            break;
+        default:
+            ESP_LOGE(TAG, "Unknown strip type %d", strip->type);
+            return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    strip_encoder_t *e = calloc(1, sizeof(strip_encoder_t));
+    if (!e)
     {
         ESP_LOGE(TAG, "Not enough memory");
         return ESP_ERR_NO_MEM;
     }
+    e->base.encode = encode_strip;
+    e->base.reset = reset_strip_encoder;
+    e->base.del = del_strip_encoder;
+    // Low level latches the data, split between both halves of the symbol
+    e->reset.level0 = 0;
+    e->reset.duration0 = NS_TO_TICKS(LED_STRIP_RESET_US * 1000) / 2;
+    e->reset.level1 = 0;
+    e->reset.duration1 = NS_TO_TICKS(LED_STRIP_RESET_US * 1000) / 2;
+
+    rmt_copy_encoder_config_t copy_config = { };
+    esp_err_t res = rmt_new_bytes_encoder(&config, &e->bytes);
+    if (res == ESP_OK)
+        res = rmt_new_copy_encoder(&copy_config, &e->copy);
+    if (res != ESP_OK)
+    {
+        del_strip_encoder(&e->base);
+        return res;
+    }
+    strip->encoder = &e->base;
+
+    return ESP_OK;
+}
+
+static bool IRAM_ATTR tx_done_handler(rmt_channel_handle_t channel, const rmt_tx_done_event_data_t *event, void *ctx)
+{
+    led_strip_t *strip = (led_strip_t *)ctx;
+    strip->done_cb(strip, strip->done_ctx);
+    return false;
+}
+
+static esp_err_t init_channel(led_strip_t *strip)
+{
+    rmt_tx_channel_config_t config = {
+        .gpio_num = strip->gpio,
+        .clk_src = RMT_CLK_SRC_DEFAULT,
+        .resolution_hz = LED_STRIP_RMT_RESOLUTION,
+        .mem_block_symbols = strip->dma ? LED_STRIP_RMT_DMA_SYMBOLS : SOC_RMT_MEM_WORDS_PER_CHANNEL,
+        .trans_queue_depth = 1,
+        .flags.with_dma = strip->dma,
+    };
+    CHECK(rmt_new_tx_channel(&config, &strip->rmt_chan));
+    CHECK(new_strip_encoder(strip));
+    if (strip->done_cb)
+    {
+        rmt_tx_event_callbacks_t cbs = { .on_trans_done = tx_done_handler };
+        CHECK(rmt_tx_register_event_callbacks(strip->rmt_chan, &cbs, strip));
+    }
+
+    return rmt_enable(strip->rmt_chan);
+}
+
+// Copy frame in strip color order or colors converted to it to transmit buffer,
+// applying output tables and summing channel values for current estimation
+static void render_frame(led_strip_t *strip, const uint8_t *data, const rgb_t *pixels)
+{
+    uint8_t color_size = COLOR_SIZE(strip);
+    const uint8_t *lut = strip->lut_active ? strip->lut : NULL;
+
+    uint8_t *dst = strip->tx_buf;
+    uint8_t px[4];
+    uint32_t sum = 0;
+    for (size_t i = 0; i < strip->length; i++)
+    {
+        const uint8_t *src = data + i * color_size;
+        if (pixels)
+        {
+            encode_pixel(strip, pixels[i], px);
+            src = px;
+        }
+        if (lut)
+            for (int c = 0; c < color_size; c++)
+                sum += *dst++ = lut[(c << 8) | src[c]];
+        else
+            for (int c = 0; c < color_size; c++)
+                sum += *dst++ = src[c];
+    }
+    strip->power_sum = sum;
+}
+
+static esp_err_t transmit(led_strip_t *strip)
+{
+    rmt_transmit_config_t config = { .loop_count = 0 };
+    return rmt_transmit(strip->rmt_chan, strip->encoder, strip->tx_buf, strip->length * COLOR_SIZE(strip), &config);
+}
+
+#endif /* LED_STRIP_RMT_ENCODER */
+
+static esp_err_t wait_done(led_strip_t *strip, TickType_t timeout)
+{
+#if LED_STRIP_RMT_ENCODER
+    return rmt_tx_wait_all_done(strip->rmt_chan, timeout == portMAX_DELAY ? -1 : (int)pdTICKS_TO_MS(timeout));
+#else
+    return rmt_wait_tx_done(strip->channel, timeout);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void led_strip_install()
+{
+#if !LED_STRIP_RMT_ENCODER
+    float ratio = (float)(APB_CLK_FREQ / LED_STRIP_RMT_CLK_DIV) / 1e09;
+
+    fill_nibbles(ws2812_nibbles, ratio, WS2812_T0H_NS, WS2812_T0L_NS, WS2812_T1H_NS, WS2812_T1L_NS);
+    fill_nibbles(sk6812_nibbles, ratio, SK6812_T0H_NS, SK6812_T0L_NS, SK6812_T1H_NS, SK6812_T1L_NS);
+    fill_nibbles(apa106_nibbles, ratio, APA106_T0H_NS, APA106_T0L_NS, APA106_T1H_NS, APA106_T1L_NS);
+#endif
+}
+
+void led_strip_reset_output(led_strip_t *strip)
+{
+#ifdef LED_STRIP_BRIGHTNESS
+    // Force table update on first flush
+    strip->lut_brightness = ~strip->brightness;
+    strip->out_brightness = strip->brightness;
+    strip->power_sum = 0;
+    strip->power_full_ua = 0;
+    strip->power_ma = 0;
+#endif
+}
+
+// Setup of output once buffers are in place
+static esp_err_t init_output(led_strip_t *strip)
+{
+    led_strip_reset_output(strip);
 
+#if LED_STRIP_RMT_ENCODER
+    return init_channel(strip);
+#else
     rmt_config_t config = RMT_DEFAULT_CONFIG_TX(strip->gpio, strip->channel);
     config.clk_div = LED_STRIP_RMT_CLK_DIV;
 
@@ -222,69 +631,344 @@ esp_err_t led_strip_init(led_strip_t *strip)
     CHECK(rmt_translator_set_context(config.channel, strip));
 #endif
 
+    if (strip->done_cb && strip->channel < RMT_CHANNEL_MAX)
+    {
+        strips[strip->channel] = strip;
+        rmt_register_tx_end_callback(tx_end_handler, NULL);
+    }
+
     return ESP_OK;
+#endif
+}
+
+esp_err_t led_strip_init(led_strip_t *strip)
+{
+    CHECK_ARG(strip && strip->length > 0);
+
+    strip->buf = calloc(strip->length, COLOR_SIZE(strip));
+    if (!strip->buf)
+    {
+        ESP_LOGE(TAG, "Not enough memory");
+        return ESP_ERR_NO_MEM;
+    }
+    strip->front_buf = NULL;
+#if LED_STRIP_RMT_ENCODER
+    // Frame is copied to transmit buffer, second drawing buffer is not needed
+    strip->tx_buf = heap_caps_calloc(strip->length, COLOR_SIZE(strip),
+            MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT | (strip->dma ? MALLOC_CAP_DMA : 0));
+    if (!strip->tx_buf)
+    {
+        ESP_LOGE(TAG, "Not enough memory");
+        free(strip->buf);
+        strip->buf = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+#else
+    if (strip->double_buffer)
+    {
+        strip->front_buf = calloc(strip->length, COLOR_SIZE(strip));
+        if (!strip->front_buf)
+        {
+            ESP_LOGE(TAG, "Not enough memory");
+            free(strip->buf);
+            strip->buf = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+#endif
+#ifdef LED_STRIP_BRIGHTNESS
+    strip->lut = malloc(LED_STRIP_LUT_SIZE);
+    if (!strip->lut)
+    {
+        ESP_LOGE(TAG, "Not enough memory");
+        free(strip->buf);
+        free(strip->front_buf);
+        strip->buf = strip->front_buf = NULL;
+#if LED_STRIP_RMT_ENCODER
+        heap_caps_free(strip->tx_buf);
+        strip->tx_buf = NULL;
+#endif
+        return ESP_ERR_NO_MEM;
+    }
+#endif
+    strip->static_buf = false;
+
+    return init_output(strip);
+}
+
+esp_err_t led_strip_init_static(led_strip_t *strip, uint8_t *mem)
+{
+    CHECK_ARG(strip && strip->length > 0 && mem);
+
+    size_t frame_size = strip->length * COLOR_SIZE(strip);
+    memset(mem, 0, LED_STRIP_BUFFER_SIZE(strip->length, strip->is_rgbw, strip->double_buffer));
+#ifdef LED_STRIP_BRIGHTNESS
+    strip->lut = mem;
+    mem += LED_STRIP_LUT_SIZE;
+#endif
+    strip->buf = mem;
+    mem += frame_size;
+    strip->front_buf = NULL;
+#if LED_STRIP_RMT_ENCODER
+    strip->tx_buf = mem;
+#else
+    if (strip->double_buffer)
+        strip->front_buf = mem;
+#endif
+    strip->static_buf = true;
+
+    return init_output(strip);
 }
 
 esp_err_t led_strip_free(led_strip_t *strip)
 {
     CHECK_ARG(strip && strip->buf);
-    free(strip->buf);
+    if (!strip->static_buf)
+    {
+        free(strip->buf);
+        free(strip->front_buf);
+#ifdef LED_STRIP_BRIGHTNESS
+        free(strip->lut);
+#endif
+#if LED_STRIP_RMT_ENCODER
+        heap_caps_free(strip->tx_buf);
+#endif
+    }
+    strip->buf = strip->front_buf = NULL;
+#ifdef LED_STRIP_BRIGHTNESS
+    strip->lut = NULL;
+#endif
 
+#if LED_STRIP_RMT_ENCODER
+    CHECK(rmt_disable(strip->rmt_chan));
+    CHECK(rmt_del_channel(strip->rmt_chan));
+    CHECK(rmt_del_encoder(strip->encoder));
+    strip->tx_buf = NULL;
+#else
+    if (strip->channel < RMT_CHANNEL_MAX && strips[strip->channel] == strip)
+        strips[strip->channel] = NULL;
     CHECK(rmt_driver_uninstall(strip->channel));
+#endif
 
     return ESP_OK;
 }
 
+#ifdef LED_STRIP_BRIGHTNESS
+// Estimate current of transmitted frame and limit brightness of the next one
+static uint8_t limit_brightness(led_strip_t *strip)
+{
+    uint32_t channel_ma = strip->power_channel_ma ? strip->power_channel_ma : LED_STRIP_POWER_CHANNEL_MA;
+    // current of transmitted channel values and of dark LEDs, uA
+    uint64_t out_ua = (uint64_t)strip->power_sum * channel_ma * 1000 / 255;
+    uint32_t idle_ua = strip->length * LED_STRIP_POWER_IDLE_UA;
+    strip->power_ma = (out_ua + idle_ua) / 1000;
+    strip->power_sum = 0;
+    // Values are summed after brightness scaling, a frame sent at zero
+    // brightness tells nothing about content, so keep the previous estimate
+    if (strip->out_brightness)
+        strip->power_full_ua = out_ua * 256 / (strip->out_brightness + 1);
+    uint64_t full_ua = strip->power_full_ua;
+
+    uint8_t b = strip->brightness;
+    if (!strip->power_limit_ma || !full_ua)
+        return b;
+
+    uint64_t budget_ua = (uint64_t)strip->power_limit_ma * 1000;
+    if (budget_ua <= idle_ua)
+        return 0;
+    uint64_t max = (budget_ua - idle_ua) * 256 / full_ua;
+    if (max <= b)
+        b = max ? max - 1 : 0;
+
+    return b;
+}
+#endif
+
+void led_strip_update_lut(led_strip_t *strip)
+{
+#ifdef LED_STRIP_BRIGHTNESS
+    uint8_t brightness = limit_brightness(strip);
+    strip->out_brightness = brightness;
+    rgb_t c = strip->correction;
+    bool dither = strip->dither && brightness != 255;
+    if (dither || brightness != strip->lut_brightness || strip->gamma != strip->lut_gamma
+            || rgb_to_code(c) != rgb_to_code(strip->lut_correction))
+    {
+        // Rounding threshold walks through 8 evenly spaced values in bit-reversed
+        // order, so the average of consecutive frames equals the exact scaled value
+        static const uint8_t offsets[8] = { 16, 144, 80, 208, 48, 176, 112, 240 };
+        uint8_t offset = dither ? offsets[strip->dither_frame++ & 7] : 0;
+        for (int i = 0; i < COLOR_SIZE(strip); i++)
+            color_output_lut_init(strip->lut + (i << 8), gamma_table(strip, i), correction(strip, i),
+                    brightness, offset);
+        strip->lut_active = brightness != 255 || strip->gamma || !rgb_is_zero(c);
+        // Force regular table rebuild when dithering is switched off
+        strip->lut_brightness = dither ? ~brightness : brightness;
+        strip->lut_gamma = strip->gamma;
+        strip->lut_correction = c;
+    }
+    strip->rgb_src = false;
+    strip->rgb_offset = 0;
+#endif
+}
+
+// Must be called when previous transmission is complete
+static const uint8_t *prepare_frame(led_strip_t *strip)
+{
+    led_strip_update_lut(strip);
+
+    if (!strip->front_buf)
+        return strip->buf;
+
+    // Swap buffers: drawn frame is transmitted, drawing continues on its copy
+    uint8_t *tmp = strip->front_buf;
+    strip->front_buf = strip->buf;
+    strip->buf = tmp;
+    memcpy(strip->buf, strip->front_buf, strip->length * COLOR_SIZE(strip));
+
+    return strip->front_buf;
+}
+
 esp_err_t led_strip_flush(led_strip_t *strip)
 {
     CHECK_ARG(strip && strip->buf);
 
+    CHECK(wait_done(strip, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+    const uint8_t *data = prepare_frame(strip);
+#if LED_STRIP_RMT_ENCODER
+    render_frame(strip, data, NULL);
+
+    return transmit(strip);
+#else
+    ets_delay_us(50);
+
+    return rmt_write_sample(strip->channel, data, strip->length * COLOR_SIZE(strip), false);
+#endif
+}
+
+esp_err_t led_strip_flush_pixels(led_strip_t *strip, const rgb_t *pixels)
+{
+    CHECK_ARG(strip && strip->buf && pixels);
+
+#if LED_STRIP_RMT_ENCODER
+    CHECK(wait_done(strip, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+    led_strip_update_lut(strip);
+    render_frame(strip, NULL, pixels);
+
+    return transmit(strip);
+#elif defined(LED_STRIP_BRIGHTNESS)
     CHECK(rmt_wait_tx_done(strip->channel, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+    led_strip_update_lut(strip);
+    strip->rgb_src = true;
+    strip->rgb_offset = 0;
+    ets_delay_us(50);
+
+    return rmt_write_sample(strip->channel, (const uint8_t *)pixels, strip->length * sizeof(rgb_t), false);
+#else
+    // No translator context, fall back to staging buffer
+    CHECK(rmt_wait_tx_done(strip->channel, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+    for (size_t i = 0; i < strip->length; i++)
+        CHECK(led_strip_set_pixel(strip, i, pixels[i]));
+    return led_strip_flush(strip);
+#endif
+}
+
+#define DITHER_CHUNK 32
+
+esp_err_t led_strip_flush_pixels16(led_strip_t *strip, const rgb16_t *pixels)
+{
+    CHECK_ARG(strip && strip->buf && pixels);
+    if (strip->type > LED_STRIP_APA106)
+    {
+        ESP_LOGE(TAG, "Unknown strip type %d", strip->type);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    // Strip buffer is being transmitted in single buffer mode
+    CHECK(wait_done(strip, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+
+    rgb_t chunk[DITHER_CHUNK];
+    for (size_t i = 0; i < strip->length; i += DITHER_CHUNK)
+    {
+        size_t n = strip->length - i < DITHER_CHUNK ? strip->length - i : DITHER_CHUNK;
+        rgb16_to_rgb_dither_array(pixels + i, chunk, n, strip->frame16 + i);
+        for (size_t j = 0; j < n; j++)
+            encode_pixel(strip, chunk[j], strip->buf + (i + j) * COLOR_SIZE(strip));
+    }
+    strip->frame16++;
+
+    return led_strip_flush(strip);
+}
+
+esp_err_t led_strip_group_flush(led_strip_t **strips, size_t count)
+{
+    CHECK_ARG(strips && count && count <= LED_STRIP_GROUP_MAX);
+    for (size_t i = 0; i < count; i++)
+        CHECK_ARG(strips[i] && strips[i]->buf);
+
+    for (size_t i = 0; i < count; i++)
+        CHECK(wait_done(strips[i], pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+
+    const uint8_t *data[LED_STRIP_GROUP_MAX];
+    for (size_t i = 0; i < count; i++)
+        data[i] = prepare_frame(strips[i]);
+
+#if LED_STRIP_RMT_ENCODER
+    // Frames are rendered before the first transmission is started, so the
+    // starts are only microseconds apart, but not synchronized by hardware
+    for (size_t i = 0; i < count; i++)
+        render_frame(strips[i], data[i], NULL);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < count && res == ESP_OK; i++)
+        res = transmit(strips[i]);
+
+    return res;
+#else
     ets_delay_us(50);
-    return rmt_write_sample(strip->channel, strip->buf,
-                            strip->length * COLOR_SIZE(strip), false);
+
+#if LED_STRIP_TX_SYNC
+    // Hardware starts all channels of the group at once when the last one is started
+    for (size_t i = 0; i < count; i++)
+        CHECK(rmt_add_channel_to_group(strips[i]->channel));
+#endif
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < count && res == ESP_OK; i++)
+        res = rmt_write_sample(strips[i]->channel, data[i], strips[i]->length * COLOR_SIZE(strips[i]), false);
+
+#if LED_STRIP_TX_SYNC
+    for (size_t i = 0; i < count; i++)
+        rmt_remove_channel_from_group(strips[i]->channel);
+#endif
+
+    return res;
+#endif
 }
 
 bool led_strip_busy(led_strip_t *strip)
 {
     if (!strip) return false;
-    return rmt_wait_tx_done(strip->channel, 0) == ESP_ERR_TIMEOUT;
+    return wait_done(strip, 0) == ESP_ERR_TIMEOUT;
 }
 
 esp_err_t led_strip_wait(led_strip_t *strip, TickType_t timeout)
 {
     CHECK_ARG(strip);
 
-    return rmt_wait_tx_done(strip->channel, timeout);
+    return wait_done(strip, timeout);
 }
 
 esp_err_t led_strip_set_pixel(led_strip_t *strip, size_t num, rgb_t color)
 {
     CHECK_ARG(strip && strip->buf && num <= strip->length);
-    size_t idx = num * COLOR_SIZE(strip);
-    switch (strip->type)
+    if (strip->type > LED_STRIP_APA106)
     {
-        case LED_STRIP_WS2812:
-        case LED_STRIP_SK6812:
-            // GRB
-            strip->buf[idx] = color.g;
-            strip->buf[idx + 1] = color.r;
-            strip->buf[idx + 2] = color.b;
-            if (strip->is_rgbw)
-                strip->buf[idx + 3] = rgb_luma(color);
-            break;
-        case LED_STRIP_APA106:
-            // RGB
-            strip->buf[idx] = color.r;
-            strip->buf[idx + 1] = color.g;
-            strip->buf[idx + 2] = color.b;
-            if (strip->is_rgbw)
-                strip->buf[idx + 3] = rgb_luma(color);
-            break;
-        default:
-            ESP_LOGE(TAG, "Unknown strip type %d", strip->type);
-            return ESP_ERR_NOT_SUPPORTED;
+        ESP_LOGE(TAG, "Unknown strip type %d", strip->type);
+        return ESP_ERR_NOT_SUPPORTED;
     }
+    encode_pixel(strip, color, strip->buf + num * COLOR_SIZE(strip));
+
     return ESP_OK;
 }
 
@@ -35,9 +35,17 @@
 #ifndef __LED_STRIP_H__
 #define __LED_STRIP_H__
 
+#include <sdkconfig.h>
 #include <driver/gpio.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#if CONFIG_LED_STRIP_RMT_ENCODER
+#include <driver/rmt_tx.h>
+#include <driver/rmt_types_legacy.h>
+#define LED_STRIP_RMT_ENCODER 1
+#else
 #include <driver/rmt.h>
+#endif
 #include <color.h>
 
 #ifdef __cplusplus
@@ -48,6 +56,14 @@ extern "C" {
 #define LED_STRIP_BRIGHTNESS 1
 #endif
 
+#ifndef LED_STRIP_POWER_CHANNEL_MA
+#define LED_STRIP_POWER_CHANNEL_MA 20   ///< Default current of one channel at full duty, mA
+#endif
+
+#ifndef LED_STRIP_POWER_IDLE_UA
+#define LED_STRIP_POWER_IDLE_UA 1000    ///< Current of one dark LED, uA
+#endif
+
 /**
  * LED type
  */
@@ -58,22 +74,115 @@ typedef enum
     LED_STRIP_APA106
 } led_strip_type_t;
 
+/**
+ * White channel extraction of RGBW strips
+ */
+typedef enum
+{
+    LED_STRIP_WHITE_LUMA = 0, ///< White is luma of the color, RGB channels are kept
+    LED_STRIP_WHITE_NONE,     ///< White channel is off
+    LED_STRIP_WHITE_MIN,      ///< Common part of RGB channels is moved to white
+    LED_STRIP_WHITE_TEMP,     ///< As much of `white_color` as the color contains is moved to white,
+                              ///< for white LEDs of a given color temperature
+} led_strip_white_t;
+
+#ifndef LED_STRIP_WHITE_COLOR
+#define LED_STRIP_WHITE_COLOR 0xffdbba ///< Default color of white LED, about 4500K
+#endif
+
+#define LED_STRIP_GROUP_MAX 8 ///< Maximal number of strips in led_strip_group_flush(), RMT TX channels of ESP32
+
+#ifdef LED_STRIP_BRIGHTNESS
+#define LED_STRIP_LUT_SIZE 1024 ///< Size of output lookup tables, bytes
+#else
+#define LED_STRIP_LUT_SIZE 0
+#endif
+
+#if LED_STRIP_RMT_ENCODER
+#define LED_STRIP_BUFFER_SIZE(N_PIXEL, IS_RGBW, DOUBLE_BUFFER) \
+    (LED_STRIP_LUT_SIZE + (N_PIXEL) * (3 + !!(IS_RGBW)) * 2)
+#else
+/**
+ * Size in bytes of memory for ::led_strip_init_static(), `N_PIXEL` is the
+ * strip length, `IS_RGBW` and `DOUBLE_BUFFER` are the descriptor fields
+ */
+#define LED_STRIP_BUFFER_SIZE(N_PIXEL, IS_RGBW, DOUBLE_BUFFER) \
+    (LED_STRIP_LUT_SIZE + (N_PIXEL) * (3 + !!(IS_RGBW)) * (1 + !!(DOUBLE_BUFFER)))
+#endif
+
+typedef struct led_strip_s led_strip_t;
+
+/**
+ * Transmission complete callback, called from ISR
+ */
+typedef void (*led_strip_done_cb_t)(led_strip_t *strip, void *ctx);
+
 /**
  * LED strip descriptor
  */
-typedef struct
+struct led_strip_s
 {
     led_strip_type_t type; ///< LED type
     bool is_rgbw;          ///< true for RGBW strips
+    led_strip_white_t white; ///< White channel extraction of RGBW strips, applied when pixels are set
+                           ///< or, for ::led_strip_flush_pixels(), by RMT translator
+    rgb_t white_color;     ///< Color of white LEDs for ::LED_STRIP_WHITE_TEMP, black for ::LED_STRIP_WHITE_COLOR
 #ifdef LED_STRIP_BRIGHTNESS
     uint8_t brightness;    ///< Brightness 0..255, call ::led_strip_flush() after change.
                            ///< Supported only for ESP-IDF version >= 4.4
+    bool dither;           ///< Temporal dithering of brightness scaling, call ::led_strip_flush()
+                           ///< continuously (at 100 Hz or more) when enabled.
+                           ///< Supported only for ESP-IDF version >= 4.4
+    const color_gamma_t *gamma; ///< Gamma correction applied on transmission before brightness
+                           ///< or NULL. Tables are read from RMT interrupt and must be in RAM.
+                           ///< White channel of RGBW strips is not corrected.
+                           ///< Supported only for ESP-IDF version >= 4.4
+    rgb_t correction;      ///< Colour correction, per channel scale applied with brightness, black for none.
+                           ///< White channel of RGBW strips is not corrected.
+                           ///< Supported only for ESP-IDF version >= 4.4
+    uint32_t power_limit_ma; ///< Current budget of strip, mA, 0 for no limit. Brightness is lowered
+                           ///< so that estimated current doesn't exceed it, see `power_ma`.
+                           ///< Supported only for ESP-IDF version >= 4.4
+    uint8_t power_channel_ma; ///< Current of one channel at full duty, mA, 0 for ::LED_STRIP_POWER_CHANNEL_MA
+    uint32_t power_ma;     ///< Estimated current of the last transmitted frame, mA, updated by flush
 #endif
     size_t length;         ///< Number of LEDs in strip
     gpio_num_t gpio;       ///< Data GPIO pin
-    rmt_channel_t channel; ///< RMT channel
-    uint8_t *buf;
-} led_strip_t;
+    rmt_channel_t channel; ///< RMT channel, ignored by RMT encoder backend, where driver allocates channels
+#if LED_STRIP_RMT_ENCODER
+    bool dma;              ///< Transmit with DMA, on chips with RMT DMA support (ESP32-S3).
+                           ///< RMT encoder backend only
+#endif
+    bool double_buffer;    ///< Allocate second buffer, so drawing and transmission can overlap
+    led_strip_done_cb_t done_cb; ///< Transmission complete callback, NULL if not used
+    void *done_ctx;        ///< Transmission complete callback context
+    uint8_t *buf;          ///< Buffer to draw into
+    uint8_t *front_buf;    ///< Internal: buffer being transmitted in double buffer mode
+    bool static_buf;       ///< Internal: buffers are provided by caller, see ::led_strip_init_static()
+    rgb_t white_cache;     ///< Internal: white color of `white_k`
+    uint16_t white_k[3];   ///< Internal: 8.8 reciprocals of white color channels
+    uint8_t frame16;       ///< Internal: dithering frame counter of ::led_strip_flush_pixels16()
+#if LED_STRIP_RMT_ENCODER
+    rmt_channel_handle_t rmt_chan; ///< Internal: RMT TX channel
+    rmt_encoder_handle_t encoder;  ///< Internal: RMT encoder of strip bits and reset code
+    uint8_t *tx_buf;          ///< Internal: frame being transmitted, with gamma and brightness applied
+#endif
+#ifdef LED_STRIP_BRIGHTNESS
+    uint8_t *lut;             ///< Internal: output tables of colour correction, gamma and brightness,
+                              ///< 256 bytes per channel in strip color order
+    bool lut_active;          ///< Internal: output tables are not identity
+    uint8_t lut_brightness;   ///< Internal: brightness of the output tables
+    const color_gamma_t *lut_gamma; ///< Internal: gamma tables of the output tables
+    rgb_t lut_correction;     ///< Internal: colour correction of the output tables
+    bool rgb_src;             ///< Internal: transmitting caller-owned rgb_t array
+    uint8_t rgb_offset;       ///< Internal: byte position inside current rgb_t pixel
+    uint8_t rgb_px[4];        ///< Internal: current rgb_t pixel in strip color order
+    uint8_t dither_frame;     ///< Internal: dithering frame counter
+    uint8_t out_brightness;   ///< Internal: brightness of transmitted frame, limited by power budget
+    uint32_t power_sum;       ///< Internal: sum of channel values of transmitted frame, from RMT translator
+    uint64_t power_full_ua;   ///< Internal: estimated current of the frame at full brightness, uA
+#endif
+};
 
 /**
  * @brief Setup library
@@ -90,6 +199,23 @@ void led_strip_install();
  */
 esp_err_t led_strip_init(led_strip_t *strip);
 
+/**
+ * @brief Initialize LED strip with caller-provided buffer memory
+ *
+ * Works as ::led_strip_init(), but strip buffer (and second buffer,
+ * output tables, transmit buffer) are placed in `mem` instead of the
+ * heap, so it can be a static array laid out at link time. With `dma`
+ * set, `mem` must be DMA-capable internal RAM. Memory is cleared by this
+ * function and is not freed by ::led_strip_free(). RMT driver still
+ * allocates its own state on the heap.
+ *
+ * @param strip Descriptor of LED strip
+ * @param mem Memory of ::LED_STRIP_BUFFER_SIZE(strip->length, strip->is_rgbw,
+ *            strip->double_buffer) bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_init_static(led_strip_t *strip, uint8_t *mem);
+
 /**
  * @brief Deallocate buffer memory and release RMT channel
  *
@@ -101,11 +227,73 @@ esp_err_t led_strip_free(led_strip_t *strip);
 /**
  * @brief Send strip buffer to LEDs
  *
+ * Function waits for the previous transmission to complete, starts
+ * a new one and returns without waiting for it.
+ * Current of the previous frame is estimated from the channel values
+ * summed up by RMT translator during its transmission, and brightness of
+ * the new frame is limited by `power_limit_ma` accordingly, so the limit
+ * follows content with one frame delay.
+ * In double buffer mode buffers are swapped: the drawn buffer is
+ * transmitted while its copy becomes the new drawing buffer, so the next
+ * frame can be drawn during transmission.
+ * Otherwise the buffer must not be changed until transmission is complete,
+ * see ::led_strip_wait().
+ * RMT encoder backend copies the frame to its transmit buffer, so the
+ * buffer can be changed as soon as the function returns and
+ * `double_buffer` is ignored.
+ *
  * @param strip Descriptor of LED strip
  * @return `ESP_OK` on success
  */
 esp_err_t led_strip_flush(led_strip_t *strip);
 
+/**
+ * @brief Send caller-owned array of colors to LEDs
+ *
+ * Colors are converted to strip color order (and white channel for RGBW
+ * strips) by RMT translator on the fly, strip buffer is not used.
+ * Array must contain `strip->length` items and must not be changed until
+ * transmission is complete, see ::led_strip_wait().
+ *
+ * On ESP-IDF versions prior to 4.4 colors are copied to strip buffer
+ * first, because RMT translator has no context there.
+ *
+ * @param strip Descriptor of LED strip
+ * @param pixels Array of colors
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_flush_pixels(led_strip_t *strip, const rgb_t *pixels);
+
+/**
+ * @brief Send array of 16-bit per channel colors to LEDs
+ *
+ * Colors are reduced to 8 bits per channel with temporal dithering into
+ * strip buffer, then buffer is sent as with ::led_strip_flush(). Fractional
+ * part of a channel is spread over 8 consecutive frames, so dim levels and
+ * slow fades are smooth instead of stepping. Call it at 100 Hz or more,
+ * otherwise dithering becomes visible as flicker.
+ *
+ * @param strip Descriptor of LED strip
+ * @param pixels Array of `strip->length` colors
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_flush_pixels16(led_strip_t *strip, const rgb16_t *pixels);
+
+/**
+ * @brief Send buffers of several strips to LEDs simultaneously
+ *
+ * Works as ::led_strip_flush() for every strip, but starts transmissions
+ * together, so frame time is the time of the longest strip. On chips with
+ * RMT TX synchronization (ESP32-S2, ESP32-C3 and newer) all channels are
+ * started by hardware at the same moment.
+ *
+ * @param strips Array of pointers to strip descriptors, strips must use
+ *               different RMT channels
+ * @param count Number of strips, up to `LED_STRIP_GROUP_MAX`
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_group_flush(led_strip_t **strips, size_t count);
+
 /**
  * @brief Check if associated RMT channel is busy
  *
@@ -0,0 +1,447 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file led_strip_i2s.c
+ *
+ * I2S parallel output backend for WS2812B/SK6812/APA106 LED strips
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <sdkconfig.h>
+
+#ifdef CONFIG_IDF_TARGET_ESP32
+
+#include "led_strip_i2s.h"
+#include "led_strip_timing.h"
+#include "led_strip_priv.h"
+#include <esp_log.h>
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_intr_alloc.h>
+#include <stdlib.h>
+#include <string.h>
+#include <freertos/semphr.h>
+#include <driver/periph_ctrl.h>
+#include <soc/i2s_struct.h>
+#include <soc/gpio_sig_map.h>
+#include <soc/soc.h>
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(4, 3, 0)
+#include <soc/lldesc.h>
+#include <esp_rom_gpio.h>
+#define gpio_matrix_out esp_rom_gpio_connect_out_signal
+#else
+#include <rom/lldesc.h>
+#include <rom/gpio.h>
+#endif
+
+static const char *TAG = "led_strip_i2s";
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define COLOR_SIZE(g) (3 + ((g)->is_rgbw != 0))
+
+// Base clock of I2S peripheral when APLL is not used, MHz
+#define I2S_BASE_CLK_MHZ 80
+// Maximal length of DMA descriptor buffer, multiple of 4
+#define DMA_MAX_CHUNK 4092
+// Reset (latch) time appended to every frame
+#define RESET_TIME_NS 300000
+
+/*
+ * Every LED bit is split into equal slots. All lanes go high in the first
+ * slot(s), lanes sending 1 stay high until `t1` slot, then all go low.
+ */
+typedef struct
+{
+    uint8_t slots; // slots per bit
+    uint8_t t0;    // high slots for 0
+    uint8_t t1;    // high slots for 1
+    uint32_t bit_ns;
+} lane_timing_t;
+
+static const lane_timing_t timings[] = {
+    [LED_STRIP_WS2812] = { 3, 1, 2, WS2812_T0H_NS + WS2812_T0L_NS },
+    [LED_STRIP_SK6812] = { 4, 1, 2, SK6812_T0H_NS + SK6812_T0L_NS },
+    [LED_STRIP_APA106] = { 4, 1, 3, APA106_T0H_NS + APA106_T0L_NS },
+};
+
+typedef struct
+{
+    i2s_dev_t *dev;
+    uint16_t *dma_buf;
+    size_t words;
+    lldesc_t *desc;
+    size_t desc_count;
+    intr_handle_t intr;
+    SemaphoreHandle_t done;
+    volatile bool busy;
+} i2s_state_t;
+
+static void IRAM_ATTR i2s_isr(void *arg)
+{
+    i2s_state_t *st = (i2s_state_t *)arg;
+    BaseType_t woken = pdFALSE;
+
+    if (st->dev->int_st.out_eof)
+    {
+        // Last descriptor is in FIFO, rest of the reset tail keeps lines low
+        st->dev->conf.tx_start = 0;
+        st->busy = false;
+        xSemaphoreGiveFromISR(st->done, &woken);
+    }
+    st->dev->int_clr.val = st->dev->int_st.val;
+
+    if (woken)
+        portYIELD_FROM_ISR();
+}
+
+static size_t max_length(led_strip_i2s_t *group)
+{
+    size_t res = 0;
+    for (size_t i = 0; i < group->lanes; i++)
+        if (group->strips[i]->length > res)
+            res = group->strips[i]->length;
+    return res;
+}
+
+static void reset_port(i2s_dev_t *dev)
+{
+    dev->conf.tx_reset = 1;
+    dev->conf.tx_reset = 0;
+    dev->conf.tx_fifo_reset = 1;
+    dev->conf.tx_fifo_reset = 0;
+    dev->lc_conf.out_rst = 1;
+    dev->lc_conf.out_rst = 0;
+    dev->lc_conf.ahbm_rst = 1;
+    dev->lc_conf.ahbm_rst = 0;
+    dev->lc_conf.ahbm_fifo_rst = 1;
+    dev->lc_conf.ahbm_fifo_rst = 0;
+}
+
+static void setup_port(i2s_dev_t *dev, uint32_t slot_ns)
+{
+    reset_port(dev);
+
+    // LCD master transmitting mode, 16 bit parallel
+    dev->conf.val = 0;
+    dev->conf.tx_right_first = 1;
+    dev->conf2.val = 0;
+    dev->conf2.lcd_en = 1;
+    dev->conf2.lcd_tx_wrx2_en = 1;
+    dev->conf1.val = 0;
+    dev->conf1.tx_pcm_bypass = 1;
+    dev->conf1.tx_stop_en = 1;
+    dev->conf_chan.val = 0;
+    dev->conf_chan.tx_chan_mod = 1;
+    dev->fifo_conf.val = 0;
+    dev->fifo_conf.tx_fifo_mod_force_en = 1;
+    dev->fifo_conf.tx_fifo_mod = 1;
+    dev->fifo_conf.tx_data_num = 32;
+    dev->fifo_conf.dscr_en = 1;
+    dev->lc_conf.val = 0;
+    dev->lc_conf.out_eof_mode = 1;
+    dev->timing = 0;
+
+    // Word rate: I2S_BASE_CLK_MHZ / (div_num + div_b / div_a)
+    uint32_t div_x63 = (I2S_BASE_CLK_MHZ * slot_ns * 63 + 500) / 1000;
+    uint32_t div_num = div_x63 / 63;
+    uint32_t div_b = div_x63 % 63;
+    dev->clkm_conf.val = 0;
+    dev->clkm_conf.clka_en = 0;
+    dev->clkm_conf.clkm_div_a = div_b ? 63 : 1;
+    dev->clkm_conf.clkm_div_b = div_b;
+    dev->clkm_conf.clkm_div_num = div_num;
+    dev->clkm_conf.clk_en = 1;
+    dev->sample_rate_conf.val = 0;
+    dev->sample_rate_conf.tx_bits_mod = 16;
+    dev->sample_rate_conf.tx_bck_div_num = 1;
+
+    dev->int_ena.val = 0;
+    dev->int_clr.val = ~0u;
+}
+
+static void free_state(i2s_state_t *st)
+{
+    if (st->intr)
+        esp_intr_free(st->intr);
+    if (st->done)
+        vSemaphoreDelete(st->done);
+    heap_caps_free(st->dma_buf);
+    heap_caps_free(st->desc);
+    free(st);
+}
+
+static void free_lanes(led_strip_i2s_t *group)
+{
+    for (size_t i = 0; i < group->lanes; i++)
+    {
+        free(group->strips[i]->buf);
+        group->strips[i]->buf = NULL;
+#ifdef LED_STRIP_BRIGHTNESS
+        free(group->strips[i]->lut);
+        group->strips[i]->lut = NULL;
+#endif
+    }
+}
+
+esp_err_t led_strip_i2s_init(led_strip_i2s_t *group)
+{
+    CHECK_ARG(group && (group->port == 0 || group->port == 1)
+              && group->lanes > 0 && group->lanes <= LED_STRIP_I2S_MAX_LANES
+              && group->type <= LED_STRIP_APA106);
+    for (size_t i = 0; i < group->lanes; i++)
+        CHECK_ARG(group->strips[i] && group->strips[i]->length > 0);
+
+    const lane_timing_t *t = &timings[group->type];
+    uint32_t slot_ns = t->bit_ns / t->slots;
+
+    for (size_t i = 0; i < group->lanes; i++)
+    {
+        led_strip_t *strip = group->strips[i];
+        strip->type = group->type;
+        strip->is_rgbw = group->is_rgbw;
+        strip->double_buffer = false;
+        strip->front_buf = NULL;
+        strip->buf = calloc(strip->length, COLOR_SIZE(group));
+#ifdef LED_STRIP_BRIGHTNESS
+        strip->lut = malloc(LED_STRIP_LUT_SIZE);
+        if (!strip->lut)
+        {
+            // free_lanes() frees buffer of this strip too
+            free(strip->buf);
+            strip->buf = NULL;
+        }
+#endif
+        if (!strip->buf)
+        {
+            ESP_LOGE(TAG, "Not enough memory");
+            free_lanes(group);
+            return ESP_ERR_NO_MEM;
+        }
+        led_strip_reset_output(strip);
+    }
+
+    i2s_state_t *st = calloc(1, sizeof(i2s_state_t));
+    if (!st)
+    {
+        free_lanes(group);
+        return ESP_ERR_NO_MEM;
+    }
+    st->dev = group->port ? &I2S1 : &I2S0;
+
+    // Words count must be even: 16-bit words are sent in 32-bit pairs
+    size_t data_words = max_length(group) * COLOR_SIZE(group) * 8 * t->slots;
+    st->words = (data_words + RESET_TIME_NS / slot_ns + 1) & ~1u;
+    size_t bytes = st->words * sizeof(uint16_t);
+    st->desc_count = (bytes + DMA_MAX_CHUNK - 1) / DMA_MAX_CHUNK;
+
+    st->dma_buf = heap_caps_calloc(1, bytes, MALLOC_CAP_DMA);
+    st->desc = heap_caps_calloc(st->desc_count, sizeof(lldesc_t), MALLOC_CAP_DMA);
+    st->done = xSemaphoreCreateBinary();
+    if (!st->dma_buf || !st->desc || !st->done)
+    {
+        ESP_LOGE(TAG, "Not enough memory");
+        free_state(st);
+        free_lanes(group);
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint8_t *p = (uint8_t *)st->dma_buf;
+    for (size_t i = 0; i < st->desc_count; i++)
+    {
+        size_t len = bytes > DMA_MAX_CHUNK ? DMA_MAX_CHUNK : bytes;
+        st->desc[i].size = len;
+        st->desc[i].length = len;
+        st->desc[i].buf = p;
+        st->desc[i].owner = 1;
+        st->desc[i].eof = i == st->desc_count - 1;
+        st->desc[i].qe = i == st->desc_count - 1 ? NULL : &st->desc[i + 1];
+        p += len;
+        bytes -= len;
+    }
+
+    periph_module_enable(group->port ? PERIPH_I2S1_MODULE : PERIPH_I2S0_MODULE);
+    setup_port(st->dev, slot_ns);
+
+    esp_err_t res = esp_intr_alloc(group->port ? ETS_I2S1_INTR_SOURCE : ETS_I2S0_INTR_SOURCE,
+                                   ESP_INTR_FLAG_IRAM | ESP_INTR_FLAG_LEVEL1, i2s_isr, st, &st->intr);
+    if (res != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not allocate I2S interrupt: %d", res);
+        free_state(st);
+        free_lanes(group);
+        return res;
+    }
+
+    int sig = group->port ? I2S1O_DATA_OUT0_IDX : I2S0O_DATA_OUT0_IDX;
+    for (size_t i = 0; i < group->lanes; i++)
+    {
+        gpio_num_t gpio = group->strips[i]->gpio;
+        gpio_reset_pin(gpio);
+        gpio_set_direction(gpio, GPIO_MODE_OUTPUT);
+        // 16-bit LCD mode outputs words on DATA_OUT8..DATA_OUT23
+        gpio_matrix_out(gpio, sig + 8 + i, false, false);
+    }
+
+    group->priv = st;
+
+    return ESP_OK;
+}
+
+esp_err_t led_strip_i2s_free(led_strip_i2s_t *group)
+{
+    CHECK_ARG(group && group->priv);
+    i2s_state_t *st = (i2s_state_t *)group->priv;
+
+    st->dev->conf.tx_start = 0;
+    st->dev->int_ena.val = 0;
+    reset_port(st->dev);
+    periph_module_disable(group->port ? PERIPH_I2S1_MODULE : PERIPH_I2S0_MODULE);
+
+    free_state(st);
+    free_lanes(group);
+    group->priv = NULL;
+
+    return ESP_OK;
+}
+
+// Transpose bytes of all lanes at one position of the strip buffers into slot words
+static void encode(led_strip_i2s_t *group, i2s_state_t *st)
+{
+    const lane_timing_t *t = &timings[group->type];
+    size_t len = max_length(group);
+    size_t bytes = COLOR_SIZE(group);
+    size_t w = 0;
+
+#ifdef LED_STRIP_BRIGHTNESS
+    const uint8_t *lut[LED_STRIP_I2S_MAX_LANES];
+    uint32_t sum[LED_STRIP_I2S_MAX_LANES] = { 0 };
+    for (size_t l = 0; l < group->lanes; l++)
+        lut[l] = group->strips[l]->lut_active ? group->strips[l]->lut : NULL;
+#endif
+
+    for (size_t led = 0; led < len; led++)
+    {
+        // Lanes shorter than this LED index stay low
+        uint16_t active = 0;
+        const uint8_t *src[LED_STRIP_I2S_MAX_LANES];
+        for (size_t l = 0; l < group->lanes; l++)
+        {
+            led_strip_t *strip = group->strips[l];
+            src[l] = NULL;
+            if (led >= strip->length)
+                continue;
+            active |= 1 << l;
+            src[l] = strip->buf + led * bytes;
+        }
+
+        for (size_t c = 0; c < bytes; c++)
+        {
+            uint8_t v[LED_STRIP_I2S_MAX_LANES];
+            for (size_t l = 0; l < group->lanes; l++)
+            {
+                if (!src[l])
+                {
+                    v[l] = 0;
+                    continue;
+                }
+                v[l] = src[l][c];
+#ifdef LED_STRIP_BRIGHTNESS
+                // Same output tables as RMT backend: gamma, correction, brightness, dithering
+                if (lut[l])
+                    v[l] = lut[l][(c << 8) | v[l]];
+                sum[l] += v[l];
+#endif
+            }
+
+            for (int bit = 7; bit >= 0; bit--)
+            {
+                uint16_t ones = 0;
+                for (size_t l = 0; l < group->lanes; l++)
+                    ones |= ((v[l] >> bit) & 1) << l;
+
+                for (uint8_t s = 0; s < t->slots; s++, w++)
+                {
+                    // 16-bit halves of every 32-bit FIFO word are sent swapped
+                    st->dma_buf[w ^ 1] = s < t->t0 ? active : (s < t->t1 ? ones : 0);
+                }
+            }
+        }
+    }
+    // Rest of the buffer is zeroed on allocation and never written
+
+#ifdef LED_STRIP_BRIGHTNESS
+    // Current estimation of the next flush
+    for (size_t l = 0; l < group->lanes; l++)
+        group->strips[l]->power_sum = sum[l];
+#endif
+}
+
+esp_err_t led_strip_i2s_flush(led_strip_i2s_t *group)
+{
+    CHECK_ARG(group && group->priv);
+    i2s_state_t *st = (i2s_state_t *)group->priv;
+
+    CHECK(led_strip_i2s_wait(group, pdMS_TO_TICKS(CONFIG_LED_STRIP_FLUSH_TIMEOUT)));
+
+    for (size_t l = 0; l < group->lanes; l++)
+        led_strip_update_lut(group->strips[l]);
+    encode(group, st);
+
+    // Drop completion of the previous frame if nobody waited for it
+    xSemaphoreTake(st->done, 0);
+    st->busy = true;
+    i2s_dev_t *dev = st->dev;
+    reset_port(dev);
+    dev->lc_conf.out_eof_mode = 1;
+    dev->out_link.addr = (uint32_t)st->desc & 0xfffff;
+    dev->out_link.start = 1;
+    dev->int_clr.val = ~0u;
+    dev->int_ena.out_eof = 1;
+    dev->conf.tx_start = 1;
+
+    return ESP_OK;
+}
+
+bool led_strip_i2s_busy(led_strip_i2s_t *group)
+{
+    if (!group || !group->priv) return false;
+    return ((i2s_state_t *)group->priv)->busy;
+}
+
+esp_err_t led_strip_i2s_wait(led_strip_i2s_t *group, TickType_t timeout)
+{
+    CHECK_ARG(group && group->priv);
+    i2s_state_t *st = (i2s_state_t *)group->priv;
+
+    if (!st->busy)
+        return ESP_OK;
+    if (xSemaphoreTake(st->done, timeout) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    return ESP_OK;
+}
+
+#endif /* CONFIG_IDF_TARGET_ESP32 */
@@ -0,0 +1,120 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file led_strip_i2s.h
+ * @addtogroup led_strip
+ * @{
+ *
+ * I2S parallel output backend for up to 16 WS2812B/SK6812/APA106 LED strips
+ *
+ * I2S peripheral in LCD mode outputs 16-bit words to 16 GPIOs at once, so
+ * bits of all strips are transposed into a single DMA stream. Strips are
+ * drawn with ::led_strip_set_pixel() and other generic functions.
+ *
+ * Supported only on ESP32.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __LED_STRIP_I2S_H__
+#define __LED_STRIP_I2S_H__
+
+#include "led_strip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_STRIP_I2S_MAX_LANES 16 ///< Maximal number of strips driven by one I2S port
+
+/**
+ * Group of LED strips driven by one I2S port
+ */
+typedef struct
+{
+    int port;                 ///< I2S port, 0 or 1
+    led_strip_type_t type;    ///< LED type of all strips in group
+    bool is_rgbw;             ///< true for RGBW strips
+    size_t lanes;             ///< Number of strips, 1..LED_STRIP_I2S_MAX_LANES
+    led_strip_t *strips[LED_STRIP_I2S_MAX_LANES]; ///< Strip descriptors. `length`, `gpio` and
+                              ///< output fields (`brightness`, `dither`, `gamma`, `correction`,
+                              ///< `power_limit_ma`, `power_channel_ma`) are used as by RMT backend,
+                              ///< `type` and `is_rgbw` are overwritten by group values
+    void *priv;               ///< Internal: DMA buffers and interrupt state
+} led_strip_i2s_t;
+
+/**
+ * @brief Initialize I2S port and allocate buffers of all strips in group
+ *
+ * DMA buffer large enough for the longest strip is allocated as well:
+ * 2 * (3 or 4) * 8 * bytes per LED * longest strip length bytes.
+ *
+ * @param group Group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_i2s_init(led_strip_i2s_t *group);
+
+/**
+ * @brief Release I2S port and deallocate buffers
+ *
+ * @param group Group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_i2s_free(led_strip_i2s_t *group);
+
+/**
+ * @brief Send buffers of all strips in group to LEDs
+ *
+ * Function waits for the previous transmission to complete, encodes
+ * strip buffers into DMA buffer, starts transmission and returns without
+ * waiting for it. Strip buffers can be changed as soon as function returns.
+ *
+ * @param group Group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_i2s_flush(led_strip_i2s_t *group);
+
+/**
+ * @brief Check if I2S port is busy
+ *
+ * @param group Group descriptor
+ * @return true if transmission is in progress
+ */
+bool led_strip_i2s_busy(led_strip_i2s_t *group);
+
+/**
+ * @brief Wait until transmission is complete
+ *
+ * @param group Group descriptor
+ * @param timeout Timeout in RTOS ticks
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_i2s_wait(led_strip_i2s_t *group, TickType_t timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __LED_STRIP_I2S_H__ */
@@ -0,0 +1,48 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 Ruslan V. Uss <unclerus@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file led_strip_timing.h
+ * @internal
+ *
+ * Bit timings of supported LED types, shared by RMT and I2S backends
+ */
+#ifndef __LED_STRIP_TIMING_H__
+#define __LED_STRIP_TIMING_H__
+
+#define WS2812_T0H_NS   400
+#define WS2812_T0L_NS   1000
+#define WS2812_T1H_NS   1000
+#define WS2812_T1L_NS   400
+
+#define SK6812_T0H_NS   300
+#define SK6812_T0L_NS   900
+#define SK6812_T1H_NS   600
+#define SK6812_T1L_NS   600
+
+#define APA106_T0H_NS   350
+#define APA106_T0L_NS   1360
+#define APA106_T1H_NS   1360
+#define APA106_T1L_NS   350
+
+#endif /* __LED_STRIP_TIMING_H__ */
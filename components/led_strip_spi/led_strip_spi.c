@@ -26,10 +26,11 @@
 /**
  * @file led_strip.c
  *
- * SPI-based ESP-IDF driver for SK9822 LED strips
+ * SPI-based ESP-IDF driver for SK9822 and WS2812 LED strips
  *
  */
 #include <string.h>
+#include <stdlib.h>
 #include <esp_err.h>
 #include <esp_log.h>
 #include <esp_attr.h>
@@ -37,10 +38,13 @@
 #include <freertos/semphr.h>
 #include <esp_heap_caps.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "led_strip_spi.h"
 
 #if defined(CONFIG_LED_STRIP_SPI_USING_SK9822)
 #include "led_strip_spi_sk9822.h"
+#elif defined(CONFIG_LED_STRIP_SPI_USING_WS2812)
+#include "led_strip_spi_ws2812.h"
 #endif
 
 #if HELPER_TARGET_IS_ESP32
@@ -77,13 +81,21 @@ static esp_err_t led_strip_spi_init_esp32(led_strip_spi_t *strip)
     CHECK_ARG(strip);
 
     esp_err_t err = ESP_FAIL;
+    /* whole frame goes in one transaction. the driver allocates DMA
+     * descriptors for max_transfer_sz once in spi_bus_initialize(), so a
+     * frame larger than that would be rejected */
+    int frame_size = LED_STRIP_SPI_BUFFER_SIZE(strip->length);
+    if (strip->max_transfer_sz != 0 && strip->max_transfer_sz < frame_size) {
+        ESP_LOGW(TAG, "max_transfer_sz %d is less than frame size %d, increased",
+                 strip->max_transfer_sz, frame_size);
+    }
     spi_bus_config_t bus_config = {
         .miso_io_num = -1,
         .mosi_io_num = strip->mosi_io_num,
         .sclk_io_num = strip->sclk_io_num,
         .quadhd_io_num = -1,
         .quadwp_io_num = -1,
-        .max_transfer_sz = strip->max_transfer_sz,
+        .max_transfer_sz = strip->max_transfer_sz > frame_size ? strip->max_transfer_sz : frame_size,
     };
     spi_device_interface_config_t device_interface_config = {
         .clock_speed_hz = strip->clock_speed_hz,
@@ -101,7 +113,9 @@ static esp_err_t led_strip_spi_init_esp32(led_strip_spi_t *strip)
         goto fail_without_give;
     }
 
-    strip->buf = heap_caps_malloc(LED_STRIP_SPI_BUFFER_SIZE(strip->length), MALLOC_CAP_DMA | MALLOC_CAP_32BIT);
+    if (!strip->static_buf) {
+        strip->buf = heap_caps_malloc(LED_STRIP_SPI_BUFFER_SIZE(strip->length), MALLOC_CAP_DMA | MALLOC_CAP_32BIT);
+    }
     if (strip->buf == NULL) {
         ESP_LOGE(TAG, "heap_caps_malloc()");
         err = ESP_ERR_NO_MEM;
@@ -119,6 +133,12 @@ static esp_err_t led_strip_spi_init_esp32(led_strip_spi_t *strip)
         ESP_LOGE(TAG, "led_strip_spi_sk9822_buf_init(): %s", esp_err_to_name(err));
         goto fail;
     }
+#elif CONFIG_LED_STRIP_SPI_USING_WS2812
+    err = led_strip_spi_ws2812_buf_init(strip);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "led_strip_spi_ws2812_buf_init(): %s", esp_err_to_name(err));
+        goto fail;
+    }
 #endif
     ESP_LOGD(TAG, "SPI buffer initialized");
 
@@ -170,7 +190,9 @@ static esp_err_t led_strip_spi_init_esp8266(led_strip_spi_t *strip)
         goto fail_without_give;
     }
 
-    strip->buf = malloc(LED_STRIP_SPI_BUFFER_SIZE(strip->length));
+    if (!strip->static_buf) {
+        strip->buf = malloc(LED_STRIP_SPI_BUFFER_SIZE(strip->length));
+    }
     if (strip->buf == NULL) {
         ESP_LOGE(TAG, "malloc()");
         err = ESP_ERR_NO_MEM;
@@ -184,6 +206,12 @@ static esp_err_t led_strip_spi_init_esp8266(led_strip_spi_t *strip)
         ESP_LOGE(TAG, "led_strip_spi_sk9822_buf_init(): %s", esp_err_to_name(err));
         goto fail;
     }
+#elif CONFIG_LED_STRIP_SPI_USING_WS2812
+    err = led_strip_spi_ws2812_buf_init(strip);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "led_strip_spi_ws2812_buf_init(): %s", esp_err_to_name(err));
+        goto fail;
+    }
 #endif
     ESP_LOGI(TAG, "SPI buffer initialized");
     spi_config.interface = interface_config;
@@ -207,8 +235,9 @@ fail_without_give:
 }
 #endif
 
-esp_err_t led_strip_spi_init(led_strip_spi_t *strip)
+static esp_err_t init_strip(led_strip_spi_t *strip)
 {
+    strip->lut = NULL;
 #if HELPER_TARGET_IS_ESP32
     return led_strip_spi_init_esp32(strip);
 #elif HELPER_TARGET_IS_ESP8266
@@ -218,11 +247,59 @@ esp_err_t led_strip_spi_init(led_strip_spi_t *strip)
 #endif
 }
 
+esp_err_t led_strip_spi_init(led_strip_spi_t *strip)
+{
+    CHECK_ARG(strip);
+
+    strip->static_buf = false;
+    return init_strip(strip);
+}
+
+esp_err_t led_strip_spi_init_static(led_strip_spi_t *strip, void *buf)
+{
+    CHECK_ARG(strip && buf);
+
+    strip->buf = buf;
+    strip->static_buf = true;
+    return init_strip(strip);
+}
+
 esp_err_t led_strip_spi_free(led_strip_spi_t *strip)
 {
     CHECK_ARG(strip);
 
-    free(strip->buf);
+    if (!strip->static_buf) {
+        free(strip->buf);
+    }
+    free(strip->lut);
+    strip->buf = NULL;
+    strip->lut = NULL;
+    return ESP_OK;
+}
+
+esp_err_t led_strip_spi_set_output(led_strip_spi_t *strip, uint8_t brightness, const color_gamma_t *gamma, rgb_t correction)
+{
+    CHECK_ARG(strip && strip->buf);
+
+    if (brightness == 255 && !gamma && rgb_is_zero(correction)) {
+        /* identity, pixels are encoded as is */
+        free(strip->lut);
+        strip->lut = NULL;
+        return ESP_OK;
+    }
+    if (!strip->lut) {
+        strip->lut = malloc(sizeof(color_gamma_t));
+        if (!strip->lut) {
+            ESP_LOGE(TAG, "malloc()");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (rgb_is_zero(correction)) {
+        correction = rgb_from_code(0xffffff);
+    }
+    color_output_lut_init(strip->lut->r, gamma ? gamma->r : NULL, correction.r, brightness, 0);
+    color_output_lut_init(strip->lut->g, gamma ? gamma->g : NULL, correction.g, brightness, 0);
+    color_output_lut_init(strip->lut->b, gamma ? gamma->b : NULL, correction.b, brightness, 0);
     return ESP_OK;
 }
 
@@ -233,10 +310,8 @@ static esp_err_t led_strip_spi_flush_esp32(led_strip_spi_t *strip)
     spi_transaction_t* t;
 
     CHECK_ARG(strip);
-    if (!strip->transaction.tx_buffer) {
-        strip->transaction.tx_buffer = strip->buf;
-    }
     strip->transaction.tx_buffer = strip->buf;
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, strip->transaction.length);
     err = spi_device_queue_trans(strip->device_handle, &strip->transaction, portMAX_DELAY);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "spi_device_queue_trans(): %s", esp_err_to_name(err));
@@ -249,6 +324,7 @@ static esp_err_t led_strip_spi_flush_esp32(led_strip_spi_t *strip)
     }
     err = ESP_OK;
 fail:
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
     return err;
 }
 #endif
@@ -278,9 +354,10 @@ static esp_err_t led_strip_spi_flush_esp8266(led_strip_spi_t *strip)
         goto fail_without_give;
     }
 
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, LED_STRIP_SPI_BUFFER_SIZE(strip->length) * 8);
     for (int i = 0; i < mosi_buffer_block_size; i++) {
         trans.bits.mosi = ESP8266_SPI_MAX_DATA_LENGTH * 8; // bits, not bytes
-        trans.mosi = strip->buf + ESP8266_SPI_MAX_DATA_LENGTH * i / sizeof(uint32_t);
+        trans.mosi = (uint32_t *)strip->buf + ESP8266_SPI_MAX_DATA_LENGTH * i / sizeof(uint32_t);
         err = spi_trans(HSPI_HOST, &trans);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "spi_trans(): %s", esp_err_to_name(err));
@@ -289,7 +366,7 @@ static esp_err_t led_strip_spi_flush_esp8266(led_strip_spi_t *strip)
     }
     if (mosi_buffer_block_size_mod > 0) {
         trans.bits.mosi = mosi_buffer_block_size_mod * 8; // bits, not bytes
-        trans.mosi = strip->buf + ESP8266_SPI_MAX_DATA_LENGTH * mosi_buffer_block_size / sizeof(uint32_t);
+        trans.mosi = (uint32_t *)strip->buf + ESP8266_SPI_MAX_DATA_LENGTH * mosi_buffer_block_size / sizeof(uint32_t);
         err = spi_trans(HSPI_HOST, &trans);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "spi_trans(): %s", esp_err_to_name(err));
@@ -297,6 +374,7 @@ static esp_err_t led_strip_spi_flush_esp8266(led_strip_spi_t *strip)
         }
     }
 fail:
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
     if (xSemaphoreGive(mutex) != pdTRUE) {
         ESP_LOGE(TAG, "xSemaphoreGive(): failed");
     }
@@ -315,10 +393,26 @@ esp_err_t led_strip_spi_flush(led_strip_spi_t*strip)
 #endif
 }
 
-esp_err_t led_strip_spi_set_pixel(led_strip_spi_t *strip, const int index, const rgb_t color)
+esp_err_t led_strip_spi_set_pixel(led_strip_spi_t *strip, const int index, rgb_t color)
 {
+    if (strip->lut) {
+        color = color_gamma_apply(strip->lut, color);
+    }
 #if CONFIG_LED_STRIP_SPI_USING_SK9822
     return led_strip_spi_set_pixel_sk9822(strip, index, color);
+#elif CONFIG_LED_STRIP_SPI_USING_WS2812
+    return led_strip_spi_set_pixel_ws2812(strip, index, color);
+#endif
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t led_strip_spi_set_pixel_brightness(led_strip_spi_t *strip, const int index, rgb_t color, const uint8_t brightness)
+{
+#if CONFIG_LED_STRIP_SPI_USING_SK9822
+    if (strip->lut) {
+        color = color_gamma_apply(strip->lut, color);
+    }
+    return led_strip_spi_set_pixel_brightness_sk9822(strip, index, color, brightness);
 #endif
     return ESP_ERR_NOT_SUPPORTED;
 }
@@ -64,6 +64,8 @@ extern "C" {
 
 #if defined(CONFIG_LED_STRIP_SPI_USING_SK9822)
 #include "led_strip_spi_sk9822.h"
+#elif defined(CONFIG_LED_STRIP_SPI_USING_WS2812)
+#include "led_strip_spi_ws2812.h"
 #else
 #error "unknown LED type"
 #endif
@@ -84,6 +86,20 @@ esp_err_t led_strip_spi_install();
  */
 esp_err_t led_strip_spi_init(led_strip_spi_t*strip);
 
+/**
+ * @brief Initialize LED strip with caller-provided buffer
+ *
+ * Works as ::led_strip_spi_init(), but the buffer is not allocated, so it
+ * can be a static array laid out at link time. On ESP32 it must be
+ * DMA-capable (internal RAM, 32-bit aligned), on ESP8266 32-bit aligned.
+ * The buffer is not freed by ::led_strip_spi_free().
+ *
+ * @param strip Descriptor of LED strip
+ * @param buf Buffer of `LED_STRIP_SPI_BUFFER_SIZE(strip->length)` bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_spi_init_static(led_strip_spi_t *strip, void *buf);
+
 /**
  * @brief Free LED strip
  *
@@ -112,6 +128,42 @@ esp_err_t led_strip_spi_flush(led_strip_spi_t*strip);
  */
 esp_err_t led_strip_spi_set_pixel(led_strip_spi_t *strip, const int num, const rgb_t color);
 
+/**
+ * @brief Set color and per-pixel global brightness of single LED in strip.
+ *
+ * For LEDs with a separate brightness field in the LED frame, such as
+ * SK9822 and APA102, where it is 5 bit wide. Combined with 8-bit color
+ * this gives high dynamic range without scaling colors on CPU.
+ *
+ * This function does not actually change colors of the LEDs.
+ * Call ::led_strip_spi_flush() to send buffer to the LEDs.
+ *
+ * @param strip Descriptor of LED strip
+ * @param num LED number, [0:strip.length - 1].
+ * @param color RGB color
+ * @param brightness Global brightness of the LED, 0..31 for SK9822
+ * @return `ESP_OK` on success, `ESP_ERR_NOT_SUPPORTED` if LED type
+ *         has no brightness field
+ */
+esp_err_t led_strip_spi_set_pixel_brightness(led_strip_spi_t *strip, const int num, const rgb_t color, const uint8_t brightness);
+
+/**
+ * @brief Set brightness, gamma and colour correction of the strip
+ *
+ * Builds one output table per channel combining the three, so pixels are
+ * corrected with one table load per byte while they are encoded into the
+ * SPI buffer, without extra passes over it. Tables are rebuilt only by
+ * this function. Pixels set before the call keep their values, set them
+ * again to apply new output tables.
+ *
+ * @param strip Descriptor of LED strip, must be initialized
+ * @param brightness Brightness 0..255
+ * @param gamma Gamma tables, NULL for none
+ * @param correction Colour correction, per channel scale, black for none
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_spi_set_output(led_strip_spi_t *strip, uint8_t brightness, const color_gamma_t *gamma, rgb_t correction);
+
 /**
  * @brief Set colors of multiple LEDs
  *
@@ -53,12 +53,15 @@ typedef struct
     spi_host_device_t host_device;      //< SPI host device name, such as `SPI2_HOST`.
     int mosi_io_num;                    ///< GPIO number of SPI MOSI.
     int sclk_io_num;                    ///< GPIO number of SPI SCLK.
-    int max_transfer_sz;                ///< Maximum transfer size in bytes. Defaults to 4094 if 0.
+    int max_transfer_sz;                ///< Maximum transfer size in bytes. Raised to the size of the whole frame if less or 0.
     int clock_speed_hz;                 ///< Clock speed in Hz.
     int queue_size;                     ///< Queue size used by `spi_device_queue_trans()`.
     spi_device_handle_t device_handle;  ///< Device handle assigned by the driver. The caller must provdie this.
-    int dma_chan;                       ///< DMA channed to use. Either 1 or 2.
+    int dma_chan;                       ///< DMA channed to use. Either 1 or 2. Frames larger than
+                                        ///< 64 bytes (more than 14 LEDs) require DMA.
     spi_transaction_t transaction;      ///< SPI transaction used internally by the driver.
+    bool static_buf;                    ///< `buf` is provided by the caller, see ::led_strip_spi_init_static(). Internal.
+    color_gamma_t *lut;                 ///< Output tables set by ::led_strip_spi_set_output(), NULL if not used. Internal.
 } led_strip_spi_esp32_t;
 
 /**
@@ -69,7 +72,7 @@ typedef struct
  * `host_device`: `LED_STRIP_SPI_DEFAULT_HOST_DEVICE`,
  * `mosi_io_num`: `LED_STRIP_SPI_DEFAULT_MOSI_IO_NUM`,
  * `max_transfer_sz`: 0,
- * `clock_speed_hz`: 1000000,
+ * `clock_speed_hz`: `LED_STRIP_SPI_DEFAULT_CLOCK_HZ` of the LED type (1000000 for SK9822),
  * `queue_size`: 1,
  * `device_handle`: `NULL`,
  * `dma_chan`: 1
@@ -82,7 +85,7 @@ typedef struct
     .mosi_io_num = LED_STRIP_SPI_DEFAULT_MOSI_IO_NUM, \
     .sclk_io_num = LED_STRIP_SPI_DEFAULT_SCLK_IO_NUM, \
     .max_transfer_sz = 0,                             \
-    .clock_speed_hz = 1000000,                        \
+    .clock_speed_hz = LED_STRIP_SPI_DEFAULT_CLOCK_HZ, \
     .queue_size = 1,                                  \
     .device_handle = NULL,                            \
     .dma_chan = 1,                                    \
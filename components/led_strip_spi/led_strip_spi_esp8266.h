@@ -45,17 +45,19 @@ typedef struct
     void *buf;              ///< Pointer to the buffer.
     size_t length;          ///< Number of pixels.
     spi_clk_div_t clk_div;  ///< Value of `clk_div`, such as `SPI_2MHz_DIV`. See available values in `${IDF_PATH}/components/esp8266/include/driver/spi.h`.
+    bool static_buf;        ///< `buf` is provided by the caller, see ::led_strip_spi_init_static(). Internal.
+    color_gamma_t *lut;     ///< Output tables set by ::led_strip_spi_set_output(), NULL if not used. Internal.
 } led_strip_spi_esp8266_t;
 
 /**
  * @brief A macro to initialize led_strip_spi_esp8266_t.
  *
- * `length`: 1 `clk_div`: SPI_2MHz_DIV
+ * `length`: 1 `clk_div`: `LED_STRIP_SPI_DEFAULT_CLK_DIV` of the LED type (SPI_2MHz_DIV for SK9822)
  */
 #define LED_STRIP_SPI_DEFAULT_ESP8266() \
 { \
     .length = 1, \
-    .clk_div = SPI_2MHz_DIV, \
+    .clk_div = LED_STRIP_SPI_DEFAULT_CLK_DIV, \
 }
 
 /** @} */
@@ -22,14 +22,23 @@
  * SOFTWARE.
  */
 
+#include <sdkconfig.h>
+
+#if CONFIG_LED_STRIP_SPI_USING_SK9822
+
 #include <esp_err.h>
 #include "led_strip_spi.h"
 #include "led_strip_spi_sk9822.h"
 
 esp_err_t led_strip_spi_set_pixel_sk9822(led_strip_spi_t *strip, size_t num, rgb_t color)
+{
+    return led_strip_spi_set_pixel_brightness_sk9822(strip, num, color, LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_DEFAULT);
+}
+
+esp_err_t led_strip_spi_set_pixel_brightness_sk9822(led_strip_spi_t *strip, size_t num, rgb_t color, uint8_t brightness)
 {
     int index = (num + 1) * 4;
-    ((uint8_t *)strip->buf)[index    ] = LED_STRIP_SPI_FRAME_SK9822_LED_MSB3 + 1; // XXX FIXME brightness control
+    ((uint8_t *)strip->buf)[index    ] = LED_STRIP_SPI_FRAME_SK9822_LED_MSB3 | (brightness & LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_MAX);
     ((uint8_t *)strip->buf)[index + 1] = color.b;
     ((uint8_t *)strip->buf)[index + 2] = color.g;
     ((uint8_t *)strip->buf)[index + 3] = color.r;
@@ -44,3 +53,5 @@ esp_err_t led_strip_spi_sk9822_buf_init(led_strip_spi_t *strip)
     }
     return ESP_OK;
 }
+
+#endif
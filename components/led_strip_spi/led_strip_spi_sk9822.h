@@ -61,6 +61,8 @@ extern "C" {
 #define LED_STRIP_SPI_FRAME_SK9822_END_SIZE(N_PIXEL) ((N_PIXEL / 16) + 1) ///< The size in bytes of the last frame. `N_PIXEL` is the number of pixels in the strip.
 
 #define LED_STRIP_SPI_FRAME_SK9822_LED_MSB3    (0xE0)   ///< A magic number of [31:29] in LED frames. The bits must be 1 (APA102, SK9822)
+#define LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_MAX (0x1F) ///< Maximum value of 5-bit global brightness in [28:24] of LED frames
+#define LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_DEFAULT (1) ///< Global brightness used by led_strip_spi_set_pixel_sk9822()
 
 #define LED_STRIP_SPI_BUFFER_SIZE(N_PIXEL) (\
         LED_STRIP_SPI_FRAME_SK9822_START_SIZE + \
@@ -68,6 +70,9 @@ extern "C" {
         LED_STRIP_SPI_FRAME_SK9822_RESET_SIZE + \
         LED_STRIP_SPI_FRAME_SK9822_END_SIZE(N_PIXEL)) ///< A macro to caliculate required size of buffer. `N_PIXEL` is the number of pixels in the strip.
 
+#define LED_STRIP_SPI_DEFAULT_CLOCK_HZ   (1000000)      ///< Default SPI clock of ESP32 for the LED type
+#define LED_STRIP_SPI_DEFAULT_CLK_DIV    SPI_2MHz_DIV   ///< Default SPI clock divider of ESP8266 for the LED type
+
 /**
  * @brief Initialize the buffer of SK9822 strip.
  * @param[in] strip LED strip descriptor to initialize
@@ -77,6 +82,11 @@ esp_err_t led_strip_spi_sk9822_buf_init(led_strip_spi_t *strip);
 
 /**
  * @brief Set color of a pixel of SK9822 strip.
+ *
+ * Global brightness of the pixel is set to
+ * `LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_DEFAULT`, use
+ * led_strip_spi_set_pixel_brightness_sk9822() to set it explicitly.
+ *
  * @param[in] strip LED strip descriptor.
  * @param[in] num Index of the LED pixel (zero-based).
  * @param[in] color The color to set.
@@ -84,6 +94,21 @@ esp_err_t led_strip_spi_sk9822_buf_init(led_strip_spi_t *strip);
  */
 esp_err_t led_strip_spi_set_pixel_sk9822(led_strip_spi_t *strip, size_t num, rgb_t color);
 
+/**
+ * @brief Set color and 5-bit global brightness of a pixel of SK9822 strip.
+ *
+ * Global brightness is applied by the LED driver itself (SK9822 scales
+ * the constant current, APA102 applies slow PWM), so dim pixels keep
+ * full 8-bit color resolution.
+ *
+ * @param[in] strip LED strip descriptor.
+ * @param[in] num Index of the LED pixel (zero-based).
+ * @param[in] color The color to set.
+ * @param[in] brightness Global brightness, 0..`LED_STRIP_SPI_FRAME_SK9822_LED_BRIGHTNESS_MAX`.
+ * @return `ESP_OK` on success.
+ */
+esp_err_t led_strip_spi_set_pixel_brightness_sk9822(led_strip_spi_t *strip, size_t num, rgb_t color, uint8_t brightness);
+
 #ifdef __cplusplus
 }
 #endif
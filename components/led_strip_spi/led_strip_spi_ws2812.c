@@ -0,0 +1,80 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *               2021 Tomoyuki Sakurai <y@rombik.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sdkconfig.h>
+
+#if CONFIG_LED_STRIP_SPI_USING_WS2812
+
+#include <esp_err.h>
+#include <esp_attr.h>
+#include "led_strip_spi.h"
+#include "led_strip_spi_ws2812.h"
+
+/* symbols of a data byte in memory order, SPI sends the lowest address first */
+static DRAM_ATTR uint32_t symbols[256];
+static bool symbols_ready = false;
+
+static void init_symbols()
+{
+    for (int d = 0; d < 256; d++) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; i++) {
+            /* two data bits per byte, MSB first */
+            uint8_t b = ((d << (2 * i)) & 0x80 ? 0xc0 : 0x80) | ((d << (2 * i)) & 0x40 ? 0x0c : 0x08);
+            v |= (uint32_t)b << (8 * i);
+        }
+        symbols[d] = v;
+    }
+    symbols_ready = true;
+}
+
+esp_err_t led_strip_spi_set_pixel_ws2812(led_strip_spi_t *strip, size_t num, rgb_t color)
+{
+    if (num >= strip->length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    /* start frame keeps LED frames 32-bit aligned */
+    uint32_t *frame = (uint32_t *)((uint8_t *)strip->buf + LED_STRIP_SPI_FRAME_WS2812_START_SIZE +
+                                   num * LED_STRIP_SPI_FRAME_WS2812_LED_SIZE);
+    frame[0] = symbols[color.g];
+    frame[1] = symbols[color.r];
+    frame[2] = symbols[color.b];
+    return ESP_OK;
+}
+
+esp_err_t led_strip_spi_ws2812_buf_init(led_strip_spi_t *strip)
+{
+    if (!symbols_ready) {
+        init_symbols();
+    }
+    /* zero bytes are not black, every LED frame needs symbols of 0 */
+    rgb_t black = { 0 };
+    for (size_t i = 0; i < strip->length; i++) {
+        led_strip_spi_set_pixel_ws2812(strip, i, black);
+    }
+    return ESP_OK;
+}
+
+#endif
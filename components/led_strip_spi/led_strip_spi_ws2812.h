@@ -0,0 +1,110 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *               2021 Tomoyuki Sakurai <y@rombik.org>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file led_strip_spi_ws2812.h
+ * @defgroup led_strip_spi_ws2812 led_strip_spi_ws2812
+ * @{
+ *
+ * Functions and macros for WS2812 LED strips driven by SPI MOSI.
+ *
+ * WS2812 has a single data line with pulse-width coded bits. Every data
+ * bit is sent as a 4-bit SPI symbol at 3.2 MHz, 312.5 ns per SPI bit:
+ *
+ * - `1000` for 0 (312.5 ns high, 937.5 ns low)
+ * - `1100` for 1 (625 ns high, 625 ns low)
+ *
+ * so a data byte takes 4 bytes of the buffer. Symbols are looked up in
+ * a 256-entry table built once by led_strip_spi_ws2812_buf_init().
+ *
+ * SPI data frame consists of:
+ *
+ * - A start frame of zero bytes, so the line is low before the first bit.
+ * - 12 byte LED frames for each LED in the string, green, red and blue
+ *   in this order.
+ * - A reset frame of zero bytes, 300 us of low level at 3.2 MHz, which
+ *   latches the data in both old and new (WS2812B-V5) LEDs.
+ *
+ * SPI clock must be `LED_STRIP_SPI_WS2812_CLOCK_HZ`, it is the default of
+ * `LED_STRIP_SPI_DEFAULT()`.
+ *
+ * @note On ESP8266 the frame is sent in 64-byte transactions and the line
+ *       stays low between them. When the gap exceeds the reset time of the
+ *       LEDs (e.g. flushing task is preempted), the LEDs latch a partial
+ *       frame and the rest of it is shown from the first LED again. WS2812
+ *       strips are reliable on ESP32 family chips only, where the frame is
+ *       sent in one transaction.
+ */
+#if !defined(__LED_STRIP_SPI_WS2812_H__)
+#define __LED_STRIP_SPI_WS2812_H__
+
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LED_STRIP_SPI_WS2812_CLOCK_HZ          (3200000) ///< SPI clock of 4-bit symbols, Hz
+#define LED_STRIP_SPI_WS2812_CLK_DIV           (25)     ///< ESP8266 SPI clock divider of 80 MHz for `LED_STRIP_SPI_WS2812_CLOCK_HZ`
+
+#define LED_STRIP_SPI_FRAME_WS2812_START_SIZE  (4)      ///< The size in bytes of start frame.
+#define LED_STRIP_SPI_FRAME_WS2812_LED_SIZE    (12)     ///< The size in bytes of each LED frame.
+#define LED_STRIP_SPI_FRAME_WS2812_LEDS_SIZE(N_PIXEL) (LED_STRIP_SPI_FRAME_WS2812_LED_SIZE * (N_PIXEL)) ///< Total size in bytes of all LED frames in a strip. `N_PIXEL` is the number of pixels in the strip.
+#define LED_STRIP_SPI_FRAME_WS2812_RESET_SIZE  (120)    ///< The size in bytes of reset frame, 300 us at 3.2 MHz.
+
+#define LED_STRIP_SPI_BUFFER_SIZE(N_PIXEL) (\
+        LED_STRIP_SPI_FRAME_WS2812_START_SIZE + \
+        LED_STRIP_SPI_FRAME_WS2812_LEDS_SIZE(N_PIXEL) + \
+        LED_STRIP_SPI_FRAME_WS2812_RESET_SIZE) ///< A macro to caliculate required size of buffer. `N_PIXEL` is the number of pixels in the strip.
+
+#define LED_STRIP_SPI_DEFAULT_CLOCK_HZ   LED_STRIP_SPI_WS2812_CLOCK_HZ ///< Default SPI clock of ESP32 for the LED type
+#define LED_STRIP_SPI_DEFAULT_CLK_DIV    ((spi_clk_div_t)LED_STRIP_SPI_WS2812_CLK_DIV) ///< Default SPI clock divider of ESP8266 for the LED type
+
+/**
+ * @brief Initialize the buffer of WS2812 strip.
+ *
+ * Builds the symbol table on the first call and sets all LEDs to black.
+ *
+ * @param[in] strip LED strip descriptor to initialize
+ * @return `ESP_OK` on success
+ */
+esp_err_t led_strip_spi_ws2812_buf_init(led_strip_spi_t *strip);
+
+/**
+ * @brief Set color of a pixel of WS2812 strip.
+ * @param[in] strip LED strip descriptor.
+ * @param[in] num Index of the LED pixel (zero-based).
+ * @param[in] color The color to set.
+ * @return `ESP_OK` on success.
+ */
+esp_err_t led_strip_spi_set_pixel_ws2812(led_strip_spi_t *strip, size_t num, rgb_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif
@@ -99,6 +99,34 @@ LIB8STATIC_ALWAYS_INLINE uint8_t avg8(uint8_t i, uint8_t j)
     return (i + j) >> 1;
 }
 
+///@name Packed operations
+/// Operate on four bytes packed into a 32-bit word at once (SWAR),
+/// results are the same as of the single byte functions for every byte.
+///@{
+
+/// qadd8() of four packed bytes
+LIB8STATIC_ALWAYS_INLINE uint32_t qadd8x4(uint32_t i, uint32_t j)
+{
+    uint32_t sum = ((i & 0x7f7f7f7fUL) + (j & 0x7f7f7f7fUL)) ^ ((i ^ j) & 0x80808080UL);
+    uint32_t carry = ((i & j) | ((i | j) & ~sum)) & 0x80808080UL;
+    return sum | ((carry >> 7) * 0xff);
+}
+
+/// qsub8() of four packed bytes
+LIB8STATIC_ALWAYS_INLINE uint32_t qsub8x4(uint32_t i, uint32_t j)
+{
+    uint32_t diff = ((i | 0x80808080UL) - (j & 0x7f7f7f7fUL)) ^ ((i ^ ~j) & 0x80808080UL);
+    uint32_t borrow = ((~i & j) | (~(i ^ j) & diff)) & 0x80808080UL;
+    return diff & ~((borrow >> 7) * 0xff);
+}
+
+/// avg8() of four packed bytes
+LIB8STATIC_ALWAYS_INLINE uint32_t avg8x4(uint32_t i, uint32_t j)
+{
+    return (i & j) + (((i ^ j) & 0xfefefefeUL) >> 1);
+}
+///@}
+
 /// Calculate an integer average of two unsigned
 ///       16-bit integer values (uint16_t).
 ///       Fractional results are rounded down, e.g. avg16(20,41) = 30
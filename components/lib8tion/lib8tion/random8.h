@@ -113,6 +113,40 @@ LIB8STATIC void random16_add_entropy(uint16_t entropy)
     rand16seed += entropy;
 }
 
+// Marsaglia's xorshift32, period 2^32 - 1, state must not be zero
+#define RAND32_SEED     2463534242UL
+#define XORSHIFT32(x)   ((x) ^= (x) << 13, (x) ^= (x) >> 17, (x) ^= (x) << 5, (x))
+
+/// 32-bit random number seed, never zero
+extern uint32_t rand32seed; // = RAND32_SEED;
+
+/// Generate a 32 bit random number. Uses separate xorshift32 generator with
+/// only shifts and xors, which gives 4 random bytes per step and has better
+/// statistical properties than random16().
+LIB8STATIC uint32_t random32()
+{
+    uint32_t x = rand32seed;
+    rand32seed = XORSHIFT32(x);
+    return rand32seed;
+}
+
+/// Set the seed of random32() and fill functions, zero is replaced by default seed
+LIB8STATIC void random32_set_seed(uint32_t seed)
+{
+    rand32seed = seed ? seed : RAND32_SEED;
+}
+
+/// Fill buffer with random bytes, much faster than calling random8() for every byte.
+/// Uses random32() generator.
+/// @param buf buffer to fill
+/// @param n number of bytes
+void random8_fill(uint8_t *buf, size_t n);
+
+/// Fill buffer with 16-bit random numbers. Uses random32() generator.
+/// @param buf buffer to fill
+/// @param n number of values
+void random16_fill(uint16_t *buf, size_t n);
+
 ///@}
 
 #endif
@@ -109,6 +109,15 @@ LIB8STATIC void nscale8x2_video(uint8_t *i, uint8_t *j, fract8 scale)
     *j = (*j == 0) ? 0 : (((int) *j * (int) (scale)) >> 8) + nonzeroscale;
 }
 
+/// scale8() of four bytes packed into a 32-bit word. Even and odd bytes
+///         are multiplied in separate 16-bit lanes, so no carries cross
+///         byte boundaries
+LIB8STATIC_ALWAYS_INLINE uint32_t scale8x4(uint32_t i, fract8 scale)
+{
+    uint32_t k = (uint32_t)scale + 1;
+    return (((i & 0x00ff00ffUL) * k >> 8) & 0x00ff00ffUL) | (((i >> 8) & 0x00ff00ffUL) * k & 0xff00ff00UL);
+}
+
 /// scale a 16-bit unsigned value by an 8-bit value,
 ///         considered as numerator of a fraction whose denominator
 ///         is 256. In other words, it computes i * (scale / 256)
@@ -150,5 +150,64 @@ LIB8STATIC uint8_t cos8(uint8_t theta)
     return sin8(theta + 64);
 }
 
+///////////////////////////////////////////////////////////////////////
+// Table based sin & cos
+//        Quarter-wave lookup tables, no multiplications. Tables are
+//        constant and stay in flash: 65 bytes for 8-bit and 2050 bytes
+//        for 16-bit functions.
+
+/// Quarter-wave table of sin8_lut(), round(127 * sin(i * pi / 128))
+extern const uint8_t sin8_quarter[65];
+/// Quarter-wave table of sin16_lut(), round(32767 * sin(i * pi / 2048))
+extern const int16_t sin16_quarter[1025];
+
+/// Table based version of sin8(), exact to rounding
+///
+///     float s = (sin(x) * 127.0) + 128;
+///
+/// @param theta input angle from 0-255
+/// @returns sin of theta, value between 1 and 255
+LIB8STATIC uint8_t sin8_lut(uint8_t theta)
+{
+    uint8_t i = theta & 0x3F;
+    if (theta & 0x40)
+        i = 64 - i;
+    uint8_t y = sin8_quarter[i];
+    return theta & 0x80 ? 128 - y : 128 + y;
+}
+
+/// Table based version of cos8()
+///
+/// @param theta input angle from 0-255
+/// @returns cos of theta, value between 1 and 255
+LIB8STATIC uint8_t cos8_lut(uint8_t theta)
+{
+    return sin8_lut(theta + 64);
+}
+
+/// Table based version of sin16(), never varies more than 0.08% from
+///
+///     float s = sin(x) * 32767.0;
+///
+/// @param theta input angle from 0-65535
+/// @returns sin of theta, value between -32767 to 32767.
+LIB8STATIC int16_t sin16_lut(uint16_t theta)
+{
+    uint16_t q = theta & 0x3FFF;
+    if (theta & 0x4000)
+        q = 0x4000 - q;
+    int16_t y = sin16_quarter[(q + 8) >> 4];
+    return theta & 0x8000 ? -y : y;
+}
+
+/// Table based version of cos16()
+///
+/// @param theta input angle from 0-65535
+/// @returns cos of theta, value between -32767 to 32767.
+LIB8STATIC int16_t cos16_lut(uint16_t theta)
+{
+    return sin16_lut(theta + 16384);
+}
+
 ///@}
 #endif
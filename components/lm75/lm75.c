@@ -84,9 +84,9 @@ static esp_err_t write_register8(i2c_dev_t *dev, uint8_t reg, uint8_t value)
     return i2c_dev_write_reg(dev, reg, &value, 1);
 }
 
-esp_err_t lm75_read_temperature(i2c_dev_t *dev, float *value)
+// 11-bit two's complement in 0.125 deg.C units
+static esp_err_t read_temperature_raw(i2c_dev_t *dev, int16_t *raw)
 {
-    CHECK_ARG(dev);
     uint16_t raw_data;
 
     I2C_DEV_TAKE_MUTEX(dev);
@@ -94,7 +94,28 @@ esp_err_t lm75_read_temperature(i2c_dev_t *dev, float *value)
             "lm75_read_temperature(): read_register16() failed: register: 0x%x", LM75_REG_TEMP);
     I2C_DEV_GIVE_MUTEX(dev);
 
-    *value = (raw_data >> 5) * 0.125;
+    // left aligned
+    *raw = (int16_t)raw_data >> 5;
+    return ESP_OK;
+}
+
+esp_err_t lm75_read_temperature(i2c_dev_t *dev, float *value)
+{
+    CHECK_ARG(dev && value);
+    int16_t raw;
+
+    CHECK(read_temperature_raw(dev, &raw));
+    *value = raw * 0.125;
+    return ESP_OK;
+}
+
+esp_err_t lm75_read_temperature_fixed(i2c_dev_t *dev, int16_t *value)
+{
+    CHECK_ARG(dev && value);
+    int16_t raw;
+
+    CHECK(read_temperature_raw(dev, &raw));
+    *value = raw * 25 / 2;
     return ESP_OK;
 }
 
@@ -148,6 +148,14 @@ esp_err_t lm75_get_os_threshold(i2c_dev_t *dev, float *value);
  */
 esp_err_t lm75_read_temperature(i2c_dev_t *dev, float *value);
 
+/**
+ * @brief Read the temperature without floating point operations
+ * @param[in] dev pointer to LM75 device descriptor
+ * @param[out] value temperature in 0.01 deg.C
+ * @return `ESP_OK` on success
+ */
+esp_err_t lm75_read_temperature_fixed(i2c_dev_t *dev, int16_t *value);
+
 /**
  * @brief Set OS mode
  * @param[in] dev pointer to LM75 device descriptor
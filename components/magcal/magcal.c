@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file magcal.c
+ *
+ * Incremental hard-iron and soft-iron calibration of 3-axis magnetometers
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include "magcal.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static void set_identity(magcal_t *cal)
+{
+    memset(cal->matrix, 0, sizeof(cal->matrix));
+    for (int i = 0; i < 3; i++)
+        cal->matrix[i][i] = MAGCAL_ONE;
+}
+
+static void recalc(magcal_t *cal)
+{
+    const int16_t *min = &cal->min.x;
+    const int16_t *max = &cal->max.x;
+    int32_t span[3];
+    int32_t avg = 0;
+
+    for (int i = 0; i < 3; i++)
+    {
+        cal->offset[i] = ((int32_t)max[i] + min[i]) / 2;
+        span[i] = (int32_t)max[i] - min[i];
+        avg += span[i];
+    }
+    avg /= 3;
+
+    set_identity(cal);
+    for (int i = 0; i < 3; i++)
+        cal->matrix[i][i] = (avg * MAGCAL_ONE + span[i] / 2) / span[i];
+}
+
+static inline int16_t clamp16(int64_t v)
+{
+    return v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : (int16_t)v);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t magcal_init(magcal_t *cal, uint16_t min_span)
+{
+    CHECK_ARG(cal && min_span);
+
+    cal->min.x = cal->min.y = cal->min.z = INT16_MAX;
+    cal->max.x = cal->max.y = cal->max.z = INT16_MIN;
+    cal->min_span = min_span;
+    cal->locked = false;
+    cal->samples = 0;
+    memset(cal->offset, 0, sizeof(cal->offset));
+    set_identity(cal);
+
+    return ESP_OK;
+}
+
+esp_err_t magcal_update(magcal_t *cal, const magcal_vec_t *raw, bool *updated)
+{
+    CHECK_ARG(cal && raw);
+
+    if (updated)
+        *updated = false;
+    if (cal->locked)
+        return ESP_OK;
+
+    cal->samples++;
+
+    const int16_t *v = &raw->x;
+    int16_t *min = &cal->min.x;
+    int16_t *max = &cal->max.x;
+    bool changed = false;
+    for (int i = 0; i < 3; i++)
+    {
+        if (v[i] < min[i])
+        {
+            min[i] = v[i];
+            changed = true;
+        }
+        if (v[i] > max[i])
+        {
+            max[i] = v[i];
+            changed = true;
+        }
+    }
+
+    if (!changed || !magcal_is_valid(cal))
+        return ESP_OK;
+
+    recalc(cal);
+    if (updated)
+        *updated = true;
+
+    return ESP_OK;
+}
+
+esp_err_t magcal_apply(const magcal_t *cal, const magcal_vec_t *raw, magcal_vec_t *out)
+{
+    CHECK_ARG(cal && raw && out);
+
+    int32_t d[3] = {
+        (int32_t)raw->x - cal->offset[0],
+        (int32_t)raw->y - cal->offset[1],
+        (int32_t)raw->z - cal->offset[2],
+    };
+    int16_t *o = &out->x;
+
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t acc = (int64_t)cal->matrix[i][0] * d[0]
+                    + (int64_t)cal->matrix[i][1] * d[1]
+                    + (int64_t)cal->matrix[i][2] * d[2];
+        // round to nearest
+        o[i] = clamp16((acc + MAGCAL_ONE / 2) >> 14);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t magcal_set(magcal_t *cal, const int16_t offset[3], const int32_t matrix[3][3])
+{
+    CHECK_ARG(cal && offset);
+
+    memcpy(cal->offset, offset, sizeof(cal->offset));
+    if (matrix)
+        memcpy(cal->matrix, matrix, sizeof(cal->matrix));
+    else
+        set_identity(cal);
+    cal->locked = true;
+
+    return ESP_OK;
+}
+
+esp_err_t magcal_lock(magcal_t *cal, bool lock)
+{
+    CHECK_ARG(cal);
+
+    cal->locked = lock;
+
+    return ESP_OK;
+}
+
+bool magcal_is_valid(const magcal_t *cal)
+{
+    if (!cal)
+        return false;
+
+    return (int32_t)cal->max.x - cal->min.x >= cal->min_span
+        && (int32_t)cal->max.y - cal->min.y >= cal->min_span
+        && (int32_t)cal->max.z - cal->min.z >= cal->min_span;
+}
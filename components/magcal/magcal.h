@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file magcal.h
+ * @defgroup magcal magcal
+ * @{
+ *
+ * Incremental hard-iron and soft-iron calibration of 3-axis magnetometers
+ *
+ * Raw samples are used to track minimum and maximum of each axis. Hard-iron
+ * offset is the center of the min/max box, soft-iron correction is a
+ * diagonal matrix scaling each axis to the mean radius. A full 3x3 matrix
+ * obtained by offline ellipsoid fit can be set with ::magcal_set().
+ * Correction is applied in fixed point, no floating point math is used.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __MAGCAL_H__
+#define __MAGCAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAGCAL_ONE (1 << 14) //!< 1.0 in soft-iron matrix fixed point format (Q14)
+
+/**
+ * 3-axis vector.
+ * Layout compatible with `hmc5883l_raw_data_t` and `qmc5883l_raw_data_t`.
+ */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} magcal_vec_t;
+
+/**
+ * Calibration state
+ */
+typedef struct
+{
+    magcal_vec_t min;       //!< Minimal values seen
+    magcal_vec_t max;       //!< Maximal values seen
+    uint16_t min_span;      //!< Minimal max - min of each axis for valid calibration
+    bool locked;            //!< Calibration is fixed, samples are not tracked
+    uint32_t samples;       //!< Number of consumed samples
+    int16_t offset[3];      //!< Hard-iron offset, raw units
+    int32_t matrix[3][3];   //!< Soft-iron correction matrix, Q14
+} magcal_t;
+
+/**
+ * @brief Initialize calibration state
+ *
+ * Offset is reset to zero and matrix to identity.
+ *
+ * @param cal Calibration state
+ * @param min_span Minimal span (max - min) of each axis, raw units,
+ *                 required to consider calibration valid
+ * @return `ESP_OK` on success
+ */
+esp_err_t magcal_init(magcal_t *cal, uint16_t min_span);
+
+/**
+ * @brief Consume raw sample
+ *
+ * Offset and diagonal matrix are recalculated only when sample extends
+ * the min/max box and all axes have reached `min_span`. Does nothing if
+ * calibration is locked. Do not pass overflowed samples (e.g. -4096 from
+ * HMC5883L).
+ *
+ * @param cal Calibration state
+ * @param raw Raw sample
+ * @param[out] updated true if calibration was changed, optional
+ * @return `ESP_OK` on success
+ */
+esp_err_t magcal_update(magcal_t *cal, const magcal_vec_t *raw, bool *updated);
+
+/**
+ * @brief Apply calibration to raw sample
+ *
+ * out = matrix * (raw - offset)
+ *
+ * @param cal Calibration state
+ * @param raw Raw sample
+ * @param[out] out Corrected sample, raw units. May be the same as `raw`
+ * @return `ESP_OK` on success
+ */
+esp_err_t magcal_apply(const magcal_t *cal, const magcal_vec_t *raw, magcal_vec_t *out);
+
+/**
+ * @brief Set calibration and lock it
+ *
+ * Use it to restore saved calibration or to set the result of ellipsoid fit.
+ *
+ * @param cal Calibration state
+ * @param offset Hard-iron offset, raw units
+ * @param matrix Soft-iron matrix, Q14, NULL for identity
+ * @return `ESP_OK` on success
+ */
+esp_err_t magcal_set(magcal_t *cal, const int16_t offset[3], const int32_t matrix[3][3]);
+
+/**
+ * @brief Lock or unlock calibration
+ *
+ * Locked calibration is not changed by ::magcal_update().
+ *
+ * @param cal Calibration state
+ * @param lock Lock if true
+ * @return `ESP_OK` on success
+ */
+esp_err_t magcal_lock(magcal_t *cal, bool lock);
+
+/**
+ * @brief Check if all axes have reached minimal span
+ *
+ * @param cal Calibration state
+ * @return true if calibration is valid
+ */
+bool magcal_is_valid(const magcal_t *cal);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __MAGCAL_H__ */
@@ -39,6 +39,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "max31725.h"
 
 static const char *TAG = "max31725";
@@ -91,6 +92,24 @@ static esp_err_t read_temp(i2c_dev_t *dev, uint8_t reg, float *temp, max31725_da
     return ESP_OK;
 }
 
+// 0.01 deg.C, without floating point operations
+static esp_err_t read_temp_fixed(i2c_dev_t *dev, uint8_t reg, int16_t *temp, max31725_data_format_t fmt)
+{
+    CHECK_ARG(dev && temp);
+
+    temp_data_t buf;
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_read_reg(dev, reg, &buf.udata, 2));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    buf.udata = (buf.udata << 8) | (buf.udata >> 8);
+    // LSB is 1/256 deg.C
+    *temp = (int32_t)buf.sdata * 25 / 64 + (fmt == MAX31725_FMT_EXTENDED ? (int)FMT_SHIFT * 100 : 0);
+
+    return ESP_OK;
+}
+
 static esp_err_t write_temp(i2c_dev_t *dev, uint8_t reg, float temp, max31725_data_format_t fmt)
 {
     CHECK_ARG(dev);
@@ -173,7 +192,7 @@ esp_err_t max31725_set_config(i2c_dev_t *dev, max31725_mode_t mode, max31725_dat
     return ESP_OK;
 }
 
-esp_err_t max31725_one_shot(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt)
+static esp_err_t one_shot(i2c_dev_t *dev)
 {
     CHECK_ARG(dev);
 
@@ -186,16 +205,33 @@ esp_err_t max31725_one_shot(i2c_dev_t *dev, float *temp, max31725_data_format_t
     I2C_DEV_GIVE_MUTEX(dev);
 
     // wait 50 ms
-    vTaskDelay(pdMS_TO_TICKS(CONV_TIME_MS));
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(CONV_TIME_MS));
 
+    return ESP_OK;
+}
+
+esp_err_t max31725_one_shot(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt)
+{
+    CHECK(one_shot(dev));
     return read_temp(dev, REG_TEMP, temp, fmt);
 }
 
+esp_err_t max31725_one_shot_fixed(i2c_dev_t *dev, int16_t *temp, max31725_data_format_t fmt)
+{
+    CHECK(one_shot(dev));
+    return read_temp_fixed(dev, REG_TEMP, temp, fmt);
+}
+
 esp_err_t max31725_get_temperature(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt)
 {
     return read_temp(dev, REG_TEMP, temp, fmt);
 }
 
+esp_err_t max31725_get_temperature_fixed(i2c_dev_t *dev, int16_t *temp, max31725_data_format_t fmt)
+{
+    return read_temp_fixed(dev, REG_TEMP, temp, fmt);
+}
+
 esp_err_t max31725_get_os_temp(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt)
 {
     return read_temp(dev, REG_OS, temp, fmt);
@@ -152,6 +152,18 @@ esp_err_t max31725_set_config(i2c_dev_t *dev, max31725_mode_t mode, max31725_dat
  */
 esp_err_t max31725_one_shot(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt);
 
+/**
+ * @brief Made a single-shot measurement without floating point operations
+ *
+ * Same as ::max31725_one_shot().
+ *
+ * @param dev Device descriptor
+ * @param[out] temp Temperature, 0.01 deg.C
+ * @param fmt Data format
+ * @return `ESP_OK` on success
+ */
+esp_err_t max31725_one_shot_fixed(i2c_dev_t *dev, int16_t *temp, max31725_data_format_t fmt);
+
 /**
  * @brief Read temperature register
  *
@@ -162,6 +174,16 @@ esp_err_t max31725_one_shot(i2c_dev_t *dev, float *temp, max31725_data_format_t
  */
 esp_err_t max31725_get_temperature(i2c_dev_t *dev, float *temp, max31725_data_format_t fmt);
 
+/**
+ * @brief Read temperature register without floating point operations
+ *
+ * @param dev Device descriptor
+ * @param[out] temp Temperature, 0.01 deg.C
+ * @param fmt Data format
+ * @return `ESP_OK` on success
+ */
+esp_err_t max31725_get_temperature_fixed(i2c_dev_t *dev, int16_t *temp, max31725_data_format_t fmt);
+
 /**
  * @brief Read OS threshold temperature
  *
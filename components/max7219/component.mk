@@ -1,2 +1,2 @@
 COMPONENT_ADD_INCLUDEDIRS = .
-COMPONENT_DEPENDS = driver log
+COMPONENT_DEPENDS = driver log esp_idf_lib_helpers
@@ -40,6 +40,7 @@
 #include "max7219.h"
 #include <string.h>
 #include <esp_log.h>
+#include <esp_idf_lib_trace.h>
 
 #include "max7219_priv.h"
 
@@ -68,9 +69,62 @@ static inline uint16_t shuffle(uint16_t val)
     return (val >> 8) | (val << 8);
 }
 
+// Wait for all queued transactions
+static esp_err_t wait_all(max7219_t *dev)
+{
+    if (!dev->in_flight)
+        return ESP_OK;
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, dev->in_flight * dev->cascade_size * 16);
+    esp_err_t res = ESP_OK;
+    while (dev->in_flight && res == ESP_OK)
+    {
+        spi_transaction_t *t;
+        res = spi_device_get_trans_result(dev->spi_dev, &t, portMAX_DELAY);
+        if (res == ESP_OK)
+            dev->in_flight--;
+    }
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+
+    return res;
+}
+
+// Get next free transaction buffer, cleared
+static esp_err_t next_slot(max7219_t *dev, uint16_t **buf)
+{
+    if (dev->in_flight == MAX7219_QUEUE_SIZE)
+    {
+        // slots are used in a ring, the oldest one is ours
+        spi_transaction_t *t;
+        CHECK(spi_device_get_trans_result(dev->spi_dev, &t, portMAX_DELAY));
+        dev->in_flight--;
+    }
+
+    *buf = dev->tx[dev->head];
+    memset(*buf, 0, sizeof(dev->tx[0]));
+
+    return ESP_OK;
+}
+
+// Queue transaction buffer returned by next_slot()
+static esp_err_t queue_slot(max7219_t *dev)
+{
+    spi_transaction_t *t = &dev->trans[dev->head];
+    memset(t, 0, sizeof(spi_transaction_t));
+    t->length = dev->cascade_size * 16;
+    t->tx_buffer = dev->tx[dev->head];
+    CHECK(spi_device_queue_trans(dev->spi_dev, t, portMAX_DELAY));
+
+    dev->in_flight++;
+    dev->head = (dev->head + 1) % MAX7219_QUEUE_SIZE;
+
+    return ESP_OK;
+}
+
 static esp_err_t send(max7219_t *dev, uint8_t chip, uint16_t value)
 {
-    uint16_t buf[MAX7219_MAX_CASCADE_SIZE] = { 0 };
+    uint16_t *buf;
+    CHECK(next_slot(dev, &buf));
     if (chip == ALL_CHIPS)
     {
         for (uint8_t i = 0; i < dev->cascade_size; i++)
@@ -78,11 +132,40 @@ static esp_err_t send(max7219_t *dev, uint8_t chip, uint16_t value)
     }
     else buf[chip] = shuffle(value);
 
-    spi_transaction_t t;
-    memset(&t, 0, sizeof(t));
-    t.length = dev->cascade_size * 16;
-    t.tx_buffer = buf;
-    return spi_device_transmit(dev->spi_dev, &t);
+    return queue_slot(dev);
+}
+
+// Queue digit `digit` of every chip marked in `mask` from framebuffer
+static esp_err_t send_row(max7219_t *dev, uint8_t digit, uint32_t mask)
+{
+    uint16_t *buf;
+    CHECK(next_slot(dev, &buf));
+    for (uint8_t i = 0; i < dev->cascade_size; i++)
+        if (mask & BIT(i))
+            buf[i] = shuffle((REG_DIGIT_0 + ((uint16_t)digit << 8)) | dev->fb[i * ALL_DIGITS + digit]);
+    CHECK(queue_slot(dev));
+
+    for (uint8_t i = 0; i < dev->cascade_size; i++)
+        if (mask & BIT(i))
+            dev->shadow[i * ALL_DIGITS + digit] = dev->fb[i * ALL_DIGITS + digit];
+
+    return ESP_OK;
+}
+
+// Queue changed rows
+static esp_err_t queue_changes(max7219_t *dev)
+{
+    for (uint8_t d = 0; d < ALL_DIGITS; d++)
+    {
+        uint32_t mask = 0;
+        for (uint8_t i = 0; i < dev->cascade_size; i++)
+            if (dev->fb[i * ALL_DIGITS + d] != dev->shadow[i * ALL_DIGITS + d])
+                mask |= BIT(i);
+        if (mask)
+            CHECK(send_row(dev, d, mask));
+    }
+
+    return ESP_OK;
 }
 
 inline static uint8_t get_char(max7219_t *dev, char c)
@@ -121,10 +204,12 @@ esp_err_t max7219_init_desc(max7219_t *dev, spi_host_device_t host, gpio_num_t c
     CHECK_ARG(dev);
 
     memset(&dev->spi_cfg, 0, sizeof(dev->spi_cfg));
+    dev->head = 0;
+    dev->in_flight = 0;
     dev->spi_cfg.spics_io_num = cs_pin;
     dev->spi_cfg.clock_speed_hz = CLOCK_SPEED_HZ;
     dev->spi_cfg.mode = 0;
-    dev->spi_cfg.queue_size = 1;
+    dev->spi_cfg.queue_size = MAX7219_QUEUE_SIZE;
     dev->spi_cfg.flags = SPI_DEVICE_NO_DUMMY;
 
     return spi_bus_add_device(host, &dev->spi_cfg, &dev->spi_dev);
@@ -134,6 +219,8 @@ esp_err_t max7219_free_desc(max7219_t *dev)
 {
     CHECK_ARG(dev);
 
+    CHECK(wait_all(dev));
+
     return spi_bus_remove_device(dev->spi_dev);
 }
 
@@ -168,7 +255,7 @@ esp_err_t max7219_init(max7219_t *dev)
     // Wake up
     CHECK(max7219_set_shutdown_mode(dev, false));
 
-    return ESP_OK;
+    return wait_all(dev);
 }
 
 esp_err_t max7219_set_decode_mode(max7219_t *dev, bool bcd)
@@ -178,6 +265,8 @@ esp_err_t max7219_set_decode_mode(max7219_t *dev, bool bcd)
     dev->bcd = bcd;
     CHECK(send(dev, ALL_CHIPS, REG_DECODE_MODE | (bcd ? 0xff : 0)));
     CHECK(max7219_clear(dev));
+    if (dev->buffered)
+        CHECK(max7219_flush(dev));
 
     return ESP_OK;
 }
@@ -189,7 +278,7 @@ esp_err_t max7219_set_brightness(max7219_t *dev, uint8_t value)
 
     CHECK(send(dev, ALL_CHIPS, REG_INTENSITY | value));
 
-    return ESP_OK;
+    return wait_all(dev);
 }
 
 esp_err_t max7219_set_shutdown_mode(max7219_t *dev, bool shutdown)
@@ -198,7 +287,7 @@ esp_err_t max7219_set_shutdown_mode(max7219_t *dev, bool shutdown)
 
     CHECK(send(dev, ALL_CHIPS, REG_SHUTDOWN | !shutdown));
 
-    return ESP_OK;
+    return wait_all(dev);
 }
 
 esp_err_t max7219_set_digit(max7219_t *dev, uint8_t digit, uint8_t val)
@@ -216,11 +305,15 @@ esp_err_t max7219_set_digit(max7219_t *dev, uint8_t digit, uint8_t val)
     uint8_t c = digit / ALL_DIGITS;
     uint8_t d = digit % ALL_DIGITS;
 
+    dev->fb[digit] = val;
+    if (dev->buffered)
+        return ESP_OK;
+
     ESP_LOGV(TAG, "Chip %d, digit %d val 0x%02x", c, d, val);
 
-    CHECK(send(dev, c, (REG_DIGIT_0 + ((uint16_t)d << 8)) | val));
+    CHECK(send_row(dev, d, BIT(c)));
 
-    return ESP_OK;
+    return wait_all(dev);
 }
 
 esp_err_t max7219_clear(max7219_t *dev)
@@ -228,17 +321,25 @@ esp_err_t max7219_clear(max7219_t *dev)
     CHECK_ARG(dev);
 
     uint8_t val = dev->bcd ? VAL_CLEAR_BCD : VAL_CLEAR_NORMAL;
+    memset(dev->fb, val, sizeof(dev->fb));
+    if (dev->buffered)
+        return ESP_OK;
+
+    // all rows are queued at once
     for (uint8_t i = 0; i < ALL_DIGITS; i++)
         CHECK(send(dev, ALL_CHIPS, (REG_DIGIT_0 + ((uint16_t)i << 8)) | val));
+    memset(dev->shadow, val, sizeof(dev->shadow));
 
-    return ESP_OK;
+    return wait_all(dev);
 }
 
 esp_err_t max7219_draw_text_7seg(max7219_t *dev, uint8_t pos, const char *s)
 {
     CHECK_ARG(dev && s);
 
-    while (s && pos < dev->digits)
+    bool buffered = dev->buffered;
+    dev->buffered = true;
+    while (*s && pos < dev->digits)
     {
         uint8_t c = get_char(dev, *s);
         if (*(s + 1) == '.')
@@ -246,20 +347,83 @@ esp_err_t max7219_draw_text_7seg(max7219_t *dev, uint8_t pos, const char *s)
             c |= 0x80;
             s++;
         }
-        CHECK(max7219_set_digit(dev, pos, c));
+        max7219_set_digit(dev, pos, c);
         pos++;
         s++;
     }
+    dev->buffered = buffered;
 
-    return ESP_OK;
+    return buffered ? ESP_OK : max7219_flush(dev);
 }
 
 esp_err_t max7219_draw_image_8x8(max7219_t *dev, uint8_t pos, const void *image)
 {
     CHECK_ARG(dev && image);
 
+    bool buffered = dev->buffered;
+    dev->buffered = true;
     for (uint8_t i = pos, offs = 0; i < dev->digits && offs < 8; i++, offs++)
         max7219_set_digit(dev, i, *((uint8_t *)image + offs));
+    dev->buffered = buffered;
+
+    return buffered ? ESP_OK : max7219_flush(dev);
+}
+
+esp_err_t max7219_draw_columns(max7219_t *dev, const uint8_t *columns, size_t num)
+{
+    CHECK_ARG(dev && (columns || !num));
+
+    bool buffered = dev->buffered;
+    dev->buffered = true;
+    for (uint8_t pos = 0; pos + ALL_DIGITS <= dev->digits; pos += ALL_DIGITS)
+    {
+        // transpose 8 columns into 8 rows, bit 0 of row is the left column
+        uint8_t rows[ALL_DIGITS] = { 0 };
+        for (uint8_t x = 0; x < ALL_DIGITS && pos + x < num; x++)
+        {
+            uint8_t col = columns[pos + x];
+            for (uint8_t y = 0; col; y++, col >>= 1)
+                if (col & 1)
+                    rows[y] |= BIT(x);
+        }
+        for (uint8_t y = 0; y < ALL_DIGITS; y++)
+            max7219_set_digit(dev, pos + y, rows[y]);
+    }
+    dev->buffered = buffered;
+
+    return buffered ? ESP_OK : max7219_flush(dev);
+}
+
+esp_err_t max7219_set_buffered(max7219_t *dev, bool buffered)
+{
+    CHECK_ARG(dev);
+
+    dev->buffered = buffered;
+    if (!buffered)
+        CHECK(max7219_flush(dev));
 
     return ESP_OK;
 }
+
+esp_err_t max7219_flush(max7219_t *dev)
+{
+    CHECK_ARG(dev);
+
+    CHECK(queue_changes(dev));
+
+    return wait_all(dev);
+}
+
+esp_err_t max7219_flush_async(max7219_t *dev)
+{
+    CHECK_ARG(dev);
+
+    return queue_changes(dev);
+}
+
+esp_err_t max7219_wait(max7219_t *dev)
+{
+    CHECK_ARG(dev);
+
+    return wait_all(dev);
+}
@@ -55,6 +55,11 @@ extern "C" {
 #define MAX7219_MAX_CASCADE_SIZE 8
 #define MAX7219_MAX_BRIGHTNESS   15
 
+/**
+ * Number of SPI transactions queued at once, enough for all rows
+ */
+#define MAX7219_QUEUE_SIZE 8
+
 /**
  * Display descriptor
  */
@@ -66,6 +71,14 @@ typedef struct
     uint8_t cascade_size;        //!< Up to `MAX7219_MAX_CASCADE_SIZE` MAX721xx cascaded
     bool mirrored;               //!< true for horizontally mirrored displays
     bool bcd;
+    bool buffered;               //!< Draw to framebuffer, see max7219_flush()
+    uint8_t fb[MAX7219_MAX_CASCADE_SIZE * 8];     //!< Framebuffer, internal
+    uint8_t shadow[MAX7219_MAX_CASCADE_SIZE * 8]; //!< Last flushed state, internal
+    spi_transaction_t trans[MAX7219_QUEUE_SIZE];  //!< SPI transactions, internal
+    uint16_t tx[MAX7219_QUEUE_SIZE][MAX7219_MAX_CASCADE_SIZE]; //!< Transaction buffers, internal.
+                                                               //!< Descriptor in internal RAM avoids copying by SPI driver
+    uint8_t head;                //!< Next transaction slot, internal
+    uint8_t in_flight;           //!< Number of queued transactions, internal
 } max7219_t;
 
 /**
@@ -162,6 +175,69 @@ esp_err_t max7219_draw_text_7seg(max7219_t *dev, uint8_t pos, const char *s);
  */
 esp_err_t max7219_draw_image_8x8(max7219_t *dev, uint8_t pos, const void *image);
 
+/**
+ * @brief Draw 1-bit columns on cascade of 8x8 matrices
+ *
+ * Column `i` is the `i`-th column of the cascade, bit 0 is the top row.
+ * This is the transposed layout of max7219_draw_image_8x8(), which takes
+ * one byte per row (digit). Columns are transposed into rows of every
+ * matrix, bit 0 of a row is its left column, missing columns are cleared.
+ * Scrolling text is drawing of the shifted window of columns.
+ *
+ * @param dev Display descriptor
+ * @param columns Column data
+ * @param num Number of columns
+ * @return `ESP_OK` on success
+ */
+esp_err_t max7219_draw_columns(max7219_t *dev, const uint8_t *columns, size_t num);
+
+/**
+ * @brief Enable or disable buffered mode
+ *
+ * In buffered mode max7219_set_digit(), max7219_clear(),
+ * max7219_draw_text_7seg() and max7219_draw_image_8x8() only update
+ * the framebuffer. Call max7219_flush() to update the display.
+ * Disabling buffered mode flushes the framebuffer.
+ *
+ * @param dev Display descriptor
+ * @param buffered Enable buffered mode if true
+ * @return `ESP_OK` on success
+ */
+esp_err_t max7219_set_buffered(max7219_t *dev, bool buffered);
+
+/**
+ * @brief Send changed part of the framebuffer to display
+ *
+ * Only rows (digits) that differ from the last flushed state are sent,
+ * one SPI transaction per row for the whole cascade. All rows are
+ * queued at once, function returns when they are sent.
+ *
+ * @param dev Display descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t max7219_flush(max7219_t *dev);
+
+/**
+ * @brief Queue changed part of the framebuffer and return immediately
+ *
+ * Same as max7219_flush() but does not wait for SPI transactions.
+ * Framebuffer is copied to transaction buffers, so drawing of the next
+ * frame may start right away. Any other function of the driver waits
+ * for the queued transactions first.
+ *
+ * @param dev Display descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t max7219_flush_async(max7219_t *dev);
+
+/**
+ * @brief Wait until all queued SPI transactions are sent
+ *
+ * @param dev Display descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t max7219_wait(max7219_t *dev);
+
 #ifdef __cplusplus
 }
 #endif
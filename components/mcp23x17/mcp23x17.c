@@ -38,6 +38,8 @@
 #include <esp_log.h>
 #include <string.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_trace.h>
 #include "mcp23x17.h"
 
 static const char *TAG = "mcp23x17";
@@ -91,6 +93,17 @@ static esp_err_t read_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t *val)
     return ESP_OK;
 }
 
+static esp_err_t read_regs(mcp23x17_t *dev, uint8_t reg, uint8_t *buf, size_t len)
+{
+    CHECK_ARG(dev && buf);
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_read_reg(dev, reg, buf, len));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
+
 static esp_err_t write_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t val)
 {
     CHECK_ARG(dev);
@@ -149,6 +162,14 @@ static esp_err_t write_reg_bit_8(mcp23x17_t *dev, uint8_t reg, bool val, uint8_t
 
 #else
 
+static esp_err_t spi_transmit(spi_device_handle_t spi_dev, spi_transaction_t *t)
+{
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, t->length);
+    esp_err_t res = spi_device_transmit(spi_dev, t);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+    return res;
+}
+
 static esp_err_t read_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t *val)
 {
     CHECK_ARG(dev && val);
@@ -162,13 +183,35 @@ static esp_err_t read_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t *val)
     t.tx_buffer = tx;
     t.length = 32;   // 32 bits
 
-    CHECK(spi_device_transmit(dev->spi_dev, &t));
+    CHECK(spi_transmit(dev->spi_dev, &t));
 
     *val = (rx[3] << 8) | rx[2];
 
     return ESP_OK;
 }
 
+#define MAX_BURST 6
+
+static esp_err_t read_regs(mcp23x17_t *dev, uint8_t reg, uint8_t *buf, size_t len)
+{
+    CHECK_ARG(dev && buf && len <= MAX_BURST);
+
+    uint8_t rx[MAX_BURST + 2] = { 0 };
+    uint8_t tx[MAX_BURST + 2] = { (dev->addr << 1) | 0x01, reg };
+
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(spi_transaction_t));
+    t.rx_buffer = rx;
+    t.tx_buffer = tx;
+    t.length = (len + 2) * 8;
+
+    CHECK(spi_transmit(dev->spi_dev, &t));
+
+    memcpy(buf, rx + 2, len);
+
+    return ESP_OK;
+}
+
 static esp_err_t write_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t val)
 {
     CHECK_ARG(dev);
@@ -180,7 +223,7 @@ static esp_err_t write_reg_16(mcp23x17_t *dev, uint8_t reg, uint16_t val)
     t.tx_buffer = tx;
     t.length = 32;   // 32 bits
 
-    CHECK(spi_device_transmit(dev->spi_dev, &t));
+    CHECK(spi_transmit(dev->spi_dev, &t));
 
     return ESP_OK;
 }
@@ -208,7 +251,7 @@ static esp_err_t read_reg_8(mcp23x17_t *dev, uint8_t reg, uint8_t *val)
     t.tx_buffer = tx;
     t.length = 24;   // 24 bits
 
-    CHECK(spi_device_transmit(dev->spi_dev, &t));
+    CHECK(spi_transmit(dev->spi_dev, &t));
 
     *val = rx[2];
 
@@ -226,7 +269,7 @@ static esp_err_t write_reg_8(mcp23x17_t *dev, uint8_t reg, uint8_t val)
     t.tx_buffer = tx;
     t.length = 24;   // 24 bits
 
-    CHECK(spi_device_transmit(dev->spi_dev, &t));
+    CHECK(spi_transmit(dev->spi_dev, &t));
 
     return ESP_OK;
 }
@@ -315,15 +358,36 @@ esp_err_t mcp23x17_init_desc_spi(mcp23x17_t *dev, spi_host_device_t host, uint32
     dev->spi_cfg.spics_io_num = cs_pin;
     dev->spi_cfg.clock_speed_hz = clock_speed_hz;
     dev->spi_cfg.mode = 0;
-    dev->spi_cfg.queue_size = 1;
+    dev->spi_cfg.queue_size = MCP23X17_SPI_QUEUE_SIZE;
+    dev->shared = false;
 
     return spi_bus_add_device(host, &dev->spi_cfg, &dev->spi_dev);
 }
 
-esp_err_t mcp23x17_free_desc(mcp23x17_t *dev)
+esp_err_t mcp23x17_init_desc_spi_shared(mcp23x17_t *dev, const mcp23x17_t *base, uint8_t addr)
+{
+    CHECK_ARG(dev && base && base->spi_dev);
+    if (addr < MCP23X17_ADDR_BASE || addr > MCP23X17_ADDR_BASE + 7)
+    {
+        ESP_LOGE(TAG, "Invalid device address: 0x%02x", addr);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    dev->addr = addr;
+    dev->spi_cfg = base->spi_cfg;
+    dev->spi_dev = base->spi_dev;
+    dev->shared = true;
+
+    return ESP_OK;
+}
+
+esp_err_t mcp23x17_free_desc_spi(mcp23x17_t *dev)
 {
     CHECK_ARG(dev);
 
+    if (dev->shared)
+        return ESP_OK;
+
     return spi_bus_remove_device(dev->spi_dev);
 }
 
@@ -335,8 +399,108 @@ esp_err_t mcp23x17_setup_hw_addr(mcp23x17_t *dev, bool enable, uint8_t new_addr)
     return ESP_OK;
 }
 
+esp_err_t mcp23x17_group_init(mcp23x17_group_t *group, mcp23x17_t **devs, size_t count)
+{
+    CHECK_ARG(group && devs && count && count <= MCP23X17_SPI_QUEUE_SIZE);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_ARG(devs[i] && devs[i]->spi_dev == devs[0]->spi_dev);
+        group->devs[i] = devs[i];
+    }
+    group->count = count;
+
+    return ESP_OK;
+}
+
+static esp_err_t group_transfer(mcp23x17_group_t *group, size_t len, bool read)
+{
+    spi_device_handle_t spi_dev = group->devs[0]->spi_dev;
+    esp_err_t res = ESP_OK;
+    size_t queued;
+
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, group->count * len * 8);
+    for (queued = 0; queued < group->count; queued++)
+    {
+        spi_transaction_t *t = &group->trans[queued];
+        memset(t, 0, sizeof(spi_transaction_t));
+        t->tx_buffer = group->tx[queued];
+        t->rx_buffer = read ? group->rx[queued] : NULL;
+        t->length = len * 8;
+        if ((res = spi_device_queue_trans(spi_dev, t, portMAX_DELAY)) != ESP_OK)
+            break;
+    }
+
+    // collect everything queued even on error
+    for (size_t i = 0; i < queued; i++)
+    {
+        spi_transaction_t *t;
+        esp_err_t r = spi_device_get_trans_result(spi_dev, &t, portMAX_DELAY);
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+
+    return res;
+}
+
+esp_err_t mcp23x17_group_port_write(mcp23x17_group_t *group, const uint16_t *values)
+{
+    CHECK_ARG(group && values);
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        uint8_t *tx = group->tx[i];
+        tx[0] = group->devs[i]->addr << 1;
+        tx[1] = REG_GPIOA;
+        tx[2] = values[i];
+        tx[3] = values[i] >> 8;
+    }
+
+    return group_transfer(group, 4, false);
+}
+
+esp_err_t mcp23x17_group_read_state(mcp23x17_group_t *group, mcp23x17_state_t *states)
+{
+    CHECK_ARG(group && states);
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        memset(group->tx[i], 0, sizeof(group->tx[i]));
+        group->tx[i][0] = (group->devs[i]->addr << 1) | 0x01;
+        group->tx[i][1] = REG_INTFA;
+    }
+
+    CHECK(group_transfer(group, 8, true));
+
+    for (size_t i = 0; i < group->count; i++)
+    {
+        const uint8_t *rx = group->rx[i] + 2;
+        states[i].intf = rx[0] | (rx[1] << 8);
+        states[i].intcap = rx[2] | (rx[3] << 8);
+        states[i].port = rx[4] | (rx[5] << 8);
+    }
+
+    return ESP_OK;
+}
+
 #endif
 
+esp_err_t mcp23x17_read_state(mcp23x17_t *dev, mcp23x17_state_t *state)
+{
+    CHECK_ARG(state);
+
+    // INTFA, INTFB, INTCAPA, INTCAPB, GPIOA, GPIOB
+    uint8_t buf[6];
+    CHECK(read_regs(dev, REG_INTFA, buf, sizeof(buf)));
+
+    state->intf = buf[0] | (buf[1] << 8);
+    state->intcap = buf[2] | (buf[3] << 8);
+    state->port = buf[4] | (buf[5] << 8);
+
+    return ESP_OK;
+}
+
 esp_err_t mcp23x17_get_int_out_mode(mcp23x17_t *dev, mcp23x17_int_out_mode_t *mode)
 {
     CHECK_ARG(mode);
@@ -481,3 +645,147 @@ esp_err_t mcp23x17_set_interrupt(mcp23x17_t *dev, uint8_t pin, mcp23x17_gpio_int
 {
     return mcp23x17_port_set_interrupt(dev, BV(pin), intr);
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR intr_isr(void *arg)
+#else
+static void intr_isr(void *arg)
+#endif
+{
+    mcp23x17_intr_service_t *svc = (mcp23x17_intr_service_t *)arg;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(svc->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static esp_err_t intr_process(mcp23x17_intr_service_t *svc)
+{
+    mcp23x17_state_t st;
+    CHECK(mcp23x17_read_state(svc->dev, &st));
+
+    uint16_t port = st.port;
+    uint16_t changed = (svc->state ^ port) | st.intf;
+    svc->state = port;
+
+    for (uint8_t pin = 0; changed; pin++, changed >>= 1)
+        if ((changed & 1) && svc->callbacks[pin])
+            svc->callbacks[pin](svc, pin, (port >> pin) & 1, svc->args[pin]);
+
+    return ESP_OK;
+}
+
+static void intr_task(void *arg)
+{
+    mcp23x17_intr_service_t *svc = (mcp23x17_intr_service_t *)arg;
+    bool active = false;
+
+    while (svc->running)
+    {
+        // poll every tick while interrupt output stays active, e.g. in
+        // compare against DEFVAL mode
+        ulTaskNotifyTake(pdTRUE, active ? 1 : portMAX_DELAY);
+        if (!svc->running)
+            break;
+
+        esp_err_t res = intr_process(svc);
+        if (res != ESP_OK)
+            ESP_LOGE(TAG, "Error reading interrupt state: %d (%s)", res, esp_err_to_name(res));
+
+        active = gpio_get_level(svc->gpio) == svc->active_level;
+    }
+
+    svc->task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t mcp23x17_intr_service_start(mcp23x17_intr_service_t *svc, mcp23x17_t *dev, gpio_num_t gpio,
+        mcp23x17_int_out_mode_t mode, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(svc && dev && !svc->task);
+
+    svc->dev = dev;
+    svc->gpio = gpio;
+    svc->active_level = mode == MCP23X17_ACTIVE_HIGH ? 1 : 0;
+
+    // both ports on one interrupt output
+    CHECK(write_reg_bit_8(dev, REG_IOCON, true, BIT_IOCON_MIRROR));
+    CHECK(mcp23x17_set_int_out_mode(dev, mode));
+
+    CHECK(gpio_set_direction(gpio, GPIO_MODE_INPUT));
+    CHECK(gpio_set_pull_mode(gpio, svc->active_level ? GPIO_PULLDOWN_ONLY : GPIO_PULLUP_ONLY));
+
+    // initial state, clears pending interrupt
+    mcp23x17_state_t st;
+    CHECK(mcp23x17_read_state(dev, &st));
+    svc->state = st.port;
+
+    svc->running = true;
+    if (xTaskCreate(intr_task, TAG, stack_size, svc, priority, &svc->task) != pdPASS)
+    {
+        svc->running = false;
+        svc->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_set_intr_type(gpio, svc->active_level ? GPIO_INTR_POSEDGE : GPIO_INTR_NEGEDGE)) != ESP_OK)
+        goto fail;
+    if ((res = gpio_isr_handler_add(gpio, intr_isr, svc)) != ESP_OK)
+        goto fail;
+
+    // catch changes made before ISR was installed
+    xTaskNotifyGive(svc->task);
+
+    return ESP_OK;
+
+fail:
+    mcp23x17_intr_service_stop(svc);
+    return res;
+}
+
+esp_err_t mcp23x17_intr_service_stop(mcp23x17_intr_service_t *svc)
+{
+    CHECK_ARG(svc);
+    // service task would wait for itself
+    if (svc->task && svc->task == xTaskGetCurrentTaskHandle())
+        return ESP_ERR_INVALID_STATE;
+
+    gpio_isr_handler_remove(svc->gpio);
+    gpio_set_intr_type(svc->gpio, GPIO_INTR_DISABLE);
+
+    svc->running = false;
+    while (svc->task)
+    {
+        xTaskNotifyGive(svc->task);
+        vTaskDelay(1);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t mcp23x17_intr_service_set_callback(mcp23x17_intr_service_t *svc, uint8_t pin,
+        mcp23x17_pin_cb_t callback, void *arg)
+{
+    CHECK_ARG(svc && pin < 16);
+
+    svc->callbacks[pin] = NULL;
+    svc->args[pin] = arg;
+    svc->callbacks[pin] = callback;
+
+    return ESP_OK;
+}
+
+esp_err_t mcp23x17_intr_service_get_state(mcp23x17_intr_service_t *svc, uint16_t *val)
+{
+    CHECK_ARG(svc && val);
+
+    *val = svc->state;
+
+    return ESP_OK;
+}
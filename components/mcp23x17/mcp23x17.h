@@ -45,6 +45,8 @@
 #include <driver/spi_master.h>
 #include <driver/gpio.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 #define MCP23X17_ADDR_BASE 0x20
 
@@ -65,8 +67,11 @@ typedef struct
     spi_device_interface_config_t spi_cfg;
     spi_device_handle_t spi_dev;
     uint8_t addr;
+    bool shared;   //!< SPI device is owned by another descriptor
 } mcp23x17_t;
 
+#define MCP23X17_SPI_QUEUE_SIZE 8 //!< Max number of queued transactions, one per chip on CS
+
 #endif
 
 /**
@@ -145,8 +150,44 @@ esp_err_t mcp23x17_init_desc_spi(mcp23x17_t *dev, spi_host_device_t host, uint32
  */
 esp_err_t mcp23x17_free_desc_spi(mcp23x17_t *dev);
 
+/**
+ * @brief Initialize descriptor of a chip sharing CS line with another one
+ *
+ * MCP23S17 chips with hardware addressing enabled (see mcp23x17_setup_hw_addr())
+ * can share one CS line. Shared descriptor uses SPI device of the `base`
+ * descriptor, so `base` must be freed last.
+ *
+ * @param dev Pointer to device descriptor
+ * @param base Initialized descriptor of a chip on the same CS line
+ * @param addr Device address (`0b0100<A2><A1><A0>`)
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_init_desc_spi_shared(mcp23x17_t *dev, const mcp23x17_t *base, uint8_t addr);
+
 #endif
 
+/**
+ * Interrupt and port state
+ */
+typedef struct
+{
+    uint16_t intf;   //!< Interrupt flags, INTFA/INTFB
+    uint16_t intcap; //!< Port state captured on interrupt, INTCAPA/INTCAPB
+    uint16_t port;   //!< Current port state, GPIOA/GPIOB
+} mcp23x17_state_t;
+
+/**
+ * @brief Read interrupt flags, captured and current port state at once
+ *
+ * Registers are read in sequential mode in one transaction.
+ * Reading current port state clears pending interrupt.
+ *
+ * @param dev Pointer to device descriptor
+ * @param[out] state Port state
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_read_state(mcp23x17_t *dev, mcp23x17_state_t *state);
+
 #ifdef CONFIG_MCP23X17_IFACE_SPI
 
 /**
@@ -163,6 +204,52 @@ esp_err_t mcp23x17_free_desc_spi(mcp23x17_t *dev);
  */
 esp_err_t mcp23x17_setup_hw_addr(mcp23x17_t *dev, bool enable, uint8_t new_addr);
 
+/**
+ * Group of chips sharing one CS line
+ */
+typedef struct
+{
+    mcp23x17_t *devs[MCP23X17_SPI_QUEUE_SIZE];         //!< Device descriptors
+    size_t count;                                      //!< Number of devices
+    spi_transaction_t trans[MCP23X17_SPI_QUEUE_SIZE];  //!< Transactions, internal
+    uint8_t tx[MCP23X17_SPI_QUEUE_SIZE][8];            //!< TX buffers, internal
+    uint8_t rx[MCP23X17_SPI_QUEUE_SIZE][8];            //!< RX buffers, internal
+} mcp23x17_group_t;
+
+/**
+ * @brief Initialize group of chips sharing one CS line
+ *
+ * All descriptors must use the same SPI device, i.e. initialized with
+ * mcp23x17_init_desc_spi_shared() from one base descriptor.
+ *
+ * @param group Group descriptor
+ * @param devs Array of device descriptors
+ * @param count Number of devices, max `MCP23X17_SPI_QUEUE_SIZE`
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_group_init(mcp23x17_group_t *group, mcp23x17_t **devs, size_t count);
+
+/**
+ * @brief Write ports of all chips in group
+ *
+ * Transactions for all chips are queued at once and then collected,
+ * so the bus is not released to the caller between chips.
+ *
+ * @param group Group descriptor
+ * @param values Array of `count` 16-bit port values
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_group_port_write(mcp23x17_group_t *group, const uint16_t *values);
+
+/**
+ * @brief Read state of all chips in group
+ *
+ * @param group Group descriptor
+ * @param[out] states Array of `count` states
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_group_read_state(mcp23x17_group_t *group, mcp23x17_state_t *states);
+
 #endif
 
 /**
@@ -327,6 +414,91 @@ esp_err_t mcp23x17_port_set_interrupt(mcp23x17_t *dev, uint16_t mask, mcp23x17_g
  */
 esp_err_t mcp23x17_set_interrupt(mcp23x17_t *dev, uint8_t pin, mcp23x17_gpio_intr_t intr);
 
+typedef struct mcp23x17_intr_service mcp23x17_intr_service_t;
+
+/**
+ * Pin change callback prototype
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number, 0 for PORTA/GPIO0..15 for PORTB/GPIO7
+ * @param level Current pin level
+ * @param arg User argument
+ */
+typedef void (*mcp23x17_pin_cb_t)(mcp23x17_intr_service_t *svc, uint8_t pin, bool level, void *arg);
+
+/**
+ * Interrupt service descriptor
+ */
+struct mcp23x17_intr_service
+{
+    mcp23x17_t *dev;                  //!< Device descriptor
+    gpio_num_t gpio;                  //!< GPIO connected to INTA
+    uint8_t active_level;             //!< Active level of INTA
+    volatile uint16_t state;          //!< Cached port state
+    mcp23x17_pin_cb_t callbacks[16];  //!< Pin callbacks
+    void *args[16];                   //!< Callback arguments
+    TaskHandle_t task;                //!< Service task, internal
+    volatile bool running;            //!< Service state, internal
+};
+
+/**
+ * @brief Start interrupt service
+ *
+ * Enables INTA/INTB mirroring, so only INTA must be connected, and
+ * installs GPIO interrupt handler. On interrupt the service task reads
+ * INTF, INTCAP and GPIO registers in one transaction, updates cached
+ * port state and calls callbacks of changed pins.
+ *
+ * Interrupts must be enabled on pins with mcp23x17_port_set_interrupt(),
+ * ::MCP23X17_INT_ANY_EDGE is recommended. In other modes interrupt
+ * output stays active while pin level differs from the compare value
+ * and the task polls the device every tick during that time.
+ *
+ * @param svc Interrupt service descriptor, must be zero-initialized
+ * @param dev Pointer to device descriptor
+ * @param gpio GPIO connected to INTA
+ * @param mode INTA pin mode
+ * @param priority Service task priority
+ * @param stack_size Service task stack size, callbacks are called from it
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_intr_service_start(mcp23x17_intr_service_t *svc, mcp23x17_t *dev, gpio_num_t gpio,
+        mcp23x17_int_out_mode_t mode, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop interrupt service
+ *
+ * Waits until the service task exits, so it must not be called from
+ * pin callbacks.
+ *
+ * @param svc Interrupt service descriptor
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` when called from
+ *         the service task
+ */
+esp_err_t mcp23x17_intr_service_stop(mcp23x17_intr_service_t *svc);
+
+/**
+ * @brief Set pin change callback
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number, 0 for PORTA/GPIO0..15 for PORTB/GPIO7
+ * @param callback Callback, NULL to remove
+ * @param arg User argument passed to callback
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_intr_service_set_callback(mcp23x17_intr_service_t *svc, uint8_t pin,
+        mcp23x17_pin_cb_t callback, void *arg);
+
+/**
+ * @brief Get cached port state
+ *
+ * No bus transaction is made, state is updated by the service task.
+ *
+ * @param svc Interrupt service descriptor
+ * @param[out] val 16-bit GPIO port value, 0 bit for PORTA/GPIO0..15 bit for PORTB/GPIO7
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp23x17_intr_service_get_state(mcp23x17_intr_service_t *svc, uint16_t *val);
 
 #ifdef __cplusplus
 }
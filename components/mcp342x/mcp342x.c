@@ -39,6 +39,7 @@
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_idf_lib_trace.h>
 #include "mcp342x.h"
 
 #define I2C_FREQ_HZ 400000 // 400kHz
@@ -56,6 +57,9 @@ static const char *TAG = "mcp342x";
 
 #define MASK_VAL 3
 
+#define GC_ADDR       0x00
+#define GC_CONVERSION 0x08
+
 #define SIGN12 0xfffff000
 #define SIGN14 0xffffc000
 #define SIGN16 0xffff0000
@@ -229,7 +233,7 @@ esp_err_t mcp342x_oneshot_conversion(mcp342x_t *dev, int32_t *data)
     uint32_t st;
     CHECK(mcp342x_get_sample_time_us(dev, &st));
     CHECK(mcp342x_start_conversion(dev));
-    vTaskDelay(pdMS_TO_TICKS(st / 1000 + 1));
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(st / 1000 + 1));
     bool ready;
     CHECK(mcp342x_get_data(dev, data, &ready));
     if (!ready)
@@ -240,3 +244,99 @@ esp_err_t mcp342x_oneshot_conversion(mcp342x_t *dev, int32_t *data)
 
     return ESP_OK;
 }
+
+esp_err_t mcp342x_group_init(mcp342x_group_t *group, mcp342x_t **devs, size_t count)
+{
+    CHECK_ARG(group && devs && count && count <= MCP342X_ADDR_MAX - MCP342X_ADDR_MIN + 1);
+    for (size_t i = 0; i < count; i++)
+        CHECK_ARG(devs[i] && devs[i]->i2c_dev.port == devs[0]->i2c_dev.port);
+
+    group->devs = devs;
+    group->count = count;
+    group->gc = devs[0]->i2c_dev;
+    group->gc.addr = GC_ADDR;
+
+    return i2c_dev_create_mutex(&group->gc);
+}
+
+esp_err_t mcp342x_group_free(mcp342x_group_t *group)
+{
+    CHECK_ARG(group);
+
+    return i2c_dev_delete_mutex(&group->gc);
+}
+
+esp_err_t mcp342x_group_start(mcp342x_group_t *group)
+{
+    CHECK_ARG(group);
+
+    // one-shot mode without RDY bit: config only, conversion is not started
+    for (size_t i = 0; i < group->count; i++)
+    {
+        group->devs[i]->mode = MCP342X_ONESHOT;
+        CHECK(mcp342x_set_config(group->devs[i]));
+    }
+
+    uint8_t cmd = GC_CONVERSION;
+    I2C_DEV_TAKE_MUTEX(&group->gc);
+    I2C_DEV_CHECK(&group->gc, i2c_dev_write(&group->gc, NULL, 0, &cmd, 1));
+    I2C_DEV_GIVE_MUTEX(&group->gc);
+
+    return ESP_OK;
+}
+
+esp_err_t mcp342x_group_collect(mcp342x_group_t *group, int32_t *data, uint32_t timeout_ms)
+{
+    CHECK_ARG(group && data);
+
+    uint32_t st = 0;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        uint32_t t;
+        CHECK(mcp342x_get_sample_time_us(group->devs[i], &t));
+        if (t > st)
+            st = t;
+    }
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(st / 1000 + 1));
+
+    uint32_t pending = (1UL << group->count) - 1;
+    TickType_t start = xTaskGetTickCount();
+    while (true)
+    {
+        for (size_t i = 0; i < group->count; i++)
+        {
+            if (!(pending & BV(i)))
+                continue;
+            bool ready;
+            CHECK(mcp342x_get_data(group->devs[i], &data[i], &ready));
+            if (ready)
+                pending &= ~BV(i);
+        }
+        if (!pending)
+            return ESP_OK;
+        if (xTaskGetTickCount() - start > pdMS_TO_TICKS(timeout_ms))
+        {
+            ESP_LOGE(TAG, "Data not ready, devices mask 0x%08x", pending);
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(1);
+    }
+}
+
+esp_err_t mcp342x_group_sweep(mcp342x_group_t *group, size_t channels, int32_t *data)
+{
+    CHECK_ARG(group && data && channels && channels <= MCP342X_CHANNEL4 + 1);
+
+    int32_t res[group->count];
+    for (size_t ch = 0; ch < channels; ch++)
+    {
+        for (size_t i = 0; i < group->count; i++)
+            group->devs[i]->channel = ch;
+        CHECK(mcp342x_group_start(group));
+        CHECK(mcp342x_group_collect(group, res, 10));
+        for (size_t i = 0; i < group->count; i++)
+            data[i * channels + ch] = res[i];
+    }
+
+    return ESP_OK;
+}
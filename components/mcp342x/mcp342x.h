@@ -186,6 +186,74 @@ esp_err_t mcp342x_get_voltage(mcp342x_t *dev, float *volts, bool *ready);
  */
 esp_err_t mcp342x_oneshot_conversion(mcp342x_t *dev, int32_t *data);
 
+/**
+ * Group of devices on one I2C bus converting simultaneously
+ */
+typedef struct {
+    mcp342x_t **devs;  //!< Device descriptors
+    size_t count;      //!< Number of devices
+    i2c_dev_t gc;      //!< General call descriptor, internal
+} mcp342x_group_t;
+
+/**
+ * @brief Initialize group
+ *
+ * All devices must be on the same I2C port.
+ *
+ * @param group Group descriptor
+ * @param devs Array of initialized device descriptors
+ * @param count Number of devices
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp342x_group_init(mcp342x_group_t *group, mcp342x_t **devs, size_t count);
+
+/**
+ * @brief Free group descriptor
+ *
+ * @param group Group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp342x_group_free(mcp342x_group_t *group);
+
+/**
+ * @brief Start conversions on all devices at once
+ *
+ * Configuration (channel, resolution, gain) of each device descriptor is
+ * written in one-shot mode, then conversions are started with one
+ * General Call Conversion command.
+ *
+ * @param group Group descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp342x_group_start(mcp342x_group_t *group);
+
+/**
+ * @brief Collect results of conversions started by mcp342x_group_start()
+ *
+ * Waits for the longest sample time in group, then reads devices until
+ * all of them are ready.
+ *
+ * @param group Group descriptor
+ * @param[out] data Array of `count` ADC values
+ * @param timeout_ms Additional time to wait for late devices
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if some devices are not ready
+ */
+esp_err_t mcp342x_group_collect(mcp342x_group_t *group, int32_t *data, uint32_t timeout_ms);
+
+/**
+ * @brief Convert several channels on all devices
+ *
+ * For each channel conversions are started and collected on all devices
+ * in parallel, so the sweep takes `channels` sample times instead of
+ * `count * channels`.
+ *
+ * @param group Group descriptor
+ * @param channels Number of channels to convert, starting from ::MCP342X_CHANNEL1
+ * @param[out] data Array of `count * channels` ADC values, `data[dev * channels + channel]`
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp342x_group_sweep(mcp342x_group_t *group, size_t channels, int32_t *data);
+
 #ifdef __cplusplus
 }
 #endif
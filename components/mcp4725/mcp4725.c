@@ -45,6 +45,7 @@ static const char *TAG = "mcp4725";
 
 #define I2C_FREQ_HZ 1000000 // Max 1MHz for esp-idf, but device supports up to 3.4Mhz
 
+#define CMD_FAST   0x00
 #define CMD_DAC    0x40
 #define CMD_EEPROM 0x60
 #define BIT_READY  0x80
@@ -182,3 +183,27 @@ esp_err_t mcp4725_set_voltage(i2c_dev_t *dev, float vdd, float value, bool eepro
     return mcp4725_set_raw_output(dev, MCP4725_MAX_VALUE / vdd * value, eeprom);
 }
 
+esp_err_t mcp4725_pack_fast(const uint16_t *samples, size_t count, mcp4725_power_mode_t mode, uint8_t *buf)
+{
+    CHECK_ARG(samples && count && buf && mode <= MCP4725_PM_PD_500K);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint16_t v = samples[i] > MCP4725_MAX_VALUE ? MCP4725_MAX_VALUE : samples[i];
+        buf[i * 2] = CMD_FAST | (mode << 4) | (v >> 8);
+        buf[i * 2 + 1] = v;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t mcp4725_write_fast(i2c_dev_t *dev, const uint8_t *buf, size_t count)
+{
+    CHECK_ARG(dev && buf && count);
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write(dev, NULL, 0, buf, count * MCP4725_FAST_SAMPLE_SIZE));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
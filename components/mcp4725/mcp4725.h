@@ -58,6 +58,8 @@ extern "C" {
 
 #define MCP4725_MAX_VALUE 0x0fff
 
+#define MCP4725_FAST_SAMPLE_SIZE 2 //!< Bytes per sample in fast write mode
+
 /**
  * Power mode, see datasheet
  */
@@ -162,6 +164,33 @@ esp_err_t mcp4725_get_voltage(i2c_dev_t *dev, float vdd, bool eeprom, float *vol
  */
 esp_err_t mcp4725_set_voltage(i2c_dev_t *dev, float vdd, float value, bool eeprom);
 
+/**
+ * @brief Pack samples for fast write mode
+ *
+ * Buffer is used by ::mcp4725_write_fast(), it can be prepared once
+ * and written many times.
+ *
+ * @param samples Raw output values, 0..4095
+ * @param count Number of samples
+ * @param mode Power mode, set with every sample
+ * @param[out] buf Buffer of `count * MCP4725_FAST_SAMPLE_SIZE` bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp4725_pack_fast(const uint16_t *samples, size_t count, mcp4725_power_mode_t mode, uint8_t *buf);
+
+/**
+ * @brief Write packed samples in one I2C transaction
+ *
+ * Uses fast write command: after the address byte every 2 bytes update
+ * DAC output, so one sample takes 18 SCL cycles. EEPROM is not written.
+ *
+ * @param dev I2C device descriptor
+ * @param buf Samples packed with ::mcp4725_pack_fast()
+ * @param count Number of samples
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp4725_write_fast(i2c_dev_t *dev, const uint8_t *buf, size_t count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file mcp4725_stream.c
+ *
+ * MCP4725 waveform output using fast write mode
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <esp_log.h>
+#include <esp_idf_lib_helpers.h>
+#include "mcp4725_stream.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define I2C_FREQ_MAX_HZ 1000000
+// Address byte, start and stop conditions
+#define BLOCK_OVERHEAD_BITS 11
+#define SAMPLE_BITS (MCP4725_FAST_SAMPLE_SIZE * 9)
+// Part of block period used by transaction
+#define BUS_LOAD_PCT 90
+
+static const char *TAG = "mcp4725_stream";
+
+static void timer_cb(void *arg)
+{
+    xTaskNotifyGive(((mcp4725_stream_t *)arg)->task);
+}
+
+static void next_block(mcp4725_stream_t *stream)
+{
+    if (!stream->wave)
+    {
+        stream->fill(stream->ctx, stream->samples, stream->block);
+        return;
+    }
+
+    for (size_t i = 0; i < stream->block; i++)
+    {
+        stream->samples[i] = stream->wave[stream->pos++];
+        if (stream->pos >= stream->wave_len)
+            stream->pos = 0;
+    }
+}
+
+static void writer_task(void *arg)
+{
+    mcp4725_stream_t *stream = (mcp4725_stream_t *)arg;
+
+    next_block(stream);
+    mcp4725_pack_fast(stream->samples, stream->block, MCP4725_PM_NORMAL, stream->buf);
+
+    while (stream->running)
+    {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!stream->running)
+            break;
+        // previous block was not finished in time
+        if (ticks > 1)
+            stream->overruns += ticks - 1;
+
+        if (mcp4725_write_fast(stream->dev, stream->buf, stream->block) != ESP_OK)
+            stream->errors++;
+
+        // prepare next block while waiting for the timer
+        next_block(stream);
+        mcp4725_pack_fast(stream->samples, stream->block, MCP4725_PM_NORMAL, stream->buf);
+    }
+
+    stream->task = NULL;
+    vTaskDelete(NULL);
+}
+
+static esp_err_t setup_clock(mcp4725_stream_t *stream, uint32_t sample_rate)
+{
+    uint64_t bits = (uint64_t)stream->block * SAMPLE_BITS + BLOCK_OVERHEAD_BITS;
+    uint64_t clk = bits * sample_rate * 100 / (stream->block * BUS_LOAD_PCT);
+    if (clk > I2C_FREQ_MAX_HZ)
+    {
+        ESP_LOGE(TAG, "Sample rate %u Hz needs %u Hz I2C clock", (unsigned)sample_rate, (unsigned)clk);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+#if HELPER_TARGET_IS_ESP32
+    stream->clk_speed = stream->dev->cfg.master.clk_speed;
+    stream->dev->cfg.master.clk_speed = clk;
+    ESP_LOGD(TAG, "I2C clock set to %u Hz", (unsigned)clk);
+#endif
+
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t mcp4725_stream_start(mcp4725_stream_t *stream, uint32_t sample_rate, size_t block,
+        UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(stream && stream->dev && sample_rate && block && !stream->task);
+    CHECK_ARG((stream->wave && stream->wave_len) || (!stream->wave && stream->fill));
+
+    stream->block = block;
+    stream->pos = 0;
+    stream->overruns = 0;
+    stream->errors = 0;
+    stream->timer = NULL;
+    stream->clk_speed = 0;
+
+    esp_err_t res = ESP_ERR_NO_MEM;
+    stream->samples = malloc(block * sizeof(uint16_t));
+    stream->buf = malloc(block * MCP4725_FAST_SAMPLE_SIZE);
+    if (!stream->samples || !stream->buf)
+        goto fail;
+
+    if ((res = setup_clock(stream, sample_rate)) != ESP_OK)
+        goto fail;
+
+    esp_timer_create_args_t timer_args = {
+        .callback = timer_cb,
+        .arg = stream,
+        .name = TAG
+    };
+    if ((res = esp_timer_create(&timer_args, &stream->timer)) != ESP_OK)
+        goto fail;
+
+    stream->running = true;
+    if (xTaskCreate(writer_task, TAG, stack_size, stream, priority, &stream->task) != pdPASS)
+    {
+        stream->task = NULL;
+        res = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+
+    if ((res = esp_timer_start_periodic(stream->timer, (uint64_t)block * 1000000 / sample_rate)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    mcp4725_stream_stop(stream);
+    return res;
+}
+
+esp_err_t mcp4725_stream_stop(mcp4725_stream_t *stream)
+{
+    CHECK_ARG(stream);
+
+    if (stream->timer)
+    {
+        esp_timer_stop(stream->timer);
+        esp_timer_delete(stream->timer);
+        stream->timer = NULL;
+    }
+
+    stream->running = false;
+    while (stream->task)
+    {
+        xTaskNotifyGive(stream->task);
+        vTaskDelay(1);
+    }
+
+#if HELPER_TARGET_IS_ESP32
+    if (stream->clk_speed)
+    {
+        stream->dev->cfg.master.clk_speed = stream->clk_speed;
+        stream->clk_speed = 0;
+    }
+#endif
+
+    free(stream->samples);
+    stream->samples = NULL;
+    free(stream->buf);
+    stream->buf = NULL;
+
+    return ESP_OK;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file mcp4725_stream.h
+ * @defgroup mcp4725_stream mcp4725_stream
+ * @{
+ *
+ * MCP4725 waveform output using fast write mode
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __MCP4725_STREAM_H__
+#define __MCP4725_STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+#include "mcp4725.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Callback to get next samples when no waveform is set.
+ *
+ * Called from the writer task, must fill all `count` samples
+ * (raw values 0..4095).
+ */
+typedef void (*mcp4725_stream_fill_cb_t)(void *ctx, uint16_t *samples, size_t count);
+
+/**
+ * Stream descriptor
+ */
+typedef struct
+{
+    i2c_dev_t *dev;                 //!< Device descriptor
+    const uint16_t *wave;           //!< Waveform played in a loop, NULL to use `fill`
+    size_t wave_len;                //!< Waveform length, samples
+    mcp4725_stream_fill_cb_t fill;  //!< Sample source when `wave` is NULL
+    void *ctx;                      //!< Callback context
+    size_t block;                   //!< Samples per transaction, internal
+    size_t pos;                     //!< Position in waveform, internal
+    uint16_t *samples;              //!< Unpacked block, internal
+    uint8_t *buf;                   //!< Packed block, internal
+    esp_timer_handle_t timer;       //!< Block timer, internal
+    TaskHandle_t task;              //!< Writer task, internal
+    volatile bool running;          //!< Stream state, internal
+    uint32_t clk_speed;             //!< I2C clock before start, internal
+    uint32_t overruns;              //!< Number of blocks written too late
+    uint32_t errors;                //!< Number of failed transactions
+} mcp4725_stream_t;
+
+/**
+ * @brief Start waveform output
+ *
+ * Samples are written in blocks of `block` samples, each block is one
+ * I2C transaction in fast write mode (2 bytes per sample). Start of every
+ * block is paced by esp_timer, so average sample rate is exact.
+ * On ESP32 I2C clock is set so that a block takes the whole block period,
+ * spacing samples inside a block evenly. On ESP8266 samples inside a
+ * block are output at the bus clock rate.
+ *
+ * Bus is locked only for the time of one block, other devices on the bus
+ * can be accessed between blocks, delaying the next block.
+ *
+ * @param stream Stream descriptor, `dev` and `wave`/`wave_len` or `fill` must be set
+ * @param sample_rate Output sample rate, Hz. Up to ~50000 on ESP32 with 1 MHz bus
+ * @param block Samples per transaction
+ * @param priority Writer task priority
+ * @param stack_size Writer task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp4725_stream_start(mcp4725_stream_t *stream, uint32_t sample_rate, size_t block,
+        UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop waveform output
+ *
+ * Output keeps the last written value, I2C clock is restored.
+ *
+ * @param stream Stream descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp4725_stream_stop(mcp4725_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __MCP4725_STREAM_H__ */
@@ -95,6 +95,14 @@ static const char *TAG = "mcp960x";
 
 #define LSB 0.0625
 
+// status flags cleared by writing 0
+#define MASK_ST_READY (BV(BIT_ST_TH) | BV(BIT_ST_BURST))
+
+static const uint8_t reg_t_hot = REG_T_HOT;
+static const uint8_t reg_t_delta = REG_T_DELTA;
+static const uint8_t reg_t_cold = REG_T_COLD;
+static const uint8_t reg_status = REG_STATUS;
+
 inline static uint16_t shuffle(uint16_t x)
 {
     return (x >> 8) | (x << 8);
@@ -150,7 +158,7 @@ static esp_err_t read_reg_16_float(mcp960x_t *dev, uint8_t reg, float *val)
 {
     uint16_t raw;
     CHECK(read_reg_16(dev, reg, &raw));
-    *val = (float)raw * LSB;
+    *val = (int16_t)raw * LSB;
     return ESP_OK;
 }
 
@@ -261,7 +269,7 @@ esp_err_t mcp960x_get_device_config(mcp960x_t *dev, mcp960x_mode_t *mode, mcp960
     CHECK_ARG(dev && (mode || bs || adc_res || tc_res));
 
     uint8_t r;
-    CHECK(read_reg_8_lock(dev, REG_SENS_CONF, &r));
+    CHECK(read_reg_8_lock(dev, REG_DEV_CONF, &r));
 
     if (mode)
         *mode = (r & MASK_DC_MODE) >> BIT_DC_MODE;
@@ -321,6 +329,62 @@ esp_err_t mcp960x_get_ambient_temp(mcp960x_t *dev, float *t)
     return read_reg_16_float_lock(dev, REG_T_COLD, t);
 }
 
+esp_err_t mcp960x_get_data(mcp960x_t *dev, mcp960x_data_t *data, bool *ready)
+{
+    CHECK_ARG(dev && data && ready);
+
+    uint8_t st;
+    uint8_t raw[3][2];
+    // flags are cleared after reading
+    uint8_t st_clear;
+
+    i2c_dev_transaction_t trans[] = {
+        { .dev = &dev->i2c_dev, .op = I2C_DEV_OP_READ, .reg = &reg_t_hot, .reg_size = 1, .data = raw[0], .size = 2 },
+        { .dev = &dev->i2c_dev, .op = I2C_DEV_OP_READ, .reg = &reg_t_delta, .reg_size = 1, .data = raw[1], .size = 2 },
+        { .dev = &dev->i2c_dev, .op = I2C_DEV_OP_READ, .reg = &reg_t_cold, .reg_size = 1, .data = raw[2], .size = 2 },
+        { .dev = &dev->i2c_dev, .op = I2C_DEV_OP_WRITE, .reg = &reg_status, .reg_size = 1, .data = &st_clear, .size = 1 },
+    };
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8(dev, REG_STATUS, &st));
+    *ready = (st & MASK_ST_READY) != 0;
+    if (*ready)
+    {
+        st_clear = st & ~MASK_ST_READY;
+        I2C_DEV_CHECK(&dev->i2c_dev, i2c_dev_transactions(dev->i2c_dev.port, trans, sizeof(trans) / sizeof(trans[0])));
+    }
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    data->status = (st & MASK_ST_MODE) >> BIT_ST_OC;
+    data->alerts = st & 0x0f;
+    if (!*ready)
+        return ESP_OK;
+
+    data->burst = (st >> BIT_ST_BURST) & 1;
+    data->hot = (int16_t)(((uint16_t)raw[0][0] << 8) | raw[0][1]) * LSB;
+    data->delta = (int16_t)(((uint16_t)raw[1][0] << 8) | raw[1][1]) * LSB;
+    data->cold = (int16_t)(((uint16_t)raw[2][0] << 8) | raw[2][1]) * LSB;
+
+    return ESP_OK;
+}
+
+esp_err_t mcp960x_start_burst(mcp960x_t *dev, mcp960x_burst_samples_t bs)
+{
+    CHECK_ARG(dev && bs <= MCP960X_SAMPLES_128);
+
+    uint8_t st, r;
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    // clear stale burst complete flag first
+    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8(dev, REG_STATUS, &st));
+    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8(dev, REG_STATUS, st & ~MASK_ST_READY));
+    I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8(dev, REG_DEV_CONF, &r));
+    r = (r & ~(MASK_DC_MODE | MASK_DC_SAMPLES)) | (MCP960X_MODE_BURST << BIT_DC_MODE) | (bs << BIT_DC_SAMPLES);
+    I2C_DEV_CHECK(&dev->i2c_dev, write_reg_8(dev, REG_DEV_CONF, r));
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    return ESP_OK;
+}
+
 esp_err_t mcp960x_get_status(mcp960x_t *dev, bool *temp_ready, bool *burst_ready, mcp960x_status_t *status,
         bool *alert1, bool *alert2, bool *alert3, bool *alert4)
 {
@@ -397,7 +461,7 @@ esp_err_t mcp960x_get_alert_config(mcp960x_t *dev, mcp960x_alert_t alert, mcp960
     if (limit)
         I2C_DEV_CHECK(&dev->i2c_dev, read_reg_16_float(dev, REG_ALERT_LIM + alert, limit));
     if (hyst)
-        I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8(dev, REG_ALERT_LIM + alert, hyst));
+        I2C_DEV_CHECK(&dev->i2c_dev, read_reg_8(dev, REG_ALERT_HYST + alert, hyst));
 
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
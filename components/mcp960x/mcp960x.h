@@ -160,6 +160,19 @@ typedef enum {
     MCP960X_ALERT_SRC_TC      /**< Alert monitor for cold-junction sensor TC */
 } mcp960x_alert_source_t;
 
+/**
+ * Combined measurement results, see ::mcp960x_get_data()
+ */
+typedef struct
+{
+    float hot;                  //!< Thermocouple temperature, cold-junction compensated, degrees Celsius
+    float delta;                //!< Junctions delta temperature, degrees Celsius
+    float cold;                 //!< Cold-junction/ambient temperature, degrees Celsius
+    bool burst;                 //!< Results are of completed burst
+    mcp960x_status_t status;    //!< Device status
+    uint8_t alerts;             //!< Alert status, bit 0 is alert 1 .. bit 3 is alert 4
+} mcp960x_data_t;
+
 /**
  * Device descriptor
  */
@@ -297,6 +310,37 @@ esp_err_t mcp960x_get_delta_temp(mcp960x_t *dev, float *t);
  */
 esp_err_t mcp960x_get_ambient_temp(mcp960x_t *dev, float *t);
 
+/**
+ * @brief Get all temperatures if a new conversion is complete
+ *
+ * Status register is checked first. If temperature update or burst complete
+ * flag is set, hot-junction, delta and cold-junction temperatures are read
+ * in one batch while holding the bus and the flags are cleared, so next
+ * call reports only the next conversion. Otherwise only `status` and
+ * `alerts` fields are updated.
+ *
+ * @param dev Device descriptor
+ * @param[out] data Results
+ * @param[out] ready true if new results were read
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp960x_get_data(mcp960x_t *dev, mcp960x_data_t *data, bool *ready);
+
+/**
+ * @brief Start burst of thermocouple conversions
+ *
+ * Device makes `bs` conversions filtered by the digital filter set with
+ * ::mcp960x_set_sensor_config() and goes to shutdown mode. Check
+ * completion with ::mcp960x_get_data(), `burst` field of results is set.
+ * Several devices can be started one after another and polled later.
+ * ADC and cold-junction resolutions are not changed.
+ *
+ * @param dev Device descriptor
+ * @param bs Number of samples in burst
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp960x_start_burst(mcp960x_t *dev, mcp960x_burst_samples_t bs);
+
 /**
  * @brief Get device status
  *
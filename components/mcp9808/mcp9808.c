@@ -329,3 +329,21 @@ esp_err_t mcp9808_get_temperature(i2c_dev_t *dev, float *t, bool *lower, bool *u
     return ESP_OK;
 }
 
+esp_err_t mcp9808_get_temperature_fixed(i2c_dev_t *dev, int16_t *t, bool *lower, bool *upper, bool *crit)
+{
+    CHECK_ARG(dev && t);
+
+    uint16_t v;
+
+    CHECK(read_reg_16(dev, REG_T_A, &v));
+    // 1/16 deg.C
+    int32_t raw = v & 0x0fff;
+    if (v & BV(BIT_T_SIGN)) raw -= 4096;
+    *t = raw * 25 / 4;
+    if (lower) *lower = v & BV(BIT_T_A_LOWER) ? true : false;
+    if (upper) *upper = v & BV(BIT_T_A_UPPER) ? true : false;
+    if (crit) *crit = v & BV(BIT_T_A_CRIT) ? true : false;
+
+    return ESP_OK;
+}
+
@@ -260,6 +260,18 @@ esp_err_t mcp9808_clear_interrupt(i2c_dev_t *dev);
  */
 esp_err_t mcp9808_get_temperature(i2c_dev_t *dev, float *t, bool *lower, bool *upper, bool *crit);
 
+/**
+ * @brief Read temperature without floating point operations
+ *
+ * @param dev Device descriptor
+ * @param[out] t Ambient temperature, 0.01 deg.C
+ * @param[out] lower True if T a < T lower, can be NULL
+ * @param[out] upper True if T a > T upper, can be NULL
+ * @param[out] crit True if T a >= T critical, can be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t mcp9808_get_temperature_fixed(i2c_dev_t *dev, int16_t *t, bool *lower, bool *upper, bool *crit);
+
 #ifdef __cplusplus
 }
 #endif
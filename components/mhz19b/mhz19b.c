@@ -38,6 +38,7 @@
  *
  * BSD Licensed as described in the file LICENSE
  */
+#include <stdlib.h>
 #include <string.h>
 #include <esp_idf_lib_helpers.h>
 #include <esp_log.h>
@@ -54,7 +55,19 @@ static const char *TAG = "mhz19b";
 
 esp_err_t mhz19b_init(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio)
 {
-    CHECK_ARG(dev);
+    return mhz19b_init_events(dev, uart_port, tx_gpio, rx_gpio, 0, NULL);
+}
+
+esp_err_t mhz19b_init_events(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        int queue_size, QueueHandle_t *events)
+{
+    return mhz19b_init_static(dev, uart_port, tx_gpio, rx_gpio, queue_size, events, NULL);
+}
+
+esp_err_t mhz19b_init_static(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        int queue_size, QueueHandle_t *events, uint8_t *buf)
+{
+    CHECK_ARG(dev && (!queue_size || events));
 
     uart_config_t uart_config = {
         .baud_rate = 9600,
@@ -66,7 +79,7 @@ esp_err_t mhz19b_init(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gp
         .source_clk = UART_SCLK_APB,
 #endif
     };
-    CHECK(uart_driver_install(uart_port, MHZ19B_SERIAL_BUF_LEN * 2, 0, 0, NULL, 0));
+    CHECK(uart_driver_install(uart_port, MHZ19B_SERIAL_BUF_LEN * 2, 0, queue_size, events, 0));
     CHECK(uart_param_config(uart_port, &uart_config));
 #if HELPER_TARGET_IS_ESP32
     CHECK(uart_set_pin(uart_port, tx_gpio, rx_gpio, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE));
@@ -74,7 +87,8 @@ esp_err_t mhz19b_init(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gp
 
     dev->uart_port = uart_port;
     // buffer for the incoming data
-    dev->buf = malloc(MHZ19B_SERIAL_BUF_LEN);
+    dev->static_buf = buf != NULL;
+    dev->buf = buf ? buf : malloc(MHZ19B_SERIAL_BUF_LEN);
     if (!dev->buf)
         return ESP_ERR_NO_MEM;
     dev->last_value = -1;
@@ -86,7 +100,8 @@ esp_err_t mhz19b_free(mhz19b_dev_t *dev)
 {
     CHECK_ARG(dev && dev->buf);
 
-    free(dev->buf);
+    if (!dev->static_buf)
+        free(dev->buf);
     dev->buf = NULL;
     return ESP_OK;
 }
@@ -138,7 +153,7 @@ bool mhz19b_is_ready(mhz19b_dev_t *dev)
     if (!dev) return false;
 
     // Minimum CO2 read interval (Built-in LED flashes)
-    if ((esp_timer_get_time() - dev->last_ts) > MHZ19B_READ_INTERVAL_MS) {
+    if ((esp_timer_get_time() - dev->last_ts) > MHZ19B_READ_INTERVAL_MS * 1000) {
         return true;
     }
 
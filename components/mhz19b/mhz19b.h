@@ -46,6 +46,8 @@
 #include <stdbool.h>
 #include <driver/uart.h>
 #include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
 #include <esp_err.h>
 
 #ifdef __cplusplus
@@ -61,6 +63,7 @@ typedef struct
     uint8_t *buf;           ///< read buffer attached to this device
     int16_t last_value;     ///< last read value
     int64_t last_ts;        ///< timestamp of the last sensor co2 level reading
+    bool static_buf;        ///< read buffer is provided by caller, not freed by ::mhz19b_free()
 } mhz19b_dev_t;
 
 //! 3 minutes warming-up time after power-on before valid data returned
@@ -111,6 +114,46 @@ typedef enum {
  */
 esp_err_t mhz19b_init(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio);
 
+/**
+ * @brief Initialize device descriptor with UART event queue
+ *
+ * Same as ::mhz19b_init(), but UART driver is installed with event
+ * queue, used by asynchronous mode.
+ *
+ * @param dev Pointer to the sensor device data structure
+ * @param uart_port UART port number
+ * @param tx_gpio GPIO pin number for TX
+ * @param rx_gpio GPIO pin number for RX
+ * @param queue_size UART event queue size, 0 for no queue
+ * @param[out] events UART event queue handle
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t mhz19b_init_events(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        int queue_size, QueueHandle_t *events);
+
+//! Size of read buffer for ::mhz19b_init_static()
+#define MHZ19B_BUFFER_SIZE              MHZ19B_SERIAL_BUF_LEN
+
+/**
+ * @brief Initialize device descriptor with caller-provided read buffer
+ *
+ * Same as ::mhz19b_init_events(), but the read buffer is not allocated, so
+ * it can be a static array. UART driver still allocates its own buffers.
+ *
+ * @param dev Pointer to the sensor device data structure
+ * @param uart_port UART port number
+ * @param tx_gpio GPIO pin number for TX
+ * @param rx_gpio GPIO pin number for RX
+ * @param queue_size UART event queue size, 0 for no queue
+ * @param[out] events UART event queue handle
+ * @param buf Read buffer of ::MHZ19B_BUFFER_SIZE bytes or NULL to allocate it
+ *
+ * @return ESP_OK on success
+ */
+esp_err_t mhz19b_init_static(mhz19b_dev_t *dev, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        int queue_size, QueueHandle_t *events, uint8_t *buf);
+
 /**
  * @brief Free device descriptor
  *
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file mhz19b_async.c
+ *
+ * Asynchronous event-driven reader for MH-Z19B sensors
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include "mhz19b_async.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define FRAME_START 0xff
+#define SENSOR_ADDR 0x01
+
+static const char *TAG = "mhz19b_async";
+
+static void send_request(mhz19b_async_sensor_t *s, const mhz19b_async_request_t *req)
+{
+    s->cmd = req->frame[2];
+    s->pos = 0;
+    s->deadline = xTaskGetTickCount() + pdMS_TO_TICKS(MHZ19B_SERIAL_RX_TIMEOUT_MS);
+    uart_write_bytes(s->dev.uart_port, (const char *)req->frame, sizeof(req->frame));
+}
+
+static void finish(mhz19b_async_t *svc, size_t idx, esp_err_t result)
+{
+    mhz19b_async_sensor_t *s = svc->sensors + idx;
+    uint8_t cmd = s->cmd;
+
+    s->cmd = 0;
+    s->pos = 0;
+    if (result != ESP_OK)
+        s->errors++;
+    else if (cmd == MHZ19B_CMD_READ_CO2)
+    {
+        s->dev.last_value = mhz19b_async_co2(s->frame);
+        s->dev.last_ts = esp_timer_get_time();
+    }
+
+    if (svc->cb)
+        svc->cb(svc, idx, cmd, s->frame, result, svc->ctx);
+
+    if (s->pending_count)
+    {
+        mhz19b_async_request_t *req = s->pending + s->pending_head;
+        s->pending_head = (s->pending_head + 1) % MHZ19B_ASYNC_PENDING_MAX;
+        s->pending_count--;
+        send_request(s, req);
+    }
+}
+
+static void handle_request(mhz19b_async_t *svc, const mhz19b_async_request_t *req)
+{
+    mhz19b_async_sensor_t *s = svc->sensors + req->sensor;
+
+    if (!s->cmd)
+    {
+        send_request(s, req);
+        return;
+    }
+    if (s->pending_count == MHZ19B_ASYNC_PENDING_MAX)
+    {
+        ESP_LOGW(TAG, "Sensor %u is busy, command 0x%02x dropped", (unsigned)req->sensor, req->frame[2]);
+        return;
+    }
+    s->pending[(s->pending_head + s->pending_count) % MHZ19B_ASYNC_PENDING_MAX] = *req;
+    s->pending_count++;
+}
+
+static void parse(mhz19b_async_t *svc, size_t idx, const uint8_t *data, size_t len)
+{
+    mhz19b_async_sensor_t *s = svc->sensors + idx;
+
+    for (size_t i = 0; i < len; i++)
+    {
+        // nothing expected, skip garbage
+        if (!s->cmd)
+            continue;
+        // resynchronize on frame start
+        if (!s->pos && data[i] != FRAME_START)
+            continue;
+        s->frame[s->pos++] = data[i];
+        if (s->pos == 2 && s->frame[1] != s->cmd)
+        {
+            s->pos = data[i] == FRAME_START ? 1 : 0;
+            continue;
+        }
+        if (s->pos < MHZ19B_SERIAL_RX_BYTES)
+            continue;
+
+        finish(svc, idx, s->frame[8] == mhz19b_calc_crc(s->frame) ? ESP_OK : ESP_ERR_INVALID_CRC);
+    }
+}
+
+static void handle_uart(mhz19b_async_t *svc, size_t idx)
+{
+    mhz19b_async_sensor_t *s = svc->sensors + idx;
+    uart_event_t event;
+    uint8_t buf[MHZ19B_SERIAL_RX_BYTES * 2];
+
+    if (xQueueReceive(s->events, &event, 0) != pdTRUE)
+        return;
+
+    switch (event.type)
+    {
+        case UART_DATA:
+            while (event.size)
+            {
+                size_t chunk = event.size > sizeof(buf) ? sizeof(buf) : event.size;
+                int len = uart_read_bytes(s->dev.uart_port, buf, chunk, 0);
+                if (len <= 0)
+                    break;
+                parse(svc, idx, buf, len);
+                event.size -= len;
+            }
+            break;
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            ESP_LOGW(TAG, "Sensor %u: RX overflow", (unsigned)idx);
+            uart_flush_input(s->dev.uart_port);
+            s->pos = 0;
+            break;
+        default:
+            break;
+    }
+}
+
+static void check_timeouts(mhz19b_async_t *svc, TickType_t *wait)
+{
+    TickType_t now = xTaskGetTickCount();
+
+    *wait = portMAX_DELAY;
+    for (size_t i = 0; i < svc->count; i++)
+    {
+        mhz19b_async_sensor_t *s = svc->sensors + i;
+        if (!s->cmd)
+            continue;
+        if ((int32_t)(s->deadline - now) <= 0)
+            finish(svc, i, ESP_ERR_TIMEOUT);
+        // finish() could send the next command
+        if (s->cmd && s->deadline - now < *wait)
+            *wait = s->deadline - now;
+    }
+}
+
+static void service_task(void *arg)
+{
+    mhz19b_async_t *svc = (mhz19b_async_t *)arg;
+    TickType_t wait = portMAX_DELAY;
+
+    while (svc->running)
+    {
+        QueueSetMemberHandle_t active = xQueueSelectFromSet(svc->set, wait);
+        if (!svc->running)
+            break;
+
+        if (active == svc->requests)
+        {
+            mhz19b_async_request_t req;
+            if (xQueueReceive(svc->requests, &req, 0) == pdTRUE)
+                handle_request(svc, &req);
+        }
+        else if (active)
+        {
+            for (size_t i = 0; i < svc->count; i++)
+                if (active == svc->sensors[i].events)
+                {
+                    handle_uart(svc, i);
+                    break;
+                }
+        }
+
+        check_timeouts(svc, &wait);
+    }
+
+    svc->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t mhz19b_async_init(mhz19b_async_t *svc, mhz19b_async_sensor_t *sensors, size_t max,
+        mhz19b_async_cb_t cb, void *ctx)
+{
+    CHECK_ARG(svc && sensors && max);
+
+    memset(svc, 0, sizeof(mhz19b_async_t));
+    memset(sensors, 0, max * sizeof(mhz19b_async_sensor_t));
+    svc->sensors = sensors;
+    svc->max = max;
+    svc->cb = cb;
+    svc->ctx = ctx;
+
+    return ESP_OK;
+}
+
+esp_err_t mhz19b_async_add(mhz19b_async_t *svc, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        size_t *index)
+{
+    CHECK_ARG(svc && svc->sensors && svc->count < svc->max && !svc->task);
+
+    mhz19b_async_sensor_t *s = svc->sensors + svc->count;
+    CHECK(mhz19b_init_events(&s->dev, uart_port, tx_gpio, rx_gpio, MHZ19B_ASYNC_EVENT_QUEUE_LEN, &s->events));
+
+    if (index)
+        *index = svc->count;
+    svc->count++;
+
+    return ESP_OK;
+}
+
+esp_err_t mhz19b_async_start(mhz19b_async_t *svc, size_t queue_size, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(svc && svc->count && queue_size && !svc->task);
+
+    esp_err_t res = ESP_ERR_NO_MEM;
+    svc->requests = xQueueCreate(queue_size, sizeof(mhz19b_async_request_t));
+    svc->set = xQueueCreateSet(queue_size + svc->count * MHZ19B_ASYNC_EVENT_QUEUE_LEN);
+    if (!svc->requests || !svc->set)
+        goto fail;
+
+    res = ESP_FAIL;
+    if (xQueueAddToSet(svc->requests, svc->set) != pdPASS)
+        goto fail;
+    for (size_t i = 0; i < svc->count; i++)
+    {
+        // events received before adding to set are not counted by set
+        xQueueReset(svc->sensors[i].events);
+        if (xQueueAddToSet(svc->sensors[i].events, svc->set) != pdPASS)
+            goto fail;
+    }
+
+    svc->running = true;
+    if (xTaskCreate(service_task, TAG, stack_size, svc, priority, &svc->task) != pdPASS)
+    {
+        svc->task = NULL;
+        res = ESP_ERR_NO_MEM;
+        goto fail;
+    }
+
+    return ESP_OK;
+
+fail:
+    mhz19b_async_stop(svc);
+    return res;
+}
+
+esp_err_t mhz19b_async_stop(mhz19b_async_t *svc)
+{
+    CHECK_ARG(svc);
+
+    svc->running = false;
+    while (svc->task)
+    {
+        // wake up the task
+        mhz19b_async_request_t req = { 0 };
+        xQueueSend(svc->requests, &req, 0);
+        vTaskDelay(1);
+    }
+
+    for (size_t i = 0; i < svc->count; i++)
+    {
+        mhz19b_async_sensor_t *s = svc->sensors + i;
+        if (svc->set)
+        {
+            // only empty queue can be removed from set
+            xQueueReset(s->events);
+            xQueueRemoveFromSet(s->events, svc->set);
+        }
+        uart_driver_delete(s->dev.uart_port);
+        mhz19b_free(&s->dev);
+    }
+    svc->count = 0;
+
+    if (svc->requests)
+    {
+        if (svc->set)
+        {
+            xQueueReset(svc->requests);
+            xQueueRemoveFromSet(svc->requests, svc->set);
+        }
+        vQueueDelete(svc->requests);
+        svc->requests = NULL;
+    }
+    if (svc->set)
+    {
+        vQueueDelete(svc->set);
+        svc->set = NULL;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t mhz19b_async_command(mhz19b_async_t *svc, size_t sensor, uint8_t cmd,
+        uint8_t b3, uint8_t b4, uint8_t b5, uint8_t b6, uint8_t b7)
+{
+    CHECK_ARG(svc && svc->requests && sensor < svc->count && cmd);
+
+    mhz19b_async_request_t req = {
+        .frame = { FRAME_START, SENSOR_ADDR, cmd, b3, b4, b5, b6, b7, 0 },
+        .sensor = sensor
+    };
+    req.frame[8] = mhz19b_calc_crc(req.frame);
+
+    return xQueueSend(svc->requests, &req, 0) == pdTRUE ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t mhz19b_async_read_co2(mhz19b_async_t *svc, size_t sensor)
+{
+    return mhz19b_async_command(svc, sensor, MHZ19B_CMD_READ_CO2, 0, 0, 0, 0, 0);
+}
+
+int16_t mhz19b_async_co2(const uint8_t *response)
+{
+    return (response[2] << 8) | response[3];
+}
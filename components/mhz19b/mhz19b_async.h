@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file mhz19b_async.h
+ * @defgroup mhz19b_async mhz19b_async
+ * @{
+ *
+ * Asynchronous event-driven reader for MH-Z19B sensors
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __MHZ19B_ASYNC_H__
+#define __MHZ19B_ASYNC_H__
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "mhz19b.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MHZ19B_ASYNC_EVENT_QUEUE_LEN 8 //!< UART event queue size per sensor
+#define MHZ19B_ASYNC_PENDING_MAX     4 //!< Commands waiting for a busy sensor
+
+/**
+ * Command request, internal
+ */
+typedef struct
+{
+    uint8_t frame[MHZ19B_SERIAL_RX_BYTES]; //!< Command frame
+    size_t sensor;                          //!< Sensor index
+} mhz19b_async_request_t;
+
+/**
+ * Sensor state
+ */
+typedef struct
+{
+    mhz19b_dev_t dev;                                            //!< Device descriptor
+    QueueHandle_t events;                                        //!< UART event queue, internal
+    uint8_t frame[MHZ19B_SERIAL_RX_BYTES];                       //!< Response being received, internal
+    size_t pos;                                                  //!< Response position, internal
+    uint8_t cmd;                                                 //!< Command waiting for response, 0 if idle, internal
+    TickType_t deadline;                                         //!< Response deadline, internal
+    mhz19b_async_request_t pending[MHZ19B_ASYNC_PENDING_MAX];    //!< Waiting commands, internal
+    size_t pending_head;                                         //!< Waiting commands head, internal
+    size_t pending_count;                                        //!< Number of waiting commands, internal
+    uint32_t errors;                                             //!< Number of bad or lost responses
+} mhz19b_async_sensor_t;
+
+struct mhz19b_async_s;
+
+/**
+ * @brief Result callback, called from the service task
+ *
+ * @param svc Service descriptor
+ * @param sensor Sensor index
+ * @param cmd Command byte
+ * @param response 9-byte response frame, valid if `result` is `ESP_OK`
+ * @param result `ESP_OK`, `ESP_ERR_TIMEOUT` or `ESP_ERR_INVALID_CRC`
+ * @param ctx Callback context
+ */
+typedef void (*mhz19b_async_cb_t)(struct mhz19b_async_s *svc, size_t sensor, uint8_t cmd,
+        const uint8_t *response, esp_err_t result, void *ctx);
+
+/**
+ * Service descriptor
+ */
+typedef struct mhz19b_async_s
+{
+    mhz19b_async_sensor_t *sensors;  //!< Sensors, added with ::mhz19b_async_add()
+    size_t count;                    //!< Number of added sensors
+    size_t max;                      //!< Size of `sensors` array
+    mhz19b_async_cb_t cb;            //!< Result callback
+    void *ctx;                       //!< Callback context
+    QueueHandle_t requests;          //!< Command queue, internal
+    QueueSetHandle_t set;            //!< Queue set, internal
+    TaskHandle_t task;               //!< Service task, internal
+    volatile bool running;           //!< Service state, internal
+} mhz19b_async_t;
+
+/**
+ * @brief Initialize service descriptor
+ *
+ * @param svc Service descriptor
+ * @param sensors Array of sensors
+ * @param max Size of sensors array
+ * @param cb Result callback
+ * @param ctx Callback context
+ * @return `ESP_OK` on success
+ */
+esp_err_t mhz19b_async_init(mhz19b_async_t *svc, mhz19b_async_sensor_t *sensors, size_t max,
+        mhz19b_async_cb_t cb, void *ctx);
+
+/**
+ * @brief Add sensor, must be called before ::mhz19b_async_start()
+ *
+ * UART driver is installed with event queue. While service is running,
+ * blocking functions of the driver must not be used with this sensor.
+ *
+ * @param svc Service descriptor
+ * @param uart_port UART port number
+ * @param tx_gpio GPIO pin number for TX
+ * @param rx_gpio GPIO pin number for RX
+ * @param[out] index Sensor index, may be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t mhz19b_async_add(mhz19b_async_t *svc, uart_port_t uart_port, gpio_num_t tx_gpio, gpio_num_t rx_gpio,
+        size_t *index);
+
+/**
+ * @brief Start service task
+ *
+ * @param svc Service descriptor
+ * @param queue_size Command queue size
+ * @param priority Service task priority
+ * @param stack_size Service task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t mhz19b_async_start(mhz19b_async_t *svc, size_t queue_size, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop service task and free sensors
+ *
+ * @param svc Service descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t mhz19b_async_stop(mhz19b_async_t *svc);
+
+/**
+ * @brief Enqueue command
+ *
+ * Result is delivered by callback.
+ *
+ * @param svc Service descriptor
+ * @param sensor Sensor index
+ * @param cmd Command byte
+ * @param b3 Byte 3
+ * @param b4 Byte 4
+ * @param b5 Byte 5
+ * @param b6 Byte 6
+ * @param b7 Byte 7
+ * @return `ESP_OK` on success, `ESP_ERR_NO_MEM` if command queue is full
+ */
+esp_err_t mhz19b_async_command(mhz19b_async_t *svc, size_t sensor, uint8_t cmd,
+        uint8_t b3, uint8_t b4, uint8_t b5, uint8_t b6, uint8_t b7);
+
+/**
+ * @brief Enqueue "Read CO2" command
+ *
+ * @param svc Service descriptor
+ * @param sensor Sensor index
+ * @return `ESP_OK` on success
+ */
+esp_err_t mhz19b_async_read_co2(mhz19b_async_t *svc, size_t sensor);
+
+/**
+ * @brief Get CO2 level from response to `MHZ19B_CMD_READ_CO2`
+ *
+ * @param response Response frame
+ * @return CO2 level, ppm
+ */
+int16_t mhz19b_async_co2(const uint8_t *response);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __MHZ19B_ASYNC_H__ */
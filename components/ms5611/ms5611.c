@@ -214,25 +214,26 @@ esp_err_t ms5611_get_sensor_data(ms5611_t *dev, int32_t *pressure, float *temper
     int32_t dt = raw_temperature - ((int32_t)dev->config_data.t_ref << 8);
     // Actual temperature (-40...85C with 0.01 resolution)
     // TEMP = 20C +dT * TEMPSENSE =2000 + dT * C6 / 2^23
-    int64_t temp = (2000 + (int64_t)dt * dev->config_data.tempsens / 8388608);
+    int32_t temp = 2000 + (int32_t)(((int64_t)dt * dev->config_data.tempsens) / 8388608);
     // Offset at actual temperature
     // OFF=OFF_t1 + TCO * dT = OFF_t1(C2) * 2^16 + (C4*dT)/2^7
-    int64_t off = (int64_t)((int64_t)dev->config_data.off * 65536)
+    int64_t off = ((int64_t)dev->config_data.off << 16)
         + (((int64_t)dev->config_data.tco * dt) / 128);
     // Sensitivity at actual temperature
     // SENS=SENS_t1 + TCS *dT = SENS_t1(C1) *2^15 + (TCS(C3) *dT)/2^8
-    int64_t sens = (int64_t)(((int64_t)dev->config_data.sens) * 32768)
+    int64_t sens = ((int64_t)dev->config_data.sens << 15)
         + (((int64_t)dev->config_data.tcs * dt) / 256);
 
     // Set defaults for temp >= 2000
-    int64_t t_2 = 0;
-    int64_t off_2 = 0;
-    int64_t sens_2 = 0;
-    int64_t help = 0;
+    // Second order terms fit into 32 bits for the whole TEMP range
+    int32_t t_2 = 0;
+    int32_t off_2 = 0;
+    int32_t sens_2 = 0;
+    int32_t help = 0;
     if (temp < 2000)
     {
         // Low temperature
-        t_2 = ((dt * dt) >> 31); // T2 = dT^2/2^31
+        t_2 = (int32_t)(((int64_t)dt * dt) >> 31); // T2 = dT^2/2^31
         help = (temp - 2000);
         help = 5 * help * help;
         off_2 = help >> 1;       // OFF_2  = 5 * (TEMP - 2000)^2/2^1
@@ -253,8 +254,9 @@ esp_err_t ms5611_get_sensor_data(ms5611_t *dev, int32_t *pressure, float *temper
 
     // Temperature compensated pressure (10...1200mbar with 0.01mbar resolution
     // P = digital pressure value  * SENS - OFF = (D1 * SENS/2^21 -OFF)/2^15
-    *pressure = (int32_t)(((int64_t)raw_pressure * (sens / 0x200000) - off) / 32768);
-    *temperature = (float)temp / 100.0;
+    // SENS/2^21 fits into 32 bits, so the product is a 32x32 multiplication
+    *pressure = (int32_t)(((int64_t)raw_pressure * (int32_t)(sens / 0x200000) - off) / 32768);
+    *temperature = (float)temp / 100.0f;
 
     return ESP_OK;
 }
@@ -21,6 +21,7 @@
  * SOFTWARE.
  */
 
+#include <stdlib.h>
 #include "noise.h"
 
 #define ALWAYS_INLINE static inline __attribute__((always_inline))
@@ -489,3 +490,455 @@ void fill_raw_noise16into8(uint8_t *pData, uint8_t num_points, uint8_t octaves,
         scx <<= 1;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// Grid fill functions
+//
+// Noise is computed row by row. Row coordinates (y, z) are eased and hashed
+// once per row, cube corner hashes are recalculated only when x crosses
+// the cell boundary.
+
+static void noise8_3d_row(uint8_t *out, size_t num, uint16_t x, int scale, uint16_t y, uint16_t z, uint8_t shift)
+{
+    uint8_t Y = y >> 8;
+    uint8_t Z = z >> 8;
+    uint8_t v = ease8InOutQuad((uint8_t)y);
+    uint8_t w = ease8InOutQuad((uint8_t)z);
+    int8_t yy = ((uint8_t)y >> 1) & 0x7F;
+    int8_t zz = ((uint8_t)z >> 1) & 0x7F;
+    uint8_t N = 0x80;
+
+    uint8_t h[8] = { 0 };
+    int cell = -1;
+
+    for (size_t i = 0; i < num; i++, x += scale)
+    {
+        uint8_t X = x >> 8;
+        if (X != cell)
+        {
+            uint8_t A  = P(X) + Y;
+            uint8_t AA = P(A) + Z;
+            uint8_t AB = P(A + 1) + Z;
+            uint8_t B  = P(X + 1) + Y;
+            uint8_t BA = P(B) + Z;
+            uint8_t BB = P(B + 1) + Z;
+            h[0] = P(AA);
+            h[1] = P(BA);
+            h[2] = P(AB);
+            h[3] = P(BB);
+            h[4] = P(AA + 1);
+            h[5] = P(BA + 1);
+            h[6] = P(AB + 1);
+            h[7] = P(BB + 1);
+            cell = X;
+        }
+
+        uint8_t u = ease8InOutQuad((uint8_t)x);
+        int8_t xx = ((uint8_t)x >> 1) & 0x7F;
+
+        int8_t X1 = lerp7by8(grad8_3d(h[0], xx, yy, zz), grad8_3d(h[1], xx - N, yy, zz), u);
+        int8_t X2 = lerp7by8(grad8_3d(h[2], xx, yy - N, zz), grad8_3d(h[3], xx - N, yy - N, zz), u);
+        int8_t X3 = lerp7by8(grad8_3d(h[4], xx, yy, zz - N), grad8_3d(h[5], xx - N, yy, zz - N), u);
+        int8_t X4 = lerp7by8(grad8_3d(h[6], xx, yy - N, zz - N), grad8_3d(h[7], xx - N, yy - N, zz - N), u);
+
+        int8_t n = lerp7by8(lerp7by8(X1, X2, v), lerp7by8(X3, X4, v), w);
+        n += 64;
+        out[i] = qadd8(out[i], qadd8(n, n) >> shift);
+    }
+}
+
+static void noise16_3d_row(uint16_t *out, size_t num, uint32_t x, int scale, uint32_t y, uint32_t z, uint8_t shift)
+{
+    uint8_t Y = (y >> 16) & 0xFF;
+    uint8_t Z = (z >> 16) & 0xFF;
+    uint16_t v = ease16InOutQuad(y & 0xFFFF);
+    uint16_t w = ease16InOutQuad(z & 0xFFFF);
+    int16_t yy = ((y & 0xFFFF) >> 1) & 0x7FFF;
+    int16_t zz = ((z & 0xFFFF) >> 1) & 0x7FFF;
+    uint16_t N = 0x8000L;
+
+    uint8_t h[8] = { 0 };
+    int cell = -1;
+
+    for (size_t i = 0; i < num; i++, x += scale)
+    {
+        uint8_t X = (x >> 16) & 0xFF;
+        if (X != cell)
+        {
+            uint8_t A  = P(X) + Y;
+            uint8_t AA = P(A) + Z;
+            uint8_t AB = P(A + 1) + Z;
+            uint8_t B  = P(X + 1) + Y;
+            uint8_t BA = P(B) + Z;
+            uint8_t BB = P(B + 1) + Z;
+            h[0] = P(AA);
+            h[1] = P(BA);
+            h[2] = P(AB);
+            h[3] = P(BB);
+            h[4] = P(AA + 1);
+            h[5] = P(BA + 1);
+            h[6] = P(AB + 1);
+            h[7] = P(BB + 1);
+            cell = X;
+        }
+
+        uint16_t u = x & 0xFFFF;
+        int16_t xx = (u >> 1) & 0x7FFF;
+        u = ease16InOutQuad(u);
+
+        int16_t X1 = lerp15by16(grad16_3d(h[0], xx, yy, zz), grad16_3d(h[1], xx - N, yy, zz), u);
+        int16_t X2 = lerp15by16(grad16_3d(h[2], xx, yy - N, zz), grad16_3d(h[3], xx - N, yy - N, zz), u);
+        int16_t X3 = lerp15by16(grad16_3d(h[4], xx, yy, zz - N), grad16_3d(h[5], xx - N, yy, zz - N), u);
+        int16_t X4 = lerp15by16(grad16_3d(h[6], xx, yy - N, zz - N), grad16_3d(h[7], xx - N, yy - N, zz - N), u);
+
+        int32_t ans = lerp15by16(lerp15by16(X1, X2, v), lerp15by16(X3, X4, v), w);
+        uint32_t pan = (uint32_t)(ans + 19052L) * 440L;
+        uint32_t accum = out[i] + (((pan >> 8) & 0xFFFF) >> shift);
+        out[i] = accum > 65535 ? 65535 : accum;
+    }
+}
+
+void fill_noise8_2d(uint8_t *data, size_t width, size_t height, uint8_t octaves,
+                    uint16_t x, int scale_x, uint16_t y, int scale_y, uint16_t time)
+{
+    for (uint8_t o = 0; o < octaves; o++)
+    {
+        uint16_t yy = y;
+        for (size_t row = 0; row < height; row++, yy += scale_y)
+            noise8_3d_row(data + row * width, width, x, scale_x, yy, time, o);
+
+        x <<= 1;
+        y <<= 1;
+        scale_x <<= 1;
+        scale_y <<= 1;
+    }
+}
+
+void fill_noise16_2d(uint16_t *data, size_t width, size_t height, uint8_t octaves,
+                     uint32_t x, int scale_x, uint32_t y, int scale_y, uint32_t time)
+{
+    for (uint8_t o = 0; o < octaves; o++)
+    {
+        uint32_t yy = y;
+        for (size_t row = 0; row < height; row++, yy += scale_y)
+            noise16_3d_row(data + row * width, width, x, scale_x, yy, time, o);
+
+        x <<= 1;
+        y <<= 1;
+        scale_x <<= 1;
+        scale_y <<= 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Simplex noise
+//
+// Integer implementation of Gustavson's simplex noise. Contributions of
+// simplex corners are summed instead of interpolated, so 2d noise needs
+// 3 corners instead of 4 and 3d noise needs 4 corners instead of 8.
+// Gradients are the same as in the Perlin noise functions above.
+
+// Skew and unskew factors, (sqrt(3) - 1) / 2 and (3 - sqrt(3)) / 6. Skewed
+// coordinates of 8.8 input reach ~700 cells, so they need more than 16 bits
+// of fraction to keep rounding errors below output resolution
+#define F2_32 1572067139UL
+#define G2_24 3545443UL
+#define G2_16 13849
+// 1/6, 0.16 fixed point
+#define G3_16 10923
+// Lattice of 3d simplex noise repeats every 768 cells, so coordinates can be
+// reduced to keep all skewed values in 32 bits
+#define PERIOD3_16 (768UL << 16)
+
+// Squared 16.16 fixed point value, distances to far corners exceed 1.0 and
+// their squares do not fit in 32 bits
+#define SQ16(v) ((int32_t)(((int64_t)(v) * (v)) >> 16))
+
+// Contribution of one 2d corner, x and y are 16.16 fixed point, result is 10.22
+ALWAYS_INLINE int32_t simplex_2d_corner(uint8_t hash, int32_t x, int32_t y)
+{
+    int32_t t = 32768 - SQ16(x) - SQ16(y);
+    if (t <= 0)
+        return 0;
+    t = (t * t) >> 16;
+    t = (t * t) >> 16;
+    // grad16_2d() returns half of dot product in 1.15 fixed point
+    return (t * grad16_2d(hash, x >> 1, y >> 1)) >> 8;
+}
+
+ALWAYS_INLINE int8_t simplex8_2d_raw(uint16_t x, uint16_t y)
+{
+    // Skew input space to find the simplex cell, internally coordinates are 16.16
+    uint32_t s = ((uint64_t)(x + y) * F2_32) >> 24;
+    uint32_t i = (((uint32_t)x << 8) + s) >> 16;
+    uint32_t j = (((uint32_t)y << 8) + s) >> 16;
+
+    // Unskewed distances from the cell origin
+    uint32_t t = ((i + j) * G2_24) >> 8;
+    int32_t x0 = (int32_t)(((uint32_t)x << 8) - (i << 16) + t);
+    int32_t y0 = (int32_t)(((uint32_t)y << 8) - (j << 16) + t);
+
+    // Middle corner of the simplex
+    uint8_t i1 = x0 > y0;
+    uint8_t j1 = !i1;
+
+    int32_t x1 = x0 - ((int32_t)i1 << 16) + G2_16;
+    int32_t y1 = y0 - ((int32_t)j1 << 16) + G2_16;
+    int32_t x2 = x0 - 0x10000 + 2 * G2_16;
+    int32_t y2 = y0 - 0x10000 + 2 * G2_16;
+
+    uint8_t I = i, J = j;
+    int32_t n = simplex_2d_corner(P((uint8_t)(P(I) + J)), x0, y0)
+              + simplex_2d_corner(P((uint8_t)(P((uint8_t)(I + i1)) + J + j1)), x1, y1)
+              + simplex_2d_corner(P((uint8_t)(P((uint8_t)(I + 1)) + J + 1)), x2, y2);
+
+    // Sum of corners is in -1/70..1/70 range, scale it to int8
+    n = (n * 70) >> 15;
+    return n > 127 ? 127 : n < -128 ? -128 : n;
+}
+
+// Contribution of one 3d corner, coordinates are 16.16 fixed point, result is 16.16
+ALWAYS_INLINE int32_t simplex_3d_corner(uint8_t hash, int32_t x, int32_t y, int32_t z)
+{
+    int32_t t = 39322 - SQ16(x) - SQ16(y) - SQ16(z);
+    if (t <= 0)
+        return 0;
+    t = (t * t) >> 16;
+    t = (t * t) >> 16;
+    // grad16_3d() returns half of dot product in 1.15 fixed point
+    return (t * grad16_3d(hash, x >> 1, y >> 1, z >> 1)) >> 14;
+}
+
+ALWAYS_INLINE int16_t simplex16_3d_raw(uint32_t x, uint32_t y, uint32_t z)
+{
+    x %= PERIOD3_16;
+    y %= PERIOD3_16;
+    z %= PERIOD3_16;
+
+    // Skew input space to find the simplex cell
+    uint32_t s = (x + y + z) / 3;
+    uint32_t i = (x + s) >> 16;
+    uint32_t j = (y + s) >> 16;
+    uint32_t k = (z + s) >> 16;
+
+    // Unskewed distances from the cell origin
+    uint32_t t = ((i + j + k) << 15) / 3;
+    int32_t x0 = (int32_t)(x - (i << 16) + t);
+    int32_t y0 = (int32_t)(y - (j << 16) + t);
+    int32_t z0 = (int32_t)(z - (k << 16) + t);
+
+    // Second and third corners of the simplex
+    uint8_t i1, j1, k1, i2, j2, k2;
+    if (x0 >= y0)
+    {
+        if (y0 >= z0)
+        {
+            i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+        }
+        else if (x0 >= z0)
+        {
+            i1 = 1; j1 = 0; k1 = 0; i2 = 1; j2 = 0; k2 = 1;
+        }
+        else
+        {
+            i1 = 0; j1 = 0; k1 = 1; i2 = 1; j2 = 0; k2 = 1;
+        }
+    }
+    else
+    {
+        if (y0 < z0)
+        {
+            i1 = 0; j1 = 0; k1 = 1; i2 = 0; j2 = 1; k2 = 1;
+        }
+        else if (x0 < z0)
+        {
+            i1 = 0; j1 = 1; k1 = 0; i2 = 0; j2 = 1; k2 = 1;
+        }
+        else
+        {
+            i1 = 0; j1 = 1; k1 = 0; i2 = 1; j2 = 1; k2 = 0;
+        }
+    }
+
+    int32_t x1 = x0 - ((int32_t)i1 << 16) + G3_16;
+    int32_t y1 = y0 - ((int32_t)j1 << 16) + G3_16;
+    int32_t z1 = z0 - ((int32_t)k1 << 16) + G3_16;
+    int32_t x2 = x0 - ((int32_t)i2 << 16) + 2 * G3_16;
+    int32_t y2 = y0 - ((int32_t)j2 << 16) + 2 * G3_16;
+    int32_t z2 = z0 - ((int32_t)k2 << 16) + 2 * G3_16;
+    int32_t x3 = x0 - 0x8000;
+    int32_t y3 = y0 - 0x8000;
+    int32_t z3 = z0 - 0x8000;
+
+    uint8_t I = i, J = j, K = k;
+    int32_t n = simplex_3d_corner(P((uint8_t)(P((uint8_t)(P(I) + J)) + K)), x0, y0, z0)
+              + simplex_3d_corner(P((uint8_t)(P((uint8_t)(P((uint8_t)(I + i1)) + J + j1)) + K + k1)), x1, y1, z1)
+              + simplex_3d_corner(P((uint8_t)(P((uint8_t)(P((uint8_t)(I + i2)) + J + j2)) + K + k2)), x2, y2, z2)
+              + simplex_3d_corner(P((uint8_t)(P((uint8_t)(P((uint8_t)(I + 1)) + J + 1)) + K + 1)), x3, y3, z3);
+
+    // Sum of corners is in -1/32..1/32 range, scale it to int16
+    n <<= 4;
+    return n > 32767 ? 32767 : n < -32768 ? -32768 : n;
+}
+
+int8_t snoise8_2d_raw(uint16_t x, uint16_t y)
+{
+    return simplex8_2d_raw(x, y);
+}
+
+uint8_t snoise8_2d(uint16_t x, uint16_t y)
+{
+    return simplex8_2d_raw(x, y) + 128;
+}
+
+int16_t snoise16_3d_raw(uint32_t x, uint32_t y, uint32_t z)
+{
+    return simplex16_3d_raw(x, y, z);
+}
+
+uint16_t snoise16_3d(uint32_t x, uint32_t y, uint32_t z)
+{
+    return simplex16_3d_raw(x, y, z) + 32768;
+}
+
+void fill_snoise8_2d(uint8_t *data, size_t width, size_t height, uint8_t octaves,
+                     uint16_t x, int scale_x, uint16_t y, int scale_y)
+{
+    for (uint8_t o = 0; o < octaves; o++)
+    {
+        uint8_t *out = data;
+        uint16_t yy = y;
+        for (size_t row = 0; row < height; row++, yy += scale_y)
+        {
+            uint16_t xx = x;
+            for (size_t col = 0; col < width; col++, xx += scale_x, out++)
+                *out = qadd8(*out, (uint8_t)(simplex8_2d_raw(xx, yy) + 128) >> o);
+        }
+
+        x <<= 1;
+        y <<= 1;
+        scale_x <<= 1;
+        scale_y <<= 1;
+    }
+}
+
+void fill_snoise16_3d(uint16_t *data, size_t width, size_t height, uint8_t octaves,
+                      uint32_t x, int scale_x, uint32_t y, int scale_y, uint32_t time)
+{
+    for (uint8_t o = 0; o < octaves; o++)
+    {
+        uint16_t *out = data;
+        uint32_t yy = y;
+        for (size_t row = 0; row < height; row++, yy += scale_y)
+        {
+            uint32_t xx = x;
+            for (size_t col = 0; col < width; col++, xx += scale_x, out++)
+            {
+                uint32_t accum = *out + ((uint16_t)(simplex16_3d_raw(xx, yy, time) + 32768) >> o);
+                *out = accum > 65535 ? 65535 : accum;
+            }
+        }
+
+        x <<= 1;
+        y <<= 1;
+        scale_x <<= 1;
+        scale_y <<= 1;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Noise field with cross-frame cache
+
+// Per-pixel data which does not change while time stays inside the lattice cell
+typedef struct
+{
+    uint8_t h[8];   // cube corner hashes
+    uint8_t u, v;   // eased fractions
+    int8_t xx, yy;  // signed fractions for grad function
+} noise8_cell_t;
+
+bool noise8_field_init(noise8_field_t *field, size_t width, size_t height)
+{
+    field->cache = malloc(width * height * sizeof(noise8_cell_t));
+    if (!field->cache)
+        return false;
+    field->width = width;
+    field->height = height;
+    noise8_field_set_origin(field, 0, 1, 0, 1);
+    return true;
+}
+
+void noise8_field_free(noise8_field_t *field)
+{
+    free(field->cache);
+    field->cache = NULL;
+}
+
+void noise8_field_set_origin(noise8_field_t *field, uint16_t x, int scale_x, uint16_t y, int scale_y)
+{
+    field->x = x;
+    field->scale_x = scale_x;
+    field->y = y;
+    field->scale_y = scale_y;
+    field->valid = false;
+}
+
+static void field_update(noise8_field_t *field, uint8_t Z)
+{
+    noise8_cell_t *c = (noise8_cell_t *)field->cache;
+    uint16_t y = field->y;
+    for (size_t row = 0; row < field->height; row++, y += field->scale_y)
+    {
+        uint8_t Y = y >> 8;
+        uint16_t x = field->x;
+        for (size_t col = 0; col < field->width; col++, x += field->scale_x, c++)
+        {
+            uint8_t X = x >> 8;
+            uint8_t A  = P(X) + Y;
+            uint8_t AA = P(A) + Z;
+            uint8_t AB = P(A + 1) + Z;
+            uint8_t B  = P(X + 1) + Y;
+            uint8_t BA = P(B) + Z;
+            uint8_t BB = P(B + 1) + Z;
+            c->h[0] = P(AA);
+            c->h[1] = P(BA);
+            c->h[2] = P(AB);
+            c->h[3] = P(BB);
+            c->h[4] = P(AA + 1);
+            c->h[5] = P(BA + 1);
+            c->h[6] = P(AB + 1);
+            c->h[7] = P(BB + 1);
+            c->u = ease8InOutQuad((uint8_t)x);
+            c->v = ease8InOutQuad((uint8_t)y);
+            c->xx = ((uint8_t)x >> 1) & 0x7F;
+            c->yy = ((uint8_t)y >> 1) & 0x7F;
+        }
+    }
+    field->cell = Z;
+    field->valid = true;
+}
+
+void noise8_field_fill(noise8_field_t *field, uint8_t *data, uint16_t time)
+{
+    uint8_t Z = time >> 8;
+    if (!field->valid || field->cell != Z)
+        field_update(field, Z);
+
+    uint8_t w = ease8InOutQuad((uint8_t)time);
+    int8_t zz = ((uint8_t)time >> 1) & 0x7F;
+    uint8_t N = 0x80;
+
+    const noise8_cell_t *c = (const noise8_cell_t *)field->cache;
+    for (size_t i = 0; i < field->width * field->height; i++, c++)
+    {
+        int8_t xx = c->xx, yy = c->yy;
+        int8_t X1 = lerp7by8(grad8_3d(c->h[0], xx, yy, zz), grad8_3d(c->h[1], xx - N, yy, zz), c->u);
+        int8_t X2 = lerp7by8(grad8_3d(c->h[2], xx, yy - N, zz), grad8_3d(c->h[3], xx - N, yy - N, zz), c->u);
+        int8_t X3 = lerp7by8(grad8_3d(c->h[4], xx, yy, zz - N), grad8_3d(c->h[5], xx - N, yy, zz - N), c->u);
+        int8_t X4 = lerp7by8(grad8_3d(c->h[6], xx, yy - N, zz - N), grad8_3d(c->h[7], xx - N, yy - N, zz - N), c->u);
+
+        int8_t n = lerp7by8(lerp7by8(X1, X2, c->v), lerp7by8(X3, X4, c->v), w);
+        n += 64;
+        data[i] = qadd8(n, n);
+    }
+}
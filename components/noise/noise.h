@@ -24,6 +24,8 @@
 #ifndef __NOISE_H__
 #define __NOISE_H__
 
+#include <stddef.h>
+#include <stdbool.h>
 #include <lib8tion.h>
 
 ///@file noise.h
@@ -72,6 +74,21 @@ int8_t inoise8_2d_raw(uint16_t x, uint16_t y);
 int8_t inoise8_1d_raw(uint16_t x);
 ///@}
 
+/// @name simplex noise functions
+///@{
+/// Fixed point implementation of Gustavson's simplex noise. Sums contributions of
+/// 3 (2d) or 4 (3d) simplex corners instead of interpolating 4 or 8 cube corners,
+/// so it's cheaper per sample and has less directional artifacts. Coordinates
+/// have the same format as in the Perlin noise functions. Scaled functions return
+/// 0-255 and 0-65535, raw functions return values in full int8 and int16 range.
+/// The results differ from inoise8_2d() and inoise16_3d(), the functions are
+/// not drop-in replacements. 3d noise repeats every 768 lattice cells.
+uint8_t snoise8_2d(uint16_t x, uint16_t y);
+int8_t snoise8_2d_raw(uint16_t x, uint16_t y);
+uint16_t snoise16_3d(uint32_t x, uint32_t y, uint32_t z);
+int16_t snoise16_3d_raw(uint32_t x, uint32_t y, uint32_t z);
+///@}
+
 ///@name raw fill functions
 ///@{
 /// Raw noise fill functions - fill into a 1d or 2d array of 8-bit values using either 8-bit noise or 16-bit noise
@@ -87,6 +104,65 @@ int8_t inoise8_1d_raw(uint16_t x);
 void fill_raw_noise8(uint8_t *pData, uint8_t num_points, uint8_t octaves, uint16_t x, int scale, uint16_t time);
 void fill_raw_noise16into8(uint8_t *pData, uint8_t num_points, uint8_t octaves, uint32_t x, int scale, uint32_t time);
 ///@}
+
+///@name grid fill functions
+///@{
+/// Fill 2d row-major array of width * height values with 3d noise (x, y, time), much faster
+/// than calling point functions for every element. Noise is added to the array with
+/// saturation, so clear it first. Every next octave has half amplitude and double frequency.
+///@param data the array of data to write into
+///@param width number of columns
+///@param height number of rows
+///@param octaves the number of octaves to use for noise
+///@param x the x position of the first column in the noise field
+///@param scale_x the distance between x points
+///@param y the y position of the first row in the noise field
+///@param scale_y the distance between y points
+///@param time the time position for the noise field
+///
+/// With one octave and zeroed array the result is the same as from inoise8_3d() or inoise16_3d().
+void fill_noise8_2d(uint8_t *data, size_t width, size_t height, uint8_t octaves,
+                    uint16_t x, int scale_x, uint16_t y, int scale_y, uint16_t time);
+void fill_noise16_2d(uint16_t *data, size_t width, size_t height, uint8_t octaves,
+                     uint32_t x, int scale_x, uint32_t y, int scale_y, uint32_t time);
+
+/// Same as fill_noise8_2d() but with 2d simplex noise, same values as snoise8_2d(x, y)
+void fill_snoise8_2d(uint8_t *data, size_t width, size_t height, uint8_t octaves,
+                     uint16_t x, int scale_x, uint16_t y, int scale_y);
+/// Same as fill_noise16_2d() but with 3d simplex noise, same values as snoise16_3d(x, y, time)
+void fill_snoise16_3d(uint16_t *data, size_t width, size_t height, uint8_t octaves,
+                      uint32_t x, int scale_x, uint32_t y, int scale_y, uint32_t time);
+///@}
+
+///@name animated noise field
+///@{
+/// 8 bit 3d noise field of fixed geometry, animated by time. Lattice hashes and
+/// fractions of every pixel are cached and recalculated only when time crosses
+/// the lattice cell boundary (every 256 time units) or origin is changed, so slowly
+/// evolving noise costs only interpolation per pixel per frame. Cache takes
+/// 12 bytes per pixel.
+typedef struct
+{
+    size_t width;      ///< Number of columns
+    size_t height;     ///< Number of rows
+    uint16_t x;        ///< X position of the first column
+    int scale_x;       ///< Distance between x points
+    uint16_t y;        ///< Y position of the first row
+    int scale_y;       ///< Distance between y points
+    uint8_t cell;      ///< Internal: time lattice cell of the cache
+    bool valid;        ///< Internal: cache is filled
+    void *cache;       ///< Internal: per-pixel data
+} noise8_field_t;
+
+/// Allocate cache, returns false if there is not enough memory
+bool noise8_field_init(noise8_field_t *field, size_t width, size_t height);
+/// Free cache
+void noise8_field_free(noise8_field_t *field);
+/// Set position and scale of the field, invalidates cache
+void noise8_field_set_origin(noise8_field_t *field, uint16_t x, int scale_x, uint16_t y, int scale_y);
+/// Fill row-major array of width * height values, same values as inoise8_3d(x, y, time)
+void noise8_field_fill(noise8_field_t *field, uint8_t *data, uint16_t time);
+///@}
 ///@}
 
 #endif /* __NOISE_H__ */
@@ -52,31 +52,56 @@
 #include <string.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_attr.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
+#include <esp_idf_lib_crit_stats.h>
 #include "onewire.h"
 
+#if CONFIG_ONEWIRE_RMT
+#include <driver/rmt.h>
+#include <freertos/ringbuf.h>
+#include <soc/gpio_periph.h>
+#include <soc/gpio_struct.h>
+#include <soc/io_mux_reg.h>
+#endif
+
 #define ONEWIRE_SELECT_ROM 0x55
 #define ONEWIRE_SKIP_ROM   0xcc
 #define ONEWIRE_SEARCH     0xf0
+#define ONEWIRE_ALARM_SEARCH 0xec
+#define ONEWIRE_OVERDRIVE_SKIP_ROM   0x3c
+#define ONEWIRE_OVERDRIVE_SELECT_ROM 0x69
+
+ESP_IDF_LIB_CRIT_STATS_DEFINE(crit_stats, "onewire");
 
 #if HELPER_TARGET_IS_ESP8266
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(); } while (0)
 #define OPEN_DRAIN_MODE GPIO_MODE_OUTPUT_OD
 
 #elif HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(&mux); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(&mux); } while (0)
 #define OPEN_DRAIN_MODE GPIO_MODE_INPUT_OUTPUT_OD
 #else
 #error BUG: Unknown target
 #endif
 
+#if HELPER_TARGET_IS_ESP32 && CONFIG_ONEWIRE_IRAM
+// noinline keeps slot functions out of their callers in flash
+#define ONEWIRE_IRAM_ATTR IRAM_ATTR __attribute__((noinline))
+#define ONEWIRE_IRAM_DATA DRAM_ATTR
+#else
+#define ONEWIRE_IRAM_ATTR
+#define ONEWIRE_IRAM_DATA
+#endif
+
 // Waits up to `max_wait` microseconds for the specified pin to go high.
 // Returns true if successful, false if the bus never comes high (likely
 // shorted).
-static inline bool _onewire_wait_for_bus(gpio_num_t pin, int max_wait)
+static bool ONEWIRE_IRAM_ATTR _onewire_wait_for_bus(gpio_num_t pin, int max_wait)
 {
     bool state;
     for (int i = 0; i < ((max_wait + 4) / 5); i++)
@@ -98,14 +123,315 @@ static void setup_pin(gpio_num_t pin, bool open_drain)
     gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
 }
 
+// Bit-banging slot timing, us (see Maxim Application Note 126)
+typedef struct
+{
+    uint16_t reset_low;
+    uint16_t reset_sample;
+    uint16_t reset_tail;
+    uint8_t write_1_low;
+    uint8_t write_1_high;
+    uint8_t write_0_low;
+    uint8_t read_low;
+    uint8_t read_sample;
+    uint8_t read_tail;
+} timing_t;
+
+static ONEWIRE_IRAM_DATA const timing_t timings[] = {
+    [ONEWIRE_SPEED_STANDARD] = {
+        .reset_low = 480, .reset_sample = 70, .reset_tail = 410,
+        .write_1_low = 10, .write_1_high = 55, .write_0_low = 65,
+        .read_low = 2, .read_sample = 11, .read_tail = 48,
+    },
+    [ONEWIRE_SPEED_OVERDRIVE] = {
+        .reset_low = 70, .reset_sample = 9, .reset_tail = 40,
+        .write_1_low = 1, .write_1_high = 7, .write_0_low = 8,
+        .read_low = 1, .read_sample = 1, .read_tail = 7,
+    },
+};
+
+// Bit per GPIO, set if the bus is in overdrive
+static uint64_t overdrive_pins;
+
+static inline onewire_speed_t pin_speed(gpio_num_t pin)
+{
+    return (overdrive_pins >> pin) & 1 ? ONEWIRE_SPEED_OVERDRIVE : ONEWIRE_SPEED_STANDARD;
+}
+
+#if CONFIG_ONEWIRE_RMT
+
+#define RMT_CLK_DIV        8    // 0.1 us per tick with 80 MHz APB clock
+#define RMT_RX_BUF_SIZE    512
+#define RMT_RX_TIMEOUT_MS  10
+
+// RMT slot timing, RMT ticks
+typedef struct
+{
+    uint16_t reset_low;
+    uint16_t reset_wait;
+    uint16_t reset_idle;   // must be longer than reset_low
+    uint16_t slot_idle;    // must be longer than the high part of any slot
+    uint16_t write_1_low;
+    uint16_t write_0_low;
+    uint16_t read_low;
+    uint16_t read_sample;  // bus released before this is a 1
+    uint16_t slot;
+    uint8_t filter;        // RX glitch filter, APB ticks
+} rmt_timing_t;
+
+static const rmt_timing_t rmt_timings[] = {
+    [ONEWIRE_SPEED_STANDARD] = {
+        .reset_low = 4800, .reset_wait = 700, .reset_idle = 5500, .slot_idle = 800,
+        .write_1_low = 60, .write_0_low = 600, .read_low = 60, .read_sample = 150,
+        .slot = 700, .filter = 100,
+    },
+    [ONEWIRE_SPEED_OVERDRIVE] = {
+        .reset_low = 700, .reset_wait = 85, .reset_idle = 800, .slot_idle = 120,
+        .write_1_low = 10, .write_0_low = 75, .read_low = 10, .read_sample = 15,
+        .slot = 100, .filter = 30,
+    },
+};
+
+typedef struct
+{
+    bool used;
+    gpio_num_t pin;
+    rmt_channel_t tx;
+    rmt_channel_t rx;
+    RingbufHandle_t rb;
+    onewire_speed_t speed;  // speed the RX filter is set for
+} rmt_bus_t;
+
+static rmt_bus_t rmt_buses[CONFIG_ONEWIRE_RMT_MAX_BUSES];
+
+static rmt_bus_t *rmt_find_bus(gpio_num_t pin)
+{
+    for (size_t i = 0; i < CONFIG_ONEWIRE_RMT_MAX_BUSES; i++)
+        if (rmt_buses[i].used && rmt_buses[i].pin == pin)
+            return &rmt_buses[i];
+    return NULL;
+}
+
+static inline rmt_item32_t rmt_slot(const rmt_timing_t *t, uint32_t low)
+{
+    rmt_item32_t item = {
+        .level0 = 0,
+        .duration0 = low,
+        .level1 = 1,
+        .duration1 = t->slot - low
+    };
+    return item;
+}
+
+// Send `count` items and capture the bus while doing so. Durations of the
+// low phases seen on the bus (including the ones we have generated
+// ourselves) are stored to `lows`. Returns number of the low phases or
+// -1 on error.
+static int rmt_transfer(rmt_bus_t *bus, const rmt_item32_t *items, size_t count,
+        uint16_t *lows, size_t max_lows, uint16_t idle)
+{
+    size_t size;
+    rmt_item32_t *rx;
+
+    onewire_speed_t speed = pin_speed(bus->pin);
+    if (bus->speed != speed)
+    {
+        if (rmt_set_rx_filter(bus->rx, true, rmt_timings[speed].filter) != ESP_OK)
+            return -1;
+        bus->speed = speed;
+    }
+
+    // drop leftovers of a timed out transfer
+    while ((rx = xRingbufferReceive(bus->rb, &size, 0)) != NULL)
+        vRingbufferReturnItem(bus->rb, rx);
+
+    if (rmt_set_rx_idle_thresh(bus->rx, idle) != ESP_OK || rmt_rx_start(bus->rx, true) != ESP_OK)
+        return -1;
+
+    if (rmt_write_items(bus->tx, items, count, true) != ESP_OK)
+    {
+        rmt_rx_stop(bus->rx);
+        return -1;
+    }
+
+    int res = -1;
+    rx = xRingbufferReceive(bus->rb, &size, pdMS_TO_TICKS(RMT_RX_TIMEOUT_MS));
+    if (rx)
+    {
+        size_t found = 0;
+        for (size_t i = 0; i < size / sizeof(rmt_item32_t); i++)
+        {
+            if (!rx[i].level0 && rx[i].duration0 && found < max_lows)
+                lows[found++] = rx[i].duration0;
+            if (!rx[i].level1 && rx[i].duration1 && found < max_lows)
+                lows[found++] = rx[i].duration1;
+        }
+        vRingbufferReturnItem(bus->rb, rx);
+        res = found;
+    }
+    rmt_rx_stop(bus->rx);
+
+    return res;
+}
+
+static bool rmt_reset(rmt_bus_t *bus)
+{
+    const rmt_timing_t *t = &rmt_timings[pin_speed(bus->pin)];
+    rmt_item32_t item = {
+        .level0 = 0,
+        .duration0 = t->reset_low,
+        .level1 = 1,
+        .duration1 = t->reset_wait
+    };
+    uint16_t lows[2];
+
+    // The first low phase is our reset pulse, the next one is presence
+    return rmt_transfer(bus, &item, 1, lows, 2, t->reset_idle) == 2;
+}
+
+static bool rmt_write_bits(rmt_bus_t *bus, uint8_t v, size_t bits)
+{
+    const rmt_timing_t *t = &rmt_timings[pin_speed(bus->pin)];
+    rmt_item32_t items[8];
+
+    for (size_t i = 0; i < bits; i++, v >>= 1)
+        items[i] = rmt_slot(t, v & 1 ? t->write_1_low : t->write_0_low);
+
+    return rmt_write_items(bus->tx, items, bits, true) == ESP_OK;
+}
+
+static int rmt_read_bits(rmt_bus_t *bus, size_t bits)
+{
+    const rmt_timing_t *t = &rmt_timings[pin_speed(bus->pin)];
+    rmt_item32_t items[8];
+    uint16_t lows[9];
+
+    for (size_t i = 0; i < bits; i++)
+        items[i] = rmt_slot(t, t->read_low);
+
+    if (rmt_transfer(bus, items, bits, lows, bits + 1, t->slot_idle) != (int)bits)
+        return -1;
+
+    int r = 0;
+    for (size_t i = 0; i < bits; i++)
+        if (lows[i] < t->read_sample)
+            r |= 1 << i;
+
+    return r;
+}
+
+esp_err_t onewire_rmt_init(gpio_num_t pin, rmt_channel_t tx_channel, rmt_channel_t rx_channel)
+{
+    if (rmt_find_bus(pin))
+        return ESP_ERR_INVALID_STATE;
+
+    rmt_bus_t *bus = NULL;
+    for (size_t i = 0; i < CONFIG_ONEWIRE_RMT_MAX_BUSES && !bus; i++)
+        if (!rmt_buses[i].used)
+            bus = &rmt_buses[i];
+    if (!bus)
+        return ESP_ERR_NO_MEM;
+
+    rmt_config_t rx_cfg = {
+        .rmt_mode = RMT_MODE_RX,
+        .channel = rx_channel,
+        .gpio_num = pin,
+        .clk_div = RMT_CLK_DIV,
+        .mem_block_num = 1,
+        .rx_config = {
+            .filter_en = true,
+            .filter_ticks_thresh = rmt_timings[ONEWIRE_SPEED_STANDARD].filter,
+            .idle_threshold = rmt_timings[ONEWIRE_SPEED_STANDARD].reset_idle,
+        }
+    };
+    rmt_config_t tx_cfg = {
+        .rmt_mode = RMT_MODE_TX,
+        .channel = tx_channel,
+        .gpio_num = pin,
+        .clk_div = RMT_CLK_DIV,
+        .mem_block_num = 1,
+        .tx_config = {
+            .idle_output_en = true,
+            .idle_level = RMT_IDLE_LEVEL_HIGH,
+        }
+    };
+
+    // RX goes first: configuring it disconnects any output from the pin
+    esp_err_t r = rmt_config(&rx_cfg);
+    if (r == ESP_OK)
+        r = rmt_config(&tx_cfg);
+    if (r == ESP_OK)
+        r = rmt_driver_install(rx_channel, RMT_RX_BUF_SIZE, 0);
+    if (r != ESP_OK)
+        return r;
+    r = rmt_driver_install(tx_channel, 0, 0);
+    if (r == ESP_OK)
+        r = rmt_get_ringbuf_handle(rx_channel, &bus->rb);
+    if (r != ESP_OK)
+    {
+        rmt_driver_uninstall(tx_channel);
+        rmt_driver_uninstall(rx_channel);
+        return r;
+    }
+
+    // Configuring TX has disabled the input path, re-enable it for RX and
+    // make the pad open drain, so idle TX releases the bus
+    PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);
+    GPIO.pin[pin].pad_driver = 1;
+    gpio_set_pull_mode(pin, GPIO_PULLUP_ONLY);
+
+    bus->pin = pin;
+    bus->tx = tx_channel;
+    bus->rx = rx_channel;
+    bus->speed = ONEWIRE_SPEED_STANDARD;
+    bus->used = true;
+
+    return ESP_OK;
+}
+
+esp_err_t onewire_rmt_free(gpio_num_t pin)
+{
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (!bus)
+        return ESP_ERR_INVALID_ARG;
+
+    bus->used = false;
+    esp_err_t r = rmt_driver_uninstall(bus->tx);
+    esp_err_t r2 = rmt_driver_uninstall(bus->rx);
+    setup_pin(pin, true);
+
+    return r != ESP_OK ? r : r2;
+}
+
+bool onewire_rmt_attached(gpio_num_t pin)
+{
+    return rmt_find_bus(pin) != NULL;
+}
+
+#endif /* CONFIG_ONEWIRE_RMT */
+
 // Perform the onewire reset function.  We will wait up to 250uS for
 // the bus to come high, if it doesn't then it is broken or shorted
 // and we return false;
 //
 // Returns true if a device asserted a presence pulse, false otherwise.
 //
-bool onewire_reset(gpio_num_t pin)
+static bool ONEWIRE_IRAM_ATTR _onewire_reset(gpio_num_t pin)
 {
+#if CONFIG_ONEWIRE_RMT
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (bus)
+    {
+        GPIO.pin[pin].pad_driver = 1; // depower
+        if (!_onewire_wait_for_bus(pin, 250))
+            return false;
+        bool r = rmt_reset(bus);
+        return _onewire_wait_for_bus(pin, timings[pin_speed(pin)].reset_tail) && r;
+    }
+#endif
+
+    const timing_t *t = &timings[pin_speed(pin)];
+
     setup_pin(pin, true);
 
     gpio_set_level(pin, 1);
@@ -114,37 +440,52 @@ bool onewire_reset(gpio_num_t pin)
         return false;
 
     gpio_set_level(pin, 0);
-    ets_delay_us(480);
+    ets_delay_us(t->reset_low);
 
     PORT_ENTER_CRITICAL;
     gpio_set_level(pin, 1); // allow it to float
-    ets_delay_us(70);
+    ets_delay_us(t->reset_sample);
     bool r = !gpio_get_level(pin);
     PORT_EXIT_CRITICAL;
 
     // Wait for all devices to finish pulling the bus low before returning
-    if (!_onewire_wait_for_bus(pin, 410))
+    if (!_onewire_wait_for_bus(pin, t->reset_tail))
         return false;
 
     return r;
 }
 
-static bool _onewire_write_bit(gpio_num_t pin, bool v)
+bool onewire_reset(gpio_num_t pin)
+{
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_ONEWIRE, pin);
+    bool r = _onewire_reset(pin);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_ONEWIRE);
+
+    return r;
+}
+
+static bool ONEWIRE_IRAM_ATTR _onewire_write_bit(gpio_num_t pin, bool v)
 {
     if (!_onewire_wait_for_bus(pin, 10))
         return false;
+#if CONFIG_ONEWIRE_RMT
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (bus)
+        return rmt_write_bits(bus, v, 1);
+#endif
+    const timing_t *t = &timings[pin_speed(pin)];
     PORT_ENTER_CRITICAL;
     if (v)
     {
         gpio_set_level(pin, 0);  // drive output low
-        ets_delay_us(10);
+        ets_delay_us(t->write_1_low);
         gpio_set_level(pin, 1);  // allow output high
-        ets_delay_us(55);
+        ets_delay_us(t->write_1_high);
     }
     else
     {
         gpio_set_level(pin, 0);  // drive output low
-        ets_delay_us(65);
+        ets_delay_us(t->write_0_low);
         gpio_set_level(pin, 1); // allow output high
     }
     ets_delay_us(1);
@@ -153,18 +494,24 @@ static bool _onewire_write_bit(gpio_num_t pin, bool v)
     return true;
 }
 
-static int _onewire_read_bit(gpio_num_t pin)
+static int ONEWIRE_IRAM_ATTR _onewire_read_bit(gpio_num_t pin)
 {
     if (!_onewire_wait_for_bus(pin, 10))
         return -1;
+#if CONFIG_ONEWIRE_RMT
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (bus)
+        return rmt_read_bits(bus, 1);
+#endif
 
+    const timing_t *t = &timings[pin_speed(pin)];
     PORT_ENTER_CRITICAL;
     gpio_set_level(pin, 0);
-    ets_delay_us(2);
+    ets_delay_us(t->read_low);
     gpio_set_level(pin, 1);  // let pin float, pull up will raise
-    ets_delay_us(11);
-    int r = gpio_get_level(pin);  // Must sample within 15us of start
-    ets_delay_us(48);
+    ets_delay_us(t->read_sample);
+    int r = gpio_get_level(pin);  // Must sample within 15us (2us in overdrive) of start
+    ets_delay_us(t->read_tail);
     PORT_EXIT_CRITICAL;
 
     return r;
@@ -175,8 +522,14 @@ static int _onewire_read_bit(gpio_num_t pin)
 // power after the write (e.g. DS18B20 in parasite power mode) then call
 // onewire_power() after this is complete to actively drive the line high.
 //
-bool onewire_write(gpio_num_t pin, uint8_t v)
+static bool ONEWIRE_IRAM_ATTR _onewire_write(gpio_num_t pin, uint8_t v)
 {
+#if CONFIG_ONEWIRE_RMT
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (bus)
+        return _onewire_wait_for_bus(pin, 10) && rmt_write_bits(bus, v, 8);
+#endif
+
     for (uint8_t bitMask = 0x01; bitMask; bitMask <<= 1)
         if (!_onewire_write_bit(pin, (bitMask & v)))
             return false;
@@ -184,6 +537,15 @@ bool onewire_write(gpio_num_t pin, uint8_t v)
     return true;
 }
 
+bool onewire_write(gpio_num_t pin, uint8_t v)
+{
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_ONEWIRE, pin);
+    bool r = _onewire_write(pin, v);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_ONEWIRE);
+
+    return r;
+}
+
 bool onewire_write_bytes(gpio_num_t pin, const uint8_t *buf, size_t count)
 {
     for (size_t i = 0; i < count; i++)
@@ -195,8 +557,14 @@ bool onewire_write_bytes(gpio_num_t pin, const uint8_t *buf, size_t count)
 
 // Read a byte
 //
-int onewire_read(gpio_num_t pin)
+static int ONEWIRE_IRAM_ATTR _onewire_read(gpio_num_t pin)
 {
+#if CONFIG_ONEWIRE_RMT
+    rmt_bus_t *bus = rmt_find_bus(pin);
+    if (bus)
+        return _onewire_wait_for_bus(pin, 10) ? rmt_read_bits(bus, 8) : -1;
+#endif
+
     int r = 0;
 
     for (uint8_t bitMask = 0x01; bitMask; bitMask <<= 1)
@@ -210,6 +578,15 @@ int onewire_read(gpio_num_t pin)
     return r;
 }
 
+int onewire_read(gpio_num_t pin)
+{
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_ONEWIRE, pin);
+    int r = _onewire_read(pin);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_ONEWIRE);
+
+    return r;
+}
+
 bool onewire_read_bytes(gpio_num_t pin, uint8_t *buf, size_t count)
 {
     size_t i;
@@ -247,6 +624,53 @@ bool onewire_skip_rom(gpio_num_t pin)
     return onewire_write(pin, ONEWIRE_SKIP_ROM);
 }
 
+void onewire_set_speed(gpio_num_t pin, onewire_speed_t speed)
+{
+    PORT_ENTER_CRITICAL;
+    if (speed == ONEWIRE_SPEED_OVERDRIVE)
+        overdrive_pins |= 1ULL << pin;
+    else
+        overdrive_pins &= ~(1ULL << pin);
+    PORT_EXIT_CRITICAL;
+}
+
+onewire_speed_t onewire_get_speed(gpio_num_t pin)
+{
+    return pin_speed(pin);
+}
+
+bool onewire_overdrive_skip_rom(gpio_num_t pin)
+{
+    if (pin_speed(pin) == ONEWIRE_SPEED_OVERDRIVE)
+        return onewire_skip_rom(pin);
+
+    if (!onewire_write(pin, ONEWIRE_OVERDRIVE_SKIP_ROM))
+        return false;
+    onewire_set_speed(pin, ONEWIRE_SPEED_OVERDRIVE);
+
+    return true;
+}
+
+bool onewire_overdrive_select(gpio_num_t pin, onewire_addr_t addr)
+{
+    if (pin_speed(pin) == ONEWIRE_SPEED_OVERDRIVE)
+        return onewire_select(pin, addr);
+
+    // command at standard speed, ROM code already in overdrive
+    if (!onewire_write(pin, ONEWIRE_OVERDRIVE_SELECT_ROM))
+        return false;
+    onewire_set_speed(pin, ONEWIRE_SPEED_OVERDRIVE);
+
+    for (int i = 0; i < 8; i++)
+    {
+        if (!onewire_write(pin, addr & 0xff))
+            return false;
+        addr >>= 8;
+    }
+
+    return true;
+}
+
 bool onewire_power(gpio_num_t pin)
 {
     // Make sure the bus is not being held low before driving it high, or we
@@ -254,6 +678,15 @@ bool onewire_power(gpio_num_t pin)
     if (!_onewire_wait_for_bus(pin, 10))
         return false;
 
+#if CONFIG_ONEWIRE_RMT
+    // TX idles high, switching the pad to push-pull drives the bus
+    if (rmt_find_bus(pin))
+    {
+        GPIO.pin[pin].pad_driver = 0;
+        return true;
+    }
+#endif
+
     setup_pin(pin, false);
     gpio_set_level(pin, 1);
 
@@ -262,6 +695,13 @@ bool onewire_power(gpio_num_t pin)
 
 void onewire_depower(gpio_num_t pin)
 {
+#if CONFIG_ONEWIRE_RMT
+    if (rmt_find_bus(pin))
+    {
+        GPIO.pin[pin].pad_driver = 1;
+        return;
+    }
+#endif
     setup_pin(pin, true);
 }
 
@@ -297,7 +737,7 @@ void onewire_search_prefix(onewire_search_t *search, uint8_t family_code)
 // Return 1 : device found, ROM number in ROM_NO buffer
 //        0 : device not found, end of search
 //
-onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin)
+static onewire_addr_t search_next(onewire_search_t *search, gpio_num_t pin, uint8_t cmd)
 {
     //TODO: add more checking for read/write errors
     uint8_t id_bit_number;
@@ -328,7 +768,7 @@ onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin)
         }
 
         // issue the search command
-        onewire_write(pin, ONEWIRE_SEARCH);
+        onewire_write(pin, cmd);
 
         // loop to do the search
         do
@@ -416,11 +856,39 @@ onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin)
     return addr;
 }
 
+onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin)
+{
+    return search_next(search, pin, ONEWIRE_SEARCH);
+}
+
+// Only devices with the alarm flag set take part in the search
+onewire_addr_t onewire_alarm_search_next(onewire_search_t *search, gpio_num_t pin)
+{
+    return search_next(search, pin, ONEWIRE_ALARM_SEARCH);
+}
+
+// Search with the path preset to `addr` (Maxim Application Note 187)
+bool onewire_verify(gpio_num_t pin, onewire_addr_t addr)
+{
+    onewire_search_t search;
+
+    for (int i = 0; i < 8; i++)
+        search.rom_no[i] = addr >> (i * 8);
+    search.last_discrepancy = 64;
+    search.last_device_found = false;
+
+    return onewire_search_next(&search, pin) == addr;
+}
+
 // The 1-Wire CRC scheme is described in Maxim Application Note 27:
 // "Understanding and Using Cyclic Redundancy Checks with Maxim iButton Products"
 //
+// Both CRCs are reflected, so a table lookup for a byte equals XOR of the
+// lookups for its low and high nibbles: CONFIG_ONEWIRE_CRC_TABLE16 uses two
+// 16-entry tables instead of a 256-entry one.
+//
 
-#ifdef CONFIG_ONEWIRE_CRC8_TABLE
+#if CONFIG_ONEWIRE_CRC_TABLE256
 // This table comes from Dallas sample code where it is freely reusable,
 // though Copyright (c) 2000 Dallas Semiconductor Corporation
 static const uint8_t dscrc_table[] = {
@@ -442,46 +910,102 @@ static const uint8_t dscrc_table[] = {
     116, 42, 200, 150, 21, 75, 169, 247, 182, 232, 10, 84, 215, 137, 107, 53
 };
 
-//
-// Compute a Dallas Semiconductor 8 bit CRC. These show up in the ROM
-// and the registers.  (note: this might better be done without to
-// table, it would probably be smaller and certainly fast enough
-// compared to all those delayMicrosecond() calls.  But I got
-// confused, so I use this table from the examples.)
-//
-uint8_t onewire_crc8(const uint8_t *data, uint8_t len)
-{
-    uint8_t crc = 0;
+// CRC-16 (polynomial 0xa001, reflected)
+static const uint16_t crc16_table[] = {
+    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+    0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440,
+    0xcc01, 0x0cc0, 0x0d80, 0xcd41, 0x0f00, 0xcfc1, 0xce81, 0x0e40,
+    0x0a00, 0xcac1, 0xcb81, 0x0b40, 0xc901, 0x09c0, 0x0880, 0xc841,
+    0xd801, 0x18c0, 0x1980, 0xd941, 0x1b00, 0xdbc1, 0xda81, 0x1a40,
+    0x1e00, 0xdec1, 0xdf81, 0x1f40, 0xdd01, 0x1dc0, 0x1c80, 0xdc41,
+    0x1400, 0xd4c1, 0xd581, 0x1540, 0xd701, 0x17c0, 0x1680, 0xd641,
+    0xd201, 0x12c0, 0x1380, 0xd341, 0x1100, 0xd1c1, 0xd081, 0x1040,
+    0xf001, 0x30c0, 0x3180, 0xf141, 0x3300, 0xf3c1, 0xf281, 0x3240,
+    0x3600, 0xf6c1, 0xf781, 0x3740, 0xf501, 0x35c0, 0x3480, 0xf441,
+    0x3c00, 0xfcc1, 0xfd81, 0x3d40, 0xff01, 0x3fc0, 0x3e80, 0xfe41,
+    0xfa01, 0x3ac0, 0x3b80, 0xfb41, 0x3900, 0xf9c1, 0xf881, 0x3840,
+    0x2800, 0xe8c1, 0xe981, 0x2940, 0xeb01, 0x2bc0, 0x2a80, 0xea41,
+    0xee01, 0x2ec0, 0x2f80, 0xef41, 0x2d00, 0xedc1, 0xec81, 0x2c40,
+    0xe401, 0x24c0, 0x2580, 0xe541, 0x2700, 0xe7c1, 0xe681, 0x2640,
+    0x2200, 0xe2c1, 0xe381, 0x2340, 0xe101, 0x21c0, 0x2080, 0xe041,
+    0xa001, 0x60c0, 0x6180, 0xa141, 0x6300, 0xa3c1, 0xa281, 0x6240,
+    0x6600, 0xa6c1, 0xa781, 0x6740, 0xa501, 0x65c0, 0x6480, 0xa441,
+    0x6c00, 0xacc1, 0xad81, 0x6d40, 0xaf01, 0x6fc0, 0x6e80, 0xae41,
+    0xaa01, 0x6ac0, 0x6b80, 0xab41, 0x6900, 0xa9c1, 0xa881, 0x6840,
+    0x7800, 0xb8c1, 0xb981, 0x7940, 0xbb01, 0x7bc0, 0x7a80, 0xba41,
+    0xbe01, 0x7ec0, 0x7f80, 0xbf41, 0x7d00, 0xbdc1, 0xbc81, 0x7c40,
+    0xb401, 0x74c0, 0x7580, 0xb541, 0x7700, 0xb7c1, 0xb681, 0x7640,
+    0x7200, 0xb2c1, 0xb381, 0x7340, 0xb101, 0x71c0, 0x7080, 0xb041,
+    0x5000, 0x90c1, 0x9181, 0x5140, 0x9301, 0x53c0, 0x5280, 0x9241,
+    0x9601, 0x56c0, 0x5780, 0x9741, 0x5500, 0x95c1, 0x9481, 0x5440,
+    0x9c01, 0x5cc0, 0x5d80, 0x9d41, 0x5f00, 0x9fc1, 0x9e81, 0x5e40,
+    0x5a00, 0x9ac1, 0x9b81, 0x5b40, 0x9901, 0x59c0, 0x5880, 0x9841,
+    0x8801, 0x48c0, 0x4980, 0x8941, 0x4b00, 0x8bc1, 0x8a81, 0x4a40,
+    0x4e00, 0x8ec1, 0x8f81, 0x4f40, 0x8d01, 0x4dc0, 0x4c80, 0x8c41,
+    0x4400, 0x84c1, 0x8581, 0x4540, 0x8701, 0x47c0, 0x4680, 0x8641,
+    0x8201, 0x42c0, 0x4380, 0x8341, 0x4100, 0x81c1, 0x8081, 0x4040
+};
 
-    while (len--)
-        crc = dscrc_table[crc ^ *data++];
+#define CRC8_LOOKUP(x)  dscrc_table[x]
+#define CRC16_LOOKUP(x) crc16_table[x]
+
+#elif CONFIG_ONEWIRE_CRC_TABLE16
+static const uint8_t crc8_table_lo[] = {
+    0x00, 0x5e, 0xbc, 0xe2, 0x61, 0x3f, 0xdd, 0x83,
+    0xc2, 0x9c, 0x7e, 0x20, 0xa3, 0xfd, 0x1f, 0x41
+};
+static const uint8_t crc8_table_hi[] = {
+    0x00, 0x9d, 0x23, 0xbe, 0x46, 0xdb, 0x65, 0xf8,
+    0x8c, 0x11, 0xaf, 0x32, 0xca, 0x57, 0xe9, 0x74
+};
+static const uint16_t crc16_table_lo[] = {
+    0x0000, 0xc0c1, 0xc181, 0x0140, 0xc301, 0x03c0, 0x0280, 0xc241,
+    0xc601, 0x06c0, 0x0780, 0xc741, 0x0500, 0xc5c1, 0xc481, 0x0440
+};
+static const uint16_t crc16_table_hi[] = {
+    0x0000, 0xcc01, 0xd801, 0x1400, 0xf001, 0x3c00, 0x2800, 0xe401,
+    0xa001, 0x6c00, 0x7800, 0xb401, 0x5000, 0x9c01, 0x8801, 0x4400
+};
+
+#define CRC8_LOOKUP(x)  (crc8_table_lo[(x) & 0x0f] ^ crc8_table_hi[(x) >> 4])
+#define CRC16_LOOKUP(x) (crc16_table_lo[(x) & 0x0f] ^ crc16_table_hi[(x) >> 4])
 
-    return crc;
-}
 #else
-//
-// Compute a Dallas Semiconductor 8 bit CRC directly.
+// Compute Dallas Semiconductor CRCs directly.
 // this is much slower, but much smaller, than the lookup table.
-//
-uint8_t onewire_crc8(const uint8_t *data, uint8_t len)
+static inline uint8_t crc8_byte(uint8_t x)
+{
+    for (int i = 8; i; i--)
+        x = x & 0x01 ? (x >> 1) ^ 0x8c : x >> 1;
+    return x;
+}
+
+static inline uint16_t crc16_byte(uint16_t x)
 {
-    uint8_t crc = 0;
+    for (int i = 8; i; i--)
+        x = x & 0x01 ? (x >> 1) ^ 0xa001 : x >> 1;
+    return x;
+}
 
+#define CRC8_LOOKUP(x)  crc8_byte(x)
+#define CRC16_LOOKUP(x) crc16_byte(x)
+#endif
+
+uint8_t onewire_crc8_update(uint8_t crc, const uint8_t *data, size_t len)
+{
     while (len--)
     {
-        uint8_t inbyte = *data++;
-        for (int i = 8; i; i--)
-        {
-            uint8_t mix = (crc ^ inbyte) & 0x01;
-            crc >>= 1;
-            if (mix)
-                crc ^= 0x8C;
-            inbyte >>= 1;
-        }
+        uint8_t x = crc ^ *data++;
+        crc = CRC8_LOOKUP(x);
     }
+
     return crc;
 }
-#endif
+
+uint8_t onewire_crc8(const uint8_t *data, uint8_t len)
+{
+    return onewire_crc8_update(0, data, len);
+}
 
 // Compute the 1-Wire CRC16 and compare it against the received CRC.
 // Example usage (reading a DS2408):
@@ -524,24 +1048,12 @@ bool onewire_check_crc16(const uint8_t* input, size_t len, const uint8_t* invert
 uint16_t onewire_crc16(const uint8_t* input, size_t len, uint16_t crc_iv)
 {
     uint16_t crc = crc_iv;
-    static const uint8_t oddparity[16] = { 0, 1, 1, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0, 1, 1, 0 };
 
-    uint16_t i;
-    for (i = 0; i < len; i++)
+    while (len--)
     {
-        // Even though we're just copying a byte from the input,
-        // we'll be doing 16-bit computation with it.
-        uint16_t cdata = input[i];
-        cdata = (cdata ^ crc) & 0xff;
-        crc >>= 8;
-
-        if (oddparity[cdata & 0x0F] ^ oddparity[cdata >> 4])
-            crc ^= 0xC001;
-
-        cdata <<= 6;
-        crc ^= cdata;
-        cdata <<= 1;
-        crc ^= cdata;
+        uint8_t x = crc ^ *input++;
+        crc = (crc >> 8) ^ CRC16_LOOKUP(x);
     }
+
     return crc;
 }
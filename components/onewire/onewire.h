@@ -56,6 +56,11 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <driver/gpio.h>
+#include <sdkconfig.h>
+
+#if CONFIG_ONEWIRE_RMT
+#include <driver/rmt.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -76,6 +81,14 @@ typedef struct
     bool last_device_found;
 } onewire_search_t;
 
+/**
+ * 1-Wire bus speed
+ */
+typedef enum {
+    ONEWIRE_SPEED_STANDARD = 0, //!< Standard speed, ~15 kbit/s
+    ONEWIRE_SPEED_OVERDRIVE,    //!< Overdrive speed, ~110 kbit/s
+} onewire_speed_t;
+
 /**
  * ::ONEWIRE_NONE is an invalid ROM address that will never occur in a device
  * (CRC mismatch), and so can be useful as an indicator for "no-such-device",
@@ -83,6 +96,54 @@ typedef struct
  */
 #define ONEWIRE_NONE ((onewire_addr_t)(0xffffffffffffffffLL))
 
+#if CONFIG_ONEWIRE_RMT || defined(__DOXYGEN__)
+
+/**
+ * @brief Attach 1-Wire bus to a pair of RMT channels.
+ *
+ * After this all functions called for `pin` generate and sample the time
+ * slots with the RMT peripheral instead of bit-banging in a critical
+ * section, so interrupts stay enabled and the calling task sleeps while
+ * the bus is busy. Both channels are connected to the same pin, which is
+ * switched to open-drain mode with pull-up enabled.
+ *
+ * Available only if CONFIG_ONEWIRE_RMT is enabled.
+ *
+ * @param pin         The GPIO pin connected to the 1-Wire bus.
+ * @param tx_channel  RMT channel for transmitting, must be TX capable
+ * @param rx_channel  RMT channel for receiving, must be RX capable
+ *
+ * @return `ESP_OK` on success, `ESP_ERR_NO_MEM` if
+ *         CONFIG_ONEWIRE_RMT_MAX_BUSES buses are already attached
+ */
+esp_err_t onewire_rmt_init(gpio_num_t pin, rmt_channel_t tx_channel, rmt_channel_t rx_channel);
+
+/**
+ * @brief Detach 1-Wire bus from RMT channels.
+ *
+ * Uninstalls RMT drivers of both channels, the bus falls back to
+ * bit-banging.
+ *
+ * @param pin  The GPIO pin connected to the 1-Wire bus.
+ *
+ * @return `ESP_OK` on success
+ */
+esp_err_t onewire_rmt_free(gpio_num_t pin);
+
+/**
+ * @brief Check if 1-Wire bus is attached to RMT channels.
+ *
+ * Functions of attached buses may block, so they must not be called from
+ * a critical section.
+ *
+ * @param pin  The GPIO pin connected to the 1-Wire bus.
+ *
+ * @return `true` if bus was attached with ::onewire_rmt_init()
+ */
+bool onewire_rmt_attached(gpio_num_t pin);
+
+#endif
+
 /**
  * @brief Perform a 1-Wire reset cycle.
  *
@@ -118,6 +179,67 @@ bool onewire_select(gpio_num_t pin, const onewire_addr_t addr);
  */
 bool onewire_skip_rom(gpio_num_t pin);
 
+/**
+ * @brief Issue a 1-Wire "overdrive skip ROM" command to switch all
+ *        overdrive capable devices to overdrive speed.
+ *
+ * It is necessary to call ::onewire_reset() before calling this function.
+ * The command itself is sent at standard speed, after it the bus is in
+ * overdrive mode (see ::onewire_set_speed()) and all subsequent slots,
+ * including reset pulses, use overdrive timing. If the bus is already in
+ * overdrive, a regular "skip ROM" command is sent instead.
+ *
+ * Devices which do not support overdrive will not respond until the bus is
+ * returned to standard speed.
+ *
+ * @param pin   The GPIO pin connected to the 1-Wire bus.
+ *
+ * @return `true` if the command could be successfully issued,
+ *         `false` if there was an error.
+ */
+bool onewire_overdrive_skip_rom(gpio_num_t pin);
+
+/**
+ * @brief Issue a 1-Wire "overdrive match ROM" command to select a particular
+ *        device and switch it to overdrive speed.
+ *
+ * It is necessary to call ::onewire_reset() before calling this function.
+ * The command is sent at standard speed and the ROM address at overdrive
+ * speed. After this the bus is in overdrive mode. If the bus is already in
+ * overdrive, a regular "ROM select" command is sent instead.
+ *
+ * @param pin   The GPIO pin connected to the 1-Wire bus.
+ * @param addr  The ROM address of the device to select
+ *
+ * @return `true` if the command could be successfully issued,
+ *         `false` if there was an error.
+ */
+bool onewire_overdrive_select(gpio_num_t pin, onewire_addr_t addr);
+
+/**
+ * @brief Set timing used on the bus.
+ *
+ * Devices stay in overdrive after overdrive reset pulses and return to
+ * standard speed on a standard speed reset pulse. So to return to standard
+ * speed set ::ONEWIRE_SPEED_STANDARD and call ::onewire_reset().
+ *
+ * Bit-banged overdrive slots are about 10 us long and need a fast CPU, for
+ * reliable overdrive use the RMT backend (CONFIG_ONEWIRE_RMT).
+ *
+ * @param pin    The GPIO pin connected to the 1-Wire bus.
+ * @param speed  Bus speed
+ */
+void onewire_set_speed(gpio_num_t pin, onewire_speed_t speed);
+
+/**
+ * @brief Get timing used on the bus.
+ *
+ * @param pin    The GPIO pin connected to the 1-Wire bus.
+ *
+ * @return current bus speed
+ */
+onewire_speed_t onewire_get_speed(gpio_num_t pin);
+
 /**
  * @brief Write a byte on the onewire bus.
  *
@@ -242,6 +364,32 @@ void onewire_search_prefix(onewire_search_t *search, uint8_t family_code);
  */
 onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin);
 
+/**
+ * @brief Search for the next device with alarm condition on the bus.
+ *
+ * Same as ::onewire_search_next(), but uses the ALARM SEARCH command, so
+ * only devices with the alarm flag set respond, e.g. DS18x20 sensors whose
+ * last measured temperature is out of their TH/TL range. Search state is
+ * reset with ::onewire_search_start() as usual.
+ *
+ * @return the address of the next device with alarm condition, or
+ *         ::ONEWIRE_NONE if there is no next address
+ */
+onewire_addr_t onewire_alarm_search_next(onewire_search_t *search, gpio_num_t pin);
+
+/**
+ * @brief Check if device with the given address is present on the bus.
+ *
+ * Performs a targeted search which follows the bits of `addr`, so it takes
+ * as long as finding a single device with ::onewire_search_next().
+ *
+ * @param pin   The GPIO pin connected to the 1-Wire bus.
+ * @param addr  The ROM address of the device
+ *
+ * @return `true` if device responded
+ */
+bool onewire_verify(gpio_num_t pin, onewire_addr_t addr);
+
 /**
  * @brief Compute a Dallas Semiconductor 8 bit CRC.
  *
@@ -250,6 +398,21 @@ onewire_addr_t onewire_search_next(onewire_search_t *search, gpio_num_t pin);
  */
 uint8_t onewire_crc8(const uint8_t *data, uint8_t len);
 
+/**
+ * @brief Continue computing Dallas Semiconductor 8 bit CRC.
+ *
+ * Can be used for blocks longer than 255 bytes or for data received in
+ * several parts. Start with `crc = 0`. CRC of data followed by its CRC
+ * byte is 0.
+ *
+ * @param crc   CRC of the preceding data
+ * @param data  Data
+ * @param len   Data length
+ *
+ * @return the updated CRC
+ */
+uint8_t onewire_crc8_update(uint8_t crc, const uint8_t *data, size_t len);
+
 /**
  * @brief Compute the 1-Wire CRC16 and compare it against the received CRC.
  *
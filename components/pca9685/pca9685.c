@@ -40,6 +40,7 @@
 #include <esp_idf_lib_helpers.h>
 #include "pca9685.h"
 
+#include <math.h>
 #include <esp_system.h>
 #include <esp_log.h>
 
@@ -61,6 +62,7 @@
 #define MODE1_SLEEP   (1 << 4)
 
 #define MODE1_SUB_BIT 3
+#define MODE1_ALLCALL (1 << 0)
 
 #define MODE2_INVRT   (1 << 4)
 #define MODE2_OUTDRV  (1 << 2)
@@ -90,14 +92,17 @@ inline static uint32_t round_div(uint32_t x, uint32_t y)
     return (x + y / 2) / y;
 }
 
+// MODE1 is not cached: RESTART bit is changed by device
+static const uint8_t cached_regs[] = { REG_MODE2, REG_PRE_SCALE };
+
 inline static esp_err_t write_reg(i2c_dev_t *dev, uint8_t reg, uint8_t val)
 {
-    return i2c_dev_write_reg(dev, reg, &val, 1);
+    return i2c_dev_write_reg_cached(dev, reg, &val, 1);
 }
 
 inline static esp_err_t read_reg(i2c_dev_t *dev, uint8_t reg, uint8_t *val)
 {
-    return i2c_dev_read_reg(dev, reg, val, 1);
+    return i2c_dev_read_reg_cached(dev, reg, val, 1);
 }
 
 static esp_err_t update_reg(i2c_dev_t *dev, uint8_t reg, uint8_t mask, uint8_t val)
@@ -111,6 +116,22 @@ static esp_err_t update_reg(i2c_dev_t *dev, uint8_t reg, uint8_t mask, uint8_t v
     return ESP_OK;
 }
 
+static void encode(uint8_t *buf, uint16_t val, uint16_t on)
+{
+    bool full_on = val >= PCA9685_MAX_PWM_VALUE;
+    bool full_off = val == 0;
+
+    if (full_on || full_off)
+        on = 0;
+    // OFF before ON wraps over the end of cycle
+    uint16_t off = full_on ? 4095 : (on + val) & 0x0fff;
+
+    buf[0] = on;
+    buf[1] = full_on ? LED_FULL_ON_OFF | (on >> 8) : on >> 8;
+    buf[2] = off;
+    buf[3] = full_off ? LED_FULL_ON_OFF | (off >> 8) : off >> 8;
+}
+
 static esp_err_t dev_sleep(i2c_dev_t *dev, bool sleep)
 {
     CHECK(update_reg(dev, REG_MODE1, MODE1_SLEEP, sleep ? MODE1_SLEEP : 0));
@@ -135,6 +156,7 @@ esp_err_t pca9685_init_desc(i2c_dev_t *dev, uint8_t addr, i2c_port_t port, gpio_
     dev->cfg.master.clk_speed = I2C_FREQ_HZ;
 #endif
 
+    CHECK(i2c_dev_cache_create(dev, cached_regs, sizeof(cached_regs), 1));
     return i2c_dev_create_mutex(dev);
 }
 
@@ -142,6 +164,7 @@ esp_err_t pca9685_free_desc(i2c_dev_t *dev)
 {
     CHECK_ARG(dev);
 
+    CHECK(i2c_dev_cache_delete(dev));
     return i2c_dev_delete_mutex(dev);
 }
 
@@ -321,17 +344,8 @@ esp_err_t pca9685_set_pwm_value(i2c_dev_t *dev, uint8_t channel, uint16_t val)
 
     uint8_t reg = channel == PCA9685_CHANNEL_ALL ? REG_ALL_LED : REG_LED_N(channel);
 
-    bool full_on = val >= PCA9685_MAX_PWM_VALUE;
-    bool full_off = val == 0;
-
-    uint16_t raw = full_on ? 4095 : val;
-
-    uint8_t buf[4] = {
-        0,
-        full_on ? LED_FULL_ON_OFF : 0,
-        raw,
-        full_off ? LED_FULL_ON_OFF | (raw >> 8) : raw >> 8
-    };
+    uint8_t buf[4];
+    encode(buf, val, 0);
 
     I2C_DEV_TAKE_MUTEX(dev);
     I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, reg, buf, 4));
@@ -347,25 +361,101 @@ esp_err_t pca9685_set_pwm_values(i2c_dev_t *dev, uint8_t first_ch, uint8_t chann
     CHECK_ARG_LOGE(channels > 0 && first_ch + channels - 1 < PCA9685_CHANNEL_ALL,
             "Invalid first_ch or channels: (%d, %d)", first_ch, channels);
 
-
     size_t size = channels * 4;
     uint8_t buf[size];
-    for (uint8_t ch = first_ch; ch < first_ch + channels; ch++)
-    {
-        bool full_on = values[ch] >= PCA9685_MAX_PWM_VALUE;
-        bool full_off = values[ch] == 0;
+    for (uint8_t i = 0; i < channels; i++)
+        encode(buf + i * 4, values[i], 0);
 
-        uint16_t val = full_on ? 4095 : values[ch];
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_LED_N(first_ch), buf, size));
+    I2C_DEV_GIVE_MUTEX(dev);
 
-        buf[ch * 4] = 0;
-        buf[ch * 4 + 1] = full_on ? LED_FULL_ON_OFF : 0;
-        buf[ch * 4 + 2] = val;
-        buf[ch * 4 + 3] = full_off ? LED_FULL_ON_OFF | (val >> 8) : val >> 8;
-    }
+    return ESP_OK;
+}
+
+esp_err_t pca9685_set_allcall(i2c_dev_t *dev, uint8_t addr, bool enable)
+{
+    CHECK_ARG(dev);
 
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_LED_N(first_ch), buf, size));
+    I2C_DEV_CHECK(dev, write_reg(dev, REG_ALLCALLADR, addr << 1));
+    I2C_DEV_CHECK(dev, update_reg(dev, REG_MODE1, MODE1_ALLCALL, enable ? MODE1_ALLCALL : 0));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_frame_init(pca9685_frame_t *frame, bool stagger)
+{
+    CHECK_ARG(frame);
+
+    frame->stagger = stagger;
+    for (uint8_t ch = 0; ch < PCA9685_CHANNEL_ALL; ch++)
+        encode(frame->regs + ch * 4, 0, 0);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_frame_set(pca9685_frame_t *frame, uint8_t channel, uint16_t val)
+{
+    CHECK_ARG(frame);
+    CHECK_ARG_LOGE(channel < PCA9685_CHANNEL_ALL,
+            "Invalid channel %d, must be in (0..%d)", channel, PCA9685_CHANNEL_ALL - 1);
+    CHECK_ARG_LOGE(val <= PCA9685_MAX_PWM_VALUE,
+            "Invalid PWM value %d, must be in (0..PCA9685_MAX_PWM_VALUE)", val);
+
+    encode(frame->regs + channel * 4, val, frame->stagger ? channel * PCA9685_STAGGER_STEP : 0);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_frame_fill(pca9685_frame_t *frame, const uint16_t *values)
+{
+    CHECK_ARG(frame && values);
+
+    for (uint8_t ch = 0; ch < PCA9685_CHANNEL_ALL; ch++)
+        CHECK(pca9685_frame_set(frame, ch, values[ch]));
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_frame_write(i2c_dev_t *dev, const pca9685_frame_t *frame)
+{
+    CHECK_ARG(dev && frame);
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_LEDX, frame->regs, sizeof(frame->regs)));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_frame_write_range(i2c_dev_t *dev, const pca9685_frame_t *frame, uint8_t first_ch, uint8_t channels)
+{
+    CHECK_ARG(dev && frame);
+    CHECK_ARG_LOGE(channels > 0 && first_ch + channels - 1 < PCA9685_CHANNEL_ALL,
+            "Invalid first_ch or channels: (%d, %d)", first_ch, channels);
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_LED_N(first_ch), frame->regs + first_ch * 4, channels * 4));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
 }
+
+esp_err_t pca9685_frame_set_level(pca9685_frame_t *frame, uint8_t channel, const pca9685_gamma_t *gamma, uint8_t level)
+{
+    CHECK_ARG(gamma);
+
+    return pca9685_frame_set(frame, channel, gamma->lut[level]);
+}
+
+esp_err_t pca9685_gamma_init(pca9685_gamma_t *gamma, float exponent)
+{
+    CHECK_ARG(gamma && exponent > 0);
+
+    for (size_t i = 0; i < 256; i++)
+        gamma->lut[i] = (uint16_t)(powf(i / 255.0f, exponent) * PCA9685_MAX_PWM_VALUE + 0.5f);
+
+    return ESP_OK;
+}
@@ -49,7 +49,8 @@
 extern "C" {
 #endif
 
-#define PCA9685_ADDR_BASE 0x40 //!< Base I2C device address
+#define PCA9685_ADDR_BASE 0x40     //!< Base I2C device address
+#define PCA9685_ADDR_ALL_CALL 0x70 //!< Default LED All Call I2C address
 
 #define PCA9685_MAX_PWM_VALUE 4096
 
@@ -242,6 +243,128 @@ esp_err_t pca9685_set_pwm_value(i2c_dev_t *dev, uint8_t channel, uint16_t val);
 esp_err_t pca9685_set_pwm_values(i2c_dev_t *dev, uint8_t first_ch, uint8_t channels,
         const uint16_t *values);
 
+/**
+ * @brief Setup LED All Call address
+ *
+ * Devices with All Call enabled respond to the common address, so one
+ * write to a descriptor with this address updates all of them at once.
+ * Only write functions must be used with such descriptor.
+ * All Call is enabled at power-on with address `PCA9685_ADDR_ALL_CALL`.
+ *
+ * @param dev Device descriptor
+ * @param addr All Call address, 7 bit
+ * @param enable True to respond to All Call address
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_set_allcall(i2c_dev_t *dev, uint8_t addr, bool enable);
+
+#define PCA9685_STAGGER_STEP (PCA9685_MAX_PWM_VALUE / PCA9685_CHANNEL_ALL) //!< ON offset between staggered channels
+
+/**
+ * PWM values of all channels, staged for one write
+ */
+typedef struct
+{
+    uint8_t regs[PCA9685_CHANNEL_ALL * 4]; //!< LEDn_ON/LEDn_OFF register values
+    bool stagger;                          //!< Shift ON time of each channel by `PCA9685_STAGGER_STEP`
+} pca9685_frame_t;
+
+/**
+ * Gamma correction table, 8-bit level to 12-bit PWM value
+ */
+typedef struct
+{
+    uint16_t lut[256]; //!< PWM values, 0..4096
+} pca9685_gamma_t;
+
+/**
+ * @brief Initialize frame
+ *
+ * All channels are set to 0.
+ *
+ * When staggering is enabled, channel N is switched on at
+ * `N * PCA9685_STAGGER_STEP` of the PWM cycle instead of 0, so outputs
+ * don't switch simultaneously. This reduces current spikes and EMI of
+ * LED drivers. Duty cycle is not affected.
+ *
+ * @param frame Frame
+ * @param stagger True to distribute ON times of channels over the cycle
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_init(pca9685_frame_t *frame, bool stagger);
+
+/**
+ * @brief Set channel value in frame
+ *
+ * No bus transaction is made.
+ *
+ * @param frame Frame
+ * @param channel Channel number, 0..15
+ * @param val PWM value, 0..4096
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_set(pca9685_frame_t *frame, uint8_t channel, uint16_t val);
+
+/**
+ * @brief Set values of all channels in frame
+ *
+ * @param frame Frame
+ * @param values Array of 16 channel values, each 0..4096
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_fill(pca9685_frame_t *frame, const uint16_t *values);
+
+/**
+ * @brief Set gamma corrected channel brightness in frame
+ *
+ * @param frame Frame
+ * @param channel Channel number, 0..15
+ * @param gamma Gamma correction table
+ * @param level Brightness, 0..255
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_set_level(pca9685_frame_t *frame, uint8_t channel, const pca9685_gamma_t *gamma, uint8_t level);
+
+/**
+ * @brief Build gamma correction table
+ *
+ * Table is computed once, afterwards conversion is a lookup.
+ * `value = 4096 * (level / 255) ^ exponent`
+ *
+ * @param gamma Gamma correction table
+ * @param exponent Gamma exponent, usually 2.2..2.8 for LEDs
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_gamma_init(pca9685_gamma_t *gamma, float exponent);
+
+/**
+ * @brief Write frame to device
+ *
+ * All 16 channels are written in one 64-byte auto-increment transaction,
+ * outputs change together on STOP condition. Auto-increment must be
+ * enabled with pca9685_init(). Use a descriptor with All Call address
+ * to send the same frame to several devices at once.
+ *
+ * @param dev Device descriptor
+ * @param frame Frame
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_write(i2c_dev_t *dev, const pca9685_frame_t *frame);
+
+/**
+ * @brief Write consecutive channels of frame to device
+ *
+ * Same as pca9685_frame_write() but only channels `first_ch` to
+ * `first_ch + channels - 1` are sent in one auto-increment transaction.
+ *
+ * @param dev Device descriptor
+ * @param frame Frame
+ * @param first_ch First channel, 0..15
+ * @param channels Number of channels to write
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_frame_write_range(i2c_dev_t *dev, const pca9685_frame_t *frame, uint8_t first_ch, uint8_t channels);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file pca9685_motion.c
+ *
+ * Motion profiles of servos driven by PCA9685
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#include "pca9685_motion.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+
+#define FRAC PCA9685_MOTION_FRAC_BITS
+#define TO_FIXED(x) ((int32_t)(x) << FRAC)
+
+// never equal to a PWM value, forces write of newly activated channel
+#define SHOWN_NONE 0xffff
+
+static const char *TAG = "pca9685_motion";
+
+static inline pca9685_motion_channel_t *get_channel(pca9685_motion_t *m, uint16_t channel)
+{
+    return &m->chips[channel / PCA9685_CHANNEL_ALL].ch[channel % PCA9685_CHANNEL_ALL];
+}
+
+// units per second (per second^2 with two periods) to fixed point units per frame
+static int32_t per_frame(uint32_t val, uint32_t period_ms, uint32_t periods)
+{
+    if (!val)
+        return 0;
+
+    uint64_t r = (uint64_t)val << FRAC;
+    for (uint32_t i = 0; i < periods; i++)
+        r = r * period_ms / 1000;
+    if (r > INT32_MAX)
+        return INT32_MAX;
+
+    // too small limits would stop motion at all
+    return r ? (int32_t)r : 1;
+}
+
+static inline int32_t limit(int32_t v, int32_t max)
+{
+    if (!max)
+        return v;
+    return v > max ? max : v < -max ? -max : v;
+}
+
+// Advance channel by one frame of trapezoidal profile
+static void advance(pca9685_motion_channel_t *c)
+{
+    int32_t err = c->target - c->pos;
+    if (!err && !c->vel)
+        return;
+
+    int32_t v;
+    if (!c->accel)
+        v = limit(err, c->max_vel);
+    else
+    {
+        v = c->vel;
+        // distance travelled until stop with current velocity
+        int64_t brake = (int64_t)v * v / (2 * (int64_t)c->accel);
+        if ((int64_t)err * v > 0 && brake >= llabs(err))
+        {
+            // decelerate, but don't reverse before the target
+            if (v > 0)
+                v = v > c->accel ? v - c->accel : 0;
+            else
+                v = v < -c->accel ? v + c->accel : 0;
+        }
+        else
+            v += err > 0 ? c->accel : -c->accel;
+        v = limit(v, c->max_vel);
+    }
+
+    // target is reached within this frame
+    if ((err >= 0 && v >= err) || (err <= 0 && v <= err))
+    {
+        c->pos = c->target;
+        c->vel = 0;
+        return;
+    }
+    c->pos += v;
+    c->vel = v;
+}
+
+static inline uint16_t to_pwm(int32_t pos)
+{
+    int32_t v = (pos + (1 << (FRAC - 1))) >> FRAC;
+    return v < 0 ? 0 : v > PCA9685_MAX_PWM_VALUE ? PCA9685_MAX_PWM_VALUE : v;
+}
+
+static void motion_task(void *arg)
+{
+    pca9685_motion_t *m = (pca9685_motion_t *)arg;
+
+    TickType_t last = xTaskGetTickCount();
+    while (m->running)
+    {
+        pca9685_motion_step(m);
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(m->period_ms));
+    }
+
+    m->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t pca9685_motion_init(pca9685_motion_t *m, i2c_dev_t **devs, size_t count, uint32_t period_ms)
+{
+    CHECK_ARG(m && devs && count && period_ms);
+
+    memset(m, 0, sizeof(pca9685_motion_t));
+    m->chips = calloc(count, sizeof(pca9685_motion_chip_t));
+    if (!m->chips)
+        return ESP_ERR_NO_MEM;
+    m->lock = xSemaphoreCreateMutex();
+    if (!m->lock)
+    {
+        free(m->chips);
+        m->chips = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        m->chips[i].dev = devs[i];
+        pca9685_frame_init(&m->chips[i].frame, false);
+    }
+    m->count = count;
+    m->period_ms = period_ms;
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_free(pca9685_motion_t *m)
+{
+    CHECK_ARG(m && m->chips);
+
+    CHECK(pca9685_motion_stop(m));
+    vSemaphoreDelete(m->lock);
+    m->lock = NULL;
+    free(m->chips);
+    m->chips = NULL;
+    m->count = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_set_limits(pca9685_motion_t *m, uint16_t channel, uint32_t max_velocity, uint32_t acceleration)
+{
+    CHECK_ARG(m && m->chips && channel < m->count * PCA9685_CHANNEL_ALL);
+
+    int32_t max_vel = per_frame(max_velocity, m->period_ms, 1);
+    int32_t accel = per_frame(acceleration, m->period_ms, 2);
+
+    xSemaphoreTake(m->lock, portMAX_DELAY);
+    pca9685_motion_channel_t *c = get_channel(m, channel);
+    c->max_vel = max_vel;
+    c->accel = accel;
+    xSemaphoreGive(m->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_set_position(pca9685_motion_t *m, uint16_t channel, uint16_t pos)
+{
+    CHECK_ARG(m && m->chips && channel < m->count * PCA9685_CHANNEL_ALL && pos <= PCA9685_MAX_PWM_VALUE);
+
+    xSemaphoreTake(m->lock, portMAX_DELAY);
+    pca9685_motion_channel_t *c = get_channel(m, channel);
+    c->pos = c->target = TO_FIXED(pos);
+    c->vel = 0;
+    if (!c->active)
+    {
+        c->active = true;
+        c->shown = SHOWN_NONE;
+    }
+    xSemaphoreGive(m->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_move(pca9685_motion_t *m, uint16_t channel, uint16_t target)
+{
+    CHECK_ARG(m && m->chips && channel < m->count * PCA9685_CHANNEL_ALL && target <= PCA9685_MAX_PWM_VALUE);
+
+    xSemaphoreTake(m->lock, portMAX_DELAY);
+    pca9685_motion_channel_t *c = get_channel(m, channel);
+    bool active = c->active;
+    if (active)
+        c->target = TO_FIXED(target);
+    xSemaphoreGive(m->lock);
+
+    return active ? ESP_OK : pca9685_motion_set_position(m, channel, target);
+}
+
+esp_err_t pca9685_motion_get_state(pca9685_motion_t *m, uint16_t channel, uint16_t *pos, bool *moving)
+{
+    CHECK_ARG(m && m->chips && channel < m->count * PCA9685_CHANNEL_ALL);
+
+    xSemaphoreTake(m->lock, portMAX_DELAY);
+    pca9685_motion_channel_t *c = get_channel(m, channel);
+    if (pos)
+        *pos = to_pwm(c->pos);
+    if (moving)
+        *moving = c->pos != c->target || c->vel;
+    xSemaphoreGive(m->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_step(pca9685_motion_t *m)
+{
+    CHECK_ARG(m && m->chips);
+
+    xSemaphoreTake(m->lock, portMAX_DELAY);
+    for (size_t i = 0; i < m->count; i++)
+    {
+        pca9685_motion_chip_t *chip = &m->chips[i];
+        for (uint8_t ch = 0; ch < PCA9685_CHANNEL_ALL; ch++)
+        {
+            pca9685_motion_channel_t *c = &chip->ch[ch];
+            if (!c->active)
+                continue;
+            advance(c);
+            uint16_t val = to_pwm(c->pos);
+            if (val == c->shown)
+                continue;
+            c->shown = val;
+            pca9685_frame_set(&chip->frame, ch, val);
+            chip->dirty |= 1 << ch;
+        }
+    }
+    xSemaphoreGive(m->lock);
+
+    // frames and dirty masks are changed by this function only
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < m->count; i++)
+    {
+        pca9685_motion_chip_t *chip = &m->chips[i];
+        if (!chip->dirty)
+            continue;
+        // one burst from the first to the last changed channel
+        uint8_t first = __builtin_ctz(chip->dirty);
+        uint8_t last = 31 - __builtin_clz(chip->dirty);
+        esp_err_t r = pca9685_frame_write_range(chip->dev, &chip->frame, first, last - first + 1);
+        if (r == ESP_OK)
+            chip->dirty = 0;
+        else
+        {
+            // changes are kept and written with the next frame
+            ESP_LOGW(TAG, "Could not write frame to device %d: %d (%s)", (int)i, r, esp_err_to_name(r));
+            m->errors++;
+            res = r;
+        }
+    }
+
+    return res;
+}
+
+esp_err_t pca9685_motion_start(pca9685_motion_t *m, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(m && m->chips && !m->task);
+
+    m->running = true;
+    if (xTaskCreate(motion_task, TAG, stack_size, m, priority, &m->task) != pdPASS)
+    {
+        m->running = false;
+        m->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t pca9685_motion_stop(pca9685_motion_t *m)
+{
+    CHECK_ARG(m);
+
+    m->running = false;
+    while (m->task)
+        vTaskDelay(1);
+
+    return ESP_OK;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file pca9685_motion.h
+ * @defgroup pca9685_motion pca9685_motion
+ * @{
+ *
+ * Motion profiles of servos driven by PCA9685
+ *
+ * Every channel moves to its target with limited velocity and
+ * acceleration (trapezoidal profile). Positions are interpolated in
+ * fixed point once per frame by a task, and changed channels of each
+ * chip are sent in one auto-increment write per frame, so application
+ * tasks only set targets and no bus traffic is made for channels at rest.
+ *
+ * Positions are PWM values, 0..4096. With 50 Hz PWM one unit is
+ * 20000 / 4096 = ~4.9 us of servo pulse width.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __PCA9685_MOTION_H__
+#define __PCA9685_MOTION_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include "pca9685.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PCA9685_MOTION_FRAC_BITS 16 //!< Fraction bits of fixed point positions and velocities
+
+/**
+ * Motion state of a channel, all values are fixed point with
+ * ::PCA9685_MOTION_FRAC_BITS fraction bits (for internal use only)
+ */
+typedef struct
+{
+    int32_t pos;            //!< Current position
+    int32_t vel;            //!< Current velocity, per frame
+    int32_t target;         //!< Target position
+    int32_t max_vel;        //!< Velocity limit per frame, 0 if unlimited
+    int32_t accel;          //!< Acceleration per frame^2, 0 if unlimited
+    uint16_t shown;         //!< PWM value in frame
+    bool active;            //!< Channel is driven by the engine
+} pca9685_motion_channel_t;
+
+/**
+ * Chip driven by the engine (for internal use only)
+ */
+typedef struct
+{
+    i2c_dev_t *dev;                                     //!< Device descriptor
+    pca9685_frame_t frame;                              //!< Current PWM values
+    pca9685_motion_channel_t ch[PCA9685_CHANNEL_ALL];   //!< Channels
+    uint16_t dirty;                                     //!< Mask of channels changed since last write
+} pca9685_motion_chip_t;
+
+/**
+ * Motion engine descriptor
+ */
+typedef struct
+{
+    pca9685_motion_chip_t *chips;   //!< Chips, internal
+    size_t count;                   //!< Number of chips
+    uint32_t period_ms;             //!< Frame period, ms
+    uint32_t errors;                //!< Number of failed frame writes
+    SemaphoreHandle_t lock;         //!< Descriptor lock, internal
+    TaskHandle_t task;              //!< Engine task, internal
+    volatile bool running;          //!< Engine task is running, internal
+} pca9685_motion_t;
+
+/**
+ * @brief Initialize motion engine
+ *
+ * Devices must be initialized with pca9685_init() and PWM frequency set.
+ * All channels are inactive: engine doesn't write them until their
+ * position is set with ::pca9685_motion_set_position().
+ *
+ * Channels are numbered across all devices: channel 0..15 of the first
+ * device, then channels 16..31 of the second one and so on.
+ *
+ * @param m Engine descriptor
+ * @param devs Array of device descriptors
+ * @param count Number of devices
+ * @param period_ms Frame period, ms, usually PWM period. Must be multiple
+ *                  of FreeRTOS tick period
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_init(pca9685_motion_t *m, i2c_dev_t **devs, size_t count, uint32_t period_ms);
+
+/**
+ * @brief Free motion engine
+ *
+ * Stops engine task if it is running. Outputs keep their last values.
+ *
+ * @param m Engine descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_free(pca9685_motion_t *m);
+
+/**
+ * @brief Set velocity and acceleration limits of channel
+ *
+ * New limits apply to the motion in progress.
+ *
+ * @param m Engine descriptor
+ * @param channel Channel number
+ * @param max_velocity Max velocity, PWM units per second, 0 for unlimited
+ * @param acceleration Acceleration and deceleration, PWM units per second^2,
+ *                     0 for unlimited
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_set_limits(pca9685_motion_t *m, uint16_t channel, uint32_t max_velocity, uint32_t acceleration);
+
+/**
+ * @brief Set channel position immediately
+ *
+ * Channel is activated, motion in progress is cancelled. Value is written
+ * with the next frame.
+ *
+ * @param m Engine descriptor
+ * @param channel Channel number
+ * @param pos Position, 0..4096
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_set_position(pca9685_motion_t *m, uint16_t channel, uint16_t pos);
+
+/**
+ * @brief Move channel to target position
+ *
+ * Motion starts with the next frame from the current position and
+ * velocity, so target may be changed while channel is moving. Inactive
+ * channel is set to the target immediately.
+ *
+ * @param m Engine descriptor
+ * @param channel Channel number
+ * @param target Target position, 0..4096
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_move(pca9685_motion_t *m, uint16_t channel, uint16_t target);
+
+/**
+ * @brief Get current state of channel
+ *
+ * @param m Engine descriptor
+ * @param channel Channel number
+ * @param[out] pos Current position, may be NULL
+ * @param[out] moving True if channel has not reached its target, may be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_get_state(pca9685_motion_t *m, uint16_t channel, uint16_t *pos, bool *moving);
+
+/**
+ * @brief Compute and write one frame
+ *
+ * Advances all active channels by one frame period and writes changed
+ * channels of every device in one transaction. Called by the engine task,
+ * may be called directly when the task is not used.
+ *
+ * @param m Engine descriptor
+ * @return `ESP_OK` on success, last write error otherwise
+ */
+esp_err_t pca9685_motion_step(pca9685_motion_t *m);
+
+/**
+ * @brief Start engine task
+ *
+ * Task calls ::pca9685_motion_step() every `period_ms`.
+ *
+ * @param m Engine descriptor
+ * @param priority Task priority
+ * @param stack_size Task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_start(pca9685_motion_t *m, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop engine task
+ *
+ * @param m Engine descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t pca9685_motion_stop(pca9685_motion_t *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __PCA9685_MOTION_H__ */
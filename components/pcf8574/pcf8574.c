@@ -97,3 +97,14 @@ esp_err_t pcf8574_port_write(i2c_dev_t *dev, uint8_t val)
 {
     return write_port(dev, val);
 }
+
+esp_err_t pcf8574_port_write_seq(i2c_dev_t *dev, const uint8_t *values, size_t len)
+{
+    CHECK_ARG(dev && values && len);
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write(dev, NULL, 0, values, len));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return ESP_OK;
+}
@@ -83,6 +83,19 @@ esp_err_t pcf8574_port_read(i2c_dev_t *dev, uint8_t *val);
  */
 esp_err_t pcf8574_port_write(i2c_dev_t *dev, uint8_t value);
 
+/**
+ * @brief Write sequence of values to GPIO port in one transaction
+ *
+ * PCF8574 latches every received byte to its outputs, so this is the
+ * fastest way to produce waveforms, e.g. for HD44780 LCD.
+ *
+ * @param dev Pointer to I2C device descriptor
+ * @param values Port values
+ * @param len Number of values
+ * @return ESP_OK on success
+ */
+esp_err_t pcf8574_port_write_seq(i2c_dev_t *dev, const uint8_t *values, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
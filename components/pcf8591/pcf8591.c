@@ -40,6 +40,7 @@
  * BSD Licensed as described in the file LICENSE
  */
 #include <stddef.h>
+#include <string.h>
 #include <esp_log.h>
 #include <esp_idf_lib_helpers.h>
 #include "pcf8591.h"
@@ -52,6 +53,8 @@ static const char *TAG = "pcf8591";
 
 #define CTRL_AD_CH_MASK 0x03
 
+#define CTRL_AUTO_INC 2
+
 #define CTRL_AD_IN_PRG 4
 #define CTRL_AD_IN_PRG_MASK (0x03 << CTRL_AD_IN_PRG)
 
@@ -87,6 +90,19 @@ esp_err_t pcf8591_free_desc(i2c_dev_t *dev)
     return i2c_dev_delete_mutex(dev);
 }
 
+uint8_t pcf8591_channels(pcf8591_input_conf_t conf)
+{
+    switch (conf)
+    {
+        case PCF8591_IC_4_SINGLES:
+            return 4;
+        case PCF8591_IC_2_DIFFS:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
 esp_err_t pcf8591_read(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t channel, uint8_t *value)
 {
     CHECK_ARG(dev && value);
@@ -101,10 +117,15 @@ esp_err_t pcf8591_read(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t channe
             (channel & CTRL_AD_CH_MASK) |
             BV(CTRL_DA_OUT_EN);
 
+    // first byte is the result of the previous conversion
+    uint8_t buf[2];
+
     I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, i2c_dev_read_reg(dev, control_reg, value, 1));
+    I2C_DEV_CHECK(dev, i2c_dev_read_reg(dev, control_reg, buf, sizeof(buf)));
     I2C_DEV_GIVE_MUTEX(dev);
 
+    *value = buf[1];
+
     return ESP_OK;
 }
 
@@ -120,3 +141,36 @@ esp_err_t pcf8591_write(i2c_dev_t *dev, uint8_t value)
 
     return ESP_OK;
 }
+
+esp_err_t pcf8591_read_burst(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t dac, uint8_t *buf, size_t frames)
+{
+    CHECK_ARG(dev && buf && frames && conf <= PCF8591_IC_2_DIFFS);
+
+    uint8_t out[2] = {
+        ((conf << CTRL_AD_IN_PRG) & CTRL_AD_IN_PRG_MASK) | BV(CTRL_AUTO_INC) | BV(CTRL_DA_OUT_EN),
+        dac
+    };
+    size_t count = pcf8591_channels(conf) * frames;
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_read(dev, out, sizeof(out), buf, count + 1));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    // skip stale result of the previous conversion
+    memmove(buf, buf + 1, count);
+
+    return ESP_OK;
+}
+
+esp_err_t pcf8591_scan(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t dac, uint8_t *values)
+{
+    CHECK_ARG(values);
+
+    uint8_t buf[PCF8591_BURST_BUF_SIZE(PCF8591_MAX_CHANNELS, 1)];
+    esp_err_t res = pcf8591_read_burst(dev, conf, dac, buf, 1);
+    if (res != ESP_OK)
+        return res;
+    memcpy(values, buf, pcf8591_channels(conf));
+
+    return ESP_OK;
+}
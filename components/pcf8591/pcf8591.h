@@ -53,6 +53,13 @@ extern "C" {
 
 #define PCF8591_DEFAULT_ADDRESS 0x48
 
+#define PCF8591_MAX_CHANNELS 4 //!< Maximal number of analog channels
+
+/**
+ * Buffer size for ::pcf8591_read_burst(), bytes
+ */
+#define PCF8591_BURST_BUF_SIZE(channels, frames) ((channels) * (frames) + 1)
+
 /**
  * Analog inputs configuration, see datasheet
  */
@@ -83,9 +90,20 @@ esp_err_t pcf8591_init_desc(i2c_dev_t *dev, uint8_t addr, i2c_port_t port, gpio_
  */
 esp_err_t pcf8591_free_desc(i2c_dev_t *dev);
 
+/**
+ * @brief Get number of analog channels for inputs configuration
+ *
+ * @param conf Analog inputs configuration
+ * @return Number of channels, 2..4
+ */
+uint8_t pcf8591_channels(pcf8591_input_conf_t conf);
+
 /**
  * @brief Read input value of an analog pin
  *
+ * Function starts a new conversion and skips the stale result of
+ * the previous one, so the returned value is always fresh.
+ *
  * @param dev Device descriptor
  * @param conf Analog inputs configuration
  * @param channel Analog channel
@@ -103,6 +121,40 @@ esp_err_t pcf8591_read(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t channe
  */
 esp_err_t pcf8591_write(i2c_dev_t *dev, uint8_t value);
 
+/**
+ * @brief Read all analog channels and update DAC in one transaction
+ *
+ * Control byte with auto-increment flag and DAC value are written,
+ * then all channels are read after repeated start. The stale first byte
+ * is discarded.
+ *
+ * @param dev Device descriptor
+ * @param conf Analog inputs configuration
+ * @param dac DAC value
+ * @param[out] values Analog values, ::pcf8591_channels() items
+ * @return `ESP_OK` on success
+ */
+esp_err_t pcf8591_scan(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t dac, uint8_t *values);
+
+/**
+ * @brief Read several frames of all channels in one continuous read
+ *
+ * In auto-increment mode PCF8591 converts the next channel while the
+ * previous result is being transmitted, so one long read gives
+ * `frames` consecutive scans at the bus rate (9 SCL cycles per sample,
+ * ~11 kSps at 100 kHz). The stale first byte is discarded and values
+ * are moved to the beginning of the buffer:
+ * `buf[frame * channels + channel]`.
+ *
+ * @param dev Device descriptor
+ * @param conf Analog inputs configuration
+ * @param dac DAC value
+ * @param[out] buf Buffer of `PCF8591_BURST_BUF_SIZE(channels, frames)` bytes
+ * @param frames Number of frames
+ * @return `ESP_OK` on success
+ */
+esp_err_t pcf8591_read_burst(i2c_dev_t *dev, pcf8591_input_conf_t conf, uint8_t dac, uint8_t *buf, size_t frames);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,469 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file pixel_sink.c
+ *
+ * Network pixel sink: E1.31 (sACN), Art-Net and DDP receiver
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <lwip/api.h>
+#include "pixel_sink.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+#define CHECK(x) do { esp_err_t __; if ((__ = (x)) != ESP_OK) return __; } while (0)
+
+#define RECV_TIMEOUT_MS 100
+// Art-Net and E1.31 fall back to unsynchronized mode after 4 s without sync
+#define SYNC_TIMEOUT_US 4000000
+
+#define E131_HEADER_SIZE 126
+#define E131_SYNC_SIZE 49
+#define E131_VECTOR_DATA 0x00000004
+#define E131_VECTOR_EXTENDED 0x00000008
+#define E131_VECTOR_FRAME_DATA 0x00000002
+#define E131_VECTOR_FRAME_SYNC 0x00000001
+#define E131_OPT_TERMINATED 0x20
+#define E131_OPT_PREVIEW 0x40
+
+#define ARTNET_HEADER_SIZE 18
+#define ARTNET_OP_DMX 0x5000
+#define ARTNET_OP_SYNC 0x5200
+
+#define DDP_HEADER_SIZE 10
+#define DDP_TIMECODE_SIZE 4
+#define DDP_VER_MASK 0xc0
+#define DDP_VER_1 0x40
+#define DDP_FLAG_TIMECODE 0x10
+#define DDP_FLAG_QUERY 0x02
+#define DDP_FLAG_PUSH 0x01
+#define DDP_ID_DISPLAY 1
+
+static const char *TAG = "pixel_sink";
+
+static const uint8_t e131_id[12] = { 'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0 };
+static const uint8_t artnet_id[8] = { 'A', 'r', 't', '-', 'N', 'e', 't', 0 };
+
+/*
+ * Received packet, either lwIP pbuf chain or plain memory. Payload is
+ * copied from pbuf chain straight to its destination.
+ */
+typedef struct
+{
+    const void *src;
+    size_t len;
+    bool pbuf;
+} packet_t;
+
+static size_t packet_copy(const packet_t *p, void *dst, size_t len, size_t offs)
+{
+    if (offs >= p->len)
+        return 0;
+    if (len > p->len - offs)
+        len = p->len - offs;
+    if (p->pbuf)
+        return pbuf_copy_partial((const struct pbuf *)p->src, dst, len, offs);
+    memcpy(dst, (const uint8_t *)p->src + offs, len);
+    return len;
+}
+
+static inline uint16_t be16(const uint8_t *b)
+{
+    return (b[0] << 8) | b[1];
+}
+
+static inline uint32_t be32(const uint8_t *b)
+{
+    return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+static esp_err_t finish_frame(pixel_sink_t *sink)
+{
+    esp_err_t res = ESP_OK;
+    framebuffer_t *fb = sink->cfg.fb;
+
+    if (fb)
+    {
+        if (sink->in_frame)
+        {
+            fb_end(fb);
+            sink->in_frame = false;
+        }
+        res = fb_render(fb, sink->cfg.render_ctx);
+    }
+    if (res == ESP_OK && sink->cfg.sync)
+        res = sink->cfg.sync(sink->cfg.sync_ctx);
+    sink->frames++;
+    sink->pending_us = 0;
+
+    return res;
+}
+
+static void write_fb(pixel_sink_t *sink, const packet_t *p, size_t src, size_t dst, size_t len)
+{
+    framebuffer_t *fb = sink->cfg.fb;
+    size_t y0 = dst / sizeof(rgb_t) / fb->width;
+    size_t y1 = (dst + len - 1) / sizeof(rgb_t) / fb->width;
+
+    if (!fb->ring)
+        packet_copy(p, (uint8_t *)fb->data + dst, len, src);
+    else
+    {
+        // logical rows are not contiguous in ring mode
+        while (len)
+        {
+            size_t pix = dst / sizeof(rgb_t);
+            size_t byte = dst % sizeof(rgb_t);
+            size_t x = pix % fb->width;
+            rgb_t *first, *second;
+            size_t n = fb_span_unchecked(fb, x, pix / fb->width, fb->width - x, &first, &second);
+            size_t chunk = n * sizeof(rgb_t) - byte;
+            if (chunk > len)
+                chunk = len;
+            packet_copy(p, (uint8_t *)first + byte, chunk, src);
+            src += chunk;
+            dst += chunk;
+            len -= chunk;
+        }
+    }
+    fb_mark_dirty_unchecked(fb, 0, y0, fb->width - 1, y1);
+}
+
+// Copy `len` bytes from packet offset `src` to target offset `dst`
+static esp_err_t write_data(pixel_sink_t *sink, const packet_t *p, size_t src, size_t dst, size_t len)
+{
+    if (src >= p->len || dst >= sink->size)
+        return ESP_ERR_INVALID_SIZE;
+    if (len > p->len - src)
+        len = p->len - src;
+    if (len > sink->size - dst)
+        len = sink->size - dst;
+    if (!len)
+        return ESP_ERR_INVALID_SIZE;
+
+    if (!sink->cfg.fb)
+    {
+        packet_copy(p, *sink->cfg.buf + dst, len, src);
+        return ESP_OK;
+    }
+
+    if (!sink->in_frame)
+    {
+        // framebuffer is locked until the frame is finished
+        CHECK(fb_begin(sink->cfg.fb));
+        sink->in_frame = true;
+    }
+    write_fb(sink, p, src, dst, len);
+
+    return ESP_OK;
+}
+
+static inline bool own_universe(pixel_sink_t *sink, uint16_t universe)
+{
+    return universe >= sink->cfg.universe && universe - sink->cfg.universe < sink->cfg.universe_count;
+}
+
+static esp_err_t universe_data(pixel_sink_t *sink, const packet_t *p, uint16_t universe, size_t src, size_t len,
+        bool synced)
+{
+    if (!own_universe(sink, universe))
+        return ESP_ERR_NOT_FOUND;
+
+    size_t u = universe - sink->cfg.universe;
+    if (len > sink->cfg.universe_channels)
+        len = sink->cfg.universe_channels;
+    CHECK(write_data(sink, p, src, u * sink->cfg.universe_channels, len));
+    sink->packets++;
+
+    // without synchronization last universe finishes the frame
+    if (!synced && sink->sync_us && esp_timer_get_time() - sink->sync_us < SYNC_TIMEOUT_US)
+        synced = true;
+    if (u == sink->cfg.universe_count - 1U)
+    {
+        if (!synced)
+            return finish_frame(sink);
+        // receiver task finishes frame if sync is lost
+        if (!sink->pending_us)
+            sink->pending_us = esp_timer_get_time();
+    }
+
+    return ESP_OK;
+}
+
+#if LWIP_IGMP
+static void e131_group(pixel_sink_t *sink, uint16_t universe, enum netconn_igmp action)
+{
+    // 239.255.<universe high byte>.<universe low byte>
+    ip_addr_t group;
+    IP_ADDR4(&group, 239, 255, universe >> 8, universe & 0xff);
+    if (netconn_join_leave_group((struct netconn *)sink->conn, &group, IP_ADDR_ANY, action) != ERR_OK)
+        ESP_LOGW(TAG, "Could not %s multicast group of universe %d",
+                action == NETCONN_JOIN ? "join" : "leave", universe);
+}
+#endif
+
+// sender tells synchronization universe in every data packet
+static void e131_sync_universe(pixel_sink_t *sink, uint16_t universe)
+{
+    if (!universe || universe == sink->sync_universe)
+        return;
+#if LWIP_IGMP
+    if (sink->conn && sink->cfg.multicast)
+    {
+        // groups of data universes are joined for whole session
+        if (sink->sync_universe && !own_universe(sink, sink->sync_universe))
+            e131_group(sink, sink->sync_universe, NETCONN_LEAVE);
+        if (!own_universe(sink, universe))
+            e131_group(sink, universe, NETCONN_JOIN);
+    }
+#endif
+    sink->sync_universe = universe;
+}
+
+static esp_err_t sync_frame(pixel_sink_t *sink)
+{
+    sink->sync_us = esp_timer_get_time();
+    return finish_frame(sink);
+}
+
+static esp_err_t process_e131(pixel_sink_t *sink, const packet_t *p)
+{
+    uint8_t h[E131_HEADER_SIZE];
+    size_t len = packet_copy(p, h, sizeof(h), 0);
+    if (len < E131_SYNC_SIZE || memcmp(h + 4, e131_id, sizeof(e131_id)))
+        return ESP_ERR_INVALID_RESPONSE;
+
+    uint32_t vector = be32(h + 18);
+    if (vector == E131_VECTOR_EXTENDED && be32(h + 40) == E131_VECTOR_FRAME_SYNC)
+    {
+        if (sink->sync_universe && be16(h + 45) != sink->sync_universe)
+            return ESP_ERR_NOT_FOUND;
+        return sync_frame(sink);
+    }
+    if (vector != E131_VECTOR_DATA || len < E131_HEADER_SIZE || be32(h + 40) != E131_VECTOR_FRAME_DATA
+            || (h[112] & (E131_OPT_TERMINATED | E131_OPT_PREVIEW)) || h[125] != 0)
+        return ESP_ERR_INVALID_RESPONSE;
+
+    // property count includes start code
+    size_t count = be16(h + 123);
+    if (!count)
+        return ESP_ERR_INVALID_RESPONSE;
+
+    uint16_t sync_universe = be16(h + 109);
+    e131_sync_universe(sink, sync_universe);
+
+    return universe_data(sink, p, be16(h + 113), E131_HEADER_SIZE, count - 1, sync_universe != 0);
+}
+
+static esp_err_t process_artnet(pixel_sink_t *sink, const packet_t *p)
+{
+    uint8_t h[ARTNET_HEADER_SIZE];
+    size_t len = packet_copy(p, h, sizeof(h), 0);
+    if (len < 10 || memcmp(h, artnet_id, sizeof(artnet_id)))
+        return ESP_ERR_INVALID_RESPONSE;
+
+    uint16_t op = h[8] | (h[9] << 8);
+    if (op == ARTNET_OP_SYNC)
+        return sync_frame(sink);
+    if (op != ARTNET_OP_DMX || len < ARTNET_HEADER_SIZE)
+        return ESP_ERR_INVALID_RESPONSE;
+
+    // 15-bit port address: net, subnet and universe
+    uint16_t universe = (h[14] | (h[15] << 8)) & 0x7fff;
+
+    return universe_data(sink, p, universe, ARTNET_HEADER_SIZE, be16(h + 16), false);
+}
+
+static esp_err_t process_ddp(pixel_sink_t *sink, const packet_t *p)
+{
+    uint8_t h[DDP_HEADER_SIZE];
+    if (packet_copy(p, h, sizeof(h), 0) < DDP_HEADER_SIZE
+            || (h[0] & DDP_VER_MASK) != DDP_VER_1 || (h[0] & DDP_FLAG_QUERY) || h[3] != DDP_ID_DISPLAY)
+        return ESP_ERR_INVALID_RESPONSE;
+
+    size_t src = DDP_HEADER_SIZE + (h[0] & DDP_FLAG_TIMECODE ? DDP_TIMECODE_SIZE : 0);
+    size_t len = be16(h + 8);
+    // push-only packets carry no data
+    if (len)
+    {
+        CHECK(write_data(sink, p, src, be32(h + 4), len));
+        sink->packets++;
+    }
+
+    return h[0] & DDP_FLAG_PUSH ? finish_frame(sink) : ESP_OK;
+}
+
+static esp_err_t process(pixel_sink_t *sink, const packet_t *p)
+{
+    esp_err_t res;
+    switch (sink->cfg.proto)
+    {
+        case PIXEL_SINK_E131:
+            res = process_e131(sink, p);
+            break;
+        case PIXEL_SINK_ARTNET:
+            res = process_artnet(sink, p);
+            break;
+        default:
+            res = process_ddp(sink, p);
+    }
+    if (res == ESP_OK)
+        sink->packet_us = esp_timer_get_time();
+    else
+        sink->dropped++;
+
+    return res;
+}
+
+static void receiver_task(void *arg)
+{
+    pixel_sink_t *sink = (pixel_sink_t *)arg;
+    struct netconn *conn = (struct netconn *)sink->conn;
+
+    while (sink->running)
+    {
+        struct netbuf *nb;
+        err_t err = netconn_recv(conn, &nb);
+        if (err == ERR_OK)
+        {
+            packet_t p = { .src = nb->p, .len = nb->p->tot_len, .pbuf = true };
+            process(sink, &p);
+            netbuf_delete(nb);
+        }
+        else if (err != ERR_TIMEOUT)
+        {
+            ESP_LOGE(TAG, "Receive error %d", err);
+            vTaskDelay(pdMS_TO_TICKS(RECV_TIMEOUT_MS));
+        }
+
+        // don't keep framebuffer locked if sender stopped in the middle of frame
+        int64_t now = esp_timer_get_time();
+        if (sink->in_frame && now - sink->packet_us > PIXEL_SINK_TIMEOUT_MS * 1000LL)
+            finish_frame(sink);
+        // present complete frame if its sync packet is lost
+        else if (sink->pending_us && now - sink->pending_us > PIXEL_SINK_SYNC_WAIT_MS * 1000LL)
+        {
+            ESP_LOGD(TAG, "No sync, frame finished");
+            finish_frame(sink);
+        }
+    }
+
+    if (sink->in_frame)
+        finish_frame(sink);
+    __atomic_store_n(&sink->task, NULL, __ATOMIC_RELEASE);
+    vTaskDelete(NULL);
+}
+
+esp_err_t pixel_sink_init(pixel_sink_t *sink, const pixel_sink_config_t *cfg)
+{
+    CHECK_ARG(sink && cfg && cfg->proto <= PIXEL_SINK_DDP);
+    CHECK_ARG((cfg->fb && cfg->fb->data) || (cfg->buf && *cfg->buf && cfg->buf_size));
+
+    memset(sink, 0, sizeof(pixel_sink_t));
+    sink->cfg = *cfg;
+    sink->size = cfg->fb ? FB_SIZE(cfg->fb) : cfg->buf_size;
+    if (!sink->cfg.port)
+        sink->cfg.port = cfg->proto == PIXEL_SINK_E131
+                         ? PIXEL_SINK_E131_PORT
+                         : cfg->proto == PIXEL_SINK_ARTNET ? PIXEL_SINK_ARTNET_PORT : PIXEL_SINK_DDP_PORT;
+    if (!sink->cfg.universe_channels)
+        sink->cfg.universe_channels = PIXEL_SINK_UNIVERSE_CHANNELS;
+    if (!sink->cfg.universe_count)
+        sink->cfg.universe_count = (sink->size + sink->cfg.universe_channels - 1) / sink->cfg.universe_channels;
+
+    return ESP_OK;
+}
+
+esp_err_t pixel_sink_start(pixel_sink_t *sink, UBaseType_t priority, BaseType_t core)
+{
+    CHECK_ARG(sink && !sink->task);
+
+    struct netconn *conn = netconn_new(NETCONN_UDP);
+    if (!conn)
+        return ESP_ERR_NO_MEM;
+    if (netconn_bind(conn, IP_ADDR_ANY, sink->cfg.port) != ERR_OK)
+    {
+        ESP_LOGE(TAG, "Could not bind to port %d", sink->cfg.port);
+        netconn_delete(conn);
+        return ESP_FAIL;
+    }
+    netconn_set_recvtimeout(conn, RECV_TIMEOUT_MS);
+#if LWIP_IGMP
+    if (sink->cfg.proto == PIXEL_SINK_E131 && sink->cfg.multicast)
+    {
+        sink->conn = conn;
+        for (size_t i = 0; i < sink->cfg.universe_count; i++)
+            e131_group(sink, sink->cfg.universe + i, NETCONN_JOIN);
+    }
+#endif
+
+    sink->conn = conn;
+    sink->sync_universe = 0;
+    sink->pending_us = 0;
+    sink->running = true;
+#if defined(CONFIG_IDF_TARGET_ESP8266)
+    BaseType_t res = xTaskCreate(receiver_task, "pixel_sink", PIXEL_SINK_STACK_SIZE, sink, priority, &sink->task);
+#else
+    BaseType_t res = xTaskCreatePinnedToCore(receiver_task, "pixel_sink", PIXEL_SINK_STACK_SIZE, sink, priority,
+            &sink->task, core);
+#endif
+    if (res != pdPASS)
+    {
+        ESP_LOGE(TAG, "Could not create receiver task");
+        sink->running = false;
+        sink->task = NULL;
+        sink->conn = NULL;
+        netconn_delete(conn);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t pixel_sink_stop(pixel_sink_t *sink)
+{
+    CHECK_ARG(sink);
+
+    sink->running = false;
+    while (__atomic_load_n(&sink->task, __ATOMIC_ACQUIRE))
+        vTaskDelay(1);
+    if (sink->conn)
+        netconn_delete((struct netconn *)sink->conn);
+    sink->conn = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t pixel_sink_feed(pixel_sink_t *sink, const void *data, size_t len)
+{
+    CHECK_ARG(sink && data && len);
+
+    packet_t p = { .src = data, .len = len, .pbuf = false };
+    return process(sink, &p);
+}
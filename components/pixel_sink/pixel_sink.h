@@ -0,0 +1,183 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file pixel_sink.h
+ * @defgroup pixel_sink pixel_sink
+ * @{
+ *
+ * Network pixel sink: E1.31 (sACN), Art-Net and DDP receiver
+ *
+ * Sink receives UDP packets with lwIP netconn API and copies pixel data
+ * from packet buffers straight into framebuffer or raw LED buffer (for
+ * example, buffer of led_strip), without intermediate packet copy. Frames
+ * are finished by protocol synchronization (E1.31 universe sync, ArtSync,
+ * DDP push flag) or by the last configured universe, then framebuffer is
+ * rendered or user sync callback is called.
+ *
+ * Channel data is copied as is: 3 bytes per pixel in RGB order for
+ * framebuffer, in the order of target buffer for raw buffers.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __PIXEL_SINK_H__
+#define __PIXEL_SINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_err.h>
+#include <framebuffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PIXEL_SINK_E131_PORT   5568 ///< Default UDP port of E1.31
+#define PIXEL_SINK_ARTNET_PORT 6454 ///< Default UDP port of Art-Net
+#define PIXEL_SINK_DDP_PORT    4048 ///< Default UDP port of DDP
+
+#define PIXEL_SINK_UNIVERSE_CHANNELS 510 ///< Default number of channels used in universe, 170 RGB pixels
+
+#ifndef PIXEL_SINK_STACK_SIZE
+#define PIXEL_SINK_STACK_SIZE 4096 ///< Stack size of receiver task
+#endif
+
+#ifndef PIXEL_SINK_TIMEOUT_MS
+#define PIXEL_SINK_TIMEOUT_MS 1000 ///< Incomplete frame is finished after this time without packets
+#endif
+
+#ifndef PIXEL_SINK_SYNC_WAIT_MS
+#define PIXEL_SINK_SYNC_WAIT_MS 100 ///< Frame waiting for sync is finished without it after this time
+#endif
+
+/**
+ * Network protocol
+ */
+typedef enum {
+    PIXEL_SINK_E131 = 0, ///< E1.31 (Streaming ACN)
+    PIXEL_SINK_ARTNET,   ///< Art-Net, ArtDmx and ArtSync
+    PIXEL_SINK_DDP,      ///< Distributed Display Protocol, 8-bit RGB
+} pixel_sink_proto_t;
+
+/**
+ * Frame sync callback for raw buffer target
+ */
+typedef esp_err_t (*pixel_sink_sync_cb_t)(void *ctx);
+
+/**
+ * Sink configuration
+ */
+typedef struct
+{
+    pixel_sink_proto_t proto;        ///< Protocol
+    uint16_t port;                   ///< UDP port, 0 for default port of protocol
+    bool multicast;                  ///< E1.31: join multicast groups of all universes and
+                                     ///< of synchronization universe
+    uint16_t universe;               ///< First universe, E1.31 and Art-Net
+    uint16_t universe_count;         ///< Number of universes, 0 to cover whole target
+    uint16_t universe_channels;      ///< Channels used in every universe, 0 for ::PIXEL_SINK_UNIVERSE_CHANNELS
+    framebuffer_t *fb;               ///< Target framebuffer, NULL for raw buffer target
+    void *render_ctx;                ///< Argument of ::fb_render()
+    uint8_t *const *buf;             ///< Raw target: pointer to buffer pointer, e.g. `&strip.buf`,
+                                     ///< so buffer swaps of the owner are followed
+    size_t buf_size;                 ///< Raw target: buffer size, bytes
+    pixel_sink_sync_cb_t sync;       ///< Called after every frame, optional for framebuffer target
+    void *sync_ctx;                  ///< Argument of `sync`
+} pixel_sink_config_t;
+
+/**
+ * Sink descriptor
+ */
+typedef struct
+{
+    pixel_sink_config_t cfg;         ///< Configuration
+    size_t size;                     ///< Internal: target size, bytes
+    void *conn;                      ///< Internal: lwIP netconn
+    TaskHandle_t task;               ///< Internal: receiver task
+    volatile bool running;           ///< Internal: receiver task must run
+    bool in_frame;                   ///< Internal: framebuffer is locked for frame
+    int64_t packet_us;               ///< Internal: time of last accepted packet
+    int64_t sync_us;                 ///< Internal: time of last sync, sync mode is on while it is fresh
+    int64_t pending_us;              ///< Internal: time when frame started waiting for sync, 0 if none
+    uint16_t sync_universe;          ///< Internal: E1.31 synchronization universe, 0 if unknown
+    uint32_t packets;                ///< Number of accepted data packets
+    uint32_t frames;                 ///< Number of finished frames
+    uint32_t dropped;                ///< Number of ignored or malformed packets
+} pixel_sink_t;
+
+/**
+ * @brief Initialize sink descriptor
+ *
+ * @param sink      Sink descriptor
+ * @param cfg       Configuration, copied
+ * @return          ESP_OK on success
+ */
+esp_err_t pixel_sink_init(pixel_sink_t *sink, const pixel_sink_config_t *cfg);
+
+/**
+ * @brief Start receiving packets
+ *
+ * Creates UDP connection and receiver task, network must be up.
+ *
+ * @param sink      Sink descriptor
+ * @param priority  Priority of receiver task
+ * @param core      Core of receiver task, ignored on single-core chips
+ * @return          ESP_OK on success
+ */
+esp_err_t pixel_sink_start(pixel_sink_t *sink, UBaseType_t priority, BaseType_t core);
+
+/**
+ * @brief Stop receiving packets
+ *
+ * Waits for receiver task to finish and closes connection.
+ *
+ * @param sink      Sink descriptor
+ * @return          ESP_OK on success
+ */
+esp_err_t pixel_sink_stop(pixel_sink_t *sink);
+
+/**
+ * @brief Process one packet from memory
+ *
+ * For packets received by other means, must not be used while sink is
+ * started.
+ *
+ * @param sink      Sink descriptor
+ * @param data      Packet, UDP payload
+ * @param len       Packet length
+ * @return          ESP_OK if packet was accepted
+ */
+esp_err_t pixel_sink_feed(pixel_sink_t *sink, const void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __PIXEL_SINK_H__ */
@@ -187,7 +187,8 @@ esp_err_t qmc5883l_get_config(qmc5883l_t *dev, qmc5883l_odr_t *odr, qmc5883l_osr
 
 esp_err_t qmc5883l_set_int(qmc5883l_t *dev, bool enable)
 {
-    return write_reg(dev, REG_CTRL2, enable ? 1 : 0);
+    // INT_ENB bit disables interrupt pin
+    return write_reg(dev, REG_CTRL2, enable ? 0 : 1);
 }
 
 esp_err_t qmc5883l_get_int(qmc5883l_t *dev, bool *enable)
@@ -196,7 +197,7 @@ esp_err_t qmc5883l_get_int(qmc5883l_t *dev, bool *enable)
 
     uint8_t v;
     CHECK(read_reg(dev, REG_CTRL2, &v));
-    *enable = v & 1;
+    *enable = !(v & 1);
 
     return ESP_OK;
 }
@@ -237,6 +238,20 @@ esp_err_t qmc5883l_raw_to_mg(qmc5883l_t *dev, qmc5883l_raw_data_t *raw, qmc5883l
     return ESP_OK;
 }
 
+esp_err_t qmc5883l_raw_to_mg_int(qmc5883l_t *dev, qmc5883l_raw_data_t *raw, qmc5883l_data_int_t *data)
+{
+    CHECK_ARG(dev && raw && data);
+
+    // 2000 / 32768 = 125 / 2048 mG/LSb, 8000 / 32768 = 125 / 512 mG/LSb
+    int32_t div = dev->range == QMC5883L_RNG_2 ? 2048 : 512;
+
+    data->x = (int32_t)raw->x * 125 / div;
+    data->y = (int32_t)raw->y * 125 / div;
+    data->z = (int32_t)raw->z * 125 / div;
+
+    return ESP_OK;
+}
+
 esp_err_t qmc5883l_get_data(qmc5883l_t *dev, qmc5883l_data_t *data)
 {
     qmc5883l_raw_data_t raw;
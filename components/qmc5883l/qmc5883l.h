@@ -110,6 +110,16 @@ typedef struct
     float z;
 } qmc5883l_data_t;
 
+/**
+ * Measurement result, integer milligauss
+ */
+typedef struct
+{
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} qmc5883l_data_int_t;
+
 /**
  * Device descriptor
  */
@@ -241,6 +251,18 @@ esp_err_t qmc5883l_get_raw_data(qmc5883l_t *dev, qmc5883l_raw_data_t *raw);
  */
 esp_err_t qmc5883l_raw_to_mg(qmc5883l_t *dev, qmc5883l_raw_data_t *raw, qmc5883l_data_t *data);
 
+/**
+ * @brief Convert raw magnetic data to integer milligauss
+ *
+ * Same as ::qmc5883l_raw_to_mg() but without floating point math.
+ *
+ * @param dev Device descriptor
+ * @param raw Raw magnetic data
+ * @param[out] data Magnetic data in mG
+ * @return `ESP_OK` on success
+ */
+esp_err_t qmc5883l_raw_to_mg_int(qmc5883l_t *dev, qmc5883l_raw_data_t *raw, qmc5883l_data_int_t *data);
+
 /**
  * @brief Read magnetic data in milligauss
  *
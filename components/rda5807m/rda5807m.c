@@ -56,8 +56,8 @@
 #define REG_RB      0x0b
 #define REG_RDSA    0x0c
 #define REG_RDSB    0x0d
-#define REG_RDSC    0x0c
-#define REG_RDSD    0x0d
+#define REG_RDSC    0x0e
+#define REG_RDSD    0x0f
 
 // Bits
 #define BIT_CTRL_ENABLE      0
@@ -82,7 +82,9 @@
 
 #define BIT_R4_AFCD        8
 #define BIT_R4_SOFTMUTE_EN 9
+#define BIT_R4_GPIO2       2
 #define BIT_R4_DE          11
+#define BIT_R4_STCIEN      14
 
 #define BIT_VOL_VOLUME   0
 #define BIT_VOL_SEEKTH   8
@@ -115,8 +117,14 @@
 #define MASK_VOL_VOLUME  0x000f
 #define MASK_VOL_SEEKTH  0x0f00
 
+#define MASK_R4_GPIO2    0x000c
+
 #define MASK_RA_READCHAN 0x3ff
 
+#define MASK_RB_BLER     0x03
+
+#define GPIO2_INT 1
+
 #define MAX_CHAN 0x3ff
 
 #define BV(x) (1 << (x))
@@ -268,15 +276,18 @@ esp_err_t rda5807m_get_state(rda5807m_t *dev, rda5807m_state_t *state)
     CHECK(read_registers_bulk(dev, r, 6));
     CHECK(read_register(dev, REG_CTRL, &ctrl));
 
-    if (ctrl & BIT_CTRL_SEEK) state->seek_status = RDA5807M_SEEK_STARTED;
-    else if (r[0] & BIT_RA_SF) state->seek_status = RDA5807M_SEEK_FAILED;
-    else if (r[0] & BIT_RA_STC) state->seek_status = RDA5807M_SEEK_COMPLETE;
+    if (ctrl & BV(BIT_CTRL_SEEK)) state->seek_status = RDA5807M_SEEK_STARTED;
+    else if (r[0] & BV(BIT_RA_SF)) state->seek_status = RDA5807M_SEEK_FAILED;
+    else if (r[0] & BV(BIT_RA_STC)) state->seek_status = RDA5807M_SEEK_COMPLETE;
     else state->seek_status = RDA5807M_SEEK_NONE;
 
     state->frequency = (r[0] & MASK_RA_READCHAN) * spacings[dev->spacing] + band_limits[dev->band].lower;
-    state->stereo = (r[0] & BIT_RA_ST) != 0;
-    state->station = (r[1] & BIT_RB_FM_ST) != 0;
-    state->rds_ready = (r[0] & BIT_RA_RDSR) != 0;
+    state->stereo = (r[0] & BV(BIT_RA_ST)) != 0;
+    state->station = (r[1] & BV(BIT_RB_FM_ST)) != 0;
+    state->rds_ready = (r[0] & BV(BIT_RA_RDSR)) != 0;
+    state->rds_sync = (r[0] & BV(BIT_RA_RDSS)) != 0;
+    state->rds_errors[0] = (r[1] >> BIT_RB_BLERA) & MASK_RB_BLER;
+    state->rds_errors[1] = (r[1] >> BIT_RB_BLERB) & MASK_RB_BLER;
     state->rssi = r[1] >> BIT_RB_RSSI;
 
     memcpy(state->rds, &r[2], 8);
@@ -551,3 +562,14 @@ esp_err_t rda5807m_seek_stop(rda5807m_t *dev)
     return ESP_OK;
 }
 
+esp_err_t rda5807m_set_interrupt(rda5807m_t *dev, bool enable)
+{
+    CHECK_ARG(dev);
+
+    CHECK(update_register(dev, REG_R4, BV(BIT_R4_STCIEN) | MASK_R4_GPIO2,
+            enable ? BV(BIT_R4_STCIEN) | (GPIO2_INT << BIT_R4_GPIO2) : 0));
+
+    ESP_LOGI(TAG, "GPIO2 interrupt %s", enable ? "enabled" : "disabled");
+
+    return ESP_OK;
+}
@@ -102,6 +102,8 @@ typedef struct
     bool station;                       //!< True if tuned to a station
     bool stereo;                        //!< True if stereo is available
     bool rds_ready;                     //!< True if RDS data is ready
+    bool rds_sync;                      //!< True if RDS decoder is synchronized
+    uint8_t rds_errors[2];              //!< Error levels of RDS blocks A and B, 0..3 (3 - uncorrectable)
     uint8_t rssi;                       //!< RSSI, 0..RDA5807M_RSSI_MAX (logarithmic scale)
     uint32_t frequency;                 //!< Current frequency, kHz
     uint16_t rds[4];                    //!< RDS data
@@ -340,6 +342,18 @@ esp_err_t rda5807m_seek_start(rda5807m_t *dev, bool up, bool wrap, uint8_t thres
  */
 esp_err_t rda5807m_seek_stop(rda5807m_t *dev);
 
+/**
+ * @brief Enable/disable interrupt output on GPIO2
+ *
+ * When enabled, GPIO2 of the device is pulled low on seek/tune complete
+ * and on RDS group ready. RDS interrupt lasts until RDS registers are read.
+ *
+ * @param dev Device descriptor
+ * @param enable Enable interrupt output
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_set_interrupt(rda5807m_t *dev, bool enable);
+
 /**@}*/
 
 #endif /* __RDA5807M_H__ */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rda5807m_rds.c
+ *
+ * Incremental RDS decoder for RDA5807M
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include "rda5807m_rds.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define GROUP_TYPE(b)  ((b) >> 12)
+#define GROUP_VER_B(b) (((b) >> 11) & 1)
+#define TP(b)          (((b) >> 10) & 1)
+#define PTY(b)         (((b) >> 5) & 0x1f)
+
+#define RT_END 0x0d
+
+// Days since 1970-01-01 to civil date
+static void civil_from_days(int32_t z, rda5807m_rds_ct_t *ct)
+{
+    z += 719468;
+    int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    ct->day = doy - (153 * mp + 2) / 5 + 1;
+    ct->month = mp < 10 ? mp + 3 : mp - 9;
+    ct->year = yoe + era * 400 + (ct->month <= 2);
+}
+
+static inline char rds_char(uint8_t c)
+{
+    return c < 0x20 ? ' ' : c;
+}
+
+static uint32_t decode_ps(rda5807m_rds_t *rds, const uint16_t *blocks)
+{
+    uint8_t seg = blocks[1] & 0x03;
+
+    rds->ta = (blocks[1] >> 4) & 1;
+    rds->music = (blocks[1] >> 3) & 1;
+
+    rds->ps_buf[seg * 2] = rds_char(blocks[3] >> 8);
+    rds->ps_buf[seg * 2 + 1] = rds_char(blocks[3]);
+    rds->ps_mask |= 1 << seg;
+    if (rds->ps_mask != 0x0f)
+        return 0;
+
+    // collect all segments again for the next name, so dynamic PS
+    // is never mixed from two names
+    rds->ps_mask = 0;
+    if ((rds->fields & RDA5807M_RDS_PS) && !memcmp(rds->ps, rds->ps_buf, RDA5807M_RDS_PS_LEN))
+        return 0;
+    memcpy(rds->ps, rds->ps_buf, RDA5807M_RDS_PS_LEN);
+    rds->fields |= RDA5807M_RDS_PS;
+
+    return RDA5807M_RDS_PS;
+}
+
+static uint32_t decode_rt(rda5807m_rds_t *rds, const uint16_t *blocks)
+{
+    bool ver_b = GROUP_VER_B(blocks[1]);
+    uint8_t ab = (blocks[1] >> 4) & 1;
+    uint8_t seg = blocks[1] & 0x0f;
+    uint8_t seg_len = ver_b ? 2 : 4;
+    uint8_t len = seg_len * 16;
+
+    // new text
+    if (ab != rds->rt_ab || ver_b != rds->rt_b)
+    {
+        memset(rds->rt_buf, ' ', sizeof(rds->rt_buf));
+        rds->rt_mask = 0;
+        rds->rt_ab = ab;
+        rds->rt_b = ver_b;
+    }
+
+    char *p = rds->rt_buf + seg * seg_len;
+    if (!ver_b)
+    {
+        *p++ = blocks[2] >> 8;
+        *p++ = blocks[2];
+    }
+    *p++ = blocks[3] >> 8;
+    *p = blocks[3];
+    rds->rt_mask |= 1 << seg;
+
+    // text is complete when all segments up to the end mark are received
+    for (uint8_t i = 0; i < len; i++)
+    {
+        if (!(rds->rt_mask & (1 << (i / seg_len))))
+            return 0;
+        if (rds->rt_buf[i] == RT_END)
+        {
+            len = i;
+            break;
+        }
+    }
+
+    char rt[RDA5807M_RDS_RT_LEN + 1];
+    for (uint8_t i = 0; i < len; i++)
+        rt[i] = rds_char(rds->rt_buf[i]);
+    // trailing spaces
+    while (len && rt[len - 1] == ' ')
+        len--;
+    rt[len] = 0;
+
+    if ((rds->fields & RDA5807M_RDS_RT) && !strcmp(rds->rt, rt))
+        return 0;
+    memcpy(rds->rt, rt, len + 1);
+    rds->fields |= RDA5807M_RDS_RT;
+
+    return RDA5807M_RDS_RT;
+}
+
+static uint32_t decode_ct(rda5807m_rds_t *rds, const uint16_t *blocks)
+{
+    uint32_t mjd = ((uint32_t)(blocks[1] & 0x03) << 15) | (blocks[2] >> 1);
+    uint8_t hour = ((blocks[2] & 1) << 4) | (blocks[3] >> 12);
+    uint8_t minute = (blocks[3] >> 6) & 0x3f;
+    int16_t offset = (blocks[3] & 0x1f) * 30;
+
+    // MJD 40587 is 1970-01-01
+    if (mjd < 40587 || hour > 23 || minute > 59)
+        return 0;
+
+    civil_from_days(mjd - 40587, &rds->ct);
+    rds->ct.hour = hour;
+    rds->ct.minute = minute;
+    rds->ct.offset = blocks[3] & 0x20 ? -offset : offset;
+    rds->fields |= RDA5807M_RDS_CT;
+
+    return RDA5807M_RDS_CT;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t rda5807m_rds_reset(rda5807m_rds_t *rds)
+{
+    CHECK_ARG(rds);
+
+    memset(rds, 0, sizeof(rda5807m_rds_t));
+    memset(rds->ps_buf, ' ', sizeof(rds->ps_buf));
+    memset(rds->rt_buf, ' ', sizeof(rds->rt_buf));
+    rds->rt_ab = -1;
+
+    return ESP_OK;
+}
+
+esp_err_t rda5807m_rds_decode(rda5807m_rds_t *rds, const rda5807m_rds_group_t *group, uint32_t *updated)
+{
+    CHECK_ARG(rds && group);
+
+    uint32_t res = 0;
+    const uint16_t *b = group->blocks;
+
+    if (group->errors[0] < RDA5807M_RDS_ERR_MAX
+            && (!(rds->fields & RDA5807M_RDS_PI) || rds->pi != b[0]))
+    {
+        rds->pi = b[0];
+        rds->fields |= RDA5807M_RDS_PI;
+        res |= RDA5807M_RDS_PI;
+    }
+
+    if (group->errors[1] < RDA5807M_RDS_ERR_MAX)
+    {
+        rds->tp = TP(b[1]);
+        rds->pty = PTY(b[1]);
+
+        switch (GROUP_TYPE(b[1]))
+        {
+            case 0:
+                res |= decode_ps(rds, b);
+                break;
+            case 2:
+                res |= decode_rt(rds, b);
+                break;
+            case 4:
+                if (!GROUP_VER_B(b[1]))
+                    res |= decode_ct(rds, b);
+                break;
+        }
+    }
+
+    if (updated)
+        *updated = res;
+
+    return ESP_OK;
+}
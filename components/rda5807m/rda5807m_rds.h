@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rda5807m_rds.h
+ * @defgroup rda5807m_rds rda5807m_rds
+ * @{
+ *
+ * Incremental RDS decoder for RDA5807M
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __RDA5807M_RDS_H__
+#define __RDA5807M_RDS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#define RDA5807M_RDS_PS_LEN 8  //!< Program service name length
+#define RDA5807M_RDS_RT_LEN 64 //!< Maximal radio text length
+
+#define RDA5807M_RDS_ERR_MAX 3 //!< Error level of uncorrectable block
+
+/**
+ * Decoded fields, flags
+ */
+typedef enum {
+    RDA5807M_RDS_PI = (1 << 0), //!< Program identification code
+    RDA5807M_RDS_PS = (1 << 1), //!< Program service name
+    RDA5807M_RDS_RT = (1 << 2), //!< Radio text
+    RDA5807M_RDS_CT = (1 << 3), //!< Clock time and date
+} rda5807m_rds_field_t;
+
+/**
+ * Raw RDS group
+ */
+typedef struct
+{
+    uint16_t blocks[4]; //!< Blocks A, B, C, D
+    uint8_t errors[2];  //!< Error levels of blocks A and B, 0..RDA5807M_RDS_ERR_MAX
+} rda5807m_rds_group_t;
+
+/**
+ * Clock time and date, group 4A
+ */
+typedef struct
+{
+    uint16_t year;      //!< Year, UTC
+    uint8_t month;      //!< Month, 1..12
+    uint8_t day;        //!< Day of month, 1..31
+    uint8_t hour;       //!< Hour, 0..23
+    uint8_t minute;     //!< Minute, 0..59
+    int16_t offset;     //!< Local time offset, minutes
+} rda5807m_rds_ct_t;
+
+/**
+ * Decoder state
+ */
+typedef struct
+{
+    uint16_t pi;                          //!< Program identification code
+    uint8_t pty;                          //!< Program type
+    bool tp;                              //!< Traffic program
+    bool ta;                              //!< Traffic announcement
+    bool music;                           //!< Music/speech switch
+    char ps[RDA5807M_RDS_PS_LEN + 1];     //!< Program service name
+    char rt[RDA5807M_RDS_RT_LEN + 1];     //!< Radio text
+    rda5807m_rds_ct_t ct;                 //!< Last received clock time
+    uint32_t fields;                      //!< Received fields, ::rda5807m_rds_field_t flags
+    char ps_buf[RDA5807M_RDS_PS_LEN];     //!< PS being received, internal
+    uint8_t ps_mask;                      //!< Received PS segments, internal
+    char rt_buf[RDA5807M_RDS_RT_LEN];     //!< RT being received, internal
+    uint16_t rt_mask;                     //!< Received RT segments, internal
+    int8_t rt_ab;                         //!< Text A/B flag, internal
+    bool rt_b;                            //!< RT is from version B groups, internal
+} rda5807m_rds_t;
+
+/**
+ * @brief Reset decoder state
+ *
+ * Should be called after tuning to another station.
+ *
+ * @param rds Decoder state
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_rds_reset(rda5807m_rds_t *rds);
+
+/**
+ * @brief Decode RDS group
+ *
+ * Groups 0A/0B (PS), 2A/2B (RT) and 4A (CT) are decoded, PS and RT
+ * are assembled from segments and published when complete.
+ * Groups with uncorrectable block B are ignored.
+ *
+ * @param rds Decoder state
+ * @param group Raw RDS group
+ * @param[out] updated Changed fields, ::rda5807m_rds_field_t flags, may be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_rds_decode(rda5807m_rds_t *rds, const rda5807m_rds_group_t *group, uint32_t *updated);
+
+/**@}*/
+
+#endif /* __RDA5807M_RDS_H__ */
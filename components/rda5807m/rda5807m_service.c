@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rda5807m_service.c
+ *
+ * Event-driven tuner service for RDA5807M
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_log.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include "rda5807m_service.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+static const char *TAG = "rda5807m_service";
+
+static const rda5807m_event_t rds_events[] = {
+    RDA5807M_EVENT_RDS_PI,
+    RDA5807M_EVENT_RDS_PS,
+    RDA5807M_EVENT_RDS_RT,
+    RDA5807M_EVENT_RDS_CT,
+};
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR int_isr(void *arg)
+#else
+static void int_isr(void *arg)
+#endif
+{
+    rda5807m_service_t *svc = (rda5807m_service_t *)arg;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(svc->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static inline void emit(rda5807m_service_t *svc, rda5807m_event_t event)
+{
+    if (svc->cb)
+        svc->cb(svc, event, svc->ctx);
+}
+
+static void push_group(rda5807m_service_t *svc, const rda5807m_rds_group_t *group)
+{
+    if (!svc->groups)
+        return;
+
+    if (xQueueSend(svc->groups, group, 0) != pdTRUE)
+    {
+        // drop the oldest group
+        rda5807m_rds_group_t old;
+        xQueueReceive(svc->groups, &old, 0);
+        xQueueSend(svc->groups, group, 0);
+        svc->overruns++;
+    }
+}
+
+static void service_task(void *arg)
+{
+    rda5807m_service_t *svc = (rda5807m_service_t *)arg;
+    TickType_t period = pdMS_TO_TICKS(svc->use_int ? RDA5807M_SERVICE_INT_POLL_MS : RDA5807M_SERVICE_POLL_MS);
+    uint32_t frequency = 0;
+    rda5807m_state_t state;
+
+    while (svc->running)
+    {
+        ulTaskNotifyTake(pdTRUE, period);
+        if (!svc->running)
+            break;
+
+        esp_err_t res = rda5807m_get_state(svc->dev, &state);
+        if (res != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Error reading state: %d (%s)", res, esp_err_to_name(res));
+            continue;
+        }
+
+        uint32_t updated = 0;
+        bool tuned = state.frequency != frequency && state.seek_status != RDA5807M_SEEK_STARTED;
+        rda5807m_rds_group_t group;
+        if (state.rds_ready)
+        {
+            memcpy(group.blocks, state.rds, sizeof(group.blocks));
+            memcpy(group.errors, state.rds_errors, sizeof(group.errors));
+        }
+
+        xSemaphoreTake(svc->lock, portMAX_DELAY);
+        svc->state = state;
+        if (tuned)
+            rda5807m_rds_reset(&svc->rds);
+        else if (state.rds_ready)
+            rda5807m_rds_decode(&svc->rds, &group, &updated);
+        xSemaphoreGive(svc->lock);
+
+        if (svc->seeking && state.seek_status != RDA5807M_SEEK_STARTED)
+        {
+            svc->seeking = false;
+            emit(svc, state.seek_status == RDA5807M_SEEK_FAILED
+                    ? RDA5807M_EVENT_SEEK_FAILED
+                    : RDA5807M_EVENT_SEEK_COMPLETE);
+        }
+        if (tuned)
+        {
+            frequency = state.frequency;
+            emit(svc, RDA5807M_EVENT_TUNED);
+            continue;
+        }
+        if (!state.rds_ready)
+            continue;
+
+        push_group(svc, &group);
+        for (size_t i = 0; i < sizeof(rds_events) / sizeof(rds_events[0]); i++)
+            if (updated & (1 << i))
+                emit(svc, rds_events[i]);
+    }
+
+    svc->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t rda5807m_service_start(rda5807m_service_t *svc, size_t buf_size, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(svc && svc->dev && !svc->task);
+
+    rda5807m_rds_reset(&svc->rds);
+    svc->overruns = 0;
+    svc->seeking = false;
+    svc->groups = NULL;
+
+    svc->lock = xSemaphoreCreateMutex();
+    if (!svc->lock)
+        return ESP_ERR_NO_MEM;
+
+    esp_err_t res = ESP_ERR_NO_MEM;
+    if (buf_size && !(svc->groups = xQueueCreate(buf_size, sizeof(rda5807m_rds_group_t))))
+        goto fail;
+
+    svc->running = true;
+    if (xTaskCreate(service_task, TAG, stack_size, svc, priority, &svc->task) != pdPASS)
+    {
+        svc->task = NULL;
+        goto fail;
+    }
+
+    if (!svc->use_int)
+        return ESP_OK;
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << svc->int_gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    if ((res = gpio_config(&io_conf)) != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(svc->int_gpio, int_isr, svc)) != ESP_OK)
+        goto fail;
+
+    if ((res = rda5807m_set_interrupt(svc->dev, true)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    rda5807m_service_stop(svc);
+    return res;
+}
+
+esp_err_t rda5807m_service_stop(rda5807m_service_t *svc)
+{
+    CHECK_ARG(svc);
+
+    if (svc->use_int)
+    {
+        gpio_isr_handler_remove(svc->int_gpio);
+        gpio_set_intr_type(svc->int_gpio, GPIO_INTR_DISABLE);
+    }
+
+    svc->running = false;
+    while (svc->task)
+    {
+        xTaskNotifyGive(svc->task);
+        vTaskDelay(1);
+    }
+
+    if (svc->groups)
+    {
+        vQueueDelete(svc->groups);
+        svc->groups = NULL;
+    }
+    if (svc->lock)
+    {
+        vSemaphoreDelete(svc->lock);
+        svc->lock = NULL;
+    }
+
+    return svc->use_int ? rda5807m_set_interrupt(svc->dev, false) : ESP_OK;
+}
+
+esp_err_t rda5807m_service_seek(rda5807m_service_t *svc, bool up, bool wrap, uint8_t threshold)
+{
+    CHECK_ARG(svc && svc->task);
+
+    esp_err_t res = rda5807m_seek_start(svc->dev, up, wrap, threshold);
+    if (res == ESP_OK)
+        svc->seeking = true;
+
+    return res;
+}
+
+esp_err_t rda5807m_service_get_rds(rda5807m_service_t *svc, rda5807m_rds_t *rds)
+{
+    CHECK_ARG(svc && svc->lock && rds);
+
+    xSemaphoreTake(svc->lock, portMAX_DELAY);
+    *rds = svc->rds;
+    xSemaphoreGive(svc->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t rda5807m_service_get_state(rda5807m_service_t *svc, rda5807m_state_t *state)
+{
+    CHECK_ARG(svc && svc->lock && state);
+
+    xSemaphoreTake(svc->lock, portMAX_DELAY);
+    *state = svc->state;
+    xSemaphoreGive(svc->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t rda5807m_service_read_groups(rda5807m_service_t *svc, rda5807m_rds_group_t *groups, size_t max,
+        size_t *count, uint32_t timeout_ms)
+{
+    CHECK_ARG(svc && svc->groups && groups && max && count);
+
+    *count = 0;
+    if (xQueueReceive(svc->groups, groups, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    size_t n = 1;
+    while (n < max && xQueueReceive(svc->groups, groups + n, 0) == pdTRUE)
+        n++;
+    *count = n;
+
+    return ESP_OK;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rda5807m_service.h
+ * @defgroup rda5807m_service rda5807m_service
+ * @{
+ *
+ * Event-driven tuner service for RDA5807M: RDS decoding and seek
+ * completion events
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __RDA5807M_SERVICE_H__
+#define __RDA5807M_SERVICE_H__
+
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "rda5807m.h"
+#include "rda5807m_rds.h"
+
+/**
+ * Status polling period without interrupt, ms.
+ * RDS groups come every ~88 ms, so every group is read.
+ */
+#define RDA5807M_SERVICE_POLL_MS 40
+
+/**
+ * Status polling period with interrupt, ms. Safety net for lost interrupts.
+ */
+#define RDA5807M_SERVICE_INT_POLL_MS 500
+
+/**
+ * Service events
+ */
+typedef enum {
+    RDA5807M_EVENT_SEEK_COMPLETE = 0, //!< Seek finished on a station
+    RDA5807M_EVENT_SEEK_FAILED,       //!< Seek finished, no station found
+    RDA5807M_EVENT_TUNED,             //!< Frequency changed, RDS data is reset
+    RDA5807M_EVENT_RDS_PI,            //!< New program identification code
+    RDA5807M_EVENT_RDS_PS,            //!< New program service name
+    RDA5807M_EVENT_RDS_RT,            //!< New radio text
+    RDA5807M_EVENT_RDS_CT,            //!< Clock time received
+} rda5807m_event_t;
+
+struct rda5807m_service_s;
+
+/**
+ * Event callback, called from the service task
+ */
+typedef void (*rda5807m_service_cb_t)(struct rda5807m_service_s *svc, rda5807m_event_t event, void *ctx);
+
+/**
+ * Service descriptor
+ */
+typedef struct rda5807m_service_s
+{
+    rda5807m_t *dev;                //!< Device descriptor
+    bool use_int;                   //!< GPIO2 of the device is connected to `int_gpio`
+    gpio_num_t int_gpio;            //!< GPIO connected to GPIO2 of the device
+    rda5807m_service_cb_t cb;       //!< Event callback, may be NULL
+    void *ctx;                      //!< Callback context
+    rda5807m_rds_t rds;             //!< Decoder state, internal
+    rda5807m_state_t state;         //!< Last device state, internal
+    SemaphoreHandle_t lock;         //!< State lock, internal
+    QueueHandle_t groups;           //!< Raw RDS groups ring buffer, internal
+    TaskHandle_t task;              //!< Service task, internal
+    volatile bool running;          //!< Service state, internal
+    volatile bool seeking;          //!< Seek started by service, internal
+    uint32_t overruns;              //!< Number of dropped RDS groups
+} rda5807m_service_t;
+
+/**
+ * @brief Start tuner service
+ *
+ * Service task reads status registers on every interrupt from GPIO2
+ * (or periodically when interrupt is not wired), decodes RDS groups
+ * and reports events through the callback. Raw groups are also put
+ * to a ring buffer, the oldest group is dropped when it is full.
+ *
+ * @param svc Service descriptor, `dev`, `use_int`, `int_gpio`, `cb`, `ctx` must be set
+ * @param buf_size Size of raw RDS groups ring buffer, 0 to disable
+ * @param priority Service task priority
+ * @param stack_size Service task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_service_start(rda5807m_service_t *svc, size_t buf_size, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop tuner service
+ *
+ * @param svc Service descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_service_stop(rda5807m_service_t *svc);
+
+/**
+ * @brief Start seeking, completion is reported by event
+ *
+ * @param svc Service descriptor
+ * @param up Seeking direction: true - up, false - down
+ * @param wrap Wrap at the band limit and continue seeking
+ * @param threshold Seeking SNR threshold, 0..`RDA5807M_SEEK_TH_MAX`
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_service_seek(rda5807m_service_t *svc, bool up, bool wrap, uint8_t threshold);
+
+/**
+ * @brief Get copy of the decoded RDS data
+ *
+ * @param svc Service descriptor
+ * @param[out] rds Decoded RDS data
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_service_get_rds(rda5807m_service_t *svc, rda5807m_rds_t *rds);
+
+/**
+ * @brief Get last device state read by service
+ *
+ * @param svc Service descriptor
+ * @param[out] state Device state
+ * @return `ESP_OK` on success
+ */
+esp_err_t rda5807m_service_get_state(rda5807m_service_t *svc, rda5807m_state_t *state);
+
+/**
+ * @brief Read raw RDS groups from ring buffer
+ *
+ * Waits for the first group, then copies all available groups
+ * without waiting.
+ *
+ * @param svc Service descriptor
+ * @param[out] groups Buffer for groups
+ * @param max Buffer size, groups
+ * @param[out] count Number of copied groups
+ * @param timeout_ms Time to wait for the first group
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if no groups
+ */
+esp_err_t rda5807m_service_read_groups(rda5807m_service_t *svc, rda5807m_rds_group_t *groups, size_t max,
+        size_t *count, uint32_t timeout_ms);
+
+/**@}*/
+
+#endif /* __RDA5807M_SERVICE_H__ */
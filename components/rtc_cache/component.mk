@@ -0,0 +1,2 @@
+COMPONENT_ADD_INCLUDEDIRS = .
+COMPONENT_DEPENDS = driver freertos log esp_idf_lib_helpers ds3231 ds1307 pcf8563
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rtc_cache.c
+ *
+ * Cached RTC time advanced by 1 Hz square wave interrupt
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
+#include <esp_idf_lib_helpers.h>
+#include <ds3231.h>
+#include <ds1307.h>
+#include <pcf8563.h>
+#include "rtc_cache.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// more than one period of 1 Hz output
+#define SYNC_TIMEOUT_MS 1500
+
+#if HELPER_TARGET_IS_ESP32
+static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL_ISR portENTER_CRITICAL_ISR(&mux)
+#define PORT_EXIT_CRITICAL_ISR portEXIT_CRITICAL_ISR(&mux)
+#else
+#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
+#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL_ISR
+#define PORT_EXIT_CRITICAL_ISR
+#endif
+
+static const char *TAG = "rtc_cache";
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR tick_isr(void *arg)
+#else
+static void tick_isr(void *arg)
+#endif
+{
+    rtc_cache_t *cache = (rtc_cache_t *)arg;
+
+    PORT_ENTER_CRITICAL_ISR;
+    cache->now++;
+    cache->tick_time = esp_timer_get_time();
+    PORT_EXIT_CRITICAL_ISR;
+
+    if (!cache->sync_pending)
+        return;
+    cache->sync_pending = false;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(cache->tick, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+// Days since 1970-01-01 of Gregorian date, independent of TZ
+static int32_t days_from_civil(int32_t y, uint32_t m, uint32_t d)
+{
+    y -= m <= 2;
+    int32_t era = (y >= 0 ? y : y - 399) / 400;
+    uint32_t yoe = (uint32_t)(y - era * 400);
+    uint32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+static time_t tm_to_epoch(const struct tm *t)
+{
+    int32_t days = days_from_civil(t->tm_year + 1900, t->tm_mon + 1, t->tm_mday);
+    return (time_t)days * 86400 + t->tm_hour * 3600 + t->tm_min * 60 + t->tm_sec;
+}
+
+static esp_err_t read_rtc(rtc_cache_t *cache, struct tm *t)
+{
+    bool valid;
+
+    switch (cache->chip)
+    {
+        case RTC_CACHE_DS3231:
+            return ds3231_get_time(cache->dev, t);
+        case RTC_CACHE_DS1307:
+            return ds1307_get_time(cache->dev, t);
+        case RTC_CACHE_PCF8563:
+            CHECK(pcf8563_get_time(cache->dev, t, &valid));
+            if (!valid)
+            {
+                ESP_LOGE(TAG, "RTC time is not valid");
+                return ESP_ERR_INVALID_STATE;
+            }
+            return ESP_OK;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+static esp_err_t enable_output(rtc_cache_t *cache, bool enable)
+{
+    switch (cache->chip)
+    {
+        case RTC_CACHE_DS3231:
+            if (!enable)
+                return ds3231_disable_squarewave(cache->dev);
+            CHECK(ds3231_set_squarewave_freq(cache->dev, DS3231_SQWAVE_1HZ));
+            return ds3231_enable_squarewave(cache->dev);
+        case RTC_CACHE_DS1307:
+            if (enable)
+                CHECK(ds1307_set_squarewave_freq(cache->dev, DS1307_1HZ));
+            return ds1307_enable_squarewave(cache->dev, enable);
+        case RTC_CACHE_PCF8563:
+            return pcf8563_set_clkout(cache->dev, enable ? PCF8563_1HZ : PCF8563_DISABLED);
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+static void resync_task(void *arg)
+{
+    rtc_cache_t *cache = (rtc_cache_t *)arg;
+
+    while (cache->running)
+    {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(cache->resync_s * 1000));
+        if (!cache->running)
+            break;
+        rtc_cache_sync(cache);
+    }
+
+    cache->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t rtc_cache_start(rtc_cache_t *cache, uint32_t resync_s, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(cache && cache->dev && cache->chip <= RTC_CACHE_PCF8563 && !cache->tick);
+
+    cache->tick = xSemaphoreCreateBinary();
+    if (!cache->tick)
+        return ESP_ERR_NO_MEM;
+    cache->valid = false;
+    cache->sync_pending = false;
+    cache->drift = 0;
+    cache->resync_s = resync_s;
+
+    // all supported outputs are open drain
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << cache->gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    esp_err_t res = gpio_config(&io_conf);
+    if (res != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(cache->gpio, tick_isr, cache)) != ESP_OK)
+        goto fail;
+
+    if ((res = enable_output(cache, true)) != ESP_OK)
+        goto fail;
+    if ((res = rtc_cache_sync(cache)) != ESP_OK)
+        goto fail;
+
+    if (resync_s)
+    {
+        cache->running = true;
+        if (xTaskCreate(resync_task, TAG, stack_size, cache, priority, &cache->task) != pdPASS)
+        {
+            cache->running = false;
+            cache->task = NULL;
+            res = ESP_ERR_NO_MEM;
+            goto fail;
+        }
+    }
+
+    return ESP_OK;
+
+fail:
+    rtc_cache_stop(cache);
+    return res;
+}
+
+esp_err_t rtc_cache_stop(rtc_cache_t *cache)
+{
+    CHECK_ARG(cache);
+
+    cache->running = false;
+    while (cache->task)
+    {
+        xTaskNotifyGive(cache->task);
+        vTaskDelay(1);
+    }
+
+    gpio_isr_handler_remove(cache->gpio);
+    gpio_set_intr_type(cache->gpio, GPIO_INTR_DISABLE);
+
+    cache->valid = false;
+    if (cache->tick)
+    {
+        vSemaphoreDelete(cache->tick);
+        cache->tick = NULL;
+    }
+
+    return enable_output(cache, false);
+}
+
+esp_err_t rtc_cache_sync(rtc_cache_t *cache)
+{
+    CHECK_ARG(cache && cache->tick);
+
+    // time registers are read right after the edge, far from the next update
+    xSemaphoreTake(cache->tick, 0);
+    cache->sync_pending = true;
+    if (xSemaphoreTake(cache->tick, pdMS_TO_TICKS(SYNC_TIMEOUT_MS)) != pdTRUE)
+    {
+        cache->sync_pending = false;
+        ESP_LOGE(TAG, "No 1 Hz signal on GPIO %d", cache->gpio);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    struct tm t;
+    CHECK(read_rtc(cache, &t));
+    time_t rtc = tm_to_epoch(&t);
+
+    PORT_ENTER_CRITICAL;
+    int32_t drift = cache->valid ? (int32_t)(rtc - cache->now) : 0;
+    cache->now = rtc;
+    cache->valid = true;
+    PORT_EXIT_CRITICAL;
+
+    cache->drift = drift;
+    if (drift)
+        ESP_LOGW(TAG, "Cached time was %d s off RTC", (int)drift);
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_cache_get_epoch(rtc_cache_t *cache, time_t *t, uint32_t *us)
+{
+    CHECK_ARG(cache && t);
+
+    PORT_ENTER_CRITICAL;
+    bool valid = cache->valid;
+    time_t now = cache->now;
+    int64_t tick_time = cache->tick_time;
+    PORT_EXIT_CRITICAL;
+
+    if (!valid)
+        return ESP_ERR_INVALID_STATE;
+
+    *t = now;
+    if (us)
+    {
+        int64_t elapsed = esp_timer_get_time() - tick_time;
+        *us = elapsed < 1000000 ? (uint32_t)elapsed : 999999;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_cache_get_time(rtc_cache_t *cache, struct tm *time)
+{
+    CHECK_ARG(cache && time);
+
+    time_t t;
+    CHECK(rtc_cache_get_epoch(cache, &t, NULL));
+    gmtime_r(&t, time);
+
+    return ESP_OK;
+}
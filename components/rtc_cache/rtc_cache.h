@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rtc_cache.h
+ * @defgroup rtc_cache rtc_cache
+ * @{
+ *
+ * Cached RTC time advanced by 1 Hz square wave interrupt
+ *
+ * RTC is read once, then the cached time is incremented on every falling
+ * edge of the 1 Hz SQW/CLKOUT output, so getting time is a memory read.
+ * RTC is re-read periodically to catch missed edges. Supported RTCs:
+ * DS3231, DS1307, PCF8563.
+ *
+ * Time is handled as stored in RTC, without timezone conversion.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __RTC_CACHE_H__
+#define __RTC_CACHE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <driver/gpio.h>
+#include <i2cdev.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * RTC chip
+ */
+typedef enum {
+    RTC_CACHE_DS3231 = 0, //!< DS3231, INT/SQW output
+    RTC_CACHE_DS1307,     //!< DS1307, SQW/OUT output
+    RTC_CACHE_PCF8563,    //!< PCF8563, CLKOUT output
+} rtc_cache_chip_t;
+
+/**
+ * Cache descriptor
+ *
+ * Fill `chip`, `dev` and `gpio` before ::rtc_cache_start(), other fields
+ * are internal.
+ */
+typedef struct
+{
+    rtc_cache_chip_t chip;      //!< RTC chip
+    i2c_dev_t *dev;             //!< Initialized RTC device descriptor
+    gpio_num_t gpio;            //!< GPIO connected to SQW/CLKOUT (open drain, internal pull-up is enabled)
+
+    volatile time_t now;        //!< Cached time
+    volatile int64_t tick_time; //!< Time of last edge, us (esp_timer)
+    volatile bool sync_pending; //!< Waiting for edge to read RTC
+    bool valid;                 //!< Cached time is valid
+    int32_t drift;              //!< RTC time minus cached time at last re-sync, seconds
+    uint32_t resync_s;          //!< Re-sync period, seconds
+    SemaphoreHandle_t tick;     //!< Edge semaphore for sync
+    TaskHandle_t task;          //!< Re-sync task
+    volatile bool running;      //!< Re-sync task is running
+} rtc_cache_t;
+
+/**
+ * @brief Start cache
+ *
+ * Enables 1 Hz output of RTC, installs GPIO interrupt handler and reads RTC
+ * right after the next edge, so it takes up to 1 s.
+ *
+ * @param cache Cache descriptor
+ * @param resync_s Period of RTC re-read, seconds, 0 to disable re-sync task
+ * @param priority Re-sync task priority
+ * @param stack_size Re-sync task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_cache_start(rtc_cache_t *cache, uint32_t resync_s, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop cache
+ *
+ * Removes interrupt handler and disables 1 Hz output of RTC.
+ *
+ * @param cache Cache descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_cache_stop(rtc_cache_t *cache);
+
+/**
+ * @brief Re-read RTC at next edge
+ *
+ * Call after setting RTC time. Takes up to 1 s.
+ *
+ * @param cache Cache descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_cache_sync(rtc_cache_t *cache);
+
+/**
+ * @brief Get cached time as seconds since epoch
+ *
+ * No bus access, can be called from any task.
+ *
+ * @param cache Cache descriptor
+ * @param[out] t Time
+ * @param[out] us Microseconds since the last edge, NULL-able
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if cache is not synced
+ */
+esp_err_t rtc_cache_get_epoch(rtc_cache_t *cache, time_t *t, uint32_t *us);
+
+/**
+ * @brief Get cached time
+ *
+ * Same as `*_get_time()` functions of RTC drivers, but without bus access.
+ *
+ * @param cache Cache descriptor
+ * @param[out] time Time
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if cache is not synced
+ */
+esp_err_t rtc_cache_get_time(rtc_cache_t *cache, struct tm *time);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __RTC_CACHE_H__ */
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rtc_ram.c
+ *
+ * Journaled record storage in battery-backed RAM of DS1302/DS1307
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_log.h>
+#include <ds1302.h>
+#include <ds1307.h>
+#include "rtc_ram.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define MAX_RAM_SIZE DS1307_RAM_SIZE
+
+static const char *TAG = "rtc_ram";
+
+static uint8_t crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = 0xff;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++)
+            crc = crc & 0x80 ? (crc << 1) ^ 0x31 : crc << 1;
+    }
+    return crc;
+}
+
+static inline uint8_t slot_size(const rtc_ram_t *store)
+{
+    return store->record_size + RTC_RAM_OVERHEAD;
+}
+
+static esp_err_t ram_read(rtc_ram_t *store, uint8_t offset, uint8_t *buf, uint8_t len)
+{
+    switch (store->chip)
+    {
+        case RTC_RAM_DS1302:
+            return ds1302_read_sram((ds1302_t *)store->dev, store->offset + offset, buf, len);
+        case RTC_RAM_DS1307:
+            return ds1307_read_ram((i2c_dev_t *)store->dev, store->offset + offset, buf, len);
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+static esp_err_t ram_write(rtc_ram_t *store, uint8_t offset, uint8_t *buf, uint8_t len)
+{
+    switch (store->chip)
+    {
+        case RTC_RAM_DS1302:
+            return ds1302_write_sram((ds1302_t *)store->dev, store->offset + offset, buf, len);
+        case RTC_RAM_DS1307:
+            return ds1307_write_ram((i2c_dev_t *)store->dev, store->offset + offset, buf, len);
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t rtc_ram_init(rtc_ram_t *store, rtc_ram_chip_t chip, void *dev, uint8_t offset, uint8_t size,
+        uint8_t record_size)
+{
+    CHECK_ARG(store && dev && chip <= RTC_RAM_DS1307 && record_size);
+
+    uint8_t ram_size = chip == RTC_RAM_DS1302 ? DS1302_RAM_SIZE : DS1307_RAM_SIZE;
+    CHECK_ARG((uint32_t)offset + size <= ram_size);
+
+    uint8_t slots = size / (record_size + RTC_RAM_OVERHEAD);
+    if (slots < 2)
+    {
+        ESP_LOGE(TAG, "Storage area is too small for record of %d bytes", record_size);
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    memset(store, 0, sizeof(rtc_ram_t));
+    store->chip = chip;
+    store->dev = dev;
+    store->offset = offset;
+    store->record_size = record_size;
+    store->slots = slots;
+    store->head = slots - 1;
+    store->seq = 0xff;
+    store->empty = true;
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_ram_load(rtc_ram_t *store, void *record, bool *found)
+{
+    CHECK_ARG(store && store->slots && record && found);
+
+    uint8_t buf[MAX_RAM_SIZE];
+    uint8_t ss = slot_size(store);
+    CHECK(ram_read(store, 0, buf, ss * store->slots));
+
+    store->empty = true;
+    for (uint8_t i = 0; i < store->slots; i++)
+    {
+        const uint8_t *slot = buf + i * ss;
+        if (crc8(slot, ss - 1) != slot[ss - 1])
+            continue;
+        // sequence numbers of valid slots differ by less than number of slots
+        if (store->empty || (int8_t)(slot[0] - store->seq) > 0)
+        {
+            store->head = i;
+            store->seq = slot[0];
+            store->empty = false;
+        }
+    }
+
+    *found = !store->empty;
+    if (store->empty)
+    {
+        // next save goes to slot 0 with sequence number 0
+        store->head = store->slots - 1;
+        store->seq = 0xff;
+        return ESP_OK;
+    }
+
+    memcpy(record, buf + store->head * ss + 1, store->record_size);
+    ESP_LOGD(TAG, "Loaded record %d from slot %d", store->seq, store->head);
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_ram_save(rtc_ram_t *store, const void *record)
+{
+    CHECK_ARG(store && store->slots && record);
+
+    uint8_t buf[MAX_RAM_SIZE];
+    uint8_t ss = slot_size(store);
+    uint8_t head = (store->head + 1) % store->slots;
+    uint8_t seq = store->seq + 1;
+
+    buf[0] = seq;
+    memcpy(buf + 1, record, store->record_size);
+    buf[ss - 1] = crc8(buf, ss - 1);
+    CHECK(ram_write(store, head * ss, buf, ss));
+
+    store->head = head;
+    store->seq = seq;
+    store->empty = false;
+
+    return ESP_OK;
+}
+
+esp_err_t rtc_ram_erase(rtc_ram_t *store)
+{
+    CHECK_ARG(store && store->slots);
+
+    uint8_t buf[MAX_RAM_SIZE];
+    uint8_t ss = slot_size(store);
+
+    memset(buf, 0, ss * store->slots);
+    // make sure CRC of every slot is wrong
+    for (uint8_t i = 0; i < store->slots; i++)
+        buf[i * ss + ss - 1] = ~crc8(buf + i * ss, ss - 1);
+    CHECK(ram_write(store, 0, buf, ss * store->slots));
+
+    store->head = store->slots - 1;
+    store->seq = 0xff;
+    store->empty = true;
+
+    return ESP_OK;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file rtc_ram.h
+ * @defgroup rtc_ram rtc_ram
+ * @{
+ *
+ * Journaled record storage in battery-backed RAM of DS1302/DS1307
+ *
+ * RAM area is split into slots of equal size. Every save writes the record
+ * to the next slot with an incremented sequence number and CRC, so the
+ * previous record survives a reset or power loss during write. Load
+ * returns the valid record with the highest sequence number.
+ *
+ * Slot layout: sequence number (1 byte), record, CRC-8 of both (1 byte).
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __RTC_RAM_H__
+#define __RTC_RAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RTC_RAM_OVERHEAD 2 //!< Bytes of slot used by sequence number and CRC
+
+/**
+ * RTC chip
+ */
+typedef enum {
+    RTC_RAM_DS1302 = 0, //!< DS1302, 31 bytes of RAM, `dev` is `ds1302_t *`
+    RTC_RAM_DS1307,     //!< DS1307, 56 bytes of RAM, `dev` is `i2c_dev_t *`
+} rtc_ram_chip_t;
+
+/**
+ * Storage descriptor
+ */
+typedef struct
+{
+    rtc_ram_chip_t chip;    //!< RTC chip
+    void *dev;              //!< Initialized device descriptor
+    uint8_t offset;         //!< Offset of storage area in RAM
+    uint8_t record_size;    //!< Record size, bytes
+    uint8_t slots;          //!< Number of slots
+    uint8_t head;           //!< Slot of the last record
+    uint8_t seq;            //!< Sequence number of the last record
+    bool empty;             //!< No valid record found
+} rtc_ram_t;
+
+/**
+ * @brief Initialize storage descriptor
+ *
+ * RAM is not accessed. At least two slots must fit into the area.
+ *
+ * @param store Storage descriptor
+ * @param chip RTC chip
+ * @param dev Initialized device descriptor
+ * @param offset Offset of storage area in RAM
+ * @param size Size of storage area, bytes
+ * @param record_size Record size, bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_ram_init(rtc_ram_t *store, rtc_ram_chip_t chip, void *dev, uint8_t offset, uint8_t size,
+        uint8_t record_size);
+
+/**
+ * @brief Load the last valid record
+ *
+ * Whole storage area is read at once. Must be called before
+ * ::rtc_ram_save(), usually at boot.
+ *
+ * @param store Storage descriptor
+ * @param[out] record Buffer of `record_size` bytes, untouched if no record found
+ * @param[out] found true if valid record was found
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_ram_load(rtc_ram_t *store, void *record, bool *found);
+
+/**
+ * @brief Save record to the next slot
+ *
+ * @param store Storage descriptor
+ * @param record Record of `record_size` bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_ram_save(rtc_ram_t *store, const void *record);
+
+/**
+ * @brief Invalidate all records
+ *
+ * @param store Storage descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t rtc_ram_erase(rtc_ram_t *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __RTC_RAM_H__ */
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sample_log.c
+ *
+ * Batched binary logging of sensor samples to a raw flash partition
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <esp_log.h>
+#include "sample_log.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define BLOCKS_PER_SECTOR (SAMPLE_LOG_SECTOR_SIZE / SAMPLE_LOG_BLOCK_SIZE)
+#define PAYLOAD_SIZE (SAMPLE_LOG_BLOCK_SIZE - SAMPLE_LOG_HEADER_SIZE)
+// id, descriptor and time as 10-byte varint; values as 5-byte varints
+#define MAX_HEAD_SIZE (2 + 10)
+#define MAX_VALUES_SIZE (SAMPLE_LOG_MAX_VALUES * 5)
+#define EMPTY_SEQ 0xffffffff
+
+#if SAMPLE_LOG_BLOCK_SIZE % 256 || SAMPLE_LOG_SECTOR_SIZE % SAMPLE_LOG_BLOCK_SIZE
+#error SAMPLE_LOG_BLOCK_SIZE must be a multiple of 256 dividing SAMPLE_LOG_SECTOR_SIZE
+#endif
+
+static const char *TAG = "sample_log";
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len)
+{
+    // zlib CRC-32, nibble table
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = table[(crc ^ data[i]) & 0x0f] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0f] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static inline uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    *p++ = v;
+    *p++ = v >> 8;
+    return p;
+}
+
+static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, v);
+    return put_u16(p, v >> 16);
+}
+
+static inline uint32_t get_u32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint8_t *put_varint(uint8_t *p, int64_t v)
+{
+    uint64_t z = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    while (z >= 0x80)
+    {
+        *p++ = z | 0x80;
+        z >>= 7;
+    }
+    *p++ = z;
+    return p;
+}
+
+static inline uint8_t *ram_block(const sample_log_t *log, size_t n)
+{
+    return log->ram + n * SAMPLE_LOG_BLOCK_SIZE;
+}
+
+// Fill header of the head block, it becomes pending
+static void close_block(sample_log_t *log)
+{
+    uint8_t *b = ram_block(log, log->head);
+    uint8_t *p = put_u16(b, SAMPLE_LOG_MAGIC);
+    *p++ = SAMPLE_LOG_VERSION;
+    *p++ = SAMPLE_LOG_BLOCK_SIZE / 256;
+    p = put_u32(p, log->seq++);
+    p = put_u16(p, log->used);
+    p = put_u16(p, log->records);
+    uint32_t crc = crc32(0, b, 12);
+    crc = crc32(crc, b + SAMPLE_LOG_HEADER_SIZE, log->used);
+    put_u32(p, crc);
+    // Erased flash state, so the rest of the page costs nothing to program
+    memset(b + SAMPLE_LOG_HEADER_SIZE + log->used, 0xff, PAYLOAD_SIZE - log->used);
+
+    log->pending++;
+    log->head = (log->head + 1) % log->ram_blocks;
+    log->used = 0;
+    log->records = 0;
+    log->last_ms = 0;
+}
+
+static esp_err_t read_seq(const sample_log_t *log, size_t block, uint32_t *seq)
+{
+    uint8_t h[8];
+    CHECK(esp_partition_read(log->partition, block * SAMPLE_LOG_BLOCK_SIZE, h, sizeof(h)));
+    bool valid = h[0] == (SAMPLE_LOG_MAGIC & 0xff) && h[1] == SAMPLE_LOG_MAGIC >> 8
+        && h[3] == SAMPLE_LOG_BLOCK_SIZE / 256;
+    *seq = valid ? get_u32(h + 4) : EMPTY_SEQ;
+    return ESP_OK;
+}
+
+// Find the block after the one with the highest sequence number
+static esp_err_t find_head(sample_log_t *log)
+{
+    uint32_t last = EMPTY_SEQ, seq;
+    size_t sector = 0;
+    // Sectors are filled in order, so the last one is found by its first block
+    for (size_t s = 0; s < log->flash_blocks / BLOCKS_PER_SECTOR; s++)
+    {
+        CHECK(read_seq(log, s * BLOCKS_PER_SECTOR, &seq));
+        if (seq != EMPTY_SEQ && (last == EMPTY_SEQ || seq > last))
+        {
+            last = seq;
+            sector = s;
+        }
+    }
+    log->next = 0;
+    log->seq = 0;
+    if (last == EMPTY_SEQ)
+        return ESP_OK;
+
+    size_t block = sector * BLOCKS_PER_SECTOR;
+    for (size_t i = 1; i < BLOCKS_PER_SECTOR; i++)
+    {
+        CHECK(read_seq(log, block + i, &seq));
+        if (seq == EMPTY_SEQ)
+            break;
+        last = seq;
+        block++;
+    }
+    log->next = (block + 1) % log->flash_blocks;
+    log->seq = last + 1;
+    ESP_LOGD(TAG, "Last block %u, sequence %u", (unsigned)block, (unsigned)last);
+
+    return ESP_OK;
+}
+
+esp_err_t sample_log_init(sample_log_t *log, const esp_partition_t *partition, size_t ram_blocks)
+{
+    CHECK_ARG(log && partition && ram_blocks >= 2);
+    CHECK_ARG(partition->size >= SAMPLE_LOG_SECTOR_SIZE && !(partition->size % SAMPLE_LOG_SECTOR_SIZE));
+
+    memset(log, 0, sizeof(sample_log_t));
+    log->partition = partition;
+    log->flash_blocks = partition->size / SAMPLE_LOG_BLOCK_SIZE;
+    log->ram_blocks = ram_blocks;
+
+    CHECK(find_head(log));
+
+    log->ram = malloc(ram_blocks * SAMPLE_LOG_BLOCK_SIZE);
+    log->lock = xSemaphoreCreateMutex();
+    if (!log->ram || !log->lock)
+    {
+        ESP_LOGE(TAG, "Not enough memory");
+        sample_log_free(log);
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t sample_log_free(sample_log_t *log)
+{
+    CHECK_ARG(log);
+
+    free(log->ram);
+    log->ram = NULL;
+    if (log->lock)
+        vSemaphoreDelete(log->lock);
+    log->lock = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t sample_log_write(sample_log_t *log, uint8_t id, int64_t time_ms, uint8_t scale,
+        const int32_t *values, uint8_t count)
+{
+    CHECK_ARG(log && log->ram && values && count && count <= SAMPLE_LOG_MAX_VALUES
+            && scale <= SAMPLE_LOG_MAX_SCALE);
+
+    // Values are encoded on stack, so the lock is held for the time delta
+    // and a copy only
+    uint8_t vals[MAX_VALUES_SIZE];
+    uint8_t *p = vals;
+    for (uint8_t i = 0; i < count; i++)
+        p = put_varint(p, values[i]);
+    size_t vals_size = p - vals;
+
+    uint8_t head[MAX_HEAD_SIZE];
+    head[0] = id;
+    head[1] = (scale << 4) | (count - 1);
+
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+
+    size_t size = put_varint(head + 2, time_ms - log->last_ms) - head;
+
+    if (log->used + size + vals_size > PAYLOAD_SIZE)
+    {
+        // Head block must stay free for new records
+        if (log->pending + 1 >= log->ram_blocks)
+        {
+            log->dropped++;
+            xSemaphoreGive(log->lock);
+            return ESP_ERR_NO_MEM;
+        }
+        close_block(log);
+        // First record of a block has absolute time
+        size = put_varint(head + 2, time_ms) - head;
+    }
+    uint8_t *dst = ram_block(log, log->head) + SAMPLE_LOG_HEADER_SIZE + log->used;
+    memcpy(dst, head, size);
+    memcpy(dst + size, vals, vals_size);
+    size += vals_size;
+    log->used += size;
+    log->records++;
+    log->last_ms = time_ms;
+
+    xSemaphoreGive(log->lock);
+
+    return ESP_OK;
+}
+
+static esp_err_t write_block(sample_log_t *log, const uint8_t *block)
+{
+    size_t offset = log->next * SAMPLE_LOG_BLOCK_SIZE;
+    if (!(offset % SAMPLE_LOG_SECTOR_SIZE))
+        CHECK(esp_partition_erase_range(log->partition, offset, SAMPLE_LOG_SECTOR_SIZE));
+    CHECK(esp_partition_write(log->partition, offset, block, SAMPLE_LOG_BLOCK_SIZE));
+    log->next = (log->next + 1) % log->flash_blocks;
+    log->written++;
+
+    return ESP_OK;
+}
+
+esp_err_t sample_log_flush(sample_log_t *log)
+{
+    CHECK_ARG(log && log->ram);
+
+    while (true)
+    {
+        xSemaphoreTake(log->lock, portMAX_DELAY);
+        size_t pending = log->pending;
+        const uint8_t *block = ram_block(log, log->tail);
+        xSemaphoreGive(log->lock);
+        if (!pending)
+            break;
+
+        // Pending blocks are not touched by writers
+        esp_err_t res = write_block(log, block);
+        if (res != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Could not write block %u: %d", (unsigned)log->next, res);
+            return res;
+        }
+
+        xSemaphoreTake(log->lock, portMAX_DELAY);
+        log->tail = (log->tail + 1) % log->ram_blocks;
+        log->pending--;
+        xSemaphoreGive(log->lock);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t sample_log_sync(sample_log_t *log)
+{
+    CHECK_ARG(log && log->ram);
+
+    CHECK(sample_log_flush(log));
+    xSemaphoreTake(log->lock, portMAX_DELAY);
+    if (log->records && log->pending + 1 < log->ram_blocks)
+        close_block(log);
+    xSemaphoreGive(log->lock);
+
+    return sample_log_flush(log);
+}
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sample_log.h
+ * @defgroup sample_log sample_log
+ * @{
+ *
+ * Batched binary logging of sensor samples to a raw flash partition
+ *
+ * Samples are encoded as compact fixed-point records into blocks in RAM.
+ * Complete blocks are written to the partition by ::sample_log_flush() as
+ * whole, page-aligned units with a CRC, so flash is written only once per
+ * block instead of once per sample. The partition is used as a ring: the
+ * next sector is erased when the write position enters it, so all sectors
+ * wear out evenly and the oldest samples are overwritten. Partition dumps
+ * are decoded on the host by `sample_log_decode.py` of this component.
+ *
+ * Block format, integers are little endian:
+ *
+ *     header:  u16 magic (SAMPLE_LOG_MAGIC), u8 version (1),
+ *              u8 block size / 256, u32 sequence number,
+ *              u16 payload size, u16 number of records,
+ *              u32 CRC-32 (zlib) of header bytes 0..11 and payload
+ *     payload: records
+ *
+ * Record: u8 sensor id, u8 (scale << 4 | (number of values - 1)),
+ * varint time delta in ms, varint values. Varints are zigzag encoded
+ * LEB128. Time of the first record of a block is the delta from 0, of
+ * the others from the previous record. Value is `raw / 10^scale`.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __SAMPLE_LOG_H__
+#define __SAMPLE_LOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <esp_partition.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SAMPLE_LOG_BLOCK_SIZE
+#define SAMPLE_LOG_BLOCK_SIZE 512     //!< Block size, multiple of 256 dividing SAMPLE_LOG_SECTOR_SIZE
+#endif
+
+#define SAMPLE_LOG_SECTOR_SIZE 4096   //!< Flash erase unit
+#define SAMPLE_LOG_MAGIC 0x4c53       //!< First bytes of block, "SL"
+#define SAMPLE_LOG_VERSION 1          //!< Format version
+#define SAMPLE_LOG_HEADER_SIZE 16     //!< Block header size, bytes
+#define SAMPLE_LOG_MAX_VALUES 16      //!< Maximal number of values in one record
+#define SAMPLE_LOG_MAX_SCALE 15       //!< Maximal decimal scale of values
+
+/**
+ * Log descriptor
+ */
+typedef struct
+{
+    const esp_partition_t *partition; //!< Data partition
+    size_t flash_blocks;     //!< Number of blocks in partition
+    size_t next;             //!< Partition block written next
+    uint32_t seq;            //!< Sequence number of next block
+    uint8_t *ram;            //!< Blocks in RAM
+    size_t ram_blocks;       //!< Number of blocks in RAM
+    size_t head;             //!< RAM block being filled
+    size_t tail;             //!< Oldest complete RAM block
+    size_t pending;          //!< Number of complete RAM blocks not written yet
+    size_t used;             //!< Payload bytes of the head block
+    uint16_t records;        //!< Records in the head block
+    int64_t last_ms;         //!< Time of the last record of the head block
+    uint32_t dropped;        //!< Records dropped because all RAM blocks were pending
+    uint32_t written;        //!< Blocks written to flash
+    SemaphoreHandle_t lock;  //!< Internal: protects RAM blocks
+} sample_log_t;
+
+/**
+ * @brief Initialize log
+ *
+ * Partition is scanned for the last written block, logging continues
+ * after it.
+ *
+ * @param log        Log descriptor
+ * @param partition  Data partition, size must be a multiple of SAMPLE_LOG_SECTOR_SIZE
+ * @param ram_blocks Number of blocks buffered in RAM, at least 2
+ * @return `ESP_OK` on success
+ */
+esp_err_t sample_log_init(sample_log_t *log, const esp_partition_t *partition, size_t ram_blocks);
+
+/**
+ * @brief Free log
+ *
+ * Records not written by ::sample_log_sync() are lost.
+ *
+ * @param log Log descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t sample_log_free(sample_log_t *log);
+
+/**
+ * @brief Add record to log
+ *
+ * Record is encoded into RAM, flash is not touched. When all RAM blocks
+ * are waiting for ::sample_log_flush(), the record is dropped. Can be
+ * called from several tasks.
+ *
+ * @param log     Log descriptor
+ * @param id      Sensor id
+ * @param time_ms Timestamp, ms
+ * @param scale   Decimal scale of values, 0..SAMPLE_LOG_MAX_SCALE
+ * @param values  Fixed-point values, `raw / 10^scale`
+ * @param count   Number of values, 1..SAMPLE_LOG_MAX_VALUES
+ * @return `ESP_OK` on success, `ESP_ERR_NO_MEM` if record was dropped
+ */
+esp_err_t sample_log_write(sample_log_t *log, uint8_t id, int64_t time_ms, uint8_t scale,
+        const int32_t *values, uint8_t count);
+
+/**
+ * @brief Write complete RAM blocks to flash
+ *
+ * Flash is written without holding the lock of RAM blocks, so writers
+ * are not blocked. Call it from one task, e.g. when `pending` reaches a
+ * threshold.
+ *
+ * @param log Log descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t sample_log_flush(sample_log_t *log);
+
+/**
+ * @brief Close the partially filled block and write all blocks to flash
+ *
+ * Costs a whole block of flash, use it before sleep or power off.
+ *
+ * @param log Log descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t sample_log_sync(sample_log_t *log);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __SAMPLE_LOG_H__ */
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+"""
+Decoder of sample_log partition dumps
+
+Dump the partition with
+`parttool.py read_partition --partition-name log --output log.bin`
+and print its records as CSV: time in ms, sensor id and values.
+Blocks with wrong CRC (e.g. interrupted by power loss) are skipped.
+
+Usage:
+  sample_log_decode.py log.bin > log.csv
+  sample_log_decode.py --id 3 log.bin
+
+See sample_log.h for format description.
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+MAGIC = 0x4c53
+VERSION = 1
+HEADER = struct.Struct('<HBBIHHI')
+MIN_BLOCK = 256
+
+
+def varint(data, pos):
+    shift = 0
+    res = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        res |= (b & 0x7f) << shift
+        shift += 7
+        if not b & 0x80:
+            break
+    return (res >> 1) ^ -(res & 1), pos
+
+
+def blocks(data):
+    pos = 0
+    while pos + HEADER.size <= len(data):
+        magic, version, size, seq, used, records, crc = HEADER.unpack_from(data, pos)
+        if magic != MAGIC or version != VERSION or not size:
+            pos += MIN_BLOCK
+            continue
+        step = size * MIN_BLOCK
+        payload = data[pos + HEADER.size:pos + HEADER.size + used]
+        if used <= step - HEADER.size and \
+                zlib.crc32(payload, zlib.crc32(data[pos:pos + 12])) == crc:
+            yield seq, records, payload
+        else:
+            sys.stderr.write('Bad block at 0x%x\n' % pos)
+        pos += step
+
+
+def records(payload, count):
+    pos = 0
+    time = 0
+    for _ in range(count):
+        sensor, desc = payload[pos], payload[pos + 1]
+        pos += 2
+        delta, pos = varint(payload, pos)
+        time += delta
+        scale = desc >> 4
+        values = []
+        for _ in range((desc & 0x0f) + 1):
+            v, pos = varint(payload, pos)
+            values.append(v / 10 ** scale if scale else v)
+        yield time, sensor, values
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--id', type=int, action='append', help='print records of sensor only, can be repeated')
+    parser.add_argument('dump', help='partition dump')
+    args = parser.parse_args()
+
+    data = open(args.dump, 'rb').read()
+    out = sys.stdout
+    out.write('time_ms,id,values\n')
+    # Partition is a ring, oldest block has the lowest sequence number
+    for _, count, payload in sorted(blocks(data)):
+        for time, sensor, values in records(payload, count):
+            if args.id and sensor not in args.id:
+                continue
+            out.write('%d,%d,%s\n' % (time, sensor, ','.join(str(v) for v in values)))
+
+
+if __name__ == '__main__':
+    main()
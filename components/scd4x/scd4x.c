@@ -40,8 +40,11 @@
  */
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <string.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 #include <esp_idf_lib_helpers.h>
+#include <sensirion.h>
 #include "scd4x.h"
 
 #define I2C_FREQ_HZ 100000 // 100kHz
@@ -71,95 +74,18 @@ static const char *TAG = "scd4x";
 #define CMD_POWER_DOWN                             (0x36E0)
 #define CMD_WAKE_UP                                (0x36F6)
 
+#define PERIOD_MS                 5000
+#define PERIOD_LOW_POWER_MS       30000
+#define TIME_SINGLE_SHOT_MS       5000
+#define TIME_SINGLE_SHOT_RHT_MS   50
+#define TIME_WAKE_UP_MS           20
+#define TIME_REINIT_MS            SCD4X_REINIT_TIME_MS
+// delay between data-ready checks when data is late
+#define POLL_RETRY_MS             100
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-static uint8_t crc8(const uint8_t *data, size_t count)
-{
-    uint8_t res = 0xff;
-
-    for (size_t i = 0; i < count; ++i)
-    {
-        res ^= data[i];
-        for (uint8_t bit = 8; bit > 0; --bit)
-        {
-            if (res & 0x80)
-                res = (res << 1) ^ 0x31;
-            else
-                res = (res << 1);
-        }
-    }
-    return res;
-}
-
-static inline uint16_t swap(uint16_t v)
-{
-    return (v << 8) | (v >> 8);
-}
-
-static esp_err_t send_cmd(i2c_dev_t *dev, uint16_t cmd, uint16_t *data, size_t words)
-{
-    uint8_t buf[2 + words * 3];
-    // add command
-    *(uint16_t *)buf = swap(cmd);
-    if (data && words)
-        // add arguments
-        for (size_t i = 0; i < words; i++)
-        {
-            uint8_t *p = buf + 2 + i * 3;
-            *(uint16_t *)p = swap(data[i]);
-            *(p + 2) = crc8(p, 2);
-        }
-
-    ESP_LOGV(TAG, "Sending buffer:");
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, buf, sizeof(buf), ESP_LOG_VERBOSE);
-
-    return i2c_dev_write(dev, NULL, 0, buf, sizeof(buf));
-}
-
-static esp_err_t read_resp(i2c_dev_t *dev, uint16_t *data, size_t words)
-{
-    uint8_t buf[words * 3];
-    CHECK(i2c_dev_read(dev, NULL, 0, buf, sizeof(buf)));
-
-    ESP_LOGV(TAG, "Received buffer:");
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, buf, sizeof(buf), ESP_LOG_VERBOSE);
-
-    for (size_t i = 0; i < words; i++)
-    {
-        uint8_t *p = buf + i * 3;
-        uint8_t crc = crc8(p, 2);
-        if (crc != *(p + 2))
-        {
-            ESP_LOGE(TAG, "Invalid CRC 0x%02x, expected 0x%02x", crc, *(p + 2));
-            return ESP_ERR_INVALID_CRC;
-        }
-        data[i] = swap(*(uint16_t *)p);
-    }
-    return ESP_OK;
-}
-
-static esp_err_t execute_cmd(i2c_dev_t *dev, uint16_t cmd, uint32_t timeout_ms,
-        uint16_t *out_data, size_t out_words, uint16_t *in_data, size_t in_words)
-{
-    CHECK_ARG(dev);
-
-    I2C_DEV_TAKE_MUTEX(dev);
-    I2C_DEV_CHECK(dev, send_cmd(dev, cmd, out_data, out_words));
-    if (timeout_ms)
-    {
-        if (timeout_ms > 10)
-            vTaskDelay(pdMS_TO_TICKS(timeout_ms));
-        else
-            ets_delay_us(timeout_ms * 1000);
-    }
-    if (in_data && in_words)
-        I2C_DEV_CHECK(dev, read_resp(dev, in_data, in_words));
-    I2C_DEV_GIVE_MUTEX(dev);
-
-    return ESP_OK;
-}
-
 ///////////////////////////////////////////////////////////////////////////////
 
 esp_err_t scd4x_init_desc(i2c_dev_t *dev, i2c_port_t port, gpio_num_t sda_gpio, gpio_num_t scl_gpio)
@@ -186,7 +112,7 @@ esp_err_t scd4x_free_desc(i2c_dev_t *dev)
 
 esp_err_t scd4x_start_periodic_measurement(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_START_PERIODIC_MEASUREMENT, 1, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_START_PERIODIC_MEASUREMENT, 1, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_read_measurement_ticks(i2c_dev_t *dev, uint16_t *co2, uint16_t *temperature, uint16_t *humidity)
@@ -194,7 +120,7 @@ esp_err_t scd4x_read_measurement_ticks(i2c_dev_t *dev, uint16_t *co2, uint16_t *
     CHECK_ARG(co2 || temperature || humidity);
 
     uint16_t buf[3];
-    CHECK(execute_cmd(dev, CMD_READ_MEASUREMENT, 1, NULL, 0, buf, 3));
+    CHECK(sensirion_execute_cmd(dev, CMD_READ_MEASUREMENT, 1, NULL, 0, buf, 3));
     if (co2)
         *co2 = buf[0];
     if (temperature)
@@ -221,14 +147,14 @@ esp_err_t scd4x_read_measurement(i2c_dev_t *dev, uint16_t *co2, float *temperatu
 
 esp_err_t scd4x_stop_periodic_measurement(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_STOP_PERIODIC_MEASUREMENT, 500, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_STOP_PERIODIC_MEASUREMENT, 500, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_get_temperature_offset_ticks(i2c_dev_t *dev, uint16_t *t_offset)
 {
     CHECK_ARG(t_offset);
 
-    return execute_cmd(dev, CMD_GET_TEMPERATURE_OFFSET, 1, NULL, 0, t_offset, 1);
+    return sensirion_execute_cmd(dev, CMD_GET_TEMPERATURE_OFFSET, 1, NULL, 0, t_offset, 1);
 }
 
 esp_err_t scd4x_get_temperature_offset(i2c_dev_t *dev, float *t_offset)
@@ -245,7 +171,7 @@ esp_err_t scd4x_get_temperature_offset(i2c_dev_t *dev, float *t_offset)
 
 esp_err_t scd4x_set_temperature_offset_ticks(i2c_dev_t *dev, uint16_t t_offset)
 {
-    return execute_cmd(dev, CMD_SET_TEMPERATURE_OFFSET, 1, &t_offset, 1, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_SET_TEMPERATURE_OFFSET, 1, &t_offset, 1, NULL, 0);
 }
 
 esp_err_t scd4x_set_temperature_offset(i2c_dev_t *dev, float t_offset)
@@ -258,17 +184,17 @@ esp_err_t scd4x_get_sensor_altitude(i2c_dev_t *dev, uint16_t *altitude)
 {
     CHECK_ARG(altitude);
 
-    return execute_cmd(dev, CMD_GET_SENSOR_ALTITUDE, 1, NULL, 0, altitude, 1);
+    return sensirion_execute_cmd(dev, CMD_GET_SENSOR_ALTITUDE, 1, NULL, 0, altitude, 1);
 }
 
 esp_err_t scd4x_set_sensor_altitude(i2c_dev_t *dev, uint16_t altitude)
 {
-    return execute_cmd(dev, CMD_SET_SENSOR_ALTITUDE, 1, &altitude, 1, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_SET_SENSOR_ALTITUDE, 1, &altitude, 1, NULL, 0);
 }
 
 esp_err_t scd4x_set_ambient_ressure(i2c_dev_t *dev, uint16_t pressure)
 {
-    return execute_cmd(dev, CMD_SET_AMBIENT_PRESSURE, 1, &pressure, 1, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_SET_AMBIENT_PRESSURE, 1, &pressure, 1, NULL, 0);
 }
 
 esp_err_t scd4x_perform_forced_recalibration(i2c_dev_t *dev, uint16_t target_co2_concentration,
@@ -276,7 +202,7 @@ esp_err_t scd4x_perform_forced_recalibration(i2c_dev_t *dev, uint16_t target_co2
 {
     CHECK_ARG(frc_correction);
 
-    return execute_cmd(dev, CMD_PERFORM_FORCED_RECALIBRATION, 400,
+    return sensirion_execute_cmd(dev, CMD_PERFORM_FORCED_RECALIBRATION, 400,
             &target_co2_concentration, 1, frc_correction, 1);
 }
 
@@ -284,17 +210,17 @@ esp_err_t scd4x_get_automatic_self_calibration(i2c_dev_t *dev, bool *enabled)
 {
     CHECK_ARG(enabled);
 
-    return execute_cmd(dev, CMD_GET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1, NULL, 0, (uint16_t *)enabled, 1);
+    return sensirion_execute_cmd(dev, CMD_GET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1, NULL, 0, (uint16_t *)enabled, 1);
 }
 
 esp_err_t scd4x_set_automatic_self_calibration(i2c_dev_t *dev, bool enabled)
 {
-    return execute_cmd(dev, CMD_SET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1, (uint16_t *)&enabled, 1, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_SET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1, (uint16_t *)&enabled, 1, NULL, 0);
 }
 
 esp_err_t scd4x_start_low_power_periodic_measurement(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_START_LOW_POWER_PERIODIC_MEASUREMENT, 0, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_START_LOW_POWER_PERIODIC_MEASUREMENT, 0, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_get_data_ready_status(i2c_dev_t *dev, bool *data_ready)
@@ -302,15 +228,16 @@ esp_err_t scd4x_get_data_ready_status(i2c_dev_t *dev, bool *data_ready)
     CHECK_ARG(data_ready);
 
     uint16_t status;
-    CHECK(execute_cmd(dev, CMD_GET_DATA_READY_STATUS, 1, NULL, 0, &status, 1));
-    *data_ready = status != 0;
+    CHECK(sensirion_execute_cmd(dev, CMD_GET_DATA_READY_STATUS, 1, NULL, 0, &status, 1));
+    // data is ready if any of 11 least significant bits is set
+    *data_ready = (status & 0x7ff) != 0;
 
     return ESP_OK;
 }
 
 esp_err_t scd4x_persist_settings(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_PERSIST_SETTINGS, 800, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_PERSIST_SETTINGS, 800, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_get_serial_number(i2c_dev_t *dev, uint16_t *serial0, uint16_t *serial1, uint16_t *serial2)
@@ -318,7 +245,7 @@ esp_err_t scd4x_get_serial_number(i2c_dev_t *dev, uint16_t *serial0, uint16_t *s
     CHECK_ARG(serial0 && serial1 && serial2);
 
     uint16_t buf[3];
-    CHECK(execute_cmd(dev, CMD_GET_SERIAL_NUMBER, 1, NULL, 0, buf, 3));
+    CHECK(sensirion_execute_cmd(dev, CMD_GET_SERIAL_NUMBER, 1, NULL, 0, buf, 3));
     *serial0 = buf[0];
     *serial1 = buf[1];
     *serial2 = buf[2];
@@ -330,35 +257,203 @@ esp_err_t scd4x_perform_self_test(i2c_dev_t *dev, bool *malfunction)
 {
     CHECK_ARG(malfunction);
 
-    return execute_cmd(dev, CMD_PERFORM_SELF_TEST, 10000, NULL, 0, (uint16_t *)malfunction, 1);
+    return sensirion_execute_cmd(dev, CMD_PERFORM_SELF_TEST, 10000, NULL, 0, (uint16_t *)malfunction, 1);
 }
 
 esp_err_t scd4x_perform_factory_reset(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_PERFORM_FACTORY_RESET, 800, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_PERFORM_FACTORY_RESET, 800, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_reinit(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_REINIT, 20, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_REINIT, TIME_REINIT_MS, NULL, 0, NULL, 0);
+}
+
+esp_err_t scd4x_start_reinit(i2c_dev_t *dev)
+{
+    return sensirion_execute_cmd(dev, CMD_REINIT, 0, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_measure_single_shot(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_MEASURE_SINGLE_SHOT, 5000, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_MEASURE_SINGLE_SHOT, 5000, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_measure_single_shot_rht_only(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_MEASURE_SINGLE_SHOT_RHT_ONLY, 50, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_MEASURE_SINGLE_SHOT_RHT_ONLY, 50, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_power_down(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_POWER_DOWN, 1, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(dev, CMD_POWER_DOWN, 1, NULL, 0, NULL, 0);
 }
 
 esp_err_t scd4x_wake_up(i2c_dev_t *dev)
 {
-    return execute_cmd(dev, CMD_WAKE_UP, 20, NULL, 0, NULL, 0);
+    CHECK_ARG(dev);
+
+    // sensor may not acknowledge wake up command, but still needs time to wake
+    esp_err_t res = sensirion_execute_cmd(dev, CMD_WAKE_UP, 0, NULL, 0, NULL, 0);
+    vTaskDelay(pdMS_TO_TICKS(TIME_WAKE_UP_MS));
+
+    return res;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static inline uint32_t measurement_time_ms(scd4x_poller_t *poller)
+{
+    switch (poller->mode)
+    {
+        case SCD4X_POLL_PERIODIC:
+            return PERIOD_MS;
+        case SCD4X_POLL_LOW_POWER:
+            return PERIOD_LOW_POWER_MS;
+        case SCD4X_POLL_SINGLE_SHOT:
+            return TIME_SINGLE_SHOT_MS;
+        default:
+            return TIME_SINGLE_SHOT_RHT_MS;
+    }
+}
+
+static inline bool is_single_shot(scd4x_poller_t *poller)
+{
+    return poller->mode == SCD4X_POLL_SINGLE_SHOT || poller->mode == SCD4X_POLL_SINGLE_SHOT_RHT;
+}
+
+static esp_err_t start_single_shot(scd4x_poller_t *poller)
+{
+    if (poller->power_down)
+    {
+        // sensor does not acknowledge wake up command
+        poller->dev->quiet = true;
+        scd4x_wake_up(poller->dev);
+        poller->dev->quiet = false;
+    }
+
+    poller->started = esp_timer_get_time();
+    CHECK(sensirion_execute_cmd(poller->dev,
+            poller->mode == SCD4X_POLL_SINGLE_SHOT ? CMD_MEASURE_SINGLE_SHOT : CMD_MEASURE_SINGLE_SHOT_RHT_ONLY,
+            0, NULL, 0, NULL, 0));
+    poller->pending = true;
+    poller->next = poller->started + measurement_time_ms(poller) * 1000LL;
+
+    return ESP_OK;
+}
+
+esp_err_t scd4x_poller_start(scd4x_poller_t *poller, i2c_dev_t *dev, scd4x_poll_mode_t mode,
+        uint32_t interval_ms, bool power_down)
+{
+    CHECK_ARG(poller && dev && mode <= SCD4X_POLL_SINGLE_SHOT_RHT);
+
+    memset(poller, 0, sizeof(scd4x_poller_t));
+    poller->dev = dev;
+    poller->mode = mode;
+
+    switch (mode)
+    {
+        case SCD4X_POLL_PERIODIC:
+            CHECK(scd4x_start_periodic_measurement(dev));
+            break;
+        case SCD4X_POLL_LOW_POWER:
+            CHECK(scd4x_start_low_power_periodic_measurement(dev));
+            break;
+        default:
+            CHECK_ARG(interval_ms >= measurement_time_ms(poller));
+            poller->interval_ms = interval_ms;
+            poller->power_down = power_down;
+            if (power_down)
+                CHECK(scd4x_power_down(dev));
+            return start_single_shot(poller);
+    }
+
+    poller->interval_ms = measurement_time_ms(poller);
+    poller->started = esp_timer_get_time();
+    poller->next = poller->started + poller->interval_ms * 1000LL;
+
+    return ESP_OK;
+}
+
+esp_err_t scd4x_poller_poll(scd4x_poller_t *poller, bool *fresh)
+{
+    CHECK_ARG(poller && poller->dev && fresh);
+
+    *fresh = false;
+    int64_t now = esp_timer_get_time();
+    if (now < poller->next)
+        return ESP_OK;
+
+    if (is_single_shot(poller) && !poller->pending)
+        return start_single_shot(poller);
+
+    bool ready;
+    CHECK(scd4x_get_data_ready_status(poller->dev, &ready));
+    if (!ready)
+    {
+        poller->not_ready++;
+        poller->next = now + POLL_RETRY_MS * 1000LL;
+        return ESP_OK;
+    }
+
+    CHECK(scd4x_read_measurement_ticks(poller->dev, &poller->co2, &poller->temperature, &poller->humidity));
+    *fresh = true;
+
+    if (is_single_shot(poller))
+    {
+        poller->pending = false;
+        if (poller->power_down)
+            CHECK(scd4x_power_down(poller->dev));
+        poller->next = poller->started + poller->interval_ms * 1000LL;
+    }
+    else
+    {
+        // align the next read to the sensor cadence
+        poller->started = now;
+        poller->next = now + poller->interval_ms * 1000LL;
+    }
+
+    return ESP_OK;
+}
+
+uint32_t scd4x_poller_get_delay(scd4x_poller_t *poller)
+{
+    if (!poller)
+        return 0;
+
+    int64_t now = esp_timer_get_time();
+
+    return poller->next > now ? (poller->next - now + 999) / 1000 : 0;
+}
+
+esp_err_t scd4x_poller_get_results(scd4x_poller_t *poller, uint16_t *co2, float *temperature, float *humidity)
+{
+    CHECK_ARG(poller && (co2 || temperature || humidity));
+
+    if (co2)
+        *co2 = poller->co2;
+    if (temperature)
+        *temperature = (float)poller->temperature * 175.0f / 65536.0f - 45.0f;
+    if (humidity)
+        *humidity = (float)poller->humidity * 100.0f / 65536.0f;
+
+    return ESP_OK;
+}
+
+esp_err_t scd4x_poller_stop(scd4x_poller_t *poller)
+{
+    CHECK_ARG(poller && poller->dev);
+
+    if (!is_single_shot(poller))
+        CHECK(scd4x_stop_periodic_measurement(poller->dev));
+    else if (poller->power_down && !poller->pending)
+    {
+        poller->dev->quiet = true;
+        scd4x_wake_up(poller->dev);
+        poller->dev->quiet = false;
+    }
+    poller->dev = NULL;
+
+    return ESP_OK;
 }
@@ -53,6 +53,35 @@ extern "C" {
 
 #define SCD4X_I2C_ADDR 0x62
 
+#define SCD4X_REINIT_TIME_MS 20 //!< Execution time of reinit command, ms
+
+/**
+ * Poller measurement mode
+ */
+typedef enum {
+    SCD4X_POLL_PERIODIC = 0,   //!< Periodic measurement, 5 s
+    SCD4X_POLL_LOW_POWER,      //!< Low power periodic measurement, 30 s
+    SCD4X_POLL_SINGLE_SHOT,    //!< Single shot measurements with given interval
+    SCD4X_POLL_SINGLE_SHOT_RHT //!< Single shot RH/T only measurements with given interval
+} scd4x_poll_mode_t;
+
+/**
+ * Data-ready driven poller
+ */
+typedef struct {
+    i2c_dev_t *dev;          //!< Device descriptor
+    scd4x_poll_mode_t mode;  //!< Measurement mode
+    uint32_t interval_ms;    //!< Interval between measurements, ms
+    bool power_down;         //!< Put sensor to sleep between single shot measurements
+    bool pending;            //!< Single shot measurement is in progress
+    int64_t next;            //!< Time of next bus access, us
+    int64_t started;         //!< Time of the last measurement start, us
+    uint16_t co2;            //!< Last CO₂ concentration, ppm
+    uint16_t temperature;    //!< Last temperature, ticks
+    uint16_t humidity;       //!< Last humidity, ticks
+    uint32_t not_ready;      //!< Number of data-ready checks returned no data
+} scd4x_poller_t;
+
 /**
  * @brief Initialize device descriptor.
  *
@@ -373,6 +402,19 @@ esp_err_t scd4x_perform_factory_reset(i2c_dev_t *dev);
  */
 esp_err_t scd4x_reinit(i2c_dev_t *dev);
 
+/**
+ * @brief Send reinit command without waiting for its execution.
+ *
+ * Same as ::scd4x_reinit(), but next command may be sent not earlier than
+ * ::SCD4X_REINIT_TIME_MS after this function.
+ *
+ * @note Only available in idle mode.
+ *
+ * @param dev Device descriptor
+ * @return    `ESP_OK` on success
+ */
+esp_err_t scd4x_start_reinit(i2c_dev_t *dev);
+
 /**
  * @brief Perform single measurement.
  *
@@ -419,6 +461,72 @@ esp_err_t scd4x_power_down(i2c_dev_t *dev);
  */
 esp_err_t scd4x_wake_up(i2c_dev_t *dev);
 
+/**
+ * @brief Start data-ready driven measurements
+ *
+ * In periodic modes measurement is started once and bus is accessed only
+ * when the next result is expected: data-ready status is checked first and
+ * the measurement is read only if it is set.
+ *
+ * In single shot modes the poller starts a measurement every `interval_ms`
+ * without blocking. If `power_down` is true, sensor is woken up before
+ * and put to sleep after each measurement, which is the lowest power
+ * option for battery nodes. `interval_ms` and `power_down` are ignored in
+ * periodic modes.
+ *
+ * Sensor must be in idle mode.
+ *
+ * @param poller      Poller descriptor
+ * @param dev         Device descriptor
+ * @param mode        Measurement mode
+ * @param interval_ms Interval between single shot measurements, ms
+ * @param power_down  Sleep between single shot measurements
+ * @return            `ESP_OK` on success
+ */
+esp_err_t scd4x_poller_start(scd4x_poller_t *poller, i2c_dev_t *dev, scd4x_poll_mode_t mode,
+        uint32_t interval_ms, bool power_down);
+
+/**
+ * @brief Advance poller state machine
+ *
+ * Function never blocks for the measurement time. Call it at any rate,
+ * e.g. after waiting ::scd4x_poller_get_delay().
+ *
+ * @param poller      Poller descriptor
+ * @param[out] fresh  true if new measurement was read
+ * @return            `ESP_OK` on success
+ */
+esp_err_t scd4x_poller_poll(scd4x_poller_t *poller, bool *fresh);
+
+/**
+ * @brief Get time until the next bus access of poller
+ *
+ * Use it to sleep between polls.
+ *
+ * @param poller Poller descriptor
+ * @return       Delay in ms, 0 if poller has to be called now
+ */
+uint32_t scd4x_poller_get_delay(scd4x_poller_t *poller);
+
+/**
+ * @brief Get last measurement of poller
+ *
+ * @param poller           Poller descriptor
+ * @param[out] co2         CO₂ concentration in ppm, optional
+ * @param[out] temperature Temperature in °C, optional
+ * @param[out] humidity    Relative humidity in %, optional
+ * @return                 `ESP_OK` on success
+ */
+esp_err_t scd4x_poller_get_results(scd4x_poller_t *poller, uint16_t *co2, float *temperature, float *humidity);
+
+/**
+ * @brief Stop poller and return sensor to idle mode
+ *
+ * @param poller Poller descriptor
+ * @return       `ESP_OK` on success
+ */
+esp_err_t scd4x_poller_stop(scd4x_poller_t *poller);
+
 #ifdef __cplusplus
 }
 #endif
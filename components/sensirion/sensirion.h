@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sensirion.h
+ * @defgroup sensirion sensirion
+ * @{
+ *
+ * Common I2C word protocol of Sensirion sensors
+ *
+ * Sensirion sensors exchange data as big-endian 16-bit words, each word
+ * is followed by CRC8 checksum (polynomial 0x31, init 0xff).
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __SENSIRION_H__
+#define __SENSIRION_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <i2cdev.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSIRION_WORD_SIZE 3 //!< Size of word with CRC on the bus, bytes
+
+/**
+ * @brief Calculate CRC8 checksum
+ *
+ * @param data Data
+ * @param count Data size, bytes
+ * @return CRC8
+ */
+uint8_t sensirion_crc8(const uint8_t *data, size_t count);
+
+/**
+ * @brief Pack words with checksums into bus format
+ *
+ * @param[out] buf Buffer of `count * SENSIRION_WORD_SIZE` bytes
+ * @param words Words
+ * @param count Number of words
+ */
+void sensirion_pack_words(uint8_t *buf, const uint16_t *words, size_t count);
+
+/**
+ * @brief Verify checksums and unpack words received from the bus
+ *
+ * All words of the buffer are checked and decoded in one pass.
+ *
+ * @param buf Buffer of `count * SENSIRION_WORD_SIZE` bytes
+ * @param[out] words Decoded words, optional. Untouched on CRC failure
+ * @param count Number of words
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_CRC` if any checksum is invalid
+ */
+esp_err_t sensirion_unpack_words(const uint8_t *buf, uint16_t *words, size_t count);
+
+/**
+ * @brief Send 16-bit command with optional arguments
+ *
+ * Function does not take device mutex.
+ *
+ * @param dev Device descriptor
+ * @param cmd Command
+ * @param data Arguments, optional
+ * @param words Number of arguments
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensirion_send_cmd(i2c_dev_t *dev, uint16_t cmd, const uint16_t *data, size_t words);
+
+/**
+ * @brief Read words with one burst and check them
+ *
+ * Function does not take device mutex.
+ *
+ * @param dev Device descriptor
+ * @param[out] data Words
+ * @param words Number of words
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensirion_read_words(i2c_dev_t *dev, uint16_t *data, size_t words);
+
+/**
+ * @brief Execute command: send it, wait and read the response
+ *
+ * Device mutex is held during the whole command.
+ *
+ * @param dev Device descriptor
+ * @param cmd Command
+ * @param delay_ms Delay between command and response reading, ms
+ * @param out_data Command arguments, optional
+ * @param out_words Number of arguments
+ * @param[out] in_data Response words, optional
+ * @param in_words Number of response words
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensirion_execute_cmd(i2c_dev_t *dev, uint16_t cmd, uint32_t delay_ms,
+        const uint16_t *out_data, size_t out_words, uint16_t *in_data, size_t in_words);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __SENSIRION_H__ */
@@ -0,0 +1,2 @@
+COMPONENT_ADD_INCLUDEDIRS = .
+COMPONENT_DEPENDS = freertos log esp_idf_lib_helpers sht3x bme680 scd4x ina3221 ds18x20
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sensor_hub.c
+ *
+ * Shared sampling of several sensors by one task per bus
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include "sensor_hub.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// maximal sleep of bus task, us
+#define MAX_SLEEP_US 1000000
+
+static const char *TAG = "sensor_hub";
+
+static void ring_push(sensor_hub_sensor_t *sensor, const sensor_hub_sample_t *s)
+{
+    sensor_hub_ring_t *ring = &sensor->ring;
+
+    size_t head = ring->head;
+    size_t next = (head + 1) % ring->size;
+    if (next == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE))
+    {
+        ring->overruns++;
+        return;
+    }
+    ring->buf[head] = *s;
+    // publish the sample after it has been written
+    __atomic_store_n(&ring->head, next, __ATOMIC_RELEASE);
+
+    if (sensor->notify)
+        xTaskNotifyGive(sensor->notify);
+}
+
+static void fail(sensor_hub_sensor_t *sensor, const char *op, esp_err_t res, int64_t now)
+{
+    ESP_LOGE(TAG, "%s: %s failed: %d (%s)", sensor->driver->name, op, res, esp_err_to_name(res));
+    sensor->errors++;
+    sensor->measuring = false;
+    sensor->deadline = sensor->started + (int64_t)sensor->period_ms * 1000;
+    if (sensor->deadline < now)
+        sensor->deadline = now;
+}
+
+static void step(sensor_hub_sensor_t *sensor, int64_t now)
+{
+    const sensor_hub_driver_t *drv = sensor->driver;
+    esp_err_t res;
+
+    if (!sensor->measuring)
+    {
+        uint32_t delay_ms = 0;
+        sensor->started = now;
+        if (drv->start && (res = drv->start(sensor->ctx, &delay_ms)) != ESP_OK)
+        {
+            fail(sensor, "start", res, now);
+            return;
+        }
+        sensor->measuring = true;
+        sensor->deadline = now + (int64_t)delay_ms * 1000;
+        if (delay_ms)
+            return;
+    }
+
+    if (drv->poll)
+    {
+        bool ready = false;
+        if ((res = drv->poll(sensor->ctx, &ready)) != ESP_OK)
+        {
+            fail(sensor, "poll", res, now);
+            return;
+        }
+        if (!ready)
+        {
+            sensor->deadline = now + SENSOR_HUB_POLL_INTERVAL_MS * 1000;
+            return;
+        }
+    }
+
+    sensor_hub_sample_t s = { 0 };
+    if ((res = drv->read(sensor->ctx, s.values, &s.count)) != ESP_OK)
+    {
+        fail(sensor, "read", res, now);
+        return;
+    }
+    s.timestamp = esp_timer_get_time();
+    ring_push(sensor, &s);
+
+    sensor->measuring = false;
+    sensor->deadline = sensor->started + (int64_t)sensor->period_ms * 1000;
+    // sensor is too slow for its period, don't try to catch up
+    if (sensor->deadline < s.timestamp)
+        sensor->deadline = s.timestamp;
+}
+
+static void bus_task(void *arg)
+{
+    sensor_hub_bus_t *bus = (sensor_hub_bus_t *)arg;
+
+    while (bus->running)
+    {
+        int64_t now = esp_timer_get_time();
+        int64_t wake = now + MAX_SLEEP_US;
+        for (sensor_hub_sensor_t *s = bus->sensors; s && bus->running; s = s->next)
+        {
+            if (s->deadline <= now)
+            {
+                step(s, now);
+                now = esp_timer_get_time();
+            }
+            if (s->deadline < wake)
+                wake = s->deadline;
+        }
+
+        int64_t sleep = wake - esp_timer_get_time();
+        if (sleep <= 0)
+            continue;
+        // round up, otherwise task would spin until deadline
+        TickType_t ticks = (sleep + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000);
+        ulTaskNotifyTake(pdTRUE, ticks);
+    }
+
+    bus->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t sensor_hub_add(sensor_hub_bus_t *bus, sensor_hub_sensor_t *sensor, size_t buf_size)
+{
+    CHECK_ARG(bus && !bus->task && sensor && sensor->driver && sensor->driver->read
+            && sensor->period_ms && buf_size);
+
+    sensor->ring.buf = calloc(buf_size + 1, sizeof(sensor_hub_sample_t));
+    if (!sensor->ring.buf)
+        return ESP_ERR_NO_MEM;
+    sensor->ring.size = buf_size + 1;
+    sensor->ring.head = 0;
+    sensor->ring.tail = 0;
+    sensor->ring.overruns = 0;
+    sensor->errors = 0;
+    sensor->measuring = false;
+    sensor->started = 0;
+    sensor->deadline = 0;
+
+    sensor->next = bus->sensors;
+    bus->sensors = sensor;
+
+    return ESP_OK;
+}
+
+esp_err_t sensor_hub_start(sensor_hub_bus_t *bus, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(bus && bus->sensors && !bus->task);
+
+    int64_t now = esp_timer_get_time();
+    for (sensor_hub_sensor_t *s = bus->sensors; s; s = s->next)
+    {
+        s->measuring = false;
+        s->deadline = now;
+    }
+
+    bus->running = true;
+    if (xTaskCreate(bus_task, TAG, stack_size, bus, priority, &bus->task) != pdPASS)
+    {
+        bus->running = false;
+        bus->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t sensor_hub_stop(sensor_hub_bus_t *bus)
+{
+    CHECK_ARG(bus);
+
+    bus->running = false;
+    while (bus->task)
+    {
+        xTaskNotifyGive(bus->task);
+        vTaskDelay(1);
+    }
+
+    sensor_hub_sensor_t *s = bus->sensors;
+    while (s)
+    {
+        sensor_hub_sensor_t *next = s->next;
+        free(s->ring.buf);
+        s->ring.buf = NULL;
+        s->ring.size = 0;
+        s->next = NULL;
+        s = next;
+    }
+    bus->sensors = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t sensor_hub_read(sensor_hub_sensor_t *sensor, sensor_hub_sample_t *samples, size_t max, size_t *count)
+{
+    CHECK_ARG(sensor && sensor->ring.buf && samples && max && count);
+
+    sensor_hub_ring_t *ring = &sensor->ring;
+    size_t tail = ring->tail;
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+    size_t n = 0;
+    while (n < max && tail != head)
+    {
+        samples[n++] = ring->buf[tail];
+        tail = (tail + 1) % ring->size;
+    }
+    // release the slots after they have been copied
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    *count = n;
+
+    return ESP_OK;
+}
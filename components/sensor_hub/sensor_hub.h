@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sensor_hub.h
+ * @defgroup sensor_hub sensor_hub
+ * @{
+ *
+ * Shared sampling of several sensors by one task per bus
+ *
+ * Each sensor is described by a driver vtable (start/poll/read) and a
+ * driver-specific context. Sensors added to a bus are sampled with their
+ * own period by a single task, which timestamps every sample and writes it
+ * into a lock-free single-producer/single-consumer ring buffer of the sensor.
+ * Adapters for some drivers of this library are declared in
+ * sensor_hub_drivers.h.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __SENSOR_HUB_H__
+#define __SENSOR_HUB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SENSOR_HUB_MAX_VALUES
+#define SENSOR_HUB_MAX_VALUES 6 //!< Maximal number of values in one sample
+#endif
+
+#ifndef SENSOR_HUB_POLL_INTERVAL_MS
+#define SENSOR_HUB_POLL_INTERVAL_MS 10 //!< Interval between poll() calls while sensor is not ready
+#endif
+
+/**
+ * One sample of a sensor
+ */
+typedef struct
+{
+    int64_t timestamp;                    //!< Time of reading the results, microseconds since boot (esp_timer)
+    uint8_t count;                        //!< Number of valid values
+    float values[SENSOR_HUB_MAX_VALUES];  //!< Sensor values, meaning defined by driver
+} sensor_hub_sample_t;
+
+/**
+ * Sensor driver vtable.
+ *
+ * All functions are called from the bus task only.
+ */
+typedef struct
+{
+    const char *name; //!< Driver name, used in log messages
+
+    /**
+     * Start measurement, may be NULL for free-running sensors.
+     * Must set `delay_ms` to the time after which results can be polled/read.
+     */
+    esp_err_t (*start)(void *ctx, uint32_t *delay_ms);
+
+    /**
+     * Check whether results are available, may be NULL if results are
+     * always available after `delay_ms` returned by start().
+     */
+    esp_err_t (*poll)(void *ctx, bool *ready);
+
+    /**
+     * Read results. Must fill up to ::SENSOR_HUB_MAX_VALUES values and
+     * set their count.
+     */
+    esp_err_t (*read)(void *ctx, float *values, uint8_t *count);
+} sensor_hub_driver_t;
+
+/**
+ * Lock-free SPSC ring buffer of samples.
+ *
+ * Only the bus task writes to the ring and only one consumer may read
+ * from it. When the ring is full, new samples are dropped.
+ */
+typedef struct
+{
+    sensor_hub_sample_t *buf;   //!< Sample slots
+    size_t size;                //!< Number of slots, one slot is always unused
+    size_t head;                //!< Write index, changed by producer only
+    size_t tail;                //!< Read index, changed by consumer only
+    uint32_t overruns;          //!< Number of dropped samples
+} sensor_hub_ring_t;
+
+/**
+ * Sensor sampled by hub.
+ *
+ * Fill `driver`, `ctx` and `period_ms` before ::sensor_hub_add(), other fields
+ * are internal.
+ */
+typedef struct sensor_hub_sensor_s
+{
+    const sensor_hub_driver_t *driver;  //!< Driver vtable
+    void *ctx;                          //!< Driver context (device descriptor)
+    uint32_t period_ms;                 //!< Sampling period, ms
+    TaskHandle_t notify;                //!< Task to notify on each new sample, may be NULL
+
+    sensor_hub_ring_t ring;             //!< Samples
+    uint32_t errors;                    //!< Number of failed driver calls
+    int64_t started;                    //!< Time of last start, us
+    int64_t deadline;                   //!< Time of next action, us
+    bool measuring;                     //!< Measurement is started
+    struct sensor_hub_sensor_s *next;   //!< Next sensor on the bus
+} sensor_hub_sensor_t;
+
+/**
+ * Bus sampled by one task.
+ *
+ * Usually one bus is used per I2C port or 1-Wire pin, but any grouping is
+ * possible as long as drivers are thread safe.
+ */
+typedef struct
+{
+    sensor_hub_sensor_t *sensors;   //!< List of sensors
+    TaskHandle_t task;              //!< Bus task
+    volatile bool running;          //!< Bus task is running
+} sensor_hub_bus_t;
+
+/**
+ * @brief Add sensor to the bus
+ *
+ * Allocates the ring buffer of the sensor. Sensors can only be added while
+ * the bus is stopped.
+ *
+ * @param bus Bus descriptor, zero-initialized before first use
+ * @param sensor Sensor descriptor with `driver`, `ctx` and `period_ms` set
+ * @param buf_size Ring buffer size, samples
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensor_hub_add(sensor_hub_bus_t *bus, sensor_hub_sensor_t *sensor, size_t buf_size);
+
+/**
+ * @brief Start bus task
+ *
+ * All sensors on the bus make their first measurement immediately.
+ *
+ * @param bus Bus descriptor
+ * @param priority Task priority
+ * @param stack_size Task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensor_hub_start(sensor_hub_bus_t *bus, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop bus task and remove all sensors
+ *
+ * Ring buffers of the sensors are freed.
+ *
+ * @param bus Bus descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensor_hub_stop(sensor_hub_bus_t *bus);
+
+/**
+ * @brief Read samples of a sensor
+ *
+ * Non-blocking. Only one task may read samples of the same sensor.
+ * Use `notify` field of the sensor descriptor and `ulTaskNotifyTake()` to
+ * wait for new samples.
+ *
+ * @param sensor Sensor descriptor
+ * @param[out] samples Buffer for samples
+ * @param max Buffer size, samples
+ * @param[out] count Number of read samples, may be 0
+ * @return `ESP_OK` on success
+ */
+esp_err_t sensor_hub_read(sensor_hub_sensor_t *sensor, sensor_hub_sample_t *samples, size_t max, size_t *count);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __SENSOR_HUB_H__ */
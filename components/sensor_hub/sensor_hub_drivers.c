@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sensor_hub_drivers.c
+ *
+ * Adapters of library drivers for sensor_hub
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <sht3x.h>
+#include <bme680.h>
+#include <scd4x.h>
+#include "sensor_hub_drivers.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+
+#define DS18X20_CONVERSION_MS 750
+
+// SHT3x
+
+static esp_err_t sht3x_start(void *ctx, uint32_t *delay_ms)
+{
+    CHECK(sht3x_start_measurement((sht3x_t *)ctx, SHT3X_SINGLE_SHOT, SHT3X_HIGH));
+    *delay_ms = sht3x_get_measurement_duration(SHT3X_HIGH) * portTICK_PERIOD_MS;
+    return ESP_OK;
+}
+
+static esp_err_t sht3x_read(void *ctx, float *values, uint8_t *count)
+{
+    CHECK(sht3x_get_results((sht3x_t *)ctx, &values[0], &values[1]));
+    *count = 2;
+    return ESP_OK;
+}
+
+const sensor_hub_driver_t sensor_hub_sht3x = {
+    .name = "sht3x",
+    .start = sht3x_start,
+    .poll = NULL,
+    .read = sht3x_read,
+};
+
+// BME680
+
+static esp_err_t bme680_start(void *ctx, uint32_t *delay_ms)
+{
+    uint32_t duration;
+    CHECK(bme680_start_measurement((bme680_t *)ctx, &duration));
+    *delay_ms = duration * portTICK_PERIOD_MS;
+    return ESP_OK;
+}
+
+static esp_err_t bme680_poll(void *ctx, bool *ready)
+{
+    return bme680_poll_measurement((bme680_t *)ctx, ready);
+}
+
+static esp_err_t bme680_read(void *ctx, float *values, uint8_t *count)
+{
+    bme680_values_float_t v;
+    CHECK(bme680_finish_measurement_float((bme680_t *)ctx, &v));
+    values[0] = v.temperature;
+    values[1] = v.pressure;
+    values[2] = v.humidity;
+    values[3] = v.gas_resistance;
+    *count = 4;
+    return ESP_OK;
+}
+
+const sensor_hub_driver_t sensor_hub_bme680 = {
+    .name = "bme680",
+    .start = bme680_start,
+    .poll = bme680_poll,
+    .read = bme680_read,
+};
+
+// SCD4x
+
+static esp_err_t scd4x_poll(void *ctx, bool *ready)
+{
+    return scd4x_get_data_ready_status((i2c_dev_t *)ctx, ready);
+}
+
+static esp_err_t scd4x_read(void *ctx, float *values, uint8_t *count)
+{
+    uint16_t co2;
+    CHECK(scd4x_read_measurement((i2c_dev_t *)ctx, &co2, &values[1], &values[2]));
+    values[0] = co2;
+    *count = 3;
+    return ESP_OK;
+}
+
+const sensor_hub_driver_t sensor_hub_scd4x = {
+    .name = "scd4x",
+    .start = NULL,
+    .poll = scd4x_poll,
+    .read = scd4x_read,
+};
+
+// INA3221
+
+static esp_err_t ina3221_poll(void *ctx, bool *ready)
+{
+    sensor_hub_ina3221_t *s = (sensor_hub_ina3221_t *)ctx;
+    return ina3221_get_all(s->dev, &s->data, ready);
+}
+
+static esp_err_t ina3221_read(void *ctx, float *values, uint8_t *count)
+{
+    sensor_hub_ina3221_t *s = (sensor_hub_ina3221_t *)ctx;
+    for (int i = 0; i < 3; i++)
+    {
+        values[i] = s->data.bus_mv[i] / 1000.0f;
+        values[i + 3] = s->data.current_ua[i] / 1000.0f;
+    }
+    *count = 6;
+    return ESP_OK;
+}
+
+const sensor_hub_driver_t sensor_hub_ina3221 = {
+    .name = "ina3221",
+    .start = NULL,
+    .poll = ina3221_poll,
+    .read = ina3221_read,
+};
+
+// DS18x20
+
+static esp_err_t ds18x20_start(void *ctx, uint32_t *delay_ms)
+{
+    sensor_hub_ds18x20_t *s = (sensor_hub_ds18x20_t *)ctx;
+    CHECK(ds18x20_measure(s->pin, s->addr, false));
+    *delay_ms = DS18X20_CONVERSION_MS;
+    return ESP_OK;
+}
+
+static esp_err_t ds18x20_read(void *ctx, float *values, uint8_t *count)
+{
+    sensor_hub_ds18x20_t *s = (sensor_hub_ds18x20_t *)ctx;
+    CHECK(ds18x20_read_temperature(s->pin, s->addr, &values[0]));
+    *count = 1;
+    return ESP_OK;
+}
+
+const sensor_hub_driver_t sensor_hub_ds18x20 = {
+    .name = "ds18x20",
+    .start = ds18x20_start,
+    .poll = NULL,
+    .read = ds18x20_read,
+};
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file sensor_hub_drivers.h
+ * @defgroup sensor_hub_drivers sensor_hub_drivers
+ * @{
+ *
+ * Adapters of library drivers for sensor_hub
+ *
+ * Devices must be initialized before adding them to a bus. Drivers take
+ * device mutexes, so the same device may be used outside of the hub as well.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __SENSOR_HUB_DRIVERS_H__
+#define __SENSOR_HUB_DRIVERS_H__
+
+#include <ds18x20.h>
+#include <ina3221.h>
+#include "sensor_hub.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * SHT3x, single shot measurements with high repeatability.
+ * Context: `sht3x_t *`. Values: temperature (°C), humidity (%).
+ */
+extern const sensor_hub_driver_t sensor_hub_sht3x;
+
+/**
+ * BME680, forced mode TPHG measurements.
+ * Context: `bme680_t *`. Values: temperature (°C), pressure (hPa),
+ * humidity (%), gas resistance (Ohm).
+ */
+extern const sensor_hub_driver_t sensor_hub_bme680;
+
+/**
+ * SCD4x in periodic measurement mode, which must be started before.
+ * Context: `i2c_dev_t *`. Values: CO2 (ppm), temperature (°C), humidity (%).
+ * Use sampling period of the measurement mode (5000 or 30000 ms).
+ */
+extern const sensor_hub_driver_t sensor_hub_scd4x;
+
+/**
+ * Context of ::sensor_hub_ina3221
+ */
+typedef struct
+{
+    ina3221_t *dev;         //!< Device descriptor
+    ina3221_data_t data;    //!< Last results, zero-initialize before use
+} sensor_hub_ina3221_t;
+
+/**
+ * INA3221 in continuous mode, all enabled channels.
+ * Context: `sensor_hub_ina3221_t *`. Values: bus voltage (V) of channels 1..3,
+ * then current (mA) of channels 1..3. Disabled channels read as 0.
+ * Use sampling period not shorter than conversion time of the device.
+ */
+extern const sensor_hub_driver_t sensor_hub_ina3221;
+
+/**
+ * Context of ::sensor_hub_ds18x20
+ */
+typedef struct
+{
+    gpio_num_t pin;         //!< 1-Wire pin
+    ds18x20_addr_t addr;    //!< Sensor address, ::DS18X20_ANY if single sensor on the bus
+} sensor_hub_ds18x20_t;
+
+/**
+ * DS18x20, worst case conversion time of 12-bit resolution is awaited.
+ * Context: `sensor_hub_ds18x20_t *`. Values: temperature (°C).
+ */
+extern const sensor_hub_driver_t sensor_hub_ds18x20;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __SENSOR_HUB_DRIVERS_H__ */
@@ -29,8 +29,13 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <sdkconfig.h>
 #include "sensirion_voc_algorithm.h"
 
+#if CONFIG_SGP40_VOC_FPU
+#include <math.h>
+#endif
+
 /* The fixed point arithmetic parts of this code were originally created by
  * https://github.com/PetteriAimonen/libfixmath
  */
@@ -59,6 +64,9 @@ static fix16_t fix16_mul(fix16_t inArg0, fix16_t inArg1);
 /*! Divides the first given fix16_t by the second and returns the result. */
 static fix16_t fix16_div(fix16_t inArg0, fix16_t inArg1);
 
+/*! Divides the given fix16_t by 2^shift, same rounding as fix16_div(). */
+static inline fix16_t fix16_div_pow2(fix16_t inArg0, uint8_t shift);
+
 /*! Returns the square root of the given fix16_t. */
 static fix16_t fix16_sqrt(fix16_t inValue);
 
@@ -188,6 +196,35 @@ static fix16_t fix16_div(fix16_t a, fix16_t b) {
     return result;
 }
 
+static inline fix16_t fix16_div_pow2(fix16_t a, uint8_t shift) {
+    if (!shift)
+        return a;
+
+    // Round magnitude half up, as the restoring division above does
+    uint32_t magnitude = (a >= 0) ? (uint32_t)a : -(uint32_t)a;
+    fix16_t result = (magnitude + ((uint32_t)1 << (shift - 1))) >> shift;
+
+    return (a < 0) ? -result : result;
+}
+
+#if CONFIG_SGP40_VOC_FPU
+
+static fix16_t fix16_sqrt(fix16_t x) {
+    // It is assumed that x is not negative
+    return (fix16_t)(sqrtf((float)x * (1.0f / 65536.0f)) * 65536.0f + 0.5f);
+}
+
+static fix16_t fix16_exp(fix16_t x) {
+    if (x >= F16(10.3972))
+        return FIX16_MAXIMUM;
+    if (x <= F16(-11.7835))
+        return 0;
+
+    return (fix16_t)(expf((float)x * (1.0f / 65536.0f)) * 65536.0f + 0.5f);
+}
+
+#else
+
 static fix16_t fix16_sqrt(fix16_t x) {
     // It is assumed that x is not negative
 
@@ -283,6 +320,8 @@ static fix16_t fix16_exp(fix16_t x) {
     return res;
 }
 
+#endif /* CONFIG_SGP40_VOC_FPU */
+
 static void VocAlgorithm__init_instances(VocAlgorithmParams* params);
 static void
 VocAlgorithm__mean_variance_estimator__init(VocAlgorithmParams* params);
@@ -593,6 +632,7 @@ static void VocAlgorithm__mean_variance_estimator__process(
     fix16_t delta_sgp;
     fix16_t c;
     fix16_t additional_scaling;
+    uint8_t additional_scaling_shift;
 
     if ((params->m_Mean_Variance_Estimator___Initialized == false)) {
         params->m_Mean_Variance_Estimator___Initialized = true;
@@ -609,17 +649,19 @@ static void VocAlgorithm__mean_variance_estimator__process(
         sraw = (sraw - params->m_Mean_Variance_Estimator___Sraw_Offset);
         VocAlgorithm__mean_variance_estimator___calculate_gamma(
             params, voc_index_from_prior);
-        delta_sgp = (fix16_div(
-            (sraw - params->m_Mean_Variance_Estimator___Mean),
-            F16(VocAlgorithm_MEAN_VARIANCE_ESTIMATOR__GAMMA_SCALING)));
+        // GAMMA_SCALING is 64
+        delta_sgp = (fix16_div_pow2(
+            (sraw - params->m_Mean_Variance_Estimator___Mean), 6));
         if ((delta_sgp < F16(0.))) {
             c = (params->m_Mean_Variance_Estimator___Std - delta_sgp);
         } else {
             c = (params->m_Mean_Variance_Estimator___Std + delta_sgp);
         }
         additional_scaling = F16(1.);
+        additional_scaling_shift = 0;
         if ((c > F16(1440.))) {
             additional_scaling = F16(4.);
+            additional_scaling_shift = 2;
         }
         params->m_Mean_Variance_Estimator___Std = (fix16_mul(
             fix16_sqrt((fix16_mul(
@@ -629,17 +671,15 @@ static void VocAlgorithm__mean_variance_estimator__process(
             fix16_sqrt((
                 (fix16_mul(
                     params->m_Mean_Variance_Estimator___Std,
-                    (fix16_div(
+                    (fix16_div_pow2(
                         params->m_Mean_Variance_Estimator___Std,
-                        (fix16_mul(
-                            F16(VocAlgorithm_MEAN_VARIANCE_ESTIMATOR__GAMMA_SCALING),
-                            additional_scaling)))))) +
+                        6 + additional_scaling_shift)))) +
                 (fix16_mul(
-                    (fix16_div(
+                    (fix16_div_pow2(
                         (fix16_mul(
                             params->m_Mean_Variance_Estimator__Gamma_Variance,
                             delta_sgp)),
-                        additional_scaling)),
+                        additional_scaling_shift)),
                     delta_sgp))))));
         params->m_Mean_Variance_Estimator___Mean =
             (params->m_Mean_Variance_Estimator___Mean +
@@ -728,10 +768,10 @@ static fix16_t VocAlgorithm__sigmoid_scaled__process(VocAlgorithmParams* params,
         return F16(0.);
     } else {
         if ((sample >= F16(0.))) {
-            shift = (fix16_div(
+            shift = (fix16_div_pow2(
                 (F16(VocAlgorithm_SIGMOID_L) -
                  (fix16_mul(F16(5.), params->m_Sigmoid_Scaled__Offset))),
-                F16(4.)));
+                2));
             return ((fix16_div((F16(VocAlgorithm_SIGMOID_L) + shift),
                                (F16(1.) + fix16_exp(x)))) -
                     shift);
@@ -9,9 +9,12 @@
  */
 #include <esp_err.h>
 #include <esp_idf_lib_helpers.h>
+#include <sensirion.h>
 #include <esp_log.h>
 #include "sgp40.h"
 #include <math.h>
+#include <stdio.h>
+#include <nvs.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
@@ -35,94 +38,24 @@ static const char *TAG = "sgp40";
 
 #define SELF_TEST_OK 0xd400
 
-#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
-#define CHECK_ARG(ARG) do { if (!(ARG)) return ESP_ERR_INVALID_ARG; } while (0)
-
-static uint8_t crc8(const uint8_t *data, size_t count)
-{
-    uint8_t res = 0xff;
+#define NVS_NAMESPACE "sgp40"
 
-    for (size_t i = 0; i < count; ++i)
-    {
-        res ^= data[i];
-        for (uint8_t bit = 8; bit > 0; --bit)
-        {
-            if (res & 0x80)
-                res = (res << 1) ^ 0x31;
-            else
-                res = (res << 1);
-        }
-    }
-    return res;
-}
+// VOC algorithm states are valid after 3 hours of operation
+#define VOC_STATE_MIN_UPTIME F16(3. * 3600.)
+// and can be restored after interruption not longer than 10 minutes
+#define VOC_STATE_MAX_AGE    (10 * 60)
+// time values before 2020-01-01 mean that the system time is not set
+#define TIME_VALID           1577836800
 
-static inline uint16_t swap(uint16_t v)
+typedef struct
 {
-    return (v << 8) | (v >> 8);
-}
-
-static esp_err_t send_cmd(i2c_dev_t *dev, uint16_t cmd, uint16_t *data, size_t words)
-{
-    uint8_t buf[2 + words * 3];
-    // add command
-    *(uint16_t *)buf = swap(cmd);
-    if (data && words)
-        // add arguments
-        for (size_t i = 0; i < words; i++)
-        {
-            uint8_t *p = buf + 2 + i * 3;
-            *(uint16_t *)p = swap(data[i]);
-            *(p + 2) = crc8(p, 2);
-        }
-
-    ESP_LOGV(TAG, "Sending buffer:");
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, buf, sizeof(buf), ESP_LOG_VERBOSE);
-
-    return i2c_dev_write(dev, NULL, 0, buf, sizeof(buf));
-}
-
-static esp_err_t read_resp(i2c_dev_t *dev, uint16_t *data, size_t words)
-{
-    uint8_t buf[words * 3];
-    CHECK(i2c_dev_read(dev, NULL, 0, buf, sizeof(buf)));
-
-    ESP_LOGV(TAG, "Received buffer:");
-    ESP_LOG_BUFFER_HEX_LEVEL(TAG, buf, sizeof(buf), ESP_LOG_VERBOSE);
+    int32_t state0;
+    int32_t state1;
+    int64_t time;
+} voc_state_t;
 
-    for (size_t i = 0; i < words; i++)
-    {
-        uint8_t *p = buf + i * 3;
-        uint8_t crc = crc8(p, 2);
-        if (crc != *(p + 2))
-        {
-            ESP_LOGE(TAG, "Invalid CRC 0x%02x, expected 0x%02x", crc, *(p + 2));
-            return ESP_ERR_INVALID_CRC;
-        }
-        data[i] = swap(*(uint16_t *)p);
-    }
-    return ESP_OK;
-}
-
-static esp_err_t execute_cmd(sgp40_t *dev, uint16_t cmd, uint32_t timeout_ms,
-        uint16_t *out_data, size_t out_words, uint16_t *in_data, size_t in_words)
-{
-    CHECK_ARG(dev);
-
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
-    I2C_DEV_CHECK(&dev->i2c_dev, send_cmd(&dev->i2c_dev, cmd, out_data, out_words));
-    if (timeout_ms)
-    {
-        if (timeout_ms > 10)
-            vTaskDelay(pdMS_TO_TICKS(timeout_ms));
-        else
-            ets_delay_us(timeout_ms * 1000);
-    }
-    if (in_data && in_words)
-        I2C_DEV_CHECK(&dev->i2c_dev, read_resp(&dev->i2c_dev, in_data, in_words));
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
-
-    return ESP_OK;
-}
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(ARG) do { if (!(ARG)) return ESP_ERR_INVALID_ARG; } while (0)
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -151,8 +84,8 @@ esp_err_t sgp40_init(sgp40_t *dev)
 {
     CHECK_ARG(dev);
 
-    CHECK(execute_cmd(dev, CMD_SERIAL, TIME_SERIAL, NULL, 0, dev->serial, 3));
-    CHECK(execute_cmd(dev, CMD_FEATURESET, TIME_FEATURESET, NULL, 0, &dev->featureset, 1));
+    CHECK(sensirion_execute_cmd(&dev->i2c_dev, CMD_SERIAL, TIME_SERIAL, NULL, 0, dev->serial, 3));
+    CHECK(sensirion_execute_cmd(&dev->i2c_dev, CMD_FEATURESET, TIME_FEATURESET, NULL, 0, &dev->featureset, 1));
 
     ESP_LOGD(TAG, "Device found. S/N: 0x%04x%04x%04x, featureset 0x%04x",
             dev->serial[0], dev->serial[1], dev->serial[2], dev->featureset);
@@ -166,7 +99,7 @@ esp_err_t sgp40_soft_reset(sgp40_t *dev)
 {
     CHECK_ARG(dev);
 
-    return execute_cmd(dev, CMD_SOFT_RESET, TIME_SOFT_RESET, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(&dev->i2c_dev, CMD_SOFT_RESET, TIME_SOFT_RESET, NULL, 0, NULL, 0);
 }
 
 esp_err_t sgp40_self_test(sgp40_t *dev)
@@ -174,7 +107,7 @@ esp_err_t sgp40_self_test(sgp40_t *dev)
     CHECK_ARG(dev);
 
     uint16_t res;
-    CHECK(execute_cmd(dev, CMD_SELF_TEST, TIME_SELF_TEST, NULL, 0, &res, 1));
+    CHECK(sensirion_execute_cmd(&dev->i2c_dev, CMD_SELF_TEST, TIME_SELF_TEST, NULL, 0, &res, 1));
 
     return res == SELF_TEST_OK ? ESP_OK : ESP_FAIL;
 }
@@ -183,7 +116,7 @@ esp_err_t sgp40_heater_off(sgp40_t *dev)
 {
     CHECK_ARG(dev);
 
-    return execute_cmd(dev, CMD_HEATER_OFF, TIME_HEATER_OFF, NULL, 0, NULL, 0);
+    return sensirion_execute_cmd(&dev->i2c_dev, CMD_HEATER_OFF, TIME_HEATER_OFF, NULL, 0, NULL, 0);
 }
 
 esp_err_t sgp40_measure_raw(sgp40_t *dev, float humidity, float temperature, uint16_t *raw)
@@ -213,7 +146,7 @@ esp_err_t sgp40_measure_raw(sgp40_t *dev, float humidity, float temperature, uin
         params[1] = (uint16_t)((temperature + 45) / 175.0 * 65535);
     }
 
-    return execute_cmd(dev, CMD_MEASURE_RAW, TIME_MEASURE_RAW, params, 2, raw, 1);
+    return sensirion_execute_cmd(&dev->i2c_dev, CMD_MEASURE_RAW, TIME_MEASURE_RAW, params, 2, raw, 1);
 }
 
 esp_err_t sgp40_measure_voc(sgp40_t *dev, float humidity, float temperature, int32_t *voc_index)
@@ -226,3 +159,64 @@ esp_err_t sgp40_measure_voc(sgp40_t *dev, float humidity, float temperature, int
 
     return ESP_OK;
 }
+
+static void state_key(sgp40_t *dev, char *key, size_t size)
+{
+    snprintf(key, size, "%04x%04x%04x", dev->serial[0], dev->serial[1], dev->serial[2]);
+}
+
+esp_err_t sgp40_save_voc_state(sgp40_t *dev)
+{
+    CHECK_ARG(dev);
+
+    if (dev->voc.m_Mean_Variance_Estimator___Uptime_Gamma < VOC_STATE_MIN_UPTIME)
+        return ESP_ERR_INVALID_STATE;
+
+    voc_state_t state;
+    VocAlgorithm_get_states(&dev->voc, &state.state0, &state.state1);
+    state.time = time(NULL);
+
+    char key[16];
+    state_key(dev, key, sizeof(key));
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs));
+    esp_err_t res = nvs_set_blob(nvs, key, &state, sizeof(state));
+    if (res == ESP_OK)
+        res = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    return res;
+}
+
+esp_err_t sgp40_restore_voc_state(sgp40_t *dev)
+{
+    CHECK_ARG(dev);
+
+    char key[16];
+    state_key(dev, key, sizeof(key));
+
+    voc_state_t state;
+    size_t size = sizeof(state);
+
+    nvs_handle_t nvs;
+    CHECK(nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs));
+    esp_err_t res = nvs_get_blob(nvs, key, &state, &size);
+    nvs_close(nvs);
+    CHECK(res);
+
+    if (size != sizeof(state))
+        return ESP_ERR_INVALID_SIZE;
+
+    int64_t now = time(NULL);
+    if (now >= TIME_VALID && state.time >= TIME_VALID && now - state.time > VOC_STATE_MAX_AGE)
+    {
+        ESP_LOGW(TAG, "Saved VOC state is too old, not restored");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    VocAlgorithm_set_states(&dev->voc, state.state0, state.state1);
+    ESP_LOGD(TAG, "VOC state restored");
+
+    return ESP_OK;
+}
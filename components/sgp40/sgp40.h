@@ -113,6 +113,36 @@ esp_err_t sgp40_measure_raw(sgp40_t *dev, float humidity, float temperature, uin
  */
 esp_err_t sgp40_measure_voc(sgp40_t *dev, float humidity, float temperature, int32_t *voc_index);
 
+/**
+ * @brief Save state of the VOC algorithm to NVS
+ *
+ * State is stored under the key made of device serial number, so several
+ * sensors can share NVS. Save it periodically to resume operation after
+ * reboot without the initial learning phase.
+ *
+ * NVS must be initialized before calling this function.
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success, `ESP_ERR_INVALID_STATE` if the algorithm
+ *         has been running less than 3 hours
+ */
+esp_err_t sgp40_save_voc_state(sgp40_t *dev);
+
+/**
+ * @brief Restore state of the VOC algorithm from NVS
+ *
+ * Call this after ::sgp40_init(). If system time is set, the state saved
+ * more than 10 minutes ago is not restored and algorithm starts with the
+ * initial learning phase.
+ *
+ * NVS must be initialized before calling this function.
+ *
+ * @param dev Device descriptor
+ * @return `ESP_OK` on success, `ESP_ERR_NVS_NOT_FOUND` if there is no saved
+ *         state, `ESP_ERR_INVALID_STATE` if saved state is too old
+ */
+esp_err_t sgp40_restore_voc_state(sgp40_t *dev);
+
 #ifdef __cplusplus
 }
 #endif
@@ -39,11 +39,14 @@
  * BSD Licensed as described in the file LICENSE
  */
 
+#include <string.h>
 #include <esp_log.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_timer.h>
 #include <esp_idf_lib_helpers.h>
+#include <sensirion.h>
+#include <esp_idf_lib_trace.h>
 #include "sht3x.h"
 
 #define I2C_FREQ_HZ 1000000 // 1MHz
@@ -57,6 +60,7 @@ const char *TAG = "sht3x";
 #define SHT3X_STOP_PERIODIC_MEAS_CMD   0x3093
 #define SHT3X_HEATER_ON_CMD            0x306D
 #define SHT3X_HEATER_OFF_CMD           0x3066
+#define SHT3X_ART_CMD                  0x2B32
 
 static const uint16_t SHT3X_MEASURE_CMD[6][3] = {
         {0x2400, 0x240b, 0x2416}, // [SINGLE_SHOT][H,M,L] without clock stretching
@@ -90,40 +94,30 @@ static const uint8_t SHT3X_MEAS_DURATION_TICKS[3] = {
         TIME_TO_TICKS(SHT3X_MEAS_DURATION_REP_LOW)
 };
 
+// periods of periodic modes in us
+static const uint32_t SHT3X_PERIOD_US[6] = {
+        0, 2000000, 1000000, 500000, 250000, 100000
+};
+
+// stream retries fetch after NACK in PERIOD / SHT3X_STREAM_RETRY_DIV
+#define SHT3X_STREAM_RETRY_DIV 10
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-#define G_POLYNOM 0x31
-
 static inline uint16_t shuffle(uint16_t val)
 {
     return (val >> 8) | (val << 8);
 }
 
-static uint8_t crc8(uint8_t data[], int len)
+static inline bool check_crc(sht3x_raw_data_t raw_data)
 {
-    // initialization value
-    uint8_t crc = 0xff;
-
-    // iterate over all bytes
-    for (int i = 0; i < len; i++)
-    {
-        crc ^= data[i];
-        for (int i = 0; i < 8; i++)
-        {
-            bool xor = crc & 0x80;
-            crc = crc << 1;
-            crc = xor ? crc ^ G_POLYNOM : crc;
-        }
-    }
-    return crc;
+    return sensirion_crc8(raw_data, 2) == raw_data[2] && sensirion_crc8(raw_data + 3, 2) == raw_data[5];
 }
 
-static esp_err_t send_cmd_nolock(sht3x_t *dev, uint16_t cmd)
+static inline esp_err_t send_cmd_nolock(sht3x_t *dev, uint16_t cmd)
 {
-    cmd = shuffle(cmd);
-
-    return i2c_dev_write(&dev->i2c_dev, NULL, 0, &cmd, 2);
+    return sensirion_send_cmd(&dev->i2c_dev, cmd, NULL, 0);
 }
 
 static esp_err_t send_cmd(sht3x_t *dev, uint16_t cmd)
@@ -185,14 +179,14 @@ static esp_err_t get_raw_data_nolock(sht3x_t *dev, sht3x_raw_data_t raw_data)
         dev->meas_started = false;
 
     // check temperature crc
-    if (crc8(raw_data, 2) != raw_data[2])
+    if (sensirion_crc8(raw_data, 2) != raw_data[2])
     {
         ESP_LOGE(TAG, "CRC check for temperature data failed");
         return ESP_ERR_INVALID_CRC;
     }
 
     // check humidity crc
-    if (crc8(raw_data + 3, 2) != raw_data[5])
+    if (sensirion_crc8(raw_data + 3, 2) != raw_data[5])
     {
         ESP_LOGE(TAG, "CRC check for humidity data failed");
         return ESP_ERR_INVALID_CRC;
@@ -225,7 +219,7 @@ esp_err_t sht3x_free_desc(sht3x_t *dev)
     return i2c_dev_delete_mutex(&dev->i2c_dev);
 }
 
-esp_err_t sht3x_init(sht3x_t *dev)
+esp_err_t sht3x_reset(sht3x_t *dev)
 {
     CHECK_ARG(dev);
 
@@ -237,12 +231,19 @@ esp_err_t sht3x_init(sht3x_t *dev)
     // send reset command
     I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
     I2C_DEV_CHECK(&dev->i2c_dev, send_cmd_nolock(dev, SHT3X_RESET_CMD));
-    vTaskDelay(pdMS_TO_TICKS(10));
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
     return ESP_OK;
 }
 
+esp_err_t sht3x_init(sht3x_t *dev)
+{
+    CHECK(sht3x_reset(dev));
+    vTaskDelay(pdMS_TO_TICKS(SHT3X_RESET_TIME_MS));
+
+    return ESP_OK;
+}
+
 esp_err_t sht3x_set_heater(sht3x_t *dev, bool enable)
 {
     CHECK_ARG(dev);
@@ -263,21 +264,52 @@ esp_err_t sht3x_compute_values(sht3x_raw_data_t raw_data, float *temperature, fl
     return ESP_OK;
 }
 
-esp_err_t sht3x_measure(sht3x_t *dev, float *temperature, float *humidity)
+esp_err_t sht3x_compute_values_fixed(sht3x_raw_data_t raw_data, int16_t *temperature, int16_t *humidity)
 {
-    CHECK_ARG(dev && (temperature || humidity));
+    CHECK_ARG(raw_data && (temperature || humidity));
 
-    sht3x_raw_data_t raw_data;
+    if (temperature)
+        *temperature = (int32_t)((raw_data[0] << 8) | raw_data[1]) * 17500 / 65535 - 4500;
+
+    if (humidity)
+        *humidity = (int32_t)((raw_data[3] << 8) | raw_data[4]) * 10000 / 65535;
+
+    return ESP_OK;
+}
 
+static esp_err_t measure_raw(sht3x_t *dev, sht3x_raw_data_t raw_data)
+{
     I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
     I2C_DEV_CHECK(&dev->i2c_dev, start_nolock(dev, SHT3X_SINGLE_SHOT, SHT3X_HIGH));
-    vTaskDelay(SHT3X_MEAS_DURATION_TICKS[SHT3X_HIGH]);
+    ESP_IDF_LIB_TRACE_DELAY(SHT3X_MEAS_DURATION_TICKS[SHT3X_HIGH]);
     I2C_DEV_CHECK(&dev->i2c_dev, get_raw_data_nolock(dev, raw_data));
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
+    return ESP_OK;
+}
+
+esp_err_t sht3x_measure(sht3x_t *dev, float *temperature, float *humidity)
+{
+    CHECK_ARG(dev && (temperature || humidity));
+
+    sht3x_raw_data_t raw_data;
+
+    CHECK(measure_raw(dev, raw_data));
+
     return sht3x_compute_values(raw_data, temperature, humidity);
 }
 
+esp_err_t sht3x_measure_fixed(sht3x_t *dev, int16_t *temperature, int16_t *humidity)
+{
+    CHECK_ARG(dev && (temperature || humidity));
+
+    sht3x_raw_data_t raw_data;
+
+    CHECK(measure_raw(dev, raw_data));
+
+    return sht3x_compute_values_fixed(raw_data, temperature, humidity);
+}
+
 uint8_t sht3x_get_measurement_duration(sht3x_repeat_t repeat)
 {
     return SHT3X_MEAS_DURATION_TICKS[repeat];  // in RTOS ticks
@@ -328,3 +360,232 @@ esp_err_t sht3x_get_results(sht3x_t *dev, float *temperature, float *humidity)
 
     return sht3x_compute_values(raw_data, temperature, humidity);
 }
+
+esp_err_t sht3x_get_results_fixed(sht3x_t *dev, int16_t *temperature, int16_t *humidity)
+{
+    CHECK_ARG(dev && (temperature || humidity));
+
+    sht3x_raw_data_t raw_data;
+
+    CHECK(sht3x_get_raw_data(dev, raw_data));
+
+    return sht3x_compute_values_fixed(raw_data, temperature, humidity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static void stream_init(sht3x_stream_t *stream, sht3x_t *dev)
+{
+    memset(stream, 0, sizeof(sht3x_stream_t));
+    stream->dev = dev;
+    stream->period_us = SHT3X_PERIOD_US[dev->mode];
+    stream->next = dev->meas_start_time + SHT3X_MEAS_DURATION_US[dev->repeatability];
+    stream->last = dev->meas_start_time;
+}
+
+esp_err_t sht3x_stream_start(sht3x_stream_t *stream, sht3x_t *dev, sht3x_mode_t mode, sht3x_repeat_t repeat)
+{
+    CHECK_ARG(stream && dev && mode != SHT3X_SINGLE_SHOT && mode <= SHT3X_PERIODIC_10MPS && repeat <= SHT3X_LOW);
+
+    CHECK(sht3x_start_measurement(dev, mode, repeat));
+    stream_init(stream, dev);
+
+    return ESP_OK;
+}
+
+esp_err_t sht3x_stream_start_art(sht3x_stream_t *stream, sht3x_t *dev)
+{
+    CHECK_ARG(stream && dev);
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_CHECK(&dev->i2c_dev, send_cmd_nolock(dev, SHT3X_ART_CMD));
+    dev->mode = SHT3X_PERIODIC_4MPS;
+    dev->repeatability = SHT3X_HIGH;
+    dev->meas_start_time = esp_timer_get_time();
+    dev->meas_started = true;
+    dev->meas_first = true;
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    stream_init(stream, dev);
+
+    return ESP_OK;
+}
+
+esp_err_t sht3x_stream_poll(sht3x_stream_t *stream, sht3x_raw_data_t raw_data, bool *fresh)
+{
+    CHECK_ARG(stream && stream->dev && fresh);
+
+    sht3x_t *dev = stream->dev;
+    uint64_t now = esp_timer_get_time();
+
+    *fresh = false;
+    if (now < stream->next)
+        return ESP_OK;
+
+    uint16_t cmd = shuffle(SHT3X_FETCH_DATA_CMD);
+    sht3x_raw_data_t data;
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    // sensor NACKs the read header when there is no new data
+    dev->i2c_dev.quiet = true;
+    esp_err_t res = i2c_dev_read(&dev->i2c_dev, &cmd, 2, data, sizeof(sht3x_raw_data_t));
+    dev->i2c_dev.quiet = false;
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    stream->reads++;
+    now = esp_timer_get_time();
+
+    if (res != ESP_OK)
+    {
+        stream->not_ready++;
+        stream->next = now + stream->period_us / SHT3X_STREAM_RETRY_DIV;
+        if (now - stream->last > 2 * stream->period_us + SHT3X_MEAS_DURATION_US[dev->repeatability])
+        {
+            ESP_LOGE(TAG, "No data from sensor for %u ms: %d", (uint32_t)((now - stream->last) / 1000), res);
+            return ESP_ERR_TIMEOUT;
+        }
+        return ESP_OK;
+    }
+
+    stream->last = now;
+    stream->next = now + stream->period_us;
+    dev->meas_first = false;
+
+    if (!check_crc(data))
+    {
+        stream->crc_errors++;
+        ESP_LOGW(TAG, "Invalid CRC, sample dropped");
+        return ESP_OK;
+    }
+
+    memcpy(stream->raw_data, data, sizeof(sht3x_raw_data_t));
+    if (raw_data)
+        memcpy(raw_data, data, sizeof(sht3x_raw_data_t));
+    *fresh = true;
+
+    return ESP_OK;
+}
+
+esp_err_t sht3x_stream_read(sht3x_stream_t *stream, float *temperature, float *humidity, bool *fresh)
+{
+    CHECK_ARG(stream && fresh);
+
+    CHECK(sht3x_stream_poll(stream, NULL, fresh));
+    if (*fresh && (temperature || humidity))
+        return sht3x_compute_values(stream->raw_data, temperature, humidity);
+
+    return ESP_OK;
+}
+
+esp_err_t sht3x_stream_stop(sht3x_stream_t *stream)
+{
+    CHECK_ARG(stream && stream->dev);
+
+    CHECK(sht3x_stop_periodic_measurement(stream->dev));
+    stream->dev = NULL;
+
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t sht3x_group_init(sht3x_group_t *group, sht3x_t **devs, size_t count)
+{
+    CHECK_ARG(group && devs && count);
+
+    group->devs = devs;
+    group->count = count;
+    group->repeatability = SHT3X_HIGH;
+    group->start_time = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t sht3x_group_start(sht3x_group_t *group, sht3x_repeat_t repeat, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        esp_err_t r = sht3x_start_measurement(group->devs[i], SHT3X_SINGLE_SHOT, repeat);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+    group->repeatability = repeat;
+    group->start_time = esp_timer_get_time();
+
+    return res;
+}
+
+// wait once for the device started last
+static void group_wait(sht3x_group_t *group)
+{
+    uint64_t elapsed = esp_timer_get_time() - group->start_time;
+    uint32_t duration = SHT3X_MEAS_DURATION_US[group->repeatability];
+    if (elapsed < duration)
+        ESP_IDF_LIB_TRACE_DELAY(TIME_TO_TICKS((duration - elapsed + 999) / 1000));
+}
+
+static esp_err_t group_get_raw_data(sht3x_group_t *group, size_t i, sht3x_raw_data_t raw_data)
+{
+    if (!group->devs[i]->meas_started)
+        return ESP_ERR_INVALID_STATE;
+    return sht3x_get_raw_data(group->devs[i], raw_data);
+}
+
+esp_err_t sht3x_group_get_results(sht3x_group_t *group, float *temperatures, float *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    group_wait(group);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        sht3x_raw_data_t raw_data;
+        esp_err_t r = group_get_raw_data(group, i, raw_data);
+        if (r == ESP_OK)
+            sht3x_compute_values(raw_data, temperatures ? temperatures + i : NULL, humidities ? humidities + i : NULL);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
+
+esp_err_t sht3x_group_get_results_fixed(sht3x_group_t *group, int16_t *temperatures, int16_t *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    group_wait(group);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        sht3x_raw_data_t raw_data;
+        esp_err_t r = group_get_raw_data(group, i, raw_data);
+        if (r == ESP_OK)
+            sht3x_compute_values_fixed(raw_data, temperatures ? temperatures + i : NULL, humidities ? humidities + i : NULL);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
+
+esp_err_t sht3x_group_measure(sht3x_group_t *group, float *temperatures, float *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    esp_err_t res = sht3x_group_start(group, SHT3X_HIGH, results);
+    esp_err_t r = sht3x_group_get_results(group, temperatures, humidities, results);
+
+    return res != ESP_OK ? res : r;
+}
@@ -56,6 +56,8 @@ extern "C" {
 
 #define SHT3X_RAW_DATA_SIZE 6
 
+#define SHT3X_RESET_TIME_MS 10 //!< Time from soft reset until the sensor accepts commands, ms
+
 typedef uint8_t sht3x_raw_data_t[SHT3X_RAW_DATA_SIZE];
 
 /**
@@ -96,6 +98,32 @@ typedef struct
     bool meas_first;              //!< first measurement in periodic mode
 } sht3x_t;
 
+/**
+ * Periodic mode stream descriptor
+ */
+typedef struct
+{
+    sht3x_t *dev;                 //!< Device descriptor
+    uint32_t period_us;           //!< Period of measurements, us
+    uint64_t next;                //!< Time of the next expected sample, us
+    uint64_t last;                //!< Time of the last received sample, us
+    sht3x_raw_data_t raw_data;    //!< Raw data of the last sample
+    uint32_t reads;               //!< Number of fetch attempts
+    uint32_t not_ready;           //!< Number of fetches NACKed by sensor
+    uint32_t crc_errors;          //!< Number of samples with invalid CRC
+} sht3x_stream_t;
+
+/**
+ * Group of sensors measured together
+ */
+typedef struct
+{
+    sht3x_t **devs;               //!< Array of device descriptors
+    size_t count;                 //!< Number of devices
+    sht3x_repeat_t repeatability; //!< Repeatability of the last started measurement
+    uint64_t start_time;          //!< Time when the last device was started, us
+} sht3x_group_t;
+
 /**
  * @brief Initialize device descriptor
  *
@@ -124,6 +152,17 @@ esp_err_t sht3x_free_desc(sht3x_t *dev);
  */
 esp_err_t sht3x_init(sht3x_t *dev);
 
+/**
+ * @brief Soft reset sensor without waiting
+ *
+ * Same as ::sht3x_init() but does not wait for the sensor. Next command
+ * may be sent not earlier than ::SHT3X_RESET_TIME_MS after this function.
+ *
+ * @param dev       Device descriptor
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht3x_reset(sht3x_t *dev);
+
 /**
  * @brief Enable/disable heater
  *
@@ -157,6 +196,18 @@ esp_err_t sht3x_set_heater(sht3x_t *dev, bool enable);
  */
 esp_err_t sht3x_measure(sht3x_t *dev, float *temperature, float *humidity);
 
+/**
+ * @brief High level measurement function without floating point operations
+ *
+ * Same as ::sht3x_measure().
+ *
+ * @param dev         Device descriptor
+ * @param temperature Temperature in 0.01 degree Celsius, NULL-able
+ * @param humidity    Humidity in 0.01 percent, NULL-able
+ * @return            `ESP_OK` on success
+ */
+esp_err_t sht3x_measure_fixed(sht3x_t *dev, int16_t *temperature, int16_t *humidity);
+
 /**
  * @brief Get the duration of a measurement in RTOS ticks.
  *
@@ -244,6 +295,16 @@ esp_err_t sht3x_get_raw_data(sht3x_t *dev, sht3x_raw_data_t raw_data);
  */
 esp_err_t sht3x_compute_values(sht3x_raw_data_t raw_data, float *temperature, float *humidity);
 
+/**
+ * @brief Computes sensor values from raw data without floating point operations
+ *
+ * @param raw_data    Byte array that contains raw data
+ * @param temperature Temperature in 0.01 degree Celsius
+ * @param humidity    Humidity in 0.01 percent
+ * @return            `ESP_OK` on success
+ */
+esp_err_t sht3x_compute_values_fixed(sht3x_raw_data_t raw_data, int16_t *temperature, int16_t *humidity);
+
 /**
  * @brief Get measurement results in form of sensor values
  *
@@ -259,6 +320,147 @@ esp_err_t sht3x_compute_values(sht3x_raw_data_t raw_data, float *temperature, fl
  */
 esp_err_t sht3x_get_results(sht3x_t *dev, float *temperature, float *humidity);
 
+/**
+ * @brief Get measurement results without floating point operations
+ *
+ * Same as ::sht3x_get_results().
+ *
+ * @param dev         Device descriptor
+ * @param temperature Temperature in 0.01 degree Celsius
+ * @param humidity    Humidity in 0.01 percent
+ * @return            `ESP_OK` on success
+ */
+esp_err_t sht3x_get_results_fixed(sht3x_t *dev, int16_t *temperature, int16_t *humidity);
+
+/**
+ * @brief Start periodic measurement stream
+ *
+ * Starts periodic measurements once. After that, ::sht3x_stream_poll()
+ * only sends FETCH_DATA command and reads 6 bytes when the next sample is
+ * expected.
+ *
+ * @param stream    Stream descriptor
+ * @param dev       Device descriptor
+ * @param mode      Periodic measurement mode, see type ::sht3x_mode_t
+ * @param repeat    Repeatability, see type ::sht3x_repeat_t
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht3x_stream_start(sht3x_stream_t *stream, sht3x_t *dev, sht3x_mode_t mode, sht3x_repeat_t repeat);
+
+/**
+ * @brief Start stream in accelerated response time (ART) mode
+ *
+ * In ART mode sensor performs measurements at 4 mps.
+ *
+ * @param stream    Stream descriptor
+ * @param dev       Device descriptor
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht3x_stream_start_art(sht3x_stream_t *stream, sht3x_t *dev);
+
+/**
+ * @brief Poll stream for a new sample
+ *
+ * The bus is not accessed until the next sample is expected. Sensor NACKs
+ * the fetch when there is no new data yet: such reads are not logged as
+ * errors, the function just retries later. Sample with invalid CRC is
+ * dropped.
+ *
+ * @param stream     Stream descriptor
+ * @param[out] raw_data Raw data of a new sample, optional
+ * @param[out] fresh true if a new sample was received
+ * @return           `ESP_OK` on success, `ESP_ERR_TIMEOUT` if sensor have not
+ *                   returned new data for more than two periods
+ */
+esp_err_t sht3x_stream_poll(sht3x_stream_t *stream, sht3x_raw_data_t raw_data, bool *fresh);
+
+/**
+ * @brief Poll stream and compute values of a new sample
+ *
+ * Values are updated only if a new sample was received.
+ *
+ * @param stream     Stream descriptor
+ * @param[out] temperature Temperature in degree Celsius, optional
+ * @param[out] humidity    Humidity in percent, optional
+ * @param[out] fresh true if a new sample was received
+ * @return           `ESP_OK` on success
+ */
+esp_err_t sht3x_stream_read(sht3x_stream_t *stream, float *temperature, float *humidity, bool *fresh);
+
+/**
+ * @brief Stop stream and return sensor to single shot mode
+ *
+ * @param stream    Stream descriptor
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht3x_stream_stop(sht3x_stream_t *stream);
+
+/**
+ * @brief Initialize group of sensors
+ *
+ * Devices may be on different I2C ports or behind multiplexers.
+ *
+ * @param group     Group descriptor
+ * @param devs      Array of initialized device descriptors
+ * @param count     Number of devices
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht3x_group_init(sht3x_group_t *group, sht3x_t **devs, size_t count);
+
+/**
+ * @brief Start single shot measurement on all sensors of group
+ *
+ * Measurement is started on all devices even if some of them fail.
+ *
+ * @param group     Group descriptor
+ * @param repeat    Repeatability, see type ::sht3x_repeat_t
+ * @param[out] results Array of `count` per device results, optional
+ * @return          `ESP_OK` if started on all devices, otherwise the first error
+ */
+esp_err_t sht3x_group_start(sht3x_group_t *group, sht3x_repeat_t repeat, esp_err_t *results);
+
+/**
+ * @brief Read results of measurement started by ::sht3x_group_start()
+ *
+ * If the measurement is still running, the function waits once for the rest
+ * of the measurement duration and then reads all started devices in one pass.
+ * Values of device with failed read or CRC check are left untouched.
+ *
+ * @param group     Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in percent, optional
+ * @param[out] results Array of `count` per device results, optional
+ * @return          `ESP_OK` if all devices were read, otherwise the first error
+ */
+esp_err_t sht3x_group_get_results(sht3x_group_t *group, float *temperatures, float *humidities, esp_err_t *results);
+
+/**
+ * @brief Read results of group measurement without floating point operations
+ *
+ * Same as ::sht3x_group_get_results().
+ *
+ * @param group             Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in 0.01 degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in 0.01 percent, optional
+ * @param[out] results      Array of `count` per device results, optional
+ * @return                  `ESP_OK` if all devices were read, otherwise the first error
+ */
+esp_err_t sht3x_group_get_results_fixed(sht3x_group_t *group, int16_t *temperatures, int16_t *humidities, esp_err_t *results);
+
+/**
+ * @brief Measure all sensors of group in single shot mode with high repeatability
+ *
+ * Takes single measurement duration for the whole group instead of
+ * one duration per sensor.
+ *
+ * @param group     Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in percent, optional
+ * @param[out] results Array of `count` per device results, optional
+ * @return          `ESP_OK` if all devices were measured, otherwise the first error
+ */
+esp_err_t sht3x_group_measure(sht3x_group_t *group, float *temperatures, float *humidities, esp_err_t *results);
+
 #ifdef __cplusplus
 }
 #endif
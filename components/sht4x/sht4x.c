@@ -40,6 +40,8 @@
 #include <freertos/task.h>
 #include <esp_idf_lib_helpers.h>
 #include <esp_timer.h>
+#include <sensirion.h>
+#include <esp_idf_lib_trace.h>
 #include "sht4x.h"
 
 #define I2C_FREQ_HZ 1000000 // 1MHz
@@ -61,21 +63,6 @@ static const char *TAG = "sht4x";
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
-#define G_POLYNOM 0x31
-
-static uint8_t crc8(uint8_t data[], size_t len)
-{
-    uint8_t crc = 0xff;
-
-    for (size_t i = 0; i < len; i++)
-    {
-        crc ^= data[i];
-        for (size_t i = 0; i < 8; i++)
-            crc = crc & 0x80 ? (crc << 1) ^ G_POLYNOM : crc << 1;
-    }
-    return crc;
-}
-
 static inline size_t get_duration_ms(sht4x_t *dev)
 {
     switch (dev->heater)
@@ -143,7 +130,7 @@ static inline esp_err_t read_res_nolock(sht4x_t *dev, sht4x_raw_data_t res)
     ESP_LOGD(TAG, "Got response %02x %02x %02x %02x %02x %02x",
             res[0], res[1], res[2], res[3], res[4], res[5]);
 
-    if (res[2] != crc8(res, 2) || res[5] != crc8(res + 3, 2))
+    if (res[2] != sensirion_crc8(res, 2) || res[5] != sensirion_crc8(res + 3, 2))
     {
         ESP_LOGE(TAG, "Invalid CRC");
         return ESP_ERR_INVALID_CRC;
@@ -175,7 +162,7 @@ static esp_err_t exec_cmd(sht4x_t *dev, uint8_t cmd, size_t delay_ticks, sht4x_r
     I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
     I2C_DEV_CHECK(&dev->i2c_dev, send_cmd_nolock(dev, cmd));
     if (delay_ticks)
-        vTaskDelay(delay_ticks);
+        ESP_IDF_LIB_TRACE_DELAY(delay_ticks);
     I2C_DEV_CHECK(&dev->i2c_dev, read_res_nolock(dev, res));
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
@@ -252,6 +239,16 @@ esp_err_t sht4x_measure(sht4x_t *dev, float *temperature, float *humidity)
     return sht4x_compute_values(raw, temperature, humidity);
 }
 
+esp_err_t sht4x_measure_fixed(sht4x_t *dev, int16_t *temperature, int16_t *humidity)
+{
+    CHECK_ARG(dev && (temperature || humidity));
+
+    sht4x_raw_data_t raw;
+    CHECK(exec_cmd(dev, get_meas_cmd(dev), sht4x_get_measurement_duration(dev), raw));
+
+    return sht4x_compute_values_fixed(raw, temperature, humidity);
+}
+
 esp_err_t sht4x_start_measurement(sht4x_t *dev)
 {
     CHECK_ARG(dev);
@@ -269,6 +266,16 @@ esp_err_t sht4x_start_measurement(sht4x_t *dev)
     return ESP_OK;
 }
 
+esp_err_t sht4x_start_measurement_ready(sht4x_t *dev, esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    CHECK(sht4x_start_measurement(dev));
+    ready->ready_us = dev->meas_start_time + get_duration_ms(dev) * 1000;
+
+    return ESP_OK;
+}
+
 size_t sht4x_get_measurement_duration(sht4x_t *dev)
 {
     if (!dev) return 0;
@@ -304,6 +311,19 @@ esp_err_t sht4x_compute_values(sht4x_raw_data_t raw_data, float *temperature, fl
     return ESP_OK;
 }
 
+esp_err_t sht4x_compute_values_fixed(sht4x_raw_data_t raw_data, int16_t *temperature, int16_t *humidity)
+{
+    CHECK_ARG(raw_data && (temperature || humidity));
+
+    if (temperature)
+        *temperature = (int32_t)((uint16_t)raw_data[0] << 8 | raw_data[1]) * 17500 / 65535 - 4500;
+
+    if (humidity)
+        *humidity = (int32_t)((uint16_t)raw_data[3] << 8 | raw_data[4]) * 12500 / 65535 - 600;
+
+    return ESP_OK;
+}
+
 esp_err_t sht4x_get_results(sht4x_t *dev, float *temperature, float *humidity)
 {
     sht4x_raw_data_t raw;
@@ -311,3 +331,124 @@ esp_err_t sht4x_get_results(sht4x_t *dev, float *temperature, float *humidity)
 
     return sht4x_compute_values(raw, temperature, humidity);
 }
+
+esp_err_t sht4x_get_results_fixed(sht4x_t *dev, int16_t *temperature, int16_t *humidity)
+{
+    sht4x_raw_data_t raw;
+    CHECK(sht4x_get_raw_data(dev, raw));
+
+    return sht4x_compute_values_fixed(raw, temperature, humidity);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t sht4x_group_init(sht4x_group_t *group, sht4x_t **devs, size_t count)
+{
+    CHECK_ARG(group && devs && count);
+
+    group->devs = devs;
+    group->count = count;
+
+    return ESP_OK;
+}
+
+esp_err_t sht4x_group_start(sht4x_group_t *group, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        esp_err_t r = sht4x_start_measurement(group->devs[i]);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
+
+static void group_wait(sht4x_group_t *group)
+{
+    // find the end of the longest measurement
+    uint64_t end = 0;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        sht4x_t *dev = group->devs[i];
+        if (!dev->meas_started)
+            continue;
+        uint64_t e = dev->meas_start_time + get_duration_ms(dev) * 1000;
+        if (e > end)
+            end = e;
+    }
+
+    // and wait for it once
+    uint64_t now = esp_timer_get_time();
+    if (end > now)
+    {
+        TickType_t ticks = pdMS_TO_TICKS((end - now + 999) / 1000);
+        ESP_IDF_LIB_TRACE_DELAY(ticks ? ticks + 1 : 1);
+    }
+}
+
+static esp_err_t group_get_raw_data(sht4x_group_t *group, size_t i, sht4x_raw_data_t raw)
+{
+    if (!group->devs[i]->meas_started)
+        return ESP_ERR_INVALID_STATE;
+    return sht4x_get_raw_data(group->devs[i], raw);
+}
+
+esp_err_t sht4x_group_get_results(sht4x_group_t *group, float *temperatures, float *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    group_wait(group);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        sht4x_raw_data_t raw;
+        esp_err_t r = group_get_raw_data(group, i, raw);
+        if (r == ESP_OK)
+            sht4x_compute_values(raw, temperatures ? temperatures + i : NULL, humidities ? humidities + i : NULL);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
+
+esp_err_t sht4x_group_get_results_fixed(sht4x_group_t *group, int16_t *temperatures, int16_t *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    group_wait(group);
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < group->count; i++)
+    {
+        sht4x_raw_data_t raw;
+        esp_err_t r = group_get_raw_data(group, i, raw);
+        if (r == ESP_OK)
+            sht4x_compute_values_fixed(raw, temperatures ? temperatures + i : NULL, humidities ? humidities + i : NULL);
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
+
+esp_err_t sht4x_group_measure(sht4x_group_t *group, float *temperatures, float *humidities, esp_err_t *results)
+{
+    CHECK_ARG(group && group->devs);
+
+    esp_err_t res = sht4x_group_start(group, results);
+    esp_err_t r = sht4x_group_get_results(group, temperatures, humidities, results);
+
+    return res != ESP_OK ? res : r;
+}
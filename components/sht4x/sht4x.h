@@ -42,6 +42,7 @@
 #include <stdbool.h>
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <esp_idf_lib_ready.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,6 +94,15 @@ typedef struct
     uint64_t meas_start_time;     //!< measurement start time in us
 } sht4x_t;
 
+/**
+ * Group of sensors measured together
+ */
+typedef struct
+{
+    sht4x_t **devs;               //!< Array of device descriptors
+    size_t count;                 //!< Number of devices
+} sht4x_group_t;
+
 /**
  * @brief Initialize device descriptor
  *
@@ -152,6 +162,18 @@ esp_err_t sht4x_reset(sht4x_t *dev);
  */
 esp_err_t sht4x_measure(sht4x_t *dev, float *temperature, float *humidity);
 
+/**
+ * @brief High level measurement function without floating point operations
+ *
+ * Same as ::sht4x_measure().
+ *
+ * @param dev         Device descriptor
+ * @param temperature Temperature in 0.01 degree Celsius, NULL-able
+ * @param humidity    Humidity in 0.01 percent, NULL-able
+ * @return            `ESP_OK` on success
+ */
+esp_err_t sht4x_measure_fixed(sht4x_t *dev, int16_t *temperature, int16_t *humidity);
+
 /**
  * @brief Start the measurement.
  *
@@ -160,6 +182,19 @@ esp_err_t sht4x_measure(sht4x_t *dev, float *temperature, float *humidity);
  */
 esp_err_t sht4x_start_measurement(sht4x_t *dev);
 
+/**
+ * @brief Start measurement and get its ready time
+ *
+ * Works as ::sht4x_start_measurement(), `ready` is set to the end of
+ * measurement duration including heater pulse. Read results with
+ * ::sht4x_get_results() after waiting for the token.
+ *
+ * @param dev           Device descriptor
+ * @param[out] ready    Conversion ready token
+ * @return              `ESP_OK` on success
+ */
+esp_err_t sht4x_start_measurement_ready(sht4x_t *dev, esp_idf_lib_ready_t *ready);
+
 /**
  * @brief Get the duration of a measurement in RTOS ticks.
  *
@@ -205,6 +240,16 @@ esp_err_t sht4x_get_raw_data(sht4x_t *dev, sht4x_raw_data_t raw);
  */
 esp_err_t sht4x_compute_values(sht4x_raw_data_t raw_data, float *temperature, float *humidity);
 
+/**
+ * @brief Computes sensor values from raw data without floating point operations
+ *
+ * @param raw_data         Byte array that contains raw data
+ * @param[out] temperature Temperature in 0.01 degree Celsius
+ * @param[out] humidity    Humidity in 0.01 percent
+ * @return                 `ESP_OK` on success
+ */
+esp_err_t sht4x_compute_values_fixed(sht4x_raw_data_t raw_data, int16_t *temperature, int16_t *humidity);
+
 /**
  * @brief Get measurement results in form of sensor values
  *
@@ -220,6 +265,83 @@ esp_err_t sht4x_compute_values(sht4x_raw_data_t raw_data, float *temperature, fl
  */
 esp_err_t sht4x_get_results(sht4x_t *dev, float *temperature, float *humidity);
 
+/**
+ * @brief Get measurement results without floating point operations
+ *
+ * Same as ::sht4x_get_results().
+ *
+ * @param dev              Device descriptor
+ * @param[out] temperature Temperature in 0.01 degree Celsius
+ * @param[out] humidity    Humidity in 0.01 percent
+ * @return                 `ESP_OK` on success
+ */
+esp_err_t sht4x_get_results_fixed(sht4x_t *dev, int16_t *temperature, int16_t *humidity);
+
+/**
+ * @brief Initialize group of sensors
+ *
+ * Devices may be on different I2C ports or behind multiplexers.
+ * Each device keeps its own repeatability and heater settings.
+ *
+ * @param group     Group descriptor
+ * @param devs      Array of initialized device descriptors
+ * @param count     Number of devices
+ * @return          `ESP_OK` on success
+ */
+esp_err_t sht4x_group_init(sht4x_group_t *group, sht4x_t **devs, size_t count);
+
+/**
+ * @brief Start measurement on all sensors of group
+ *
+ * Measurement is started on all devices even if some of them fail.
+ *
+ * @param group        Group descriptor
+ * @param[out] results Array of `count` per device results, optional
+ * @return             `ESP_OK` if started on all devices, otherwise the first error
+ */
+esp_err_t sht4x_group_start(sht4x_group_t *group, esp_err_t *results);
+
+/**
+ * @brief Read results of measurement started by ::sht4x_group_start()
+ *
+ * The function waits once until the longest measurement in group is
+ * finished and then reads all started devices in one pass. Values of
+ * device with failed read or CRC check are left untouched.
+ *
+ * @param group             Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in percent, optional
+ * @param[out] results      Array of `count` per device results, optional
+ * @return                  `ESP_OK` if all devices were read, otherwise the first error
+ */
+esp_err_t sht4x_group_get_results(sht4x_group_t *group, float *temperatures, float *humidities, esp_err_t *results);
+
+/**
+ * @brief Read results of group measurement without floating point operations
+ *
+ * Same as ::sht4x_group_get_results().
+ *
+ * @param group             Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in 0.01 degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in 0.01 percent, optional
+ * @param[out] results      Array of `count` per device results, optional
+ * @return                  `ESP_OK` if all devices were read, otherwise the first error
+ */
+esp_err_t sht4x_group_get_results_fixed(sht4x_group_t *group, int16_t *temperatures, int16_t *humidities, esp_err_t *results);
+
+/**
+ * @brief Measure all sensors of group
+ *
+ * Combines ::sht4x_group_start() and ::sht4x_group_get_results()
+ *
+ * @param group             Group descriptor
+ * @param[out] temperatures Array of `count` temperatures in degree Celsius, optional
+ * @param[out] humidities   Array of `count` humidities in percent, optional
+ * @param[out] results      Array of `count` per device results, optional
+ * @return                  `ESP_OK` if all devices were measured, otherwise the first error
+ */
+esp_err_t sht4x_group_measure(sht4x_group_t *group, float *temperatures, float *humidities, esp_err_t *results);
+
 #ifdef __cplusplus
 }
 #endif
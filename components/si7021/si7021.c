@@ -39,6 +39,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "si7021.h"
 
 #define I2C_FREQ_HZ 400000 // 400kHz
@@ -47,11 +48,15 @@ static const char *TAG = "si7021";
 
 #define DELAY_MS 50  // fixed delay
 
+// Maximal conversion times at the highest resolution, RH conversion includes temperature
+#define CONV_T_US  10800
+#define CONV_RH_US (12000 + CONV_T_US)
+
 #define CMD_MEAS_RH_HOLD     0xe5 // not used, can't stretch clock
 #define CMD_MEAS_RH_NOHOLD   0xf5
 #define CMD_MEAS_T_HOLD      0xe3 // not used, can't stretch clock
 #define CMD_MEAS_T_NOHOLD    0xf3
-#define CMD_READ_T           0xe0 // not used
+#define CMD_READ_T           0xe0 // temperature of previous RH measurement, no CRC
 #define CMD_RESET            0xfe
 #define CMD_WRITE_USER_REG   0xe6
 #define CMD_READ_USER_REG    0xe7
@@ -89,6 +94,19 @@ static bool check_crc(uint16_t value, uint8_t crc)
     return !row;
 }
 
+static esp_err_t check_raw(const uint8_t *buf, uint16_t *raw)
+{
+    *raw = ((uint16_t)buf[0] << 8) | buf[1];
+
+    if (!check_crc(*raw, buf[2]))
+    {
+        ESP_LOGE(TAG, "Invalid CRC");
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    return ESP_OK;
+}
+
 static esp_err_t measure(i2c_dev_t *dev, uint8_t cmd, uint16_t *raw)
 {
     I2C_DEV_TAKE_MUTEX(dev);
@@ -96,24 +114,61 @@ static esp_err_t measure(i2c_dev_t *dev, uint8_t cmd, uint16_t *raw)
     I2C_DEV_CHECK(dev, i2c_dev_write(dev, NULL, 0, &cmd, 1));
 
     // wait
-    vTaskDelay(DELAY_MS / portTICK_RATE_MS);
+    ESP_IDF_LIB_TRACE_DELAY(DELAY_MS / portTICK_RATE_MS);
 
     // read data
     uint8_t buf[3];
     I2C_DEV_CHECK(dev, i2c_dev_read(dev, NULL, 0, buf, 3));
     I2C_DEV_GIVE_MUTEX(dev);
 
-    *raw = ((uint16_t)buf[0] << 8) | buf[1];
+    return check_raw(buf, raw);
+}
 
-    if (!check_crc(*raw, buf[2]))
-    {
-        ESP_LOGE(TAG, "Invalid CRC");
-        return ESP_ERR_INVALID_RESPONSE;
-    }
+static esp_err_t start(i2c_dev_t *dev, uint8_t cmd, uint32_t conversion_us, esp_idf_lib_ready_t *ready)
+{
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write(dev, NULL, 0, &cmd, 1));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    esp_idf_lib_ready_after(ready, conversion_us);
 
     return ESP_OK;
 }
 
+static esp_err_t read_raw(i2c_dev_t *dev, uint16_t *raw)
+{
+    uint8_t buf[3];
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_read(dev, NULL, 0, buf, 3));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    return check_raw(buf, raw);
+}
+
+// Humidity and temperature of the same conversion, mutex must be taken
+static esp_err_t read_rh_t_nolock(i2c_dev_t *dev, uint16_t *raw_rh, uint16_t *raw_t)
+{
+    uint8_t buf[3];
+    CHECK(i2c_dev_read(dev, NULL, 0, buf, 3));
+    CHECK(check_raw(buf, raw_rh));
+
+    uint8_t cmd = CMD_READ_T;
+    CHECK(i2c_dev_read(dev, &cmd, 1, buf, 2));
+    *raw_t = ((uint16_t)buf[0] << 8) | buf[1];
+
+    return ESP_OK;
+}
+
+static inline float raw_to_temperature(uint16_t raw)
+{
+    return raw * 175.72 / 65536 - 46.85;
+}
+
+static inline float raw_to_humidity(uint16_t raw)
+{
+    return raw * 125.0 / 65536 - 6;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 esp_err_t si7021_init_desc(i2c_dev_t *dev, i2c_port_t port, gpio_num_t sda_gpio, gpio_num_t scl_gpio)
@@ -244,7 +299,7 @@ esp_err_t si7021_measure_temperature(i2c_dev_t *dev, float *t)
 
     uint16_t raw;
     CHECK(measure(dev, CMD_MEAS_T_NOHOLD, &raw));
-    *t = raw * 175.72 / 65536 - 46.85;
+    *t = raw_to_temperature(raw);
 
     return ESP_OK;
 }
@@ -255,7 +310,84 @@ esp_err_t si7021_measure_humidity(i2c_dev_t *dev, float *rh)
 
     uint16_t raw;
     CHECK(measure(dev, CMD_MEAS_RH_NOHOLD, &raw));
-    *rh = raw * 125.0 / 65536 - 6;
+    *rh = raw_to_humidity(raw);
+
+    return ESP_OK;
+}
+
+static void convert_rh_t(uint16_t raw_rh, uint16_t raw_t, float *t, float *rh)
+{
+    if (t)
+        *t = raw_to_temperature(raw_t);
+    if (rh)
+        *rh = raw_to_humidity(raw_rh);
+}
+
+esp_err_t si7021_measure(i2c_dev_t *dev, float *t, float *rh)
+{
+    CHECK_ARG(dev && (t || rh));
+
+    uint8_t cmd = CMD_MEAS_RH_NOHOLD;
+    uint16_t raw_rh, raw_t;
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, i2c_dev_write(dev, NULL, 0, &cmd, 1));
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(CONV_RH_US / 1000 + 1));
+    I2C_DEV_CHECK(dev, read_rh_t_nolock(dev, &raw_rh, &raw_t));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    convert_rh_t(raw_rh, raw_t, t, rh);
+
+    return ESP_OK;
+}
+
+esp_err_t si7021_start_temperature(i2c_dev_t *dev, esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    return start(dev, CMD_MEAS_T_NOHOLD, CONV_T_US, ready);
+}
+
+esp_err_t si7021_start_humidity(i2c_dev_t *dev, esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    return start(dev, CMD_MEAS_RH_NOHOLD, CONV_RH_US, ready);
+}
+
+esp_err_t si7021_read_temperature(i2c_dev_t *dev, float *t)
+{
+    CHECK_ARG(dev && t);
+
+    uint16_t raw;
+    CHECK(read_raw(dev, &raw));
+    *t = raw_to_temperature(raw);
+
+    return ESP_OK;
+}
+
+esp_err_t si7021_read_humidity(i2c_dev_t *dev, float *rh)
+{
+    CHECK_ARG(dev && rh);
+
+    uint16_t raw;
+    CHECK(read_raw(dev, &raw));
+    *rh = raw_to_humidity(raw);
+
+    return ESP_OK;
+}
+
+esp_err_t si7021_read_measurement(i2c_dev_t *dev, float *t, float *rh)
+{
+    CHECK_ARG(dev && (t || rh));
+
+    uint16_t raw_rh, raw_t;
+
+    I2C_DEV_TAKE_MUTEX(dev);
+    I2C_DEV_CHECK(dev, read_rh_t_nolock(dev, &raw_rh, &raw_t));
+    I2C_DEV_GIVE_MUTEX(dev);
+
+    convert_rh_t(raw_rh, raw_t, t, rh);
 
     return ESP_OK;
 }
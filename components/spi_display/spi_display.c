@@ -0,0 +1,468 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file spi_display.c
+ *
+ * Framebuffer renderer for SPI displays
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <esp_heap_caps.h>
+#include <esp_log.h>
+#include <esp_idf_lib_trace.h>
+#include "spi_display.h"
+
+static const char *TAG = "spi_display";
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// DC level is set by pre-transfer callback from transaction user field
+#define DC_USER(dev, level) ((void *)(uintptr_t)(((uint32_t)(dev)->dc_pin << 1) | (level)))
+
+#define DCS_SWRESET 0x01
+#define DCS_SLPOUT  0x11
+#define DCS_NORON   0x13
+#define DCS_INVOFF  0x20
+#define DCS_INVON   0x21
+#define DCS_DISPOFF 0x28
+#define DCS_DISPON  0x29
+#define DCS_CASET   0x2a
+#define DCS_RASET   0x2b
+#define DCS_RAMWR   0x2c
+#define DCS_MADCTL  0x36
+#define DCS_COLMOD  0x3a
+
+#define MADCTL_MY   0x80
+#define MADCTL_MX   0x40
+#define MADCTL_MV   0x20
+#define MADCTL_BGR  0x08
+
+#define COLMOD_RGB565 0x55
+
+#define SSD1306_COLUMN_ADDR 0x21
+#define SSD1306_PAGE_ADDR   0x22
+#define SSD1306_DISPLAY_OFF 0xae
+#define SSD1306_DISPLAY_ON  0xaf
+
+#define DEFAULT_THRESHOLD 128
+
+static const uint8_t madctl_st7789[] = {
+    0, MADCTL_MX | MADCTL_MV, MADCTL_MX | MADCTL_MY, MADCTL_MY | MADCTL_MV
+};
+
+static const uint8_t madctl_ili9341[] = {
+    MADCTL_MX, MADCTL_MV, MADCTL_MY, MADCTL_MX | MADCTL_MY | MADCTL_MV
+};
+
+// 4x4 Bayer matrix, thresholds of ordered dithering
+static const uint8_t bayer4[4][4] = {
+    {   8, 136,  40, 168 },
+    { 200,  72, 232, 104 },
+    {  56, 184,  24, 152 },
+    { 248, 120, 216,  88 },
+};
+
+static void IRAM_ATTR pre_transfer(spi_transaction_t *t)
+{
+    uint32_t user = (uint32_t)(uintptr_t)t->user;
+    gpio_set_level(user >> 1, user & 1);
+}
+
+static inline bool is_mono(const spi_display_t *dev)
+{
+    return dev->type == SPI_DISPLAY_SSD1306;
+}
+
+static esp_err_t transmit(spi_display_t *dev, spi_transaction_t *t)
+{
+    ESP_IDF_LIB_TRACE_BEGIN(ESP_IDF_LIB_TRACE_SPI, t->length);
+    esp_err_t res = spi_device_polling_transmit(dev->spi_dev, t);
+    ESP_IDF_LIB_TRACE_END(ESP_IDF_LIB_TRACE_SPI);
+    return res;
+}
+
+// Synchronous command, queue must be empty. SSD1306 takes arguments as commands
+static esp_err_t send_cmd(spi_display_t *dev, uint8_t cmd, const uint8_t *args, size_t len)
+{
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.flags = SPI_TRANS_USE_TXDATA;
+    t.tx_data[0] = cmd;
+    t.user = DC_USER(dev, 0);
+    if (is_mono(dev))
+    {
+        memcpy(t.tx_data + 1, args, len);
+        t.length = (len + 1) * 8;
+        return transmit(dev, &t);
+    }
+    t.length = 8;
+    CHECK(transmit(dev, &t));
+    if (!len)
+        return ESP_OK;
+
+    memset(&t, 0, sizeof(t));
+    t.flags = SPI_TRANS_USE_TXDATA;
+    memcpy(t.tx_data, args, len);
+    t.length = len * 8;
+    t.user = DC_USER(dev, 1);
+    return transmit(dev, &t);
+}
+
+static esp_err_t send_cmd1(spi_display_t *dev, uint8_t cmd, uint8_t arg)
+{
+    return send_cmd(dev, cmd, &arg, 1);
+}
+
+static esp_err_t queue(spi_display_t *dev, spi_transaction_t *t)
+{
+    CHECK(spi_device_queue_trans(dev->spi_dev, t, portMAX_DELAY));
+    dev->in_flight++;
+    return ESP_OK;
+}
+
+static esp_err_t complete_one(spi_display_t *dev)
+{
+    spi_transaction_t *t;
+    CHECK(spi_device_get_trans_result(dev->spi_dev, &t, portMAX_DELAY));
+    dev->in_flight--;
+    if (t == &dev->data_trans[0])
+        dev->busy &= ~1;
+    else if (t == &dev->data_trans[1])
+        dev->busy &= ~2;
+    return ESP_OK;
+}
+
+static void setup_cmd_trans(spi_display_t *dev, spi_transaction_t *t, int dc, size_t len, const uint8_t *data)
+{
+    memset(t, 0, sizeof(*t));
+    t->flags = SPI_TRANS_USE_TXDATA;
+    t->length = len * 8;
+    memcpy(t->tx_data, data, len);
+    t->user = DC_USER(dev, dc);
+}
+
+static esp_err_t queue_window(spi_display_t *dev, size_t x0, size_t y0, size_t x1, size_t y1)
+{
+    x0 += dev->x_offset;
+    x1 += dev->x_offset;
+    y0 += dev->y_offset;
+    y1 += dev->y_offset;
+
+    if (is_mono(dev))
+    {
+        uint8_t col[] = { SSD1306_COLUMN_ADDR, x0, x1 };
+        uint8_t page[] = { SSD1306_PAGE_ADDR, y0 / 8, y1 / 8 };
+        setup_cmd_trans(dev, &dev->cmd_trans[0], 0, sizeof(col), col);
+        setup_cmd_trans(dev, &dev->cmd_trans[1], 0, sizeof(page), page);
+        CHECK(queue(dev, &dev->cmd_trans[0]));
+        return queue(dev, &dev->cmd_trans[1]);
+    }
+
+    uint8_t caset = DCS_CASET, raset = DCS_RASET, ramwr = DCS_RAMWR;
+    uint8_t cols[] = { x0 >> 8, x0, x1 >> 8, x1 };
+    uint8_t rows[] = { y0 >> 8, y0, y1 >> 8, y1 };
+    setup_cmd_trans(dev, &dev->cmd_trans[0], 0, 1, &caset);
+    setup_cmd_trans(dev, &dev->cmd_trans[1], 1, sizeof(cols), cols);
+    setup_cmd_trans(dev, &dev->cmd_trans[2], 0, 1, &raset);
+    setup_cmd_trans(dev, &dev->cmd_trans[3], 1, sizeof(rows), rows);
+    setup_cmd_trans(dev, &dev->cmd_trans[4], 0, 1, &ramwr);
+    for (size_t i = 0; i < SPI_DISPLAY_CMD_TRANS; i++)
+        CHECK(queue(dev, &dev->cmd_trans[i]));
+
+    return ESP_OK;
+}
+
+static inline rgb_t fetch(const color_gamma_t *gamma, rgb_t c)
+{
+    return gamma ? color_gamma_apply(gamma, c) : c;
+}
+
+static uint8_t *pack_rgb565(const color_gamma_t *gamma, const rgb_t *src, size_t num, uint8_t *dst)
+{
+    for (size_t i = 0; i < num; i++, dst += 2)
+    {
+        rgb_t c = fetch(gamma, src[i]);
+        // Big endian RRRRRGGG GGGBBBBB
+        dst[0] = (c.r & 0xf8) | (c.g >> 5);
+        dst[1] = ((c.g << 3) & 0xe0) | (c.b >> 3);
+    }
+    return dst;
+}
+
+static void convert_rgb565(const framebuffer_t *fb, size_t x0, size_t w, size_t y, size_t rows, uint8_t *dst)
+{
+    for (size_t row = y; row < y + rows; row++)
+    {
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, x0, row, w, &first, &second);
+        dst = pack_rgb565(fb->gamma, first, n, dst);
+        if (n < w)
+            dst = pack_rgb565(fb->gamma, second, w - n, dst);
+    }
+}
+
+static void pack_mono(const spi_display_t *dev, const color_gamma_t *gamma, const rgb_t *src,
+        size_t x, size_t num, size_t row, uint8_t *dst)
+{
+    uint8_t bit = 1 << (row & 7);
+    const uint8_t *thresholds = bayer4[row & 3];
+    uint8_t threshold = dev->threshold ? dev->threshold : DEFAULT_THRESHOLD;
+    for (size_t i = 0; i < num; i++, x++)
+    {
+        uint8_t luma = rgb_luma(fetch(gamma, src[i]));
+        if (dev->dither ? luma > thresholds[x & 3] : luma >= threshold)
+            dst[i] |= bit;
+    }
+}
+
+// Pages of 8 rows, every byte is a column of page, LSB is the top row
+static void convert_mono(const spi_display_t *dev, const framebuffer_t *fb, size_t x0, size_t w,
+        size_t y, size_t rows, uint8_t *dst)
+{
+    memset(dst, 0, rows / 8 * w);
+    for (size_t row = y; row < y + rows; row++)
+    {
+        uint8_t *page = dst + (row - y) / 8 * w;
+        rgb_t *first, *second;
+        size_t n = fb_span_unchecked(fb, x0, row, w, &first, &second);
+        pack_mono(dev, fb->gamma, first, x0, n, row, page);
+        if (n < w)
+            pack_mono(dev, fb->gamma, second, x0 + n, w - n, row, page + n);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t spi_display_init_desc(spi_display_t *dev, spi_host_device_t host, uint32_t clock_hz,
+        gpio_num_t cs_pin, gpio_num_t dc_pin, gpio_num_t rst_pin)
+{
+    CHECK_ARG(dev && clock_hz && dc_pin >= 0);
+
+    dev->dc_pin = dc_pin;
+    dev->rst_pin = rst_pin;
+    dev->buf[0] = dev->buf[1] = NULL;
+    dev->cur = 0;
+    dev->busy = 0;
+    dev->in_flight = 0;
+
+    CHECK(gpio_reset_pin(dc_pin));
+    CHECK(gpio_set_direction(dc_pin, GPIO_MODE_OUTPUT));
+    if (rst_pin >= 0)
+    {
+        CHECK(gpio_reset_pin(rst_pin));
+        CHECK(gpio_set_direction(rst_pin, GPIO_MODE_OUTPUT));
+        CHECK(gpio_set_level(rst_pin, 1));
+    }
+
+    memset(&dev->spi_cfg, 0, sizeof(dev->spi_cfg));
+    dev->spi_cfg.spics_io_num = cs_pin;
+    dev->spi_cfg.clock_speed_hz = clock_hz;
+    // Modules without CS pin latch data only in mode 3
+    dev->spi_cfg.mode = cs_pin >= 0 ? 0 : 3;
+    dev->spi_cfg.queue_size = SPI_DISPLAY_CMD_TRANS + 2;
+    dev->spi_cfg.pre_cb = pre_transfer;
+
+    return spi_bus_add_device(host, &dev->spi_cfg, &dev->spi_dev);
+}
+
+esp_err_t spi_display_free_desc(spi_display_t *dev)
+{
+    CHECK_ARG(dev);
+
+    CHECK(spi_display_wait(dev));
+    heap_caps_free(dev->buf[0]);
+    heap_caps_free(dev->buf[1]);
+    dev->buf[0] = dev->buf[1] = NULL;
+
+    return spi_bus_remove_device(dev->spi_dev);
+}
+
+size_t spi_display_buffer_size(const spi_display_t *dev)
+{
+    if (!dev)
+        return 0;
+    if (is_mono(dev))
+        return dev->width * dev->height / 8;
+    return (dev->lines ? dev->lines : SPI_DISPLAY_LINES) * dev->width * 2;
+}
+
+static esp_err_t init_dcs(spi_display_t *dev)
+{
+    const uint8_t *madctl = dev->type == SPI_DISPLAY_ILI9341 ? madctl_ili9341 : madctl_st7789;
+
+    CHECK(send_cmd(dev, DCS_SWRESET, NULL, 0));
+    vTaskDelay(pdMS_TO_TICKS(150));
+    CHECK(send_cmd(dev, DCS_SLPOUT, NULL, 0));
+    vTaskDelay(pdMS_TO_TICKS(120));
+    CHECK(send_cmd1(dev, DCS_COLMOD, COLMOD_RGB565));
+    CHECK(send_cmd1(dev, DCS_MADCTL, madctl[dev->rotation & 3] | (dev->bgr ? MADCTL_BGR : 0)));
+    CHECK(send_cmd(dev, dev->invert ? DCS_INVON : DCS_INVOFF, NULL, 0));
+    CHECK(send_cmd(dev, DCS_NORON, NULL, 0));
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    return send_cmd(dev, DCS_DISPON, NULL, 0);
+}
+
+static esp_err_t init_ssd1306(spi_display_t *dev)
+{
+    bool flip = dev->rotation == SPI_DISPLAY_ROTATION_180;
+
+    CHECK(send_cmd(dev, SSD1306_DISPLAY_OFF, NULL, 0));
+    CHECK(send_cmd1(dev, 0xd5, 0x80));                         // clock divider
+    CHECK(send_cmd1(dev, 0xa8, dev->height - 1));              // multiplex ratio
+    CHECK(send_cmd1(dev, 0xd3, 0));                            // display offset
+    CHECK(send_cmd(dev, 0x40, NULL, 0));                       // start line 0
+    CHECK(send_cmd1(dev, 0x8d, 0x14));                         // charge pump on
+    CHECK(send_cmd1(dev, 0x20, 0));                            // horizontal addressing
+    CHECK(send_cmd(dev, flip ? 0xa0 : 0xa1, NULL, 0));         // segment remap
+    CHECK(send_cmd(dev, flip ? 0xc0 : 0xc8, NULL, 0));         // COM scan direction
+    CHECK(send_cmd1(dev, 0xda, dev->height == 64 ? 0x12 : 0x02)); // COM pins
+    CHECK(send_cmd1(dev, 0x81, 0xcf));                         // contrast
+    CHECK(send_cmd1(dev, 0xd9, 0xf1));                         // precharge
+    CHECK(send_cmd1(dev, 0xdb, 0x40));                         // VCOMH level
+    CHECK(send_cmd(dev, 0xa4, NULL, 0));                       // display RAM content
+    CHECK(send_cmd(dev, dev->invert ? 0xa7 : 0xa6, NULL, 0));  // normal or inverse
+
+    return send_cmd(dev, SSD1306_DISPLAY_ON, NULL, 0);
+}
+
+esp_err_t spi_display_init(spi_display_t *dev)
+{
+    CHECK_ARG(dev && dev->spi_dev && dev->width && dev->height && dev->type <= SPI_DISPLAY_SSD1306);
+    if (is_mono(dev) && (dev->height % 8 || dev->rotation % 2))
+    {
+        ESP_LOGE(TAG, "SSD1306 height must be multiple of 8, rotation 0 or 180");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    CHECK(spi_display_wait(dev));
+
+    size_t size = spi_display_buffer_size(dev);
+    for (int i = 0; i < 2; i++)
+    {
+        if (!dev->buf[i])
+            dev->buf[i] = heap_caps_malloc(size, MALLOC_CAP_DMA);
+        if (!dev->buf[i])
+        {
+            ESP_LOGE(TAG, "Not enough DMA memory for line buffers, %u bytes", (unsigned)size);
+            heap_caps_free(dev->buf[0]);
+            dev->buf[0] = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    dev->cur = 0;
+    dev->busy = 0;
+
+    if (dev->rst_pin >= 0)
+    {
+        gpio_set_level(dev->rst_pin, 0);
+        vTaskDelay(pdMS_TO_TICKS(10));
+        gpio_set_level(dev->rst_pin, 1);
+        vTaskDelay(pdMS_TO_TICKS(120));
+    }
+
+    return is_mono(dev) ? init_ssd1306(dev) : init_dcs(dev);
+}
+
+esp_err_t spi_display_set_on(spi_display_t *dev, bool on)
+{
+    CHECK_ARG(dev);
+
+    CHECK(spi_display_wait(dev));
+    if (is_mono(dev))
+        return send_cmd(dev, on ? SSD1306_DISPLAY_ON : SSD1306_DISPLAY_OFF, NULL, 0);
+    return send_cmd(dev, on ? DCS_DISPON : DCS_DISPOFF, NULL, 0);
+}
+
+esp_err_t spi_display_wait(spi_display_t *dev)
+{
+    CHECK_ARG(dev);
+
+    while (dev->in_flight)
+        CHECK(complete_one(dev));
+
+    return ESP_OK;
+}
+
+esp_err_t spi_display_draw(spi_display_t *dev, framebuffer_t *fb, const fb_rect_t *rect)
+{
+    CHECK_ARG(dev && dev->buf[0] && dev->buf[1] && fb && fb->data && rect
+            && fb->width == dev->width && fb->height == dev->height
+            && rect->x0 <= rect->x1 && rect->y0 <= rect->y1
+            && rect->x1 < fb->width && rect->y1 < fb->height);
+
+    size_t x0 = rect->x0, y0 = rect->y0, y1 = rect->y1;
+    size_t w = rect->x1 - x0 + 1;
+    // Lines are sent in chunks of whole pages for SSD1306
+    size_t unit = is_mono(dev) ? 8 : 1;
+    size_t unit_bytes = is_mono(dev) ? w : w * 2;
+    y0 -= y0 % unit;
+    y1 += unit - 1 - y1 % unit;
+    size_t chunk = spi_display_buffer_size(dev) / unit_bytes * unit;
+
+    // Window transactions are reused, previous frame must be sent
+    CHECK(spi_display_wait(dev));
+    CHECK(queue_window(dev, x0, y0, rect->x1, y1));
+
+    for (size_t y = y0; y <= y1; y += chunk)
+    {
+        size_t rows = y1 - y + 1 < chunk ? y1 - y + 1 : chunk;
+        uint8_t b = dev->cur;
+
+        while (dev->busy & (1 << b))
+            CHECK(complete_one(dev));
+
+        if (is_mono(dev))
+            convert_mono(dev, fb, x0, w, y, rows, dev->buf[b]);
+        else
+            convert_rgb565(fb, x0, w, y, rows, dev->buf[b]);
+
+        spi_transaction_t *t = &dev->data_trans[b];
+        memset(t, 0, sizeof(*t));
+        t->length = rows / unit * unit_bytes * 8;
+        t->tx_buffer = dev->buf[b];
+        t->user = DC_USER(dev, 1);
+        CHECK(queue(dev, t));
+        dev->busy |= 1 << b;
+        dev->cur = b ^ 1;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t spi_display_render(framebuffer_t *fb, void *arg)
+{
+    CHECK_ARG(fb && arg);
+
+    fb_rect_t full = { 0, 0, fb->width - 1, fb->height - 1 };
+
+    return spi_display_draw((spi_display_t *)arg, fb, fb->dirty ? &fb->dirty_rect : &full);
+}
@@ -0,0 +1,210 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file spi_display.h
+ * @defgroup spi_display spi_display
+ * @{
+ *
+ * Framebuffer renderer for SPI displays: ST7789, ILI9341 (RGB565) and
+ * SSD1306 (monochrome)
+ *
+ * Only the changed region of framebuffer is sent. Pixels are converted
+ * into two DMA-capable line buffers: while one buffer is being transmitted
+ * by queued SPI transactions, the next lines are converted into the other
+ * one, so the bus runs at full speed. Render callback returns as soon as
+ * the last lines are queued, framebuffer is not accessed by DMA.
+ *
+ * SPI bus must be initialized by caller with `max_transfer_sz` not less than
+ * ::spi_display_buffer_size().
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __SPI_DISPLAY_H__
+#define __SPI_DISPLAY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <esp_err.h>
+#include <framebuffer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SPI_DISPLAY_LINES
+#define SPI_DISPLAY_LINES 16 ///< Default number of lines in each of two line buffers
+#endif
+
+#define SPI_DISPLAY_CMD_TRANS 5 ///< Number of transactions of window setup
+
+/**
+ * Display controller
+ */
+typedef enum {
+    SPI_DISPLAY_ST7789 = 0, ///< ST7789, RGB565
+    SPI_DISPLAY_ILI9341,    ///< ILI9341, RGB565
+    SPI_DISPLAY_SSD1306,    ///< SSD1306, monochrome, 4-wire SPI
+} spi_display_type_t;
+
+/**
+ * Display rotation
+ */
+typedef enum {
+    SPI_DISPLAY_ROTATION_0 = 0, ///< Native orientation
+    SPI_DISPLAY_ROTATION_90,    ///< Rotated by 90 degrees
+    SPI_DISPLAY_ROTATION_180,   ///< Rotated by 180 degrees
+    SPI_DISPLAY_ROTATION_270,   ///< Rotated by 270 degrees
+} spi_display_rotation_t;
+
+/**
+ * Display descriptor
+ */
+typedef struct
+{
+    spi_display_type_t type;       ///< Controller
+    spi_device_interface_config_t spi_cfg; ///< SPI device configuration
+    spi_device_handle_t spi_dev;   ///< SPI device handle
+    gpio_num_t dc_pin;             ///< Data/command GPIO
+    gpio_num_t rst_pin;            ///< Reset GPIO, -1 if not connected
+    uint16_t width;                ///< Width in current rotation, pixels
+    uint16_t height;               ///< Height in current rotation, pixels.
+                                   ///< Multiple of 8 for SSD1306
+    uint16_t x_offset;             ///< Column of the first visible pixel in controller memory
+    uint16_t y_offset;             ///< Row of the first visible pixel in controller memory
+    spi_display_rotation_t rotation; ///< Rotation, RGB565 controllers and 0/180 for SSD1306
+    bool bgr;                      ///< Panel has BGR subpixel order, RGB565 controllers
+    bool invert;                   ///< Invert colors. Most ST7789 panels need it
+    bool dither;                   ///< SSD1306: ordered dithering instead of threshold
+    uint8_t threshold;             ///< SSD1306: luma of lit pixel when not dithering, 0 for 128
+    size_t lines;                  ///< Lines in line buffer, 0 for ::SPI_DISPLAY_LINES
+    uint8_t *buf[2];               ///< Internal: DMA-capable line buffers
+    spi_transaction_t cmd_trans[SPI_DISPLAY_CMD_TRANS]; ///< Internal: window setup transactions
+    spi_transaction_t data_trans[2]; ///< Internal: transactions of line buffers
+    uint8_t cur;                   ///< Internal: line buffer to fill next
+    uint8_t busy;                  ///< Internal: bit mask of line buffers being transmitted
+    uint8_t in_flight;             ///< Internal: number of queued transactions
+} spi_display_t;
+
+/**
+ * @brief Initialize device descriptor and add device to SPI bus
+ *
+ * Controller type, dimensions and options must be set in descriptor
+ * before calling ::spi_display_init().
+ *
+ * @param dev           Device descriptor
+ * @param host          SPI host, bus must be initialized
+ * @param clock_hz      SPI clock, Hz
+ * @param cs_pin        CS GPIO
+ * @param dc_pin        Data/command GPIO
+ * @param rst_pin       Reset GPIO, -1 if not connected
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_init_desc(spi_display_t *dev, spi_host_device_t host, uint32_t clock_hz,
+        gpio_num_t cs_pin, gpio_num_t dc_pin, gpio_num_t rst_pin);
+
+/**
+ * @brief Free device descriptor
+ *
+ * Waits for queued transactions, frees line buffers and removes
+ * device from SPI bus.
+ *
+ * @param dev           Device descriptor
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_free_desc(spi_display_t *dev);
+
+/**
+ * @brief Size of each line buffer, bytes
+ *
+ * @param dev           Device descriptor
+ * @return              Buffer size
+ */
+size_t spi_display_buffer_size(const spi_display_t *dev);
+
+/**
+ * @brief Allocate line buffers, reset and initialize controller
+ *
+ * Display memory is not cleared, render full frame after init.
+ *
+ * @param dev           Device descriptor
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_init(spi_display_t *dev);
+
+/**
+ * @brief Turn display on or off
+ *
+ * @param dev           Device descriptor
+ * @param on            true to turn on
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_set_on(spi_display_t *dev, bool on);
+
+/**
+ * @brief Send rectangle of framebuffer to display
+ *
+ * Framebuffer must have the size of display. Gamma of framebuffer is
+ * applied, map is ignored. SSD1306 rectangle is extended to whole 8-row
+ * pages. Function returns when the last lines are queued.
+ *
+ * @param dev           Device descriptor
+ * @param fb            Framebuffer
+ * @param rect          Rectangle, inclusive coordinates
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_draw(spi_display_t *dev, framebuffer_t *fb, const fb_rect_t *rect);
+
+/**
+ * @brief Wait until all queued transactions are complete
+ *
+ * @param dev           Device descriptor
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_wait(spi_display_t *dev);
+
+/**
+ * @brief Framebuffer renderer callback
+ *
+ * Sends changed region of framebuffer, or the whole frame when framebuffer
+ * is not dirty (`render_always` mode). Pass it to ::fb_init() and the display
+ * descriptor as context of ::fb_render().
+ *
+ * @param fb            Framebuffer
+ * @param arg           Device descriptor, ::spi_display_t
+ * @return              `ESP_OK` on success
+ */
+esp_err_t spi_display_render(framebuffer_t *fb, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __SPI_DISPLAY_H__ */
@@ -92,6 +92,9 @@ esp_err_t tca9548_free_desc(i2c_dev_t *dev);
 /**
  * @brief Switch channels
  *
+ * Devices behind the multiplexer can also be accessed without explicit
+ * switching, see `mux_addr` and `mux_channels` fields of ::i2c_dev_t.
+ *
  * @param dev Device descriptor
  * @param channels Channel flags, combination of TCA9548_CHANNELn
  * @return `ESP_OK` on success
@@ -36,8 +36,12 @@
  */
 
 #include <esp_idf_lib_helpers.h>
+#include <esp_attr.h>
+#include <esp_log.h>
 #include "tca95x5.h"
 
+static const char *TAG = "tca95x5";
+
 #define I2C_FREQ_HZ 400000
 
 #define REG_IN0   0x00
@@ -109,6 +113,11 @@ esp_err_t tca95x5_port_read(i2c_dev_t *dev, uint16_t *val)
     return read_reg_16(dev, REG_IN0, val);
 }
 
+esp_err_t tca95x5_port_read_output(i2c_dev_t *dev, uint16_t *val)
+{
+    return read_reg_16(dev, REG_OUT0, val);
+}
+
 esp_err_t tca95x5_port_write(i2c_dev_t *dev, uint16_t val)
 {
     return write_reg_16(dev, REG_OUT0, val);
@@ -125,14 +134,159 @@ esp_err_t tca95x5_get_level(i2c_dev_t *dev, uint8_t pin, uint32_t *val)
 
 esp_err_t tca95x5_set_level(i2c_dev_t *dev, uint8_t pin, uint32_t val)
 {
+    CHECK_ARG(pin < 16);
+
+    return tca95x5_port_write_masked(dev, BV(pin), val ? BV(pin) : 0);
+}
+
+esp_err_t tca95x5_port_write_masked(i2c_dev_t *dev, uint16_t mask, uint16_t val)
+{
+    CHECK_ARG(dev);
+
     uint16_t v;
 
     I2C_DEV_TAKE_MUTEX(dev);
     I2C_DEV_CHECK(dev, i2c_dev_read_reg(dev, REG_OUT0, &v, 2));
-    v = (v & ~BV(pin)) | (val ? BV(pin) : 0);
+    v = (v & ~mask) | (val & mask);
     I2C_DEV_CHECK(dev, i2c_dev_write_reg(dev, REG_OUT0, &v, 2));
     I2C_DEV_GIVE_MUTEX(dev);
 
     return ESP_OK;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR intr_isr(void *arg)
+#else
+static void intr_isr(void *arg)
+#endif
+{
+    tca95x5_intr_service_t *svc = (tca95x5_intr_service_t *)arg;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(svc->task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static esp_err_t intr_process(tca95x5_intr_service_t *svc)
+{
+    // both input registers in one burst, reading clears interrupt
+    uint16_t port;
+    CHECK(read_reg_16(svc->dev, REG_IN0, &port));
+
+    uint16_t changed = svc->state ^ port;
+    svc->state = port;
+
+    for (uint8_t pin = 0; changed; pin++, changed >>= 1)
+        if ((changed & 1) && svc->callbacks[pin])
+            svc->callbacks[pin](svc, pin, (port >> pin) & 1, svc->args[pin]);
+
+    return ESP_OK;
+}
+
+static void intr_task(void *arg)
+{
+    tca95x5_intr_service_t *svc = (tca95x5_intr_service_t *)arg;
+    bool active = false;
+
+    while (svc->running)
+    {
+        // INT is asserted again if inputs changed after the read,
+        // no new edge comes in that case
+        ulTaskNotifyTake(pdTRUE, active ? 1 : portMAX_DELAY);
+        if (!svc->running)
+            break;
+
+        esp_err_t res = intr_process(svc);
+        if (res != ESP_OK)
+            ESP_LOGE(TAG, "Error reading input port: %d (%s)", res, esp_err_to_name(res));
+
+        active = gpio_get_level(svc->gpio) == 0;
+    }
+
+    svc->task = NULL;
+    vTaskDelete(NULL);
+}
+
+esp_err_t tca95x5_intr_service_start(tca95x5_intr_service_t *svc, i2c_dev_t *dev, gpio_num_t gpio,
+        UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(svc && dev && !svc->task);
+
+    svc->dev = dev;
+    svc->gpio = gpio;
+
+    CHECK(gpio_set_direction(gpio, GPIO_MODE_INPUT));
+    CHECK(gpio_set_pull_mode(gpio, GPIO_PULLUP_ONLY));
+
+    // initial state, clears pending interrupt
+    uint16_t port;
+    CHECK(read_reg_16(dev, REG_IN0, &port));
+    svc->state = port;
+
+    svc->running = true;
+    if (xTaskCreate(intr_task, TAG, stack_size, svc, priority, &svc->task) != pdPASS)
+    {
+        svc->running = false;
+        svc->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_set_intr_type(gpio, GPIO_INTR_NEGEDGE)) != ESP_OK)
+        goto fail;
+    if ((res = gpio_isr_handler_add(gpio, intr_isr, svc)) != ESP_OK)
+        goto fail;
+
+    // catch changes made before ISR was installed
+    xTaskNotifyGive(svc->task);
+
+    return ESP_OK;
+
+fail:
+    tca95x5_intr_service_stop(svc);
+    return res;
+}
+
+esp_err_t tca95x5_intr_service_stop(tca95x5_intr_service_t *svc)
+{
+    CHECK_ARG(svc);
+
+    gpio_isr_handler_remove(svc->gpio);
+    gpio_set_intr_type(svc->gpio, GPIO_INTR_DISABLE);
+
+    svc->running = false;
+    while (svc->task)
+    {
+        xTaskNotifyGive(svc->task);
+        vTaskDelay(1);
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t tca95x5_intr_service_set_callback(tca95x5_intr_service_t *svc, uint8_t pin,
+        tca95x5_pin_cb_t callback, void *arg)
+{
+    CHECK_ARG(svc && pin < 16);
+
+    svc->callbacks[pin] = NULL;
+    svc->args[pin] = arg;
+    svc->callbacks[pin] = callback;
+
+    return ESP_OK;
+}
+
+esp_err_t tca95x5_intr_service_get_state(tca95x5_intr_service_t *svc, uint16_t *val)
+{
+    CHECK_ARG(svc && val);
+
+    *val = svc->state;
+
+    return ESP_OK;
+}
+
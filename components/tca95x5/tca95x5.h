@@ -40,8 +40,12 @@
 #define __TCA95X5_H__
 
 #include <stddef.h>
+#include <stdbool.h>
 #include <i2cdev.h>
+#include <driver/gpio.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -101,6 +105,17 @@ esp_err_t tca95x5_port_set_mode(i2c_dev_t *dev, uint16_t mode);
  */
 esp_err_t tca95x5_port_read(i2c_dev_t *dev, uint16_t *val);
 
+/**
+ * @brief Read output port register
+ *
+ * Returns output latch, not pin levels
+ *
+ * @param dev Pointer to I2C device descriptor
+ * @param[out] val Output latch, 0 bit for P0.0 .. 15 bit for P1.7
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_port_read_output(i2c_dev_t *dev, uint16_t *val);
+
 /**
  * @brief Write value to GPIO port
  *
@@ -132,6 +147,100 @@ esp_err_t tca95x5_get_level(i2c_dev_t *dev, uint8_t pin, uint32_t *val);
  */
 esp_err_t tca95x5_set_level(i2c_dev_t *dev, uint8_t pin, uint32_t val);
 
+/**
+ * @brief Change several output pins in one transaction
+ *
+ * Output latch is read and written in 16-bit bursts, bus is locked
+ * during the whole read-modify-write. For repeated changes without
+ * reading the latch use gpio_expander with ::gpio_expander_tca95x5.
+ *
+ * @param dev Pointer to device descriptor
+ * @param mask Pins to change, 0 bit for P0.0 .. 15 bit for P1.7
+ * @param val New levels of pins in mask
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_port_write_masked(i2c_dev_t *dev, uint16_t mask, uint16_t val);
+
+typedef struct tca95x5_intr_service tca95x5_intr_service_t;
+
+/**
+ * Pin change callback prototype
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number, 0 for P0.0 .. 15 for P1.7
+ * @param level Current pin level
+ * @param arg User argument
+ */
+typedef void (*tca95x5_pin_cb_t)(tca95x5_intr_service_t *svc, uint8_t pin, bool level, void *arg);
+
+/**
+ * Interrupt service descriptor
+ */
+struct tca95x5_intr_service
+{
+    i2c_dev_t *dev;                  //!< Device descriptor
+    gpio_num_t gpio;                 //!< GPIO connected to INT
+    volatile uint16_t state;         //!< Cached input port state
+    tca95x5_pin_cb_t callbacks[16];  //!< Pin callbacks
+    void *args[16];                  //!< Callback arguments
+    TaskHandle_t task;               //!< Service task, internal
+    volatile bool running;           //!< Service state, internal
+};
+
+/**
+ * @brief Start interrupt service
+ *
+ * Installs GPIO interrupt handler on the INT line (open drain, active
+ * low, external or internal pull-up). On interrupt the service task reads
+ * both input port registers in one 2-byte burst, which clears the
+ * interrupt, updates cached port state and calls callbacks of changed
+ * pins. While INT stays low the task polls the device every tick, so
+ * changes made during the read are not lost.
+ *
+ * TCA95x5 raises INT on any change of an input pin, there is no
+ * per-pin interrupt mask.
+ *
+ * @param svc Interrupt service descriptor, must be zero-initialized
+ * @param dev Pointer to device descriptor
+ * @param gpio GPIO connected to INT
+ * @param priority Service task priority
+ * @param stack_size Service task stack size, callbacks are called from it
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_intr_service_start(tca95x5_intr_service_t *svc, i2c_dev_t *dev, gpio_num_t gpio,
+        UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop interrupt service
+ *
+ * @param svc Interrupt service descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_intr_service_stop(tca95x5_intr_service_t *svc);
+
+/**
+ * @brief Set pin change callback
+ *
+ * @param svc Interrupt service descriptor
+ * @param pin Pin number, 0 for P0.0 .. 15 for P1.7
+ * @param callback Callback, NULL to remove
+ * @param arg User argument passed to callback
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_intr_service_set_callback(tca95x5_intr_service_t *svc, uint8_t pin,
+        tca95x5_pin_cb_t callback, void *arg);
+
+/**
+ * @brief Get cached input port state
+ *
+ * No bus transaction is made, state is updated by the service task.
+ *
+ * @param svc Interrupt service descriptor
+ * @param[out] val 16-bit input port value, 0 bit for P0.0 .. 15 bit for P1.7
+ * @return `ESP_OK` on success
+ */
+esp_err_t tca95x5_intr_service_get_state(tca95x5_intr_service_t *svc, uint16_t *val);
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,8 +31,10 @@
  * MIT Licensed as described in the file LICENSE
  */
 
+#include <string.h>
 #include <esp_log.h>
 #include <esp_idf_lib_helpers.h>
+#include <freertos/task.h>
 #include "tda74xx.h"
 
 #define I2C_FREQ_HZ 100000 // 100kHz
@@ -48,6 +50,8 @@ static const char *TAG = "tda74xx";
 #define REG_ATTEN_R        0x06
 #define REG_ATTEN_L        0x07
 
+#define REG_AUTO_INC       0x10
+
 #define MUTE_VALUE 0x38
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
@@ -75,6 +79,29 @@ static esp_err_t read_reg(i2c_dev_t *dev, uint8_t reg, uint8_t *val)
     return ESP_OK;
 }
 
+static inline uint8_t volume_value(int8_t volume_db)
+{
+    return volume_db == TDA74XX_MIN_VOLUME ? MUTE_VALUE : -volume_db;
+}
+
+static inline uint8_t eq_reg(tda74xx_band_t band)
+{
+    switch(band)
+    {
+        case TDA74XX_BAND_BASS:
+            return REG_BASS_GAIN;
+        case TDA74XX_BAND_MIDDLE:
+            return REG_MID_GAIN;
+        default:
+            return REG_TREBLE_GAIN;
+    }
+}
+
+static inline uint8_t atten_reg(tda74xx_channel_t channel)
+{
+    return channel == TDA74XX_CHANNEL_LEFT ? REG_ATTEN_L : REG_ATTEN_R;
+}
+
 esp_err_t tda74xx_init_desc(i2c_dev_t *dev, i2c_port_t port, gpio_num_t sda_gpio, gpio_num_t scl_gpio)
 {
     CHECK_ARG(dev);
@@ -132,7 +159,7 @@ esp_err_t tda74xx_set_volume(i2c_dev_t *dev, int8_t volume_db)
 {
     CHECK_ARG(dev && volume_db <= TDA74XX_MAX_VOLUME && volume_db >= TDA74XX_MIN_VOLUME);
 
-    return write_reg(dev, REG_VOLUME, volume_db == TDA74XX_MIN_VOLUME ? MUTE_VALUE : -volume_db);
+    return write_reg(dev, REG_VOLUME, volume_value(volume_db));
 }
 
 esp_err_t tda74xx_get_volume(i2c_dev_t *dev, int8_t *volume_db)
@@ -148,40 +175,14 @@ esp_err_t tda74xx_set_equalizer_gain(i2c_dev_t *dev, tda74xx_band_t band, int8_t
 {
     CHECK_ARG(dev && gain_db >= TDA74XX_MIN_EQ_GAIN && gain_db <= TDA74XX_MAX_EQ_GAIN);
 
-    uint8_t reg;
-    switch(band)
-    {
-        case TDA74XX_BAND_BASS:
-            reg = REG_BASS_GAIN;
-            break;
-        case TDA74XX_BAND_MIDDLE:
-            reg = REG_MID_GAIN;
-            break;
-        default:
-            reg = REG_TREBLE_GAIN;
-    }
-
-    return write_reg(dev, reg, (gain_db + 14) / 2);
+    return write_reg(dev, eq_reg(band), (gain_db + 14) / 2);
 }
 
 esp_err_t tda74xx_get_equalizer_gain(i2c_dev_t *dev, tda74xx_band_t band, int8_t *gain_db)
 {
     CHECK_ARG(dev && gain_db);
 
-    uint8_t reg;
-    switch(band)
-    {
-        case TDA74XX_BAND_BASS:
-            reg = REG_BASS_GAIN;
-            break;
-        case TDA74XX_BAND_MIDDLE:
-            reg = REG_MID_GAIN;
-            break;
-        default:
-            reg = REG_TREBLE_GAIN;
-    }
-
-    CHECK(read_reg(dev, reg, (uint8_t *)gain_db));
+    CHECK(read_reg(dev, eq_reg(band), (uint8_t *)gain_db));
     *gain_db = *gain_db * 2 - 14;
     return ESP_OK;
 }
@@ -190,12 +191,114 @@ esp_err_t tda74xx_set_speaker_attenuation(i2c_dev_t *dev, tda74xx_channel_t chan
 {
     CHECK_ARG(dev && atten_db <= TDA74XX_MAX_ATTEN);
 
-    return write_reg(dev, channel == TDA74XX_CHANNEL_LEFT ? REG_ATTEN_L : REG_ATTEN_R, atten_db);
+    return write_reg(dev, atten_reg(channel), atten_db);
 }
 
 esp_err_t tda74xx_get_speaker_attenuation(i2c_dev_t *dev, tda74xx_channel_t channel, uint8_t *atten_db)
 {
     CHECK_ARG(dev && atten_db);
 
-    return read_reg(dev, channel == TDA74XX_CHANNEL_LEFT ? REG_ATTEN_L : REG_ATTEN_R, atten_db);
+    return read_reg(dev, atten_reg(channel), atten_db);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Cached access
+
+static esp_err_t cache_set(tda74xx_cache_t *cache, uint8_t reg, uint8_t val)
+{
+    uint8_t bit = 1 << reg;
+    if ((cache->valid & bit) && cache->regs[reg] == val)
+        return ESP_OK;
+
+    cache->regs[reg] = val;
+    cache->valid |= bit;
+    cache->dirty |= bit;
+
+    return tda74xx_cache_flush(cache, false);
+}
+
+esp_err_t tda74xx_cache_init(tda74xx_cache_t *cache, i2c_dev_t *dev, uint32_t interval_ms)
+{
+    CHECK_ARG(cache && dev);
+
+    memset(cache, 0, sizeof(tda74xx_cache_t));
+    cache->dev = dev;
+    cache->interval = pdMS_TO_TICKS(interval_ms);
+
+    return ESP_OK;
+}
+
+esp_err_t tda74xx_cache_flush(tda74xx_cache_t *cache, bool force)
+{
+    CHECK_ARG(cache && cache->dev);
+
+    if (!cache->dirty)
+        return ESP_OK;
+
+    TickType_t now = xTaskGetTickCount();
+    if (!force && cache->flushed && now - cache->last_flush < cache->interval)
+        return ESP_OK;
+
+    // auto-increment writes of changed registers, unchanged known
+    // registers between them are rewritten to join transactions
+    I2C_DEV_TAKE_MUTEX(cache->dev);
+    uint8_t reg = 0;
+    while (reg < TDA74XX_REG_COUNT)
+    {
+        if (!(cache->dirty & (1 << reg)))
+        {
+            reg++;
+            continue;
+        }
+        uint8_t first = reg;
+        uint8_t last = reg;
+        for (reg++; reg < TDA74XX_REG_COUNT && (cache->valid & (1 << reg)); reg++)
+            if (cache->dirty & (1 << reg))
+                last = reg;
+        I2C_DEV_CHECK(cache->dev, i2c_dev_write_reg(cache->dev, first | REG_AUTO_INC,
+                cache->regs + first, last - first + 1));
+        ESP_LOGD(TAG, "Flushed registers %02x..%02x", first, last);
+    }
+    I2C_DEV_GIVE_MUTEX(cache->dev);
+
+    cache->dirty = 0;
+    cache->last_flush = now;
+    cache->flushed = true;
+
+    return ESP_OK;
+}
+
+esp_err_t tda74xx_cache_set_input(tda74xx_cache_t *cache, uint8_t input)
+{
+    CHECK_ARG(cache && input <= TDA74XX_MAX_INPUT);
+
+    return cache_set(cache, REG_INPUT_SELECTOR, input);
+}
+
+esp_err_t tda74xx_cache_set_input_gain(tda74xx_cache_t *cache, uint8_t gain_db)
+{
+    CHECK_ARG(cache && gain_db <= TDA74XX_MAX_INPUT_GAIN);
+
+    return cache_set(cache, REG_INPUT_GAIN, gain_db / 2);
+}
+
+esp_err_t tda74xx_cache_set_volume(tda74xx_cache_t *cache, int8_t volume_db)
+{
+    CHECK_ARG(cache && volume_db <= TDA74XX_MAX_VOLUME && volume_db >= TDA74XX_MIN_VOLUME);
+
+    return cache_set(cache, REG_VOLUME, volume_value(volume_db));
+}
+
+esp_err_t tda74xx_cache_set_equalizer_gain(tda74xx_cache_t *cache, tda74xx_band_t band, int8_t gain_db)
+{
+    CHECK_ARG(cache && gain_db >= TDA74XX_MIN_EQ_GAIN && gain_db <= TDA74XX_MAX_EQ_GAIN);
+
+    return cache_set(cache, eq_reg(band), (gain_db + 14) / 2);
+}
+
+esp_err_t tda74xx_cache_set_speaker_attenuation(tda74xx_cache_t *cache, tda74xx_channel_t channel, uint8_t atten_db)
+{
+    CHECK_ARG(cache && atten_db <= TDA74XX_MAX_ATTEN);
+
+    return cache_set(cache, atten_reg(channel), atten_db);
 }
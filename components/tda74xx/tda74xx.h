@@ -38,6 +38,7 @@
 #include <stdbool.h>
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <freertos/FreeRTOS.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -57,6 +58,8 @@ extern "C" {
 
 #define TDA74XX_MAX_ATTEN      56   //!< Maximum speaker attenuation level, dB
 
+#define TDA74XX_REG_COUNT      8    //!< Number of device registers
+
 /**
  * Audio channel
  */
@@ -187,6 +190,96 @@ esp_err_t tda74xx_set_speaker_attenuation(i2c_dev_t *dev, tda74xx_channel_t chan
  */
 esp_err_t tda74xx_get_speaker_attenuation(i2c_dev_t *dev, tda74xx_channel_t channel, uint8_t *atten_db);
 
+/**
+ * Write-through register cache
+ *
+ * Cached setters skip writes of unchanged values and coalesce rapid
+ * updates: changed registers are written not more often than once per
+ * `interval`, in one auto-increment transaction. Not thread-safe.
+ */
+typedef struct
+{
+    i2c_dev_t *dev;                      //!< Device descriptor
+    uint8_t regs[TDA74XX_REG_COUNT];     //!< Register values
+    uint8_t valid;                       //!< Bitmask of known registers
+    uint8_t dirty;                       //!< Bitmask of registers not written yet
+    TickType_t interval;                 //!< Minimal interval between writes
+    TickType_t last_flush;               //!< Time of the last write
+    bool flushed;                        //!< Cache was written at least once
+} tda74xx_cache_t;
+
+/**
+ * @brief Initialize register cache
+ *
+ * All registers are unknown after initialization, so the first
+ * set of every register is always written.
+ *
+ * @param cache Cache descriptor
+ * @param dev Device descriptor
+ * @param interval_ms Minimal interval between writes, 0 to write at once
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_init(tda74xx_cache_t *cache, i2c_dev_t *dev, uint32_t interval_ms);
+
+/**
+ * @brief Write pending changes to device
+ *
+ * Should be called periodically (or with `force` after the last change)
+ * so postponed values reach the device.
+ *
+ * @param cache Cache descriptor
+ * @param force Write even if interval since the last write is not elapsed
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_flush(tda74xx_cache_t *cache, bool force);
+
+/**
+ * @brief Switch input, cached
+ *
+ * @param cache Cache descriptor
+ * @param input Input #, 0..3
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_set_input(tda74xx_cache_t *cache, uint8_t input);
+
+/**
+ * @brief Set input gain, cached
+ *
+ * @param cache Cache descriptor
+ * @param gain_db Gain, 0..30 dB
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_set_input_gain(tda74xx_cache_t *cache, uint8_t gain_db);
+
+/**
+ * @brief Set master volume, cached
+ *
+ * @param cache Cache descriptor
+ * @param volume_db Volume, -48..0 dB
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_set_volume(tda74xx_cache_t *cache, int8_t volume_db);
+
+/**
+ * @brief Set equalizer gain, cached
+ *
+ * @param cache Cache descriptor
+ * @param band Band
+ * @param gain_db Gain, -14..14 dB in 2 dB step
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_set_equalizer_gain(tda74xx_cache_t *cache, tda74xx_band_t band, int8_t gain_db);
+
+/**
+ * @brief Attenuate speaker, cached
+ *
+ * @param cache Cache descriptor
+ * @param channel Audio channel
+ * @param atten_db Attenuation, 0..56 dB
+ * @return `ESP_OK` on success
+ */
+esp_err_t tda74xx_cache_set_speaker_attenuation(tda74xx_cache_t *cache, tda74xx_channel_t channel, uint8_t atten_db);
+
 #ifdef __cplusplus
 }
 #endif
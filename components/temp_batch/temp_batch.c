@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file temp_batch.c
+ *
+ * Batch reading of I2C temperature sensors of mixed types
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_log.h>
+#include <esp_timer.h>
+#include "temp_batch.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// Temperature registers and TSYS01 commands, see drivers
+#define LM75_REG_TEMP     0x00
+#define MCP9808_REG_T_A   0x05
+#define MAX31725_REG_TEMP 0x00
+#define TSYS01_CMD_START  0x48
+#define TSYS01_CMD_READ   0x00
+
+#define TSYS01_CONV_US 10000
+#define MAX31725_FMT_SHIFT_MDEG 64000
+
+#define NO_TRANS ((size_t)-1)
+
+static const char *TAG = "temp_batch";
+
+static const uint8_t lm75_reg = LM75_REG_TEMP;
+static const uint8_t mcp9808_reg = MCP9808_REG_T_A;
+static const uint8_t max31725_reg = MAX31725_REG_TEMP;
+static const uint8_t tsys01_read_cmd = TSYS01_CMD_READ;
+static uint8_t tsys01_start_cmd = TSYS01_CMD_START;
+
+static inline const i2c_dev_t *sensor_i2c_dev(const temp_batch_sensor_t *s)
+{
+    return s->type == TEMP_BATCH_TSYS01 ? &((tsys01_t *)s->dev)->i2c_dev : (const i2c_dev_t *)s->dev;
+}
+
+static void add_read(i2c_dev_transaction_t *t, const i2c_dev_t *dev, const uint8_t *reg, uint8_t *data, size_t size)
+{
+    t->dev = dev;
+    t->op = I2C_DEV_OP_READ;
+    t->reg = reg;
+    t->reg_size = 1;
+    t->data = data;
+    t->size = size;
+}
+
+// execute transactions, one batch per run of the same port
+static void run(i2c_dev_transaction_t *trans, size_t count)
+{
+    size_t i = 0;
+    while (i < count)
+    {
+        i2c_port_t port = trans[i].dev->port;
+        size_t j = i + 1;
+        while (j < count && trans[j].dev->port == port)
+            j++;
+        esp_err_t res = i2c_dev_transactions(port, trans + i, j - i);
+        if (res != ESP_OK)
+            ESP_LOGD(TAG, "Batch on port %d failed: %d (%s)", port, res, esp_err_to_name(res));
+        i = j;
+    }
+}
+
+static esp_err_t convert(const temp_batch_sensor_t *s, const uint8_t *raw, int32_t *mdeg)
+{
+    int16_t v = (int16_t)(((uint16_t)raw[0] << 8) | raw[1]);
+    float t;
+
+    switch (s->type)
+    {
+        case TEMP_BATCH_LM75:
+            // 11-bit two's complement, 0.125 deg.C
+            *mdeg = (int32_t)(v >> 5) * 125;
+            break;
+        case TEMP_BATCH_MCP9808:
+            // 13-bit two's complement with alert flags above, 0.0625 deg.C
+            v = (int16_t)((uint16_t)v << 3) >> 3;
+            *mdeg = (int32_t)v * 125 / 2;
+            break;
+        case TEMP_BATCH_MAX31725:
+            // 1/256 deg.C
+            *mdeg = (int32_t)v * 125 / 32 + (s->fmt == MAX31725_FMT_EXTENDED ? MAX31725_FMT_SHIFT_MDEG : 0);
+            break;
+        case TEMP_BATCH_TSYS01:
+            tsys01_raw_to_temp((tsys01_t *)s->dev,
+                    ((uint32_t)raw[0] << 16) | ((uint32_t)raw[1] << 8) | raw[2], &t);
+            *mdeg = (int32_t)(t * 1000 + (t < 0 ? -0.5f : 0.5f));
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t temp_batch_init(temp_batch_t *batch, const temp_batch_sensor_t *sensors, size_t count)
+{
+    CHECK_ARG(batch && sensors && count);
+
+    memset(batch, 0, sizeof(temp_batch_t));
+
+    size_t tsys01_count = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        CHECK_ARG(sensors[i].dev && sensors[i].type <= TEMP_BATCH_TSYS01);
+        if (sensors[i].type == TEMP_BATCH_TSYS01)
+            tsys01_count++;
+    }
+
+    batch->trans = calloc(count + tsys01_count, sizeof(i2c_dev_transaction_t));
+    batch->map = malloc(count * 2 * sizeof(size_t));
+    batch->raw = calloc(count, 3);
+    if (!batch->trans || !batch->map || !batch->raw)
+    {
+        temp_batch_free(batch);
+        return ESP_ERR_NO_MEM;
+    }
+    batch->sensors = sensors;
+    batch->count = count;
+    batch->trans_count = count;
+    batch->tsys01_count = tsys01_count;
+
+    // First phase: TSYS01 conversion starts, then other sensors, grouped by port.
+    // Second phase: TSYS01 results.
+    size_t n = 0, n2 = count;
+    for (int port = 0; port < I2C_NUM_MAX; port++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const temp_batch_sensor_t *s = sensors + i;
+            const i2c_dev_t *dev = sensor_i2c_dev(s);
+            if (dev->port != port || s->type != TEMP_BATCH_TSYS01)
+                continue;
+
+            i2c_dev_transaction_t *t = batch->trans + n;
+            t->dev = dev;
+            t->op = I2C_DEV_OP_WRITE;
+            t->data = &tsys01_start_cmd;
+            t->size = 1;
+            batch->map[i * 2] = n++;
+
+            add_read(batch->trans + n2, dev, &tsys01_read_cmd, batch->raw + i * 3, 3);
+            batch->map[i * 2 + 1] = n2++;
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            const temp_batch_sensor_t *s = sensors + i;
+            const i2c_dev_t *dev = sensor_i2c_dev(s);
+            if (dev->port != port || s->type == TEMP_BATCH_TSYS01)
+                continue;
+
+            const uint8_t *reg = s->type == TEMP_BATCH_LM75
+                ? &lm75_reg
+                : s->type == TEMP_BATCH_MCP9808 ? &mcp9808_reg : &max31725_reg;
+            add_read(batch->trans + n, dev, reg, batch->raw + i * 3, 2);
+            batch->map[i * 2] = n++;
+            batch->map[i * 2 + 1] = NO_TRANS;
+        }
+    }
+
+    if (n != count)
+    {
+        ESP_LOGE(TAG, "Invalid I2C port of sensor");
+        temp_batch_free(batch);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t temp_batch_free(temp_batch_t *batch)
+{
+    CHECK_ARG(batch);
+
+    free(batch->trans);
+    free(batch->map);
+    free(batch->raw);
+    memset(batch, 0, sizeof(temp_batch_t));
+
+    return ESP_OK;
+}
+
+esp_err_t temp_batch_read(temp_batch_t *batch, int32_t *mdeg, esp_err_t *results)
+{
+    CHECK_ARG(batch && batch->trans && mdeg);
+
+    int64_t start = esp_timer_get_time();
+    run(batch->trans, batch->trans_count);
+
+    if (batch->tsys01_count)
+    {
+        // other sensors were read while TSYS01 were converting
+        int64_t left = TSYS01_CONV_US - (esp_timer_get_time() - start);
+        if (left > 0)
+            vTaskDelay((left + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000) + 1);
+        run(batch->trans + batch->trans_count, batch->tsys01_count);
+    }
+
+    esp_err_t res = ESP_OK;
+    for (size_t i = 0; i < batch->count; i++)
+    {
+        esp_err_t r = batch->trans[batch->map[i * 2]].result;
+        if (r == ESP_OK && batch->map[i * 2 + 1] != NO_TRANS)
+            r = batch->trans[batch->map[i * 2 + 1]].result;
+        if (r == ESP_OK)
+            r = convert(batch->sensors + i, batch->raw + i * 3, mdeg + i);
+
+        if (results)
+            results[i] = r;
+        if (r != ESP_OK && res == ESP_OK)
+            res = r;
+    }
+
+    return res;
+}
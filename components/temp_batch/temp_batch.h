@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file temp_batch.h
+ * @defgroup temp_batch temp_batch
+ * @{
+ *
+ * Batch reading of I2C temperature sensors of mixed types
+ *
+ * Supported sensors: LM75, MCP9808, MAX31725, TSYS01. All sensors are read
+ * in one scheduled pass with ::i2c_dev_transactions(), one batch per I2C
+ * port. Sensors behind I2C multiplexers are supported by i2cdev. TSYS01
+ * conversions are started at the beginning of the pass and read after
+ * all other sensors.
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __TEMP_BATCH_H__
+#define __TEMP_BATCH_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <i2cdev.h>
+#include <max31725.h>
+#include <tsys01.h>
+#include <esp_err.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sensor type
+ */
+typedef enum {
+    TEMP_BATCH_LM75 = 0, //!< LM75, `dev` is `i2c_dev_t *`
+    TEMP_BATCH_MCP9808,  //!< MCP9808, `dev` is `i2c_dev_t *`
+    TEMP_BATCH_MAX31725, //!< MAX31725, `dev` is `i2c_dev_t *`
+    TEMP_BATCH_TSYS01,   //!< TSYS01, `dev` is `tsys01_t *`, initialized with tsys01_init()
+} temp_batch_type_t;
+
+/**
+ * Sensor in batch
+ */
+typedef struct
+{
+    temp_batch_type_t type;     //!< Sensor type
+    void *dev;                  //!< Initialized device descriptor
+    max31725_data_format_t fmt; //!< Data format, MAX31725 only
+} temp_batch_sensor_t;
+
+/**
+ * Batch descriptor
+ */
+typedef struct
+{
+    const temp_batch_sensor_t *sensors; //!< Sensors
+    size_t count;                       //!< Number of sensors
+    i2c_dev_transaction_t *trans;       //!< Transactions, sorted by port
+    size_t *map;                        //!< Transaction indices of each sensor, two per sensor
+    size_t trans_count;                 //!< Number of transactions in the first phase
+    size_t tsys01_count;                //!< Number of TSYS01 sensors (transactions in the second phase)
+    uint8_t *raw;                       //!< Raw data, 3 bytes per sensor
+} temp_batch_t;
+
+/**
+ * @brief Prepare batch
+ *
+ * Allocates and builds transactions for all sensors.
+ *
+ * @param batch Batch descriptor
+ * @param sensors Array of sensors, must be valid until ::temp_batch_free()
+ * @param count Number of sensors
+ * @return `ESP_OK` on success
+ */
+esp_err_t temp_batch_init(temp_batch_t *batch, const temp_batch_sensor_t *sensors, size_t count);
+
+/**
+ * @brief Free batch
+ *
+ * @param batch Batch descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t temp_batch_free(temp_batch_t *batch);
+
+/**
+ * @brief Read temperatures of all sensors
+ *
+ * Takes ~10 ms more if TSYS01 sensors are present (conversion time).
+ * Device mutexes are not taken, so sensors of the batch must not be used
+ * by other tasks concurrently.
+ *
+ * @param batch Batch descriptor
+ * @param[out] mdeg Temperatures, milli-degrees Celsius, `count` elements
+ * @param[out] results Result of each sensor, `count` elements, may be NULL.
+ *             Temperature of a failed sensor is left untouched.
+ * @return `ESP_OK` if all sensors were read, otherwise the first error
+ */
+esp_err_t temp_batch_read(temp_batch_t *batch, int32_t *mdeg, esp_err_t *results);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __TEMP_BATCH_H__ */
@@ -43,6 +43,7 @@
 #include <freertos/task.h>
 #include <esp_log.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "tsl2561.h"
 
 #define I2C_FREQ_HZ 400000 // 400kHz
@@ -131,9 +132,18 @@ static const char *TAG = "tsl2561";
 #define B8C 0x0000 // 0.000 * 2^LUX_SCALE
 #define M8C 0x0000 // 0.000 * 2^LUX_SCALE
 
+// Max channel counts
+#define TSL2561_MAX_COUNT_13MS  5047
+#define TSL2561_MAX_COUNT_101MS 37177
+#define TSL2561_MAX_COUNT_402MS 65535
+
+// Auto-range thresholds, percent of max count
+#define AUTORANGE_HIGH 90
+#define AUTORANGE_LOW  50
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
-#define SLEEP_MS(x) do { vTaskDelay(pdMS_TO_TICKS(x)); } while (0)
+#define SLEEP_MS(x) do { ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(x)); } while (0)
 
 static inline esp_err_t write_register(tsl2561_t *dev, uint8_t reg, uint8_t value)
 {
@@ -293,10 +303,8 @@ esp_err_t tsl2561_set_gain(tsl2561_t *dev, tsl2561_gain_t gain)
     return ESP_OK;
 }
 
-esp_err_t tsl2561_read_lux(tsl2561_t *dev, uint32_t *lux)
+static esp_err_t calculate_lux(tsl2561_t *dev, uint16_t ch0, uint16_t ch1, uint32_t *lux)
 {
-    CHECK_ARG(dev && lux);
-
     uint32_t ch_scale, channel1, channel0;
 
     switch (dev->integration_time)
@@ -318,11 +326,6 @@ esp_err_t tsl2561_read_lux(tsl2561_t *dev, uint32_t *lux)
         // we need to scale by 16
         ch_scale = ch_scale << 4;
 
-    uint16_t ch0 = 0;
-    uint16_t ch1 = 0;
-
-    CHECK(get_channel_data(dev, &ch0, &ch1));
-
     // Scale the channel values
     channel0 = (ch0 * ch_scale) >> CH_SCALE;
     channel1 = (ch1 * ch_scale) >> CH_SCALE;
@@ -442,3 +445,107 @@ esp_err_t tsl2561_read_lux(tsl2561_t *dev, uint32_t *lux)
 
     return ESP_OK;
 }
+
+esp_err_t tsl2561_read_lux(tsl2561_t *dev, uint32_t *lux)
+{
+    CHECK_ARG(dev && lux);
+
+    uint16_t ch0 = 0;
+    uint16_t ch1 = 0;
+
+    CHECK(get_channel_data(dev, &ch0, &ch1));
+
+    return calculate_lux(dev, ch0, ch1, lux);
+}
+
+typedef struct
+{
+    tsl2561_gain_t gain;
+    tsl2561_integration_time_t time;
+    uint32_t sens;  // gain * integration time, 0.1 ms
+} autorange_step_t;
+
+// Ordered by sensitivity
+static const autorange_step_t autorange_steps[] = {
+    { TSL2561_GAIN_1X,  TSL2561_INTEGRATION_13MS,  1 * 137 },
+    { TSL2561_GAIN_1X,  TSL2561_INTEGRATION_101MS, 1 * 1010 },
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATION_13MS,  16 * 137 },
+    { TSL2561_GAIN_1X,  TSL2561_INTEGRATION_402MS, 1 * 4020 },
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATION_101MS, 16 * 1010 },
+    { TSL2561_GAIN_16X, TSL2561_INTEGRATION_402MS, 16 * 4020 },
+};
+
+#define AUTORANGE_STEPS (sizeof(autorange_steps) / sizeof(autorange_steps[0]))
+
+static inline uint32_t max_count(tsl2561_integration_time_t time)
+{
+    switch (time)
+    {
+        case TSL2561_INTEGRATION_13MS:
+            return TSL2561_MAX_COUNT_13MS;
+        case TSL2561_INTEGRATION_101MS:
+            return TSL2561_MAX_COUNT_101MS;
+        default:
+            return TSL2561_MAX_COUNT_402MS;
+    }
+}
+
+static esp_err_t set_step(tsl2561_t *dev, const autorange_step_t *st)
+{
+    if (dev->gain == st->gain && dev->integration_time == st->time)
+        return ESP_OK;
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_CHECK(&dev->i2c_dev, enable(dev));
+    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2561_REG_TIMING, st->time | st->gain));
+    dev->integration_time = st->time;
+    dev->gain = st->gain;
+    I2C_DEV_CHECK(&dev->i2c_dev, disable(dev));
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    ESP_LOGD(TAG, "Auto-range: gain %s, integration time %d",
+            st->gain == TSL2561_GAIN_16X ? "16x" : "1x", st->time);
+
+    return ESP_OK;
+}
+
+esp_err_t tsl2561_read_lux_auto(tsl2561_t *dev, uint32_t *lux)
+{
+    CHECK_ARG(dev && lux);
+
+    uint8_t cur = 0;
+    for (uint8_t i = 0; i < AUTORANGE_STEPS; i++)
+        if (autorange_steps[i].gain == dev->gain && autorange_steps[i].time == dev->integration_time)
+            cur = i;
+
+    uint16_t ch0, ch1;
+    CHECK(get_channel_data(dev, &ch0, &ch1));
+
+    uint32_t max = max_count(dev->integration_time);
+    if ((ch0 >= max || ch1 >= max) && cur)
+    {
+        // saturated, retry once with the least sensitive settings
+        cur = 0;
+        CHECK(set_step(dev, &autorange_steps[0]));
+        CHECK(get_channel_data(dev, &ch0, &ch1));
+        max = max_count(dev->integration_time);
+    }
+
+    CHECK(calculate_lux(dev, ch0, ch1, lux));
+
+    // select settings for the next read
+    uint8_t best = 0;
+    for (int i = AUTORANGE_STEPS - 1; i > 0; i--)
+    {
+        uint64_t pred = (uint64_t)ch0 * autorange_steps[i].sens / autorange_steps[cur].sens;
+        if (pred * 100 < (uint64_t)max_count(autorange_steps[i].time) * AUTORANGE_LOW)
+        {
+            best = i;
+            break;
+        }
+    }
+    if (best > cur || (uint32_t)ch0 * 100 >= max * AUTORANGE_HIGH)
+        CHECK(set_step(dev, &autorange_steps[best]));
+
+    return ESP_OK;
+}
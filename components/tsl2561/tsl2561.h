@@ -146,6 +146,20 @@ esp_err_t tsl2561_set_gain(tsl2561_t *dev, tsl2561_gain_t gain);
  */
 esp_err_t tsl2561_read_lux(tsl2561_t *dev, uint32_t *lux);
 
+/**
+ * @brief Read light intensity with automatic gain and integration time
+ *
+ * Gain and integration time for the next read are selected from this
+ * sample: the most sensitive settings which keep predicted channel 0
+ * count within the range. If sample is saturated, it is repeated once
+ * with the least sensitive settings.
+ *
+ * @param dev Device descriptor
+ * @param[out] lux Light intensity, lux
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsl2561_read_lux_auto(tsl2561_t *dev, uint32_t *lux);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,7 +34,10 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_log.h>
+#include <esp_timer.h>
+#include <esp_attr.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "tsl2591.h"
 
 #define I2C_FREQ_HZ 400000 // 400kHz
@@ -83,12 +86,20 @@ static const char *TAG = "tsl2591";
 #define TSL2591_STATUS_ALS_NP_INTR  0x20
 #define TSL2591_STATUS_ALS_VALID    0x01  
 
+// Max channel counts.
+#define TSL2591_MAX_COUNT_100MS     37888
+#define TSL2591_MAX_COUNT           65535
+
+// Auto-range thresholds, percent of max count.
+#define AUTORANGE_HIGH  90
+#define AUTORANGE_LOW   50
+
 // Calculation constants.
 #define TSL2591_LUX_DF 408.0F
 
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
-#define SLEEP_MS(x) do { vTaskDelay(pdMS_TO_TICKS(x)); } while (0)
+#define SLEEP_MS(x) do { ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(x)); } while (0)
 
 // Read/write to registers.
 static inline esp_err_t write_register(tsl2591_t *dev, uint8_t reg, uint8_t value)
@@ -181,22 +192,22 @@ esp_err_t tsl2591_init(tsl2591_t *dev)
     CHECK_ARG(dev);
     ESP_LOGD(TAG, "Initialize sensor.");
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     uint8_t tmp_reg = 0;
-    I2C_DEV_CHECK(&dev->i2c_dev, read_enable_register(dev, &tmp_reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_enable_register(dev, &tmp_reg));
     dev->settings.enable_reg = tmp_reg;
     ESP_LOGD(TAG, "Initial enable register: %x.", tmp_reg);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, read_control_register(dev, &tmp_reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_control_register(dev, &tmp_reg));
     dev->settings.control_reg = tmp_reg;
     ESP_LOGD(TAG, "Initial control register: %x.", tmp_reg);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, read_register(dev, TSL2591_REG_PERSIST, &tmp_reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_register(dev, TSL2591_REG_PERSIST, &tmp_reg));
     dev->settings.persistence_reg = tmp_reg;
     ESP_LOGD(TAG, "Initial persistence filter: %x.", tmp_reg);
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     // Wait until the first integration cycle is completed.
     tsl2591_integration_time_t integration_time;
@@ -232,12 +243,12 @@ esp_err_t tsl2591_get_channel_data(tsl2591_t *dev, uint16_t *channel0, uint16_t
 {
     CHECK_ARG(dev && channel0 &&  channel1);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C0DATAL, channel0));
-    I2C_DEV_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C1DATAL, channel1));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C0DATAL, channel0));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C1DATAL, channel1));
     
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
     ESP_LOGD(TAG, "channel0: 0x%x channel1: 0x%x.", *channel0, *channel1);
 
     return ESP_OK;
@@ -298,6 +309,41 @@ esp_err_t tsl2591_calculate_lux(tsl2591_t *dev, uint16_t channel0, uint16_t chan
     return ESP_OK;
 }
 
+// 408000 * 2^16 / (atime * again), Q16 factor to get millilux
+#define LUX_INT_F(atime, again) ((uint32_t)((408000ULL << 16) / ((atime) * (again))))
+#define LUX_INT_ROW(atime) { LUX_INT_F(atime, 1), LUX_INT_F(atime, 25), LUX_INT_F(atime, 428), LUX_INT_F(atime, 9876) }
+
+static const uint32_t lux_int_factors[6][4] = {
+    LUX_INT_ROW(100), LUX_INT_ROW(200), LUX_INT_ROW(300),
+    LUX_INT_ROW(400), LUX_INT_ROW(500), LUX_INT_ROW(600),
+};
+
+esp_err_t tsl2591_calculate_lux_int(tsl2591_t *dev, uint16_t channel0, uint16_t channel1, uint32_t *mlux)
+{
+    CHECK_ARG(dev && mlux);
+
+    if (channel0 == 0 || channel1 >= channel0)
+    {
+        *mlux = 0;
+        return ESP_OK;
+    }
+
+    uint8_t time = dev->settings.control_reg & 0x07;
+    if (time > TSL2591_INTEGRATION_600MS)
+        time = TSL2591_INTEGRATION_100MS;
+    uint8_t gain = (dev->settings.control_reg & TSL2591_GAIN_MAX) >> 4;
+
+    // lux = (ch0 - ch1) * (1 - ch1 / ch0) / cpl = d * (d / ch0) * 408 / (atime * again)
+    // d * d / ch0 in Q16, split into quotient and remainder to stay in 32 bits
+    uint32_t d = channel0 - channel1;
+    uint32_t sq = d * d;
+    uint32_t x = ((sq / channel0) << 16) + ((sq % channel0) << 16) / channel0;
+
+    *mlux = ((uint64_t)x * lux_int_factors[time][gain] + (1ULL << 31)) >> 32;
+
+    return ESP_OK;
+}
+
 esp_err_t tsl2591_get_lux(tsl2591_t *dev, float *lux)
 {
     CHECK_ARG(dev && lux);
@@ -313,13 +359,13 @@ esp_err_t tsl2591_set_power_status(tsl2591_t *dev, tsl2591_power_status_t power_
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, 
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, 
         write_enable_register(dev, (dev->settings.enable_reg & ~TSL2591_POWER_ON) | power_status));
     dev->settings.enable_reg = (dev->settings.enable_reg & ~TSL2591_POWER_ON) | power_status;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -337,13 +383,13 @@ esp_err_t tsl2591_set_als_status(tsl2591_t *dev, tsl2591_als_status_t als_status
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, 
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, 
         write_enable_register(dev, (dev->settings.enable_reg & ~TSL2591_ALS_ON) | als_status));
     dev->settings.enable_reg = (dev->settings.enable_reg & ~TSL2591_ALS_ON) | als_status;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -361,17 +407,17 @@ esp_err_t tsl2591_set_interrupt(tsl2591_t *dev, tsl2591_interrupt_t interrupt)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_enable_register(dev, (dev->settings.enable_reg & ~TSL2591_ALS_INTR_BOTH_ON) | interrupt));
     dev->settings.enable_reg = (dev->settings.enable_reg & ~TSL2591_ALS_INTR_BOTH_ON) | interrupt; 
 
     uint8_t tmp = 0;
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         read_enable_register(dev, &tmp));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -389,13 +435,13 @@ esp_err_t tsl2591_set_sleep_after_intr(tsl2591_t *dev, tsl2591_sleep_after_intr_
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_enable_register(dev, (dev->settings.enable_reg & ~TSL2591_SLEEP_AFTER_ON) | sleep_after_intr));
     dev->settings.enable_reg = (dev->settings.enable_reg & ~TSL2591_SLEEP_AFTER_ON) | sleep_after_intr; 
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -415,14 +461,14 @@ esp_err_t tsl2591_set_integration_time(tsl2591_t *dev, tsl2591_integration_time_
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
     // Last 3 bits represent the integration time.
-    I2C_DEV_CHECK(&dev->i2c_dev, 
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, 
         write_control_register(dev, (dev->settings.control_reg & ~0x07) | integration_time));
     dev->settings.control_reg = (dev->settings.control_reg & ~0x07) | integration_time;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -441,13 +487,13 @@ esp_err_t tsl2591_set_gain(tsl2591_t *dev, tsl2591_gain_t gain)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, 
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, 
         write_control_register(dev, (dev->settings.control_reg & ~TSL2591_GAIN_MAX) | gain));
     dev->settings.control_reg = (dev->settings.control_reg & ~TSL2591_GAIN_MAX) | gain;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -467,13 +513,13 @@ esp_err_t tsl2591_set_persistence_filter(tsl2591_t *dev, tsl2591_persistence_fil
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, 
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, 
         write_register(dev, TSL2591_REG_PERSIST, (dev->settings.persistence_reg & ~TSL2591_60_CYCLES) | filter));
     dev->settings.persistence_reg = (dev->settings.persistence_reg & ~TSL2591_60_CYCLES) | filter;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -493,12 +539,12 @@ esp_err_t tsl2591_als_set_low_threshold(tsl2591_t *dev, uint16_t low_threshold)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AILTL, low_threshold));
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AILTH, low_threshold >> 8));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AILTL, low_threshold));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AILTH, low_threshold >> 8));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -507,12 +553,12 @@ esp_err_t tsl2591_als_set_high_threshold(tsl2591_t *dev, uint16_t high_threshold
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AIHTL, high_threshold));
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AIHTH, high_threshold >> 8));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AIHTL, high_threshold));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_AIHTH, high_threshold >> 8));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -521,12 +567,12 @@ esp_err_t tsl2591_no_persist_set_low_threshold(tsl2591_t *dev, uint16_t low_thre
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAILTL, low_threshold));
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAILTH, low_threshold >> 8));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAILTL, low_threshold));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAILTH, low_threshold >> 8));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -535,12 +581,12 @@ esp_err_t tsl2591_no_persist_set_high_threshold(tsl2591_t *dev, uint16_t high_th
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAIHTL, high_threshold));
-    I2C_DEV_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAIHTH, high_threshold >> 8));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAIHTL, high_threshold));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_register(dev, TSL2591_REG_NPAIHTH, high_threshold >> 8));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -551,12 +597,12 @@ esp_err_t tsl2591_set_test_intr(tsl2591_t *dev)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_special_function(dev, TSL2591_SPECIAL_SET_INTR));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -565,12 +611,12 @@ esp_err_t tsl2591_clear_als_intr(tsl2591_t *dev)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_special_function(dev, TSL2591_SPECIAL_CLEAR_INTR));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -579,12 +625,12 @@ esp_err_t tsl2591_clear_als_np_intr(tsl2591_t *dev)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_special_function(dev, TSL2591_SPECIAL_CLEAR_NP_INTR));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -593,12 +639,12 @@ esp_err_t tsl2591_clear_both_intr(tsl2591_t *dev)
 {
     CHECK_ARG(dev);
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         write_special_function(dev, TSL2591_SPECIAL_CLEAR_BOTH));
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -611,14 +657,14 @@ esp_err_t tsl2591_get_np_intr_flag(tsl2591_t *dev, bool *flag)
     
     uint8_t tmp;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         read_register(dev, TSL2591_REG_STATUS, &tmp));
     
     *flag = tmp & TSL2591_STATUS_ALS_NP_INTR ? true : false;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -629,14 +675,14 @@ esp_err_t tsl2591_get_als_intr_flag(tsl2591_t *dev, bool *flag)
     
     uint8_t tmp;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         read_register(dev, TSL2591_REG_STATUS, &tmp));
     
     *flag = tmp & TSL2591_STATUS_ALS_INTR ? true : false;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
 
     return ESP_OK;
 }
@@ -647,14 +693,233 @@ esp_err_t tsl2591_get_als_valid_flag(tsl2591_t *dev, bool *flag)
     
     uint8_t tmp;
 
-    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
 
-    I2C_DEV_CHECK(&dev->i2c_dev,
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev,
         read_register(dev, TSL2591_REG_STATUS, &tmp));
     
     *flag = tmp & TSL2591_STATUS_ALS_VALID? true : false;
 
-    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+
+    return ESP_OK;
+}
+
+
+// Auto-range.
+typedef struct
+{
+    tsl2591_gain_t gain;
+    tsl2591_integration_time_t time;
+    uint32_t sens;  // gain * integration time, ms
+} autorange_step_t;
+
+static const autorange_step_t autorange_steps[] = {
+    { TSL2591_GAIN_LOW,    TSL2591_INTEGRATION_100MS, 1 * 100 },
+    { TSL2591_GAIN_MEDIUM, TSL2591_INTEGRATION_100MS, 25 * 100 },
+    { TSL2591_GAIN_HIGH,   TSL2591_INTEGRATION_100MS, 428 * 100 },
+    { TSL2591_GAIN_HIGH,   TSL2591_INTEGRATION_300MS, 428 * 300 },
+    { TSL2591_GAIN_MAX,    TSL2591_INTEGRATION_100MS, 9876 * 100 },
+    { TSL2591_GAIN_MAX,    TSL2591_INTEGRATION_300MS, 9876 * 300 },
+    { TSL2591_GAIN_MAX,    TSL2591_INTEGRATION_600MS, 9876 * 600 },
+};
+
+#define AUTORANGE_STEPS (sizeof(autorange_steps) / sizeof(autorange_steps[0]))
+
+static inline uint32_t max_count(tsl2591_integration_time_t time)
+{
+    return time == TSL2591_INTEGRATION_100MS ? TSL2591_MAX_COUNT_100MS : TSL2591_MAX_COUNT;
+}
+
+static inline uint32_t integration_ms(tsl2591_integration_time_t time)
+{
+    return TSL2591_INTEGRATION_TIME_100MS + time * 100;
+}
+
+// Select the most sensitive step at which predicted count is below low threshold
+static uint8_t select_step(uint8_t cur, uint16_t channel0)
+{
+    for (int i = AUTORANGE_STEPS - 1; i > 0; i--)
+    {
+        uint64_t pred = (uint64_t)channel0 * autorange_steps[i].sens / autorange_steps[cur].sens;
+        if (pred * 100 < (uint64_t)max_count(autorange_steps[i].time) * AUTORANGE_LOW)
+            return i;
+    }
+    return 0;
+}
+
+static esp_err_t apply_step(tsl2591_autorange_t *ar)
+{
+    tsl2591_t *dev = ar->dev;
+    const autorange_step_t *st = &autorange_steps[ar->step];
+    uint8_t control = (dev->settings.control_reg & ~(TSL2591_GAIN_MAX | 0x07)) | st->gain | st->time;
+
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_control_register(dev, control));
+    dev->settings.control_reg = control;
+    // Restart integration cycle with new settings
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_enable_register(dev, dev->settings.enable_reg & ~TSL2591_ALS_ON));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_enable_register(dev, dev->settings.enable_reg));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_special_function(dev, TSL2591_SPECIAL_CLEAR_INTR));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+    ar->started = esp_timer_get_time();
+
+    if (ar->ready)
+        xSemaphoreTake(ar->ready, 0);
+
+    return ESP_OK;
+}
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR intr_isr(void *arg)
+#else
+static void intr_isr(void *arg)
+#endif
+{
+    tsl2591_autorange_t *ar = (tsl2591_autorange_t *)arg;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(ar->ready, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+esp_err_t tsl2591_autorange_start(tsl2591_autorange_t *ar, tsl2591_t *dev, gpio_num_t gpio)
+{
+    CHECK_ARG(ar && dev);
+
+    ar->dev = dev;
+    ar->gpio = gpio;
+    ar->ready = NULL;
+    ar->saturated = 0;
+    ar->channel0 = ar->channel1 = 0;
+
+    // Start from the step nearest to the current settings
+    tsl2591_gain_t gain = dev->settings.control_reg & TSL2591_GAIN_MAX;
+    ar->step = 0;
+    for (uint8_t i = 0; i < AUTORANGE_STEPS; i++)
+        if (autorange_steps[i].gain == gain)
+        {
+            ar->step = i;
+            break;
+        }
+
+    uint8_t enable = dev->settings.enable_reg | TSL2591_POWER_ON | TSL2591_ALS_ON;
+    if (gpio == GPIO_NUM_MAX)
+    {
+        dev->settings.enable_reg = enable;
+        return apply_step(ar);
+    }
+
+    ar->ready = xSemaphoreCreateBinary();
+    if (!ar->ready)
+        return ESP_ERR_NO_MEM;
+
+    gpio_config_t io_conf;
+    io_conf.pin_bit_mask = 1ULL << gpio;
+    io_conf.mode = GPIO_MODE_INPUT;
+    io_conf.pull_up_en = GPIO_PULLUP_ENABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    io_conf.intr_type = GPIO_INTR_NEGEDGE;
+
+    esp_err_t res = gpio_config(&io_conf);
+    if (res != ESP_OK)
+        goto fail;
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_isr_handler_add(gpio, intr_isr, ar)) != ESP_OK)
+        goto fail;
+
+    // Interrupt at the end of every integration cycle: any count is out of
+    // [0xffff, 0] threshold window, no persistence filter
+    if ((res = tsl2591_als_set_low_threshold(dev, 0xffff)) != ESP_OK
+        || (res = tsl2591_als_set_high_threshold(dev, 0)) != ESP_OK
+        || (res = tsl2591_set_persistence_filter(dev, TSL2591_EVERY_CYCLE)) != ESP_OK)
+        goto fail;
+
+    dev->settings.enable_reg = (enable & ~TSL2591_SLEEP_AFTER_ON) | TSL2591_ALS_INTR_ON;
+    if ((res = apply_step(ar)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    tsl2591_autorange_stop(ar);
+    return res;
+}
+
+esp_err_t tsl2591_autorange_stop(tsl2591_autorange_t *ar)
+{
+    CHECK_ARG(ar && ar->dev);
+
+    if (!ar->ready)
+        return ESP_OK;
+
+    gpio_isr_handler_remove(ar->gpio);
+    gpio_set_intr_type(ar->gpio, GPIO_INTR_DISABLE);
+    vSemaphoreDelete(ar->ready);
+    ar->ready = NULL;
+
+    CHECK(tsl2591_set_interrupt(ar->dev, TSL2591_INTR_OFF));
+
+    return tsl2591_clear_als_intr(ar->dev);
+}
+
+esp_err_t tsl2591_autorange_read(tsl2591_autorange_t *ar, uint32_t timeout_ms, float *lux, bool *valid)
+{
+    CHECK_ARG(ar && ar->dev && lux && valid);
+
+    tsl2591_t *dev = ar->dev;
+    const autorange_step_t *st = &autorange_steps[ar->step];
+
+    *valid = false;
+
+    if (ar->ready)
+    {
+        if (xSemaphoreTake(ar->ready, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+            return ESP_ERR_TIMEOUT;
+    }
+    else
+    {
+        int64_t end = ar->started + integration_ms(st->time) * 1000LL;
+        int64_t now = esp_timer_get_time();
+        if (end > now)
+            SLEEP_MS((end - now + 999) / 1000);
+        ar->started = esp_timer_get_time();
+    }
+
+    I2C_DEV_SESSION_BEGIN(&dev->i2c_dev);
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C0DATAL, &ar->channel0));
+    I2C_DEV_SESSION_CHECK(&dev->i2c_dev, read_register16(dev, TSL2591_REG_C1DATAL, &ar->channel1));
+    if (ar->ready)
+        I2C_DEV_SESSION_CHECK(&dev->i2c_dev, write_special_function(dev, TSL2591_SPECIAL_CLEAR_INTR));
+    I2C_DEV_SESSION_END(&dev->i2c_dev);
+
+    uint32_t max = max_count(st->time);
+    uint8_t next = ar->step;
+    if (ar->channel0 >= max || ar->channel1 >= max)
+    {
+        ar->saturated++;
+        next = 0;
+    }
+    else
+    {
+        *valid = true;
+        // lux must be calculated with the settings of this sample
+        CHECK(tsl2591_calculate_lux(dev, ar->channel0, ar->channel1, lux));
+
+        uint8_t best = select_step(ar->step, ar->channel0);
+        if (best > ar->step || (uint32_t)ar->channel0 * 100 >= max * AUTORANGE_HIGH)
+            next = best;
+    }
+
+    if (next != ar->step)
+    {
+        ESP_LOGD(TAG, "Auto-range step %d -> %d", ar->step, next);
+        ar->step = next;
+        CHECK(apply_step(ar));
+    }
 
     return ESP_OK;
 }
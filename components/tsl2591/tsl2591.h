@@ -38,6 +38,9 @@
 
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <driver/gpio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -151,6 +154,21 @@ typedef struct
 
 } tsl2591_t;
 
+/**
+ * Auto-range controller
+ */
+typedef struct
+{
+    tsl2591_t *dev;              //!< Device descriptor
+    gpio_num_t gpio;             //!< GPIO connected to INT pin, GPIO_NUM_MAX to use timing
+    SemaphoreHandle_t ready;     //!< Integration complete semaphore, internal
+    int64_t started;             //!< Time of integration cycle start, internal
+    uint8_t step;                //!< Current gain/integration time step
+    uint16_t channel0;           //!< Last channel 0 data
+    uint16_t channel1;           //!< Last channel 1 data
+    uint32_t saturated;          //!< Number of saturated samples
+} tsl2591_autorange_t;
+
 
 /**
  * @brief Initialize device descriptor
@@ -199,6 +217,21 @@ esp_err_t tsl2591_get_channel_data(tsl2591_t *dev, uint16_t *channel0, uint16_t
  */
 esp_err_t tsl2591_calculate_lux(tsl2591_t *dev, uint16_t channel0, uint16_t channel1, float *lux);
 
+/**
+ * @brief Calculate light intensity from channels without floating point math
+ *
+ * Same formula as ::tsl2591_calculate_lux() in 32-bit fixed point. Relative
+ * error against float implementation is below 0.1% for lux > 1.
+ * Returns 0 if `channel1 >= channel0`.
+ *
+ * @param dev Device descriptor
+ * @param channel0 Channel0 data
+ * @param channel1 Channel1 data
+ * @param[out] mlux Light intensity, millilux
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsl2591_calculate_lux_int(tsl2591_t *dev, uint16_t channel0, uint16_t channel1, uint32_t *mlux);
+
 /**
  * @brief Get and calculate light intensity
  *
@@ -434,6 +467,47 @@ esp_err_t tsl2591_get_als_intr_flag(tsl2591_t *dev, bool *flag);
  */
 esp_err_t tsl2591_get_als_valid_flag(tsl2591_t *dev, bool *flag);
 
+/**
+ * @brief Start auto-ranging measurements
+ *
+ * Gain and integration time are selected from the previous sample: longest
+ * integration and highest gain which keep the predicted channel 0 count
+ * within the range. A saturated sample switches to the least sensitive
+ * setting at once, so any light level is measured in at most one retry.
+ *
+ * If `gpio` is not GPIO_NUM_MAX, ALS interrupt is enabled for every
+ * integration cycle and INT pin (active low) is used to read data exactly when
+ * the integration is complete. Otherwise data is read after the integration
+ * time. ALS interrupt thresholds and persistence filter are overwritten.
+ *
+ * @param ar Auto-range controller
+ * @param dev Device descriptor
+ * @param gpio GPIO connected to INT pin or GPIO_NUM_MAX
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsl2591_autorange_start(tsl2591_autorange_t *ar, tsl2591_t *dev, gpio_num_t gpio);
+
+/**
+ * @brief Stop auto-ranging measurements
+ *
+ * ALS interrupt is disabled, gain and integration time are kept.
+ *
+ * @param ar Auto-range controller
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsl2591_autorange_stop(tsl2591_autorange_t *ar);
+
+/**
+ * @brief Wait for the next sample and calculate light intensity
+ *
+ * @param ar Auto-range controller
+ * @param timeout_ms Time to wait for interrupt
+ * @param[out] lux Light intensity, not changed if sample was saturated
+ * @param[out] valid false if sample was saturated and range has been switched
+ * @return `ESP_OK` on success, `ESP_ERR_TIMEOUT` if there was no interrupt
+ */
+esp_err_t tsl2591_autorange_read(tsl2591_autorange_t *ar, uint32_t timeout_ms, float *lux, bool *valid);
+
 #ifdef __cplusplus
 }
 #endif
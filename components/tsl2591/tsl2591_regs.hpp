@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * @file tsl2591_regs.hpp
+ * @defgroup tsl2591_regs tsl2591_regs
+ * @{
+ *
+ * TSL2591 register map for i2cdev_regs.hpp
+ *
+ * Register addresses include command bit and normal transaction type.
+ *
+ * MIT Licensed as described in the file LICENSE
+ */
+#ifndef __TSL2591_REGS_HPP__
+#define __TSL2591_REGS_HPP__
+
+#include <i2cdev_regs.hpp>
+
+namespace tsl2591_regs {
+
+using i2cdev::reg;
+using i2cdev::field;
+using i2cdev::byte_order;
+
+/// Command byte for normal register access
+constexpr uint8_t cmd(uint8_t addr) { return 0xa0 | addr; }
+
+/// Enable register
+struct enable : reg<cmd(0x00)>
+{
+    typedef field<enable, 0> pon;   //!< Power on
+    typedef field<enable, 1> aen;   //!< ALS enable
+    typedef field<enable, 4> aien;  //!< ALS interrupt enable
+    typedef field<enable, 6> sai;   //!< Sleep after interrupt
+    typedef field<enable, 7> npien; //!< No persist interrupt enable
+};
+
+/// Control register
+struct control : reg<cmd(0x01)>
+{
+    typedef field<control, 0, 3> atime; //!< Integration time, ::tsl2591_integration_time_t
+    typedef field<control, 4, 2> again; //!< Gain, ::tsl2591_gain_t >> 4
+    typedef field<control, 7> sreset;   //!< System reset
+};
+
+/// Interrupt persistence filter register
+struct persist : reg<cmd(0x0c)>
+{
+    typedef field<persist, 0, 4> apers; //!< Persistence filter
+};
+
+/// Status register
+struct status : reg<cmd(0x13)>
+{
+    typedef field<status, 0> avalid; //!< ALS data valid
+    typedef field<status, 4> aint;   //!< ALS interrupt
+    typedef field<status, 5> npintr; //!< No persist interrupt
+};
+
+/// Channel 0 data
+struct c0data : reg<cmd(0x14), uint16_t, byte_order::little> {};
+
+/// Channel 1 data
+struct c1data : reg<cmd(0x16), uint16_t, byte_order::little> {};
+
+} // namespace tsl2591_regs
+
+/**@}*/
+
+#endif /* __TSL2591_REGS_HPP__ */
@@ -43,6 +43,7 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_trace.h>
 #include "tsl4531.h"
 
 #define I2C_FREQ_HZ 400000
@@ -184,15 +185,15 @@ esp_err_t tsl4531_read_lux(tsl4531_t *dev, uint16_t *lux)
     {
         case TSL4531_INTEGRATION_100MS:
             multiplier = 4;
-            vTaskDelay(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_100MS));
+            ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_100MS));
             break;
         case TSL4531_INTEGRATION_200MS:
             multiplier = 2;
-            vTaskDelay(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_200MS));
+            ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_200MS));
             break;
         default:
             multiplier = 1;
-            vTaskDelay(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_400MS));
+            ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(TSL4531_INTEGRATION_TIME_400MS));
     }
 
     uint16_t lux_data;
@@ -38,6 +38,7 @@
 #include <esp_idf_lib_helpers.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <esp_idf_lib_trace.h>
 #include "tsys01.h"
 
 #define I2C_FREQ_HZ 1000000 // 1MHz
@@ -50,6 +51,8 @@ static const char *TAG = "tsys01";
 #define CMD_PROM   0xa0
 #define CMD_SERIAL 0xac
 
+#define CONVERSION_US 10000 // 9.04 ms max
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
@@ -67,7 +70,7 @@ static esp_err_t send_cmd(tsys01_t *dev, uint8_t cmd)
     return ESP_OK;
 }
 
-inline static float calc_temp(tsys01_t *dev, uint16_t raw)
+inline static float calc_temp(const tsys01_t *dev, uint16_t raw)
 {
     return -2.0f * dev->cal[1] / 1000000000000000000000.0f * raw * raw * raw * raw +
             4.0f * dev->cal[2] / 10000000000000000.0f * raw * raw * raw +
@@ -76,6 +79,18 @@ inline static float calc_temp(tsys01_t *dev, uint16_t raw)
            -1.5f * dev->cal[5] / 100.0f;
 }
 
+// Same polynomial in 0.01 deg.C, evaluated by Horner's method in 64-bit
+// integers, accumulator is scaled by 10^6 to keep precision
+inline static int16_t calc_temp_fixed(const tsys01_t *dev, uint16_t raw)
+{
+    const int64_t s = 1000000;
+    int64_t acc = -2 * (int64_t)dev->cal[1] * s;
+    acc = acc * raw / 100000 + 4 * (int64_t)dev->cal[2] * s;
+    acc = acc * raw / 100000 - 2 * (int64_t)dev->cal[3] * s;
+    acc = acc * raw / 100000 + (int64_t)dev->cal[4] * s;
+    return acc * raw / (10000 * s) - 3 * (int32_t)dev->cal[5] / 2;
+}
+
 static esp_err_t get_temp_nolock(tsys01_t *dev, uint32_t *raw, float *t)
 {
     uint8_t r[3];
@@ -152,6 +167,16 @@ esp_err_t tsys01_start(tsys01_t *dev)
     return send_cmd(dev, CMD_START);
 }
 
+esp_err_t tsys01_start_ready(tsys01_t *dev, esp_idf_lib_ready_t *ready)
+{
+    CHECK_ARG(dev && ready);
+
+    CHECK(send_cmd(dev, CMD_START));
+    esp_idf_lib_ready_after(ready, CONVERSION_US);
+
+    return ESP_OK;
+}
+
 esp_err_t tsys01_get_temp(tsys01_t *dev, uint32_t *raw, float *t)
 {
     CHECK_ARG(dev && (raw || t));
@@ -163,13 +188,48 @@ esp_err_t tsys01_get_temp(tsys01_t *dev, uint32_t *raw, float *t)
     return ESP_OK;
 }
 
+esp_err_t tsys01_raw_to_temp(const tsys01_t *dev, uint32_t raw, float *t)
+{
+    CHECK_ARG(dev && t);
+
+    *t = calc_temp(dev, raw >> 8);
+
+    return ESP_OK;
+}
+
+esp_err_t tsys01_raw_to_temp_fixed(const tsys01_t *dev, uint32_t raw, int16_t *t)
+{
+    CHECK_ARG(dev && t);
+
+    *t = calc_temp_fixed(dev, raw >> 8);
+
+    return ESP_OK;
+}
+
+esp_err_t tsys01_measure_fixed(tsys01_t *dev, int16_t *t)
+{
+    CHECK_ARG(dev && t);
+
+    uint32_t raw;
+
+    I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
+    I2C_DEV_CHECK(&dev->i2c_dev, send_cmd_nolock(dev, CMD_START));
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(CONVERSION_US / 1000));
+    I2C_DEV_CHECK(&dev->i2c_dev, get_temp_nolock(dev, &raw, NULL));
+    I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
+
+    *t = calc_temp_fixed(dev, raw >> 8);
+
+    return ESP_OK;
+}
+
 esp_err_t tsys01_measure(tsys01_t *dev, float *t)
 {
     CHECK_ARG(dev && t);
 
     I2C_DEV_TAKE_MUTEX(&dev->i2c_dev);
     I2C_DEV_CHECK(&dev->i2c_dev, send_cmd_nolock(dev, CMD_START));
-    vTaskDelay(pdMS_TO_TICKS(10));
+    ESP_IDF_LIB_TRACE_DELAY(pdMS_TO_TICKS(CONVERSION_US / 1000));
     I2C_DEV_CHECK(&dev->i2c_dev, get_temp_nolock(dev, NULL, t));
     I2C_DEV_GIVE_MUTEX(&dev->i2c_dev);
 
@@ -41,6 +41,7 @@
 
 #include <i2cdev.h>
 #include <esp_err.h>
+#include <esp_idf_lib_ready.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -106,6 +107,17 @@ esp_err_t tsys01_reset(tsys01_t *dev);
  */
 esp_err_t tsys01_start(tsys01_t *dev);
 
+/**
+ * @brief Start temperature conversion and get its ready time
+ *
+ * Read result with ::tsys01_get_temp() after waiting for the token.
+ *
+ * @param dev Device descriptor
+ * @param[out] ready Conversion ready token
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsys01_start_ready(tsys01_t *dev, esp_idf_lib_ready_t *ready);
+
 /**
  * @brief Read converted temperature from sensor.
  *
@@ -116,6 +128,31 @@ esp_err_t tsys01_start(tsys01_t *dev);
  */
 esp_err_t tsys01_get_temp(tsys01_t *dev, uint32_t *raw, float *t);
 
+/**
+ * @brief Convert raw ADC value to temperature.
+ *
+ * Useful when ADC value is read by other means, e.g. in a batch with
+ * other devices.
+ *
+ * @param dev Device descriptor, calibration values are used
+ * @param raw Raw 24-bit ADC value
+ * @param[out] t Temperature, degrees Celsius
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsys01_raw_to_temp(const tsys01_t *dev, uint32_t raw, float *t);
+
+/**
+ * @brief Convert raw ADC value to temperature without floating point operations.
+ *
+ * Result differs from ::tsys01_raw_to_temp() by 0.01 deg.C at most.
+ *
+ * @param dev Device descriptor, calibration values are used
+ * @param raw Raw 24-bit ADC value
+ * @param[out] t Temperature, 0.01 deg.C
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsys01_raw_to_temp_fixed(const tsys01_t *dev, uint32_t raw, int16_t *t);
+
 /**
  * @brief Perform temperature conversion
  *
@@ -128,6 +165,17 @@ esp_err_t tsys01_get_temp(tsys01_t *dev, uint32_t *raw, float *t);
  */
 esp_err_t tsys01_measure(tsys01_t *dev, float *t);
 
+/**
+ * @brief Perform temperature conversion without floating point operations
+ *
+ * Same as ::tsys01_measure().
+ *
+ * @param dev Device descriptor
+ * @param[out] t Temperature, 0.01 deg.C
+ * @return `ESP_OK` on success
+ */
+esp_err_t tsys01_measure_fixed(tsys01_t *dev, int16_t *t);
+
 #ifdef __cplusplus
 }
 #endif
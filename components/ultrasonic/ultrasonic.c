@@ -37,25 +37,33 @@
  * BSD Licensed as described in the file LICENSE
  */
 #include <esp_idf_lib_helpers.h>
+#include <esp_idf_lib_crit_stats.h>
 #include "ultrasonic.h"
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <esp_timer.h>
+#include <esp_attr.h>
 
 #define TRIGGER_LOW_DELAY 4
 #define TRIGGER_HIGH_DELAY 10
-#define PING_TIMEOUT 6000
 #define ROUNDTRIP_M 5800.0f
 #define ROUNDTRIP_CM 58
 
+ESP_IDF_LIB_CRIT_STATS_DEFINE(crit_stats, "ultrasonic");
+
+// Short ISR sections of echo capture are not accounted
 #if HELPER_TARGET_IS_ESP32
 static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL(&mux)
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL(&mux)
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(&mux); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(&mux); } while (0)
+#define PORT_ENTER_CRITICAL_ISR portENTER_CRITICAL_ISR(&mux)
+#define PORT_EXIT_CRITICAL_ISR portEXIT_CRITICAL_ISR(&mux)
 
 #elif HELPER_TARGET_IS_ESP8266
-#define PORT_ENTER_CRITICAL portENTER_CRITICAL()
-#define PORT_EXIT_CRITICAL portEXIT_CRITICAL()
+#define PORT_ENTER_CRITICAL do { portENTER_CRITICAL(); ESP_IDF_LIB_CRIT_STATS_BEGIN(crit_stats); } while (0)
+#define PORT_EXIT_CRITICAL do { ESP_IDF_LIB_CRIT_STATS_END(crit_stats); portEXIT_CRITICAL(); } while (0)
+#define PORT_ENTER_CRITICAL_ISR
+#define PORT_EXIT_CRITICAL_ISR
 
 #else
 #error cannot identify the target
@@ -67,6 +75,13 @@ static portMUX_TYPE mux = portMUX_INITIALIZER_UNLOCKED;
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define RETURN_CRITICAL(RES) do { PORT_EXIT_CRITICAL; return RES; } while(0)
 
+enum {
+    CAPTURE_IDLE = 0,
+    CAPTURE_WAIT_ECHO,
+    CAPTURE_ECHO,
+    CAPTURE_DONE
+};
+
 esp_err_t ultrasonic_init(const ultrasonic_sensor_t *dev)
 {
     CHECK_ARG(dev);
@@ -99,7 +114,7 @@ esp_err_t ultrasonic_measure_raw(const ultrasonic_sensor_t *dev, uint32_t max_ti
     int64_t start = esp_timer_get_time();
     while (!gpio_get_level(dev->echo_pin))
     {
-        if (timeout_expired(start, PING_TIMEOUT))
+        if (timeout_expired(start, ULTRASONIC_PING_TIMEOUT_US))
             RETURN_CRITICAL(ESP_ERR_ULTRASONIC_PING_TIMEOUT);
     }
 
@@ -140,3 +155,179 @@ esp_err_t ultrasonic_measure_cm(const ultrasonic_sensor_t *dev, uint32_t max_dis
 
     return ESP_OK;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if HELPER_TARGET_IS_ESP32
+static void IRAM_ATTR echo_isr(void *arg)
+#else
+static void echo_isr(void *arg)
+#endif
+{
+    ultrasonic_capture_t *cap = (ultrasonic_capture_t *)arg;
+    int64_t now = esp_timer_get_time();
+    bool finished = false;
+
+    PORT_ENTER_CRITICAL_ISR;
+    if (gpio_get_level(cap->sensor.echo_pin))
+    {
+        if (cap->state == CAPTURE_WAIT_ECHO)
+        {
+            cap->echo_start = now;
+            cap->state = CAPTURE_ECHO;
+        }
+    }
+    else if (cap->state == CAPTURE_ECHO)
+    {
+        cap->time_us = now - cap->echo_start;
+        cap->result = cap->time_us < cap->max_time_us ? ESP_OK : ESP_ERR_ULTRASONIC_ECHO_TIMEOUT;
+        cap->state = CAPTURE_DONE;
+        finished = true;
+    }
+    PORT_EXIT_CRITICAL_ISR;
+
+    if (!finished)
+        return;
+
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(cap->done, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
+}
+
+static void timeout_cb(void *arg)
+{
+    ultrasonic_capture_t *cap = (ultrasonic_capture_t *)arg;
+    bool finished = false;
+
+    PORT_ENTER_CRITICAL;
+    if (cap->state == CAPTURE_WAIT_ECHO || cap->state == CAPTURE_ECHO)
+    {
+        cap->result = cap->state == CAPTURE_WAIT_ECHO
+            ? ESP_ERR_ULTRASONIC_PING_TIMEOUT
+            : ESP_ERR_ULTRASONIC_ECHO_TIMEOUT;
+        cap->state = CAPTURE_DONE;
+        finished = true;
+    }
+    PORT_EXIT_CRITICAL;
+
+    if (finished)
+        xSemaphoreGive(cap->done);
+}
+
+esp_err_t ultrasonic_capture_init(ultrasonic_capture_t *cap)
+{
+    CHECK_ARG(cap);
+
+    CHECK(ultrasonic_init(&cap->sensor));
+
+    cap->state = CAPTURE_IDLE;
+    cap->done = xSemaphoreCreateBinary();
+    if (!cap->done)
+        return ESP_ERR_NO_MEM;
+
+    esp_timer_create_args_t args = {
+        .callback = timeout_cb,
+        .arg = cap,
+        .name = "ultrasonic"
+    };
+    esp_err_t res = esp_timer_create(&args, &cap->timer);
+    if (res != ESP_OK)
+        goto fail_timer;
+
+    res = gpio_install_isr_service(0);
+    if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
+        goto fail;
+    if ((res = gpio_set_intr_type(cap->sensor.echo_pin, GPIO_INTR_ANYEDGE)) != ESP_OK)
+        goto fail;
+    if ((res = gpio_isr_handler_add(cap->sensor.echo_pin, echo_isr, cap)) != ESP_OK)
+        goto fail;
+
+    return ESP_OK;
+
+fail:
+    esp_timer_delete(cap->timer);
+fail_timer:
+    vSemaphoreDelete(cap->done);
+    cap->timer = NULL;
+    cap->done = NULL;
+    return res;
+}
+
+esp_err_t ultrasonic_capture_free(ultrasonic_capture_t *cap)
+{
+    CHECK_ARG(cap && cap->done);
+
+    CHECK(gpio_isr_handler_remove(cap->sensor.echo_pin));
+    CHECK(gpio_set_intr_type(cap->sensor.echo_pin, GPIO_INTR_DISABLE));
+    esp_timer_stop(cap->timer);
+    CHECK(esp_timer_delete(cap->timer));
+    vSemaphoreDelete(cap->done);
+    cap->timer = NULL;
+    cap->done = NULL;
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_capture_start(ultrasonic_capture_t *cap, uint32_t max_time_us)
+{
+    CHECK_ARG(cap && cap->done);
+
+    if (cap->state == CAPTURE_WAIT_ECHO || cap->state == CAPTURE_ECHO)
+        return ESP_ERR_INVALID_STATE;
+
+    // Previous ping isn't ended
+    if (gpio_get_level(cap->sensor.echo_pin))
+        return ESP_ERR_ULTRASONIC_PING;
+
+    // Drop the result nobody has read
+    xSemaphoreTake(cap->done, 0);
+    cap->max_time_us = max_time_us;
+    cap->state = CAPTURE_WAIT_ECHO;
+
+    // Ping: Low for 2..4 us, then high 10 us. Pulse may be stretched by
+    // an interrupt, sensor doesn't care
+    CHECK(gpio_set_level(cap->sensor.trigger_pin, 0));
+    ets_delay_us(TRIGGER_LOW_DELAY);
+    CHECK(gpio_set_level(cap->sensor.trigger_pin, 1));
+    ets_delay_us(TRIGGER_HIGH_DELAY);
+    CHECK(gpio_set_level(cap->sensor.trigger_pin, 0));
+
+    esp_err_t res = esp_timer_start_once(cap->timer, ULTRASONIC_PING_TIMEOUT_US + max_time_us);
+    if (res != ESP_OK)
+        cap->state = CAPTURE_IDLE;
+
+    return res;
+}
+
+esp_err_t ultrasonic_capture_get(ultrasonic_capture_t *cap, uint32_t wait_ms, uint32_t *time_us)
+{
+    CHECK_ARG(cap && cap->done && time_us);
+
+    if (cap->state == CAPTURE_IDLE)
+        return ESP_ERR_INVALID_STATE;
+
+    if (xSemaphoreTake(cap->done, pdMS_TO_TICKS(wait_ms)) != pdTRUE)
+        return ESP_ERR_TIMEOUT;
+
+    esp_timer_stop(cap->timer);
+    cap->state = CAPTURE_IDLE;
+    CHECK(cap->result);
+    *time_us = cap->time_us;
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_capture_measure_cm(ultrasonic_capture_t *cap, uint32_t max_distance, uint32_t *distance)
+{
+    CHECK_ARG(cap && distance);
+
+    uint32_t max_time_us = max_distance * ROUNDTRIP_CM;
+    CHECK(ultrasonic_capture_start(cap, max_time_us));
+
+    uint32_t time_us;
+    CHECK(ultrasonic_capture_get(cap, (ULTRASONIC_PING_TIMEOUT_US + max_time_us) / 1000 + 2 * portTICK_PERIOD_MS, &time_us));
+    *distance = time_us / ROUNDTRIP_CM;
+
+    return ESP_OK;
+}
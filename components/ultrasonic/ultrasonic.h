@@ -43,6 +43,9 @@
 
 #include <driver/gpio.h>
 #include <esp_err.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,6 +55,8 @@ extern "C" {
 #define ESP_ERR_ULTRASONIC_PING_TIMEOUT 0x201
 #define ESP_ERR_ULTRASONIC_ECHO_TIMEOUT 0x202
 
+#define ULTRASONIC_PING_TIMEOUT_US 6000 //!< Maximum time from trigger until echo start, us
+
 /**
  * Device descriptor
  */
@@ -61,6 +66,21 @@ typedef struct
     gpio_num_t echo_pin;    //!< GPIO input pin for echo
 } ultrasonic_sensor_t;
 
+/**
+ * Interrupt-driven measurement descriptor
+ */
+typedef struct
+{
+    ultrasonic_sensor_t sensor;   //!< Sensor pins
+    esp_timer_handle_t timer;     //!< Timeout timer, internal
+    SemaphoreHandle_t done;       //!< Measurement done semaphore, internal
+    volatile uint8_t state;       //!< Measurement state, internal
+    int64_t echo_start;           //!< Echo rising edge time, internal
+    uint32_t max_time_us;         //!< Maximal echo time, internal
+    uint32_t time_us;             //!< Last measured time, internal
+    esp_err_t result;             //!< Last measurement result, internal
+} ultrasonic_capture_t;
+
 /**
  * @brief Init ranging module
  *
@@ -108,6 +128,66 @@ esp_err_t ultrasonic_measure(const ultrasonic_sensor_t *dev, float max_distance,
  */
 esp_err_t ultrasonic_measure_cm(const ultrasonic_sensor_t *dev, uint32_t max_distance, uint32_t *distance);
 
+/**
+ * @brief Init interrupt-driven measurement
+ *
+ * Configures pins, installs GPIO ISR service if it is not installed yet
+ * and adds echo pin edge handler. Echo edges are timestamped in the
+ * interrupt handler, no critical sections or busy waits are used.
+ *
+ * @param cap Measurement descriptor, `sensor` field must be set
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_capture_init(ultrasonic_capture_t *cap);
+
+/**
+ * @brief Free interrupt-driven measurement resources
+ *
+ * @param cap Measurement descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_capture_free(ultrasonic_capture_t *cap);
+
+/**
+ * @brief Send ping and return immediately
+ *
+ * Result is obtained with ultrasonic_capture_get().
+ *
+ * @param cap Measurement descriptor
+ * @param max_time_us Maximal time to wait for echo
+ * @return `ESP_OK` on success, otherwise:
+ *         - `ESP_ERR_INVALID_STATE`           - Measurement is in progress
+ *         - ::ESP_ERR_ULTRASONIC_PING         - Invalid state (previous ping is not ended)
+ */
+esp_err_t ultrasonic_capture_start(ultrasonic_capture_t *cap, uint32_t max_time_us);
+
+/**
+ * @brief Wait for the result of measurement started by ultrasonic_capture_start()
+ *
+ * @param cap Measurement descriptor
+ * @param wait_ms Maximal time to wait for the result, milliseconds. 0 to poll
+ * @param[out] time_us Time between ping and echo, us
+ * @return `ESP_OK` on success, otherwise:
+ *         - `ESP_ERR_TIMEOUT`                 - Measurement is not finished yet
+ *         - ::ESP_ERR_ULTRASONIC_PING_TIMEOUT - Device is not responding
+ *         - ::ESP_ERR_ULTRASONIC_ECHO_TIMEOUT - Distance is too big or wave is scattered
+ */
+esp_err_t ultrasonic_capture_get(ultrasonic_capture_t *cap, uint32_t wait_ms, uint32_t *time_us);
+
+/**
+ * @brief Measure distance in centimeters using interrupts
+ *
+ * Same as ultrasonic_measure_cm(), but calling task sleeps during the
+ * measurement instead of busy waiting with interrupts disabled.
+ *
+ * @param cap Measurement descriptor
+ * @param max_distance Maximal distance to measure, centimeters
+ * @param[out] distance Distance in centimeters
+ * @return `ESP_OK` on success, errors of ultrasonic_capture_start() and
+ *         ultrasonic_capture_get() otherwise
+ */
+esp_err_t ultrasonic_capture_measure_cm(ultrasonic_capture_t *cap, uint32_t max_distance, uint32_t *distance);
+
 #ifdef __cplusplus
 }
 #endif
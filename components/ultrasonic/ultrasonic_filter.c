@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ultrasonic_filter.c
+ *
+ * Streaming median filter for ultrasonic range meters
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include "ultrasonic_filter.h"
+
+#define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+// speed of sound: 331.3 m/s at 0 C, plus 0.606 m/s per degree
+#define SPEED_0C 331300
+#define SPEED_K 606
+
+// first position in sorted window with value >= v
+static size_t lower_bound(const uint32_t *a, size_t n, uint32_t v)
+{
+    size_t lo = 0, hi = n;
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (a[mid] < v)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+static void push(ultrasonic_filter_t *f, uint32_t time_us)
+{
+    size_t n = f->count, i;
+
+    if (n == f->size)
+    {
+        // remove oldest sample from sorted window
+        i = lower_bound(f->sorted, n, f->window[f->pos]);
+        memmove(&f->sorted[i], &f->sorted[i + 1], (n - i - 1) * sizeof(uint32_t));
+        n--;
+    }
+    else
+        f->count++;
+
+    f->window[f->pos] = time_us;
+    f->pos = (f->pos + 1) % f->size;
+
+    i = lower_bound(f->sorted, n, time_us);
+    memmove(&f->sorted[i + 1], &f->sorted[i], (n - i) * sizeof(uint32_t));
+    f->sorted[i] = time_us;
+
+    // until window is full, take median of what we have
+    f->median = f->sorted[f->count / 2];
+}
+
+esp_err_t ultrasonic_filter_init(ultrasonic_filter_t *f, uint8_t size, uint32_t max_jump_us)
+{
+    CHECK_ARG(f && size && size <= ULTRASONIC_FILTER_MAX && (size & 1));
+
+    memset(f, 0, sizeof(ultrasonic_filter_t));
+    f->size = size;
+    f->max_jump_us = max_jump_us;
+
+    return ultrasonic_filter_set_temperature(f, ULTRASONIC_FILTER_DEFAULT_TEMP);
+}
+
+esp_err_t ultrasonic_filter_reset(ultrasonic_filter_t *f)
+{
+    CHECK_ARG(f);
+
+    f->count = 0;
+    f->pos = 0;
+    f->rejected = 0;
+    f->median = 0;
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_filter_set_temperature(ultrasonic_filter_t *f, int16_t temperature)
+{
+    CHECK_ARG(f && temperature >= -4000 && temperature <= 8500);
+
+    f->speed = SPEED_0C + (int32_t)temperature * SPEED_K / 100;
+
+    return ESP_OK;
+}
+
+uint32_t ultrasonic_filter_distance_mm(const ultrasonic_filter_t *f, uint32_t time_us)
+{
+    // round trip: mm = us * (mm/s) / 2 / 10^6
+    return (uint32_t)(((uint64_t)time_us * f->speed + 1000000) / 2000000);
+}
+
+bool ultrasonic_filter_update(ultrasonic_filter_t *f, uint32_t time_us, uint32_t *distance)
+{
+    bool accepted = true;
+
+    if (f->count && f->max_jump_us)
+    {
+        uint32_t diff = time_us > f->median ? time_us - f->median : f->median - time_us;
+        if (diff > f->max_jump_us)
+        {
+            f->outliers++;
+            if (++f->rejected <= f->size / 2)
+                accepted = false;
+            else
+                // too many in a row, this is a new distance
+                ultrasonic_filter_reset(f);
+        }
+        else
+            f->rejected = 0;
+    }
+
+    if (accepted)
+        push(f, time_us);
+
+    if (distance)
+        *distance = ultrasonic_filter_distance_mm(f, f->median);
+
+    return accepted;
+}
+
+esp_err_t ultrasonic_filter_measure(ultrasonic_capture_t *cap, ultrasonic_filter_t *f,
+        uint32_t max_distance, uint32_t *distance)
+{
+    CHECK_ARG(cap && f && distance);
+
+    uint32_t max_time_us = (uint32_t)(((uint64_t)max_distance * 2000000 + f->speed - 1) / f->speed);
+    CHECK(ultrasonic_capture_start(cap, max_time_us));
+
+    uint32_t time_us;
+    esp_err_t res = ultrasonic_capture_get(cap, (ULTRASONIC_PING_TIMEOUT_US + max_time_us) / 1000 + 2 * portTICK_PERIOD_MS, &time_us);
+    if (res != ESP_OK)
+    {
+        if (res != ESP_ERR_ULTRASONIC_ECHO_TIMEOUT || !f->count)
+            return res;
+        *distance = ultrasonic_filter_distance_mm(f, f->median);
+        return ESP_OK;
+    }
+
+    ultrasonic_filter_update(f, time_us, distance);
+
+    return ESP_OK;
+}
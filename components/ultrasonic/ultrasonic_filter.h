@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ultrasonic_filter.h
+ * @defgroup ultrasonic_filter ultrasonic_filter
+ * @{
+ *
+ * Streaming median filter for ultrasonic range meters
+ *
+ * Every echo time is pushed into a rolling median window, so filtered
+ * distance is produced at the raw measurement rate instead of taking N
+ * pings per reading. Samples too far from the current median are
+ * rejected as outliers, echo time is converted to distance using speed
+ * of sound compensated for air temperature. No floating point is used.
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ULTRASONIC_FILTER_H__
+#define __ULTRASONIC_FILTER_H__
+
+#include <stdbool.h>
+#include "ultrasonic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximal median window size
+ */
+#define ULTRASONIC_FILTER_MAX 15
+
+/**
+ * Default air temperature, 1/100 degrees Celsius
+ */
+#define ULTRASONIC_FILTER_DEFAULT_TEMP 2000
+
+/**
+ * Filter descriptor
+ */
+typedef struct
+{
+    uint8_t size;          //!< Window size
+    uint8_t count;         //!< Samples in window
+    uint8_t pos;           //!< Oldest sample position in window
+    uint8_t rejected;      //!< Consecutive rejected samples
+    uint32_t max_jump_us;  //!< Outlier threshold, us, 0 to disable rejection
+    uint32_t speed;        //!< Speed of sound, mm/s
+    uint32_t window[ULTRASONIC_FILTER_MAX]; //!< Echo times, in arrival order
+    uint32_t sorted[ULTRASONIC_FILTER_MAX]; //!< Echo times, sorted
+    uint32_t median;       //!< Last filtered echo time, us
+    uint32_t outliers;     //!< Total number of rejected samples
+} ultrasonic_filter_t;
+
+/**
+ * @brief Initialize filter
+ *
+ * Air temperature is set to ::ULTRASONIC_FILTER_DEFAULT_TEMP.
+ *
+ * Sample is rejected when it differs from the current median by more
+ * than `max_jump_us`. If more than half of the window is rejected in a
+ * row, target has really moved: window is restarted from the last sample.
+ *
+ * @param f Filter descriptor
+ * @param size Odd window size, 1..::ULTRASONIC_FILTER_MAX
+ * @param max_jump_us Outlier threshold, echo time in microseconds
+ *                    (58 us per centimeter), 0 to disable rejection
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_filter_init(ultrasonic_filter_t *f, uint8_t size, uint32_t max_jump_us);
+
+/**
+ * @brief Reset filter window
+ *
+ * Temperature and outlier threshold are kept.
+ *
+ * @param f Filter descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_filter_reset(ultrasonic_filter_t *f);
+
+/**
+ * @brief Set air temperature for speed of sound compensation
+ *
+ * Speed of sound is calculated as 331.3 + 0.606 * T m/s.
+ *
+ * @param f Filter descriptor
+ * @param temperature Air temperature, 1/100 degrees Celsius, -40..+85 C
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_filter_set_temperature(ultrasonic_filter_t *f, int16_t temperature);
+
+/**
+ * @brief Convert echo time to distance using compensated speed of sound
+ *
+ * @param f Filter descriptor
+ * @param time_us Round-trip echo time, microseconds
+ * @return Distance, millimeters
+ */
+uint32_t ultrasonic_filter_distance_mm(const ultrasonic_filter_t *f, uint32_t time_us);
+
+/**
+ * @brief Feed echo time to the filter
+ *
+ * Every call produces output while window is not empty, outliers are
+ * dropped and last median is returned instead.
+ *
+ * @param f Filter descriptor
+ * @param time_us Round-trip echo time, microseconds
+ * @param[out] distance Filtered distance, millimeters
+ * @return true if sample was accepted, false if it was rejected as outlier
+ */
+bool ultrasonic_filter_update(ultrasonic_filter_t *f, uint32_t time_us, uint32_t *distance);
+
+/**
+ * @brief Measure filtered distance using interrupt-driven capture
+ *
+ * Makes one ping with ultrasonic_capture_start() and feeds result to the
+ * filter, so filtered distance is produced at the raw rate. Echo
+ * timeouts are not fed to the filter, last filtered distance is returned
+ * instead while window is not empty.
+ *
+ * @param cap Capture descriptor
+ * @param f Filter descriptor
+ * @param max_distance Maximal distance to measure, millimeters
+ * @param[out] distance Filtered distance, millimeters
+ * @return `ESP_OK` on success, errors of ultrasonic_capture_start() and
+ *         ultrasonic_capture_get() if window is empty
+ */
+esp_err_t ultrasonic_filter_measure(ultrasonic_capture_t *cap, ultrasonic_filter_t *f,
+        uint32_t max_distance, uint32_t *distance);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __ULTRASONIC_FILTER_H__ */
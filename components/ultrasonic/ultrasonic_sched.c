@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ultrasonic_sched.c
+ *
+ * Round-robin scheduler for arrays of ultrasonic range meters
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#include <string.h>
+#include <esp_timer.h>
+#include "ultrasonic_sched.h"
+
+#define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
+
+#define ROUNDTRIP_CM 58
+
+static void publish(ultrasonic_sched_t *sched, uint8_t sensor, esp_err_t result, uint32_t time_us,
+        int64_t timestamp)
+{
+    ultrasonic_reading_t r = {
+        .sensor = sensor,
+        .result = result,
+        .distance = result == ESP_OK ? time_us / ROUNDTRIP_CM : 0,
+        .timestamp = timestamp,
+    };
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    sched->latest[sensor] = r;
+    sched->ring[sched->seq % ULTRASONIC_SCHED_RING_LEN] = r;
+    sched->seq++;
+    xSemaphoreGive(sched->lock);
+}
+
+static void sched_task(void *arg)
+{
+    ultrasonic_sched_t *sched = (ultrasonic_sched_t *)arg;
+    uint32_t max_time_us = sched->max_distance * ROUNDTRIP_CM;
+    TickType_t max_wait = pdMS_TO_TICKS((ULTRASONIC_PING_TIMEOUT_US + max_time_us) / 1000) + 2;
+    TickType_t spacing = pdMS_TO_TICKS(sched->spacing_ms);
+    int64_t started[ULTRASONIC_SCHED_MAX_SENSORS];
+    // ping started and its capture not finished yet
+    bool in_flight[ULTRASONIC_SCHED_MAX_SENSORS] = { 0 };
+    uint32_t time_us;
+    size_t step = 0;
+
+    TickType_t last = xTaskGetTickCount();
+    while (sched->running)
+    {
+        uint8_t s = sched->order ? sched->order[step] : step;
+        step = (step + 1) % (sched->order ? sched->order_len : sched->count);
+
+        // previous ping of this sensor must be over, otherwise the sensor
+        // skips its turn and is collected later
+        esp_err_t res = ESP_OK;
+        if (in_flight[s])
+        {
+            res = ultrasonic_capture_get(&sched->sensors[s], max_wait * portTICK_PERIOD_MS, &time_us);
+            if (res != ESP_ERR_TIMEOUT)
+            {
+                publish(sched, s, res, time_us, started[s]);
+                in_flight[s] = false;
+            }
+        }
+
+        if (!in_flight[s])
+        {
+            started[s] = esp_timer_get_time();
+            res = ultrasonic_capture_start(&sched->sensors[s], max_time_us);
+            if (res == ESP_OK)
+                in_flight[s] = true;
+            else
+                publish(sched, s, res, 0, started[s]);
+        }
+
+        // collect results of other sensors without waiting
+        for (size_t i = 0; i < sched->count; i++)
+        {
+            if (!in_flight[i] || i == s)
+                continue;
+            res = ultrasonic_capture_get(&sched->sensors[i], 0, &time_us);
+            if (res == ESP_ERR_TIMEOUT)
+                continue;
+            publish(sched, i, res, time_us, started[i]);
+            in_flight[i] = false;
+        }
+
+        if (spacing)
+            vTaskDelayUntil(&last, spacing);
+        else
+            last = xTaskGetTickCount();
+    }
+
+    for (size_t i = 0; i < sched->count; i++)
+        if (in_flight[i])
+            publish(sched, i, ultrasonic_capture_get(&sched->sensors[i], max_wait * portTICK_PERIOD_MS, &time_us),
+                    time_us, started[i]);
+
+    sched->task = NULL;
+    vTaskDelete(NULL);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+esp_err_t ultrasonic_sched_start(ultrasonic_sched_t *sched, UBaseType_t priority, uint32_t stack_size)
+{
+    CHECK_ARG(sched && sched->sensors && sched->count && sched->count <= ULTRASONIC_SCHED_MAX_SENSORS
+            && sched->max_distance && !sched->task);
+    CHECK_ARG(!sched->order || sched->order_len);
+    for (size_t i = 0; sched->order && i < sched->order_len; i++)
+        CHECK_ARG(sched->order[i] < sched->count);
+
+    if (!sched->lock)
+    {
+        sched->lock = xSemaphoreCreateMutex();
+        if (!sched->lock)
+            return ESP_ERR_NO_MEM;
+    }
+
+    sched->seq = 0;
+    memset(sched->latest, 0, sizeof(sched->latest));
+    sched->running = true;
+    if (xTaskCreate(sched_task, "ultrasonic", stack_size, sched, priority, &sched->task) != pdPASS)
+    {
+        sched->running = false;
+        sched->task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_sched_stop(ultrasonic_sched_t *sched)
+{
+    CHECK_ARG(sched);
+
+    sched->running = false;
+    while (sched->task)
+        vTaskDelay(1);
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_sched_snapshot(ultrasonic_sched_t *sched, ultrasonic_reading_t *readings, uint32_t *seq)
+{
+    CHECK_ARG(sched && sched->lock && readings);
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    memcpy(readings, sched->latest, sched->count * sizeof(ultrasonic_reading_t));
+    if (seq)
+        *seq = sched->seq;
+    xSemaphoreGive(sched->lock);
+
+    return ESP_OK;
+}
+
+esp_err_t ultrasonic_sched_history(ultrasonic_sched_t *sched, uint32_t since, ultrasonic_reading_t *readings,
+        size_t count, size_t *copied, uint32_t *seq)
+{
+    CHECK_ARG(sched && sched->lock && readings && copied && seq);
+
+    xSemaphoreTake(sched->lock, portMAX_DELAY);
+    uint32_t first = since;
+    if (sched->seq - first > ULTRASONIC_SCHED_RING_LEN)
+        first = sched->seq - ULTRASONIC_SCHED_RING_LEN;
+    uint32_t avail = sched->seq - first;
+    if (avail > count)
+        avail = count;
+    for (uint32_t i = 0; i < avail; i++)
+        readings[i] = sched->ring[(first + i) % ULTRASONIC_SCHED_RING_LEN];
+    *copied = avail;
+    *seq = first + avail;
+    xSemaphoreGive(sched->lock);
+
+    return ESP_OK;
+}
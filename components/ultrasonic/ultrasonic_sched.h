@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of itscontributors
+ *    may be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file ultrasonic_sched.h
+ * @defgroup ultrasonic_sched ultrasonic_sched
+ * @{
+ *
+ * Round-robin scheduler for arrays of ultrasonic range meters
+ *
+ * Sensors are pinged in configurable order with a minimal spacing between
+ * pings, so that several pings may be in flight at once while neighbouring
+ * sensors do not hear each other's echo. Results are published to a ring
+ * buffer and a table of latest readings per sensor.
+ *
+ * BSD Licensed as described in the file LICENSE
+ */
+#ifndef __ULTRASONIC_SCHED_H__
+#define __ULTRASONIC_SCHED_H__
+
+#include <stdbool.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include "ultrasonic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximal number of sensors in a scheduler
+ */
+#define ULTRASONIC_SCHED_MAX_SENSORS 8
+
+/**
+ * Ring buffer length, readings
+ */
+#define ULTRASONIC_SCHED_RING_LEN 32
+
+/**
+ * Single reading
+ */
+typedef struct
+{
+    uint8_t sensor;      //!< Sensor index
+    esp_err_t result;    //!< Measurement result, see ultrasonic_capture_get()
+    uint32_t distance;   //!< Distance, centimeters. Valid if result is `ESP_OK`
+    int64_t timestamp;   //!< Ping time, us since boot
+} ultrasonic_reading_t;
+
+/**
+ * Scheduler descriptor
+ */
+typedef struct
+{
+    ultrasonic_capture_t *sensors; //!< Sensors, initialized with ultrasonic_capture_init()
+    size_t count;                  //!< Number of sensors
+    const uint8_t *order;          //!< Ping order, sensor indexes. NULL for 0, 1, ..., count - 1
+    size_t order_len;              //!< Length of `order`
+    uint32_t max_distance;         //!< Maximal distance, centimeters
+    uint32_t spacing_ms;           //!< Minimal time between two pings
+
+    TaskHandle_t task;             //!< Scheduler task, internal
+    SemaphoreHandle_t lock;        //!< Result lock, internal
+    volatile bool running;         //!< Scheduler state, internal
+    uint32_t seq;                  //!< Number of readings published, internal
+    ultrasonic_reading_t latest[ULTRASONIC_SCHED_MAX_SENSORS]; //!< Latest readings, internal
+    ultrasonic_reading_t ring[ULTRASONIC_SCHED_RING_LEN];      //!< Ring buffer, internal
+} ultrasonic_sched_t;
+
+/**
+ * @brief Start scheduler task
+ *
+ * Public fields of the descriptor must be set before the call.
+ * To avoid crosstalk order should interleave sensors so that consecutive
+ * pings come from sensors looking away from each other, e.g. 0, 3, 1, 4,
+ * 2, 5 for 6 sensors in a ring. `spacing_ms` may be shorter than flight
+ * time, sensor is never pinged again before its previous echo is
+ * received or timed out.
+ *
+ * @param sched Scheduler descriptor
+ * @param priority Task priority
+ * @param stack_size Task stack size
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_sched_start(ultrasonic_sched_t *sched, UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Stop scheduler task
+ *
+ * Waits for the task to finish pending measurements.
+ *
+ * @param sched Scheduler descriptor
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_sched_stop(ultrasonic_sched_t *sched);
+
+/**
+ * @brief Get latest reading of every sensor
+ *
+ * Readings of sensors never measured have `timestamp` 0.
+ *
+ * @param sched Scheduler descriptor
+ * @param[out] readings Array of `sched->count` readings
+ * @param[out] seq Number of readings published so far, may be NULL
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_sched_snapshot(ultrasonic_sched_t *sched, ultrasonic_reading_t *readings, uint32_t *seq);
+
+/**
+ * @brief Get readings published since given sequence number
+ *
+ * Copies readings in chronological order. If more than
+ * ::ULTRASONIC_SCHED_RING_LEN readings have been published since `since`,
+ * oldest are lost.
+ *
+ * @param sched Scheduler descriptor
+ * @param since Sequence number returned by the previous call, 0 at first
+ * @param[out] readings Array of at least `count` readings
+ * @param count Array length
+ * @param[out] copied Number of readings copied
+ * @param[out] seq Sequence number to pass to the next call
+ * @return `ESP_OK` on success
+ */
+esp_err_t ultrasonic_sched_history(ultrasonic_sched_t *sched, uint32_t since, ultrasonic_reading_t *readings,
+        size_t count, size_t *copied, uint32_t *seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif /* __ULTRASONIC_SCHED_H__ */
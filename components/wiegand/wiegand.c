@@ -38,15 +38,25 @@
 #include <string.h>
 #include <stdlib.h>
 #include <esp_idf_lib_helpers.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 #include "wiegand.h"
 
 static const char *TAG = "wiegand";
 
 #define TIMER_INTERVAL_US 50000 // 50ms
 
+// Frame start marker in ring buffer
+#define RING_START 2
+
 #define CHECK(x) do { esp_err_t __; if ((__ = x) != ESP_OK) return __; } while (0)
 #define CHECK_ARG(VAL) do { if (!(VAL)) return ESP_ERR_INVALID_ARG; } while (0)
 
+static wiegand_reader_t *readers = NULL;
+static SemaphoreHandle_t lock = NULL;
+static TaskHandle_t task = NULL;
+
 static void isr_disable(wiegand_reader_t *reader)
 {
     gpio_set_intr_type(reader->gpio_d0, GPIO_INTR_DISABLE);
@@ -59,6 +69,24 @@ static void isr_enable(wiegand_reader_t *reader)
     gpio_set_intr_type(reader->gpio_d1, GPIO_INTR_NEGEDGE);
 }
 
+#if HELPER_TARGET_IS_ESP32
+static inline bool IRAM_ATTR ring_push(wiegand_reader_t *reader, uint8_t value)
+#else
+static inline bool ring_push(wiegand_reader_t *reader, uint8_t value)
+#endif
+{
+    size_t head = reader->head;
+    size_t next = (head + 1) % reader->ring_size;
+    if (next == __atomic_load_n(&reader->tail, __ATOMIC_ACQUIRE))
+    {
+        reader->overruns++;
+        return false;
+    }
+    reader->ring[head] = value;
+    __atomic_store_n(&reader->head, next, __ATOMIC_RELEASE);
+    return true;
+}
+
 #if HELPER_TARGET_IS_ESP32
 static void IRAM_ATTR isr_handler(void *arg)
 #else
@@ -73,41 +101,101 @@ static void isr_handler(void *arg)
     // ignore equal
     if (d0 == d1)
         return;
-    // overflow
-    if (reader->bits >= reader->size * 8)
-        return;
 
-    esp_timer_stop(reader->timer);
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    bool start = now - reader->last >= TIMER_INTERVAL_US;
+    reader->last = now;
 
-    uint8_t value = d0 ? 0x80 : 0;
+    if (start && !ring_push(reader, RING_START))
+        return;
+    ring_push(reader, d0 ? 1 : 0);
 
-    reader->buf[reader->bits / 8] |= value >> (reader->bits % 8);
-    reader->bits++;
+    if (!start)
+        return;
 
-    esp_timer_start_once(reader->timer, TIMER_INTERVAL_US);
+    // wake up decoder at the beginning of the code
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task, &woken);
+    if (woken == pdTRUE)
+        portYIELD_FROM_ISR();
 }
 
-static void timer_handler(void *arg)
+static void finish(wiegand_reader_t *reader)
 {
-    wiegand_reader_t *reader = (wiegand_reader_t *)arg;
+    if (!reader->bits)
+        return;
 
     ESP_LOGD(TAG, "Got %d bits of data", reader->bits);
 
-    isr_disable(reader);
-
     if (reader->callback)
         reader->callback(reader);
 
     reader->bits = 0;
     memset(reader->buf, 0, reader->size);
+}
 
-    isr_enable(reader);
+// Returns true if code reception is in progress
+static bool process(wiegand_reader_t *reader)
+{
+    // ISR updates `last` before it publishes bits, so `last` read after
+    // `head` is not older than any bit before `head`
+    size_t head = __atomic_load_n(&reader->head, __ATOMIC_ACQUIRE);
+    uint32_t last = __atomic_load_n(&reader->last, __ATOMIC_RELAXED);
+
+    while (reader->tail != head)
+    {
+        uint8_t value = reader->ring[reader->tail];
+        __atomic_store_n(&reader->tail, (reader->tail + 1) % reader->ring_size, __ATOMIC_RELEASE);
+
+        if (value == RING_START)
+        {
+            finish(reader);
+            continue;
+        }
+        // overflow
+        if (reader->bits >= reader->size * 8)
+            continue;
+
+        reader->buf[reader->bits / 8] |= (value ? 0x80 : 0) >> (reader->bits % 8);
+        reader->bits++;
+    }
+
+    if (!reader->bits)
+        return false;
+
+    // No bits since the last one we have seen for the whole interval
+    if ((uint32_t)esp_timer_get_time() - last >= TIMER_INTERVAL_US
+            && __atomic_load_n(&reader->head, __ATOMIC_ACQUIRE) == head)
+    {
+        finish(reader);
+        return false;
+    }
+
+    return true;
+}
+
+static void decoder_task(void *arg)
+{
+    TickType_t wait = portMAX_DELAY;
+    while (true)
+    {
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        bool busy = false;
+        xSemaphoreTake(lock, portMAX_DELAY);
+        for (wiegand_reader_t *r = readers; r; r = r->next)
+            if (process(r))
+                busy = true;
+        xSemaphoreGive(lock);
+
+        wait = busy ? pdMS_TO_TICKS(TIMER_INTERVAL_US / 2000) + 1 : portMAX_DELAY;
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
-        bool internal_pullups, size_t buf_size, wiegand_callback_t callback)
+static esp_err_t reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
+        bool internal_pullups, size_t buf_size, wiegand_callback_t callback, uint8_t *mem)
 {
     CHECK_ARG(reader && buf_size && callback);
 
@@ -115,25 +203,57 @@ esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio
     if (res != ESP_OK && res != ESP_ERR_INVALID_STATE)
         return res;
 
+    if (!lock)
+    {
+        lock = xSemaphoreCreateMutex();
+        if (!lock)
+            return ESP_ERR_NO_MEM;
+    }
+    if (!task && xTaskCreate(decoder_task, TAG, CONFIG_WIEGAND_TASK_STACK_SIZE, NULL,
+            CONFIG_WIEGAND_TASK_PRIORITY, &task) != pdPASS)
+    {
+        task = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+
     memset(reader, 0, sizeof(wiegand_reader_t));
     reader->gpio_d0 = gpio_d0;
     reader->gpio_d1 = gpio_d1;
     reader->size = buf_size;
-    reader->buf = calloc(buf_size, 1);
     reader->callback = callback;
-
-    esp_timer_create_args_t timer_args = {
-        .name = TAG,
-        .arg = reader,
-        .callback = timer_handler,
-        .dispatch_method = ESP_TIMER_TASK
-    };
-    CHECK(esp_timer_create(&timer_args, &reader->timer));
+    // room for two codes with start markers
+    reader->ring_size = buf_size * 16 + 3;
+    if (mem)
+    {
+        memset(mem, 0, WIEGAND_BUFFER_SIZE(buf_size));
+        reader->buf = mem;
+        reader->ring = mem + buf_size;
+        reader->static_buf = true;
+    }
+    else
+    {
+        reader->buf = calloc(buf_size, 1);
+        reader->ring = malloc(reader->ring_size);
+        if (!reader->buf || !reader->ring)
+        {
+            free(reader->buf);
+            free(reader->ring);
+            reader->buf = NULL;
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    reader->last = (uint32_t)esp_timer_get_time() - TIMER_INTERVAL_US;
 
     CHECK(gpio_set_direction(gpio_d0, GPIO_MODE_INPUT));
     CHECK(gpio_set_direction(gpio_d1, GPIO_MODE_INPUT));
     CHECK(gpio_set_pull_mode(gpio_d0, internal_pullups ? GPIO_PULLUP_ONLY : GPIO_FLOATING));
     CHECK(gpio_set_pull_mode(gpio_d1, internal_pullups ? GPIO_PULLUP_ONLY : GPIO_FLOATING));
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    reader->next = readers;
+    readers = reader;
+    xSemaphoreGive(lock);
+
     isr_disable(reader);
     CHECK(gpio_isr_handler_add(gpio_d0, isr_handler, reader));
     CHECK(gpio_isr_handler_add(gpio_d1, isr_handler, reader));
@@ -144,6 +264,20 @@ esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio
     return ESP_OK;
 }
 
+esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
+        bool internal_pullups, size_t buf_size, wiegand_callback_t callback)
+{
+    return reader_init(reader, gpio_d0, gpio_d1, internal_pullups, buf_size, callback, NULL);
+}
+
+esp_err_t wiegand_reader_init_static(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
+        bool internal_pullups, size_t buf_size, wiegand_callback_t callback, uint8_t *mem)
+{
+    CHECK_ARG(mem);
+
+    return reader_init(reader, gpio_d0, gpio_d1, internal_pullups, buf_size, callback, mem);
+}
+
 esp_err_t wiegand_reader_done(wiegand_reader_t *reader)
 {
     CHECK_ARG(reader && reader->buf);
@@ -151,11 +285,137 @@ esp_err_t wiegand_reader_done(wiegand_reader_t *reader)
     isr_disable(reader);
     CHECK(gpio_isr_handler_remove(reader->gpio_d0));
     CHECK(gpio_isr_handler_remove(reader->gpio_d1));
-    esp_timer_stop(reader->timer);
-    CHECK(esp_timer_delete(reader->timer));
-    free(reader->buf);
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (wiegand_reader_t **r = &readers; *r; r = &(*r)->next)
+        if (*r == reader)
+        {
+            *r = reader->next;
+            break;
+        }
+    xSemaphoreGive(lock);
+
+    if (!reader->static_buf)
+    {
+        free(reader->buf);
+        free(reader->ring);
+    }
+    reader->buf = NULL;
+    reader->ring = NULL;
 
     ESP_LOGI(TAG, "Reader removed");
 
     return ESP_OK;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+const wiegand_format_t wiegand_format_h10301 = {
+    .name = "H10301",
+    .bits = 26,
+    .facility_start = 1, .facility_len = 8,
+    .card_start = 9, .card_len = 16,
+    .parity = {
+        { .pos = 0, .start = 1, .len = 12, .odd = false },
+        { .pos = 25, .start = 13, .len = 12, .odd = true },
+    }
+};
+
+const wiegand_format_t wiegand_format_34bit = {
+    .name = "34-bit",
+    .bits = 34,
+    .facility_start = 1, .facility_len = 16,
+    .card_start = 17, .card_len = 16,
+    .parity = {
+        { .pos = 0, .start = 1, .len = 16, .odd = false },
+        { .pos = 33, .start = 17, .len = 16, .odd = true },
+    }
+};
+
+const wiegand_format_t wiegand_format_h10302 = {
+    .name = "H10302",
+    .bits = 37,
+    .facility_len = 0,
+    .card_start = 1, .card_len = 35,
+    .parity = {
+        { .pos = 0, .start = 1, .len = 18, .odd = false },
+        { .pos = 36, .start = 18, .len = 18, .odd = true },
+    }
+};
+
+const wiegand_format_t wiegand_format_h10304 = {
+    .name = "H10304",
+    .bits = 37,
+    .facility_start = 1, .facility_len = 16,
+    .card_start = 17, .card_len = 19,
+    .parity = {
+        { .pos = 0, .start = 1, .len = 18, .odd = false },
+        { .pos = 36, .start = 18, .len = 18, .odd = true },
+    }
+};
+
+static const wiegand_format_t *builtin_formats[] = {
+    &wiegand_format_h10301,
+    &wiegand_format_34bit,
+    // H10302 has the same length and parity bits as H10304 and would
+    // never be matched, it can be passed to wiegand_decode() explicitly
+    &wiegand_format_h10304,
+};
+
+static inline int get_bit(const uint8_t *buf, size_t pos)
+{
+    return (buf[pos / 8] >> (7 - pos % 8)) & 1;
+}
+
+uint64_t wiegand_get_bits(const uint8_t *buf, size_t start, size_t len)
+{
+    uint64_t res = 0;
+    for (size_t i = start; i < start + len; i++)
+        res = (res << 1) | get_bit(buf, i);
+    return res;
+}
+
+static bool parity_ok(const uint8_t *buf, const wiegand_format_t *format)
+{
+    for (size_t i = 0; i < 2; i++)
+    {
+        const wiegand_parity_t *p = &format->parity[i];
+        if (!p->len)
+            continue;
+        int sum = get_bit(buf, p->pos) + __builtin_popcountll(wiegand_get_bits(buf, p->start, p->len));
+        if ((sum & 1) != p->odd)
+            return false;
+    }
+    return true;
+}
+
+esp_err_t wiegand_decode(const wiegand_reader_t *reader, const wiegand_format_t * const *formats, size_t count,
+        wiegand_code_t *code)
+{
+    CHECK_ARG(reader && reader->buf && code);
+    if (!formats)
+    {
+        formats = builtin_formats;
+        count = sizeof(builtin_formats) / sizeof(builtin_formats[0]);
+    }
+
+    const wiegand_format_t *found = NULL;
+    bool ok = false;
+    for (size_t i = 0; i < count && !ok; i++)
+    {
+        if (formats[i]->bits != reader->bits || formats[i]->bits > reader->size * 8)
+            continue;
+        ok = parity_ok(reader->buf, formats[i]);
+        if (ok || !found)
+            found = formats[i];
+    }
+    if (!found)
+        return ESP_ERR_NOT_FOUND;
+
+    code->format = found;
+    code->parity_ok = ok;
+    code->facility = wiegand_get_bits(reader->buf, found->facility_start, found->facility_len);
+    code->card = wiegand_get_bits(reader->buf, found->card_start, found->card_len);
+
+    return ESP_OK;
+}
@@ -62,13 +62,73 @@ struct wiegand_reader
     uint8_t *buf;
     size_t size;
     size_t bits;
-    esp_timer_handle_t timer;
     bool start_parity;
+
+    uint8_t *ring;           //!< Received bits, written in ISR, internal
+    size_t ring_size;        //!< Ring buffer length, internal
+    volatile size_t head;    //!< Ring buffer write position, internal
+    volatile size_t tail;    //!< Ring buffer read position, internal
+    volatile uint32_t last;  //!< Time of last received bit, us, internal
+    uint32_t overruns;       //!< Bits dropped because ring buffer was full
+    wiegand_reader_t *next;  //!< Next reader, internal
+    bool static_buf;         //!< Buffers are provided by caller, internal
 };
 
+/**
+ * Parity bit of a Wiegand format
+ */
+typedef struct
+{
+    uint8_t pos;   //!< Position of parity bit, 0 is the first received bit
+    uint8_t start; //!< First bit covered by parity
+    uint8_t len;   //!< Number of bits covered by parity, 0 if parity is not used
+    bool odd;      //!< Odd parity if true, even otherwise
+} wiegand_parity_t;
+
+/**
+ * Wiegand format descriptor
+ *
+ * Fields are given by position of the first bit and length, bit 0 is
+ * the first received one, fields are MSB first.
+ */
+typedef struct
+{
+    const char *name;           //!< Format name
+    uint8_t bits;               //!< Code length, bits
+    uint8_t facility_start;     //!< Facility code position
+    uint8_t facility_len;       //!< Facility code length, 0 if there is no facility code
+    uint8_t card_start;         //!< Card number position
+    uint8_t card_len;           //!< Card number length, up to 64 bits
+    wiegand_parity_t parity[2]; //!< Parity bits
+} wiegand_format_t;
+
+/**
+ * Decoded code
+ */
+typedef struct
+{
+    const wiegand_format_t *format; //!< Detected format
+    uint32_t facility;              //!< Facility code
+    uint64_t card;                  //!< Card number
+    bool parity_ok;                 //!< true if all parity bits are valid
+} wiegand_code_t;
+
+extern const wiegand_format_t wiegand_format_h10301;  //!< Standard 26-bit format
+extern const wiegand_format_t wiegand_format_34bit;   //!< 34-bit format, 16-bit facility and card number
+extern const wiegand_format_t wiegand_format_h10302;  //!< 37-bit format without facility code, not built-in
+extern const wiegand_format_t wiegand_format_h10304;  //!< 37-bit format with 16-bit facility code
+
 /**
  * @brief Create and initialize reader instance.
  *
+ * Bits are put into a lock-free ring buffer in the interrupt handler,
+ * codes are assembled and callbacks are called by a single decoder task
+ * shared by all readers. Interrupts stay enabled while callback runs,
+ * so the next code is not lost.
+ *
+ * `buf` and `bits` fields of the descriptor are valid only inside
+ * the callback. Do not call wiegand_reader_done() from the callback.
+ *
  * @param reader           Reader descriptor
  * @param gpio_d0          GPIO pin for D0
  * @param gpio_d1          GPIO pin for D0
@@ -81,6 +141,33 @@ struct wiegand_reader
 esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
         bool internal_pullups, size_t buf_size, wiegand_callback_t callback);
 
+/**
+ * Size in bytes of memory for ::wiegand_reader_init_static(), code buffer
+ * and ring buffer of received bits
+ */
+#define WIEGAND_BUFFER_SIZE(BUF_SIZE) ((BUF_SIZE) * 17 + 3)
+
+/**
+ * @brief Create and initialize reader instance with caller-provided buffers.
+ *
+ * Same as ::wiegand_reader_init(), but the code buffer and the ring buffer
+ * are placed in `mem`, so it can be a static array. Memory is not freed by
+ * ::wiegand_reader_done(). Shared decoder task and its mutex are still
+ * created on the heap by the first reader.
+ *
+ * @param reader           Reader descriptor
+ * @param gpio_d0          GPIO pin for D0
+ * @param gpio_d1          GPIO pin for D0
+ * @param internal_pullups Enable internal pull-up resistors for D0 and D1 GPIO
+ * @param buf_size         Reader buffer size in bytes, must be large enough to
+ *                         contain entire Wiegand key
+ * @param callback         Callback function for processing received codes
+ * @param mem              Memory of ::WIEGAND_BUFFER_SIZE(buf_size) bytes
+ * @return `ESP_OK` on success
+ */
+esp_err_t wiegand_reader_init_static(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio_num_t gpio_d1,
+        bool internal_pullups, size_t buf_size, wiegand_callback_t callback, uint8_t *mem);
+
 /**
  * @brief Delete reader instance.
  *
@@ -89,6 +176,37 @@ esp_err_t wiegand_reader_init(wiegand_reader_t *reader, gpio_num_t gpio_d0, gpio
  */
 esp_err_t wiegand_reader_done(wiegand_reader_t *reader);
 
+/**
+ * @brief Extract bit field from received code
+ *
+ * @param buf   Code buffer, e.g. `reader->buf`
+ * @param start First bit of field
+ * @param len   Field length, up to 64 bits
+ * @return Field value
+ */
+uint64_t wiegand_get_bits(const uint8_t *buf, size_t start, size_t len);
+
+/**
+ * @brief Decode received code
+ *
+ * Call this function from the reader callback. Formats are tried in
+ * array order, the first one matching code length and parity wins. If
+ * no format with valid parity found, first format matching code length
+ * is used and `code->parity_ok` is false. Code is decoded directly from
+ * the reader buffer.
+ *
+ * @param reader  Reader descriptor
+ * @param formats Array of formats, NULL for built-in formats (H10301, 34-bit, H10304).
+ *                H10302 codes are indistinguishable from H10304 ones, use
+ *                array with ::wiegand_format_h10302 for H10302 readers
+ * @param count   Number of formats
+ * @param[out] code Decoded code
+ * @return `ESP_OK` on success, `ESP_ERR_NOT_FOUND` if no format matches
+ *         code length
+ */
+esp_err_t wiegand_decode(const wiegand_reader_t *reader, const wiegand_format_t * const *formats, size_t count,
+        wiegand_code_t *code);
+
 #ifdef __cplusplus
 }
 #endif
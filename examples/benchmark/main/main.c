@@ -0,0 +1,294 @@
+/**
+ * Micro-benchmarks of hot paths of the library.
+ *
+ * Every benchmark runs its function in a loop and prints CPU cycles
+ * (esp_cpu_get_ccount()) and nanoseconds (esp_timer) per call. Pure
+ * computations need no hardware, bus benchmarks are enabled in menuconfig.
+ *
+ * Run it before and after a change on the same target and compare
+ * the tables.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <esp_idf_lib_helpers.h>
+#include <lib8tion.h>
+#include <color.h>
+#include <noise.h>
+#include <framebuffer.h>
+#include <onewire.h>
+#include <i2cdev.h>
+#include <esp_idf_lib_ring.h>
+#include <freertos/queue.h>
+#if HELPER_TARGET_IS_ESP8266
+#include <driver/soc.h>
+#elif ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+#include <esp_cpu.h>
+#else
+#include <soc/cpu.h>
+#endif
+#ifdef CONFIG_BENCH_LED_STRIP
+#include <led_strip.h>
+#endif
+
+#define WIDTH  16
+#define HEIGHT 16
+
+static const char *TAG = "benchmark";
+
+static volatile uint32_t sink;
+
+static inline uint32_t ccount()
+{
+#if HELPER_TARGET_IS_ESP8266
+    return soc_get_ccount();
+#elif ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+    return esp_cpu_get_cycle_count();
+#else
+    return esp_cpu_get_ccount();
+#endif
+}
+
+/*
+ * Runs `expr` `n` times and prints one row of the table. Counter wraps in
+ * ~17 s at 240 MHz, so one benchmark must be shorter than that.
+ */
+#define BENCH(name, n, expr) do { \
+        int64_t __t = esp_timer_get_time(); \
+        uint32_t __c = ccount(); \
+        for (uint32_t i = 0; i < (n); i++) { expr; } \
+        __c = ccount() - __c; \
+        __t = esp_timer_get_time() - __t; \
+        print_row(name, n, __c, __t); \
+        vTaskDelay(1); \
+    } while (0)
+
+static void print_row(const char *name, uint32_t n, uint32_t cycles, int64_t us)
+{
+    printf("| %-28s | %8u | %12u | %12u |\n", name, (unsigned)n,
+            (unsigned)(cycles / n), (unsigned)(us * 1000 / n));
+}
+
+static size_t xy_serpentine(void *ctx, size_t x, size_t y)
+{
+    return y * WIDTH + (y % 2 ? WIDTH - x - 1 : x);
+}
+
+static esp_err_t render_none(framebuffer_t *fb, void *arg)
+{
+    return ESP_OK;
+}
+
+static void bench_color()
+{
+    static rgb_t leds[WIDTH * HEIGHT];
+
+    BENCH("hsv2rgb_rainbow", 10000, {
+        rgb_t c = hsv2rgb_rainbow(hsv_from_values(i, 255 - (i >> 8), 255));
+        sink += c.r;
+    });
+
+    for (size_t i = 0; i < WIDTH * HEIGHT; i++)
+        leds[i] = hsv2rgb_rainbow(hsv_from_values(i, 255, 255));
+    BENCH("blur2d 16x16", 100, blur2d(leds, WIDTH, HEIGHT, 64, xy_serpentine, NULL));
+
+    static hsv_t hsv[WIDTH * HEIGHT];
+    BENCH("rgb2hsv_approximate 16x16", 100, {
+        for (size_t j = 0; j < WIDTH * HEIGHT; j++)
+            hsv[j] = rgb2hsv_approximate(leds[j]);
+    });
+    BENCH("rgb2hsv_approximate_array", 100, rgb2hsv_approximate_array(leds, hsv, WIDTH * HEIGHT));
+}
+
+static void bench_framebuffer()
+{
+    framebuffer_t fb;
+    if (fb_init(&fb, WIDTH, HEIGHT, render_none) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Could not allocate framebuffer");
+        return;
+    }
+    for (size_t i = 0; i < WIDTH * HEIGHT; i++)
+        fb.data[i] = hsv2rgb_rainbow(hsv_from_values(i, 255, 255));
+
+    BENCH("fb_fade 16x16", 100, fb_fade(&fb, 250));
+
+    fb_free(&fb);
+}
+
+static void bench_lib8tion()
+{
+    static uint8_t buf[WIDTH * HEIGHT];
+
+    BENCH("random8, 16x16 loop", 100, {
+        for (size_t j = 0; j < sizeof(buf); j++)
+            buf[j] = random8();
+    });
+    BENCH("random8_fill 16x16", 100, random8_fill(buf, sizeof(buf)));
+    sink += buf[0];
+
+    BENCH("sin8", 10000, sink += sin8(i));
+    BENCH("sin8_lut", 10000, sink += sin8_lut(i));
+    BENCH("sin16", 10000, sink += sin16(i * 7));
+    BENCH("sin16_lut", 10000, sink += sin16_lut(i * 7));
+}
+
+static void bench_noise()
+{
+    BENCH("inoise8_2d", 10000, sink += inoise8_2d(i * 37, i * 13));
+    BENCH("inoise16_3d", 10000, sink += inoise16_3d(i * 997, i * 331, i * 61));
+    BENCH("snoise8_2d", 10000, sink += snoise8_2d(i * 37, i * 13));
+    BENCH("snoise16_3d", 10000, sink += snoise16_3d(i * 997, i * 331, i * 61));
+
+    static uint8_t grid8[WIDTH * HEIGHT];
+    static uint16_t grid16[WIDTH * HEIGHT];
+    BENCH("fill_noise8_2d 16x16", 100, fill_noise8_2d(grid8, WIDTH, HEIGHT, 1, i, 97, 0, 97, i * 5));
+    BENCH("fill_snoise8_2d 16x16", 100, fill_snoise8_2d(grid8, WIDTH, HEIGHT, 1, i, 97, 0, 97));
+    BENCH("fill_noise16_2d 16x16", 100, fill_noise16_2d(grid16, WIDTH, HEIGHT, 1, i, 9973, 0, 9973, i * 1021));
+    BENCH("fill_snoise16_3d 16x16", 100, fill_snoise16_3d(grid16, WIDTH, HEIGHT, 1, i, 9973, 0, 9973, i * 1021));
+    sink += grid8[0] + grid16[0];
+}
+
+static void bench_crc()
+{
+    uint8_t data[9] = { 0x28, 0xff, 0x4c, 0x2e, 0x63, 0x16, 0x03, 0x9a, 0x00 };
+
+    BENCH("onewire_crc8, 8 bytes", 10000, { data[8] = i; sink += onewire_crc8(data + 1, 8); });
+    BENCH("onewire_crc16, 9 bytes", 10000, { data[8] = i; sink += onewire_crc16(data, 9, 0); });
+}
+
+static void bench_ring()
+{
+    ESP_IDF_LIB_RING_DEFINE(ring, uint32_t, 64);
+    uint32_t v;
+
+    // Same core, no contention: cost of the calls themselves
+    BENCH("esp_idf_lib_ring push+pop", 10000, {
+        esp_idf_lib_ring_push(&ring, &i);
+        esp_idf_lib_ring_pop(&ring, &v);
+        sink += v;
+    });
+
+    QueueHandle_t queue = xQueueCreate(64, sizeof(uint32_t));
+    if (!queue)
+    {
+        ESP_LOGE(TAG, "Could not create queue");
+        return;
+    }
+    BaseType_t woken;
+    BENCH("xQueueSend+xQueueReceive", 10000, {
+        xQueueSend(queue, &i, 0);
+        xQueueReceive(queue, &v, 0);
+        sink += v;
+    });
+    BENCH("xQueueSendFromISR+Receive", 10000, {
+        xQueueSendFromISR(queue, &i, &woken);
+        xQueueReceive(queue, &v, 0);
+        sink += v;
+    });
+    vQueueDelete(queue);
+}
+
+#ifdef CONFIG_BENCH_I2C
+static void bench_i2c()
+{
+    i2c_dev_t dev;
+    memset(&dev, 0, sizeof(dev));
+    dev.port = 0;
+    dev.addr = CONFIG_BENCH_I2C_ADDR;
+    dev.cfg.sda_io_num = CONFIG_BENCH_I2C_SDA_GPIO;
+    dev.cfg.scl_io_num = CONFIG_BENCH_I2C_SCL_GPIO;
+#if HELPER_TARGET_IS_ESP32
+    dev.cfg.master.clk_speed = 400000;
+#endif
+    ESP_ERROR_CHECK(i2c_dev_create_mutex(&dev));
+
+    uint8_t v;
+    esp_err_t res = i2c_dev_read_reg(&dev, CONFIG_BENCH_I2C_REG, &v, 1);
+    if (res != ESP_OK)
+        ESP_LOGW(TAG, "I2C device does not respond: %d (%s)", res, esp_err_to_name(res));
+    else
+        BENCH("i2c_dev_read_reg, 1 byte", 100, i2c_dev_read_reg(&dev, CONFIG_BENCH_I2C_REG, &v, 1));
+
+    i2c_dev_delete_mutex(&dev);
+}
+#endif
+
+#ifdef CONFIG_BENCH_ONEWIRE
+static void bench_onewire()
+{
+    if (!onewire_reset(CONFIG_BENCH_ONEWIRE_GPIO))
+        ESP_LOGW(TAG, "No 1-Wire devices found, timing without presence pulse");
+    BENCH("onewire_reset", 100, sink += onewire_reset(CONFIG_BENCH_ONEWIRE_GPIO));
+}
+#endif
+
+#ifdef CONFIG_BENCH_LED_STRIP
+static void bench_led_strip()
+{
+    led_strip_install();
+    led_strip_t strip = {
+        .type = LED_STRIP_WS2812,
+        .length = CONFIG_BENCH_LED_STRIP_LEN,
+        .gpio = CONFIG_BENCH_LED_STRIP_GPIO,
+        .buf = NULL,
+#ifdef LED_STRIP_BRIGHTNESS
+        .brightness = 255,
+#endif
+    };
+    ESP_ERROR_CHECK(led_strip_init(&strip));
+    for (size_t i = 0; i < strip.length; i++)
+        led_strip_set_pixel(&strip, i, hsv2rgb_rainbow(hsv_from_values(i, 255, 255)));
+
+    // RMT translator (_rmt_adapter) runs in the RMT ISR while the frame
+    // is transmitted, if it is too slow the frame gets longer than
+    // the wire time
+    BENCH("led_strip frame", 20, {
+        led_strip_flush(&strip);
+        led_strip_wait(&strip, portMAX_DELAY);
+    });
+    // WS2812: 1.25 us per bit, 24 bits per LED, 50 us reset delay
+    printf("| %-28s | %8u | %12s | %12u |\n", "WS2812 wire time", (unsigned)strip.length, "-",
+            (unsigned)(strip.length * 30000 + 50000));
+
+    led_strip_free(&strip);
+}
+#endif
+
+void task(void *pvParamters)
+{
+    printf("\nTarget: %s, ESP-IDF %s\n\n", CONFIG_IDF_TARGET, esp_get_idf_version());
+    printf("| %-28s | %8s | %12s | %12s |\n", "Function", "Calls", "Cycles/call", "ns/call");
+    printf("|------------------------------|----------|--------------|--------------|\n");
+
+    bench_lib8tion();
+    bench_color();
+    bench_framebuffer();
+    bench_noise();
+    bench_crc();
+    bench_ring();
+#ifdef CONFIG_BENCH_I2C
+    bench_i2c();
+#endif
+#ifdef CONFIG_BENCH_ONEWIRE
+    bench_onewire();
+#endif
+#ifdef CONFIG_BENCH_LED_STRIP
+    bench_led_strip();
+#endif
+
+    printf("\n");
+    vTaskDelete(NULL);
+}
+
+void app_main()
+{
+#ifdef CONFIG_BENCH_I2C
+    ESP_ERROR_CHECK(i2cdev_init());
+#endif
+    xTaskCreate(task, "bench", configMINIMAL_STACK_SIZE * 8, NULL, 5, NULL);
+}
@@ -0,0 +1,449 @@
+/**
+ * System-level benchmark: many devices on I2C, 1-Wire and SPI buses
+ * sampled at configured rates at the same time.
+ *
+ * Reports achieved samples per second and sampling jitter (delay from
+ * the ideal release time to the start of the sample) of every device,
+ * bus utilisation of I2C ports from i2cdev statistics, busy time of
+ * 1-Wire and SPI buses and CPU load of every core.
+ *
+ * Run it with both I2C sampling modes (tasks or port scheduler) on the
+ * same configuration and compare the tables.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <driver/spi_master.h>
+#include <i2cdev.h>
+#include <onewire.h>
+
+#if CONFIG_BUS_BENCH_MODE_SCHED
+#define USE_SCHED 1
+#else
+#define USE_SCHED 0
+#endif
+
+#define MAX_DEVICES 32
+#define MAX_I2C_SIZE 32
+
+static const char *TAG = "bus_benchmark";
+
+typedef struct bench_dev_s bench_dev_t;
+
+typedef esp_err_t (*sample_cb_t)(bench_dev_t *dev);
+
+struct bench_dev_s
+{
+    char name[16];
+    sample_cb_t sample;
+    uint32_t rate_hz;
+    TickType_t period;      // ticks
+    uint32_t period_us;
+    int64_t start_us;       // ideal time of the first release
+    uint32_t released;
+    uint32_t samples;
+    uint32_t errors;
+    uint64_t busy_us;
+    uint32_t jitter_max;
+    uint32_t *jitter;
+    size_t jitter_count;
+    i2c_dev_t i2c;
+    size_t i2c_size;
+    uint8_t i2c_reg;
+    i2c_dev_job_t job;
+};
+
+static bench_dev_t devs[MAX_DEVICES];
+static size_t dev_count = 0;
+
+static volatile bool running = false;
+static SemaphoreHandle_t finished;
+
+static SemaphoreHandle_t onewire_lock, spi_lock;
+static spi_device_handle_t spi_dev;
+static uint64_t onewire_busy_us, spi_busy_us;
+
+static bench_dev_t *add_dev(const char *kind, size_t n, sample_cb_t sample, uint32_t rate_hz)
+{
+    if (dev_count == MAX_DEVICES || !rate_hz)
+    {
+        ESP_LOGE(TAG, "Too many devices or invalid rate");
+        return NULL;
+    }
+
+    bench_dev_t *d = &devs[dev_count++];
+    memset(d, 0, sizeof(bench_dev_t));
+    snprintf(d->name, sizeof(d->name), "%s #%u", kind, (unsigned)n);
+    d->sample = sample;
+    d->rate_hz = rate_hz;
+    d->period = pdMS_TO_TICKS(1000 / rate_hz);
+    if (!d->period)
+        d->period = 1;
+    d->period_us = d->period * portTICK_PERIOD_MS * 1000;
+    d->jitter = malloc(CONFIG_BUS_BENCH_MAX_JITTER_SAMPLES * sizeof(uint32_t));
+    if (!d->jitter)
+    {
+        ESP_LOGE(TAG, "Out of memory");
+        dev_count--;
+        return NULL;
+    }
+
+    return d;
+}
+
+static void run_sample(bench_dev_t *d)
+{
+    int64_t now = esp_timer_get_time();
+    int64_t release = d->start_us + (int64_t)d->released++ * d->period_us;
+    uint32_t jitter = now > release ? (uint32_t)(now - release) : 0;
+
+    if (jitter > d->jitter_max)
+        d->jitter_max = jitter;
+    if (d->jitter_count < CONFIG_BUS_BENCH_MAX_JITTER_SAMPLES)
+        d->jitter[d->jitter_count++] = jitter;
+
+    if (d->sample(d) == ESP_OK)
+        d->samples++;
+    else
+        d->errors++;
+    d->busy_us += esp_timer_get_time() - now;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Samplers
+
+static esp_err_t sample_i2c(bench_dev_t *d)
+{
+    uint8_t buf[MAX_I2C_SIZE];
+
+    esp_err_t res = i2c_dev_take_mutex(&d->i2c);
+    if (res != ESP_OK)
+        return res;
+    res = i2c_dev_read_reg(&d->i2c, d->i2c_reg, buf, d->i2c_size);
+    i2c_dev_give_mutex(&d->i2c);
+
+    return res;
+}
+
+static esp_err_t sample_onewire(bench_dev_t *d)
+{
+    uint8_t scratchpad[9];
+    int64_t start;
+
+    xSemaphoreTake(onewire_lock, portMAX_DELAY);
+    start = esp_timer_get_time();
+    // no presence pulse is not an error, devices are not required
+    onewire_reset(CONFIG_BUS_BENCH_ONEWIRE_GPIO);
+    bool ok = onewire_skip_rom(CONFIG_BUS_BENCH_ONEWIRE_GPIO)
+        && onewire_write(CONFIG_BUS_BENCH_ONEWIRE_GPIO, 0xbe)
+        && onewire_read_bytes(CONFIG_BUS_BENCH_ONEWIRE_GPIO, scratchpad, sizeof(scratchpad));
+    onewire_busy_us += esp_timer_get_time() - start;
+    xSemaphoreGive(onewire_lock);
+
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+static esp_err_t sample_spi(bench_dev_t *d)
+{
+    static uint8_t tx[CONFIG_BUS_BENCH_SPI_SIZE], rx[CONFIG_BUS_BENCH_SPI_SIZE];
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.length = CONFIG_BUS_BENCH_SPI_SIZE * 8;
+    t.tx_buffer = tx;
+    t.rx_buffer = rx;
+
+    // one device handle is shared by all simulated devices
+    xSemaphoreTake(spi_lock, portMAX_DELAY);
+    int64_t start = esp_timer_get_time();
+    esp_err_t res = spi_device_transmit(spi_dev, &t);
+    spi_busy_us += esp_timer_get_time() - start;
+    xSemaphoreGive(spi_lock);
+
+    return res;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sampling
+
+static void dev_task(void *arg)
+{
+    bench_dev_t *d = (bench_dev_t *)arg;
+
+    TickType_t last = xTaskGetTickCount();
+    d->start_us = esp_timer_get_time();
+    while (running)
+    {
+        run_sample(d);
+        vTaskDelayUntil(&last, d->period);
+    }
+
+    xSemaphoreGive(finished);
+    vTaskDelete(NULL);
+}
+
+#if CONFIG_BUS_BENCH_MODE_SCHED
+static void dev_job(const i2c_dev_t *dev, void *ctx)
+{
+    if (running)
+        run_sample((bench_dev_t *)ctx);
+}
+#endif
+
+static esp_err_t start_dev(bench_dev_t *d, bool sched)
+{
+#if CONFIG_BUS_BENCH_MODE_SCHED
+    if (sched)
+    {
+        d->job.dev = &d->i2c;
+        d->job.cb = dev_job;
+        d->job.ctx = d;
+        d->job.period = d->period;
+        d->start_us = esp_timer_get_time();
+        return i2c_dev_sched_add(d->i2c.port, &d->job);
+    }
+#endif
+    if (xTaskCreate(dev_task, d->name, configMINIMAL_STACK_SIZE * 4, d,
+            CONFIG_BUS_BENCH_PRIORITY, NULL) != pdPASS)
+        return ESP_ERR_NO_MEM;
+    return ESP_OK;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Setup
+
+static void setup_i2c(i2c_port_t port, size_t count, int sda, int scl, uint32_t freq,
+        uint8_t addr, uint8_t reg, size_t size, uint32_t rate_hz)
+{
+    if (!count)
+        return;
+    if (port >= I2C_NUM_MAX)
+    {
+        ESP_LOGW(TAG, "I2C port %d is not available on this target", port);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        bench_dev_t *d = add_dev(port ? "I2C1" : "I2C0", i, sample_i2c, rate_hz);
+        if (!d)
+            return;
+        d->i2c.port = port;
+        d->i2c.addr = addr;
+        d->i2c.cfg.sda_io_num = sda;
+        d->i2c.cfg.scl_io_num = scl;
+        d->i2c.cfg.master.clk_speed = freq;
+        d->i2c_reg = reg;
+        d->i2c_size = size > MAX_I2C_SIZE ? MAX_I2C_SIZE : size;
+        ESP_ERROR_CHECK(i2c_dev_create_mutex(&d->i2c));
+    }
+#if CONFIG_BUS_BENCH_MODE_SCHED
+    ESP_ERROR_CHECK(i2c_dev_sched_init(port, CONFIG_BUS_BENCH_PRIORITY));
+#endif
+}
+
+static void setup_onewire()
+{
+    onewire_lock = xSemaphoreCreateMutex();
+    for (size_t i = 0; i < CONFIG_BUS_BENCH_ONEWIRE_DEVICES; i++)
+        add_dev("1-Wire", i, sample_onewire, CONFIG_BUS_BENCH_ONEWIRE_RATE_HZ);
+}
+
+static void setup_spi()
+{
+    spi_bus_config_t bus = {
+        .mosi_io_num = CONFIG_BUS_BENCH_SPI_MOSI_GPIO,
+        .miso_io_num = CONFIG_BUS_BENCH_SPI_MISO_GPIO,
+        .sclk_io_num = CONFIG_BUS_BENCH_SPI_SCLK_GPIO,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = CONFIG_BUS_BENCH_SPI_SIZE,
+    };
+    ESP_ERROR_CHECK(spi_bus_initialize(SPI2_HOST, &bus, 0));
+
+    spi_device_interface_config_t cfg;
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.spics_io_num = CONFIG_BUS_BENCH_SPI_CS_GPIO;
+    cfg.clock_speed_hz = CONFIG_BUS_BENCH_SPI_FREQ_HZ;
+    cfg.queue_size = 1;
+    ESP_ERROR_CHECK(spi_bus_add_device(SPI2_HOST, &cfg, &spi_dev));
+
+    spi_lock = xSemaphoreCreateMutex();
+    for (size_t i = 0; i < CONFIG_BUS_BENCH_SPI_DEVICES; i++)
+        add_dev("SPI", i, sample_spi, CONFIG_BUS_BENCH_SPI_RATE_HZ);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Report
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+typedef struct
+{
+    uint32_t total;
+    uint32_t idle[portNUM_PROCESSORS];
+} cpu_snapshot_t;
+
+static void cpu_snapshot(cpu_snapshot_t *s)
+{
+    memset(s, 0, sizeof(cpu_snapshot_t));
+
+    UBaseType_t n = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *st = malloc(n * sizeof(TaskStatus_t));
+    if (!st)
+        return;
+    n = uxTaskGetSystemState(st, n, &s->total);
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(core);
+        for (UBaseType_t i = 0; i < n; i++)
+            if (st[i].xHandle == idle)
+                s->idle[core] = st[i].ulRunTimeCounter;
+    }
+    free(st);
+}
+
+static void print_cpu_load(const cpu_snapshot_t *before, const cpu_snapshot_t *after)
+{
+    uint32_t total = after->total - before->total;
+    if (!total)
+        return;
+    for (int core = 0; core < portNUM_PROCESSORS; core++)
+    {
+        uint32_t idle = after->idle[core] - before->idle[core];
+        printf("CPU%d load: %u%%\n", core, (unsigned)(100 - (uint64_t)idle * 100 / total));
+    }
+}
+#endif
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static uint32_t percentile(const uint32_t *sorted, size_t count, unsigned pct)
+{
+    return count ? sorted[(count - 1) * pct / 100] : 0;
+}
+
+static void print_devices(int64_t elapsed_us)
+{
+    printf("| %-12s | %7s | %9s | %6s | %8s | %8s | %8s | %6s |\n",
+            "Device", "Rate", "Samples/s", "Errors", "p50, us", "p99, us", "max, us", "Busy");
+    printf("|--------------|---------|-----------|--------|----------|----------|----------|--------|\n");
+
+    uint32_t total = 0;
+    for (size_t i = 0; i < dev_count; i++)
+    {
+        bench_dev_t *d = &devs[i];
+        qsort(d->jitter, d->jitter_count, sizeof(uint32_t), cmp_u32);
+        printf("| %-12s | %7u | %9.1f | %6u | %8u | %8u | %8u | %5.1f%% |\n",
+                d->name, (unsigned)d->rate_hz, d->samples * 1e6 / elapsed_us, (unsigned)d->errors,
+                (unsigned)percentile(d->jitter, d->jitter_count, 50),
+                (unsigned)percentile(d->jitter, d->jitter_count, 99),
+                (unsigned)d->jitter_max, d->busy_us * 100.0 / elapsed_us);
+        total += d->samples;
+    }
+    printf("\nTotal: %.1f samples/s\n\n", total * 1e6 / elapsed_us);
+}
+
+static void print_buses(int64_t elapsed_us)
+{
+#if CONFIG_I2CDEV_STATS
+    for (i2c_port_t port = 0; port < I2C_NUM_MAX; port++)
+    {
+        i2c_dev_stats_t s;
+        if (i2c_dev_get_port_stats(port, &s) != ESP_OK || !s.transactions)
+            continue;
+        printf("I2C%d: %u transactions, %u errors, bus utilisation %.1f%%, lock wait %u ms\n",
+                port, (unsigned)s.transactions, (unsigned)s.errors,
+                s.bus_time_us * 100.0 / elapsed_us, (unsigned)(s.lock_wait_us / 1000));
+    }
+#else
+    printf("Enable CONFIG_I2CDEV_STATS for I2C bus utilisation\n");
+#endif
+    if (CONFIG_BUS_BENCH_ONEWIRE_DEVICES)
+        printf("1-Wire: bus utilisation %.1f%%\n", onewire_busy_us * 100.0 / elapsed_us);
+    if (CONFIG_BUS_BENCH_SPI_DEVICES)
+        printf("SPI: bus utilisation %.1f%%\n", spi_busy_us * 100.0 / elapsed_us);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void app_main()
+{
+    ESP_ERROR_CHECK(i2cdev_init());
+
+    finished = xSemaphoreCreateCounting(MAX_DEVICES, 0);
+
+    setup_i2c(0, CONFIG_BUS_BENCH_I2C0_DEVICES, CONFIG_BUS_BENCH_I2C0_SDA_GPIO,
+            CONFIG_BUS_BENCH_I2C0_SCL_GPIO, CONFIG_BUS_BENCH_I2C0_FREQ_HZ, CONFIG_BUS_BENCH_I2C0_ADDR,
+            CONFIG_BUS_BENCH_I2C0_REG, CONFIG_BUS_BENCH_I2C0_SIZE, CONFIG_BUS_BENCH_I2C0_RATE_HZ);
+    setup_i2c(1, CONFIG_BUS_BENCH_I2C1_DEVICES, CONFIG_BUS_BENCH_I2C1_SDA_GPIO,
+            CONFIG_BUS_BENCH_I2C1_SCL_GPIO, CONFIG_BUS_BENCH_I2C1_FREQ_HZ, CONFIG_BUS_BENCH_I2C1_ADDR,
+            CONFIG_BUS_BENCH_I2C1_REG, CONFIG_BUS_BENCH_I2C1_SIZE, CONFIG_BUS_BENCH_I2C1_RATE_HZ);
+    if (CONFIG_BUS_BENCH_ONEWIRE_DEVICES)
+        setup_onewire();
+    if (CONFIG_BUS_BENCH_SPI_DEVICES)
+        setup_spi();
+
+    if (!dev_count)
+    {
+        ESP_LOGE(TAG, "No devices configured");
+        return;
+    }
+
+    printf("\nTarget: %s, ESP-IDF %s, %u devices, %s, %d s\n\n", CONFIG_IDF_TARGET,
+            esp_get_idf_version(), (unsigned)dev_count,
+            USE_SCHED ? "I2C port scheduler" : "task per device",
+            CONFIG_BUS_BENCH_DURATION_S);
+
+#if CONFIG_I2CDEV_STATS
+    for (i2c_port_t port = 0; port < I2C_NUM_MAX; port++)
+        i2c_dev_reset_stats(port);
+#endif
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+    cpu_snapshot_t cpu_before, cpu_after;
+    cpu_snapshot(&cpu_before);
+#endif
+
+    running = true;
+    int64_t start = esp_timer_get_time();
+    size_t tasks = 0;
+    for (size_t i = 0; i < dev_count; i++)
+    {
+        bool sched = USE_SCHED && devs[i].sample == sample_i2c;
+        ESP_ERROR_CHECK(start_dev(&devs[i], sched));
+        if (!sched)
+            tasks++;
+    }
+
+    vTaskDelay(pdMS_TO_TICKS(CONFIG_BUS_BENCH_DURATION_S * 1000));
+    running = false;
+    int64_t elapsed = esp_timer_get_time() - start;
+
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+    cpu_snapshot(&cpu_after);
+#endif
+
+    while (tasks--)
+        xSemaphoreTake(finished, portMAX_DELAY);
+#if CONFIG_BUS_BENCH_MODE_SCHED
+    for (i2c_port_t port = 0; port < I2C_NUM_MAX; port++)
+        i2c_dev_sched_done(port);
+#endif
+
+    print_devices(elapsed);
+    print_buses(elapsed);
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS && CONFIG_FREERTOS_USE_TRACE_FACILITY
+    print_cpu_load(&cpu_before, &cpu_after);
+#else
+    printf("Enable CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS for CPU load\n");
+#endif
+    printf("\n");
+}
@@ -34,10 +34,16 @@ static esp_err_t write_lcd_data(const hd44780_t *lcd, uint8_t data)
     return pcf8574_port_write(&pcf8574, data);
 }
 
+static esp_err_t write_lcd_bulk(const hd44780_t *lcd, const uint8_t *data, size_t len)
+{
+    return pcf8574_port_write_seq(&pcf8574, data, len);
+}
+
 void lcd_test(void *pvParameters)
 {
     hd44780_t lcd = {
         .write_cb = write_lcd_data, // use callback to send data to LCD by I2C GPIO expander
+        .write_bulk_cb = write_lcd_bulk, // send whole strings in one I2C transaction
         .font = HD44780_FONT_5X8,
         .lines = 2,
         .pins = {
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <sys/time.h>
+#include <hd44780.h>
+#include <mcp23x17.h>
+#include <string.h>
+
+// A0, A1, A2 pins are grounded
+
+#define SDA_GPIO 16
+#define SCL_GPIO 17
+
+// D0..D7 of LCD are connected to GPA0..GPA7, RS, E and backlight to GPB0..GPB2
+#define PIN_RS 8
+#define PIN_E  9
+#define PIN_BL 10
+
+static mcp23x17_t mcp23017;
+
+static uint32_t get_time_sec()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec;
+}
+
+// data, RS and E are set by a single 16-bit port write
+static esp_err_t write_lcd_data16(const hd44780_t *lcd, uint16_t data)
+{
+    return mcp23x17_port_write(&mcp23017, data);
+}
+
+void lcd_test(void *pvParameters)
+{
+    hd44780_t lcd = {
+        .write16_cb = write_lcd_data16,
+        .bus_8bit = true,
+        .font = HD44780_FONT_5X8,
+        .lines = 2,
+        .pins = {
+            .rs = PIN_RS,
+            .e  = PIN_E,
+            .d0 = 0,
+            .d1 = 1,
+            .d2 = 2,
+            .d3 = 3,
+            .d4 = 4,
+            .d5 = 5,
+            .d6 = 6,
+            .d7 = 7,
+            .bl = PIN_BL
+        }
+    };
+
+    memset(&mcp23017, 0, sizeof(mcp23x17_t));
+    ESP_ERROR_CHECK(mcp23x17_init_desc(&mcp23017, 0, MCP23X17_ADDR_BASE, SDA_GPIO, SCL_GPIO));
+    // all pins are outputs
+    ESP_ERROR_CHECK(mcp23x17_port_set_mode(&mcp23017, 0));
+
+    ESP_ERROR_CHECK(hd44780_init(&lcd));
+
+    hd44780_switch_backlight(&lcd, true);
+
+    hd44780_gotoxy(&lcd, 0, 0);
+    hd44780_puts(&lcd, "Hello world!");
+
+    char time[16];
+
+    while (1)
+    {
+        hd44780_gotoxy(&lcd, 0, 1);
+
+        snprintf(time, 7, "%u  ", get_time_sec());
+        time[sizeof(time) - 1] = 0;
+
+        hd44780_puts(&lcd, time);
+
+        vTaskDelay(1000 / portTICK_PERIOD_MS);
+    }
+}
+
+void app_main()
+{
+    ESP_ERROR_CHECK(i2cdev_init());
+    xTaskCreate(lcd_test, "lcd_test", configMINIMAL_STACK_SIZE * 5, NULL, 5, NULL);
+}
@@ -1,2 +1 @@
 COMPONENT_ADD_INCLUDEDIRS = .
-COMPONENT_SRCDIRS = . effects
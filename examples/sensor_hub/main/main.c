@@ -0,0 +1,82 @@
+/**
+ * Simple example of sensor_hub: SHT3x on I2C bus and DS18B20 on 1-Wire bus
+ * sampled by two hub tasks, one consumer task prints results.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_system.h>
+#include <esp_err.h>
+#include <sht3x.h>
+#include <sensor_hub_drivers.h>
+
+#if defined(CONFIG_IDF_TARGET_ESP8266)
+#define SDA_GPIO 4
+#define SCL_GPIO 5
+#define ONEWIRE_GPIO 14
+#else
+#define SDA_GPIO 16
+#define SCL_GPIO 17
+#define ONEWIRE_GPIO 18
+#endif
+
+#define BUF_SIZE 8
+
+static sht3x_t sht3x;
+static sensor_hub_ds18x20_t ds18b20 = { .pin = ONEWIRE_GPIO, .addr = DS18X20_ANY };
+
+static sensor_hub_bus_t i2c_bus, onewire_bus;
+static sensor_hub_sensor_t sht3x_sensor, ds18b20_sensor;
+
+static void print_samples(const char *name, sensor_hub_sensor_t *sensor)
+{
+    sensor_hub_sample_t samples[BUF_SIZE];
+    size_t count;
+
+    ESP_ERROR_CHECK(sensor_hub_read(sensor, samples, BUF_SIZE, &count));
+    for (size_t i = 0; i < count; i++)
+    {
+        printf("%d ms %s:", (int)(samples[i].timestamp / 1000), name);
+        for (uint8_t v = 0; v < samples[i].count; v++)
+            printf(" %.2f", samples[i].values[v]);
+        printf("\n");
+    }
+}
+
+void task(void *pvParameters)
+{
+    while (1)
+    {
+        // woken by both sensors
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        print_samples("SHT3x", &sht3x_sensor);
+        print_samples("DS18B20", &ds18b20_sensor);
+    }
+}
+
+void app_main()
+{
+    TaskHandle_t consumer;
+    xTaskCreate(task, "consumer", configMINIMAL_STACK_SIZE * 8, NULL, 5, &consumer);
+
+    ESP_ERROR_CHECK(i2cdev_init());
+    memset(&sht3x, 0, sizeof(sht3x_t));
+    ESP_ERROR_CHECK(sht3x_init_desc(&sht3x, 0, SHT3X_I2C_ADDR_GND, SDA_GPIO, SCL_GPIO));
+    ESP_ERROR_CHECK(sht3x_init(&sht3x));
+
+    sht3x_sensor.driver = &sensor_hub_sht3x;
+    sht3x_sensor.ctx = &sht3x;
+    sht3x_sensor.period_ms = 1000;
+    sht3x_sensor.notify = consumer;
+    ESP_ERROR_CHECK(sensor_hub_add(&i2c_bus, &sht3x_sensor, BUF_SIZE));
+
+    ds18b20_sensor.driver = &sensor_hub_ds18x20;
+    ds18b20_sensor.ctx = &ds18b20;
+    ds18b20_sensor.period_ms = 2000;
+    ds18b20_sensor.notify = consumer;
+    ESP_ERROR_CHECK(sensor_hub_add(&onewire_bus, &ds18b20_sensor, BUF_SIZE));
+
+    ESP_ERROR_CHECK(sensor_hub_start(&i2c_bus, 6, configMINIMAL_STACK_SIZE * 6));
+    ESP_ERROR_CHECK(sensor_hub_start(&onewire_bus, 6, configMINIMAL_STACK_SIZE * 6));
+}
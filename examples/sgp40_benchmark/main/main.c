@@ -0,0 +1,64 @@
+/**
+ * Benchmark of the VOC index algorithm.
+ *
+ * Feeds synthetic raw values to several algorithm instances, as if
+ * SENSORS sensors were measured once per second, and prints the average
+ * time of one VocAlgorithm_process() call. No hardware is required.
+ *
+ * Enable "Use FPU in VOC index algorithm" in menuconfig to compare
+ * fixed point and float implementations.
+ */
+#include <stdio.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <sensirion_voc_algorithm.h>
+
+#define SENSORS 20
+#define SECONDS 600
+
+static const char *TAG = "sgp40-benchmark";
+
+static VocAlgorithmParams voc[SENSORS];
+
+static int32_t synthetic_sraw(size_t sensor, uint32_t second)
+{
+    // slow drift with a pollution event every 5 minutes
+    int32_t sraw = 30000 + (int32_t)sensor * 100 + (int32_t)(second % 600);
+    if (second % 300 > 270)
+        sraw -= 3000;
+    return sraw;
+}
+
+void task(void *pvParamters)
+{
+    for (size_t i = 0; i < SENSORS; i++)
+        VocAlgorithm_init(&voc[i]);
+
+    int64_t total = 0;
+    int32_t voc_index = 0;
+    for (uint32_t s = 0; s < SECONDS; s++)
+    {
+        int64_t start = esp_timer_get_time();
+        for (size_t i = 0; i < SENSORS; i++)
+            VocAlgorithm_process(&voc[i], synthetic_sraw(i, s), &voc_index);
+        total += esp_timer_get_time() - start;
+
+        // let the idle task run
+        if (s % 100 == 99)
+            vTaskDelay(1);
+    }
+
+    ESP_LOGI(TAG, "%d sensors, %d samples each: %d us per sample, %d us per second of operation",
+            SENSORS, SECONDS, (int)(total / (SENSORS * SECONDS)), (int)(total / SECONDS));
+    ESP_LOGI(TAG, "Last VOC index: %d", voc_index);
+
+    vTaskDelete(NULL);
+}
+
+void app_main()
+{
+    xTaskCreate(task, "bench", configMINIMAL_STACK_SIZE * 8, NULL, 5, NULL);
+}
@@ -0,0 +1,90 @@
+/**
+ * Benchmark of the TSL2591 lux calculation.
+ *
+ * Runs tsl2591_calculate_lux() and tsl2591_calculate_lux_int() on the
+ * same synthetic channel values for every gain and integration time,
+ * prints the average time of one call and the maximal relative error
+ * of the integer implementation. No hardware is required.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <esp_log.h>
+#include <tsl2591.h>
+
+#define SAMPLES 1000
+
+static const char *TAG = "tsl2591-lux-benchmark";
+
+static const tsl2591_gain_t gains[] = {
+    TSL2591_GAIN_LOW, TSL2591_GAIN_MEDIUM, TSL2591_GAIN_HIGH, TSL2591_GAIN_MAX
+};
+
+static uint16_t ch0[SAMPLES], ch1[SAMPLES];
+
+void task(void *pvParamters)
+{
+    // pseudo-random channel values, channel1 is 5..95% of channel0
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < SAMPLES; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        ch0[i] = 100 + (seed >> 16) % 65000;
+        ch1[i] = (uint32_t)ch0[i] * (5 + (seed >> 8) % 91) / 100;
+    }
+
+    // only settings are used by calculation functions
+    tsl2591_t dev;
+    memset(&dev, 0, sizeof(dev));
+
+    int64_t t_float = 0, t_int = 0;
+    float max_err = 0;
+    float lux;
+    uint32_t mlux;
+    for (int t = TSL2591_INTEGRATION_100MS; t <= TSL2591_INTEGRATION_600MS; t++)
+        for (size_t g = 0; g < sizeof(gains) / sizeof(gains[0]); g++)
+        {
+            dev.settings.control_reg = gains[g] | t;
+
+            int64_t start = esp_timer_get_time();
+            for (size_t i = 0; i < SAMPLES; i++)
+                tsl2591_calculate_lux(&dev, ch0[i], ch1[i], &lux);
+            t_float += esp_timer_get_time() - start;
+
+            start = esp_timer_get_time();
+            for (size_t i = 0; i < SAMPLES; i++)
+                tsl2591_calculate_lux_int(&dev, ch0[i], ch1[i], &mlux);
+            t_int += esp_timer_get_time() - start;
+
+            for (size_t i = 0; i < SAMPLES; i++)
+            {
+                tsl2591_calculate_lux(&dev, ch0[i], ch1[i], &lux);
+                tsl2591_calculate_lux_int(&dev, ch0[i], ch1[i], &mlux);
+                if (lux <= 1)
+                    continue;
+                float err = (mlux / 1000.0f - lux) / lux;
+                if (err < 0)
+                    err = -err;
+                if (err > max_err)
+                    max_err = err;
+            }
+
+            // let the idle task run
+            vTaskDelay(1);
+        }
+
+    int calls = SAMPLES * 6 * sizeof(gains) / sizeof(gains[0]);
+    ESP_LOGI(TAG, "float: %d ns per call", (int)(t_float * 1000 / calls));
+    ESP_LOGI(TAG, "int:   %d ns per call", (int)(t_int * 1000 / calls));
+    ESP_LOGI(TAG, "Max relative error of integer calculation: %.4f%%", max_err * 100);
+
+    vTaskDelete(NULL);
+}
+
+void app_main()
+{
+    xTaskCreate(task, "bench", configMINIMAL_STACK_SIZE * 8, NULL, 5, NULL);
+}
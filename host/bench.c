@@ -0,0 +1,341 @@
+/**
+ * Host benchmark of pure-compute components
+ *
+ * Runs kernels of color, noise, lib8tion, framebuffer, framebuffer effects,
+ * the VOC index algorithm and the SPSC ring on large inputs and prints time per call and throughput.
+ *
+ * Usage: bench [-s scale] [filter]
+ *
+ *   -s scale  Multiply number of iterations, default 1
+ *   filter    Run only benchmarks whose name contains this string
+ *
+ * Build with `make` and profile e.g. with `perf record ./bench noise`
+ * or `valgrind --tool=callgrind ./bench -s 0.1 blur`.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <lib8tion.h>
+#include <color.h>
+#include <noise.h>
+#include <framebuffer.h>
+#include <fbindexed.h>
+#include <fbblit.h>
+#include <fbdraw.h>
+#include <fb_effects.h>
+#include <sensirion_voc_algorithm.h>
+#include <esp_idf_lib_ring.h>
+
+#define WIDTH  256
+#define HEIGHT 256
+#define PIXELS (WIDTH * HEIGHT)
+
+static double scale = 1;
+static const char *filter;
+
+static volatile uint32_t sink;
+
+static rgb_t leds[PIXELS];
+static hsv_t hsv[PIXELS];
+static hsv_t hsv_rainbow[PIXELS]; // constant saturation and value
+static uint8_t field[PIXELS];
+
+/*
+ * Runs `expr` `n * scale` times, `items` is the number of processed items
+ * per call (pixels, samples) for throughput.
+ */
+#define BENCH(name, n, items, expr) do { \
+        if (!filter || strstr(name, filter)) { \
+            uint32_t __n = (uint32_t)((n) * scale) ? (uint32_t)((n) * scale) : 1; \
+            int64_t __t = esp_timer_get_time(); \
+            for (uint32_t i = 0; i < __n; i++) { expr; } \
+            __t = esp_timer_get_time() - __t; \
+            print_row(name, __n, items, __t); \
+        } \
+    } while (0)
+
+static void print_row(const char *name, uint32_t n, uint32_t items, int64_t us)
+{
+    double ns = (double)us * 1000 / n;
+    printf("| %-32s | %10u | %12.1f | %12.2f |\n", name, n, ns, items * 1000.0 / ns);
+}
+
+static size_t xy_linear(void *ctx, size_t x, size_t y)
+{
+    return y * WIDTH + x;
+}
+
+static esp_err_t render_none(framebuffer_t *fb, void *arg)
+{
+    return ESP_OK;
+}
+
+static void fill_pattern()
+{
+    for (size_t i = 0; i < PIXELS; i++)
+    {
+        hsv[i] = hsv_from_values(i, 255 - (i >> 10), 255 - (i >> 12));
+        hsv_rainbow[i] = hsv_from_values(i, 240, 255);
+        leds[i] = hsv2rgb_rainbow(hsv[i]);
+    }
+}
+
+static void bench_lib8tion()
+{
+    BENCH("sin16", 10000000, 1, sink += sin16(i));
+    BENCH("scale8", 10000000, 1, sink += scale8(i, i >> 8));
+    BENCH("random8", 10000000, 1, sink += random8());
+}
+
+static void bench_color()
+{
+    BENCH("hsv2rgb_rainbow", 10000000, 1, {
+        rgb_t c = hsv2rgb_rainbow(hsv_from_values(i, 255 - (i >> 8), 255));
+        sink += c.r;
+    });
+    BENCH("hsv2rgb_rainbow_array 256x256", 100, PIXELS, hsv2rgb_rainbow_array(hsv, leds, PIXELS));
+    static hsv_rainbow_lut_t lut;
+    hsv_rainbow_lut_init(&lut, 0, 0);
+    BENCH("rainbow_array, const s/v", 100, PIXELS, hsv2rgb_rainbow_array(hsv_rainbow, leds, PIXELS));
+    BENCH("rainbow_array_lut, const s/v", 100, PIXELS, hsv2rgb_rainbow_array_lut(hsv_rainbow, leds, PIXELS, &lut));
+    BENCH("hsv2rgb_spectrum", 10000000, 1, {
+        rgb_t c = hsv2rgb_spectrum(hsv_from_values(i, 255 - (i >> 8), 255));
+        sink += c.g;
+    });
+    BENCH("rgb_nscale8_array 256x256", 1000, PIXELS, rgb_nscale8_array(leds, PIXELS, 254));
+    BENCH("apply_gamma2rgb", 1000000, 1, {
+        rgb_t c = apply_gamma2rgb(leds[i & (PIXELS - 1)], 2.2);
+        sink += c.r;
+    });
+    static color_gamma_t gamma;
+    color_gamma_init(&gamma, 2.2);
+    BENCH("color_gamma_apply_array 256x256", 1000, PIXELS, color_gamma_apply_array(&gamma, leds, leds, PIXELS));
+    fill_pattern();
+    BENCH("blur1d 256x256", 200, PIXELS, blur1d(leds, PIXELS, 64));
+    fill_pattern();
+    BENCH("blur2d 256x256", 100, PIXELS, blur2d(leds, WIDTH, HEIGHT, 64, xy_linear, NULL));
+}
+
+static void bench_noise()
+{
+    BENCH("inoise8_2d", 10000000, 1, sink += inoise8_2d(i * 37, i * 13));
+    BENCH("inoise8_3d", 10000000, 1, sink += inoise8_3d(i * 37, i * 13, i));
+    BENCH("inoise16_3d", 10000000, 1, sink += inoise16_3d(i * 997, i * 331, i * 61));
+
+    noise8_field_t nf;
+    if (!noise8_field_init(&nf, WIDTH, HEIGHT))
+    {
+        fprintf(stderr, "Could not allocate noise field\n");
+        return;
+    }
+    noise8_field_set_origin(&nf, 0, 30, 0, 30);
+    BENCH("noise8_field_fill 256x256", 100, PIXELS, noise8_field_fill(&nf, field, i * 16));
+    noise8_field_free(&nf);
+}
+
+// Randomized check of strips against per-pixel access, run before timing
+// them. Ring origin must be moved, so loads and stores wrap around
+static bool check_strip(framebuffer_t *fb)
+{
+    fb_strip_t strip;
+    if (fb_strip_init(&strip, fb, 8) != ESP_OK)
+        return false;
+
+    bool ok = true;
+    for (int n = 0; n < 1000 && ok; n++)
+    {
+        size_t count = 1 + rand() % strip.rows;
+        size_t y0 = rand() % (HEIGHT - count + 1);
+        ok = fb_strip_load(&strip, y0, count) == ESP_OK;
+        rgb_t c;
+        for (size_t y = y0; y < y0 + count && ok; y++)
+            for (size_t x = 0; x < WIDTH && ok; x++)
+            {
+                rgb_t *p = fb_strip_pixel(&strip, x, y);
+                ok = fb_get_pixel_rgb(fb, x, y, &c) == ESP_OK && !memcmp(&c, p, sizeof(c));
+                p->r ^= 0x5a;
+            }
+        ok = ok && fb_strip_store(&strip) == ESP_OK;
+        for (size_t y = y0; y < y0 + count && ok; y++)
+            for (size_t x = 0; x < WIDTH && ok; x++)
+                ok = fb_get_pixel_rgb(fb, x, y, &c) == ESP_OK && !memcmp(&c, fb_strip_pixel(&strip, x, y), sizeof(c));
+    }
+
+    fb_strip_free(&strip);
+    return ok;
+}
+
+static void bench_framebuffer()
+{
+    framebuffer_t fb;
+    if (fb_init(&fb, WIDTH, HEIGHT, render_none) != ESP_OK)
+    {
+        fprintf(stderr, "Could not allocate framebuffer\n");
+        return;
+    }
+    memcpy(fb.data, leds, sizeof(leds));
+
+    BENCH("fb_fade 256x256", 1000, PIXELS, fb_fade(&fb, 250));
+    memcpy(fb.data, leds, sizeof(leds));
+    BENCH("fb_blur2d 256x256", 100, PIXELS, fb_blur2d(&fb, 64));
+    BENCH("fb_shift 256x256", 1000, PIXELS, fb_shift(&fb, 1, FB_SHIFT_UP));
+    BENCH("fb_shift left 256x256", 1000, PIXELS, fb_shift(&fb, 1, FB_SHIFT_LEFT));
+    fb_ring_enable(&fb, true);
+    BENCH("fb_shift ring 256x256", 1000000, PIXELS, fb_shift(&fb, 1, i & 1 ? FB_SHIFT_UP : FB_SHIFT_LEFT));
+    static rgb_t out[PIXELS];
+    BENCH("fb_remap ring 256x256", 1000, PIXELS, fb_remap(&fb, out));
+    if (!filter || strstr("fb_strip", filter))
+    {
+        fb_shift(&fb, 37, FB_SHIFT_UP);
+        fb_shift(&fb, 101, FB_SHIFT_LEFT);
+        if (!check_strip(&fb))
+        {
+            fprintf(stderr, "fb_strip check failed\n");
+            exit(1);
+        }
+    }
+    fb_strip_t strip;
+    if (fb_strip_init(&strip, &fb, 8) == ESP_OK)
+    {
+        BENCH("fb_strip load+store ring 256x8", 100000, WIDTH * 8, {
+            fb_strip_load(&strip, i % (HEIGHT - 8), 8);
+            fb_strip_store(&strip);
+        });
+        fb_strip_free(&strip);
+    }
+    fb_ring_enable(&fb, false);
+
+    fb_indexed_t ifb;
+    static rgb_t palette[FB_INDEXED_PALETTE_SIZE];
+    for (size_t i = 0; i < FB_INDEXED_PALETTE_SIZE; i++)
+        palette[i] = hsv2rgb_rainbow(hsv_from_values(i, 255, i));
+    if (fb_indexed_init(&ifb, WIDTH, HEIGHT, palette) == ESP_OK)
+    {
+        memcpy(ifb.data, field, PIXELS);
+        BENCH("fb_indexed_shift 256x256", 1000, PIXELS, fb_indexed_shift(&ifb, 1, FB_SHIFT_UP));
+        BENCH("fb_indexed_blur2d 256x256", 100, PIXELS, fb_indexed_blur2d(&ifb, 64));
+        BENCH("fb_indexed_expand 256x256", 1000, PIXELS, {
+            fb_indexed_fade(&ifb, 254);
+            fb_indexed_expand(&ifb, &fb);
+        });
+        fb_indexed_free(&ifb);
+    }
+
+    fb_image_t sprite = { .format = FB_IMAGE_RGB, .width = 64, .height = 64, .data = leds, .alpha = field };
+    BENCH("fb_set_pixel_rgb sprite 64x64", 10000, 64 * 64, {
+        for (size_t y = 0; y < 64; y++)
+            for (size_t x = 0; x < 64; x++)
+                fb_set_pixel_rgb(&fb, x + (i & 63), y + 7, leds[y * 64 + x]);
+    });
+    BENCH("fb_blit 64x64", 10000, 64 * 64, fb_blit(&fb, (int)(i & 63) - 32, 7, &sprite));
+    BENCH("fb_blit_keyed 64x64", 10000, 64 * 64, fb_blit_keyed(&fb, (int)(i & 63) - 32, 7, &sprite, leds[0]));
+    BENCH("fb_blit_alpha 64x64", 10000, 64 * 64, fb_blit_alpha(&fb, (int)(i & 63) - 32, 7, &sprite, 255));
+
+    rgb_t white = { .r = 255, .g = 255, .b = 255 };
+    BENCH("fb_set_pixelf_rgb line 256", 10000, 256, {
+        for (size_t x = 0; x < 256; x++)
+            fb_set_pixelf_rgb(&fb, x, x * 0.37f + (i & 63), white);
+    });
+    BENCH("fb_draw_line_aa 256", 10000, 256,
+          fb_draw_line_aa(&fb, 0, FB_FIXED(i & 63), FB_FIXED(255), FB_FIXED(255 * 0.37f + (i & 63)), white));
+    BENCH("fb_fill_circle_aa r100", 1000, 31416,
+          fb_fill_circle_aa(&fb, FB_FIXED(128) + (i & 255), FB_FIXED(128), FB_FIXED(100), leds[i & 255]));
+    BENCH("fb_fill_triangle_aa", 1000, 128 * 200,
+          fb_fill_triangle_aa(&fb, FB_FIXED(10) + (i & 255), FB_FIXED(5), FB_FIXED(250), FB_FIXED(128),
+                              FB_FIXED(10), FB_FIXED(250), leds[i & 255]));
+
+    fb_free(&fb);
+}
+
+static void bench_fb_effects()
+{
+    framebuffer_t fb;
+    fb_effects_t fx;
+    if (fb_init(&fb, WIDTH, HEIGHT, render_none) != ESP_OK || fb_effects_init(&fx, &fb, 0) != ESP_OK)
+    {
+        fprintf(stderr, "Could not allocate framebuffer effects\n");
+        return;
+    }
+
+    char name[64];
+    for (size_t e = 0; e < fb_effects_count(); e++)
+    {
+        const fb_effect_t *effect = fb_effects_get(e);
+        fb_effects_switch(&fx, effect);
+        snprintf(name, sizeof(name), "fb_effect_%s 256x256", effect->name);
+        BENCH(name, 100, PIXELS, effect->run(&fb));
+    }
+
+    fb_effects_free(&fx);
+    fb_free(&fb);
+}
+
+static void bench_voc()
+{
+    VocAlgorithmParams params;
+    VocAlgorithm_init(&params);
+    int32_t voc;
+
+    BENCH("VocAlgorithm_process", 1000000, 1, {
+        VocAlgorithm_process(&params, 30000 + (int32_t)(i % 600) - (i % 300 > 270 ? 3000 : 0), &voc);
+        sink += voc;
+    });
+}
+
+static void bench_ring()
+{
+    ESP_IDF_LIB_RING_DEFINE(ring, uint32_t, 64);
+    static esp_idf_lib_sample_t samples[64];
+    esp_idf_lib_ring_t sring;
+    esp_idf_lib_ring_init(&sring, samples, sizeof(esp_idf_lib_sample_t), 64);
+    uint32_t v;
+
+    BENCH("esp_idf_lib_ring push+pop", 10000000, 1, {
+        esp_idf_lib_ring_push(&ring, &i);
+        esp_idf_lib_ring_pop(&ring, &v);
+        sink += v;
+    });
+    BENCH("esp_idf_lib_ring 32 push, 32 pop", 1000000, 32, {
+        for (uint32_t n = 0; n < 32; n++)
+            esp_idf_lib_ring_push(&ring, &n);
+        while (esp_idf_lib_ring_pop(&ring, &v))
+            sink += v;
+    });
+    BENCH("esp_idf_lib_ring_push_sample", 10000000, 1, {
+        esp_idf_lib_ring_push_sample(&sring, i, i);
+        esp_idf_lib_sample_t *s = esp_idf_lib_ring_peek(&sring);
+        sink += s->value;
+        esp_idf_lib_ring_release(&sring);
+    });
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)
+            scale = atof(argv[++i]);
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Usage: %s [-s scale] [filter]\n", argv[0]);
+            return 1;
+        }
+        else
+            filter = argv[i];
+    }
+
+    fill_pattern();
+
+    printf("| %-32s | %10s | %12s | %12s |\n", "Function", "Calls", "ns/call", "Mitems/s");
+    printf("|----------------------------------|------------|--------------|--------------|\n");
+
+    bench_lib8tion();
+    bench_color();
+    bench_noise();
+    bench_framebuffer();
+    bench_fb_effects();
+    bench_voc();
+    bench_ring();
+
+    return 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * Host shim: esp_timer_get_time() on CLOCK_MONOTONIC
+ *
+ * Timers are not implemented, fbanimation is not part of the host build,
+ * only its types are used.
+ */
+#ifndef __HOST_ESP_TIMER_H__
+#define __HOST_ESP_TIMER_H__
+
+#include <stdint.h>
+#include <time.h>
+#include "esp_err.h"
+
+typedef struct esp_timer *esp_timer_handle_t;
+
+static inline int64_t esp_timer_get_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+#endif /* __HOST_ESP_TIMER_H__ */
@@ -0,0 +1,43 @@
+/*
+ * Host shim: FreeRTOS mutexes on pthreads
+ *
+ * Only mutexes are supported, timeouts other than 0 wait forever.
+ */
+#ifndef __HOST_SEMPHR_H__
+#define __HOST_SEMPHR_H__
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "FreeRTOS.h"
+
+typedef pthread_mutex_t *SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t m = malloc(sizeof(pthread_mutex_t));
+    if (m)
+        pthread_mutex_init(m, NULL);
+    return m;
+}
+
+static inline void vSemaphoreDelete(SemaphoreHandle_t m)
+{
+    pthread_mutex_destroy(m);
+    free(m);
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t timeout)
+{
+    if (!timeout)
+        return pthread_mutex_trylock(m) ? pdFALSE : pdTRUE;
+    pthread_mutex_lock(m);
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t m)
+{
+    pthread_mutex_unlock(m);
+    return pdTRUE;
+}
+
+#endif /* __HOST_SEMPHR_H__ */
@@ -0,0 +1,15 @@
+/*
+ * Host shim: FreeRTOS task types used in headers of pure-compute components
+ *
+ * Tasks are not implemented, multi-core parts of fbanimation are compiled out.
+ */
+#ifndef __HOST_FREERTOS_TASK_H__
+#define __HOST_FREERTOS_TASK_H__
+
+#include "FreeRTOS.h"
+
+#define portNUM_PROCESSORS 1
+
+typedef struct tskTaskControlBlock *TaskHandle_t;
+
+#endif /* __HOST_FREERTOS_TASK_H__ */
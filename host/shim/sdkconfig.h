@@ -0,0 +1,19 @@
+/*
+ * Host shim: configuration of components built for host
+ *
+ * Options can be overridden from the command line, e.g.
+ * `make CFLAGS_EXTRA=-DCONFIG_SGP40_VOC_FPU=1`
+ */
+#ifndef __HOST_SDKCONFIG_H__
+#define __HOST_SDKCONFIG_H__
+
+#ifndef CONFIG_SGP40_VOC_FPU
+#define CONFIG_SGP40_VOC_FPU 0
+#endif
+
+#define CONFIG_FB_EFFECTS_FIRE 1
+#define CONFIG_FB_EFFECTS_NOISE 1
+#define CONFIG_FB_EFFECTS_RAINBOW 1
+#define CONFIG_FB_EFFECTS_WATERFALL 1
+
+#endif /* __HOST_SDKCONFIG_H__ */